@@ -6,6 +6,12 @@ dnl Function to detect if libqcow dependencies are available
 AC_DEFUN([AX_LIBQCOW_CHECK_LOCAL],
   [dnl Check for internationalization functions in libqcow/libqcow_i18n.c
   AC_CHECK_FUNCS([bindtextdomain])
+
+  dnl Check for the Linux io_uring interface used in libqcow/libqcow_io_uring.c
+  AC_CHECK_HEADERS([fcntl.h linux/io_uring.h sys/mman.h sys/syscall.h unistd.h])
+
+  dnl Check for the access pattern advice used in libqcow/libqcow_mapped_file.c
+  AC_CHECK_FUNCS([madvise])
 ])
 
 dnl Function to detect if qcowtools dependencies are available
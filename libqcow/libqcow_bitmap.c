@@ -0,0 +1,600 @@
+/*
+ * Bitmap functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_bitmap.h"
+#include "libqcow_bitmap_values.h"
+#include "libqcow_file.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+/* Creates a bitmap
+ * Make sure the value bitmap is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_initialize(
+     libqcow_bitmap_t **bitmap,
+     libqcow_internal_file_t *internal_file,
+     libqcow_bitmap_values_t *bitmap_values,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_initialize";
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	if( *bitmap != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid bitmap value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = memory_allocate_structure(
+	                     libqcow_internal_bitmap_t );
+
+	if( internal_bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create bitmap.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_bitmap,
+	     0,
+	     sizeof( libqcow_internal_bitmap_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear bitmap.",
+		 function );
+
+		goto on_error;
+	}
+	internal_bitmap->internal_file = internal_file;
+	internal_bitmap->bitmap_values = bitmap_values;
+
+	*bitmap = (libqcow_bitmap_t *) internal_bitmap;
+
+	return( 1 );
+
+on_error:
+	if( internal_bitmap != NULL )
+	{
+		memory_free(
+		 internal_bitmap );
+	}
+	return( -1 );
+}
+
+/* Frees a bitmap
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_free(
+     libqcow_bitmap_t **bitmap,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_free";
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	if( *bitmap != NULL )
+	{
+		internal_bitmap = (libqcow_internal_bitmap_t *) *bitmap;
+		*bitmap         = NULL;
+
+		/* The internal_file and bitmap_values references are freed elsewhere
+		 */
+		memory_free(
+		 internal_bitmap );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_get_utf8_name_size(
+     libqcow_bitmap_t *bitmap,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_utf8_name_size";
+	int result                                 = 0;
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	result = libqcow_bitmap_values_get_utf8_name_size(
+	          internal_bitmap->bitmap_values,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-8 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_get_utf8_name(
+     libqcow_bitmap_t *bitmap,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_utf8_name";
+	int result                                 = 0;
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	result = libqcow_bitmap_values_get_utf8_name(
+	          internal_bitmap->bitmap_values,
+	          utf8_string,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the size of the UTF-16 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_get_utf16_name_size(
+     libqcow_bitmap_t *bitmap,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_utf16_name_size";
+	int result                                 = 0;
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	result = libqcow_bitmap_values_get_utf16_name_size(
+	          internal_bitmap->bitmap_values,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-16 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_get_utf16_name(
+     libqcow_bitmap_t *bitmap,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_utf16_name";
+	int result                                 = 0;
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	result = libqcow_bitmap_values_get_utf16_name(
+	          internal_bitmap->bitmap_values,
+	          utf16_string,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the granularity
+ * The granularity is the number of bytes of media data covered by a single bit
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_get_granularity(
+     libqcow_bitmap_t *bitmap,
+     size64_t *granularity,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_granularity";
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	if( internal_bitmap->bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid bitmap - missing bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( granularity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid granularity.",
+		 function );
+
+		return( -1 );
+	}
+	*granularity = (size64_t) 1 << internal_bitmap->bitmap_values->granularity_bits;
+
+	return( 1 );
+}
+
+/* Retrieves the flags
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_get_flags(
+     libqcow_bitmap_t *bitmap,
+     uint32_t *flags,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	static char *function                      = "libqcow_bitmap_get_flags";
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	if( internal_bitmap->bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid bitmap - missing bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid flags.",
+		 function );
+
+		return( -1 );
+	}
+	*flags = internal_bitmap->bitmap_values->flags;
+
+	return( 1 );
+}
+
+/* Retrieves the next changed extent at or after a specific offset
+ * A changed extent is a range of media data that was modified since the bitmap was created,
+ * the offset of the next call is typically the end of the previous extent.
+ * The bitmap table is read on first use
+ * Returns 1 if successful, 0 if there are no more changed extents or -1 on error
+ */
+int libqcow_bitmap_get_next_changed_extent(
+     libqcow_bitmap_t *bitmap,
+     off64_t offset,
+     off64_t *extent_offset,
+     size64_t *extent_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_bitmap_t *internal_bitmap = NULL;
+	libqcow_internal_file_t *internal_file     = NULL;
+	static char *function                      = "libqcow_bitmap_get_next_changed_extent";
+	int result                                 = 0;
+
+	if( bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	internal_bitmap = (libqcow_internal_bitmap_t *) bitmap;
+
+	if( internal_bitmap->internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid bitmap - missing file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = internal_bitmap->internal_file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+	/* The file IO handle and the bitmap cluster data are shared with the other readers
+	 */
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+#endif
+	/* The bitmaps track changes of the active image
+	 */
+	result = libqcow_bitmap_values_get_changed_extent(
+	          internal_bitmap->bitmap_values,
+	          internal_file->file_io_handle,
+	          internal_file->cluster_block_size,
+	          internal_file->file_header->media_size,
+	          offset,
+	          extent_offset,
+	          extent_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve changed extent at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
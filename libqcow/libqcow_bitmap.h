@@ -0,0 +1,113 @@
+/*
+ * Bitmap functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_BITMAP_H )
+#define _LIBQCOW_INTERNAL_BITMAP_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_bitmap_values.h"
+#include "libqcow_extern.h"
+#include "libqcow_file.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_bitmap libqcow_internal_bitmap_t;
+
+struct libqcow_internal_bitmap
+{
+	/* The internal file
+	 */
+	libqcow_internal_file_t *internal_file;
+
+	/* The bitmap values
+	 * These are owned by the file
+	 */
+	libqcow_bitmap_values_t *bitmap_values;
+};
+
+int libqcow_bitmap_initialize(
+     libqcow_bitmap_t **bitmap,
+     libqcow_internal_file_t *internal_file,
+     libqcow_bitmap_values_t *bitmap_values,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_free(
+     libqcow_bitmap_t **bitmap,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_utf8_name_size(
+     libqcow_bitmap_t *bitmap,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_utf8_name(
+     libqcow_bitmap_t *bitmap,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_utf16_name_size(
+     libqcow_bitmap_t *bitmap,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_utf16_name(
+     libqcow_bitmap_t *bitmap,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_granularity(
+     libqcow_bitmap_t *bitmap,
+     size64_t *granularity,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_flags(
+     libqcow_bitmap_t *bitmap,
+     uint32_t *flags,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_bitmap_get_next_changed_extent(
+     libqcow_bitmap_t *bitmap,
+     off64_t offset,
+     off64_t *extent_offset,
+     size64_t *extent_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_BITMAP_H ) */
+
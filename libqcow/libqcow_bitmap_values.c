@@ -0,0 +1,1413 @@
+/*
+ * Bitmap values functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_bitmap_values.h"
+#include "libqcow_cluster_table.h"
+#include "libqcow_definitions.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libuna.h"
+
+#include "qcow_bitmap_directory.h"
+
+/* Creates bitmap values
+ * Make sure the value bitmap_values is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_initialize(
+     libqcow_bitmap_values_t **bitmap_values,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_initialize";
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( *bitmap_values != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid bitmap values value already set.",
+		 function );
+
+		return( -1 );
+	}
+	*bitmap_values = memory_allocate_structure(
+	                  libqcow_bitmap_values_t );
+
+	if( *bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create bitmap values.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *bitmap_values,
+	     0,
+	     sizeof( libqcow_bitmap_values_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear bitmap values.",
+		 function );
+
+		goto on_error;
+	}
+	( *bitmap_values )->data_table_index = -1;
+
+	return( 1 );
+
+on_error:
+	if( *bitmap_values != NULL )
+	{
+		memory_free(
+		 *bitmap_values );
+
+		*bitmap_values = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees bitmap values
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_free(
+     libqcow_bitmap_values_t **bitmap_values,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_free";
+	int result            = 1;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( *bitmap_values != NULL )
+	{
+		if( ( *bitmap_values )->bitmap_table != NULL )
+		{
+			if( libqcow_cluster_table_free(
+			     &( ( *bitmap_values )->bitmap_table ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free bitmap table.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *bitmap_values )->data != NULL )
+		{
+			memory_free(
+			 ( *bitmap_values )->data );
+		}
+		if( ( *bitmap_values )->name != NULL )
+		{
+			memory_free(
+			 ( *bitmap_values )->name );
+		}
+		memory_free(
+		 *bitmap_values );
+
+		*bitmap_values = NULL;
+	}
+	return( result );
+}
+
+/* Reads the bitmap values from a bitmap directory entry
+ * The data contains the entry including the extra data and name
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_read_data(
+     libqcow_bitmap_values_t *bitmap_values,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function             = "libqcow_bitmap_values_read_data";
+	size_t data_offset                = 0;
+	uint64_t safe_bitmap_table_offset = 0;
+	uint32_t extra_data_size          = 0;
+	uint16_t name_size                = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->name != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid bitmap values - name value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size < sizeof( qcow_bitmap_directory_entry_t ) )
+	 || ( data_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: bitmap directory entry data:\n",
+		 function );
+		libcnotify_print_data(
+		 data,
+		 data_size,
+		 0 );
+	}
+#endif
+	byte_stream_copy_to_uint64_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) data )->bitmap_table_offset,
+	 safe_bitmap_table_offset );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) data )->bitmap_table_size,
+	 bitmap_values->bitmap_table_size );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) data )->flags,
+	 bitmap_values->flags );
+
+	bitmap_values->type             = ( (qcow_bitmap_directory_entry_t *) data )->type;
+	bitmap_values->granularity_bits = ( (qcow_bitmap_directory_entry_t *) data )->granularity_bits;
+
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) data )->name_size,
+	 name_size );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) data )->extra_data_size,
+	 extra_data_size );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: bitmap table offset\t\t\t: 0x%08" PRIx64 "\n",
+		 function,
+		 safe_bitmap_table_offset );
+
+		libcnotify_printf(
+		 "%s: bitmap table size\t\t\t: %" PRIu32 "\n",
+		 function,
+		 bitmap_values->bitmap_table_size );
+
+		libcnotify_printf(
+		 "%s: flags\t\t\t\t\t: 0x%08" PRIx32 "\n",
+		 function,
+		 bitmap_values->flags );
+
+		libcnotify_printf(
+		 "%s: type\t\t\t\t\t: %" PRIu8 "\n",
+		 function,
+		 bitmap_values->type );
+
+		libcnotify_printf(
+		 "%s: granularity bits\t\t\t: %" PRIu8 "\n",
+		 function,
+		 bitmap_values->granularity_bits );
+
+		libcnotify_printf(
+		 "%s: name size\t\t\t\t: %" PRIu16 "\n",
+		 function,
+		 name_size );
+
+		libcnotify_printf(
+		 "%s: extra data size\t\t\t\t: %" PRIu32 "\n",
+		 function,
+		 extra_data_size );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+
+	if( ( safe_bitmap_table_offset == 0 )
+	 || ( safe_bitmap_table_offset > (uint64_t) INT64_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bitmap table offset value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	if( ( bitmap_values->bitmap_table_size == 0 )
+	 || ( (size_t) bitmap_values->bitmap_table_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 8 ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bitmap table size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	if( bitmap_values->type != LIBQCOW_BITMAP_TYPE_DIRTY_TRACKING )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported bitmap type: %" PRIu8 ".",
+		 function,
+		 bitmap_values->type );
+
+		goto on_error;
+	}
+	if( ( bitmap_values->granularity_bits < LIBQCOW_BITMAP_MINIMUM_GRANULARITY_BITS )
+	 || ( bitmap_values->granularity_bits > LIBQCOW_BITMAP_MAXIMUM_GRANULARITY_BITS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid granularity bits value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	data_offset = sizeof( qcow_bitmap_directory_entry_t );
+
+	if( ( (size_t) extra_data_size + name_size ) > ( data_size - data_offset ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value too small.",
+		 function );
+
+		goto on_error;
+	}
+	bitmap_values->bitmap_table_offset = (off64_t) safe_bitmap_table_offset;
+	bitmap_values->extra_data_size     = extra_data_size;
+
+	data_offset += extra_data_size;
+
+	if( name_size > 0 )
+	{
+		bitmap_values->name = (uint8_t *) memory_allocate(
+		                                   sizeof( uint8_t ) * name_size );
+
+		if( bitmap_values->name == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create name.",
+			 function );
+
+			goto on_error;
+		}
+		if( memory_copy(
+		     bitmap_values->name,
+		     &( data[ data_offset ] ),
+		     (size_t) name_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy name.",
+			 function );
+
+			goto on_error;
+		}
+		bitmap_values->name_size = (size_t) name_size;
+	}
+	return( 1 );
+
+on_error:
+	if( bitmap_values->name != NULL )
+	{
+		memory_free(
+		 bitmap_values->name );
+
+		bitmap_values->name = NULL;
+	}
+	bitmap_values->name_size = 0;
+
+	return( -1 );
+}
+
+/* Reads the bitmap values from a bitmap directory entry
+ * The entry size is the size of the entry including the alignment padding,
+ * which is the distance to the next entry in the bitmap directory
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_read_file_io_handle(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     size_t *entry_size,
+     libcerror_error_t **error )
+{
+	uint8_t entry_header_data[ sizeof( qcow_bitmap_directory_entry_t ) ];
+
+	uint8_t *entry_data      = NULL;
+	static char *function    = "libqcow_bitmap_values_read_file_io_handle";
+	size_t entry_data_size   = 0;
+	ssize_t read_count       = 0;
+	uint32_t extra_data_size = 0;
+	uint16_t name_size       = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( entry_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid entry size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading bitmap directory entry at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 file_offset,
+		 file_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              entry_header_data,
+	              sizeof( qcow_bitmap_directory_entry_t ),
+	              file_offset,
+	              error );
+
+	if( read_count != (ssize_t) sizeof( qcow_bitmap_directory_entry_t ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read bitmap directory entry data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		goto on_error;
+	}
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) entry_header_data )->name_size,
+	 name_size );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_bitmap_directory_entry_t *) entry_header_data )->extra_data_size,
+	 extra_data_size );
+
+	if( extra_data_size > LIBQCOW_BITMAP_MAXIMUM_EXTRA_DATA_SIZE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid extra data size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	entry_data_size = sizeof( qcow_bitmap_directory_entry_t ) + (size_t) extra_data_size + name_size;
+
+	entry_data = (uint8_t *) memory_allocate(
+	                          sizeof( uint8_t ) * entry_data_size );
+
+	if( entry_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create bitmap directory entry data.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_copy(
+	     entry_data,
+	     entry_header_data,
+	     sizeof( qcow_bitmap_directory_entry_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy bitmap directory entry data.",
+		 function );
+
+		goto on_error;
+	}
+	if( entry_data_size > sizeof( qcow_bitmap_directory_entry_t ) )
+	{
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              &( entry_data[ sizeof( qcow_bitmap_directory_entry_t ) ] ),
+		              entry_data_size - sizeof( qcow_bitmap_directory_entry_t ),
+		              file_offset + sizeof( qcow_bitmap_directory_entry_t ),
+		              error );
+
+		if( read_count != (ssize_t) ( entry_data_size - sizeof( qcow_bitmap_directory_entry_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read bitmap directory entry data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 file_offset,
+			 file_offset );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_bitmap_values_read_data(
+	     bitmap_values,
+	     entry_data,
+	     entry_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read bitmap directory entry.",
+		 function );
+
+		goto on_error;
+	}
+	memory_free(
+	 entry_data );
+
+	/* The bitmap directory entries are 8-byte aligned
+	 */
+	*entry_size = ( entry_data_size + 7 ) & ~( (size_t) 7 );
+
+	return( 1 );
+
+on_error:
+	if( entry_data != NULL )
+	{
+		memory_free(
+		 entry_data );
+	}
+	return( -1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_values_get_utf8_name_size(
+     libqcow_bitmap_values_t *bitmap_values,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_get_utf8_name_size";
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_size_from_utf8_stream(
+	     bitmap_values->name,
+	     bitmap_values->name_size,
+	     utf8_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-8 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_values_get_utf8_name(
+     libqcow_bitmap_values_t *bitmap_values,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_get_utf8_name";
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_copy_from_utf8_stream(
+	     utf8_string,
+	     utf8_string_size,
+	     bitmap_values->name,
+	     bitmap_values->name_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-16 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_values_get_utf16_name_size(
+     libqcow_bitmap_values_t *bitmap_values,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_get_utf16_name_size";
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_size_from_utf8_stream(
+	     bitmap_values->name,
+	     bitmap_values->name_size,
+	     utf16_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-16 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_bitmap_values_get_utf16_name(
+     libqcow_bitmap_values_t *bitmap_values,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_bitmap_values_get_utf16_name";
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_copy_from_utf8_stream(
+	     utf16_string,
+	     utf16_string_size,
+	     bitmap_values->name,
+	     bitmap_values->name_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads the bitmap table
+ * The bitmap table is only read once
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_read_bitmap_table(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     size64_t media_size,
+     libcerror_error_t **error )
+{
+	static char *function      = "libqcow_bitmap_values_read_bitmap_table";
+	uint64_t bits_per_cluster  = 0;
+	uint64_t number_of_bits    = 0;
+	uint64_t number_of_entries = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->bitmap_table != NULL )
+	{
+		return( 1 );
+	}
+	if( ( cluster_block_size == 0 )
+	 || ( cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	/* Every bit covers 2^granularity bytes of the media data
+	 * and every bitmap cluster contains cluster block size * 8 bits
+	 */
+	number_of_bits = media_size >> bitmap_values->granularity_bits;
+
+	if( ( media_size & ( ( (size64_t) 1 << bitmap_values->granularity_bits ) - 1 ) ) != 0 )
+	{
+		number_of_bits += 1;
+	}
+	bits_per_cluster  = (uint64_t) cluster_block_size * 8;
+	number_of_entries = number_of_bits / bits_per_cluster;
+
+	if( ( number_of_bits % bits_per_cluster ) != 0 )
+	{
+		number_of_entries += 1;
+	}
+	if( number_of_entries > (uint64_t) bitmap_values->bitmap_table_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bitmap table size value too small for media size.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_initialize(
+	     &( bitmap_values->bitmap_table ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create bitmap table.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_table_read(
+	     bitmap_values->bitmap_table,
+	     file_io_handle,
+	     bitmap_values->bitmap_table_offset,
+	     (size_t) bitmap_values->bitmap_table_size * 8,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read bitmap table.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( bitmap_values->bitmap_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &( bitmap_values->bitmap_table ),
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Retrieves the data of a specific bitmap cluster
+ * If the bitmap cluster is not stored in the file data is set to NULL
+ * and fill value contains the byte value of the entire cluster
+ * The data is owned by the bitmap values and remains valid until the next call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_bitmap_values_get_cluster_data(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     uint64_t table_index,
+     uint8_t **data,
+     uint8_t *fill_value,
+     libcerror_error_t **error )
+{
+	static char *function         = "libqcow_bitmap_values_get_cluster_data";
+	ssize_t read_count            = 0;
+	uint64_t bitmap_table_entry   = 0;
+	off64_t bitmap_cluster_offset = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( bitmap_values->bitmap_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid bitmap values - missing bitmap table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block_size == 0 )
+	 || ( cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( table_index > (uint64_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( fill_value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid fill value.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     bitmap_values->bitmap_table,
+	     (int) table_index,
+	     &bitmap_table_entry,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve bitmap table entry: %" PRIu64 ".",
+		 function,
+		 table_index );
+
+		return( -1 );
+	}
+	if( ( bitmap_table_entry & LIBQCOW_BITMAP_TABLE_ENTRY_RESERVED_MASK ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported bitmap table entry: %" PRIu64 " reserved bits are set.",
+		 function,
+		 table_index );
+
+		return( -1 );
+	}
+	bitmap_cluster_offset = (off64_t) ( bitmap_table_entry & LIBQCOW_BITMAP_TABLE_ENTRY_OFFSET_MASK );
+
+	if( bitmap_cluster_offset == 0 )
+	{
+		if( ( bitmap_table_entry & LIBQCOW_BITMAP_TABLE_ENTRY_FLAG_ALL_ONES ) != 0 )
+		{
+			*fill_value = 0xff;
+		}
+		else
+		{
+			*fill_value = 0x00;
+		}
+		*data = NULL;
+
+		return( 1 );
+	}
+	if( ( (size64_t) bitmap_cluster_offset % cluster_block_size ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bitmap table entry: %" PRIu64 " offset value not aligned with cluster block size.",
+		 function,
+		 table_index );
+
+		return( -1 );
+	}
+	if( bitmap_values->data_size != (size_t) cluster_block_size )
+	{
+		if( bitmap_values->data != NULL )
+		{
+			memory_free(
+			 bitmap_values->data );
+
+			bitmap_values->data = NULL;
+		}
+		bitmap_values->data_size        = 0;
+		bitmap_values->data_table_index = -1;
+
+		bitmap_values->data = (uint8_t *) memory_allocate(
+		                                   sizeof( uint8_t ) * (size_t) cluster_block_size );
+
+		if( bitmap_values->data == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create bitmap cluster data.",
+			 function );
+
+			return( -1 );
+		}
+		bitmap_values->data_size = (size_t) cluster_block_size;
+	}
+	if( bitmap_values->data_table_index != (int64_t) table_index )
+	{
+		bitmap_values->data_table_index = -1;
+
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              bitmap_values->data,
+		              bitmap_values->data_size,
+		              bitmap_cluster_offset,
+		              error );
+
+		if( read_count != (ssize_t) bitmap_values->data_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read bitmap cluster at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 bitmap_cluster_offset,
+			 bitmap_cluster_offset );
+
+			return( -1 );
+		}
+		bitmap_values->data_table_index = (int64_t) table_index;
+	}
+	*data = bitmap_values->data;
+
+	return( 1 );
+}
+
+/* Finds the first bit with a specific value in the range [start, end)
+ * The bits are stored least significant bit first
+ * Returns 1 if successful, 0 if no such bit was found or -1 on error
+ */
+int libqcow_bitmap_values_find_bit(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     uint64_t start_bit_index,
+     uint64_t end_bit_index,
+     uint8_t bit_value,
+     uint64_t *bit_index,
+     libcerror_error_t **error )
+{
+	uint8_t *data              = NULL;
+	static char *function      = "libqcow_bitmap_values_find_bit";
+	uint64_t bits_per_cluster  = 0;
+	uint64_t cluster_bit_end   = 0;
+	uint64_t cluster_bit_index = 0;
+	uint64_t cluster_start     = 0;
+	uint64_t current_bit_index = 0;
+	uint8_t byte_value         = 0;
+	uint8_t fill_value         = 0;
+	uint8_t match_value        = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block_size == 0 )
+	 || ( cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( bit_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bit index.",
+		 function );
+
+		return( -1 );
+	}
+	/* The match value is XOR-ed with the bitmap data so that
+	 * the bits that are searched for become 1
+	 */
+	if( bit_value == 0 )
+	{
+		match_value = 0xff;
+	}
+	bits_per_cluster  = (uint64_t) cluster_block_size * 8;
+	current_bit_index = start_bit_index;
+
+	while( current_bit_index < end_bit_index )
+	{
+		cluster_bit_index = current_bit_index % bits_per_cluster;
+		cluster_start     = current_bit_index - cluster_bit_index;
+		cluster_bit_end   = end_bit_index - cluster_start;
+
+		if( cluster_bit_end > bits_per_cluster )
+		{
+			cluster_bit_end = bits_per_cluster;
+		}
+		if( libqcow_bitmap_values_get_cluster_data(
+		     bitmap_values,
+		     file_io_handle,
+		     cluster_block_size,
+		     current_bit_index / bits_per_cluster,
+		     &data,
+		     &fill_value,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve bitmap cluster data.",
+			 function );
+
+			return( -1 );
+		}
+		if( data == NULL )
+		{
+			if( ( fill_value ^ match_value ) != 0 )
+			{
+				*bit_index = current_bit_index;
+
+				return( 1 );
+			}
+		}
+		else
+		{
+			while( cluster_bit_index < cluster_bit_end )
+			{
+				byte_value = data[ cluster_bit_index / 8 ] ^ match_value;
+
+				byte_value >>= cluster_bit_index % 8;
+
+				if( byte_value == 0 )
+				{
+					cluster_bit_index = ( cluster_bit_index | 7 ) + 1;
+
+					continue;
+				}
+				while( ( byte_value & 0x01 ) == 0 )
+				{
+					byte_value >>= 1;
+
+					cluster_bit_index++;
+				}
+				if( cluster_bit_index >= cluster_bit_end )
+				{
+					break;
+				}
+				*bit_index = cluster_start + cluster_bit_index;
+
+				return( 1 );
+			}
+		}
+		current_bit_index = cluster_start + cluster_bit_end;
+	}
+	return( 0 );
+}
+
+/* Retrieves the next changed extent at or after a specific offset
+ * The extent is clamped to the media size
+ * Returns 1 if successful, 0 if there are no more changed extents or -1 on error
+ */
+int libqcow_bitmap_values_get_changed_extent(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     size64_t media_size,
+     off64_t offset,
+     off64_t *extent_offset,
+     size64_t *extent_size,
+     libcerror_error_t **error )
+{
+	static char *function    = "libqcow_bitmap_values_get_changed_extent";
+	size64_t extent_end      = 0;
+	size64_t extent_start    = 0;
+	uint64_t clear_bit_index = 0;
+	uint64_t number_of_bits  = 0;
+	uint64_t set_bit_index   = 0;
+	int result               = 0;
+
+	if( bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bitmap values.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( bitmap_values->flags & LIBQCOW_BITMAP_FLAG_IN_USE ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported bitmap - bitmap is in use and inconsistent.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( bitmap_values->extra_data_size != 0 )
+	 && ( ( bitmap_values->flags & LIBQCOW_BITMAP_FLAG_EXTRA_DATA_COMPATIBLE ) == 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported bitmap - incompatible extra data.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent size.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= media_size )
+	{
+		return( 0 );
+	}
+	if( libqcow_bitmap_values_read_bitmap_table(
+	     bitmap_values,
+	     file_io_handle,
+	     cluster_block_size,
+	     media_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read bitmap table.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_bits = media_size >> bitmap_values->granularity_bits;
+
+	if( ( media_size & ( ( (size64_t) 1 << bitmap_values->granularity_bits ) - 1 ) ) != 0 )
+	{
+		number_of_bits += 1;
+	}
+	result = libqcow_bitmap_values_find_bit(
+	          bitmap_values,
+	          file_io_handle,
+	          cluster_block_size,
+	          (uint64_t) offset >> bitmap_values->granularity_bits,
+	          number_of_bits,
+	          1,
+	          &set_bit_index,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to find start of changed extent.",
+		 function );
+
+		return( -1 );
+	}
+	else if( result == 0 )
+	{
+		return( 0 );
+	}
+	result = libqcow_bitmap_values_find_bit(
+	          bitmap_values,
+	          file_io_handle,
+	          cluster_block_size,
+	          set_bit_index + 1,
+	          number_of_bits,
+	          0,
+	          &clear_bit_index,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to find end of changed extent.",
+		 function );
+
+		return( -1 );
+	}
+	else if( result == 0 )
+	{
+		clear_bit_index = number_of_bits;
+	}
+	extent_start = (size64_t) set_bit_index << bitmap_values->granularity_bits;
+	extent_end   = (size64_t) clear_bit_index << bitmap_values->granularity_bits;
+
+	if( extent_start < (size64_t) offset )
+	{
+		extent_start = (size64_t) offset;
+	}
+	if( extent_end > media_size )
+	{
+		extent_end = media_size;
+	}
+	*extent_offset = (off64_t) extent_start;
+	*extent_size   = extent_end - extent_start;
+
+	return( 1 );
+}
+
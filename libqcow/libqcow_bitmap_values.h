@@ -0,0 +1,173 @@
+/*
+ * Bitmap values functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_BITMAP_VALUES_H )
+#define _LIBQCOW_BITMAP_VALUES_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cluster_table.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_bitmap_values libqcow_bitmap_values_t;
+
+struct libqcow_bitmap_values
+{
+	/* The bitmap table offset
+	 */
+	off64_t bitmap_table_offset;
+
+	/* The bitmap table size, which is the number of entries
+	 */
+	uint32_t bitmap_table_size;
+
+	/* The flags
+	 */
+	uint32_t flags;
+
+	/* The type
+	 */
+	uint8_t type;
+
+	/* The granularity bits
+	 */
+	uint8_t granularity_bits;
+
+	/* The extra data size
+	 */
+	uint32_t extra_data_size;
+
+	/* The name
+	 */
+	uint8_t *name;
+
+	/* The name size
+	 */
+	size_t name_size;
+
+	/* The bitmap table, which is read on first use
+	 */
+	libqcow_cluster_table_t *bitmap_table;
+
+	/* The data of the most recently read bitmap cluster
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size_t data_size;
+
+	/* The bitmap table index of the data, where -1 represents none
+	 */
+	int64_t data_table_index;
+};
+
+int libqcow_bitmap_values_initialize(
+     libqcow_bitmap_values_t **bitmap_values,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_free(
+     libqcow_bitmap_values_t **bitmap_values,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_read_data(
+     libqcow_bitmap_values_t *bitmap_values,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_read_file_io_handle(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     size_t *entry_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_utf8_name_size(
+     libqcow_bitmap_values_t *bitmap_values,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_utf8_name(
+     libqcow_bitmap_values_t *bitmap_values,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_utf16_name_size(
+     libqcow_bitmap_values_t *bitmap_values,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_utf16_name(
+     libqcow_bitmap_values_t *bitmap_values,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_read_bitmap_table(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     size64_t media_size,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_cluster_data(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     uint64_t table_index,
+     uint8_t **data,
+     uint8_t *fill_value,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_find_bit(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     uint64_t start_bit_index,
+     uint64_t end_bit_index,
+     uint8_t bit_value,
+     uint64_t *bit_index,
+     libcerror_error_t **error );
+
+int libqcow_bitmap_values_get_changed_extent(
+     libqcow_bitmap_values_t *bitmap_values,
+     libbfio_handle_t *file_io_handle,
+     size64_t cluster_block_size,
+     size64_t media_size,
+     off64_t offset,
+     off64_t *extent_offset,
+     size64_t *extent_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_BITMAP_VALUES_H ) */
+
@@ -0,0 +1,1009 @@
+/*
+ * Block cache functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_block_cache.h"
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+
+/* Determines the hash table index of a key
+ * The key is an offset of at least 512 byte aligned data hence the lower 9 bits are ignored
+ */
+#define libqcow_block_cache_get_hash_table_index( block_cache, key ) \
+	(size_t) ( ( ( (uint64_t) ( key ) >> 9 ) * (uint64_t) 0x9e3779b97f4a7c15ULL ) >> ( 64 - ( block_cache )->number_of_hash_table_bits ) )
+
+/* Creates a block cache
+ * Make sure the value block_cache is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_initialize(
+     libqcow_block_cache_t **block_cache,
+     int maximum_number_of_entries,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_block_cache_initialize";
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( *block_cache != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid block cache value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( maximum_number_of_entries <= 0 )
+	 || ( maximum_number_of_entries > LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid maximum number of entries value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*block_cache = memory_allocate_structure(
+	                libqcow_block_cache_t );
+
+	if( *block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create block cache.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *block_cache,
+	     0,
+	     sizeof( libqcow_block_cache_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear block cache.",
+		 function );
+
+		memory_free(
+		 *block_cache );
+
+		*block_cache = NULL;
+
+		return( -1 );
+	}
+	if( libqcow_block_cache_resize(
+	     *block_cache,
+	     maximum_number_of_entries,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+		 "%s: unable to resize block cache.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 block_cache,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Frees a block cache
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_free(
+     libqcow_block_cache_t **block_cache,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *entry      = NULL;
+	libqcow_block_cache_entry_t *next_entry = NULL;
+	static char *function                   = "libqcow_block_cache_free";
+	int result                              = 1;
+	int segment                             = 0;
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( *block_cache != NULL )
+	{
+		for( segment = 0;
+		     segment < LIBQCOW_BLOCK_CACHE_NUMBER_OF_SEGMENTS;
+		     segment++ )
+		{
+			entry = ( *block_cache )->first_entry[ segment ];
+
+			while( entry != NULL )
+			{
+				next_entry = entry->next_entry;
+
+				if( ( entry->value != NULL )
+				 && ( entry->free_value != NULL ) )
+				{
+					if( entry->free_value(
+					     &( entry->value ),
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+						 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+						 "%s: unable to free value.",
+						 function );
+
+						result = -1;
+					}
+				}
+				memory_free(
+				 entry );
+
+				entry = next_entry;
+			}
+		}
+		if( ( *block_cache )->hash_table != NULL )
+		{
+			memory_free(
+			 ( *block_cache )->hash_table );
+		}
+		memory_free(
+		 *block_cache );
+
+		*block_cache = NULL;
+	}
+	return( result );
+}
+
+/* Resizes a block cache
+ * Values that no longer fit are evicted, least recently used first
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_resize(
+     libqcow_block_cache_t *block_cache,
+     int maximum_number_of_entries,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_block_cache_resize";
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( maximum_number_of_entries <= 0 )
+	 || ( maximum_number_of_entries > LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid maximum number of entries value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	block_cache->maximum_number_of_entries        = maximum_number_of_entries;
+	block_cache->maximum_number_of_recent_entries = maximum_number_of_entries / 4;
+	block_cache->maximum_number_of_ghost_entries  = maximum_number_of_entries / 2;
+
+	if( block_cache->maximum_number_of_recent_entries == 0 )
+	{
+		block_cache->maximum_number_of_recent_entries = 1;
+	}
+	if( block_cache->maximum_number_of_ghost_entries == 0 )
+	{
+		block_cache->maximum_number_of_ghost_entries = 1;
+	}
+	while( ( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ]
+	       + block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ] ) > maximum_number_of_entries )
+	{
+		if( libqcow_block_cache_evict_entry(
+		     block_cache,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+			 "%s: unable to evict entry.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	libqcow_block_cache_trim_ghost_entries(
+	 block_cache );
+
+	if( libqcow_block_cache_set_hash_table_size(
+	     block_cache,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+		 "%s: unable to resize hash table.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the number of entries that have a value
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_get_number_of_entries(
+     libqcow_block_cache_t *block_cache,
+     int *number_of_entries,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_block_cache_get_number_of_entries";
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_entries == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of entries.",
+		 function );
+
+		return( -1 );
+	}
+	*number_of_entries = block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ]
+	                   + block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ];
+
+	return( 1 );
+}
+
+/* Retrieves the value of a specific key
+ * The value remains managed by the block cache and is only valid until the next call
+ * that sets a value or resizes the block cache
+ * Returns 1 if successful, 0 if no such value or -1 on error
+ */
+int libqcow_block_cache_get_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     intptr_t **value,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+	static char *function              = "libqcow_block_cache_get_value_by_key";
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid value.",
+		 function );
+
+		return( -1 );
+	}
+	entry = libqcow_block_cache_find_entry(
+	         block_cache,
+	         key );
+
+	if( ( entry == NULL )
+	 || ( entry->segment == LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST ) )
+	{
+		block_cache->number_of_misses += 1;
+
+		*value = NULL;
+
+		return( 0 );
+	}
+	/* Values in the recent segment are not moved on a hit, since repeated
+	 * reads of the same block in a short time are typical for a sequential scan
+	 */
+	if( ( entry->segment == LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT )
+	 && ( entry != block_cache->first_entry[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ] ) )
+	{
+		libqcow_block_cache_unlink_entry(
+		 block_cache,
+		 entry );
+
+		libqcow_block_cache_link_entry(
+		 block_cache,
+		 entry,
+		 LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT );
+	}
+	block_cache->number_of_hits += 1;
+
+	*value = entry->value;
+
+	return( 1 );
+}
+
+/* Sets the value of a specific key
+ * On success the block cache manages the value, it is freed using free_value
+ * when evicted or when the block cache is freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_set_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     intptr_t *value,
+     int (*free_value)(
+            intptr_t **value,
+            libcerror_error_t **error ),
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+	static char *function              = "libqcow_block_cache_set_value_by_key";
+	int segment                        = LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT;
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid value.",
+		 function );
+
+		return( -1 );
+	}
+	entry = libqcow_block_cache_find_entry(
+	         block_cache,
+	         key );
+
+	if( ( entry != NULL )
+	 && ( entry->segment != LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST ) )
+	{
+		if( entry->value != value )
+		{
+			if( entry->free_value != NULL )
+			{
+				if( entry->free_value(
+				     &( entry->value ),
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+					 "%s: unable to free value.",
+					 function );
+
+					return( -1 );
+				}
+			}
+			entry->value = value;
+		}
+		entry->free_value = free_value;
+
+		return( 1 );
+	}
+	while( ( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ]
+	       + block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ] ) >= block_cache->maximum_number_of_entries )
+	{
+		if( libqcow_block_cache_evict_entry(
+		     block_cache,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+			 "%s: unable to evict entry.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	/* The eviction can have removed the ghost entry of the key
+	 */
+	entry = libqcow_block_cache_find_entry(
+	         block_cache,
+	         key );
+
+	if( entry != NULL )
+	{
+		/* A key that was recently evicted is used more than once
+		 */
+		libqcow_block_cache_unlink_entry(
+		 block_cache,
+		 entry );
+
+		segment = LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT;
+	}
+	else
+	{
+		entry = memory_allocate_structure(
+		         libqcow_block_cache_entry_t );
+
+		if( entry == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create entry.",
+			 function );
+
+			return( -1 );
+		}
+		if( memory_set(
+		     entry,
+		     0,
+		     sizeof( libqcow_block_cache_entry_t ) ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear entry.",
+			 function );
+
+			memory_free(
+			 entry );
+
+			return( -1 );
+		}
+		entry->key = key;
+
+		libqcow_block_cache_insert_hash_entry(
+		 block_cache,
+		 entry );
+	}
+	entry->value      = value;
+	entry->free_value = free_value;
+
+	libqcow_block_cache_link_entry(
+	 block_cache,
+	 entry,
+	 segment );
+
+	return( 1 );
+}
+
+/* Removes the value of a specific key
+ * The key is removed without leaving a ghost entry
+ * Returns 1 if successful, 0 if no such value or -1 on error
+ */
+int libqcow_block_cache_remove_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+	static char *function              = "libqcow_block_cache_remove_value_by_key";
+	int result                         = 1;
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	entry = libqcow_block_cache_find_entry(
+	         block_cache,
+	         key );
+
+	if( entry == NULL )
+	{
+		return( 0 );
+	}
+	if( entry->segment == LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST )
+	{
+		result = 0;
+	}
+	libqcow_block_cache_unlink_entry(
+	 block_cache,
+	 entry );
+
+	libqcow_block_cache_remove_hash_entry(
+	 block_cache,
+	 entry );
+
+	if( ( entry->value != NULL )
+	 && ( entry->free_value != NULL ) )
+	{
+		if( entry->free_value(
+		     &( entry->value ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free value.",
+			 function );
+
+			result = -1;
+		}
+	}
+	memory_free(
+	 entry );
+
+	return( result );
+}
+
+/* Retrieves the block cache statistics
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_get_statistics(
+     libqcow_block_cache_t *block_cache,
+     uint64_t *number_of_hits,
+     uint64_t *number_of_misses,
+     uint64_t *number_of_evictions,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_block_cache_get_statistics";
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_hits == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of hits.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_misses == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of misses.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_evictions == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of evictions.",
+		 function );
+
+		return( -1 );
+	}
+	*number_of_hits      = block_cache->number_of_hits;
+	*number_of_misses    = block_cache->number_of_misses;
+	*number_of_evictions = block_cache->number_of_evictions;
+
+	return( 1 );
+}
+
+/* Sets the hash table size to fit the maximum number of entries, including ghost entries
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_set_hash_table_size(
+     libqcow_block_cache_t *block_cache,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t **hash_table = NULL;
+	libqcow_block_cache_entry_t *entry       = NULL;
+	static char *function                    = "libqcow_block_cache_set_hash_table_size";
+	size_t hash_table_size                   = 0;
+	size_t number_of_entries                 = 0;
+	uint8_t number_of_hash_table_bits        = 1;
+	int segment                              = 0;
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_entries = (size_t) block_cache->maximum_number_of_entries
+	                  + (size_t) block_cache->maximum_number_of_ghost_entries;
+
+	while( ( (size_t) 1 << number_of_hash_table_bits ) < number_of_entries )
+	{
+		number_of_hash_table_bits++;
+	}
+	if( ( block_cache->hash_table != NULL )
+	 && ( block_cache->number_of_hash_table_bits == number_of_hash_table_bits ) )
+	{
+		return( 1 );
+	}
+	hash_table_size = sizeof( libqcow_block_cache_entry_t * ) << number_of_hash_table_bits;
+
+	hash_table = (libqcow_block_cache_entry_t **) memory_allocate(
+	                                               hash_table_size );
+
+	if( hash_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create hash table.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     hash_table,
+	     0,
+	     hash_table_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear hash table.",
+		 function );
+
+		memory_free(
+		 hash_table );
+
+		return( -1 );
+	}
+	if( block_cache->hash_table != NULL )
+	{
+		memory_free(
+		 block_cache->hash_table );
+	}
+	block_cache->hash_table                = hash_table;
+	block_cache->number_of_hash_table_bits = number_of_hash_table_bits;
+
+	for( segment = 0;
+	     segment < LIBQCOW_BLOCK_CACHE_NUMBER_OF_SEGMENTS;
+	     segment++ )
+	{
+		for( entry = block_cache->first_entry[ segment ];
+		     entry != NULL;
+		     entry = entry->next_entry )
+		{
+			libqcow_block_cache_insert_hash_entry(
+			 block_cache,
+			 entry );
+		}
+	}
+	return( 1 );
+}
+
+/* Finds the entry of a specific key
+ * Returns the entry or NULL if not available
+ */
+libqcow_block_cache_entry_t *libqcow_block_cache_find_entry(
+                              libqcow_block_cache_t *block_cache,
+                              uint64_t key )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+
+	entry = block_cache->hash_table[ libqcow_block_cache_get_hash_table_index( block_cache, key ) ];
+
+	while( entry != NULL )
+	{
+		if( entry->key == key )
+		{
+			break;
+		}
+		entry = entry->next_bucket_entry;
+	}
+	return( entry );
+}
+
+/* Links an entry as the most recently used entry of a segment
+ */
+void libqcow_block_cache_link_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry,
+      int segment )
+{
+	entry->segment        = segment;
+	entry->previous_entry = NULL;
+	entry->next_entry     = block_cache->first_entry[ segment ];
+
+	if( entry->next_entry != NULL )
+	{
+		entry->next_entry->previous_entry = entry;
+	}
+	else
+	{
+		block_cache->last_entry[ segment ] = entry;
+	}
+	block_cache->first_entry[ segment ] = entry;
+
+	block_cache->number_of_entries[ segment ] += 1;
+}
+
+/* Unlinks an entry from its segment
+ */
+void libqcow_block_cache_unlink_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry )
+{
+	if( entry->previous_entry != NULL )
+	{
+		entry->previous_entry->next_entry = entry->next_entry;
+	}
+	else
+	{
+		block_cache->first_entry[ entry->segment ] = entry->next_entry;
+	}
+	if( entry->next_entry != NULL )
+	{
+		entry->next_entry->previous_entry = entry->previous_entry;
+	}
+	else
+	{
+		block_cache->last_entry[ entry->segment ] = entry->previous_entry;
+	}
+	entry->previous_entry = NULL;
+	entry->next_entry     = NULL;
+
+	block_cache->number_of_entries[ entry->segment ] -= 1;
+}
+
+/* Inserts an entry into the hash table
+ */
+void libqcow_block_cache_insert_hash_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry )
+{
+	size_t hash_table_index = libqcow_block_cache_get_hash_table_index( block_cache, entry->key );
+
+	entry->next_bucket_entry                    = block_cache->hash_table[ hash_table_index ];
+	block_cache->hash_table[ hash_table_index ] = entry;
+}
+
+/* Removes an entry from the hash table
+ */
+void libqcow_block_cache_remove_hash_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry )
+{
+	libqcow_block_cache_entry_t **bucket_entry = NULL;
+
+	bucket_entry = &( block_cache->hash_table[ libqcow_block_cache_get_hash_table_index( block_cache, entry->key ) ] );
+
+	while( *bucket_entry != NULL )
+	{
+		if( *bucket_entry == entry )
+		{
+			*bucket_entry = entry->next_bucket_entry;
+
+			break;
+		}
+		bucket_entry = &( ( *bucket_entry )->next_bucket_entry );
+	}
+	entry->next_bucket_entry = NULL;
+}
+
+/* Removes the least recently used ghost entries that exceed the maximum
+ */
+void libqcow_block_cache_trim_ghost_entries(
+      libqcow_block_cache_t *block_cache )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+
+	while( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST ] > block_cache->maximum_number_of_ghost_entries )
+	{
+		entry = block_cache->last_entry[ LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST ];
+
+		libqcow_block_cache_unlink_entry(
+		 block_cache,
+		 entry );
+
+		libqcow_block_cache_remove_hash_entry(
+		 block_cache,
+		 entry );
+
+		memory_free(
+		 entry );
+	}
+}
+
+/* Evicts the value of the least recently used entry
+ * The value is taken from the recent segment when it exceeds its maximum,
+ * its key is kept as a ghost entry, otherwise from the frequent segment
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_block_cache_evict_entry(
+     libqcow_block_cache_t *block_cache,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *entry = NULL;
+	static char *function              = "libqcow_block_cache_evict_entry";
+	int result                         = 1;
+	uint8_t keep_as_ghost              = 0;
+
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid block cache.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ] > 0 )
+	 && ( ( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ] >= block_cache->maximum_number_of_recent_entries )
+	  ||  ( block_cache->number_of_entries[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ] == 0 ) ) )
+	{
+		entry         = block_cache->last_entry[ LIBQCOW_BLOCK_CACHE_SEGMENT_RECENT ];
+		keep_as_ghost = 1;
+	}
+	else
+	{
+		entry = block_cache->last_entry[ LIBQCOW_BLOCK_CACHE_SEGMENT_FREQUENT ];
+	}
+	if( entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing entry.",
+		 function );
+
+		return( -1 );
+	}
+	libqcow_block_cache_unlink_entry(
+	 block_cache,
+	 entry );
+
+	if( ( entry->value != NULL )
+	 && ( entry->free_value != NULL ) )
+	{
+		if( entry->free_value(
+		     &( entry->value ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free value.",
+			 function );
+
+			result = -1;
+		}
+	}
+	entry->value      = NULL;
+	entry->free_value = NULL;
+
+	if( keep_as_ghost != 0 )
+	{
+		libqcow_block_cache_link_entry(
+		 block_cache,
+		 entry,
+		 LIBQCOW_BLOCK_CACHE_SEGMENT_GHOST );
+
+		libqcow_block_cache_trim_ghost_entries(
+		 block_cache );
+	}
+	else
+	{
+		libqcow_block_cache_remove_hash_entry(
+		 block_cache,
+		 entry );
+
+		memory_free(
+		 entry );
+	}
+	block_cache->number_of_evictions += 1;
+
+	return( result );
+}
+
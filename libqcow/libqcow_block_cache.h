@@ -0,0 +1,209 @@
+/*
+ * Block cache functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_BLOCK_CACHE_H )
+#define _LIBQCOW_BLOCK_CACHE_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_block_cache_entry libqcow_block_cache_entry_t;
+
+struct libqcow_block_cache_entry
+{
+	/* The key
+	 */
+	uint64_t key;
+
+	/* The value, which is NULL for a ghost entry
+	 */
+	intptr_t *value;
+
+	/* The value free function
+	 */
+	int (*free_value)(
+	       intptr_t **value,
+	       libcerror_error_t **error );
+
+	/* The segment
+	 */
+	int segment;
+
+	/* The next entry in the same hash table bucket
+	 */
+	libqcow_block_cache_entry_t *next_bucket_entry;
+
+	/* The previous (more recently used) entry in the segment
+	 */
+	libqcow_block_cache_entry_t *previous_entry;
+
+	/* The next (less recently used) entry in the segment
+	 */
+	libqcow_block_cache_entry_t *next_entry;
+};
+
+typedef struct libqcow_block_cache libqcow_block_cache_t;
+
+/* The block cache uses the 2Q replacement policy
+ * New values enter a FIFO of recently used values. Values evicted from
+ * this FIFO leave their key behind in a ghost list. A value that is set
+ * again while its key is in the ghost list enters the LRU of frequently
+ * used values. This keeps a single sequential scan from evicting
+ * the frequently used values.
+ */
+struct libqcow_block_cache
+{
+	/* The maximum number of entries that have a value
+	 */
+	int maximum_number_of_entries;
+
+	/* The maximum number of entries in the recent segment
+	 */
+	int maximum_number_of_recent_entries;
+
+	/* The maximum number of entries in the ghost segment
+	 */
+	int maximum_number_of_ghost_entries;
+
+	/* The number of entries per segment
+	 */
+	int number_of_entries[ LIBQCOW_BLOCK_CACHE_NUMBER_OF_SEGMENTS ];
+
+	/* The first (most recently used) entry per segment
+	 */
+	libqcow_block_cache_entry_t *first_entry[ LIBQCOW_BLOCK_CACHE_NUMBER_OF_SEGMENTS ];
+
+	/* The last (least recently used) entry per segment
+	 */
+	libqcow_block_cache_entry_t *last_entry[ LIBQCOW_BLOCK_CACHE_NUMBER_OF_SEGMENTS ];
+
+	/* The hash table
+	 */
+	libqcow_block_cache_entry_t **hash_table;
+
+	/* The number of hash table bits
+	 */
+	uint8_t number_of_hash_table_bits;
+
+	/* The number of hits
+	 */
+	uint64_t number_of_hits;
+
+	/* The number of misses
+	 */
+	uint64_t number_of_misses;
+
+	/* The number of evictions
+	 */
+	uint64_t number_of_evictions;
+};
+
+int libqcow_block_cache_initialize(
+     libqcow_block_cache_t **block_cache,
+     int maximum_number_of_entries,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_free(
+     libqcow_block_cache_t **block_cache,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_resize(
+     libqcow_block_cache_t *block_cache,
+     int maximum_number_of_entries,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_get_number_of_entries(
+     libqcow_block_cache_t *block_cache,
+     int *number_of_entries,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_get_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     intptr_t **value,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_set_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     intptr_t *value,
+     int (*free_value)(
+            intptr_t **value,
+            libcerror_error_t **error ),
+     libcerror_error_t **error );
+
+int libqcow_block_cache_remove_value_by_key(
+     libqcow_block_cache_t *block_cache,
+     uint64_t key,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_get_statistics(
+     libqcow_block_cache_t *block_cache,
+     uint64_t *number_of_hits,
+     uint64_t *number_of_misses,
+     uint64_t *number_of_evictions,
+     libcerror_error_t **error );
+
+int libqcow_block_cache_set_hash_table_size(
+     libqcow_block_cache_t *block_cache,
+     libcerror_error_t **error );
+
+libqcow_block_cache_entry_t *libqcow_block_cache_find_entry(
+                              libqcow_block_cache_t *block_cache,
+                              uint64_t key );
+
+void libqcow_block_cache_link_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry,
+      int segment );
+
+void libqcow_block_cache_unlink_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry );
+
+void libqcow_block_cache_insert_hash_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry );
+
+void libqcow_block_cache_remove_hash_entry(
+      libqcow_block_cache_t *block_cache,
+      libqcow_block_cache_entry_t *entry );
+
+void libqcow_block_cache_trim_ghost_entries(
+      libqcow_block_cache_t *block_cache );
+
+int libqcow_block_cache_evict_entry(
+     libqcow_block_cache_t *block_cache,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_BLOCK_CACHE_H ) */
+
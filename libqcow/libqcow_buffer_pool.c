@@ -0,0 +1,587 @@
+/*
+ * Buffer pool functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_buffer_pool.h"
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+/* Creates a buffer pool
+ * Make sure the value buffer_pool is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_buffer_pool_initialize(
+     libqcow_buffer_pool_t **buffer_pool,
+     size_t buffer_size,
+     int maximum_number_of_free_buffers,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_buffer_pool_initialize";
+
+	if( buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *buffer_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid buffer pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( buffer_size == 0 )
+	 || ( buffer_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid buffer size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( maximum_number_of_free_buffers < 0 )
+	 || ( maximum_number_of_free_buffers > LIBQCOW_BUFFER_POOL_MAXIMUM_NUMBER_OF_FREE_BUFFERS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid maximum number of free buffers value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*buffer_pool = memory_allocate_structure(
+	                libqcow_buffer_pool_t );
+
+	if( *buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create buffer pool.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *buffer_pool,
+	     0,
+	     sizeof( libqcow_buffer_pool_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear buffer pool.",
+		 function );
+
+		memory_free(
+		 *buffer_pool );
+
+		*buffer_pool = NULL;
+
+		return( -1 );
+	}
+	if( maximum_number_of_free_buffers > 0 )
+	{
+		( *buffer_pool )->free_buffers = (uint8_t **) memory_allocate(
+		                                               sizeof( uint8_t * ) * maximum_number_of_free_buffers );
+
+		if( ( *buffer_pool )->free_buffers == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create free buffers.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	( *buffer_pool )->buffer_size                    = buffer_size;
+	( *buffer_pool )->maximum_number_of_free_buffers = maximum_number_of_free_buffers;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *buffer_pool )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *buffer_pool != NULL )
+	{
+		if( ( *buffer_pool )->free_buffers != NULL )
+		{
+			memory_free(
+			 ( *buffer_pool )->free_buffers );
+		}
+		memory_free(
+		 *buffer_pool );
+
+		*buffer_pool = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a buffer pool
+ * The free buffers are cleared before they are freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_buffer_pool_free(
+     libqcow_buffer_pool_t **buffer_pool,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_buffer_pool_free";
+	int buffer_index      = 0;
+	int result            = 1;
+
+	if( buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *buffer_pool != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_free(
+		     &( ( *buffer_pool )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		for( buffer_index = 0;
+		     buffer_index < ( *buffer_pool )->number_of_free_buffers;
+		     buffer_index++ )
+		{
+			if( memory_set(
+			     ( *buffer_pool )->free_buffers[ buffer_index ],
+			     0,
+			     ( *buffer_pool )->buffer_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to clear free buffer: %d.",
+				 function,
+				 buffer_index );
+
+				result = -1;
+			}
+			memory_free(
+			 ( *buffer_pool )->free_buffers[ buffer_index ] );
+		}
+		if( ( *buffer_pool )->free_buffers != NULL )
+		{
+			memory_free(
+			 ( *buffer_pool )->free_buffers );
+		}
+		memory_free(
+		 *buffer_pool );
+
+		*buffer_pool = NULL;
+	}
+	return( result );
+}
+
+/* Retrieves a buffer of a specific data size
+ * A data size that does not exceed the buffer size is served by a buffer of the buffer size,
+ * which is a free buffer if available. A larger data size is allocated individually.
+ * The buffer must be released with the same data size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_buffer_pool_get_buffer(
+     libqcow_buffer_pool_t *buffer_pool,
+     size_t data_size,
+     uint8_t **buffer,
+     libcerror_error_t **error )
+{
+	uint8_t *safe_buffer  = NULL;
+	static char *function = "libqcow_buffer_pool_get_buffer";
+	size_t allocated_size = 0;
+
+	if( buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size == 0 )
+	 || ( data_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size <= buffer_pool->buffer_size )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_grab(
+		     buffer_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( buffer_pool->number_of_free_buffers > 0 )
+		{
+			buffer_pool->number_of_free_buffers -= 1;
+
+			safe_buffer = buffer_pool->free_buffers[ buffer_pool->number_of_free_buffers ];
+
+			buffer_pool->free_buffers[ buffer_pool->number_of_free_buffers ] = NULL;
+
+			buffer_pool->number_of_reuses += 1;
+		}
+		else
+		{
+			buffer_pool->number_of_allocations += 1;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_release(
+		     buffer_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			goto on_error;
+		}
+#endif
+		allocated_size = buffer_pool->buffer_size;
+	}
+	else
+	{
+		allocated_size = data_size;
+	}
+	if( safe_buffer == NULL )
+	{
+		safe_buffer = (uint8_t *) memory_allocate(
+		                           sizeof( uint8_t ) * allocated_size );
+
+		if( safe_buffer == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create buffer.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	*buffer = safe_buffer;
+
+	return( 1 );
+
+on_error:
+	if( safe_buffer != NULL )
+	{
+		memory_free(
+		 safe_buffer );
+	}
+	return( -1 );
+}
+
+/* Releases a buffer that was retrieved with a specific data size
+ * The buffer is kept as a free buffer if it is of the buffer size and the maximum
+ * number of free buffers has not been reached, otherwise it is cleared and freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_buffer_pool_release_buffer(
+     libqcow_buffer_pool_t *buffer_pool,
+     uint8_t **buffer,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_buffer_pool_release_buffer";
+	size_t allocated_size = 0;
+	uint8_t is_free       = 0;
+	int result            = 1;
+
+	if( buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( *buffer == NULL )
+	{
+		return( 1 );
+	}
+	if( data_size <= buffer_pool->buffer_size )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_grab(
+		     buffer_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( buffer_pool->number_of_free_buffers < buffer_pool->maximum_number_of_free_buffers )
+		{
+			buffer_pool->free_buffers[ buffer_pool->number_of_free_buffers ] = *buffer;
+
+			buffer_pool->number_of_free_buffers += 1;
+
+			*buffer = NULL;
+			is_free = 1;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_release(
+		     buffer_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		allocated_size = buffer_pool->buffer_size;
+	}
+	else
+	{
+		allocated_size = data_size;
+	}
+	if( is_free == 0 )
+	{
+		if( memory_set(
+		     *buffer,
+		     0,
+		     allocated_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear buffer.",
+			 function );
+
+			result = -1;
+		}
+		memory_free(
+		 *buffer );
+	}
+	*buffer = NULL;
+
+	return( result );
+}
+
+/* Retrieves the buffer pool statistics
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_buffer_pool_get_statistics(
+     libqcow_buffer_pool_t *buffer_pool,
+     uint64_t *number_of_allocations,
+     uint64_t *number_of_reuses,
+     int *number_of_free_buffers,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_buffer_pool_get_statistics";
+
+	if( buffer_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_allocations == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of allocations.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_reuses == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of reuses.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_free_buffers == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of free buffers.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     buffer_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*number_of_allocations  = buffer_pool->number_of_allocations;
+	*number_of_reuses       = buffer_pool->number_of_reuses;
+	*number_of_free_buffers = buffer_pool->number_of_free_buffers;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     buffer_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
@@ -0,0 +1,109 @@
+/*
+ * Buffer pool functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_BUFFER_POOL_H )
+#define _LIBQCOW_BUFFER_POOL_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_buffer_pool libqcow_buffer_pool_t;
+
+/* The buffer pool recycles buffers of a fixed size, such as the cluster block size
+ * A buffer that is released is kept for reuse, up to a maximum number of free buffers,
+ * so that a cache miss does not need to allocate and page in a new buffer.
+ * Requests for a size larger than the fixed size are allocated individually
+ */
+struct libqcow_buffer_pool
+{
+	/* The (fixed) buffer size
+	 */
+	size_t buffer_size;
+
+	/* The free buffers
+	 */
+	uint8_t **free_buffers;
+
+	/* The number of free buffers
+	 */
+	int number_of_free_buffers;
+
+	/* The maximum number of free buffers
+	 */
+	int maximum_number_of_free_buffers;
+
+	/* The number of buffers that were allocated
+	 */
+	uint64_t number_of_allocations;
+
+	/* The number of buffers that were reused
+	 */
+	uint64_t number_of_reuses;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex
+	 */
+	libcthreads_mutex_t *mutex;
+#endif
+};
+
+int libqcow_buffer_pool_initialize(
+     libqcow_buffer_pool_t **buffer_pool,
+     size_t buffer_size,
+     int maximum_number_of_free_buffers,
+     libcerror_error_t **error );
+
+int libqcow_buffer_pool_free(
+     libqcow_buffer_pool_t **buffer_pool,
+     libcerror_error_t **error );
+
+int libqcow_buffer_pool_get_buffer(
+     libqcow_buffer_pool_t *buffer_pool,
+     size_t data_size,
+     uint8_t **buffer,
+     libcerror_error_t **error );
+
+int libqcow_buffer_pool_release_buffer(
+     libqcow_buffer_pool_t *buffer_pool,
+     uint8_t **buffer,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_buffer_pool_get_statistics(
+     libqcow_buffer_pool_t *buffer_pool,
+     uint64_t *number_of_allocations,
+     uint64_t *number_of_reuses,
+     int *number_of_free_buffers,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_BUFFER_POOL_H ) */
+
@@ -0,0 +1,432 @@
+/*
+ * Cache budget functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cache_budget.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_once.h"
+
+/* The process wide maximum cache size, where 0 represents no maximum
+ */
+static size64_t libqcow_cache_budget_maximum_size = 0;
+
+/* The cache size reserved by open files
+ */
+static size64_t libqcow_cache_budget_reserved_size = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* The mutex that protects the maximum and reserved cache size
+ * The mutex is created once and not freed, since it can be used by any thread at any time
+ */
+static libcthreads_mutex_t *libqcow_cache_budget_mutex = NULL;
+
+/* The once state of the mutex initialization
+ */
+static libqcow_once_t libqcow_cache_budget_mutex_once = LIBQCOW_ONCE_INITIALIZER;
+
+/* Initializes the mutex
+ * Called once by libqcow_cache_budget_grab_mutex
+ */
+static void libqcow_cache_budget_initialize_mutex(
+             void )
+{
+	if( libcthreads_mutex_initialize(
+	     &libqcow_cache_budget_mutex,
+	     NULL ) != 1 )
+	{
+		libqcow_cache_budget_mutex = NULL;
+	}
+}
+
+/* Grabs the mutex, which is initialized on first use
+ * Returns 1 if successful or -1 on error
+ */
+static int libqcow_cache_budget_grab_mutex(
+            libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_budget_grab_mutex";
+
+	if( libqcow_once_execute(
+	     &libqcow_cache_budget_mutex_once,
+	     &libqcow_cache_budget_initialize_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cache_budget_mutex == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing mutex.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+#endif
+
+/* Retrieves the process wide maximum cache size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_budget_get_maximum_size(
+     size64_t *maximum_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_budget_get_maximum_size";
+
+	if( maximum_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid maximum size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libqcow_cache_budget_grab_mutex(
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*maximum_size = libqcow_cache_budget_maximum_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the process wide maximum cache size
+ * A maximum size of 0 represents no maximum, which can only be set when no cache size is reserved
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_budget_set_maximum_size(
+     size64_t maximum_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_budget_set_maximum_size";
+	int result            = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libqcow_cache_budget_grab_mutex(
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( ( maximum_size == 0 )
+	 && ( libqcow_cache_budget_reserved_size != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid reserved size value already set.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		libqcow_cache_budget_maximum_size = maximum_size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the cache size reserved by open files
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_budget_get_reserved_size(
+     size64_t *reserved_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_budget_get_reserved_size";
+
+	if( reserved_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reserved size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libqcow_cache_budget_grab_mutex(
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*reserved_size = libqcow_cache_budget_reserved_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Reserves cache size from the process wide maximum cache size
+ * The reserved size is the requested size limited to the remaining cache size,
+ * but never less than the minimum size, so an open file always retains a usable cache.
+ * Hence the maximum cache size is a soft ceiling, when the remaining cache size is
+ * less than the minimum size the reserved cache size exceeds the maximum cache size
+ * Returns 1 if successful, 0 if there is no maximum cache size (nothing is reserved) or -1 on error
+ */
+int libqcow_cache_budget_reserve(
+     size64_t requested_size,
+     size64_t minimum_size,
+     size64_t *reserved_size,
+     libcerror_error_t **error )
+{
+	static char *function       = "libqcow_cache_budget_reserve";
+	size64_t remaining_size     = 0;
+	size64_t safe_reserved_size = 0;
+	int result                  = 1;
+
+	if( reserved_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reserved size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libqcow_cache_budget_grab_mutex(
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_cache_budget_maximum_size == 0 )
+	{
+		safe_reserved_size = requested_size;
+
+		result = 0;
+	}
+	else
+	{
+		if( libqcow_cache_budget_reserved_size < libqcow_cache_budget_maximum_size )
+		{
+			remaining_size = libqcow_cache_budget_maximum_size - libqcow_cache_budget_reserved_size;
+		}
+		safe_reserved_size = requested_size;
+
+		if( safe_reserved_size > remaining_size )
+		{
+			safe_reserved_size = remaining_size;
+		}
+		if( safe_reserved_size < minimum_size )
+		{
+			safe_reserved_size = minimum_size;
+		}
+		libqcow_cache_budget_reserved_size += safe_reserved_size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		if( result != 0 )
+		{
+			libqcow_cache_budget_reserved_size -= safe_reserved_size;
+		}
+		return( -1 );
+	}
+#endif
+	*reserved_size = safe_reserved_size;
+
+	return( result );
+}
+
+/* Releases cache size previously reserved from the process wide maximum cache size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_budget_release(
+     size64_t reserved_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_budget_release";
+	int result            = 1;
+
+	if( reserved_size == 0 )
+	{
+		return( 1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libqcow_cache_budget_grab_mutex(
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( reserved_size > libqcow_cache_budget_reserved_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reserved size value out of bounds.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		libqcow_cache_budget_reserved_size -= reserved_size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     libqcow_cache_budget_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
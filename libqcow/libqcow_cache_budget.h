@@ -0,0 +1,61 @@
+/*
+ * Cache budget functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_CACHE_BUDGET_H )
+#define _LIBQCOW_CACHE_BUDGET_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+int libqcow_cache_budget_get_maximum_size(
+     size64_t *maximum_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_budget_set_maximum_size(
+     size64_t maximum_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_budget_get_reserved_size(
+     size64_t *reserved_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_budget_reserve(
+     size64_t requested_size,
+     size64_t minimum_size,
+     size64_t *reserved_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_budget_release(
+     size64_t reserved_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_CACHE_BUDGET_H ) */
+
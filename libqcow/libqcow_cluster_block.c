@@ -24,6 +24,7 @@
 #include <memory.h>
 #include <types.h>
 
+#include "libqcow_buffer_pool.h"
 #include "libqcow_cluster_block.h"
 #include "libqcow_definitions.h"
 #include "libqcow_libbfio.h"
@@ -32,10 +33,12 @@
 
 /* Creates a cluster block
  * Make sure the value cluster_block is referencing, is set to NULL
+ * The data is retrieved from the buffer pool if set, otherwise it is allocated individually
  * Returns 1 if successful or -1 on error
  */
 int libqcow_cluster_block_initialize(
      libqcow_cluster_block_t **cluster_block,
+     libqcow_buffer_pool_t *buffer_pool,
      size_t data_size,
      libcerror_error_t **error )
 {
@@ -108,10 +111,13 @@ int libqcow_cluster_block_initialize(
 
 		return( -1 );
 	}
-	( *cluster_block )->data = (uint8_t *) memory_allocate(
-	                                        sizeof( uint8_t ) * data_size );
+	( *cluster_block )->buffer_pool = buffer_pool;
 
-	if( ( *cluster_block )->data == NULL )
+	if( libqcow_cluster_block_allocate_buffer(
+	     *cluster_block,
+	     data_size,
+	     &( ( *cluster_block )->data ),
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
@@ -160,34 +166,35 @@ int libqcow_cluster_block_free(
 	}
 	if( *cluster_block != NULL )
 	{
-		if( ( *cluster_block )->compressed_data != NULL )
-		{
-			memory_free(
-			 ( *cluster_block )->compressed_data );
-		}
-		if( ( *cluster_block )->encrypted_data != NULL )
+		if( libqcow_cluster_block_free_buffer(
+		     *cluster_block,
+		     &( ( *cluster_block )->compressed_data ),
+		     ( *cluster_block )->compressed_data_size,
+		     error ) != 1 )
 		{
-			memory_free(
-			 ( *cluster_block )->encrypted_data );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free compressed data.",
+			 function );
+
+			result = -1;
 		}
-		if( ( *cluster_block )->data != NULL )
+		if( libqcow_cluster_block_free_buffer(
+		     *cluster_block,
+		     &( ( *cluster_block )->data ),
+		     ( *cluster_block )->data_size,
+		     error ) != 1 )
 		{
-			if( memory_set(
-			     ( *cluster_block )->data,
-			     0,
-			     ( *cluster_block )->data_size ) == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-				 "%s: unable to clear data.",
-				 function );
-
-				result = -1;
-			}
-			memory_free(
-			 ( *cluster_block )->data );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free data.",
+			 function );
+
+			result = -1;
 		}
 		memory_free(
 		 *cluster_block );
@@ -197,6 +204,282 @@ int libqcow_cluster_block_free(
 	return( result );
 }
 
+/* Allocates a buffer of a specific data size
+ * The buffer is retrieved from the buffer pool if set, otherwise it is allocated individually
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_allocate_buffer(
+     libqcow_cluster_block_t *cluster_block,
+     size_t data_size,
+     uint8_t **buffer,
+     libcerror_error_t **error )
+{
+	uint8_t *safe_buffer  = NULL;
+	static char *function = "libqcow_cluster_block_allocate_buffer";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size == 0 )
+	 || ( data_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->buffer_pool != NULL )
+	{
+		if( libqcow_buffer_pool_get_buffer(
+		     cluster_block->buffer_pool,
+		     data_size,
+		     &safe_buffer,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve buffer from buffer pool.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	else
+	{
+		safe_buffer = (uint8_t *) memory_allocate(
+		                           sizeof( uint8_t ) * data_size );
+
+		if( safe_buffer == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create buffer.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	*buffer = safe_buffer;
+
+	return( 1 );
+}
+
+/* Frees a buffer that was allocated with a specific data size
+ * The buffer is returned to the buffer pool if set, otherwise it is cleared and freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_free_buffer(
+     libqcow_cluster_block_t *cluster_block,
+     uint8_t **buffer,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_free_buffer";
+	int result            = 1;
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( *buffer == NULL )
+	{
+		return( 1 );
+	}
+	if( cluster_block->buffer_pool != NULL )
+	{
+		if( libqcow_buffer_pool_release_buffer(
+		     cluster_block->buffer_pool,
+		     buffer,
+		     data_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release buffer to buffer pool.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	else
+	{
+		if( memory_set(
+		     *buffer,
+		     0,
+		     data_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear buffer.",
+			 function );
+
+			result = -1;
+		}
+		memory_free(
+		 *buffer );
+
+		*buffer = NULL;
+	}
+	return( result );
+}
+
+/* Marks the data of the cluster block as compressed
+ * The data becomes the compressed data and new data of the uncompressed data size is allocated
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_set_compressed(
+     libqcow_cluster_block_t *cluster_block,
+     size_t uncompressed_data_size,
+     libcerror_error_t **error )
+{
+	uint8_t *uncompressed_data = NULL;
+	static char *function      = "libqcow_cluster_block_set_compressed";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cluster block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->compressed_data != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cluster block - compressed data value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_block_allocate_buffer(
+	     cluster_block,
+	     uncompressed_data_size,
+	     &uncompressed_data,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create uncompressed data.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_block->compressed_data      = cluster_block->data;
+	cluster_block->compressed_data_size = cluster_block->data_size;
+	cluster_block->data                 = uncompressed_data;
+	cluster_block->data_size            = uncompressed_data_size;
+
+	return( 1 );
+}
+
+/* Frees the compressed data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_free_compressed_data(
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_free_compressed_data";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_block_free_buffer(
+	     cluster_block,
+	     &( cluster_block->compressed_data ),
+	     cluster_block->compressed_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free compressed data.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_block->compressed_data_size = 0;
+
+	return( 1 );
+}
+
 /* Reads cluster block
  * Returns 1 if successful or -1 on error
  */
@@ -276,3 +559,105 @@ int libqcow_cluster_block_read(
 	return( 1 );
 }
 
+/* Copies cluster block data into a buffer
+ * The part of the buffer beyond the end of the cluster block data is set to 0
+ * since the last cluster block in the file can be smaller than the cluster block size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_copy_data(
+     libqcow_cluster_block_t *cluster_block,
+     size_t data_offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_copy_data";
+	size_t copy_size      = 0;
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cluster block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_offset < cluster_block->data_size )
+	{
+		copy_size = cluster_block->data_size - data_offset;
+
+		if( copy_size > buffer_size )
+		{
+			copy_size = buffer_size;
+		}
+		if( memory_copy(
+		     buffer,
+		     &( cluster_block->data[ data_offset ] ),
+		     copy_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy cluster block data to buffer.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( copy_size < buffer_size )
+	{
+		if( memory_set(
+		     &( buffer[ copy_size ] ),
+		     0,
+		     buffer_size - copy_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear remainder of buffer.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
@@ -25,6 +25,7 @@
 #include <common.h>
 #include <types.h>
 
+#include "libqcow_buffer_pool.h"
 #include "libqcow_libbfio.h"
 #include "libqcow_libcerror.h"
 
@@ -36,13 +37,17 @@ typedef struct libqcow_cluster_block libqcow_cluster_block_t;
 
 struct libqcow_cluster_block
 {
+	/* The buffer pool, which is NULL if the buffers are allocated individually
+	 */
+	libqcow_buffer_pool_t *buffer_pool;
+
 	/* The compressed data
 	 */
 	uint8_t *compressed_data;
 
-	/* The encrypted data
+	/* The compressed data size
 	 */
-	uint8_t *encrypted_data;
+	size_t compressed_data_size;
 
 	/* The data
 	 */
@@ -55,6 +60,7 @@ struct libqcow_cluster_block
 
 int libqcow_cluster_block_initialize(
      libqcow_cluster_block_t **cluster_block,
+     libqcow_buffer_pool_t *buffer_pool,
      size_t data_size,
      libcerror_error_t **error );
 
@@ -62,12 +68,40 @@ int libqcow_cluster_block_free(
      libqcow_cluster_block_t **cluster_block,
      libcerror_error_t **error );
 
+int libqcow_cluster_block_allocate_buffer(
+     libqcow_cluster_block_t *cluster_block,
+     size_t data_size,
+     uint8_t **buffer,
+     libcerror_error_t **error );
+
+int libqcow_cluster_block_free_buffer(
+     libqcow_cluster_block_t *cluster_block,
+     uint8_t **buffer,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_cluster_block_set_compressed(
+     libqcow_cluster_block_t *cluster_block,
+     size_t uncompressed_data_size,
+     libcerror_error_t **error );
+
+int libqcow_cluster_block_free_compressed_data(
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error );
+
 int libqcow_cluster_block_read(
      libqcow_cluster_block_t *cluster_block,
      libbfio_handle_t *file_io_handle,
      off64_t cluster_offset,
      libcerror_error_t **error );
 
+int libqcow_cluster_block_copy_data(
+     libqcow_cluster_block_t *cluster_block,
+     size_t data_offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error );
+
 #if defined( __cplusplus )
 }
 #endif
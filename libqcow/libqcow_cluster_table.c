@@ -235,6 +235,170 @@ int libqcow_cluster_table_get_reference_by_index(
 	return( 1 );
 }
 
+/* Sets a specific reference in the cluster table
+ * The reference is marked as modified
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_table_set_reference_by_index(
+     libqcow_cluster_table_t *cluster_table,
+     int reference_index,
+     uint64_t reference,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_table_set_reference_by_index";
+
+	if( cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_table->references == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cluster table - missing references.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_index < 0 )
+	 || ( reference_index >= cluster_table->number_of_references ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_table->references[ reference_index ] = reference;
+
+	if( cluster_table->modified_start_index == cluster_table->modified_end_index )
+	{
+		cluster_table->modified_start_index = reference_index;
+		cluster_table->modified_end_index   = reference_index + 1;
+	}
+	else if( reference_index < cluster_table->modified_start_index )
+	{
+		cluster_table->modified_start_index = reference_index;
+	}
+	else if( reference_index >= cluster_table->modified_end_index )
+	{
+		cluster_table->modified_end_index = reference_index + 1;
+	}
+	return( 1 );
+}
+
+/* Resizes the cluster table
+ * References that are added are set to 0
+ * All references are marked as modified since a resized cluster table is written to a new location
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_table_resize(
+     libqcow_cluster_table_t *cluster_table,
+     size_t cluster_table_size,
+     libcerror_error_t **error )
+{
+	uint64_t *references     = NULL;
+	static char *function    = "libqcow_cluster_table_resize";
+	int number_of_references = 0;
+
+	if( cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_table_size == 0 )
+	 || ( cluster_table_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
+	 || ( ( cluster_table_size % 8 ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster table size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_table_size / 8 ) > (size_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid number of references value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_references = (int) ( cluster_table_size / 8 );
+
+	if( number_of_references < cluster_table->number_of_references )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster table size value smaller than current size.",
+		 function );
+
+		return( -1 );
+	}
+	references = (uint64_t *) memory_reallocate(
+	                           cluster_table->references,
+	                           cluster_table_size );
+
+	if( references == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to resize references.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_table->references = references;
+
+	if( memory_set(
+	     &( references[ cluster_table->number_of_references ] ),
+	     0,
+	     sizeof( uint64_t ) * ( number_of_references - cluster_table->number_of_references ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear references.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_table->number_of_references = number_of_references;
+	cluster_table->modified_start_index = 0;
+	cluster_table->modified_end_index   = number_of_references;
+
+	return( 1 );
+}
+
 /* Reads the cluster table
  * Returns 1 if successful or -1 on error
  */
@@ -420,3 +584,132 @@ on_error:
 	return( -1 );
 }
 
+/* Writes the modified references of the cluster table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_table_write_modified_references(
+     libqcow_cluster_table_t *cluster_table,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error )
+{
+	uint8_t *cluster_table_data      = NULL;
+	static char *function            = "libqcow_cluster_table_write_modified_references";
+	size_t cluster_table_data_offset = 0;
+	size_t write_size                = 0;
+	ssize_t write_count              = 0;
+	int cluster_table_index          = 0;
+
+	if( cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_table->references == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cluster table - missing references.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_table->modified_start_index == cluster_table->modified_end_index )
+	{
+		return( 1 );
+	}
+	write_size = (size_t) ( cluster_table->modified_end_index - cluster_table->modified_start_index ) * 8;
+
+	cluster_table_data = (uint8_t *) memory_allocate(
+	                                  write_size );
+
+	if( cluster_table_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cluster table data.",
+		 function );
+
+		goto on_error;
+	}
+	for( cluster_table_index = cluster_table->modified_start_index;
+	     cluster_table_index < cluster_table->modified_end_index;
+	     cluster_table_index++ )
+	{
+		byte_stream_copy_from_uint64_big_endian(
+		 &( cluster_table_data[ cluster_table_data_offset ] ),
+		 ( cluster_table->references )[ cluster_table_index ] );
+
+		cluster_table_data_offset += 8;
+	}
+	file_offset += (off64_t) cluster_table->modified_start_index * 8;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: writing %" PRIzd " bytes of cluster table at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 write_size,
+		 file_offset,
+		 file_offset );
+	}
+#endif
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               file_io_handle,
+	               cluster_table_data,
+	               write_size,
+	               file_offset,
+	               error );
+
+	if( write_count != (ssize_t) write_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write cluster table at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		goto on_error;
+	}
+	memory_free(
+	 cluster_table_data );
+
+	cluster_table->modified_start_index = 0;
+	cluster_table->modified_end_index   = 0;
+
+	return( 1 );
+
+on_error:
+	if( cluster_table_data != NULL )
+	{
+		memory_free(
+		 cluster_table_data );
+	}
+	return( -1 );
+}
+
@@ -43,6 +43,14 @@ struct libqcow_cluster_table
 	/* The references
 	 */
 	uint64_t *references;
+
+	/* The index of the first modified reference
+	 */
+	int modified_start_index;
+
+	/* The index after the last modified reference
+	 */
+	int modified_end_index;
 };
 
 int libqcow_cluster_table_initialize(
@@ -64,6 +72,17 @@ int libqcow_cluster_table_get_reference_by_index(
      uint64_t *reference,
      libcerror_error_t **error );
 
+int libqcow_cluster_table_set_reference_by_index(
+     libqcow_cluster_table_t *cluster_table,
+     int reference_index,
+     uint64_t reference,
+     libcerror_error_t **error );
+
+int libqcow_cluster_table_resize(
+     libqcow_cluster_table_t *cluster_table,
+     size_t cluster_table_size,
+     libcerror_error_t **error );
+
 int libqcow_cluster_table_read(
      libqcow_cluster_table_t *cluster_table,
      libbfio_handle_t *file_io_handle,
@@ -71,6 +90,12 @@ int libqcow_cluster_table_read(
      size_t cluster_table_size,
      libcerror_error_t **error );
 
+int libqcow_cluster_table_write_modified_references(
+     libqcow_cluster_table_t *cluster_table,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
 #if defined( __cplusplus )
 }
 #endif
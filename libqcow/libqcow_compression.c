@@ -33,11 +33,16 @@
 #include <zlib.h>
 #endif
 
+#if defined( HAVE_ZSTD ) && defined( HAVE_ZSTD_DECOMPRESS )
+#include <zstd.h>
+#endif
+
 #include "libqcow_compression.h"
 #include "libqcow_definitions.h"
 #include "libqcow_deflate.h"
 #include "libqcow_libcerror.h"
 #include "libqcow_libcnotify.h"
+#include "libqcow_zstd.h"
 
 /* Decompresses data using the compression method
  * Returns 1 on success, 0 on failure or -1 on error
@@ -53,6 +58,15 @@ int libqcow_decompress_data(
 	static char *function = "libqcow_decompress_data";
 	int result            = 0;
 
+#if defined( HAVE_ZSTD ) && defined( HAVE_ZSTD_DECOMPRESS )
+	size_t compressed_data_offset   = 0;
+	size_t frame_size               = 0;
+	size_t uncompressed_data_offset = 0;
+	size_t zstd_result              = 0;
+	uint32_t signature              = 0;
+	int number_of_frames            = 0;
+#endif
+
 #if ( defined( HAVE_ZLIB ) && defined( HAVE_ZLIB_INFLATE ) ) || defined( ZLIB_DLL )
 	z_stream zlib_stream;
 #endif
@@ -272,6 +286,105 @@ int libqcow_decompress_data(
 			return( -1 );
 		}
 #endif /* ( defined( HAVE_ZLIB ) && defined( HAVE_ZLIB_INFLATE ) ) || defined( ZLIB_DLL ) */
+	}
+	else if( compression_method == LIBQCOW_COMPRESSION_METHOD_ZSTD )
+	{
+#if defined( HAVE_ZSTD ) && defined( HAVE_ZSTD_DECOMPRESS )
+		/* A compressed cluster is stored in whole sectors, hence data can follow
+		 * the last frame. The frames are decompressed until the cluster is full.
+		 */
+		while( uncompressed_data_offset < *uncompressed_data_size )
+		{
+			if( ( compressed_data_size - compressed_data_offset ) < 4 )
+			{
+				break;
+			}
+			byte_stream_copy_to_uint32_little_endian(
+			 &( compressed_data[ compressed_data_offset ] ),
+			 signature );
+
+			if( ( signature != LIBQCOW_ZSTD_FRAME_SIGNATURE )
+			 && ( ( signature & LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE_MASK ) != LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE ) )
+			{
+				break;
+			}
+			frame_size = ZSTD_findFrameCompressedSize(
+			              &( compressed_data[ compressed_data_offset ] ),
+			              compressed_data_size - compressed_data_offset );
+
+			if( ZSTD_isError( frame_size ) != 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+				 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+				 "%s: unable to determine size of frame: %d.",
+				 function,
+				 number_of_frames );
+
+				return( -1 );
+			}
+			zstd_result = ZSTD_decompress(
+			               &( uncompressed_data[ uncompressed_data_offset ] ),
+			               *uncompressed_data_size - uncompressed_data_offset,
+			               &( compressed_data[ compressed_data_offset ] ),
+			               frame_size );
+
+			if( ZSTD_isError( zstd_result ) != 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+				 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+				 "%s: unable to decompress frame: %d with error: %s.",
+				 function,
+				 number_of_frames,
+				 ZSTD_getErrorName( zstd_result ) );
+
+				return( -1 );
+			}
+			compressed_data_offset   += frame_size;
+			uncompressed_data_offset += zstd_result;
+
+			if( signature == LIBQCOW_ZSTD_FRAME_SIGNATURE )
+			{
+				number_of_frames++;
+			}
+		}
+		if( number_of_frames == 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+			 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+			 "%s: unable to decompress zstd compressed data - missing frame.",
+			 function );
+
+			return( -1 );
+		}
+		*uncompressed_data_size = uncompressed_data_offset;
+
+		result = 1;
+#else
+		result = libqcow_zstd_decompress(
+		          compressed_data,
+		          compressed_data_size,
+		          uncompressed_data,
+		          uncompressed_data_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+			 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+			 "%s: unable to decompress zstd compressed data.",
+			 function );
+
+			return( -1 );
+		}
+#endif /* defined( HAVE_ZSTD ) && defined( HAVE_ZSTD_DECOMPRESS ) */
 	}
 	else
 	{
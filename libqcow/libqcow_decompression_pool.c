@@ -0,0 +1,626 @@
+/*
+ * Decompression pool functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_cluster_block.h"
+#include "libqcow_decompression_pool.h"
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_read_segment.h"
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Creates a decompression pool
+ * Make sure the value decompression_pool is referencing, is set to NULL
+ * The worker threads call decompress_cluster_block for every task, without holding the decompression pool mutex
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decompression_pool_initialize(
+     libqcow_decompression_pool_t **decompression_pool,
+     intptr_t *data_handle,
+     int (*decompress_cluster_block)(
+            intptr_t *data_handle,
+            libqcow_cluster_block_t *cluster_block,
+            libcerror_error_t **error ),
+     int number_of_threads,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decompression_pool_initialize";
+
+	if( decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *decompression_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid decompression pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( decompress_cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompress cluster block function.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_threads <= 0 )
+	 || ( number_of_threads > LIBQCOW_MAXIMUM_NUMBER_OF_DECOMPRESSION_THREADS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of threads value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*decompression_pool = memory_allocate_structure(
+	                       libqcow_decompression_pool_t );
+
+	if( *decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create decompression pool.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *decompression_pool,
+	     0,
+	     sizeof( libqcow_decompression_pool_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear decompression pool.",
+		 function );
+
+		memory_free(
+		 *decompression_pool );
+
+		*decompression_pool = NULL;
+
+		return( -1 );
+	}
+	( *decompression_pool )->data_handle              = data_handle;
+	( *decompression_pool )->decompress_cluster_block = decompress_cluster_block;
+	( *decompression_pool )->number_of_threads        = number_of_threads;
+
+	if( libcthreads_mutex_initialize(
+	     &( ( *decompression_pool )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *decompression_pool )->task_processed_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize task processed condition.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_thread_pool_create(
+	     &( ( *decompression_pool )->thread_pool ),
+	     NULL,
+	     number_of_threads,
+	     LIBQCOW_MAXIMUM_NUMBER_OF_QUEUED_DECOMPRESSION_TASKS,
+	     &libqcow_decompression_pool_process_task,
+	     (void *) *decompression_pool,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create worker thread pool.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *decompression_pool != NULL )
+	{
+		if( ( *decompression_pool )->task_processed_condition != NULL )
+		{
+			libcthreads_condition_free(
+			 &( ( *decompression_pool )->task_processed_condition ),
+			 NULL );
+		}
+		if( ( *decompression_pool )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *decompression_pool )->mutex ),
+			 NULL );
+		}
+		memory_free(
+		 *decompression_pool );
+
+		*decompression_pool = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a decompression pool
+ * The worker threads are stopped after the tasks that were pushed have been processed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decompression_pool_free(
+     libqcow_decompression_pool_t **decompression_pool,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decompression_pool_free";
+	int result            = 1;
+
+	if( decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *decompression_pool != NULL )
+	{
+		if( libcthreads_thread_pool_join(
+		     &( ( *decompression_pool )->thread_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join worker thread pool.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_condition_free(
+		     &( ( *decompression_pool )->task_processed_condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free task processed condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_free(
+		     &( ( *decompression_pool )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+		memory_free(
+		 *decompression_pool );
+
+		*decompression_pool = NULL;
+	}
+	return( result );
+}
+
+/* Pushes a task onto the decompression pool
+ * The task and its cluster block and read segments must remain available until its batch has been waited for
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decompression_pool_push_task(
+     libqcow_decompression_pool_t *decompression_pool,
+     libqcow_decompression_task_t *decompression_task,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decompression_pool_push_task";
+
+	if( decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( decompression_task == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression task.",
+		 function );
+
+		return( -1 );
+	}
+	if( decompression_task->batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid decompression task - missing batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( decompression_task->cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid decompression task - missing cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( decompression_task->read_segments == NULL )
+	 && ( decompression_task->number_of_read_segments != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid decompression task - missing read segments.",
+		 function );
+
+		return( -1 );
+	}
+	decompression_task->result = 0;
+
+	if( libcthreads_mutex_grab(
+	     decompression_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	decompression_task->batch->number_of_pending_tasks += 1;
+
+	if( libcthreads_mutex_release(
+	     decompression_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_thread_pool_push(
+	     decompression_pool->thread_pool,
+	     (intptr_t *) decompression_task,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to push task onto worker thread pool.",
+		 function );
+
+		libcthreads_mutex_grab(
+		 decompression_pool->mutex,
+		 NULL );
+
+		decompression_task->batch->number_of_pending_tasks -= 1;
+
+		libcthreads_mutex_release(
+		 decompression_pool->mutex,
+		 NULL );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Waits until all the tasks of a batch have been processed
+ * Returns 1 if successful, 0 if one or more tasks failed or -1 on error
+ */
+int libqcow_decompression_pool_wait_for_batch(
+     libqcow_decompression_pool_t *decompression_pool,
+     libqcow_decompression_batch_t *decompression_batch,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decompression_pool_wait_for_batch";
+	int result            = 1;
+
+	if( decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( decompression_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decompression batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     decompression_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( decompression_batch->number_of_pending_tasks > 0 )
+	{
+		if( libcthreads_condition_wait(
+		     decompression_pool->task_processed_condition,
+		     decompression_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to wait for task processed condition.",
+			 function );
+
+			result = -1;
+
+			break;
+		}
+	}
+	if( ( result == 1 )
+	 && ( decompression_batch->number_of_failed_tasks > 0 ) )
+	{
+		result = 0;
+	}
+	if( libcthreads_mutex_release(
+	     decompression_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* The worker thread pool callback function
+ * Decompresses the cluster block of the task and copies its data into the buffers of the read segments
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decompression_pool_process_task(
+     intptr_t *value,
+     void *arguments )
+{
+	libcerror_error_t *error                         = NULL;
+	libqcow_decompression_pool_t *decompression_pool = NULL;
+	libqcow_decompression_task_t *decompression_task = NULL;
+	libqcow_read_segment_t *read_segment             = NULL;
+	static char *function                            = "libqcow_decompression_pool_process_task";
+	size_t read_segment_index                        = 0;
+	int result                                       = 1;
+
+	if( ( value == NULL )
+	 || ( arguments == NULL ) )
+	{
+		return( -1 );
+	}
+	decompression_task = (libqcow_decompression_task_t *) value;
+	decompression_pool = (libqcow_decompression_pool_t *) arguments;
+
+	if( decompression_pool->decompress_cluster_block(
+	     decompression_pool->data_handle,
+	     decompression_task->cluster_block,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+		 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+		 "%s: unable to decompress cluster block.",
+		 function );
+
+		result = -1;
+	}
+	for( read_segment_index = 0;
+	     ( result == 1 ) && ( read_segment_index < decompression_task->number_of_read_segments );
+	     read_segment_index++ )
+	{
+		read_segment = &( decompression_task->read_segments[ read_segment_index ] );
+
+		if( libqcow_cluster_block_copy_data(
+		     decompression_task->cluster_block,
+		     (size_t) read_segment->cluster_block_data_offset,
+		     read_segment->buffer,
+		     read_segment->size,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_COPY_FAILED,
+			 "%s: unable to copy cluster block data.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( result == -1 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_print_error_backtrace(
+			 error );
+		}
+#endif
+		libcerror_error_free(
+		 &error );
+	}
+	if( libcthreads_mutex_grab(
+	     decompression_pool->mutex,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		goto on_error;
+	}
+	decompression_task->result = result;
+
+	if( result != 1 )
+	{
+		decompression_task->batch->number_of_failed_tasks += 1;
+	}
+	decompression_task->batch->number_of_pending_tasks -= 1;
+
+	if( libcthreads_condition_broadcast(
+	     decompression_pool->task_processed_condition,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to broadcast task processed condition.",
+		 function );
+
+		libcthreads_mutex_release(
+		 decompression_pool->mutex,
+		 NULL );
+
+		goto on_error;
+	}
+	if( libcthreads_mutex_release(
+	     decompression_pool->mutex,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		goto on_error;
+	}
+	return( result );
+
+on_error:
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_print_error_backtrace(
+		 error );
+	}
+#endif
+	libcerror_error_free(
+	 &error );
+
+	return( -1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
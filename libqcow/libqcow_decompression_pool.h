@@ -0,0 +1,151 @@
+/*
+ * Decompression pool functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_DECOMPRESSION_POOL_H )
+#define _LIBQCOW_DECOMPRESSION_POOL_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cluster_block.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_read_segment.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+typedef struct libqcow_decompression_batch libqcow_decompression_batch_t;
+
+/* A decompression batch tracks the tasks that were pushed for a single read
+ */
+struct libqcow_decompression_batch
+{
+	/* The number of tasks that have not been processed
+	 */
+	int number_of_pending_tasks;
+
+	/* The number of tasks that failed
+	 */
+	int number_of_failed_tasks;
+};
+
+typedef struct libqcow_decompression_task libqcow_decompression_task_t;
+
+/* A decompression task decompresses a cluster block and copies its data
+ * into the buffers of the read segments that are stored in the cluster block
+ */
+struct libqcow_decompression_task
+{
+	/* The batch
+	 */
+	libqcow_decompression_batch_t *batch;
+
+	/* The cluster block, which contains the compressed data when the task is pushed
+	 */
+	libqcow_cluster_block_t *cluster_block;
+
+	/* The read segments
+	 */
+	libqcow_read_segment_t *read_segments;
+
+	/* The number of read segments
+	 */
+	size_t number_of_read_segments;
+
+	/* The result of the task
+	 */
+	int result;
+};
+
+typedef struct libqcow_decompression_pool libqcow_decompression_pool_t;
+
+/* The decompression pool decompresses the cluster blocks of a read in worker threads
+ */
+struct libqcow_decompression_pool
+{
+	/* The data handle
+	 */
+	intptr_t *data_handle;
+
+	/* The decompress cluster block function
+	 */
+	int (*decompress_cluster_block)(
+	       intptr_t *data_handle,
+	       libqcow_cluster_block_t *cluster_block,
+	       libcerror_error_t **error );
+
+	/* The number of threads
+	 */
+	int number_of_threads;
+
+	/* The mutex
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that signals a task was processed
+	 */
+	libcthreads_condition_t *task_processed_condition;
+
+	/* The worker thread pool
+	 */
+	libcthreads_thread_pool_t *thread_pool;
+};
+
+int libqcow_decompression_pool_initialize(
+     libqcow_decompression_pool_t **decompression_pool,
+     intptr_t *data_handle,
+     int (*decompress_cluster_block)(
+            intptr_t *data_handle,
+            libqcow_cluster_block_t *cluster_block,
+            libcerror_error_t **error ),
+     int number_of_threads,
+     libcerror_error_t **error );
+
+int libqcow_decompression_pool_free(
+     libqcow_decompression_pool_t **decompression_pool,
+     libcerror_error_t **error );
+
+int libqcow_decompression_pool_push_task(
+     libqcow_decompression_pool_t *decompression_pool,
+     libqcow_decompression_task_t *decompression_task,
+     libcerror_error_t **error );
+
+int libqcow_decompression_pool_wait_for_batch(
+     libqcow_decompression_pool_t *decompression_pool,
+     libqcow_decompression_batch_t *decompression_batch,
+     libcerror_error_t **error );
+
+int libqcow_decompression_pool_process_task(
+     intptr_t *value,
+     void *arguments );
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_DECOMPRESSION_POOL_H ) */
+
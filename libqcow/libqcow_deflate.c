@@ -26,12 +26,19 @@
 
 #include "libqcow_deflate.h"
 #include "libqcow_libcerror.h"
+#include "libqcow_once.h"
 
 libqcow_deflate_huffman_table_t libqcow_deflate_fixed_huffman_distances_table;
 libqcow_deflate_huffman_table_t libqcow_deflate_fixed_huffman_literals_table;
 
 int libqcow_deflate_fixed_huffman_tables_initialized = 0;
 
+/* The Adler-32 implementation, which is determined once on first use
+ */
+int libqcow_deflate_adler32_implementation = 0;
+
+libqcow_once_t libqcow_deflate_adler32_implementation_once = LIBQCOW_ONCE_INITIALIZER;
+
 /* Retrieves a value from the bit stream
  * Returns 1 on success or -1 on error
  */
@@ -309,6 +316,19 @@ int libqcow_deflate_huffman_table_construct(
 		code_offsets_array[ code_size ]  += 1;
 		table->codes_array[ code_offset ] = symbol;
 	}
+	if( libqcow_deflate_huffman_table_build_lookup_table(
+	     table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to build lookup table.",
+		 function );
+
+		return( -1 );
+	}
 /* TODO only used by dynamic Huffman
 	if( left_value > 0 )
 	{
@@ -325,6 +345,211 @@ int libqcow_deflate_huffman_table_construct(
 	return( 1 );
 }
 
+/* Builds the Huffman lookup table from the sorted codes array
+ * Every Huffman code is stored in the lookup table in bit stream order, which
+ * is the reverse of the Huffman code, so that the table can be indexed by
+ * the least significant bits of the bit buffer. Codes that are longer than
+ * LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS are stored in a secondary lookup
+ * table that is referenced by the primary lookup table entry
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_deflate_huffman_table_build_lookup_table(
+     libqcow_deflate_huffman_table_t *table,
+     libcerror_error_t **error )
+{
+	static char *function     = "libqcow_deflate_huffman_table_build_lookup_table";
+	uint16_t huffman_code     = 0;
+	uint16_t lookup_entry     = 0;
+	uint16_t reversed_code    = 0;
+	uint16_t sub_table_offset = 0;
+	uint16_t table_index      = 0;
+	uint16_t value_16bit      = 0;
+	uint8_t bit_index         = 0;
+	uint8_t code_size         = 0;
+	uint8_t sub_table_bits    = 0;
+	int code_index            = 0;
+	int code_size_count       = 0;
+	int symbol                = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( table->maximum_number_of_bits > 15 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid table - number of bits values out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     &( table->lookup_table ),
+	     0,
+	     LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_SIZE * sizeof( uint16_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear lookup table.",
+		 function );
+
+		return( -1 );
+	}
+	/* Determine the number of bits of the secondary lookup tables
+	 */
+	for( code_size = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS + 1;
+	     code_size <= table->maximum_number_of_bits;
+	     code_size++ )
+	{
+		if( table->code_counts_array[ code_size ] != 0 )
+		{
+			break;
+		}
+	}
+	if( code_size <= table->maximum_number_of_bits )
+	{
+		huffman_code = 0;
+
+		for( bit_index = 1;
+		     bit_index <= table->maximum_number_of_bits;
+		     bit_index++ )
+		{
+			code_size_count = table->code_counts_array[ bit_index ];
+
+			if( bit_index > LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS )
+			{
+				sub_table_bits = bit_index - LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS;
+
+				while( code_size_count > 0 )
+				{
+					/* The first bits of the code in bit stream order
+					 */
+					value_16bit = huffman_code >> sub_table_bits;
+					table_index = 0;
+
+					for( code_index = 0;
+					     code_index < LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS;
+					     code_index++ )
+					{
+						table_index <<= 1;
+						table_index  |= value_16bit & 0x0001;
+						value_16bit >>= 1;
+					}
+					table->lookup_table[ table_index ] = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE | sub_table_bits;
+
+					huffman_code++;
+					code_size_count--;
+				}
+			}
+			else
+			{
+				huffman_code += (uint16_t) code_size_count;
+			}
+			huffman_code <<= 1;
+		}
+		/* Assign the secondary lookup tables their offset in the lookup table
+		 */
+		sub_table_offset = (uint16_t) 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS;
+
+		for( table_index = 0;
+		     table_index < ( (uint16_t) 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS );
+		     table_index++ )
+		{
+			lookup_entry = table->lookup_table[ table_index ];
+
+			if( ( lookup_entry & LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE ) == 0 )
+			{
+				continue;
+			}
+			sub_table_bits = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry );
+
+			if( ( (int) sub_table_offset + ( 1 << sub_table_bits ) ) > LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_SIZE )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid secondary lookup table offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			table->lookup_table[ table_index ] = ( sub_table_offset << 5 )
+			                                   | LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE
+			                                   | sub_table_bits;
+
+			sub_table_offset += (uint16_t) 1 << sub_table_bits;
+		}
+	}
+	/* Fill the lookup table with the symbols
+	 */
+	huffman_code = 0;
+	code_index   = 0;
+
+	for( code_size = 1;
+	     code_size <= table->maximum_number_of_bits;
+	     code_size++ )
+	{
+		for( code_size_count = table->code_counts_array[ code_size ];
+		     code_size_count > 0;
+		     code_size_count-- )
+		{
+			symbol = table->codes_array[ code_index++ ];
+
+			value_16bit   = huffman_code;
+			reversed_code = 0;
+
+			for( bit_index = 0;
+			     bit_index < code_size;
+			     bit_index++ )
+			{
+				reversed_code <<= 1;
+				reversed_code  |= value_16bit & 0x0001;
+				value_16bit   >>= 1;
+			}
+			lookup_entry = (uint16_t) ( symbol << 5 ) | code_size;
+
+			if( code_size <= LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS )
+			{
+				for( table_index = reversed_code;
+				     table_index < ( (uint16_t) 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS );
+				     table_index += (uint16_t) 1 << code_size )
+				{
+					table->lookup_table[ table_index ] = lookup_entry;
+				}
+			}
+			else
+			{
+				value_16bit      = table->lookup_table[ reversed_code & ( ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS ) - 1 ) ];
+				sub_table_offset = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( value_16bit );
+				sub_table_bits   = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( value_16bit );
+
+				for( table_index = reversed_code >> LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS;
+				     table_index < ( (uint16_t) 1 << sub_table_bits );
+				     table_index += (uint16_t) 1 << ( code_size - LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS ) )
+				{
+					table->lookup_table[ sub_table_offset + table_index ] = lookup_entry;
+				}
+			}
+			huffman_code++;
+		}
+		huffman_code <<= 1;
+	}
+	return( 1 );
+}
+
 /* Retrieves a Huffman encoded value from the bit stream
  * Returns 1 on success or -1 on error
  */
@@ -335,15 +560,9 @@ int libqcow_deflate_bit_stream_get_huffman_encoded_value(
      libcerror_error_t **error )
 {
 	static char *function     = "libqcow_deflate_bit_stream_get_huffman_encoded_value";
-	uint32_t bit_buffer       = 0;
 	uint32_t safe_value_32bit = 0;
-	uint8_t bit_index         = 0;
+	uint16_t lookup_entry     = 0;
 	uint8_t number_of_bits    = 0;
-	int code_size_count       = 0;
-	int first_huffman_code    = 0;
-	int first_index           = 0;
-	int huffman_code          = 0;
-	int result                = 0;
 
 	if( bit_stream == NULL )
 	{
@@ -392,44 +611,19 @@ int libqcow_deflate_bit_stream_get_huffman_encoded_value(
 		bit_stream->bit_buffer      |= safe_value_32bit;
 		bit_stream->bit_buffer_size += 8;
 	}
-	if( table->maximum_number_of_bits < bit_stream->bit_buffer_size )
-	{
-		number_of_bits = table->maximum_number_of_bits;
-	}
-	else
-	{
-		number_of_bits = bit_stream->bit_buffer_size;
-	}
-	bit_buffer = bit_stream->bit_buffer;
+	lookup_entry = table->lookup_table[ bit_stream->bit_buffer & ( ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS ) - 1 ) ];
 
-	for( bit_index = 1;
-	     bit_index <= number_of_bits;
-	     bit_index++ )
+	if( ( lookup_entry & LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE ) != 0 )
 	{
-		huffman_code <<= 1;
-		huffman_code  |= (int) bit_buffer & 0x00000001UL;
-		bit_buffer   >>= 1;
-
-		code_size_count = table->code_counts_array[ bit_index ];
-
-		if( ( huffman_code - code_size_count ) < first_huffman_code )
-		{
-			safe_value_32bit = table->codes_array[ first_index + ( huffman_code - first_huffman_code ) ];
+		safe_value_32bit = bit_stream->bit_buffer >> LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS;
+		safe_value_32bit &= ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry ) ) - 1;
 
-			result = 1;
-
-			break;
-		}
-		first_huffman_code  += code_size_count;
-		first_huffman_code <<= 1;
-		first_index         += code_size_count;
-	}
-	if( result != 0 )
-	{
-		bit_stream->bit_buffer     >>= bit_index;
-		bit_stream->bit_buffer_size -= bit_index;
+		lookup_entry = table->lookup_table[ LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry ) + safe_value_32bit ];
 	}
-	if( result != 1 )
+	number_of_bits = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry );
+
+	if( ( number_of_bits == 0 )
+	 || ( number_of_bits > bit_stream->bit_buffer_size ) )
 	{
 		libcerror_error_set(
 		 error,
@@ -440,7 +634,10 @@ int libqcow_deflate_bit_stream_get_huffman_encoded_value(
 
 		return( -1 );
 	}
-	*value_32bit = safe_value_32bit;
+	bit_stream->bit_buffer     >>= number_of_bits;
+	bit_stream->bit_buffer_size -= number_of_bits;
+
+	*value_32bit = (uint32_t) LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry );
 
 	return( 1 );
 }
@@ -837,13 +1034,53 @@ int libqcow_deflate_decode_huffman(
 		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
 
 	static char *function         = "libqcow_deflate_decode_huffman";
+	size_t byte_stream_offset     = 0;
 	size_t data_offset            = 0;
+	uint64_t bit_buffer           = 0;
+	uint64_t value_64bit          = 0;
 	uint32_t code_value           = 0;
 	uint32_t extra_bits           = 0;
 	uint16_t compression_offset   = 0;
 	uint16_t compression_size     = 0;
+	uint16_t lookup_entry         = 0;
 	uint16_t number_of_extra_bits = 0;
+	uint32_t bit_buffer_size      = 0;
+	uint32_t number_of_bits       = 0;
+	uint8_t end_of_block          = 0;
+
+	if( bit_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bit stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( literals_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid literals table.",
+		 function );
+
+		return( -1 );
+	}
+	if( distances_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid distances table.",
+		 function );
 
+		return( -1 );
+	}
 	if( uncompressed_data == NULL )
 	{
 		libcerror_error_set(
@@ -877,83 +1114,300 @@ int libqcow_deflate_decode_huffman(
 
 		return( -1 );
 	}
+	if( bit_stream->byte_stream_offset > bit_stream->byte_stream_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bit stream - byte stream offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
 	data_offset = *uncompressed_data_offset;
 
-	do
+	if( data_offset > uncompressed_data_size )
 	{
-		if( libqcow_deflate_bit_stream_get_huffman_encoded_value(
-		     bit_stream,
-		     literals_table,
-		     &code_value,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve literal value from bit stream.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid uncompressed data offset value out of bounds.",
+		 function );
 
-			return( -1 );
-		}
-		if( code_value < 256 )
+		return( -1 );
+	}
+	while( end_of_block == 0 )
+	{
+		/* Decode without bounds checks while there is enough compressed data
+		 * to fill a 64-bit bit buffer and enough space for the largest match
+		 * of 258 bytes and the 7 bytes a match copy can write beyond it
+		 */
+		if( ( ( bit_stream->byte_stream_size - bit_stream->byte_stream_offset ) >= 8 )
+		 && ( ( uncompressed_data_size - data_offset ) >= 266 ) )
 		{
-			if( data_offset >= uncompressed_data_size )
+			bit_buffer         = bit_stream->bit_buffer;
+			bit_buffer_size    = bit_stream->bit_buffer_size;
+			byte_stream_offset = bit_stream->byte_stream_offset;
+
+			do
 			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-				 LIBCERROR_ARGUMENT_ERROR_VALUE_TOO_SMALL,
-				 "%s: invalid uncompressed data value too small.",
-				 function );
+				/* Fill the bit buffer to at least 56 bits, which is more than
+				 * the 48 bits needed for a length and distance pair
+				 */
+				byte_stream_copy_to_uint64_little_endian(
+				 &( bit_stream->byte_stream[ byte_stream_offset ] ),
+				 value_64bit );
 
-				return( -1 );
-			}
-			uncompressed_data[ data_offset++ ] = (uint8_t) code_value;
-		}
-		else if( ( code_value > 256 )
-		      && ( code_value < 286 ) )
-		{
-			code_value -= 257;
+				bit_buffer         |= value_64bit << bit_buffer_size;
+				byte_stream_offset += ( 63 - bit_buffer_size ) >> 3;
+				bit_buffer_size    |= 56;
 
-			number_of_extra_bits = literal_codes_number_of_extra_bits[ code_value ];
+				lookup_entry = literals_table->lookup_table[ bit_buffer & ( ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS ) - 1 ) ];
 
-			if( libqcow_deflate_bit_stream_get_value(
-			     bit_stream,
-			     (uint8_t) number_of_extra_bits,
-			     &extra_bits,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-				 "%s: unable to retrieve literal extra value from bit stream.",
-				 function );
+				if( ( lookup_entry & LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE ) != 0 )
+				{
+					extra_bits  = (uint32_t) ( bit_buffer >> LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS );
+					extra_bits &= ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry ) ) - 1;
 
-				return( -1 );
-			}
-			compression_size = literal_codes_base[ code_value ] + (uint16_t) extra_bits;
+					lookup_entry = literals_table->lookup_table[ LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry ) + extra_bits ];
+				}
+				number_of_bits = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry );
 
-			if( libqcow_deflate_bit_stream_get_huffman_encoded_value(
-			     bit_stream,
-			     distances_table,
-			     &code_value,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-				 "%s: unable to retrieve distance value from bit stream.",
-				 function );
+				if( number_of_bits == 0 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: invalid huffman encoded literal value.",
+					 function );
 
-				return( -1 );
-			}
-			number_of_extra_bits = distance_codes_number_of_extra_bits[ code_value ];
+					return( -1 );
+				}
+				bit_buffer     >>= number_of_bits;
+				bit_buffer_size -= number_of_bits;
 
-			if( libqcow_deflate_bit_stream_get_value(
-			     bit_stream,
+				code_value = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry );
+
+				if( code_value < 256 )
+				{
+					uncompressed_data[ data_offset++ ] = (uint8_t) code_value;
+
+					continue;
+				}
+				if( code_value == 256 )
+				{
+					end_of_block = 1;
+
+					break;
+				}
+				if( code_value >= 286 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: invalid code value: %" PRIu32 ".",
+					 function,
+					 code_value );
+
+					return( -1 );
+				}
+				code_value -= 257;
+
+				number_of_extra_bits = literal_codes_number_of_extra_bits[ code_value ];
+
+				compression_size = literal_codes_base[ code_value ]
+				                 + (uint16_t) ( bit_buffer & ( ( 1 << number_of_extra_bits ) - 1 ) );
+
+				bit_buffer     >>= number_of_extra_bits;
+				bit_buffer_size -= number_of_extra_bits;
+
+				lookup_entry = distances_table->lookup_table[ bit_buffer & ( ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS ) - 1 ) ];
+
+				if( ( lookup_entry & LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE ) != 0 )
+				{
+					extra_bits  = (uint32_t) ( bit_buffer >> LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS );
+					extra_bits &= ( 1 << LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry ) ) - 1;
+
+					lookup_entry = distances_table->lookup_table[ LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry ) + extra_bits ];
+				}
+				number_of_bits = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry );
+				code_value     = LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( lookup_entry );
+
+				if( ( number_of_bits == 0 )
+				 || ( code_value >= 30 ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: invalid huffman encoded distance value.",
+					 function );
+
+					return( -1 );
+				}
+				bit_buffer     >>= number_of_bits;
+				bit_buffer_size -= number_of_bits;
+
+				number_of_extra_bits = distance_codes_number_of_extra_bits[ code_value ];
+
+				compression_offset = distance_codes_base[ code_value ]
+				                   + (uint16_t) ( bit_buffer & ( ( 1 << number_of_extra_bits ) - 1 ) );
+
+				bit_buffer     >>= number_of_extra_bits;
+				bit_buffer_size -= number_of_extra_bits;
+
+				if( compression_offset > data_offset )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid compression offset value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				if( compression_offset >= 8 )
+				{
+					/* Copy 8 bytes at a time, which can write up to 7 bytes
+					 * beyond the end of the match
+					 */
+					while( compression_size > 0 )
+					{
+						if( memory_copy(
+						     &( uncompressed_data[ data_offset ] ),
+						     &( uncompressed_data[ data_offset - compression_offset ] ),
+						     8 ) == NULL )
+						{
+							libcerror_error_set(
+							 error,
+							 LIBCERROR_ERROR_DOMAIN_MEMORY,
+							 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+							 "%s: unable to copy match.",
+							 function );
+
+							return( -1 );
+						}
+						if( compression_size <= 8 )
+						{
+							data_offset += compression_size;
+
+							break;
+						}
+						data_offset      += 8;
+						compression_size -= 8;
+					}
+				}
+				else
+				{
+					while( compression_size > 0 )
+					{
+						uncompressed_data[ data_offset ] = uncompressed_data[ data_offset - compression_offset ];
+
+						data_offset++;
+						compression_size--;
+					}
+				}
+			}
+			while( ( ( bit_stream->byte_stream_size - byte_stream_offset ) >= 8 )
+			    && ( ( uncompressed_data_size - data_offset ) >= 266 ) );
+
+			/* Return the bytes that were not consumed to the byte stream
+			 */
+			while( bit_buffer_size >= 8 )
+			{
+				byte_stream_offset -= 1;
+				bit_buffer_size    -= 8;
+			}
+			bit_stream->bit_buffer         = (uint32_t) ( bit_buffer & ( ( (uint64_t) 1 << bit_buffer_size ) - 1 ) );
+			bit_stream->bit_buffer_size    = (uint8_t) bit_buffer_size;
+			bit_stream->byte_stream_offset = byte_stream_offset;
+
+			if( end_of_block != 0 )
+			{
+				break;
+			}
+		}
+		if( libqcow_deflate_bit_stream_get_huffman_encoded_value(
+		     bit_stream,
+		     literals_table,
+		     &code_value,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve literal value from bit stream.",
+			 function );
+
+			return( -1 );
+		}
+		if( code_value < 256 )
+		{
+			if( data_offset >= uncompressed_data_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+				 LIBCERROR_ARGUMENT_ERROR_VALUE_TOO_SMALL,
+				 "%s: invalid uncompressed data value too small.",
+				 function );
+
+				return( -1 );
+			}
+			uncompressed_data[ data_offset++ ] = (uint8_t) code_value;
+		}
+		else if( code_value == 256 )
+		{
+			end_of_block = 1;
+		}
+		else if( code_value < 286 )
+		{
+			code_value -= 257;
+
+			number_of_extra_bits = literal_codes_number_of_extra_bits[ code_value ];
+
+			if( libqcow_deflate_bit_stream_get_value(
+			     bit_stream,
+			     (uint8_t) number_of_extra_bits,
+			     &extra_bits,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve literal extra value from bit stream.",
+				 function );
+
+				return( -1 );
+			}
+			compression_size = literal_codes_base[ code_value ] + (uint16_t) extra_bits;
+
+			if( libqcow_deflate_bit_stream_get_huffman_encoded_value(
+			     bit_stream,
+			     distances_table,
+			     &code_value,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve distance value from bit stream.",
+				 function );
+
+				return( -1 );
+			}
+			number_of_extra_bits = distance_codes_number_of_extra_bits[ code_value ];
+
+			if( libqcow_deflate_bit_stream_get_value(
+			     bit_stream,
 			     (uint8_t) number_of_extra_bits,
 			     &extra_bits,
 			     error ) != 1 )
@@ -999,26 +1453,93 @@ int libqcow_deflate_decode_huffman(
 				compression_size--;
 			}
 		}
-		else if( code_value != 256 )
+		else
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: invalid code value: %" PRIu16 ".",
+			 "%s: invalid code value: %" PRIu32 ".",
 			 function,
 			 code_value );
 
 			return( -1 );
 		}
 	}
-	while( code_value != 256 );
-
 	*uncompressed_data_offset = data_offset;
 
 	return( 1 );
 }
 
+/* Determines the Adler-32 implementation supported by the CPU
+ * Returns the Adler-32 implementation
+ */
+int libqcow_deflate_get_adler32_implementation(
+     void )
+{
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 ) && defined( _MSC_VER )
+	int cpu_information[ 4 ];
+#endif
+
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+#if defined( _MSC_VER )
+	__cpuid(
+	 cpu_information,
+	 0 );
+
+	if( cpu_information[ 0 ] >= 7 )
+	{
+		__cpuid(
+		 cpu_information,
+		 1 );
+
+		/* Check if the CPU supports AVX and the operating system
+		 * saves the AVX registers
+		 */
+		if( ( ( cpu_information[ 2 ] & 0x18000000L ) == 0x18000000L )
+		 && ( ( _xgetbv( 0 ) & 0x00000006UL ) == 0x00000006UL ) )
+		{
+			__cpuidex(
+			 cpu_information,
+			 7,
+			 0 );
+
+			if( ( cpu_information[ 1 ] & 0x00000020L ) != 0 )
+			{
+				return( LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_AVX2 );
+			}
+		}
+	}
+#else
+	__builtin_cpu_init();
+
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		return( LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_AVX2 );
+	}
+#endif
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_AVX2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+	return( LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SSE2 );
+
+#elif defined( LIBQCOW_DEFLATE_HAVE_NEON )
+	return( LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_NEON );
+
+#else
+	return( LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SCALAR );
+#endif
+}
+
+/* Determines the Adler-32 implementation
+ * Called once by libqcow_deflate_calculate_adler32
+ */
+void libqcow_deflate_initialize_adler32_implementation(
+      void )
+{
+	libqcow_deflate_adler32_implementation = libqcow_deflate_get_adler32_implementation();
+}
+
 /* Calculates the little-endian Adler-32 of a buffer
  * It uses the initial value to calculate a new Adler-32
  * Returns 1 if successful or -1 on error
@@ -1031,6 +1552,91 @@ int libqcow_deflate_calculate_adler32(
      libcerror_error_t **error )
 {
 	static char *function = "libqcow_deflate_calculate_adler32";
+	int result            = 0;
+
+	/* The implementation is determined once, since multiple threads can decompress concurrently
+	 */
+	if( libqcow_once_execute(
+	     &libqcow_deflate_adler32_implementation_once,
+	     &libqcow_deflate_initialize_adler32_implementation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to determine Adler-32 implementation.",
+		 function );
+
+		return( -1 );
+	}
+	switch( libqcow_deflate_adler32_implementation )
+	{
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+		case LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_AVX2:
+			result = libqcow_deflate_calculate_adler32_avx2(
+			          checksum_value,
+			          buffer,
+			          size,
+			          initial_value,
+			          error );
+			break;
+#endif
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+		case LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SSE2:
+			result = libqcow_deflate_calculate_adler32_sse2(
+			          checksum_value,
+			          buffer,
+			          size,
+			          initial_value,
+			          error );
+			break;
+#endif
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+		case LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_NEON:
+			result = libqcow_deflate_calculate_adler32_neon(
+			          checksum_value,
+			          buffer,
+			          size,
+			          initial_value,
+			          error );
+			break;
+#endif
+		default:
+			result = libqcow_deflate_calculate_adler32_scalar(
+			          checksum_value,
+			          buffer,
+			          size,
+			          initial_value,
+			          error );
+			break;
+	}
+	if( result != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to calculate Adler-32.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Calculates the little-endian Adler-32 of a buffer one byte at a time
+ * It uses the initial value to calculate a new Adler-32
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_deflate_calculate_adler32_scalar(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_deflate_calculate_adler32_scalar";
 	size_t buffer_offset  = 0;
 	uint32_t lower_word   = 0;
 	uint32_t upper_word   = 0;
@@ -1267,6 +1873,514 @@ int libqcow_deflate_calculate_adler32(
 	return( 1 );
 }
 
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+
+/* Calculates the little-endian Adler-32 of a buffer using SSE2
+ * It uses the initial value to calculate a new Adler-32
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_deflate_calculate_adler32_sse2(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error )
+{
+	uint32_t values_32bit[ 4 ];
+
+	__m128i block_data;
+	__m128i lower_words;
+	__m128i previous_lower_words;
+	__m128i upper_words;
+	__m128i weights_high;
+	__m128i weights_low;
+	__m128i zero;
+
+	static char *function   = "libqcow_deflate_calculate_adler32_sse2";
+	size_t block_offset     = 0;
+	size_t block_size       = 0;
+	size_t buffer_offset    = 0;
+	uint64_t lower_sum      = 0;
+	uint64_t previous_sum   = 0;
+	uint64_t upper_sum      = 0;
+	uint32_t lower_word     = 0;
+	uint32_t upper_word     = 0;
+
+	if( checksum_value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid checksum value.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	lower_word = initial_value & 0xffff;
+	upper_word = ( initial_value >> 16 ) & 0xffff;
+
+	zero         = _mm_setzero_si128();
+	weights_low  = _mm_set_epi16( 9, 10, 11, 12, 13, 14, 15, 16 );
+	weights_high = _mm_set_epi16( 1, 2, 3, 4, 5, 6, 7, 8 );
+
+	while( size >= 16 )
+	{
+		/* The modulo calculation is needed per 5552 (0x15b0) bytes
+		 * 5552 / 16 = 347
+		 */
+		block_size = size;
+
+		if( block_size > 0x15b0 )
+		{
+			block_size = 0x15b0;
+		}
+		block_size &= ~( (size_t) 15 );
+
+		lower_words          = _mm_setzero_si128();
+		previous_lower_words = _mm_setzero_si128();
+		upper_words          = _mm_setzero_si128();
+
+		for( block_offset = 0;
+		     block_offset < block_size;
+		     block_offset += 16 )
+		{
+			block_data = _mm_loadu_si128(
+			              (const __m128i *) &( buffer[ buffer_offset + block_offset ] ) );
+
+			/* Every byte of the previous 16-byte blocks is added to the upper word 16 times
+			 */
+			previous_lower_words = _mm_add_epi64(
+			                        previous_lower_words,
+			                        lower_words );
+
+			lower_words = _mm_add_epi64(
+			               lower_words,
+			               _mm_sad_epu8(
+			                block_data,
+			                zero ) );
+
+			upper_words = _mm_add_epi32(
+			               upper_words,
+			               _mm_madd_epi16(
+			                _mm_unpacklo_epi8(
+			                 block_data,
+			                 zero ),
+			                weights_low ) );
+
+			upper_words = _mm_add_epi32(
+			               upper_words,
+			               _mm_madd_epi16(
+			                _mm_unpackhi_epi8(
+			                 block_data,
+			                 zero ),
+			                weights_high ) );
+		}
+		/* The 64-bit lanes contain values that fit in 32-bit
+		 */
+		lower_sum = (uint32_t) _mm_cvtsi128_si32( lower_words )
+		          + (uint32_t) _mm_cvtsi128_si32( _mm_srli_si128( lower_words, 8 ) );
+
+		previous_sum = (uint32_t) _mm_cvtsi128_si32( previous_lower_words )
+		             + (uint32_t) _mm_cvtsi128_si32( _mm_srli_si128( previous_lower_words, 8 ) );
+
+		_mm_storeu_si128(
+		 (__m128i *) values_32bit,
+		 upper_words );
+
+		upper_sum = (uint64_t) values_32bit[ 0 ] + values_32bit[ 1 ] + values_32bit[ 2 ] + values_32bit[ 3 ];
+
+		upper_sum += (uint64_t) upper_word + ( (uint64_t) lower_word * block_size ) + ( previous_sum << 4 );
+		lower_sum += lower_word;
+
+		lower_word = (uint32_t) ( lower_sum % 65521 );
+		upper_word = (uint32_t) ( upper_sum % 65521 );
+
+		buffer_offset += block_size;
+		size          -= block_size;
+	}
+	if( libqcow_deflate_calculate_adler32_scalar(
+	     checksum_value,
+	     &( buffer[ buffer_offset ] ),
+	     size,
+	     ( upper_word << 16 ) | lower_word,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to calculate Adler-32 of remaining data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_SSE2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+
+/* Calculates the little-endian Adler-32 of a buffer using AVX2
+ * It uses the initial value to calculate a new Adler-32
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("avx2")))
+#endif
+int libqcow_deflate_calculate_adler32_avx2(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error )
+{
+	uint32_t values_32bit[ 8 ];
+	uint64_t values_64bit[ 4 ];
+
+	__m256i block_data;
+	__m256i lower_words;
+	__m256i ones;
+	__m256i previous_lower_words;
+	__m256i upper_words;
+	__m256i weights;
+	__m256i zero;
+
+	static char *function   = "libqcow_deflate_calculate_adler32_avx2";
+	size_t block_offset     = 0;
+	size_t block_size       = 0;
+	size_t buffer_offset    = 0;
+	uint64_t lower_sum      = 0;
+	uint64_t previous_sum   = 0;
+	uint64_t upper_sum      = 0;
+	uint32_t lower_word     = 0;
+	uint32_t upper_word     = 0;
+
+	if( checksum_value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid checksum value.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	lower_word = initial_value & 0xffff;
+	upper_word = ( initial_value >> 16 ) & 0xffff;
+
+	zero    = _mm256_setzero_si256();
+	ones    = _mm256_set1_epi16( 1 );
+	weights = _mm256_set_epi8(
+	           1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+	           17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32 );
+
+	while( size >= 32 )
+	{
+		/* The modulo calculation is needed per 5552 (0x15b0) bytes
+		 * 5536 / 32 = 173
+		 */
+		block_size = size;
+
+		if( block_size > 0x15a0 )
+		{
+			block_size = 0x15a0;
+		}
+		block_size &= ~( (size_t) 31 );
+
+		lower_words          = _mm256_setzero_si256();
+		previous_lower_words = _mm256_setzero_si256();
+		upper_words          = _mm256_setzero_si256();
+
+		for( block_offset = 0;
+		     block_offset < block_size;
+		     block_offset += 32 )
+		{
+			block_data = _mm256_loadu_si256(
+			              (const __m256i *) &( buffer[ buffer_offset + block_offset ] ) );
+
+			/* Every byte of the previous 32-byte blocks is added to the upper word 32 times
+			 */
+			previous_lower_words = _mm256_add_epi64(
+			                        previous_lower_words,
+			                        lower_words );
+
+			lower_words = _mm256_add_epi64(
+			               lower_words,
+			               _mm256_sad_epu8(
+			                block_data,
+			                zero ) );
+
+			upper_words = _mm256_add_epi32(
+			               upper_words,
+			               _mm256_madd_epi16(
+			                _mm256_maddubs_epi16(
+			                 block_data,
+			                 weights ),
+			                ones ) );
+		}
+		_mm256_storeu_si256(
+		 (__m256i *) values_64bit,
+		 lower_words );
+
+		lower_sum = values_64bit[ 0 ] + values_64bit[ 1 ] + values_64bit[ 2 ] + values_64bit[ 3 ];
+
+		_mm256_storeu_si256(
+		 (__m256i *) values_64bit,
+		 previous_lower_words );
+
+		previous_sum = values_64bit[ 0 ] + values_64bit[ 1 ] + values_64bit[ 2 ] + values_64bit[ 3 ];
+
+		_mm256_storeu_si256(
+		 (__m256i *) values_32bit,
+		 upper_words );
+
+		upper_sum = (uint64_t) values_32bit[ 0 ] + values_32bit[ 1 ] + values_32bit[ 2 ] + values_32bit[ 3 ]
+		          + values_32bit[ 4 ] + values_32bit[ 5 ] + values_32bit[ 6 ] + values_32bit[ 7 ];
+
+		upper_sum += (uint64_t) upper_word + ( (uint64_t) lower_word * block_size ) + ( previous_sum << 5 );
+		lower_sum += lower_word;
+
+		lower_word = (uint32_t) ( lower_sum % 65521 );
+		upper_word = (uint32_t) ( upper_sum % 65521 );
+
+		buffer_offset += block_size;
+		size          -= block_size;
+	}
+	if( libqcow_deflate_calculate_adler32_scalar(
+	     checksum_value,
+	     &( buffer[ buffer_offset ] ),
+	     size,
+	     ( upper_word << 16 ) | lower_word,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to calculate Adler-32 of remaining data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_AVX2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+
+/* Calculates the little-endian Adler-32 of a buffer using NEON
+ * It uses the initial value to calculate a new Adler-32
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_deflate_calculate_adler32_neon(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error )
+{
+	static const uint8_t weights_data[ 16 ] = {
+		16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+
+	uint32_t values_32bit[ 4 ];
+
+	uint8x16_t block_data;
+	uint8x8_t weights_high;
+	uint8x8_t weights_low;
+	uint32x4_t lower_words;
+	uint32x4_t previous_lower_words;
+	uint32x4_t upper_words;
+
+	static char *function   = "libqcow_deflate_calculate_adler32_neon";
+	size_t block_offset     = 0;
+	size_t block_size       = 0;
+	size_t buffer_offset    = 0;
+	uint64_t lower_sum      = 0;
+	uint64_t previous_sum   = 0;
+	uint64_t upper_sum      = 0;
+	uint32_t lower_word     = 0;
+	uint32_t upper_word     = 0;
+
+	if( checksum_value == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid checksum value.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	lower_word = initial_value & 0xffff;
+	upper_word = ( initial_value >> 16 ) & 0xffff;
+
+	weights_low  = vld1_u8( &( weights_data[ 0 ] ) );
+	weights_high = vld1_u8( &( weights_data[ 8 ] ) );
+
+	while( size >= 16 )
+	{
+		/* The modulo calculation is needed per 5552 (0x15b0) bytes
+		 * 5552 / 16 = 347
+		 */
+		block_size = size;
+
+		if( block_size > 0x15b0 )
+		{
+			block_size = 0x15b0;
+		}
+		block_size &= ~( (size_t) 15 );
+
+		lower_words          = vdupq_n_u32( 0 );
+		previous_lower_words = vdupq_n_u32( 0 );
+		upper_words          = vdupq_n_u32( 0 );
+
+		for( block_offset = 0;
+		     block_offset < block_size;
+		     block_offset += 16 )
+		{
+			block_data = vld1q_u8( &( buffer[ buffer_offset + block_offset ] ) );
+
+			/* Every byte of the previous 16-byte blocks is added to the upper word 16 times
+			 */
+			previous_lower_words = vaddq_u32(
+			                        previous_lower_words,
+			                        lower_words );
+
+			lower_words = vpadalq_u16(
+			               lower_words,
+			               vpaddlq_u8( block_data ) );
+
+			upper_words = vpadalq_u16(
+			               upper_words,
+			               vmull_u8(
+			                vget_low_u8( block_data ),
+			                weights_low ) );
+
+			upper_words = vpadalq_u16(
+			               upper_words,
+			               vmull_u8(
+			                vget_high_u8( block_data ),
+			                weights_high ) );
+		}
+		vst1q_u32(
+		 values_32bit,
+		 lower_words );
+
+		lower_sum = (uint64_t) values_32bit[ 0 ] + values_32bit[ 1 ] + values_32bit[ 2 ] + values_32bit[ 3 ];
+
+		vst1q_u32(
+		 values_32bit,
+		 previous_lower_words );
+
+		previous_sum = (uint64_t) values_32bit[ 0 ] + values_32bit[ 1 ] + values_32bit[ 2 ] + values_32bit[ 3 ];
+
+		vst1q_u32(
+		 values_32bit,
+		 upper_words );
+
+		upper_sum = (uint64_t) values_32bit[ 0 ] + values_32bit[ 1 ] + values_32bit[ 2 ] + values_32bit[ 3 ];
+
+		upper_sum += (uint64_t) upper_word + ( (uint64_t) lower_word * block_size ) + ( previous_sum << 4 );
+		lower_sum += lower_word;
+
+		lower_word = (uint32_t) ( lower_sum % 65521 );
+		upper_word = (uint32_t) ( upper_sum % 65521 );
+
+		buffer_offset += block_size;
+		size          -= block_size;
+	}
+	if( libqcow_deflate_calculate_adler32_scalar(
+	     checksum_value,
+	     &( buffer[ buffer_offset ] ),
+	     size,
+	     ( upper_word << 16 ) | lower_word,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to calculate Adler-32 of remaining data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_NEON ) */
+
 /* Reads the compressed data header
  * Returns 1 on success or -1 on error
  */
@@ -27,10 +27,58 @@
 
 #include "libqcow_libcerror.h"
 
+/* The vector instruction sets that can be used to calculate the Adler-32
+ * SSE2 and NEON are always available on the targets they are enabled for,
+ * AVX2 support is determined at run-time
+ */
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_AMD64 ) )
+#define LIBQCOW_DEFLATE_HAVE_SSE2
+
+#if _MSC_VER >= 1800
+#define LIBQCOW_DEFLATE_HAVE_AVX2
+#endif
+
+#elif defined( __GNUC__ ) && defined( __SSE2__ )
+#define LIBQCOW_DEFLATE_HAVE_SSE2
+
+#if defined( __clang__ ) || ( __GNUC__ >= 5 )
+#define LIBQCOW_DEFLATE_HAVE_AVX2
+#endif
+
+#endif
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+#define LIBQCOW_DEFLATE_HAVE_NEON
+#endif
+
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 ) && defined( _MSC_VER )
+#include <intrin.h>
+
+#elif defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+#include <immintrin.h>
+
+#elif defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+#include <emmintrin.h>
+#endif
+
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+#include <arm_neon.h>
+#endif
+
 #if defined( __cplusplus )
 extern "C" {
 #endif
 
+/* The Adler-32 implementations
+ */
+enum LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATIONS
+{
+	LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SCALAR	= 1,
+	LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SSE2	= 2,
+	LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_AVX2	= 3,
+	LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_NEON	= 4
+};
+
 /* The block types
  */
 enum LIBQCOW_DEFLATE_BLOCK_TYPES
@@ -41,6 +89,32 @@ enum LIBQCOW_DEFLATE_BLOCK_TYPES
 	LIBQCOW_DEFLATE_BLOCK_TYPE_RESERVED		= 0x03
 };
 
+/* The number of bits used to index the primary Huffman lookup table
+ */
+#define LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS	10
+
+/* The size of the Huffman lookup table, which contains the primary lookup table
+ * followed by the secondary lookup tables of the codes that are longer than
+ * LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_BITS
+ */
+#define LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_SIZE	2048
+
+/* The Huffman lookup table entry flags
+ */
+#define LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE	0x0010
+
+/* A Huffman lookup table entry contains:
+ * bits 0 - 3:  the code size or the number of bits of the secondary lookup table
+ * bit 4:       the secondary lookup table flag
+ * bits 5 - 15: the symbol or the offset of the secondary lookup table
+ * An entry of 0 represents an invalid code.
+ */
+#define LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( entry ) \
+	( (uint8_t) ( ( entry ) & 0x000f ) )
+
+#define LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_ENTRY_VALUE( entry ) \
+	( (uint16_t) ( ( entry ) >> 5 ) )
+
 typedef struct libqcow_deflate_bit_stream libqcow_deflate_bit_stream_t;
 
 struct libqcow_deflate_bit_stream
@@ -86,6 +160,10 @@ struct libqcow_deflate_huffman_table
 	/* The number of codes
 	 */
 	int number_of_codes;
+
+	/* The lookup table
+	 */
+	uint16_t lookup_table[ LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_TABLE_SIZE ];
 };
 
 int libqcow_deflate_bit_stream_get_value(
@@ -100,6 +178,10 @@ int libqcow_deflate_huffman_table_construct(
      int number_of_code_sizes,
      libcerror_error_t **error );
 
+int libqcow_deflate_huffman_table_build_lookup_table(
+     libqcow_deflate_huffman_table_t *table,
+     libcerror_error_t **error );
+
 int libqcow_deflate_bit_stream_get_huffman_encoded_value(
      libqcow_deflate_bit_stream_t *bit_stream,
      libqcow_deflate_huffman_table_t *table,
@@ -126,6 +208,12 @@ int libqcow_deflate_decode_huffman(
      size_t *uncompressed_data_offset,
      libcerror_error_t **error );
 
+int libqcow_deflate_get_adler32_implementation(
+     void );
+
+void libqcow_deflate_initialize_adler32_implementation(
+      void );
+
 int libqcow_deflate_calculate_adler32(
      uint32_t *checksum_value,
      const uint8_t *buffer,
@@ -133,6 +221,46 @@ int libqcow_deflate_calculate_adler32(
      uint32_t initial_value,
      libcerror_error_t **error );
 
+int libqcow_deflate_calculate_adler32_scalar(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error );
+
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+
+int libqcow_deflate_calculate_adler32_sse2(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error );
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_SSE2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+
+int libqcow_deflate_calculate_adler32_avx2(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error );
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_AVX2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+
+int libqcow_deflate_calculate_adler32_neon(
+     uint32_t *checksum_value,
+     const uint8_t *buffer,
+     size_t size,
+     uint32_t initial_value,
+     libcerror_error_t **error );
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_NEON ) */
+
 int libqcow_deflate_read_data_header(
      const uint8_t *compressed_data,
      size_t compressed_data_size,
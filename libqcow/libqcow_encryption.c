@@ -24,6 +24,7 @@
 #include <memory.h>
 #include <types.h>
 
+#include "libqcow_definitions.h"
 #include "libqcow_encryption.h"
 #include "libqcow_libcaes.h"
 #include "libqcow_libcerror.h"
@@ -61,6 +62,18 @@ int libqcow_encryption_initialize(
 
 		return( -1 );
 	}
+	if( ( method != LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC )
+	 && ( method != LIBQCOW_ENCRYPTION_METHOD_LUKS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported method.",
+		 function );
+
+		return( -1 );
+	}
 	*context = memory_allocate_structure(
 	            libqcow_encryption_context_t );
 
@@ -94,39 +107,80 @@ int libqcow_encryption_initialize(
 
 		return( -1 );
 	}
-	if( libcaes_context_initialize(
-	     &( ( *context )->decryption_context ),
-	     error ) != 1 )
+	/* LUKS uses AES-XTS, which requires tweaked contexts
+	 */
+	if( method == LIBQCOW_ENCRYPTION_METHOD_LUKS )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable initialize decryption context.",
-		 function );
+		if( libcaes_tweaked_context_initialize(
+		     &( ( *context )->decryption_tweaked_context ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable initialize decryption tweaked context.",
+			 function );
 
-		goto on_error;
+			goto on_error;
+		}
+		if( libcaes_tweaked_context_initialize(
+		     &( ( *context )->encryption_tweaked_context ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable initialize encryption tweaked context.",
+			 function );
+
+			goto on_error;
+		}
 	}
-	if( libcaes_context_initialize(
-	     &( ( *context )->encryption_context ),
-	     error ) != 1 )
+	else
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable initialize encryption context.",
-		 function );
+		if( libcaes_context_initialize(
+		     &( ( *context )->decryption_context ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable initialize decryption context.",
+			 function );
 
-		goto on_error;
+			goto on_error;
+		}
+		if( libcaes_context_initialize(
+		     &( ( *context )->encryption_context ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable initialize encryption context.",
+			 function );
+
+			goto on_error;
+		}
 	}
-	( *context )->method = method;
+	( *context )->method             = method;
+	( *context )->aes_implementation = libqcow_encryption_get_aes_implementation();
 
 	return( 1 );
 
 on_error:
 	if( *context != NULL )
 	{
+		if( ( *context )->decryption_tweaked_context != NULL )
+		{
+			libcaes_tweaked_context_free(
+			 &( ( *context )->decryption_tweaked_context ),
+			 NULL );
+		}
 		if( ( *context )->decryption_context != NULL )
 		{
 			libcaes_context_free(
@@ -164,32 +218,75 @@ int libqcow_encryption_free(
 	}
 	if( *context != NULL )
 	{
-		if( libcaes_context_free(
-		     &( ( *context )->decryption_context ),
-		     error ) != 1 )
+		if( ( *context )->decryption_context != NULL )
 		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-			 "%s: unable free decryption context.",
-			 function );
+			if( libcaes_context_free(
+			     &( ( *context )->decryption_context ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable free decryption context.",
+				 function );
 
-			result = -1;
+				result = -1;
+			}
 		}
-		if( libcaes_context_free(
-		     &( ( *context )->encryption_context ),
-		     error ) != 1 )
+		if( ( *context )->encryption_context != NULL )
 		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-			 "%s: unable free encryption context.",
-			 function );
+			if( libcaes_context_free(
+			     &( ( *context )->encryption_context ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable free encryption context.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *context )->decryption_tweaked_context != NULL )
+		{
+			if( libcaes_tweaked_context_free(
+			     &( ( *context )->decryption_tweaked_context ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable free decryption tweaked context.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *context )->encryption_tweaked_context != NULL )
+		{
+			if( libcaes_tweaked_context_free(
+			     &( ( *context )->encryption_tweaked_context ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable free encryption tweaked context.",
+				 function );
 
-			result = -1;
+				result = -1;
+			}
 		}
+		memory_set(
+		 *context,
+		 0,
+		 sizeof( libqcow_encryption_context_t ) );
+
 		memory_free(
 		 *context );
 
@@ -199,6 +296,8 @@ int libqcow_encryption_free(
 }
 
 /* Sets the de- and encryption keys
+ * For AES-CBC the first 16 bytes of the key are used, for AES-XTS the key
+ * must be 32 or 64 bytes where the second half of the key is the tweak key
  * Returns 1 if successful or -1 on error
  */
 int libqcow_encryption_set_keys(
@@ -253,6 +352,78 @@ int libqcow_encryption_set_keys(
 
 		return( -1 );
 	}
+	if( context->method == LIBQCOW_ENCRYPTION_METHOD_LUKS )
+	{
+		if( ( key_size != 32 )
+		 && ( key_size != 64 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported key size.",
+			 function );
+
+			return( -1 );
+		}
+		if( libcaes_tweaked_context_set_keys(
+		     context->decryption_tweaked_context,
+		     LIBCAES_CRYPT_MODE_DECRYPT,
+		     key,
+		     ( key_size / 2 ) * 8,
+		     &( key[ key_size / 2 ] ),
+		     ( key_size / 2 ) * 8,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set keys in decryption tweaked context.",
+			 function );
+
+			return( -1 );
+		}
+		if( libcaes_tweaked_context_set_keys(
+		     context->encryption_tweaked_context,
+		     LIBCAES_CRYPT_MODE_ENCRYPT,
+		     key,
+		     ( key_size / 2 ) * 8,
+		     &( key[ key_size / 2 ] ),
+		     ( key_size / 2 ) * 8,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set keys in encryption tweaked context.",
+			 function );
+
+			return( -1 );
+		}
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+		if( context->aes_implementation != LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC )
+		{
+			if( libqcow_encryption_set_xts_round_keys_aesni(
+			     context,
+			     key,
+			     key_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set XTS round keys.",
+				 function );
+
+				return( -1 );
+			}
+		}
+#endif
+		return( 1 );
+	}
 	if( libcaes_context_set_key(
 	     context->decryption_context,
 	     LIBCAES_CRYPT_MODE_DECRYPT,
@@ -285,10 +456,103 @@ int libqcow_encryption_set_keys(
 
 		return( -1 );
 	}
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+	if( context->aes_implementation != LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC )
+	{
+		if( libqcow_encryption_set_decryption_round_keys_aesni(
+		     context,
+		     key,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set decryption round keys.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#endif
 	return( 1 );
 }
 
+/* Determines the AES implementation supported by the CPU
+ * Returns the AES implementation
+ */
+int libqcow_encryption_get_aes_implementation(
+     void )
+{
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) && defined( _MSC_VER )
+	int cpu_information[ 4 ];
+#endif
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+#if defined( _MSC_VER )
+	__cpuid(
+	 cpu_information,
+	 0 );
+
+	if( cpu_information[ 0 ] >= 1 )
+	{
+		__cpuid(
+		 cpu_information,
+		 1 );
+
+		/* Check if the CPU supports AES-NI
+		 */
+		if( ( cpu_information[ 2 ] & 0x02000000L ) != 0 )
+		{
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+			/* Check if the CPU supports AVX and the operating system
+			 * saves the AVX registers
+			 */
+			if( ( ( cpu_information[ 2 ] & 0x18000000L ) == 0x18000000L )
+			 && ( ( _xgetbv( 0 ) & 0x00000006UL ) == 0x00000006UL ) )
+			{
+				__cpuidex(
+				 cpu_information,
+				 7,
+				 0 );
+
+				/* Check if the CPU supports AVX2 and VAES
+				 */
+				if( ( ( cpu_information[ 1 ] & 0x00000020L ) != 0 )
+				 && ( ( cpu_information[ 2 ] & 0x00000200L ) != 0 ) )
+				{
+					return( LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES );
+				}
+			}
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
+			return( LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI );
+		}
+	}
+#else
+	__builtin_cpu_init();
+
+	if( __builtin_cpu_supports( "aes" ) )
+	{
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+		if( __builtin_cpu_supports( "avx2" )
+		 && __builtin_cpu_supports( "vaes" ) )
+		{
+			return( LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES );
+		}
+#endif
+		return( LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI );
+	}
+#endif
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+	return( LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC );
+}
+
 /* De- or encrypts a block of data
+ * The data is de- or encrypted in sectors of 512 bytes, where the block key of the first sector
+ * is used as the initialization vector (or tweak value for AES-XTS) and is incremented for every
+ * subsequent sector. The input and output data can be the same buffer to de- or encrypt the data in-place
  * Returns 1 if successful or -1 on error
  */
 int libqcow_encryption_crypt(
@@ -302,9 +566,11 @@ int libqcow_encryption_crypt(
      libcerror_error_t **error )
 {
 	uint8_t initialization_vector[ 16 ];
+	uint8_t sector_data[ 512 ];
 
-	static char *function = "libqcow_encryption_crypt";
-	size_t data_index     = 0;
+	uint8_t *sector_output_data = NULL;
+	static char *function       = "libqcow_encryption_crypt";
+	size_t data_index           = 0;
 
 	if( context == NULL )
 	{
@@ -351,6 +617,108 @@ int libqcow_encryption_crypt(
 
 		return( -1 );
 	}
+	if( ( context->method == LIBQCOW_ENCRYPTION_METHOD_LUKS )
+	 && ( mode == LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT ) )
+	{
+		switch( context->aes_implementation )
+		{
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+			case LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES:
+				if( libqcow_encryption_decrypt_xts_vaes(
+				     context,
+				     input_data,
+				     output_data,
+				     input_data_size,
+				     block_key,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-XTS decrypt output data using VAES.",
+					 function );
+
+					return( -1 );
+				}
+				return( 1 );
+#endif
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+			case LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI:
+				if( libqcow_encryption_decrypt_xts_aesni(
+				     context,
+				     input_data,
+				     output_data,
+				     input_data_size,
+				     block_key,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-XTS decrypt output data using AES-NI.",
+					 function );
+
+					return( -1 );
+				}
+				return( 1 );
+#endif
+			default:
+				break;
+		}
+	}
+	if( ( context->method != LIBQCOW_ENCRYPTION_METHOD_LUKS )
+	 && ( mode == LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT ) )
+	{
+		switch( context->aes_implementation )
+		{
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+			case LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES:
+				if( libqcow_encryption_decrypt_vaes(
+				     context,
+				     input_data,
+				     output_data,
+				     input_data_size,
+				     block_key,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-CBC decrypt output data using VAES.",
+					 function );
+
+					return( -1 );
+				}
+				return( 1 );
+#endif
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+			case LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI:
+				if( libqcow_encryption_decrypt_aesni(
+				     context,
+				     input_data,
+				     output_data,
+				     input_data_size,
+				     block_key,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-CBC decrypt output data using AES-NI.",
+					 function );
+
+					return( -1 );
+				}
+				return( 1 );
+#endif
+			default:
+				break;
+		}
+	}
 	while( data_index < input_data_size )
 	{
 		if( memory_set(
@@ -371,7 +739,67 @@ int libqcow_encryption_crypt(
 		 initialization_vector,
 		 block_key );
 
-		if( mode == LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT )
+		/* The sector is de- or encrypted into a separate buffer when the data is de- or encrypted in-place
+		 */
+		if( input_data == output_data )
+		{
+			sector_output_data = sector_data;
+		}
+		else
+		{
+			sector_output_data = &( output_data[ data_index ] );
+		}
+
+		if( context->method == LIBQCOW_ENCRYPTION_METHOD_LUKS )
+		{
+			if( mode == LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT )
+			{
+				if( libcaes_crypt_xts(
+				     context->encryption_tweaked_context,
+				     LIBCAES_CRYPT_MODE_ENCRYPT,
+				     initialization_vector,
+				     16,
+				     &( input_data[ data_index ] ),
+				     512,
+				     sector_output_data,
+				     512,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-XTS encrypt output data.",
+					 function );
+
+					return( -1 );
+				}
+			}
+			else
+			{
+				if( libcaes_crypt_xts(
+				     context->decryption_tweaked_context,
+				     LIBCAES_CRYPT_MODE_DECRYPT,
+				     initialization_vector,
+				     16,
+				     &( input_data[ data_index ] ),
+				     512,
+				     sector_output_data,
+				     512,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to AES-XTS decrypt output data.",
+					 function );
+
+					return( -1 );
+				}
+			}
+		}
+		else if( mode == LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT )
 		{
 			if( libcaes_crypt_cbc(
 			     context->encryption_context,
@@ -380,7 +808,7 @@ int libqcow_encryption_crypt(
 			     16,
 			     &( input_data[ data_index ] ),
 			     512,
-			     &( output_data[ data_index ] ),
+			     sector_output_data,
 			     512,
 			     error ) != 1 )
 			{
@@ -403,7 +831,7 @@ int libqcow_encryption_crypt(
 			     16,
 			     &( input_data[ data_index ] ),
 			     512,
-			     &( output_data[ data_index ] ),
+			     sector_output_data,
 			     512,
 			     error ) != 1 )
 			{
@@ -417,9 +845,1289 @@ int libqcow_encryption_crypt(
 				return( -1 );
 			}
 		}
+		if( sector_output_data == sector_data )
+		{
+			if( memory_copy(
+			     &( output_data[ data_index ] ),
+			     sector_data,
+			     512 ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy sector data.",
+				 function );
+
+				return( -1 );
+			}
+		}
 		data_index += 512;
 		block_key  += 1;
 	}
+	if( memory_set(
+	     sector_data,
+	     0,
+	     512 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear sector data.",
+		 function );
+
+		return( -1 );
+	}
 	return( 1 );
 }
 
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+/* Expands an AES-128 round key using the result of AESKEYGENASSIST
+ */
+#define libqcow_encryption_aesni_expand_round_key( round_key, key_generation_assist ) \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_shuffle_epi32( key_generation_assist, 0xff ) )
+
+/* Expands an odd AES-256 round key using the result of AESKEYGENASSIST
+ * where the substituted word is not rotated
+ */
+#define libqcow_encryption_aesni_expand_round_key_without_rotation( round_key, key_generation_assist ) \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_slli_si128( round_key, 4 ) ); \
+	round_key = _mm_xor_si128( round_key, _mm_shuffle_epi32( key_generation_assist, 0xaa ) )
+
+/* Expands 2 AES-256 round keys from the previous 2 round keys
+ */
+#define libqcow_encryption_aesni_expand_round_keys_256( round_keys, round_index, round_constant ) \
+	round_keys[ round_index ] = round_keys[ round_index - 2 ]; \
+	libqcow_encryption_aesni_expand_round_key( \
+	 round_keys[ round_index ], \
+	 _mm_aeskeygenassist_si128( round_keys[ round_index - 1 ], round_constant ) ); \
+	round_keys[ round_index + 1 ] = round_keys[ round_index - 1 ]; \
+	libqcow_encryption_aesni_expand_round_key_without_rotation( \
+	 round_keys[ round_index + 1 ], \
+	 _mm_aeskeygenassist_si128( round_keys[ round_index ], 0x00 ) )
+
+/* Multiplies an AES-XTS tweak by the primitive element (x) of GF(2^128)
+ * The tweak is shifted 1 bit to the left, where the bits that are shifted out of every 32-bit value
+ * are carried into the next 32-bit value and the bit shifted out of the tweak is reduced by the polynomial
+ */
+#define libqcow_encryption_aesni_multiply_tweak( tweak, polynomial ) \
+	tweak = _mm_xor_si128( \
+	         _mm_slli_epi32( tweak, 1 ), \
+	         _mm_and_si128( _mm_shuffle_epi32( _mm_srai_epi32( tweak, 31 ), 0x93 ), polynomial ) )
+
+/* Sets the AES-128 decryption round keys using AES-NI
+ * The decryption round keys are the encryption round keys in reverse order
+ * where the inner round keys are transformed by AESIMC
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("aes,sse2")))
+#endif
+int libqcow_encryption_set_decryption_round_keys_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *key,
+     libcerror_error_t **error )
+{
+	__m128i round_keys[ 11 ];
+
+	static char *function = "libqcow_encryption_set_decryption_round_keys_aesni";
+	int round_index       = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	round_keys[ 0 ] = _mm_loadu_si128(
+	                   (__m128i *) key );
+
+	/* AESKEYGENASSIST requires the round constant to be an immediate value
+	 */
+	round_keys[ 1 ] = round_keys[ 0 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 1 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 0 ], 0x01 ) );
+
+	round_keys[ 2 ] = round_keys[ 1 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 2 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 1 ], 0x02 ) );
+
+	round_keys[ 3 ] = round_keys[ 2 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 3 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 2 ], 0x04 ) );
+
+	round_keys[ 4 ] = round_keys[ 3 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 4 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 3 ], 0x08 ) );
+
+	round_keys[ 5 ] = round_keys[ 4 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 5 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 4 ], 0x10 ) );
+
+	round_keys[ 6 ] = round_keys[ 5 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 6 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 5 ], 0x20 ) );
+
+	round_keys[ 7 ] = round_keys[ 6 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 7 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 6 ], 0x40 ) );
+
+	round_keys[ 8 ] = round_keys[ 7 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 8 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 7 ], 0x80 ) );
+
+	round_keys[ 9 ] = round_keys[ 8 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 9 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 8 ], 0x1b ) );
+
+	round_keys[ 10 ] = round_keys[ 9 ];
+	libqcow_encryption_aesni_expand_round_key(
+	 round_keys[ 10 ],
+	 _mm_aeskeygenassist_si128( round_keys[ 9 ], 0x36 ) );
+
+	_mm_storeu_si128(
+	 (__m128i *) context->decryption_round_keys,
+	 round_keys[ 10 ] );
+
+	for( round_index = 1;
+	     round_index < 10;
+	     round_index++ )
+	{
+		_mm_storeu_si128(
+		 (__m128i *) &( context->decryption_round_keys[ round_index * 16 ] ),
+		 _mm_aesimc_si128( round_keys[ 10 - round_index ] ) );
+	}
+	_mm_storeu_si128(
+	 (__m128i *) &( context->decryption_round_keys[ 160 ] ),
+	 round_keys[ 0 ] );
+
+	if( memory_set(
+	     round_keys,
+	     0,
+	     sizeof( __m128i ) * 11 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear round keys.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* AES-CBC decrypts sectors of 512 bytes using AES-NI
+ * The blocks of a sector do not depend on each other when decrypting, hence 8 blocks are
+ * decrypted interleaved. The input and output data can be the same buffer
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("aes,sse2")))
+#endif
+int libqcow_encryption_decrypt_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error )
+{
+	__m128i blocks[ 8 ];
+	__m128i encrypted_blocks[ 8 ];
+	__m128i round_keys[ 11 ];
+	__m128i previous_encrypted_block;
+
+	static char *function = "libqcow_encryption_decrypt_aesni";
+	size_t block_offset   = 0;
+	size_t data_offset    = 0;
+	int block_index       = 0;
+	int round_index       = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( input_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid input data.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid output data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size % 512 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	for( round_index = 0;
+	     round_index < 11;
+	     round_index++ )
+	{
+		round_keys[ round_index ] = _mm_loadu_si128(
+		                             (__m128i *) &( context->decryption_round_keys[ round_index * 16 ] ) );
+	}
+	while( data_offset < data_size )
+	{
+		/* The initialization vector of a sector is the little-endian block key
+		 */
+		previous_encrypted_block = _mm_set_epi32(
+		                            0,
+		                            0,
+		                            (int) ( block_key >> 32 ),
+		                            (int) ( block_key & 0xffffffffUL ) );
+
+		for( block_offset = 0;
+		     block_offset < 512;
+		     block_offset += 128 )
+		{
+			/* All encrypted blocks are loaded before the decrypted blocks are stored
+			 * to support decrypting in-place
+			 */
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				encrypted_blocks[ block_index ] = _mm_loadu_si128(
+				                                   (__m128i *) &( input_data[ data_offset + block_offset + ( block_index * 16 ) ] ) );
+
+				blocks[ block_index ] = _mm_xor_si128(
+				                         encrypted_blocks[ block_index ],
+				                         round_keys[ 0 ] );
+			}
+			for( round_index = 1;
+			     round_index < 10;
+			     round_index++ )
+			{
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					blocks[ block_index ] = _mm_aesdec_si128(
+					                         blocks[ block_index ],
+					                         round_keys[ round_index ] );
+				}
+			}
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				blocks[ block_index ] = _mm_aesdeclast_si128(
+				                         blocks[ block_index ],
+				                         round_keys[ 10 ] );
+			}
+			blocks[ 0 ] = _mm_xor_si128(
+			               blocks[ 0 ],
+			               previous_encrypted_block );
+
+			for( block_index = 1;
+			     block_index < 8;
+			     block_index++ )
+			{
+				blocks[ block_index ] = _mm_xor_si128(
+				                         blocks[ block_index ],
+				                         encrypted_blocks[ block_index - 1 ] );
+			}
+			previous_encrypted_block = encrypted_blocks[ 7 ];
+
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				_mm_storeu_si128(
+				 (__m128i *) &( output_data[ data_offset + block_offset + ( block_index * 16 ) ] ),
+				 blocks[ block_index ] );
+			}
+		}
+		data_offset += 512;
+		block_key   += 1;
+	}
+	return( 1 );
+}
+
+/* Expands an AES-128 or AES-256 key into round keys using AES-NI
+ * The encryption and decryption round keys are optional and consist of 176 bytes for AES-128
+ * or 240 bytes for AES-256
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("aes,sse2")))
+#endif
+int libqcow_encryption_expand_round_keys_aesni(
+     const uint8_t *key,
+     size_t key_bit_size,
+     uint8_t *encryption_round_keys,
+     uint8_t *decryption_round_keys,
+     libcerror_error_t **error )
+{
+	__m128i round_keys[ 15 ];
+
+	static char *function = "libqcow_encryption_expand_round_keys_aesni";
+	int number_of_rounds  = 0;
+	int round_index       = 0;
+
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	round_keys[ 0 ] = _mm_loadu_si128(
+	                   (__m128i *) key );
+
+	/* AESKEYGENASSIST requires the round constant to be an immediate value
+	 */
+	if( key_bit_size == 128 )
+	{
+		number_of_rounds = 10;
+
+		round_keys[ 1 ] = round_keys[ 0 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 1 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 0 ], 0x01 ) );
+
+		round_keys[ 2 ] = round_keys[ 1 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 2 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 1 ], 0x02 ) );
+
+		round_keys[ 3 ] = round_keys[ 2 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 3 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 2 ], 0x04 ) );
+
+		round_keys[ 4 ] = round_keys[ 3 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 4 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 3 ], 0x08 ) );
+
+		round_keys[ 5 ] = round_keys[ 4 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 5 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 4 ], 0x10 ) );
+
+		round_keys[ 6 ] = round_keys[ 5 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 6 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 5 ], 0x20 ) );
+
+		round_keys[ 7 ] = round_keys[ 6 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 7 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 6 ], 0x40 ) );
+
+		round_keys[ 8 ] = round_keys[ 7 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 8 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 7 ], 0x80 ) );
+
+		round_keys[ 9 ] = round_keys[ 8 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 9 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 8 ], 0x1b ) );
+
+		round_keys[ 10 ] = round_keys[ 9 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 10 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 9 ], 0x36 ) );
+	}
+	else if( key_bit_size == 256 )
+	{
+		number_of_rounds = 14;
+
+		round_keys[ 1 ] = _mm_loadu_si128(
+		                   (__m128i *) &( key[ 16 ] ) );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 2,
+		 0x01 );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 4,
+		 0x02 );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 6,
+		 0x04 );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 8,
+		 0x08 );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 10,
+		 0x10 );
+
+		libqcow_encryption_aesni_expand_round_keys_256(
+		 round_keys,
+		 12,
+		 0x20 );
+
+		round_keys[ 14 ] = round_keys[ 12 ];
+		libqcow_encryption_aesni_expand_round_key(
+		 round_keys[ 14 ],
+		 _mm_aeskeygenassist_si128( round_keys[ 13 ], 0x40 ) );
+	}
+	else
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported key bit size.",
+		 function );
+
+		return( -1 );
+	}
+	if( encryption_round_keys != NULL )
+	{
+		for( round_index = 0;
+		     round_index <= number_of_rounds;
+		     round_index++ )
+		{
+			_mm_storeu_si128(
+			 (__m128i *) &( encryption_round_keys[ round_index * 16 ] ),
+			 round_keys[ round_index ] );
+		}
+	}
+	/* The decryption round keys are the encryption round keys in reverse order
+	 * where the inner round keys are transformed by AESIMC
+	 */
+	if( decryption_round_keys != NULL )
+	{
+		_mm_storeu_si128(
+		 (__m128i *) decryption_round_keys,
+		 round_keys[ number_of_rounds ] );
+
+		for( round_index = 1;
+		     round_index < number_of_rounds;
+		     round_index++ )
+		{
+			_mm_storeu_si128(
+			 (__m128i *) &( decryption_round_keys[ round_index * 16 ] ),
+			 _mm_aesimc_si128( round_keys[ number_of_rounds - round_index ] ) );
+		}
+		_mm_storeu_si128(
+		 (__m128i *) &( decryption_round_keys[ number_of_rounds * 16 ] ),
+		 round_keys[ 0 ] );
+	}
+	if( memory_set(
+	     round_keys,
+	     0,
+	     sizeof( __m128i ) * 15 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear round keys.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Sets the AES-XTS decryption and tweak encryption round keys using AES-NI
+ * The key consists of the (data) key followed by the tweak key
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_encryption_set_xts_round_keys_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *key,
+     size_t key_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_encryption_set_xts_round_keys_aesni";
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	if( key_size == 32 )
+	{
+		context->number_of_rounds = 10;
+	}
+	else if( key_size == 64 )
+	{
+		context->number_of_rounds = 14;
+	}
+	else
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported key size.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_encryption_expand_round_keys_aesni(
+	     key,
+	     ( key_size / 2 ) * 8,
+	     NULL,
+	     context->decryption_round_keys,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to expand key into decryption round keys.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_encryption_expand_round_keys_aesni(
+	     &( key[ key_size / 2 ] ),
+	     ( key_size / 2 ) * 8,
+	     context->tweak_encryption_round_keys,
+	     NULL,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to expand tweak key into encryption round keys.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* AES-XTS decrypts sectors of 512 bytes using AES-NI
+ * The tweaks of up to 8 sectors are encrypted interleaved, after which the blocks of
+ * every sector are decrypted 8 blocks interleaved. The input and output data can be the same buffer
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("aes,sse2")))
+#endif
+int libqcow_encryption_decrypt_xts_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error )
+{
+	__m128i blocks[ 8 ];
+	__m128i round_keys[ 15 ];
+	__m128i sector_tweaks[ 8 ];
+	__m128i tweak_round_keys[ 15 ];
+	__m128i tweaks[ 8 ];
+	__m128i polynomial;
+	__m128i tweak;
+
+	static char *function    = "libqcow_encryption_decrypt_xts_aesni";
+	size_t block_offset      = 0;
+	size_t data_offset       = 0;
+	size_t number_of_sectors = 0;
+	size_t sector_index      = 0;
+	int block_index          = 0;
+	int number_of_rounds     = 0;
+	int round_index          = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( context->number_of_rounds != 10 )
+	 && ( context->number_of_rounds != 14 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid context - unsupported number of rounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( input_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid input data.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid output data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size % 512 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_rounds = context->number_of_rounds;
+
+	for( round_index = 0;
+	     round_index <= number_of_rounds;
+	     round_index++ )
+	{
+		round_keys[ round_index ] = _mm_loadu_si128(
+		                             (__m128i *) &( context->decryption_round_keys[ round_index * 16 ] ) );
+
+		tweak_round_keys[ round_index ] = _mm_loadu_si128(
+		                                   (__m128i *) &( context->tweak_encryption_round_keys[ round_index * 16 ] ) );
+	}
+	polynomial = _mm_set_epi32(
+	              1,
+	              1,
+	              1,
+	              0x87 );
+
+	while( data_offset < data_size )
+	{
+		number_of_sectors = ( data_size - data_offset ) / 512;
+
+		if( number_of_sectors > 8 )
+		{
+			number_of_sectors = 8;
+		}
+		/* The tweak value of a sector is the little-endian block key (plain64),
+		 * the tweak values of the sectors in the batch are encrypted interleaved
+		 */
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			sector_tweaks[ sector_index ] = _mm_xor_si128(
+			                                 _mm_set_epi32(
+			                                  0,
+			                                  0,
+			                                  (int) ( ( block_key + sector_index ) >> 32 ),
+			                                  (int) ( ( block_key + sector_index ) & 0xffffffffUL ) ),
+			                                 tweak_round_keys[ 0 ] );
+		}
+		for( round_index = 1;
+		     round_index < number_of_rounds;
+		     round_index++ )
+		{
+			for( sector_index = 0;
+			     sector_index < number_of_sectors;
+			     sector_index++ )
+			{
+				sector_tweaks[ sector_index ] = _mm_aesenc_si128(
+				                                 sector_tweaks[ sector_index ],
+				                                 tweak_round_keys[ round_index ] );
+			}
+		}
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			sector_tweaks[ sector_index ] = _mm_aesenclast_si128(
+			                                 sector_tweaks[ sector_index ],
+			                                 tweak_round_keys[ number_of_rounds ] );
+		}
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			tweak = sector_tweaks[ sector_index ];
+
+			for( block_offset = 0;
+			     block_offset < 512;
+			     block_offset += 128 )
+			{
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					tweaks[ block_index ] = tweak;
+
+					blocks[ block_index ] = _mm_xor_si128(
+					                         _mm_loadu_si128(
+					                          (__m128i *) &( input_data[ data_offset + block_offset + ( block_index * 16 ) ] ) ),
+					                         _mm_xor_si128(
+					                          tweak,
+					                          round_keys[ 0 ] ) );
+
+					libqcow_encryption_aesni_multiply_tweak(
+					 tweak,
+					 polynomial );
+				}
+				for( round_index = 1;
+				     round_index < number_of_rounds;
+				     round_index++ )
+				{
+					for( block_index = 0;
+					     block_index < 8;
+					     block_index++ )
+					{
+						blocks[ block_index ] = _mm_aesdec_si128(
+						                         blocks[ block_index ],
+						                         round_keys[ round_index ] );
+					}
+				}
+				/* All encrypted blocks are loaded before the decrypted blocks are stored
+				 * to support decrypting in-place
+				 */
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					blocks[ block_index ] = _mm_aesdeclast_si128(
+					                         blocks[ block_index ],
+					                         round_keys[ number_of_rounds ] );
+
+					_mm_storeu_si128(
+					 (__m128i *) &( output_data[ data_offset + block_offset + ( block_index * 16 ) ] ),
+					 _mm_xor_si128(
+					  blocks[ block_index ],
+					  tweaks[ block_index ] ) );
+				}
+			}
+			data_offset += 512;
+		}
+		block_key += number_of_sectors;
+	}
+	return( 1 );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+/* AES-CBC decrypts sectors of 512 bytes using VAES
+ * Every 256-bit register contains 2 blocks and 8 registers are decrypted interleaved,
+ * hence a sector is decrypted in 2 iterations. The input and output data can be the same buffer
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("vaes,avx2")))
+#endif
+int libqcow_encryption_decrypt_vaes(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error )
+{
+	__m256i blocks[ 8 ];
+	__m256i chaining_blocks[ 8 ];
+	__m256i round_keys[ 11 ];
+	__m128i previous_encrypted_block;
+
+	static char *function = "libqcow_encryption_decrypt_vaes";
+	size_t block_offset   = 0;
+	size_t data_offset    = 0;
+	int block_index       = 0;
+	int round_index       = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( input_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid input data.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid output data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size % 512 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	for( round_index = 0;
+	     round_index < 11;
+	     round_index++ )
+	{
+		round_keys[ round_index ] = _mm256_broadcastsi128_si256(
+		                             _mm_loadu_si128(
+		                              (__m128i *) &( context->decryption_round_keys[ round_index * 16 ] ) ) );
+	}
+	while( data_offset < data_size )
+	{
+		/* The initialization vector of a sector is the little-endian block key
+		 */
+		previous_encrypted_block = _mm_set_epi32(
+		                            0,
+		                            0,
+		                            (int) ( block_key >> 32 ),
+		                            (int) ( block_key & 0xffffffffUL ) );
+
+		for( block_offset = 0;
+		     block_offset < 512;
+		     block_offset += 256 )
+		{
+			/* All encrypted blocks, which are also the chaining blocks of the blocks that follow
+			 * them, are loaded before the decrypted blocks are stored to support decrypting in-place
+			 */
+			chaining_blocks[ 0 ] = _mm256_inserti128_si256(
+			                        _mm256_castsi128_si256(
+			                         previous_encrypted_block ),
+			                        _mm_loadu_si128(
+			                         (__m128i *) &( input_data[ data_offset + block_offset ] ) ),
+			                        1 );
+
+			for( block_index = 1;
+			     block_index < 8;
+			     block_index++ )
+			{
+				chaining_blocks[ block_index ] = _mm256_loadu_si256(
+				                                  (__m256i *) &( input_data[ data_offset + block_offset + ( block_index * 32 ) - 16 ] ) );
+			}
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				blocks[ block_index ] = _mm256_xor_si256(
+				                         _mm256_loadu_si256(
+				                          (__m256i *) &( input_data[ data_offset + block_offset + ( block_index * 32 ) ] ) ),
+				                         round_keys[ 0 ] );
+			}
+			previous_encrypted_block = _mm_loadu_si128(
+			                            (__m128i *) &( input_data[ data_offset + block_offset + 240 ] ) );
+
+			for( round_index = 1;
+			     round_index < 10;
+			     round_index++ )
+			{
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					blocks[ block_index ] = _mm256_aesdec_epi128(
+					                         blocks[ block_index ],
+					                         round_keys[ round_index ] );
+				}
+			}
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				blocks[ block_index ] = _mm256_aesdeclast_epi128(
+				                         blocks[ block_index ],
+				                         round_keys[ 10 ] );
+
+				blocks[ block_index ] = _mm256_xor_si256(
+				                         blocks[ block_index ],
+				                         chaining_blocks[ block_index ] );
+			}
+			for( block_index = 0;
+			     block_index < 8;
+			     block_index++ )
+			{
+				_mm256_storeu_si256(
+				 (__m256i *) &( output_data[ data_offset + block_offset + ( block_index * 32 ) ] ),
+				 blocks[ block_index ] );
+			}
+		}
+		data_offset += 512;
+		block_key   += 1;
+	}
+	return( 1 );
+}
+
+/* Multiplies 2 AES-XTS tweaks in a 256-bit register by the square of the primitive element (x^2) of GF(2^128)
+ * The tweaks are shifted 2 bits to the left, where the bits that are shifted out of every 32-bit value
+ * are carried into the next 32-bit value. The bits shifted out of a tweak are reduced by carry-less
+ * multiplication with the polynomial (0x87), which is calculated with shifts because there are only 2 bits
+ */
+#define libqcow_encryption_vaes_multiply_tweaks_squared( tweaks, carry, reduction_mask ) \
+	carry  = _mm256_shuffle_epi32( _mm256_srli_epi32( tweaks, 30 ), 0x93 ); \
+	tweaks = _mm256_xor_si256( \
+	          _mm256_xor_si256( _mm256_slli_epi32( tweaks, 2 ), carry ), \
+	          _mm256_and_si256( \
+	           _mm256_xor_si256( \
+	            _mm256_xor_si256( _mm256_slli_epi32( carry, 1 ), _mm256_slli_epi32( carry, 2 ) ), \
+	            _mm256_slli_epi32( carry, 7 ) ), \
+	           reduction_mask ) )
+
+/* AES-XTS decrypts sectors of 512 bytes using VAES
+ * The tweaks of up to 8 sectors are encrypted interleaved using AES-NI, after which every 256-bit
+ * register contains 2 blocks and 8 registers are decrypted interleaved, hence a sector is decrypted
+ * in 2 iterations. The input and output data can be the same buffer
+ * Returns 1 if successful or -1 on error
+ */
+#if !defined( _MSC_VER )
+__attribute__((target("aes,vaes,avx2")))
+#endif
+int libqcow_encryption_decrypt_xts_vaes(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error )
+{
+	__m256i blocks[ 8 ];
+	__m256i round_keys[ 15 ];
+	__m256i tweaks[ 8 ];
+	__m256i carry;
+	__m256i reduction_mask;
+	__m256i tweak_pair;
+	__m128i sector_tweaks[ 8 ];
+	__m128i tweak_round_keys[ 15 ];
+	__m128i polynomial;
+	__m128i tweak;
+
+	static char *function    = "libqcow_encryption_decrypt_xts_vaes";
+	size_t block_offset      = 0;
+	size_t data_offset       = 0;
+	size_t number_of_sectors = 0;
+	size_t sector_index      = 0;
+	int block_index          = 0;
+	int number_of_rounds     = 0;
+	int round_index          = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( context->number_of_rounds != 10 )
+	 && ( context->number_of_rounds != 14 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid context - unsupported number of rounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( input_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid input data.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid output data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size % 512 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_rounds = context->number_of_rounds;
+
+	for( round_index = 0;
+	     round_index <= number_of_rounds;
+	     round_index++ )
+	{
+		round_keys[ round_index ] = _mm256_broadcastsi128_si256(
+		                             _mm_loadu_si128(
+		                              (__m128i *) &( context->decryption_round_keys[ round_index * 16 ] ) ) );
+
+		tweak_round_keys[ round_index ] = _mm_loadu_si128(
+		                                   (__m128i *) &( context->tweak_encryption_round_keys[ round_index * 16 ] ) );
+	}
+	polynomial = _mm_set_epi32(
+	              1,
+	              1,
+	              1,
+	              0x87 );
+
+	reduction_mask = _mm256_set_epi32(
+	                  0,
+	                  0,
+	                  0,
+	                  -1,
+	                  0,
+	                  0,
+	                  0,
+	                  -1 );
+
+	while( data_offset < data_size )
+	{
+		number_of_sectors = ( data_size - data_offset ) / 512;
+
+		if( number_of_sectors > 8 )
+		{
+			number_of_sectors = 8;
+		}
+		/* The tweak value of a sector is the little-endian block key (plain64),
+		 * the tweak values of the sectors in the batch are encrypted interleaved
+		 */
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			sector_tweaks[ sector_index ] = _mm_xor_si128(
+			                                 _mm_set_epi32(
+			                                  0,
+			                                  0,
+			                                  (int) ( ( block_key + sector_index ) >> 32 ),
+			                                  (int) ( ( block_key + sector_index ) & 0xffffffffUL ) ),
+			                                 tweak_round_keys[ 0 ] );
+		}
+		for( round_index = 1;
+		     round_index < number_of_rounds;
+		     round_index++ )
+		{
+			for( sector_index = 0;
+			     sector_index < number_of_sectors;
+			     sector_index++ )
+			{
+				sector_tweaks[ sector_index ] = _mm_aesenc_si128(
+				                                 sector_tweaks[ sector_index ],
+				                                 tweak_round_keys[ round_index ] );
+			}
+		}
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			sector_tweaks[ sector_index ] = _mm_aesenclast_si128(
+			                                 sector_tweaks[ sector_index ],
+			                                 tweak_round_keys[ number_of_rounds ] );
+		}
+		for( sector_index = 0;
+		     sector_index < number_of_sectors;
+		     sector_index++ )
+		{
+			/* The first register contains the tweaks of the first 2 blocks of the sector
+			 */
+			tweak = sector_tweaks[ sector_index ];
+
+			libqcow_encryption_aesni_multiply_tweak(
+			 tweak,
+			 polynomial );
+
+			tweak_pair = _mm256_inserti128_si256(
+			              _mm256_castsi128_si256(
+			               sector_tweaks[ sector_index ] ),
+			              tweak,
+			              1 );
+
+			for( block_offset = 0;
+			     block_offset < 512;
+			     block_offset += 256 )
+			{
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					tweaks[ block_index ] = tweak_pair;
+
+					blocks[ block_index ] = _mm256_xor_si256(
+					                         _mm256_loadu_si256(
+					                          (__m256i *) &( input_data[ data_offset + block_offset + ( block_index * 32 ) ] ) ),
+					                         _mm256_xor_si256(
+					                          tweak_pair,
+					                          round_keys[ 0 ] ) );
+
+					libqcow_encryption_vaes_multiply_tweaks_squared(
+					 tweak_pair,
+					 carry,
+					 reduction_mask );
+				}
+				for( round_index = 1;
+				     round_index < number_of_rounds;
+				     round_index++ )
+				{
+					for( block_index = 0;
+					     block_index < 8;
+					     block_index++ )
+					{
+						blocks[ block_index ] = _mm256_aesdec_epi128(
+						                         blocks[ block_index ],
+						                         round_keys[ round_index ] );
+					}
+				}
+				/* All encrypted blocks are loaded before the decrypted blocks are stored
+				 * to support decrypting in-place
+				 */
+				for( block_index = 0;
+				     block_index < 8;
+				     block_index++ )
+				{
+					blocks[ block_index ] = _mm256_aesdeclast_epi128(
+					                         blocks[ block_index ],
+					                         round_keys[ number_of_rounds ] );
+
+					_mm256_storeu_si256(
+					 (__m256i *) &( output_data[ data_offset + block_offset + ( block_index * 32 ) ] ),
+					 _mm256_xor_si256(
+					  blocks[ block_index ],
+					  tweaks[ block_index ] ) );
+				}
+			}
+			data_offset += 512;
+		}
+		block_key += number_of_sectors;
+	}
+	return( 1 );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
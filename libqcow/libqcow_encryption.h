@@ -28,6 +28,32 @@
 #include "libqcow_libcaes.h"
 #include "libqcow_libcerror.h"
 
+/* The instruction sets that can be used to decrypt AES-CBC and AES-XTS
+ * AES-NI and VAES support is determined at run-time
+ */
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_AMD64 ) )
+#define LIBQCOW_ENCRYPTION_HAVE_AESNI
+
+#if _MSC_VER >= 1920
+#define LIBQCOW_ENCRYPTION_HAVE_VAES
+#endif
+
+#elif defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) ) && ( defined( __clang__ ) || ( __GNUC__ >= 5 ) )
+#define LIBQCOW_ENCRYPTION_HAVE_AESNI
+
+#if ( defined( __clang__ ) && ( __clang_major__ >= 8 ) ) || ( !defined( __clang__ ) && ( __GNUC__ >= 11 ) )
+#define LIBQCOW_ENCRYPTION_HAVE_VAES
+#endif
+
+#endif
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) && defined( _MSC_VER )
+#include <intrin.h>
+
+#elif defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+#include <immintrin.h>
+#endif
+
 #if defined( __cplusplus )
 extern "C" {
 #endif
@@ -38,6 +64,15 @@ enum LIBQCOW_ENCYPTION_CRYPT_MODES
 	LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT   = 1
 };
 
+/* The AES implementations
+ */
+enum LIBQCOW_ENCRYPTION_AES_IMPLEMENTATIONS
+{
+	LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC	= 1,
+	LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI	= 2,
+	LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES	= 3
+};
+
 typedef struct libqcow_encryption_context libqcow_encryption_context_t;
 
 struct libqcow_encryption_context
@@ -53,6 +88,30 @@ struct libqcow_encryption_context
 	/* The (AES) encryption context
 	 */
 	libcaes_context_t *encryption_context;
+
+	/* The (AES-XTS) decryption tweaked context
+	 */
+	libcaes_tweaked_context_t *decryption_tweaked_context;
+
+	/* The (AES-XTS) encryption tweaked context
+	 */
+	libcaes_tweaked_context_t *encryption_tweaked_context;
+
+	/* The AES implementation used to decrypt
+	 */
+	int aes_implementation;
+
+	/* The number of AES rounds
+	 */
+	int number_of_rounds;
+
+	/* The decryption round keys used by the AES-NI and VAES implementations
+	 */
+	uint8_t decryption_round_keys[ 240 ];
+
+	/* The (AES-XTS) tweak encryption round keys used by the AES-NI implementation
+	 */
+	uint8_t tweak_encryption_round_keys[ 240 ];
 };
 
 int libqcow_encryption_initialize(
@@ -70,6 +129,67 @@ int libqcow_encryption_set_keys(
      size_t key_size,
      libcerror_error_t **error );
 
+int libqcow_encryption_get_aes_implementation(
+     void );
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+int libqcow_encryption_set_decryption_round_keys_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *key,
+     libcerror_error_t **error );
+
+int libqcow_encryption_decrypt_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error );
+
+int libqcow_encryption_expand_round_keys_aesni(
+     const uint8_t *key,
+     size_t key_bit_size,
+     uint8_t *encryption_round_keys,
+     uint8_t *decryption_round_keys,
+     libcerror_error_t **error );
+
+int libqcow_encryption_set_xts_round_keys_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *key,
+     size_t key_size,
+     libcerror_error_t **error );
+
+int libqcow_encryption_decrypt_xts_aesni(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+int libqcow_encryption_decrypt_vaes(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error );
+
+int libqcow_encryption_decrypt_xts_vaes(
+     libqcow_encryption_context_t *context,
+     const uint8_t *input_data,
+     uint8_t *output_data,
+     size_t data_size,
+     uint64_t block_key,
+     libcerror_error_t **error );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
 int libqcow_encryption_crypt(
      libqcow_encryption_context_t *context,
      int mode,
@@ -25,11 +25,17 @@
 #include <types.h>
 #include <wide_string.h>
 
+#include "libqcow_bitmap.h"
+#include "libqcow_bitmap_values.h"
+#include "libqcow_block_cache.h"
+#include "libqcow_buffer_pool.h"
+#include "libqcow_cache_budget.h"
 #include "libqcow_cluster_block.h"
 #include "libqcow_cluster_table.h"
 #include "libqcow_codepage.h"
 #include "libqcow_compression.h"
 #include "libqcow_debug.h"
+#include "libqcow_decompression_pool.h"
 #include "libqcow_definitions.h"
 #include "libqcow_encryption.h"
 #include "libqcow_file_header.h"
@@ -40,9 +46,14 @@
 #include "libqcow_libcerror.h"
 #include "libqcow_libcnotify.h"
 #include "libqcow_libcthreads.h"
-#include "libqcow_libfcache.h"
-#include "libqcow_libfdata.h"
 #include "libqcow_libuna.h"
+#include "libqcow_luks_header.h"
+#include "libqcow_read_segment.h"
+#include "libqcow_readahead.h"
+#include "libqcow_reference_count_block.h"
+#include "libqcow_snapshot.h"
+#include "libqcow_snapshot_values.h"
+#include "libqcow_unused.h"
 
 /* Creates a file
  * Make sure the value file is referencing, is set to NULL
@@ -147,8 +158,23 @@ int libqcow_file_initialize(
 
 		goto on_error;
 	}
+	if( libcthreads_mutex_initialize(
+	     &( internal_file->cache_mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize cache mutex.",
+		 function );
+
+		goto on_error;
+	}
 #endif
-	internal_file->is_locked = 1;
+	internal_file->is_locked               = 1;
+	internal_file->io_queue_depth          = 1;
+	internal_file->selected_snapshot_index = -1;
 
 	*file = (libqcow_file_t *) internal_file;
 
@@ -157,6 +183,14 @@ int libqcow_file_initialize(
 on_error:
 	if( internal_file != NULL )
 	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( internal_file->read_write_lock != NULL )
+		{
+			libcthreads_read_write_lock_free(
+			 &( internal_file->read_write_lock ),
+			 NULL );
+		}
+#endif
 		if( internal_file->io_handle != NULL )
 		{
 			libqcow_io_handle_free(
@@ -227,6 +261,19 @@ int libqcow_file_free(
 
 			result = -1;
 		}
+		if( libcthreads_mutex_free(
+		     &( internal_file->cache_mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cache mutex.",
+			 function );
+
+			result = -1;
+		}
 #endif
 		if( libqcow_io_handle_free(
 		     &( internal_file->io_handle ),
@@ -241,16 +288,15 @@ int libqcow_file_free(
 
 			result = -1;
 		}
-		if( memory_set(
-		     internal_file->key_data,
-		     0,
-		     16 ) == NULL )
+		if( libqcow_internal_file_clear_keys(
+		     internal_file,
+		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_MEMORY,
-			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-			 "%s: unable to clear key data.",
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to clear keys.",
 			 function );
 
 			result = -1;
@@ -312,6 +358,7 @@ int libqcow_file_open(
 	libbfio_handle_t *file_io_handle       = NULL;
 	libqcow_internal_file_t *internal_file = NULL;
 	static char *function                  = "libqcow_file_open";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -347,17 +394,6 @@ int libqcow_file_open(
 
 		return( -1 );
 	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: write access currently not supported.",
-		 function );
-
-		return( -1 );
-	}
 	internal_file = (libqcow_internal_file_t *) file;
 
 	if( libbfio_file_initialize(
@@ -438,6 +474,21 @@ int libqcow_file_open(
 #endif
 	internal_file->file_io_handle_created_in_library = 1;
 
+	if( libqcow_internal_file_open_direct_access(
+	     internal_file,
+	     file_io_handle,
+	     access_flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open direct access to file.",
+		 function );
+
+		result = -1;
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
@@ -453,7 +504,7 @@ int libqcow_file_open(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 
 on_error:
 	if( file_io_handle != NULL )
@@ -479,6 +530,7 @@ int libqcow_file_open_wide(
 	libbfio_handle_t *file_io_handle       = NULL;
 	libqcow_internal_file_t *internal_file = NULL;
 	static char *function                  = "libqcow_file_open_wide";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -514,17 +566,6 @@ int libqcow_file_open_wide(
 
 		return( -1 );
 	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: write access currently not supported.",
-		 function );
-
-		return( -1 );
-	}
 	internal_file = (libqcow_internal_file_t *) file;
 
 	if( libbfio_file_initialize(
@@ -605,6 +646,21 @@ int libqcow_file_open_wide(
 #endif
 	internal_file->file_io_handle_created_in_library = 1;
 
+	if( libqcow_internal_file_open_direct_access(
+	     internal_file,
+	     file_io_handle,
+	     access_flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open direct access to file.",
+		 function );
+
+		result = -1;
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
@@ -620,7 +676,7 @@ int libqcow_file_open_wide(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 
 on_error:
 	if( file_io_handle != NULL )
@@ -697,20 +753,13 @@ int libqcow_file_open_file_io_handle(
 
 		return( -1 );
 	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: write access currently not supported.",
-		 function );
+	/* The metadata is read for write access as well
+	 */
+	bfio_access_flags = LIBBFIO_ACCESS_FLAG_READ;
 
-		return( -1 );
-	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_READ ) != 0 )
+	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
 	{
-		bfio_access_flags = LIBBFIO_ACCESS_FLAG_READ;
+		bfio_access_flags |= LIBBFIO_ACCESS_FLAG_WRITE;
 	}
 	file_io_handle_is_open = libbfio_handle_is_open(
 	                          file_io_handle,
@@ -760,6 +809,8 @@ int libqcow_file_open_file_io_handle(
 		return( -1 );
 	}
 #endif
+	internal_file->access_flags = access_flags;
+
 	result = libqcow_internal_file_open_read(
 	          internal_file,
 	          file_io_handle,
@@ -773,6 +824,8 @@ int libqcow_file_open_file_io_handle(
 		 LIBCERROR_IO_ERROR_READ_FAILED,
 		 "%s: unable to read from file IO handle.",
 		 function );
+
+		internal_file->access_flags = 0;
 	}
 	else
 	{
@@ -855,6 +908,74 @@ int libqcow_file_close(
 
 		return( -1 );
 	}
+	if( internal_file->readahead != NULL )
+	{
+		if( libqcow_readahead_free(
+		     &( internal_file->readahead ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free readahead.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( internal_file->decompression_pool != NULL )
+	{
+		if( libqcow_decompression_pool_free(
+		     &( internal_file->decompression_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free decompression pool.",
+			 function );
+
+			result = -1;
+		}
+	}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING )
+	if( internal_file->io_uring != NULL )
+	{
+		if( libqcow_io_uring_free(
+		     &( internal_file->io_uring ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free io_uring.",
+			 function );
+
+			result = -1;
+		}
+	}
+#endif
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	if( internal_file->mapped_file != NULL )
+	{
+		if( libqcow_mapped_file_free(
+		     &( internal_file->mapped_file ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mapped file.",
+			 function );
+
+			result = -1;
+		}
+	}
 #endif
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
@@ -877,6 +998,41 @@ int libqcow_file_close(
 		}
 	}
 #endif
+	if( ( internal_file->reference_count_table != NULL )
+	 && ( internal_file->write_failed == 0 ) )
+	{
+		if( libqcow_internal_file_write_modified_metadata(
+		     internal_file,
+		     internal_file->file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write modified metadata.",
+			 function );
+
+			result = -1;
+		}
+		/* The dirty flag is only cleared when the reference counts are consistent
+		 */
+		else if( libqcow_internal_file_set_dirty_flag(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          0,
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to clear dirty flag.",
+			 function );
+
+			result = -1;
+		}
+	}
 	if( internal_file->file_io_handle_opened_in_library != 0 )
 	{
 		if( libbfio_handle_close(
@@ -911,6 +1067,47 @@ int libqcow_file_close(
 		}
 		internal_file->file_io_handle_created_in_library = 0;
 	}
+	if( internal_file->data_file_io_handle_opened_in_library != 0 )
+	{
+		if( libbfio_handle_close(
+		     internal_file->data_file_io_handle,
+		     error ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close data file IO handle.",
+			 function );
+
+			result = -1;
+		}
+		internal_file->data_file_io_handle_opened_in_library = 0;
+	}
+	internal_file->data_file_io_handle = NULL;
+	internal_file->data_file_size      = 0;
+	internal_file->data_file_is_raw    = 0;
+
+	if( internal_file->parent_file_io_handle_opened_in_library != 0 )
+	{
+		if( libbfio_handle_close(
+		     internal_file->parent_file_io_handle,
+		     error ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close parent file IO handle.",
+			 function );
+
+			result = -1;
+		}
+		internal_file->parent_file_io_handle_opened_in_library = 0;
+	}
+	internal_file->parent_file_io_handle = NULL;
+	internal_file->parent_file_size      = 0;
+
 	internal_file->file_io_handle = NULL;
 	internal_file->current_offset = 0;
 	internal_file->is_locked      = 1;
@@ -949,6 +1146,22 @@ int libqcow_file_close(
 		internal_file->backing_filename      = NULL;
 		internal_file->backing_filename_size = 0;
 	}
+	if( internal_file->backing_format != NULL )
+	{
+		memory_free(
+		 internal_file->backing_format );
+
+		internal_file->backing_format      = NULL;
+		internal_file->backing_format_size = 0;
+	}
+	if( internal_file->data_filename != NULL )
+	{
+		memory_free(
+		 internal_file->data_filename );
+
+		internal_file->data_filename      = NULL;
+		internal_file->data_filename_size = 0;
+	}
 	if( libqcow_cluster_table_free(
 	     &( internal_file->level1_table ),
 	     error ) != 1 )
@@ -962,46 +1175,46 @@ int libqcow_file_close(
 
 		result = -1;
 	}
-	if( libfdata_vector_free(
-	     &( internal_file->level2_table_vector ),
+	if( libqcow_internal_file_free_snapshots(
+	     internal_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free level2 table vector.",
+		 "%s: unable to free snapshots.",
 		 function );
 
 		result = -1;
 	}
-	if( libfcache_cache_free(
-	     &( internal_file->level2_table_cache ),
+	if( libqcow_internal_file_free_bitmaps(
+	     internal_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free level2 table cache.",
+		 "%s: unable to free bitmaps.",
 		 function );
 
 		result = -1;
 	}
-	if( libfdata_vector_free(
-	     &( internal_file->cluster_block_vector ),
+	if( libqcow_block_cache_free(
+	     &( internal_file->level2_table_cache ),
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free cluster block vector.",
+		 "%s: unable to free level2 table cache.",
 		 function );
 
 		result = -1;
 	}
-	if( libfcache_cache_free(
+	if( libqcow_block_cache_free(
 	     &( internal_file->cluster_block_cache ),
 	     error ) != 1 )
 	{
@@ -1014,7 +1227,7 @@ int libqcow_file_close(
 
 		result = -1;
 	}
-	if( libfcache_cache_free(
+	if( libqcow_block_cache_free(
 	     &( internal_file->compressed_cluster_block_cache ),
 	     error ) != 1 )
 	{
@@ -1027,6 +1240,52 @@ int libqcow_file_close(
 
 		result = -1;
 	}
+	internal_file->number_of_decompressed_cluster_blocks = 0;
+
+	/* The buffer pool is freed after the caches since these release their cluster blocks into it
+	 */
+	if( libqcow_buffer_pool_free(
+	     &( internal_file->buffer_pool ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free buffer pool.",
+		 function );
+
+		result = -1;
+	}
+
+	if( libqcow_internal_file_free_write_values(
+	     internal_file,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free write values.",
+		 function );
+
+		result = -1;
+	}
+	if( libqcow_cache_budget_release(
+	     internal_file->reserved_cache_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to release reserved cache size.",
+		 function );
+
+		result = -1;
+	}
+	internal_file->reserved_cache_size = 0;
+
 	if( internal_file->encryption_context != NULL )
 	{
 		if( libqcow_encryption_free(
@@ -1069,12 +1328,15 @@ int libqcow_internal_file_open_read(
      libbfio_handle_t *file_io_handle,
      libcerror_error_t **error )
 {
+	uint8_t encryption_key[ LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ];
+
 	static char *function                      = "libqcow_internal_file_open_read";
+	size_t encryption_key_size                 = 0;
+	size64_t maximum_number_of_free_buffers    = 0;
 	size_t level1_table_size                   = 0;
 	size_t level2_table_size                   = 0;
 	uint32_t number_of_level1_table_references = 0;
 	uint32_t number_of_level2_table_bits       = 0;
-	int entry_index                            = 0;
 
 	if( internal_file == NULL )
 	{
@@ -1131,46 +1393,35 @@ int libqcow_internal_file_open_read(
 
 		return( -1 );
 	}
-	if( internal_file->level2_table_vector != NULL )
+	if( internal_file->level2_table_cache != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - level2 table vector already set.",
+		 "%s: invalid file - level2 table cache already set.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->level2_table_cache != NULL )
+	if( internal_file->buffer_pool != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - level2 table cache already set.",
+		 "%s: invalid file - buffer pool already set.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_vector != NULL )
+	if( internal_file->cluster_block_cache != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - cluster block vector already set.",
-		 function );
-
-		return( -1 );
-	}
-	if( internal_file->cluster_block_cache != NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - cluster block cache already set.",
+		 "%s: invalid file - cluster block cache already set.",
 		 function );
 
 		return( -1 );
@@ -1246,7 +1497,10 @@ int libqcow_internal_file_open_read(
 		goto on_error;
 	}
 
-	internal_file->encryption_method  = internal_file->file_header->encryption_method;
+	internal_file->encryption_method           = internal_file->file_header->encryption_method;
+	internal_file->media_size                  = internal_file->file_header->media_size;
+	internal_file->has_extended_level2_entries = 0;
+	internal_file->data_file_is_raw            = 0;
 
 	number_of_level1_table_references = internal_file->file_header->number_of_level1_table_references;
 
@@ -1295,8 +1549,29 @@ int libqcow_internal_file_open_read(
 
 			goto on_error;
 		}
-		number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+		/* An extended level 2 table entry consists of 16 bytes instead of 8 bytes
+		 */
+		if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTENDED_L2 ) != 0 )
+		{
+			if( internal_file->file_header->number_of_cluster_block_bits < LIBQCOW_MINIMUM_EXTENDED_L2_CLUSTER_BLOCK_BITS )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid number of cluster block bits value out of bounds for extended level 2 table entries.",
+				 function );
+
+				goto on_error;
+			}
+			internal_file->has_extended_level2_entries = 1;
 
+			number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 4;
+		}
+		else
+		{
+			number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+		}
 		internal_file->offset_bit_mask           = 0x3fffffffffffffffULL;
 		internal_file->compression_flag_bit_mask = (uint64_t) 1UL << 62;
 		internal_file->compression_bit_shift     = 62 - ( internal_file->file_header->number_of_cluster_block_bits - 8 );
@@ -1319,6 +1594,17 @@ int libqcow_internal_file_open_read(
 	internal_file->compression_bit_mask   = ~( (uint64_t) -1 << internal_file->compression_bit_shift );
 	internal_file->cluster_block_size     = (size64_t) 1 << internal_file->file_header->number_of_cluster_block_bits;
 
+	if( internal_file->has_extended_level2_entries != 0 )
+	{
+		internal_file->subcluster_block_size     = internal_file->cluster_block_size >> LIBQCOW_NUMBER_OF_SUBCLUSTER_BITS;
+		internal_file->subcluster_block_bit_mask = internal_file->cluster_block_bit_mask >> LIBQCOW_NUMBER_OF_SUBCLUSTER_BITS;
+	}
+	else
+	{
+		internal_file->subcluster_block_size     = internal_file->cluster_block_size;
+		internal_file->subcluster_block_bit_mask = internal_file->cluster_block_bit_mask;
+	}
+
 	level2_table_size = (size_t) 1 << number_of_level2_table_bits;
 
 	if( internal_file->file_header->format_version == 1 )
@@ -1396,7 +1682,17 @@ int libqcow_internal_file_open_read(
 		goto on_error;
 	}
 	level1_table_size *= 8;
-	level2_table_size *= 8;
+
+	if( internal_file->has_extended_level2_entries != 0 )
+	{
+		level2_table_size *= 16;
+	}
+	else
+	{
+		level2_table_size *= 8;
+	}
+
+	internal_file->level2_table_size = level2_table_size;
 
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
@@ -1441,8 +1737,77 @@ int libqcow_internal_file_open_read(
 			goto on_error;
 		}
 	}
+	if( ( internal_file->file_header->backing_format_offset > 0 )
+	 && ( internal_file->file_header->backing_format_size > 0 ) )
+	{
+		if( libqcow_internal_file_open_read_backing_format(
+		     internal_file,
+		     file_io_handle,
+		     internal_file->file_header->backing_format_offset,
+		     internal_file->file_header->backing_format_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read backing format.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	{
+		if( ( internal_file->file_header->data_filename_offset > 0 )
+		 && ( internal_file->file_header->data_filename_size > 0 ) )
+		{
+			if( libqcow_internal_file_open_read_data_filename(
+			     internal_file,
+			     file_io_handle,
+			     internal_file->file_header->data_filename_offset,
+			     internal_file->file_header->data_filename_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read external data filename.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		/* A raw external data file can be read without the level 1 and 2 tables,
+		 * unless the data is stored in a backing file or is encrypted
+		 */
+		if( ( ( internal_file->file_header->auto_clear_feature_flags & LIBQCOW_AUTO_CLEAR_FEATURE_FLAG_DATA_FILE_RAW ) != 0 )
+		 && ( internal_file->backing_filename == NULL )
+		 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+		{
+			internal_file->data_file_is_raw = 1;
+		}
+	}
 	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
 	{
+		if( libqcow_internal_file_open_read_encryption_key(
+		     internal_file,
+		     file_io_handle,
+		     encryption_key,
+		     LIBQCOW_LUKS_MAXIMUM_KEY_SIZE,
+		     &encryption_key_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine encryption key.",
+			 function );
+
+			goto on_error;
+		}
 		if( libqcow_encryption_initialize(
 		     &( internal_file->encryption_context ),
 		     internal_file->encryption_method,
@@ -1464,15 +1829,15 @@ int libqcow_internal_file_open_read(
 			 "%s: key:\n",
 			 function );
 			libcnotify_print_data(
-			 internal_file->key_data,
-			 16,
+			 encryption_key,
+			 encryption_key_size,
 			 0 );
 		}
 #endif
 		if( libqcow_encryption_set_keys(
 		     internal_file->encryption_context,
-		     internal_file->key_data,
-		     16,
+		     encryption_key,
+		     encryption_key_size,
 		     error ) != 1 )
 		{
 			libcerror_error_set(
@@ -1484,6 +1849,20 @@ int libqcow_internal_file_open_read(
 
 			goto on_error;
 		}
+		if( memory_set(
+		     encryption_key,
+		     0,
+		     LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear encryption key.",
+			 function );
+
+			goto on_error;
+		}
 	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
@@ -1521,48 +1900,89 @@ int libqcow_internal_file_open_read(
 
 		goto on_error;
 	}
-/* TODO clone function ? */
-	if( libfdata_vector_initialize(
-	     &( internal_file->level2_table_vector ),
-	     (size64_t) level2_table_size,
-	     (intptr_t *) internal_file->io_handle,
-	     NULL,
-	     NULL,
-	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_level2_table,
-	     NULL,
-	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	if( internal_file->file_header->number_of_snapshots > 0 )
+	{
+		if( libqcow_internal_file_open_read_snapshot_table(
+		     internal_file,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot table.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	/* The bitmaps are only consistent if the auto-clear bitmaps flag is set
+	 * and since writing clears the auto-clear feature flags the bitmaps are
+	 * only read if the file is opened for reading only
+	 */
+	if( ( internal_file->file_header->number_of_bitmaps > 0 )
+	 && ( ( internal_file->file_header->auto_clear_feature_flags & LIBQCOW_AUTO_CLEAR_FEATURE_FLAG_BITMAPS ) != 0 )
+	 && ( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) == 0 ) )
+	{
+		if( libqcow_internal_file_open_read_bitmap_directory(
+		     internal_file,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read bitmap directory.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_internal_file_determine_cache_entries(
+	     internal_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create level2 table vector.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to determine number of cache entries.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfdata_vector_append_segment(
-	     internal_file->level2_table_vector,
-	     &entry_index,
-	     0,
-	     0,
-	     internal_file->size,
-	     0,
+	/* The buffer pool keeps a limited number of evicted cluster block buffers for reuse
+	 */
+	maximum_number_of_free_buffers = LIBQCOW_BUFFER_POOL_MAXIMUM_FREE_SIZE / internal_file->cluster_block_size;
+
+	if( maximum_number_of_free_buffers == 0 )
+	{
+		maximum_number_of_free_buffers = 1;
+	}
+	else if( maximum_number_of_free_buffers > LIBQCOW_BUFFER_POOL_MAXIMUM_NUMBER_OF_FREE_BUFFERS )
+	{
+		maximum_number_of_free_buffers = LIBQCOW_BUFFER_POOL_MAXIMUM_NUMBER_OF_FREE_BUFFERS;
+	}
+	if( libqcow_buffer_pool_initialize(
+	     &( internal_file->buffer_pool ),
+	     (size_t) internal_file->cluster_block_size,
+	     (int) maximum_number_of_free_buffers,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
-		 "%s: unable to append segment to level2 table vector.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create buffer pool.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfcache_cache_initialize(
+	if( libqcow_block_cache_initialize(
 	     &( internal_file->level2_table_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES,
+	     internal_file->number_of_level2_table_cache_entries,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
@@ -1574,69 +1994,73 @@ int libqcow_internal_file_open_read(
 
 		goto on_error;
 	}
-/* TODO clone function ? */
-	if( libfdata_vector_initialize(
-	     &( internal_file->cluster_block_vector ),
-	     internal_file->cluster_block_size,
-	     (intptr_t *) internal_file->io_handle,
-	     NULL,
-	     NULL,
-	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_cluster_block,
-	     NULL,
-	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	if( libqcow_block_cache_initialize(
+	     &( internal_file->cluster_block_cache ),
+	     internal_file->number_of_cluster_block_cache_entries,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create cluster block vector.",
+		 "%s: unable to create cluster block cache.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfdata_vector_append_segment(
-	     internal_file->cluster_block_vector,
-	     &entry_index,
-	     0,
-	     0,
-	     internal_file->size,
-	     0,
+	if( libqcow_block_cache_initialize(
+	     &( internal_file->compressed_cluster_block_cache ),
+	     internal_file->number_of_compressed_cluster_block_cache_entries,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
-		 "%s: unable to append segment to cluster block vector.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create compressed cluster block cache.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfcache_cache_initialize(
-	     &( internal_file->cluster_block_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+	if( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
+	{
+		if( libqcow_internal_file_open_write(
+		     internal_file,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open file for writing.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_internal_file_start_readahead(
+	     internal_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create cluster block cache.",
+		 "%s: unable to start readahead.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfcache_cache_initialize(
-	     &( internal_file->compressed_cluster_block_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+	if( libqcow_internal_file_start_decompression_pool(
+	     internal_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create compressed cluster block cache.",
+		 "%s: unable to start decompression pool.",
 		 function );
 
 		goto on_error;
@@ -1646,30 +2070,57 @@ int libqcow_internal_file_open_read(
 	return( 1 );
 
 on_error:
+	memory_set(
+	 encryption_key,
+	 0,
+	 LIBQCOW_LUKS_MAXIMUM_KEY_SIZE );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->decompression_pool != NULL )
+	{
+		libqcow_decompression_pool_free(
+		 &( internal_file->decompression_pool ),
+		 NULL );
+	}
+#endif
 	if( internal_file->cluster_block_cache != NULL )
 	{
-		libfcache_cache_free(
+		libqcow_block_cache_free(
 		 &( internal_file->cluster_block_cache ),
 		 NULL );
 	}
-	if( internal_file->cluster_block_vector != NULL )
+	if( internal_file->compressed_cluster_block_cache != NULL )
 	{
-		libfdata_vector_free(
-		 &( internal_file->cluster_block_vector ),
+		libqcow_block_cache_free(
+		 &( internal_file->compressed_cluster_block_cache ),
 		 NULL );
 	}
-	if( internal_file->level2_table_cache != NULL )
+	if( internal_file->buffer_pool != NULL )
 	{
-		libfcache_cache_free(
-		 &( internal_file->level2_table_cache ),
+		libqcow_buffer_pool_free(
+		 &( internal_file->buffer_pool ),
 		 NULL );
 	}
-	if( internal_file->level2_table_vector != NULL )
+	libqcow_cache_budget_release(
+	 internal_file->reserved_cache_size,
+	 NULL );
+
+	internal_file->reserved_cache_size = 0;
+
+	if( internal_file->level2_table_cache != NULL )
 	{
-		libfdata_vector_free(
-		 &( internal_file->level2_table_vector ),
+		libqcow_block_cache_free(
+		 &( internal_file->level2_table_cache ),
 		 NULL );
 	}
+	libqcow_internal_file_free_bitmaps(
+	 internal_file,
+	 NULL );
+
+	libqcow_internal_file_free_snapshots(
+	 internal_file,
+	 NULL );
+
 	if( internal_file->level1_table != NULL )
 	{
 		libqcow_cluster_table_free(
@@ -1691,6 +2142,24 @@ on_error:
 	}
 	internal_file->backing_filename_size = 0;
 
+	if( internal_file->backing_format != NULL )
+	{
+		memory_free(
+		 internal_file->backing_format );
+
+		internal_file->backing_format = NULL;
+	}
+	internal_file->backing_format_size = 0;
+
+	if( internal_file->data_filename != NULL )
+	{
+		memory_free(
+		 internal_file->data_filename );
+
+		internal_file->data_filename = NULL;
+	}
+	internal_file->data_filename_size = 0;
+
 	if( internal_file->file_header != NULL )
 	{
 		libqcow_file_header_free(
@@ -1700,18 +2169,26 @@ on_error:
 	return( -1 );
 }
 
-/* Reads the backing filename
+/* Opens direct access to the file, which reads the file using its own file descriptor
+ * The file is memory-mapped when requested, otherwise read using io_uring when the IO queue depth
+ * is larger than 1. Direct access is optional, when it cannot be opened reads fall back to the file IO handle
  * Returns 1 if successful or -1 on error
  */
-int libqcow_internal_file_open_read_backing_filename(
+int libqcow_internal_file_open_direct_access(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
-     off64_t backing_filename_offset,
-     uint32_t backing_filename_size,
+     int access_flags,
      libcerror_error_t **error )
 {
-	static char *function = "libqcow_internal_file_open_read_backing_filename";
-	ssize_t read_count    = 0;
+	static char *function                       = "libqcow_internal_file_open_direct_access";
+
+#if defined( HAVE_LIBQCOW_MAPPED_FILE ) || defined( HAVE_LIBQCOW_IO_URING )
+	libcerror_error_t *direct_access_error      = NULL;
+	char *filename                              = NULL;
+	size_t filename_size                        = 0;
+	uint8_t use_io_uring                        = 0;
+	uint8_t use_mapped_file                     = 0;
+#endif
 
 	if( internal_file == NULL )
 	{
@@ -1724,114 +2201,192 @@ int libqcow_internal_file_open_read_backing_filename(
 
 		return( -1 );
 	}
-	if( internal_file->backing_filename != NULL )
+	if( file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - backing filename value already set.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( ( backing_filename_size == 0 )
-	 || ( backing_filename_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+#if defined( HAVE_LIBQCOW_MAPPED_FILE ) || defined( HAVE_LIBQCOW_IO_URING )
+	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
+	{
+		return( 1 );
+	}
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	if( ( internal_file->use_memory_map != 0 )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+	{
+		use_mapped_file = 1;
+	}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING )
+	if( internal_file->io_queue_depth > 1 )
+	{
+		use_io_uring = 1;
+	}
+#endif
+	if( ( use_mapped_file == 0 )
+	 && ( use_io_uring == 0 ) )
+	{
+		return( 1 );
+	}
+	/* The file IO handle provides the narrow filename, also when the file was opened by wide filename
+	 */
+	if( libbfio_file_get_name_size(
+	     file_io_handle,
+	     &filename_size,
+	     &direct_access_error ) != 1 )
 	{
 		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid backing filename size value out of bounds.",
+		 &direct_access_error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve filename size.",
 		 function );
 
-		goto on_error;
+		goto on_unavailable;
 	}
-	internal_file->backing_filename = (uint8_t *) memory_allocate(
-	                                               sizeof( uint8_t ) * backing_filename_size );
+	if( ( filename_size == 0 )
+	 || ( filename_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 &direct_access_error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid filename size value out of bounds.",
+		 function );
 
-	if( internal_file->backing_filename == NULL )
+		goto on_unavailable;
+	}
+	filename = narrow_string_allocate(
+	            filename_size );
+
+	if( filename == NULL )
 	{
 		libcerror_error_set(
-		 error,
+		 &direct_access_error,
 		 LIBCERROR_ERROR_DOMAIN_MEMORY,
 		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-		 "%s: unable to create backing filename.",
+		 "%s: unable to create filename.",
 		 function );
 
-		goto on_error;
+		goto on_unavailable;
 	}
-	internal_file->backing_filename_size = (size_t) backing_filename_size;
-
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+	if( libbfio_file_get_name(
+	     file_io_handle,
+	     filename,
+	     filename_size,
+	     &direct_access_error ) != 1 )
 	{
-		libcnotify_printf(
-		 "%s: reading backing filename at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
-		 function,
-		 backing_filename_offset,
-		 backing_filename_offset );
+		libcerror_error_set(
+		 &direct_access_error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve filename.",
+		 function );
+
+		goto on_unavailable;
 	}
-#endif
-	read_count = libbfio_handle_read_buffer_at_offset(
-		      file_io_handle,
-		      internal_file->backing_filename,
-		      (size_t) backing_filename_size,
-		      backing_filename_offset,
-		      error );
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	/* The mapped file maps the file using its own file descriptor
+	 */
+	if( use_mapped_file != 0 )
+	{
+		if( libqcow_mapped_file_initialize(
+		     &( internal_file->mapped_file ),
+		     filename,
+		     &direct_access_error ) == -1 )
+		{
+			libcerror_error_set(
+			 &direct_access_error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create mapped file.",
+			 function );
 
-	if( read_count != (ssize_t) backing_filename_size )
+			goto on_unavailable;
+		}
+		if( internal_file->mapped_file != NULL )
+		{
+			use_io_uring = 0;
+		}
+	}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING )
+	/* The io_uring reads the file using its own file descriptor
+	 */
+	if( use_io_uring != 0 )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read backing filename data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
-		 function,
-		 backing_filename_offset,
-		 backing_filename_offset );
+		if( libqcow_io_uring_initialize(
+		     &( internal_file->io_uring ),
+		     filename,
+		     internal_file->io_queue_depth,
+		     &direct_access_error ) == -1 )
+		{
+			libcerror_error_set(
+			 &direct_access_error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create io_uring.",
+			 function );
 
-		goto on_error;
+			goto on_unavailable;
+		}
 	}
+#endif
+	memory_free(
+	 filename );
+
+	return( 1 );
+
+on_unavailable:
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
-		libcnotify_printf(
-		 "%s: backing filename data:\n",
-		 function );
-		libcnotify_print_data(
-		 internal_file->backing_filename,
-		 (size_t) backing_filename_size,
-		 0 );
+		libcnotify_print_error_backtrace(
+		 direct_access_error );
 	}
 #endif
-	return( 1 );
+	libcerror_error_free(
+	 &direct_access_error );
 
-on_error:
-	if( internal_file->backing_filename != NULL )
+	if( filename != NULL )
 	{
 		memory_free(
-		 internal_file->backing_filename );
-
-		internal_file->backing_filename = NULL;
+		 filename );
 	}
-	internal_file->backing_filename_size = 0;
+	return( 1 );
+#else
+	LIBQCOW_UNREFERENCED_PARAMETER( access_flags )
 
-	return( -1 );
+	return( 1 );
+
+#endif /* defined( HAVE_LIBQCOW_MAPPED_FILE ) || defined( HAVE_LIBQCOW_IO_URING ) */
 }
 
-/* Determines if the file is locked
- * Returns 1 if locked, 0 if not or -1 on error
+/* Determines the number of cache entries from the cache budget
+ * The cache budget is divided between the level2 table cache (1/4), the cluster block cache (1/2)
+ * and the compressed cluster block cache (1/4) and is limited by the process wide cache budget
+ * Any cache size previously reserved by the file is released first
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_is_locked(
-     libqcow_file_t *file,
+int libqcow_internal_file_determine_cache_entries(
+     libqcow_internal_file_t *internal_file,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_is_locked";
-	uint8_t is_locked                      = 0;
+	static char *function      = "libqcow_internal_file_determine_cache_entries";
+	size64_t cache_size        = 0;
+	size64_t default_size      = 0;
+	size64_t minimum_size      = 0;
+	size64_t number_of_entries = 0;
+	int result                 = 0;
 
-	if( file == NULL )
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -1842,63 +2397,165 @@ int libqcow_file_is_locked(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	if( ( internal_file->cluster_block_size == 0 )
+	 || ( internal_file->cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
+		return( -1 );
+	}
+	if( ( internal_file->level2_table_size == 0 )
+	 || ( internal_file->level2_table_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - level2 table size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cache_budget_release(
+	     internal_file->reserved_cache_size,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to release reserved cache size.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	is_locked = internal_file->is_locked;
+	internal_file->reserved_cache_size = 0;
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	default_size = ( LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES * (size64_t) internal_file->level2_table_size )
+	             + ( 2 * LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS * internal_file->cluster_block_size );
+
+	minimum_size = (size64_t) internal_file->level2_table_size + ( 2 * internal_file->cluster_block_size );
+
+	if( internal_file->cache_budget != 0 )
+	{
+		cache_size = internal_file->cache_budget;
+	}
+	else
+	{
+		cache_size = default_size;
+	}
+	result = libqcow_cache_budget_reserve(
+	          cache_size,
+	          minimum_size,
+	          &cache_size,
+	          error );
+
+	if( result == -1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to reserve cache size.",
 		 function );
 
 		return( -1 );
 	}
+	else if( result != 0 )
+	{
+		internal_file->reserved_cache_size = cache_size;
+	}
+	if( cache_size == default_size )
+	{
+		internal_file->number_of_level2_table_cache_entries             = LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES;
+		internal_file->number_of_cluster_block_cache_entries            = LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
+		internal_file->number_of_compressed_cluster_block_cache_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
+	}
+	else
+	{
+		number_of_entries = ( cache_size / 4 ) / internal_file->level2_table_size;
+
+		if( number_of_entries == 0 )
+		{
+			number_of_entries = 1;
+		}
+		else if( number_of_entries > LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET )
+		{
+			number_of_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET;
+		}
+		internal_file->number_of_level2_table_cache_entries = (int) number_of_entries;
+
+		number_of_entries = ( cache_size / 2 ) / internal_file->cluster_block_size;
+
+		if( number_of_entries == 0 )
+		{
+			number_of_entries = 1;
+		}
+		else if( number_of_entries > LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET )
+		{
+			number_of_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET;
+		}
+		internal_file->number_of_cluster_block_cache_entries = (int) number_of_entries;
+
+		number_of_entries = ( cache_size / 4 ) / internal_file->cluster_block_size;
+
+		if( number_of_entries == 0 )
+		{
+			number_of_entries = 1;
+		}
+		else if( number_of_entries > LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET )
+		{
+			number_of_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_BUDGET;
+		}
+		internal_file->number_of_compressed_cluster_block_cache_entries = (int) number_of_entries;
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: cache size\t\t\t\t: %" PRIu64 "\n",
+		 function,
+		 cache_size );
+
+		libcnotify_printf(
+		 "%s: number of level2 table cache entries\t: %d\n",
+		 function,
+		 internal_file->number_of_level2_table_cache_entries );
+
+		libcnotify_printf(
+		 "%s: number of cluster block cache entries\t: %d\n",
+		 function,
+		 internal_file->number_of_cluster_block_cache_entries );
+
+		libcnotify_printf(
+		 "%s: number of compressed cluster block cache entries\t: %d\n",
+		 function,
+		 internal_file->number_of_compressed_cluster_block_cache_entries );
+
+		libcnotify_printf(
+		 "\n" );
+	}
 #endif
-	return( is_locked );
+	return( 1 );
 }
 
-/* Retrieves the cluster block offset for a specific offset
+/* Reads the backing filename
  * Returns 1 if successful or -1 on error
  */
-int libqcow_internal_file_get_cluster_block_offset(
+int libqcow_internal_file_open_read_backing_filename(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
-     off64_t offset,
-     uint64_t *cluster_block_offset,
-     uint64_t *cluster_block_data_offset,
-     uint8_t *cluster_block_is_compressed,
+     off64_t backing_filename_offset,
+     uint32_t backing_filename_size,
      libcerror_error_t **error )
 {
-	libqcow_cluster_table_t *level2_table = NULL;
-	static char *function                 = "libqcow_internal_file_get_cluster_block_offset";
-	off64_t element_data_offset           = 0;
-	uint64_t level1_table_index           = 0;
-	uint64_t level2_table_index           = 0;
-	uint64_t level2_table_offset          = 0;
-	uint64_t safe_cluster_block_offset    = 0;
-	uint8_t is_compressed                 = 0;
+	static char *function = "libqcow_internal_file_open_read_backing_filename";
+	ssize_t read_count    = 0;
 
 	if( internal_file == NULL )
 	{
@@ -1911,250 +2568,234 @@ int libqcow_internal_file_get_cluster_block_offset(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
-		 function );
-
-		return( -1 );
-	}
-	if( offset < 0 )
+	if( internal_file->backing_filename != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid offset value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - backing filename value already set.",
 		 function );
 
 		return( -1 );
 	}
-	if( cluster_block_offset == NULL )
+	if( ( backing_filename_size == 0 )
+	 || ( backing_filename_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block offset.",
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid backing filename size value out of bounds.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( cluster_block_data_offset == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block data offset.",
-		 function );
+	internal_file->backing_filename = (uint8_t *) memory_allocate(
+	                                               sizeof( uint8_t ) * backing_filename_size );
 
-		return( -1 );
-	}
-	if( cluster_block_is_compressed == NULL )
+	if( internal_file->backing_filename == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block is compressed.",
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create backing filename.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	level1_table_index = offset >> internal_file->level1_index_bit_shift;
+	internal_file->backing_filename_size = (size_t) backing_filename_size;
 
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
 		libcnotify_printf(
-		 "%s: level 1 table index\t: %" PRIu64 "\n",
+		 "%s: reading backing filename at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
 		 function,
-		 level1_table_index );
+		 backing_filename_offset,
+		 backing_filename_offset );
 	}
 #endif
-	if( level1_table_index > (uint64_t) INT_MAX )
+	read_count = libbfio_handle_read_buffer_at_offset(
+		      file_io_handle,
+		      internal_file->backing_filename,
+		      (size_t) backing_filename_size,
+		      backing_filename_offset,
+		      error );
+
+	if( read_count != (ssize_t) backing_filename_size )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid level 1 table index value out of bounds.",
-		 function );
-
-		return( -1 );
-	}
-	if( libqcow_cluster_table_get_reference_by_index(
-	     internal_file->level1_table,
-	     (int) level1_table_index,
-	     &level2_table_offset,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read backing filename data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
 		 function,
-		 level1_table_index );
+		 backing_filename_offset,
+		 backing_filename_offset );
 
-		return( -1 );
+		goto on_error;
 	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
 		libcnotify_printf(
-		 "%s: level 2 table offset\t: 0x%08" PRIx64 "\n",
-		 function,
-		 level2_table_offset );
-
-		libcnotify_printf(
-		 "\n" );
+		 "%s: backing filename data:\n",
+		 function );
+		libcnotify_print_data(
+		 internal_file->backing_filename,
+		 (size_t) backing_filename_size,
+		 0 );
 	}
 #endif
-	level2_table_offset &= internal_file->offset_bit_mask;
+	return( 1 );
 
-	/* If level2_table_offset is 0 the level 2 table is sparse
-	 */
-	if( level2_table_offset > 0 )
-	{
-		if( libfdata_vector_get_element_value_at_offset(
-		     internal_file->level2_table_vector,
-		     (intptr_t *) file_io_handle,
-		     (libfdata_cache_t *) internal_file->level2_table_cache,
-		     (off64_t) level2_table_offset,
-		     &element_data_offset,
-		     (intptr_t **) &level2_table,
-		     0,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
-			 function,
-			 level2_table_offset );
+on_error:
+	if( internal_file->backing_filename != NULL )
+	{
+		memory_free(
+		 internal_file->backing_filename );
 
-			return( -1 );
-		}
-		level2_table_index = ( internal_file->current_offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+		internal_file->backing_filename = NULL;
+	}
+	internal_file->backing_filename_size = 0;
 
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: level 2 table index\t: %" PRIu64 "\n",
-			 function,
-			 level2_table_index );
-		}
-#endif
-		if( level2_table_index > (uint64_t) INT_MAX )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid level 2 table index value out of bounds.",
-			 function );
+	return( -1 );
+}
 
-			return( -1 );
-		}
-		if( libqcow_cluster_table_get_reference_by_index(
-		     level2_table,
-		     (int) level2_table_index,
-		     &safe_cluster_block_offset,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve level 2 table entry: %" PRIu64 ".",
-			 function,
-			 level2_table_index );
+/* Reads the backing format
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_backing_format(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t backing_format_offset,
+     uint32_t backing_format_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_open_read_backing_format";
+	ssize_t read_count    = 0;
 
-			return( -1 );
-		}
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_format != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - backing format value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( backing_format_size == 0 )
+	 || ( backing_format_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid backing format size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->backing_format = (uint8_t *) memory_allocate(
+	                                             sizeof( uint8_t ) * backing_format_size );
+
+	if( internal_file->backing_format == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create backing format.",
+		 function );
+
+		goto on_error;
 	}
+	internal_file->backing_format_size = (size_t) backing_format_size;
+
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
 		libcnotify_printf(
-		 "%s: table2 entry: %" PRIu64 "\t\t: 0x%08" PRIx64 "\n",
-		 function,
-		 level2_table_index,
-		 safe_cluster_block_offset );
-
-		libcnotify_printf(
-		 "%s: cluster block offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 "%s: reading backing format at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
 		 function,
-		 safe_cluster_block_offset & internal_file->offset_bit_mask,
-		 safe_cluster_block_offset & internal_file->offset_bit_mask );
+		 backing_format_offset,
+		 backing_format_offset );
 	}
 #endif
-	if( ( safe_cluster_block_offset & internal_file->compression_flag_bit_mask ) != 0 )
+	read_count = libbfio_handle_read_buffer_at_offset(
+		      file_io_handle,
+		      internal_file->backing_format,
+		      (size_t) backing_format_size,
+		      backing_format_offset,
+		      error );
+
+	if( read_count != (ssize_t) backing_format_size )
 	{
-		if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-			 "%s: simultaneous encryption and compression not supported.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read backing format data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 backing_format_offset,
+		 backing_format_offset );
 
-			return( -1 );
-		}
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: is compressed\n",
-			 function );
-		}
-#endif
-		is_compressed = 1;
+		goto on_error;
 	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
 		libcnotify_printf(
-		 "\n" );
+		 "%s: backing format data:\n",
+		 function );
+		libcnotify_print_data(
+		 internal_file->backing_format,
+		 (size_t) backing_format_size,
+		 0 );
 	}
 #endif
-	*cluster_block_offset        = safe_cluster_block_offset & internal_file->offset_bit_mask;
-	*cluster_block_data_offset   = offset & internal_file->cluster_block_bit_mask;
-	*cluster_block_is_compressed = is_compressed;
-
 	return( 1 );
+
+on_error:
+	if( internal_file->backing_format != NULL )
+	{
+		memory_free(
+		 internal_file->backing_format );
+
+		internal_file->backing_format = NULL;
+	}
+	internal_file->backing_format_size = 0;
+
+	return( -1 );
 }
 
-/* Reads a cluster block
+/* Reads the external data filename
  * Returns 1 if successful or -1 on error
  */
-int libqcow_internal_file_read_cluster_block(
+int libqcow_internal_file_open_read_data_filename(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
-     uint64_t cluster_block_offset,
-     uint64_t cluster_block_data_offset,
-     uint8_t cluster_block_is_compressed,
-     libqcow_cluster_block_t **cluster_block,
+     off64_t data_filename_offset,
+     uint32_t data_filename_size,
      libcerror_error_t **error )
 {
-	libfcache_cache_t *cluster_block_cache       = NULL;
-	libqcow_cluster_block_t *safe_cluster_block  = NULL;
-	static char *function                        = "libqcow_internal_file_read_cluster_block";
-	size_t cluster_block_size                    = 0;
-	size_t safe_cluster_block_data_size          = 0;
-	off64_t element_data_offset                  = 0;
-	uint64_t block_key                           = 0;
-	uint64_t compressed_cluster_block_end_offset = 0;
-	int cache_entry_index                        = 0;
+	static char *function = "libqcow_internal_file_open_read_data_filename";
+	ssize_t read_count    = 0;
 
 	if( internal_file == NULL )
 	{
@@ -2167,345 +2808,12187 @@ int libqcow_internal_file_read_cluster_block(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	if( internal_file->data_filename != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - data filename value already set.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_size == 0 )
+	if( ( data_filename_size == 0 )
+	 || ( data_filename_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - cluster block size value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data filename size value out of bounds.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( cluster_block == NULL )
+	internal_file->data_filename = (uint8_t *) memory_allocate(
+	                                            sizeof( uint8_t ) * data_filename_size );
+
+	if( internal_file->data_filename == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block.",
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data filename.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( cluster_block_is_compressed != 0 )
-	{
-		/* Handle compressed cluster block
-		 */
-		cluster_block_size    = (size_t) ( cluster_block_offset >> internal_file->compression_bit_shift );
-		cluster_block_offset &= internal_file->compression_bit_mask;
-
-		if( ( internal_file->file_header->format_version == 2 )
-		 || ( internal_file->file_header->format_version == 3 ) )
-		{
-			cluster_block_size += 1;
-			cluster_block_size *= 512;
+	internal_file->data_filename_size = (size_t) data_filename_size;
 
-			/* Make sure the compressed block size stays within the bounds
-			 * of the cluster block size and the size of the file
-			 */
-			compressed_cluster_block_end_offset = cluster_block_offset / internal_file->cluster_block_size;
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading data filename at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 data_filename_offset,
+		 data_filename_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+		      file_io_handle,
+		      internal_file->data_filename,
+		      (size_t) data_filename_size,
+		      data_filename_offset,
+		      error );
 
-			if( ( cluster_block_offset % internal_file->cluster_block_size ) != 0 )
-			{
-				compressed_cluster_block_end_offset += 1;
-			}
-			compressed_cluster_block_end_offset += 1;
-			compressed_cluster_block_end_offset *= internal_file->cluster_block_size;
+	if( read_count != (ssize_t) data_filename_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read data filename data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 data_filename_offset,
+		 data_filename_offset );
 
-			if( compressed_cluster_block_end_offset > internal_file->size )
-			{
-				compressed_cluster_block_end_offset = internal_file->size;
-			}
-			if( ( cluster_block_offset + cluster_block_size ) > compressed_cluster_block_end_offset )
-			{
-				cluster_block_size = (size_t) ( compressed_cluster_block_end_offset - cluster_block_offset );
-			}
-		}
+		goto on_error;
+	}
 #if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: compressed cluster block offset\t\t: 0x%08" PRIx64 "\n",
-			 function,
-			 cluster_block_offset );
-
-			libcnotify_printf(
-			 "%s: compressed cluster block size\t\t: %" PRIzd "\n",
-			 function,
-			 cluster_block_size );
-		}
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: data filename data:\n",
+		 function );
+		libcnotify_print_data(
+		 internal_file->data_filename,
+		 (size_t) data_filename_size,
+		 0 );
+	}
 #endif
-		cluster_block_cache = internal_file->compressed_cluster_block_cache;
+	return( 1 );
+
+on_error:
+	if( internal_file->data_filename != NULL )
+	{
+		memory_free(
+		 internal_file->data_filename );
+
+		internal_file->data_filename = NULL;
 	}
-	else
+	internal_file->data_filename_size = 0;
+
+	return( -1 );
+}
+
+/* Determines the encryption key
+ * For the AES-CBC encryption method the key is either the key data or the first 16 bytes
+ * of the password padded with zero bytes
+ * For the LUKS encryption method the key is the master key that is either the key data
+ * or is unlocked from one of the key slots with the password
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_encryption_key(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint8_t *key,
+     size_t key_size,
+     size_t *encryption_key_size,
+     libcerror_error_t **error )
+{
+	libqcow_luks_header_t *luks_header = NULL;
+	static char *function              = "libqcow_internal_file_open_read_encryption_key";
+	size_t password_size               = 0;
+	int result                         = 0;
+
+	if( internal_file == NULL )
 	{
-		/* For version 2 and 3 make sure the sure the last cluster block size
-		 * stays within the bounds of the size of the file
-		 */
-		if( ( ( internal_file->file_header->format_version == 2 )
-		  ||  ( internal_file->file_header->format_version == 3 ) )
-		 && ( ( cluster_block_offset + internal_file->cluster_block_size ) > internal_file->size ) )
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	if( key_size < LIBQCOW_LUKS_MAXIMUM_KEY_SIZE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_TOO_SMALL,
+		 "%s: invalid key size value too small.",
+		 function );
+
+		return( -1 );
+	}
+	if( encryption_key_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid encryption key size.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     key,
+	     0,
+	     key_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear key.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->password != NULL )
+	{
+		password_size = internal_file->password_size - 1;
+	}
+	if( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC )
+	{
+		if( internal_file->password != NULL )
 		{
-			cluster_block_size = (size_t) ( internal_file->size - cluster_block_offset );
+			if( password_size > 16 )
+			{
+				password_size = 16;
+			}
+			if( memory_copy(
+			     key,
+			     internal_file->password,
+			     password_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy password.",
+				 function );
 
-#if defined( HAVE_DEBUG_OUTPUT )
-			if( libcnotify_verbose != 0 )
+				goto on_error;
+			}
+		}
+		else if( internal_file->key_data_is_set != 0 )
+		{
+			if( internal_file->key_data_size != 16 )
 			{
-				libcnotify_printf(
-				 "%s: last cluster block offset\t\t: 0x%08" PRIx64 "\n",
-				 function,
-				 cluster_block_offset );
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+				 "%s: unsupported key data size.",
+				 function );
 
-				libcnotify_printf(
-				 "%s: last cluster block size\t\t\t: %" PRIzd "\n",
-				 function,
-				 cluster_block_size );
+				goto on_error;
+			}
+			if( memory_copy(
+			     key,
+			     internal_file->key_data,
+			     16 ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy key data.",
+				 function );
+
+				goto on_error;
 			}
-#endif
 		}
-		cluster_block_cache = internal_file->cluster_block_cache;
+		*encryption_key_size = 16;
+
+		return( 1 );
 	}
-	if( cluster_block_size != 0 )
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_LUKS )
 	{
-/* TODO check cache  */
-		if( libqcow_cluster_block_initialize(
-		     &safe_cluster_block,
-		     cluster_block_size,
-		     error ) != 1 )
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported encryption method.",
+		 function );
+
+		goto on_error;
+	}
+	if( internal_file->file_header->encryption_header_offset == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing full disk encryption header extension.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_luks_header_initialize(
+	     &luks_header,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create LUKS header.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_luks_header_read_file_io_handle(
+	     luks_header,
+	     file_io_handle,
+	     internal_file->file_header->encryption_header_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read LUKS header.",
+		 function );
+
+		goto on_error;
+	}
+	if( internal_file->password != NULL )
+	{
+		result = libqcow_luks_header_get_master_key_with_password(
+		          luks_header,
+		          file_io_handle,
+		          internal_file->file_header->encryption_header_offset,
+		          internal_file->password,
+		          password_size,
+		          key,
+		          (size_t) luks_header->master_key_size,
+		          error );
+
+		if( result == -1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-			 "%s: unable to create cluster block.",
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve master key with password.",
 			 function );
 
 			goto on_error;
 		}
-		if( libqcow_cluster_block_read(
-		     safe_cluster_block,
-		     file_io_handle,
-		     cluster_block_offset,
-		     error ) != 1 )
+		else if( result == 0 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_READ_FAILED,
-			 "%s: unable to read cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 cluster_block_offset,
-			 cluster_block_offset );
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to unlock master key - invalid password.",
+			 function );
 
 			goto on_error;
 		}
 	}
-	else
+	else if( internal_file->key_data_is_set != 0 )
 	{
-		if( libfdata_vector_get_element_value_at_offset(
-		     internal_file->cluster_block_vector,
-		     (intptr_t *) file_io_handle,
-		     (libfdata_cache_t *) cluster_block_cache,
-		     (off64_t) cluster_block_offset,
-		     &element_data_offset,
-		     (intptr_t **) cluster_block,
-		     0,
-		     error ) != 1 )
+		if( internal_file->key_data_size != (size_t) luks_header->master_key_size )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 cluster_block_offset,
-			 cluster_block_offset );
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported key data size.",
+			 function );
 
 			goto on_error;
 		}
-	}
-	if( cluster_block_is_compressed != 0 )
-	{
-		safe_cluster_block->compressed_data = safe_cluster_block->data;
-
-		safe_cluster_block->data = (uint8_t *) memory_allocate(
-		                                        sizeof( uint8_t ) * internal_file->cluster_block_size );
+		result = libqcow_luks_header_verify_master_key(
+		          luks_header,
+		          internal_file->key_data,
+		          internal_file->key_data_size,
+		          error );
 
-		if( safe_cluster_block->data == NULL )
+		if( result == -1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_MEMORY,
-			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-			 "%s: unable to create cluster block data.",
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to verify master key.",
 			 function );
 
 			goto on_error;
 		}
-		safe_cluster_block->data_size = internal_file->cluster_block_size;
-
-		safe_cluster_block_data_size = safe_cluster_block->data_size;
-
-		if( libqcow_decompress_data(
-		     safe_cluster_block->compressed_data,
-		     cluster_block_size,
-		     LIBQCOW_COMPRESSION_METHOD_DEFLATE,
-		     safe_cluster_block->data,
-		     &safe_cluster_block_data_size,
-		     error ) != 1 )
+		else if( result == 0 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
-			 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
-			 "%s: unable to decompress cluster block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 cluster_block_offset,
-			 cluster_block_offset );
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: invalid master key.",
+			 function );
 
 			goto on_error;
 		}
-/* TODO check safe_cluster_block_data_size
-		if( safe_cluster_block_data_size != safe_cluster_block->data_size )
+		if( memory_copy(
+		     key,
+		     internal_file->key_data,
+		     internal_file->key_data_size ) == NULL )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid cluster block size value out of bounds.",
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy key data.",
 			 function );
 
 			goto on_error;
 		}
-*/
 	}
-	if( safe_cluster_block != NULL )
+	else
 	{
-		cache_entry_index = ( cluster_block_offset & internal_file->cluster_block_bit_mask ) % LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
-
-		if( libfcache_cache_set_value_by_index(
-		     cluster_block_cache,
-		     cache_entry_index,
-		     0,
-		     cluster_block_offset,
-		     0,
-		     (intptr_t *) safe_cluster_block,
-		     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
-		     LIBFCACHE_CACHE_VALUE_FLAG_MANAGED,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-			 "%s: unable to set value in cache entry: %d.",
-			 function,
-			 cache_entry_index );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing password or master key.",
+		 function );
 
-			goto on_error;
-		}
-		*cluster_block = safe_cluster_block;
+		goto on_error;
 	}
-	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	*encryption_key_size = (size_t) luks_header->master_key_size;
+
+	if( libqcow_luks_header_free(
+	     &luks_header,
+	     error ) != 1 )
 	{
-		if( *cluster_block == NULL )
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free LUKS header.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	memory_set(
+	 key,
+	 0,
+	 key_size );
+
+	return( -1 );
+}
+
+/* Reads the snapshot table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	static char *function                      = "libqcow_internal_file_open_read_snapshot_table";
+	size_t entry_size                          = 0;
+	off64_t file_offset                        = 0;
+	int snapshot_index                         = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->snapshot_values != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - snapshot values already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->number_of_snapshots == 0 )
+	 || ( internal_file->file_header->number_of_snapshots > (uint32_t) LIBQCOW_MAXIMUM_NUMBER_OF_SNAPSHOTS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - number of snapshots value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->snapshots_offset <= 0 )
+	 || ( ( (uint64_t) internal_file->file_header->snapshots_offset & internal_file->cluster_block_bit_mask ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - snapshots offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file->snapshot_values = (libqcow_snapshot_values_t **) memory_allocate(
+	                                                                 sizeof( libqcow_snapshot_values_t * ) * internal_file->file_header->number_of_snapshots );
+
+	if( internal_file->snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create snapshot values array.",
+		 function );
+
+		goto on_error;
+	}
+	file_offset = internal_file->file_header->snapshots_offset;
+
+	for( snapshot_index = 0;
+	     snapshot_index < (int) internal_file->file_header->number_of_snapshots;
+	     snapshot_index++ )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "Reading snapshot: %d:\n",
+			 snapshot_index );
+		}
+#endif
+		if( libqcow_snapshot_values_initialize(
+		     &snapshot_values,
+		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: missing cluster block.",
-			 function );
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create snapshot: %d values.",
+			 function,
+			 snapshot_index );
 
 			goto on_error;
 		}
-		if( ( *cluster_block )->encrypted_data == NULL )
+		if( libqcow_snapshot_values_read_file_io_handle(
+		     snapshot_values,
+		     file_io_handle,
+		     file_offset,
+		     &entry_size,
+		     error ) != 1 )
 		{
-			( *cluster_block )->encrypted_data = ( *cluster_block )->data;
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot: %d values at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 snapshot_index,
+			 file_offset,
+			 file_offset );
 
-			( *cluster_block )->data = (uint8_t *) memory_allocate(
-			                                        sizeof( uint8_t ) * ( *cluster_block )->data_size );
+			goto on_error;
+		}
+		if( ( (uint64_t) snapshot_values->level1_table_offset & internal_file->cluster_block_bit_mask ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid snapshot: %d level 1 table offset value out of bounds.",
+			 function,
+			 snapshot_index );
 
-			if( ( *cluster_block )->data == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-				 "%s: unable to create cluster block data.",
-				 function );
+			goto on_error;
+		}
+		if( ( snapshot_values->number_of_level1_table_references == 0 )
+		 || ( (size_t) snapshot_values->number_of_level1_table_references > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 8 ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid snapshot: %d number of level 1 table references value out of bounds.",
+			 function,
+			 snapshot_index );
 
-				goto on_error;
-			}
-			block_key = (uint64_t) ( internal_file->current_offset - cluster_block_data_offset ) / 512;
-
-			if( libqcow_encryption_crypt(
-			     internal_file->encryption_context,
-			     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
-			     ( *cluster_block )->encrypted_data,
-			     ( *cluster_block )->data_size,
-			     ( *cluster_block )->data,
-			     ( *cluster_block )->data_size,
-			     block_key,
+			goto on_error;
+		}
+		/* Snapshots created by older versions of QEMU do not store the media size
+		 */
+		if( snapshot_values->media_size == 0 )
+		{
+			snapshot_values->media_size = internal_file->file_header->media_size;
+		}
+		internal_file->snapshot_values[ snapshot_index ] = snapshot_values;
+		internal_file->number_of_snapshots              += 1;
+
+		snapshot_values = NULL;
+
+		file_offset += (off64_t) entry_size;
+	}
+	return( 1 );
+
+on_error:
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	libqcow_internal_file_free_snapshots(
+	 internal_file,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Frees the snapshot values and the level 1 table of the selected snapshot
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_snapshots(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_free_snapshots";
+	int result            = 1;
+	int snapshot_index    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->snapshot_level1_table != NULL )
+	{
+		if( libqcow_cluster_table_free(
+		     &( internal_file->snapshot_level1_table ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free snapshot level 1 table.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( internal_file->snapshot_values != NULL )
+	{
+		for( snapshot_index = 0;
+		     snapshot_index < internal_file->number_of_snapshots;
+		     snapshot_index++ )
+		{
+			if( libqcow_snapshot_values_free(
+			     &( internal_file->snapshot_values[ snapshot_index ] ),
 			     error ) != 1 )
 			{
 				libcerror_error_set(
 				 error,
-				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
-				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
-				 "%s: unable to decrypt cluster block data.",
-				 function );
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free snapshot: %d values.",
+				 function,
+				 snapshot_index );
 
-				goto on_error;
+				result = -1;
 			}
 		}
+		memory_free(
+		 internal_file->snapshot_values );
+
+		internal_file->snapshot_values = NULL;
 	}
-	return( 1 );
+	internal_file->number_of_snapshots     = 0;
+	internal_file->selected_snapshot_index = -1;
+
+	if( internal_file->file_header != NULL )
+	{
+		internal_file->media_size = internal_file->file_header->media_size;
+	}
+	else
+	{
+		internal_file->media_size = 0;
+	}
+	return( result );
+}
+
+/* Reads the bitmap directory
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_bitmap_directory(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_bitmap_values_t *bitmap_values = NULL;
+	static char *function                  = "libqcow_internal_file_open_read_bitmap_directory";
+	size_t entry_size                      = 0;
+	off64_t directory_end_offset           = 0;
+	off64_t file_offset                    = 0;
+	int bitmap_index                       = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->bitmap_values != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - bitmap values already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->number_of_bitmaps == 0 )
+	 || ( internal_file->file_header->number_of_bitmaps > (uint32_t) LIBQCOW_MAXIMUM_NUMBER_OF_BITMAPS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - number of bitmaps value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->bitmap_directory_offset <= 0 )
+	 || ( ( (uint64_t) internal_file->file_header->bitmap_directory_offset & internal_file->cluster_block_bit_mask ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - bitmap directory offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->bitmap_directory_size == 0 )
+	 || ( internal_file->file_header->bitmap_directory_size > (size64_t) LIBQCOW_BITMAP_MAXIMUM_DIRECTORY_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - bitmap directory size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file->bitmap_values = (libqcow_bitmap_values_t **) memory_allocate(
+	                                                             sizeof( libqcow_bitmap_values_t * ) * internal_file->file_header->number_of_bitmaps );
+
+	if( internal_file->bitmap_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create bitmap values array.",
+		 function );
+
+		goto on_error;
+	}
+	file_offset          = internal_file->file_header->bitmap_directory_offset;
+	directory_end_offset = file_offset + (off64_t) internal_file->file_header->bitmap_directory_size;
+
+	for( bitmap_index = 0;
+	     bitmap_index < (int) internal_file->file_header->number_of_bitmaps;
+	     bitmap_index++ )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "Reading bitmap: %d:\n",
+			 bitmap_index );
+		}
+#endif
+		if( libqcow_bitmap_values_initialize(
+		     &bitmap_values,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create bitmap: %d values.",
+			 function,
+			 bitmap_index );
+
+			goto on_error;
+		}
+		if( libqcow_bitmap_values_read_file_io_handle(
+		     bitmap_values,
+		     file_io_handle,
+		     file_offset,
+		     &entry_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read bitmap: %d values at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 bitmap_index,
+			 file_offset,
+			 file_offset );
+
+			goto on_error;
+		}
+		if( (size64_t) entry_size > (size64_t) ( directory_end_offset - file_offset ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid bitmap: %d entry exceeds bitmap directory size.",
+			 function,
+			 bitmap_index );
+
+			goto on_error;
+		}
+		if( ( (uint64_t) bitmap_values->bitmap_table_offset & internal_file->cluster_block_bit_mask ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid bitmap: %d bitmap table offset value out of bounds.",
+			 function,
+			 bitmap_index );
+
+			goto on_error;
+		}
+		internal_file->bitmap_values[ bitmap_index ] = bitmap_values;
+		internal_file->number_of_bitmaps            += 1;
+
+		bitmap_values = NULL;
+
+		file_offset += (off64_t) entry_size;
+	}
+	return( 1 );
+
+on_error:
+	if( bitmap_values != NULL )
+	{
+		libqcow_bitmap_values_free(
+		 &bitmap_values,
+		 NULL );
+	}
+	libqcow_internal_file_free_bitmaps(
+	 internal_file,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Frees the bitmap values
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_bitmaps(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_free_bitmaps";
+	int bitmap_index      = 0;
+	int result            = 1;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->bitmap_values != NULL )
+	{
+		for( bitmap_index = 0;
+		     bitmap_index < internal_file->number_of_bitmaps;
+		     bitmap_index++ )
+		{
+			if( libqcow_bitmap_values_free(
+			     &( internal_file->bitmap_values[ bitmap_index ] ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free bitmap: %d values.",
+				 function,
+				 bitmap_index );
+
+				result = -1;
+			}
+		}
+		memory_free(
+		 internal_file->bitmap_values );
+
+		internal_file->bitmap_values = NULL;
+	}
+	internal_file->number_of_bitmaps = 0;
+
+	return( result );
+}
+
+/* Starts reading ahead cluster blocks
+ * Readahead is only used if multi-thread support is available, the file is opened for reading only
+ * and the number of readahead cluster blocks is not 0. The number of cluster blocks that are read ahead
+ * is limited to half of the recently used entries of the cluster block caches, so that cluster blocks
+ * that were read ahead are not evicted before they are read
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_start_readahead(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_start_readahead";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	int maximum_number_of_blocks = 0;
+	int number_of_blocks         = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->readahead != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - readahead value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->number_of_readahead_cluster_blocks == 0 )
+	 || ( internal_file->file_header == NULL )
+	 || ( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 ) )
+	{
+		return( 1 );
+	}
+	if( ( internal_file->cluster_block_cache == NULL )
+	 || ( internal_file->compressed_cluster_block_cache == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing cluster block caches.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_blocks = internal_file->number_of_readahead_cluster_blocks;
+
+	maximum_number_of_blocks = internal_file->cluster_block_cache->maximum_number_of_recent_entries / 2;
+
+	if( maximum_number_of_blocks > ( internal_file->compressed_cluster_block_cache->maximum_number_of_recent_entries / 2 ) )
+	{
+		maximum_number_of_blocks = internal_file->compressed_cluster_block_cache->maximum_number_of_recent_entries / 2;
+	}
+	if( maximum_number_of_blocks < 1 )
+	{
+		maximum_number_of_blocks = 1;
+	}
+	if( number_of_blocks > maximum_number_of_blocks )
+	{
+		number_of_blocks = maximum_number_of_blocks;
+	}
+	if( libqcow_readahead_initialize(
+	     &( internal_file->readahead ),
+	     (intptr_t *) internal_file,
+	     (int (*)(intptr_t *, off64_t, libcerror_error_t **)) &libqcow_internal_file_read_ahead_cluster_block,
+	     internal_file->cluster_block_size,
+	     internal_file->file_header->media_size,
+	     number_of_blocks,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create readahead.",
+		 function );
+
+		return( -1 );
+	}
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+	return( 1 );
+}
+
+/* Starts the decompression pool
+ * The decompression pool is only used if multi-thread support is available, the file is opened
+ * for reading only and the number of decompression threads is not 0
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_start_decompression_pool(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_start_decompression_pool";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->decompression_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - decompression pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->number_of_decompression_threads == 0 )
+	 || ( internal_file->file_header == NULL )
+	 || ( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 ) )
+	{
+		return( 1 );
+	}
+	if( libqcow_decompression_pool_initialize(
+	     &( internal_file->decompression_pool ),
+	     (intptr_t *) internal_file,
+	     (int (*)(intptr_t *, libqcow_cluster_block_t *, libcerror_error_t **)) &libqcow_internal_file_decompress_cluster_block,
+	     internal_file->number_of_decompression_threads,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+	return( 1 );
+}
+
+/* Opens a file for writing
+ * Write access requires a format version 2 or 3 file without encryption, snapshots
+ * or incompatible features other than the compression type
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_write(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	static char *function             = "libqcow_internal_file_open_write";
+	size_t reference_count_table_size = 0;
+	int number_of_references          = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_table != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - reference count table already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->format_version != 2 )
+	 && ( internal_file->file_header->format_version != 3 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access to format version: %" PRIu32 " not supported.",
+		 function,
+		 internal_file->file_header->format_version );
+
+		return( -1 );
+	}
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access to encrypted file not supported.",
+		 function );
+
+		return( -1 );
+	}
+	/* Clusters shared with snapshots require copy-on-write of the level 2 tables
+	 */
+	if( internal_file->file_header->number_of_snapshots != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access to file with snapshots not supported.",
+		 function );
+
+		return( -1 );
+	}
+	/* This includes the dirty flag, which indicates the reference counts are not consistent
+	 * The compression type only affects reading compressed cluster blocks
+	 */
+	if( ( internal_file->file_header->incompatible_feature_flags & ~( LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_COMPRESSION_TYPE ) ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access to file with incompatible features flags: 0x%08" PRIx64 " not supported.",
+		 function,
+		 internal_file->file_header->incompatible_feature_flags );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->reference_count_order < 3 )
+	 || ( internal_file->file_header->reference_count_order > 6 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access to file with reference count order: %" PRIu32 " not supported.",
+		 function,
+		 internal_file->file_header->reference_count_order );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->reference_count_table_offset <= 0 )
+	 || ( internal_file->file_header->reference_count_table_clusters == 0 )
+	 || ( (size64_t) internal_file->file_header->reference_count_table_clusters > ( (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / internal_file->cluster_block_size ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count table value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	reference_count_table_size = (size_t) internal_file->file_header->reference_count_table_clusters * (size_t) internal_file->cluster_block_size;
+
+	internal_file->number_of_reference_count_block_bits = (uint8_t) ( internal_file->file_header->number_of_cluster_block_bits + 3 - internal_file->file_header->reference_count_order );
+
+	if( libqcow_cluster_table_initialize(
+	     &( internal_file->reference_count_table ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create reference count table.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_table_read(
+	     internal_file->reference_count_table,
+	     file_io_handle,
+	     internal_file->file_header->reference_count_table_offset,
+	     reference_count_table_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read reference count table.",
+		 function );
+
+		goto on_error;
+	}
+	number_of_references = internal_file->reference_count_table->number_of_references;
+
+	internal_file->reference_count_blocks = (libqcow_reference_count_block_t **) memory_allocate(
+	                                                                              sizeof( libqcow_reference_count_block_t * ) * number_of_references );
+
+	if( internal_file->reference_count_blocks == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create reference count blocks.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_file->reference_count_blocks,
+	     0,
+	     sizeof( libqcow_reference_count_block_t * ) * number_of_references ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear reference count blocks.",
+		 function );
+
+		goto on_error;
+	}
+	/* New clusters are allocated at the end of the file
+	 */
+	internal_file->next_cluster_offset = ( internal_file->size + internal_file->cluster_block_bit_mask ) & ~( internal_file->cluster_block_bit_mask );
+
+	/* The auto-clear features must be cleared by an implementation that does not maintain them
+	 */
+	if( internal_file->file_header->auto_clear_feature_flags != 0 )
+	{
+		internal_file->file_header->auto_clear_feature_flags = 0;
+
+		if( libqcow_file_header_write_file_io_handle(
+		     internal_file->file_header,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write file header.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+	libqcow_internal_file_free_write_values(
+	 internal_file,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Frees the values used for writing
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_write_values(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function                = "libqcow_internal_file_free_write_values";
+	int reference_count_block_index      = 0;
+	int result                           = 1;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_blocks != NULL )
+	{
+		for( reference_count_block_index = 0;
+		     reference_count_block_index < internal_file->reference_count_table->number_of_references;
+		     reference_count_block_index++ )
+		{
+			if( libqcow_reference_count_block_free(
+			     &( internal_file->reference_count_blocks[ reference_count_block_index ] ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free reference count block: %d.",
+				 function,
+				 reference_count_block_index );
+
+				result = -1;
+			}
+		}
+		memory_free(
+		 internal_file->reference_count_blocks );
+
+		internal_file->reference_count_blocks = NULL;
+	}
+	if( libqcow_cluster_table_free(
+	     &( internal_file->reference_count_table ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free reference count table.",
+		 function );
+
+		result = -1;
+	}
+	if( internal_file->modified_level2_tables != NULL )
+	{
+		memory_free(
+		 internal_file->modified_level2_tables );
+
+		internal_file->modified_level2_tables = NULL;
+	}
+	if( internal_file->modified_level2_table_offsets != NULL )
+	{
+		memory_free(
+		 internal_file->modified_level2_table_offsets );
+
+		internal_file->modified_level2_table_offsets = NULL;
+	}
+	internal_file->number_of_modified_level2_tables         = 0;
+	internal_file->maximum_number_of_modified_level2_tables = 0;
+	internal_file->previous_reference_count_table_offset    = 0;
+	internal_file->previous_reference_count_table_clusters  = 0;
+	internal_file->file_header_is_modified                  = 0;
+	internal_file->write_failed                             = 0;
+	internal_file->next_cluster_offset                      = 0;
+	internal_file->access_flags                             = 0;
+
+	return( result );
+}
+
+/* Determines if the file is locked
+ * Returns 1 if locked, 0 if not or -1 on error
+ */
+int libqcow_file_is_locked(
+     libqcow_file_t *file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_is_locked";
+	uint8_t is_locked                      = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	is_locked = internal_file->is_locked;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( is_locked );
+}
+
+/* Reads a level 2 table
+ * This function is not multi-thread safe acquire the cache mutex before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_read_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level2_table_offset,
+     libqcow_cluster_table_t **level2_table,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *safe_level2_table = NULL;
+	static char *function                      = "libqcow_internal_file_read_level2_table";
+	int result                                 = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+	result = libqcow_block_cache_get_value_by_key(
+	          internal_file->level2_table_cache,
+	          level2_table_offset,
+	          (intptr_t **) level2_table,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table from cache.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		return( 1 );
+	}
+	/* The modified level 2 tables are written before the level 2 table cache
+	 * can evict one of them
+	 */
+	if( internal_file->number_of_modified_level2_tables > 0 )
+	{
+		if( libqcow_internal_file_write_modified_metadata(
+		     internal_file,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write modified metadata.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_cluster_table_initialize(
+	     &safe_level2_table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create level 2 table.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_table_read(
+	     safe_level2_table,
+	     file_io_handle,
+	     (off64_t) level2_table_offset,
+	     internal_file->level2_table_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read level 2 table at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 level2_table_offset,
+		 level2_table_offset );
+
+		goto on_error;
+	}
+	if( libqcow_block_cache_set_value_by_key(
+	     internal_file->level2_table_cache,
+	     level2_table_offset,
+	     (intptr_t *) safe_level2_table,
+	     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_table_free,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set level 2 table in cache.",
+		 function );
+
+		goto on_error;
+	}
+	*level2_table = safe_level2_table;
+
+	return( 1 );
+
+on_error:
+	if( safe_level2_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &safe_level2_table,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Retrieves the level 2 table for a specific level 1 table index
+ * This function is not multi-thread safe acquire the cache mutex before call
+ * Returns 1 if successful, 0 if the level 2 table is sparse or -1 on error
+ */
+int libqcow_internal_file_get_level2_table_by_index(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level1_table_index,
+     libqcow_cluster_table_t **level2_table,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level1_table = NULL;
+	static char *function                 = "libqcow_internal_file_get_level2_table_by_index";
+	uint64_t level2_table_offset          = 0;
+	int number_of_level1_table_references = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 1 table index\t: %" PRIu64 "\n",
+		 function,
+		 level1_table_index );
+	}
+#endif
+	if( level1_table_index > (uint64_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 1 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	/* The level 1 table of the selected snapshot replaces that of the active image
+	 */
+	if( internal_file->snapshot_level1_table == NULL )
+	{
+		level1_table = internal_file->level1_table;
+	}
+	else
+	{
+		level1_table = internal_file->snapshot_level1_table;
+
+		if( libqcow_cluster_table_get_number_of_references(
+		     level1_table,
+		     &number_of_level1_table_references,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve number of level 1 table references.",
+			 function );
+
+			return( -1 );
+		}
+		/* The level 1 table of a snapshot can be smaller than the media size requires
+		 * in which case the remaining level 2 tables are sparse
+		 */
+		if( level1_table_index >= (uint64_t) number_of_level1_table_references )
+		{
+			*level2_table = NULL;
+
+			return( 0 );
+		}
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     level1_table,
+	     (int) level1_table_index,
+	     &level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 2 table offset\t: 0x%08" PRIx64 "\n",
+		 function,
+		 level2_table_offset );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	level2_table_offset &= internal_file->offset_bit_mask;
+
+	/* If level2_table_offset is 0 the level 2 table is sparse
+	 */
+	if( level2_table_offset == 0 )
+	{
+		*level2_table = NULL;
+
+		return( 0 );
+	}
+	if( libqcow_internal_file_read_level2_table(
+	     internal_file,
+	     file_io_handle,
+	     level2_table_offset,
+	     level2_table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
+		 function,
+		 level2_table_offset );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the cluster block offset for a specific offset from its level 2 table
+ * The level 2 table is NULL if it is sparse
+ * The cluster block offset is 0 if the cluster block is not allocated or reads as zero
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     uint8_t *cluster_block_is_compressed,
+     uint8_t *cluster_block_is_zero,
+     libcerror_error_t **error )
+{
+	static char *function              = "libqcow_internal_file_get_cluster_block_offset_from_level2_table";
+	uint64_t level2_table_index        = 0;
+	uint64_t safe_cluster_block_offset = 0;
+	uint64_t subcluster_bitmap         = 0;
+	uint32_t subcluster_index          = 0;
+	uint8_t is_allocated               = 0;
+	uint8_t is_compressed              = 0;
+	uint8_t is_zero                    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_is_compressed == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block is compressed.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_is_zero == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block is zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table != NULL )
+	{
+		level2_table_index = ( (uint64_t) offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+
+		/* An extended level 2 table entry consists of 2 references
+		 * the cluster block reference and the subcluster bitmap
+		 */
+		if( internal_file->has_extended_level2_entries != 0 )
+		{
+			level2_table_index *= 2;
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: level 2 table index\t: %" PRIu64 "\n",
+			 function,
+			 level2_table_index );
+		}
+#endif
+		if( level2_table_index >= (uint64_t) INT_MAX )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid level 2 table index value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_cluster_table_get_reference_by_index(
+		     level2_table,
+		     (int) level2_table_index,
+		     &safe_cluster_block_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table entry: %" PRIu64 ".",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		if( internal_file->has_extended_level2_entries != 0 )
+		{
+			if( libqcow_cluster_table_get_reference_by_index(
+			     level2_table,
+			     (int) level2_table_index + 1,
+			     &subcluster_bitmap,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level 2 table entry: %" PRIu64 " subcluster bitmap.",
+				 function,
+				 level2_table_index );
+
+				return( -1 );
+			}
+			subcluster_index = (uint32_t) ( ( (uint64_t) offset & internal_file->cluster_block_bit_mask ) >> ( internal_file->file_header->number_of_cluster_block_bits - LIBQCOW_NUMBER_OF_SUBCLUSTER_BITS ) );
+		}
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: table2 entry: %" PRIu64 "\t\t: 0x%08" PRIx64 "\n",
+		 function,
+		 level2_table_index,
+		 safe_cluster_block_offset );
+
+		libcnotify_printf(
+		 "%s: cluster block offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 safe_cluster_block_offset & internal_file->offset_bit_mask,
+		 safe_cluster_block_offset & internal_file->offset_bit_mask );
+	}
+#endif
+	if( ( safe_cluster_block_offset & internal_file->compression_flag_bit_mask ) != 0 )
+	{
+		if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: simultaneous encryption and compression not supported.",
+			 function );
+
+			return( -1 );
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: is compressed\n",
+			 function );
+		}
+#endif
+		is_compressed = 1;
+
+		safe_cluster_block_offset &= internal_file->offset_bit_mask;
+	}
+	/* For extended level 2 table entries the subcluster bitmap indicates if the subcluster
+	 * reads as zero or is allocated, the bitmap of a compressed cluster block is not used
+	 */
+	else if( internal_file->has_extended_level2_entries != 0 )
+	{
+		if( level2_table != NULL )
+		{
+			is_zero      = (uint8_t) ( ( subcluster_bitmap >> ( 32 + subcluster_index ) ) & 0x01 );
+			is_allocated = (uint8_t) ( ( subcluster_bitmap >> subcluster_index ) & 0x01 );
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: subcluster bitmap\t\t: 0x%016" PRIx64 "\n",
+			 function,
+			 subcluster_bitmap );
+
+			libcnotify_printf(
+			 "%s: subcluster index\t\t: %" PRIu32 "\n",
+			 function,
+			 subcluster_index );
+		}
+#endif
+		safe_cluster_block_offset &= internal_file->offset_bit_mask & ~( internal_file->cluster_block_bit_mask );
+
+		if( ( is_zero != 0 )
+		 && ( is_allocated != 0 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid subcluster: %" PRIu32 " both allocated and zero.",
+			 function,
+			 subcluster_index );
+
+			return( -1 );
+		}
+		if( ( is_allocated != 0 )
+		 && ( safe_cluster_block_offset == 0 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid subcluster: %" PRIu32 " allocated without cluster block offset.",
+			 function,
+			 subcluster_index );
+
+			return( -1 );
+		}
+		/* A subcluster that is not allocated is stored in the backing file if available
+		 */
+		if( is_allocated == 0 )
+		{
+			safe_cluster_block_offset = 0;
+		}
+	}
+	/* For version 3 the zero flag indicates the cluster block reads as zero,
+	 * regardless of a preallocated cluster block offset
+	 */
+	else if( ( internal_file->file_header->format_version >= 3 )
+	      && ( ( safe_cluster_block_offset & LIBQCOW_TABLE_REFERENCE_FLAG_ZERO ) != 0 ) )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: is zero\n",
+			 function );
+		}
+#endif
+		is_zero = 1;
+
+		safe_cluster_block_offset = 0;
+	}
+	else
+	{
+		safe_cluster_block_offset &= internal_file->offset_bit_mask & ~( internal_file->cluster_block_bit_mask );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	*cluster_block_offset        = safe_cluster_block_offset;
+	*cluster_block_data_offset   = offset & internal_file->cluster_block_bit_mask;
+	*cluster_block_is_compressed = is_compressed;
+	*cluster_block_is_zero       = is_zero;
+
+	return( 1 );
+}
+
+
+/* Retrieves the cluster block offset for a specific offset
+ * The cluster block offset is 0 if the cluster block is not allocated or reads as zero
+ * This function is not multi-thread safe acquire the cache mutex before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     uint8_t *cluster_block_is_compressed,
+     uint8_t *cluster_block_is_zero,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table = NULL;
+	static char *function                 = "libqcow_internal_file_get_cluster_block_offset";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_file_get_level2_table_by_index(
+	     internal_file,
+	     file_io_handle,
+	     (uint64_t) offset >> internal_file->level1_index_bit_shift,
+	     &level2_table,
+	     error ) == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+	     internal_file,
+	     level2_table,
+	     offset,
+	     cluster_block_offset,
+	     cluster_block_data_offset,
+	     cluster_block_is_compressed,
+	     cluster_block_is_zero,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the extent that starts at a specific offset
+ * The extent consists of the consecutive cluster blocks with the same extent flags
+ * This function is not multi-thread safe acquire the cache mutex before call
+ * Returns 1 if successful, 0 if the offset is beyond the media size or -1 on error
+ */
+int libqcow_internal_file_get_extent_at_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     size64_t *extent_size,
+     uint32_t *extent_flags,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table   = NULL;
+	static char *function                   = "libqcow_internal_file_get_extent_at_offset";
+	uint64_t cluster_block_data_offset      = 0;
+	uint64_t cluster_block_file_offset      = 0;
+	uint64_t extent_end_offset              = 0;
+	uint64_t level1_table_index             = 0;
+	uint64_t next_offset                    = 0;
+	uint64_t previous_level1_table_index    = 0;
+	uint32_t cluster_block_extent_flags     = 0;
+	uint32_t safe_extent_flags              = 0;
+	uint32_t sparse_extent_flags            = 0;
+	uint8_t cluster_block_is_compressed     = 0;
+	uint8_t cluster_block_is_zero           = 0;
+	int result                              = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent size.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent flags.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= internal_file->media_size )
+	{
+		return( 0 );
+	}
+	/* The data of cluster blocks that are not allocated is stored in the backing file if available
+	 */
+	if( internal_file->backing_filename != NULL )
+	{
+		sparse_extent_flags = LIBQCOW_EXTENT_FLAG_IS_BACKING_FILE;
+	}
+	else
+	{
+		sparse_extent_flags = LIBQCOW_EXTENT_FLAG_IS_SPARSE;
+	}
+	extent_end_offset = (uint64_t) offset;
+
+	while( extent_end_offset < internal_file->media_size )
+	{
+		level1_table_index = extent_end_offset >> internal_file->level1_index_bit_shift;
+
+		if( ( extent_end_offset == (uint64_t) offset )
+		 || ( level1_table_index != previous_level1_table_index ) )
+		{
+			result = libqcow_internal_file_get_level2_table_by_index(
+			          internal_file,
+			          file_io_handle,
+			          level1_table_index,
+			          &level2_table,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+				 function,
+				 level1_table_index );
+
+				return( -1 );
+			}
+			previous_level1_table_index = level1_table_index;
+		}
+		if( level2_table == NULL )
+		{
+			/* All the cluster blocks of a sparse level 2 table are not allocated
+			 */
+			cluster_block_extent_flags = sparse_extent_flags;
+
+			next_offset = ( level1_table_index + 1 ) << internal_file->level1_index_bit_shift;
+		}
+		else
+		{
+			if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+			     internal_file,
+			     level2_table,
+			     (off64_t) extent_end_offset,
+			     &cluster_block_file_offset,
+			     &cluster_block_data_offset,
+			     &cluster_block_is_compressed,
+			     &cluster_block_is_zero,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block offset for offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 extent_end_offset,
+				 extent_end_offset );
+
+				return( -1 );
+			}
+			if( cluster_block_is_zero != 0 )
+			{
+				cluster_block_extent_flags = LIBQCOW_EXTENT_FLAG_IS_ZERO;
+			}
+			else if( cluster_block_file_offset == 0 )
+			{
+				cluster_block_extent_flags = sparse_extent_flags;
+			}
+			else if( cluster_block_is_compressed != 0 )
+			{
+				cluster_block_extent_flags = LIBQCOW_EXTENT_FLAG_IS_COMPRESSED;
+			}
+			else
+			{
+				cluster_block_extent_flags = 0;
+			}
+			/* For extended level 2 table entries the allocation status can differ per subcluster
+			 */
+			next_offset = ( extent_end_offset & ~( internal_file->subcluster_block_bit_mask ) ) + internal_file->subcluster_block_size;
+		}
+		if( extent_end_offset == (uint64_t) offset )
+		{
+			safe_extent_flags = cluster_block_extent_flags;
+		}
+		else if( cluster_block_extent_flags != safe_extent_flags )
+		{
+			break;
+		}
+		extent_end_offset = next_offset;
+	}
+	if( extent_end_offset > internal_file->media_size )
+	{
+		extent_end_offset = internal_file->media_size;
+	}
+	*extent_size  = (size64_t) ( extent_end_offset - (uint64_t) offset );
+	*extent_flags = safe_extent_flags;
+
+	return( 1 );
+}
+
+/* Retrieves the size of the range, that starts at a specific offset, of consecutive cluster blocks
+ * that are not allocated and of which the data is stored in the backing file
+ * The range does not exceed the maximum size
+ * This function acquires the cache mutex
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_backing_range_size(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     size_t maximum_size,
+     size_t *range_size,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table = NULL;
+	static char *function                 = "libqcow_internal_file_get_backing_range_size";
+	uint64_t cluster_block_data_offset    = 0;
+	uint64_t cluster_block_file_offset    = 0;
+	uint64_t level1_table_index           = 0;
+	uint64_t maximum_end_offset           = 0;
+	uint64_t next_offset                  = 0;
+	uint64_t previous_level1_table_index  = 0;
+	uint64_t range_end_offset             = 0;
+	uint8_t cluster_block_is_compressed   = 0;
+	uint8_t cluster_block_is_zero         = 0;
+	int result                            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( maximum_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid maximum size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( range_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid range size.",
+		 function );
+
+		return( -1 );
+	}
+	range_end_offset   = (uint64_t) offset;
+	maximum_end_offset = (uint64_t) offset + maximum_size;
+
+	if( maximum_end_offset > internal_file->media_size )
+	{
+		maximum_end_offset = internal_file->media_size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	while( range_end_offset < maximum_end_offset )
+	{
+		level1_table_index = range_end_offset >> internal_file->level1_index_bit_shift;
+
+		if( ( range_end_offset == (uint64_t) offset )
+		 || ( level1_table_index != previous_level1_table_index ) )
+		{
+			result = libqcow_internal_file_get_level2_table_by_index(
+			          internal_file,
+			          file_io_handle,
+			          level1_table_index,
+			          &level2_table,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+				 function,
+				 level1_table_index );
+
+				goto on_error;
+			}
+			previous_level1_table_index = level1_table_index;
+		}
+		if( level2_table == NULL )
+		{
+			/* All the cluster blocks of a sparse level 2 table are not allocated
+			 */
+			next_offset = ( level1_table_index + 1 ) << internal_file->level1_index_bit_shift;
+		}
+		else
+		{
+			if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+			     internal_file,
+			     level2_table,
+			     (off64_t) range_end_offset,
+			     &cluster_block_file_offset,
+			     &cluster_block_data_offset,
+			     &cluster_block_is_compressed,
+			     &cluster_block_is_zero,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block offset for offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 range_end_offset,
+				 range_end_offset );
+
+				goto on_error;
+			}
+			if( ( cluster_block_file_offset != 0 )
+			 || ( cluster_block_is_zero != 0 ) )
+			{
+				break;
+			}
+			next_offset = ( range_end_offset & ~( internal_file->subcluster_block_bit_mask ) ) + internal_file->subcluster_block_size;
+		}
+		range_end_offset = next_offset;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( range_end_offset > maximum_end_offset )
+	{
+		range_end_offset = maximum_end_offset;
+	}
+	*range_size = (size_t) ( range_end_offset - (uint64_t) offset );
+
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_mutex_release(
+	 internal_file->cache_mutex,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Retrieves the range of a cluster block in the file
+ * For a compressed cluster block the cluster block offset contains both the offset and the size
+ * of the compressed data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_cluster_block_file_range(
+     libqcow_internal_file_t *internal_file,
+     uint64_t cluster_block_offset,
+     uint8_t cluster_block_is_compressed,
+     uint64_t *cluster_block_file_offset,
+     size_t *cluster_block_size,
+     libcerror_error_t **error )
+{
+	static char *function                        = "libqcow_internal_file_get_cluster_block_file_range";
+	size_t safe_cluster_block_size               = 0;
+	size64_t data_file_size                      = 0;
+	uint64_t compressed_cluster_block_end_offset = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_file_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block file offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block size.",
+		 function );
+
+		return( -1 );
+	}
+	/* The cluster blocks of an image with an external data file are stored in the data file
+	 */
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		data_file_size = internal_file->data_file_size;
+	}
+	else
+	{
+		data_file_size = internal_file->size;
+	}
+	if( cluster_block_is_compressed != 0 )
+	{
+		/* Handle compressed cluster block
+		 */
+		safe_cluster_block_size = (size_t) ( cluster_block_offset >> internal_file->compression_bit_shift );
+		cluster_block_offset   &= internal_file->compression_bit_mask;
+
+		if( ( internal_file->file_header->format_version == 2 )
+		 || ( internal_file->file_header->format_version == 3 ) )
+		{
+			safe_cluster_block_size += 1;
+			safe_cluster_block_size *= 512;
+
+			/* Make sure the compressed block size stays within the bounds
+			 * of the cluster block size and the size of the file
+			 */
+			compressed_cluster_block_end_offset = cluster_block_offset / internal_file->cluster_block_size;
+
+			if( ( cluster_block_offset % internal_file->cluster_block_size ) != 0 )
+			{
+				compressed_cluster_block_end_offset += 1;
+			}
+			compressed_cluster_block_end_offset += 1;
+			compressed_cluster_block_end_offset *= internal_file->cluster_block_size;
+
+			if( compressed_cluster_block_end_offset > data_file_size )
+			{
+				compressed_cluster_block_end_offset = data_file_size;
+			}
+			if( ( cluster_block_offset + safe_cluster_block_size ) > compressed_cluster_block_end_offset )
+			{
+				safe_cluster_block_size = (size_t) ( compressed_cluster_block_end_offset - cluster_block_offset );
+			}
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: compressed cluster block offset\t\t: 0x%08" PRIx64 "\n",
+			 function,
+			 cluster_block_offset );
+
+			libcnotify_printf(
+			 "%s: compressed cluster block size\t\t: %" PRIzd "\n",
+			 function,
+			 safe_cluster_block_size );
+		}
+#endif
+	}
+	else
+	{
+		safe_cluster_block_size = (size_t) internal_file->cluster_block_size;
+
+		/* For version 2 and 3 make sure the sure the last cluster block size
+		 * stays within the bounds of the size of the file
+		 */
+		if( ( ( internal_file->file_header->format_version == 2 )
+		  ||  ( internal_file->file_header->format_version == 3 ) )
+		 && ( ( cluster_block_offset + internal_file->cluster_block_size ) > data_file_size ) )
+		{
+			if( cluster_block_offset >= data_file_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid cluster block offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			safe_cluster_block_size = (size_t) ( data_file_size - cluster_block_offset );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: last cluster block offset\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 cluster_block_offset );
+
+				libcnotify_printf(
+				 "%s: last cluster block size\t\t\t: %" PRIzd "\n",
+				 function,
+				 safe_cluster_block_size );
+			}
+#endif
+		}
+	}
+	*cluster_block_file_offset = cluster_block_offset;
+	*cluster_block_size        = safe_cluster_block_size;
+
+	return( 1 );
+}
+
+/* Decompresses a compressed cluster block
+ * On return the cluster block contains the uncompressed data, the compressed data is freed
+ * so that only a single buffer remains per cluster block
+ * This function does not change the file and can be called without the cache mutex
+ * for a cluster block that is not stored in a cache
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_decompress_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function         = "libqcow_internal_file_decompress_cluster_block";
+	size_t uncompressed_data_size = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->cluster_block_size == 0 )
+	 || ( internal_file->cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	/* The data read from the file becomes the compressed data, which is a transient
+	 * buffer that is returned to the buffer pool once the data is decompressed
+	 */
+	if( libqcow_cluster_block_set_compressed(
+	     cluster_block,
+	     (size_t) internal_file->cluster_block_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set cluster block compressed.",
+		 function );
+
+		return( -1 );
+	}
+	uncompressed_data_size = cluster_block->data_size;
+
+	if( libqcow_decompress_data(
+	     cluster_block->compressed_data,
+	     cluster_block->compressed_data_size,
+	     internal_file->file_header->compression_method,
+	     cluster_block->data,
+	     &uncompressed_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+		 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+		 "%s: unable to decompress cluster block data.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_size < cluster_block->data_size )
+	{
+		if( memory_set(
+		     &( cluster_block->data[ uncompressed_data_size ] ),
+		     0,
+		     cluster_block->data_size - uncompressed_data_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear cluster block data.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( libqcow_cluster_block_free_compressed_data(
+	     cluster_block,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free cluster block compressed data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Decrypts an encrypted cluster block
+ * The data is decrypted in-place
+ * The encryption block key is determined by the cluster block media offset for the AES-CBC
+ * encryption method and by the cluster block file offset for the LUKS encryption method
+ * This function does not change the file and can be called without the cache mutex
+ * for a cluster block that is not stored in a cache
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_decrypt_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     off64_t cluster_block_media_offset,
+     off64_t cluster_block_file_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_decrypt_cluster_block";
+	uint64_t block_key    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_media_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block media offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_file_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block file offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	/* LUKS uses the sector number in the file as the AES-XTS tweak
+	 */
+	if( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_LUKS )
+	{
+		block_key = (uint64_t) cluster_block_file_offset / 512;
+	}
+	else
+	{
+		block_key = (uint64_t) cluster_block_media_offset / 512;
+	}
+
+	if( libqcow_encryption_crypt(
+	     internal_file->encryption_context,
+	     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	     cluster_block->data,
+	     cluster_block->data_size,
+	     cluster_block->data,
+	     cluster_block->data_size,
+	     block_key,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+		 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+		 "%s: unable to decrypt cluster block data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads a cluster block without using the cluster block cache
+ * The cluster block is read from the file range and decompressed and decrypted if needed
+ * The cluster block media offset is used to determine the encryption block key
+ * This function does not change the file and can be called without the cache mutex
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_read_uncached_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_block_file_offset,
+     size_t cluster_block_size,
+     off64_t cluster_block_media_offset,
+     uint8_t cluster_block_is_compressed,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_block_t *safe_cluster_block = NULL;
+	static char *function                       = "libqcow_internal_file_read_uncached_cluster_block";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_block_initialize(
+	     &safe_cluster_block,
+	     internal_file->buffer_pool,
+	     cluster_block_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create cluster block.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_block_read(
+	     safe_cluster_block,
+	     file_io_handle,
+	     cluster_block_file_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 cluster_block_file_offset,
+		 cluster_block_file_offset );
+
+		goto on_error;
+	}
+	if( cluster_block_is_compressed != 0 )
+	{
+		if( libqcow_internal_file_decompress_cluster_block(
+		     internal_file,
+		     safe_cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+			 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+			 "%s: unable to decompress cluster block data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+			 function,
+			 cluster_block_file_offset,
+			 cluster_block_file_offset );
+
+			goto on_error;
+		}
+	}
+	/* The cluster block is decrypted before it is stored in a cache
+	 * so that the caches only contain decrypted data
+	 */
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		if( libqcow_internal_file_decrypt_cluster_block(
+		     internal_file,
+		     safe_cluster_block,
+		     cluster_block_media_offset,
+		     (off64_t) cluster_block_file_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+			 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+			 "%s: unable to decrypt cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	*cluster_block = safe_cluster_block;
+
+	return( 1 );
+
+on_error:
+	if( safe_cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &safe_cluster_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Reads cluster block data into a buffer using the cluster block caches
+ * The cluster block media offset is used to determine the encryption block key
+ * The cache mutex is only held to look up the cluster block in the cache and to store
+ * the cluster block in the cache. The cluster block is read, decompressed and decrypted
+ * without holding it. Do not call this function with the cache mutex acquired
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_read_cached_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_block_offset,
+     uint64_t cluster_block_data_offset,
+     off64_t cluster_block_media_offset,
+     uint8_t cluster_block_is_compressed,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *cache_entry    = NULL;
+	libqcow_block_cache_t *cluster_block_cache  = NULL;
+	libqcow_cluster_block_t *cluster_block      = NULL;
+	libqcow_cluster_block_t *safe_cluster_block = NULL;
+	static char *function                       = "libqcow_internal_file_read_cached_cluster_block_data";
+	size_t cluster_block_size                   = 0;
+	uint64_t cluster_block_file_offset          = 0;
+	int result                                  = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	uint8_t cache_mutex_grabbed                 = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block_data_offset >= internal_file->cluster_block_size )
+	 || ( buffer_size > ( internal_file->cluster_block_size - cluster_block_data_offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid buffer size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_file_get_cluster_block_file_range(
+	     internal_file,
+	     cluster_block_offset,
+	     cluster_block_is_compressed,
+	     &cluster_block_file_offset,
+	     &cluster_block_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block file range.",
+		 function );
+
+		goto on_error;
+	}
+	if( cluster_block_is_compressed != 0 )
+	{
+		cluster_block_cache = internal_file->compressed_cluster_block_cache;
+	}
+	else
+	{
+		cluster_block_cache = internal_file->cluster_block_cache;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	cache_mutex_grabbed = 1;
+#endif
+	/* Cluster blocks are cached by their offset in the file since multiple
+	 * compressed cluster blocks can be stored in a single cluster
+	 */
+	result = libqcow_block_cache_get_value_by_key(
+	          cluster_block_cache,
+	          cluster_block_file_offset,
+	          (intptr_t **) &cluster_block,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ") from cache.",
+		 function,
+		 cluster_block_file_offset,
+		 cluster_block_file_offset );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		/* The cached cluster block can be evicted once the cache mutex is released
+		 */
+		if( libqcow_cluster_block_copy_data(
+		     cluster_block,
+		     (size_t) cluster_block_data_offset,
+		     buffer,
+		     buffer_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_COPY_FAILED,
+			 "%s: unable to copy cluster block data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( result != 0 )
+	{
+		return( 1 );
+	}
+	if( libqcow_internal_file_read_uncached_cluster_block(
+	     internal_file,
+	     file_io_handle,
+	     cluster_block_file_offset,
+	     cluster_block_size,
+	     cluster_block_media_offset,
+	     cluster_block_is_compressed,
+	     &safe_cluster_block,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 cluster_block_file_offset,
+		 cluster_block_file_offset );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_block_copy_data(
+	     safe_cluster_block,
+	     (size_t) cluster_block_data_offset,
+	     buffer,
+	     buffer_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_COPY_FAILED,
+		 "%s: unable to copy cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	cache_mutex_grabbed = 1;
+#endif
+	/* Another read can have stored the cluster block in the cache in the meantime
+	 */
+	cache_entry = libqcow_block_cache_find_entry(
+	               cluster_block_cache,
+	               cluster_block_file_offset );
+
+	if( ( cache_entry == NULL )
+	 || ( cache_entry->value == NULL ) )
+	{
+		if( libqcow_block_cache_set_value_by_key(
+		     cluster_block_cache,
+		     cluster_block_file_offset,
+		     (intptr_t *) safe_cluster_block,
+		     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cluster block in cache.",
+			 function );
+
+			goto on_error;
+		}
+		/* The cache now manages the cluster block
+		 */
+		safe_cluster_block = NULL;
+
+		if( cluster_block_is_compressed != 0 )
+		{
+			internal_file->number_of_decompressed_cluster_blocks += 1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( safe_cluster_block != NULL )
+	{
+		if( libqcow_cluster_block_free(
+		     &safe_cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+#endif
+	if( safe_cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &safe_cluster_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Reads cluster block data at a specific offset into a buffer
+ * The buffer size cannot exceed the remainder of the cluster block
+ * The cache mutex is only held to look up the level 2 table and the cluster block
+ * in the caches and to store a cluster block in the cache. The cluster block is read,
+ * decompressed and decrypted without holding it, so that reads can run concurrently
+ * This function does not modify the current offset
+ * Returns 1 if successful, 0 if the cluster block is not allocated or -1 on error
+ */
+int libqcow_internal_file_read_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *data_file_io_handle = NULL;
+	static char *function                 = "libqcow_internal_file_read_cluster_block_data";
+	ssize_t read_count                    = 0;
+	uint64_t cluster_block_data_offset    = 0;
+	uint64_t cluster_block_file_offset    = 0;
+	uint8_t cluster_block_is_compressed   = 0;
+	uint8_t cluster_block_is_zero         = 0;
+
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	int result                            = 0;
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	uint8_t cache_mutex_grabbed           = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		return( -1 );
+	}
+	cache_mutex_grabbed = 1;
+#endif
+	if( libqcow_internal_file_get_cluster_block_offset(
+	     internal_file,
+	     file_io_handle,
+	     offset,
+	     &cluster_block_file_offset,
+	     &cluster_block_data_offset,
+	     &cluster_block_is_compressed,
+	     &cluster_block_is_zero,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( ( cluster_block_file_offset == 0 )
+	 && ( cluster_block_is_zero == 0 ) )
+	{
+		return( 0 );
+	}
+	if( buffer_size > ( internal_file->cluster_block_size - cluster_block_data_offset ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid buffer size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	/* The level 2 tables are stored in the image file while the cluster block data
+	 * of an image with an external data file is stored in the data file
+	 */
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		data_file_io_handle = internal_file->data_file_io_handle;
+	}
+	else
+	{
+		data_file_io_handle = file_io_handle;
+	}
+	/* A cluster block that reads as zero is not read from the file
+	 * and is not stored in the cluster block cache
+	 */
+	if( cluster_block_is_zero != 0 )
+	{
+		if( memory_set(
+		     buffer,
+		     0,
+		     buffer_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to set zero data in buffer.",
+			 function );
+
+			goto on_error;
+		}
+		return( 1 );
+	}
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	/* An uncompressed cluster block of a mapped file is copied directly from the mapped data
+	 * and is not stored in the cluster block cache
+	 */
+	if( ( internal_file->mapped_file != NULL )
+	 && ( data_file_io_handle == internal_file->file_io_handle )
+	 && ( cluster_block_is_compressed == 0 ) )
+	{
+		result = libqcow_mapped_file_copy_data_at_offset(
+		          internal_file->mapped_file,
+		          (off64_t) ( cluster_block_file_offset + cluster_block_data_offset ),
+		          buffer,
+		          buffer_size,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to copy mapped cluster block data.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			return( 1 );
+		}
+	}
+#endif
+	/* For extended level 2 table entries an uncompressed and unencrypted subcluster is read directly
+	 * so that the subclusters that are not allocated are not read from the file
+	 */
+	if( ( internal_file->has_extended_level2_entries != 0 )
+	 && ( cluster_block_is_compressed == 0 )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+	{
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              data_file_io_handle,
+		              buffer,
+		              buffer_size,
+		              (off64_t) ( cluster_block_file_offset + cluster_block_data_offset ),
+		              error );
+
+		if( read_count < 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read subcluster data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+			 function,
+			 cluster_block_file_offset + cluster_block_data_offset,
+			 cluster_block_file_offset + cluster_block_data_offset );
+
+			goto on_error;
+		}
+		/* The last cluster block in the file can be smaller than the cluster block size
+		 */
+		if( (size_t) read_count < buffer_size )
+		{
+			if( memory_set(
+			     &( buffer[ read_count ] ),
+			     0,
+			     buffer_size - (size_t) read_count ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to clear remainder of subcluster data.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		return( 1 );
+	}
+	if( libqcow_internal_file_read_cached_cluster_block_data(
+	     internal_file,
+	     data_file_io_handle,
+	     cluster_block_file_offset,
+	     cluster_block_data_offset,
+	     offset - (off64_t) cluster_block_data_offset,
+	     cluster_block_is_compressed,
+	     buffer,
+	     buffer_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+#endif
+	return( -1 );
+}
+
+/* Reads the data of a run of cluster blocks that are contiguous in the file into a buffer
+ * The run consists of uncompressed and unencrypted cluster blocks that are stored consecutively
+ * in the file. The data is read directly into the buffer with a single read, bypassing the cluster block cache
+ * The cache mutex is only held to look up the level 2 tables, the data is read without holding it
+ * This function does not modify the current offset
+ * Returns 1 if successful, 0 if the data does not start with a run of at least 2 contiguous cluster blocks or -1 on error
+ */
+int libqcow_internal_file_read_contiguous_cluster_blocks_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     size_t *read_size,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *data_file_io_handle = NULL;
+	libqcow_cluster_table_t *level2_table = NULL;
+	static char *function                 = "libqcow_internal_file_read_contiguous_cluster_blocks_data";
+	size_t first_block_size               = 0;
+	size_t run_size                       = 0;
+	ssize_t read_count                    = 0;
+	size64_t data_file_size               = 0;
+	uint64_t cluster_block_data_offset    = 0;
+	uint64_t cluster_block_file_offset    = 0;
+	uint64_t level1_table_index           = 0;
+	uint64_t next_level1_table_index      = 0;
+	uint64_t run_file_offset              = 0;
+	uint8_t cluster_block_is_compressed   = 0;
+	uint8_t cluster_block_is_zero         = 0;
+	int result                            = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	uint8_t cache_mutex_grabbed           = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read size.",
+		 function );
+
+		return( -1 );
+	}
+	/* Encrypted cluster blocks are decrypted by the cluster block cache
+	 */
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		return( 0 );
+	}
+	/* For extended level 2 table entries the run consists of allocated subclusters
+	 */
+	run_size = (size_t) ( internal_file->subcluster_block_size - ( (uint64_t) offset & internal_file->subcluster_block_bit_mask ) );
+
+	if( buffer_size <= run_size )
+	{
+		return( 0 );
+	}
+	/* The level 2 tables are stored in the image file while the cluster block data
+	 * of an image with an external data file is stored in the data file
+	 */
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		data_file_io_handle = internal_file->data_file_io_handle;
+		data_file_size      = internal_file->data_file_size;
+	}
+	else
+	{
+		data_file_io_handle = file_io_handle;
+		data_file_size      = internal_file->size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		return( -1 );
+	}
+	cache_mutex_grabbed = 1;
+#endif
+	level1_table_index = (uint64_t) offset >> internal_file->level1_index_bit_shift;
+
+	result = libqcow_internal_file_get_level2_table_by_index(
+	          internal_file,
+	          file_io_handle,
+	          level1_table_index,
+	          &level2_table,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+		 function,
+		 level1_table_index );
+
+		goto on_error;
+	}
+	if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+	     internal_file,
+	     level2_table,
+	     offset,
+	     &cluster_block_file_offset,
+	     &cluster_block_data_offset,
+	     &cluster_block_is_compressed,
+	     &cluster_block_is_zero,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		goto on_error;
+	}
+	result = 0;
+
+	if( ( cluster_block_file_offset != 0 )
+	 && ( cluster_block_is_compressed == 0 ) )
+	{
+		run_file_offset  = cluster_block_file_offset + cluster_block_data_offset;
+		first_block_size = run_size;
+
+		while( run_size < buffer_size )
+		{
+			next_level1_table_index = ( (uint64_t) offset + run_size ) >> internal_file->level1_index_bit_shift;
+
+			if( next_level1_table_index != level1_table_index )
+			{
+				level1_table_index = next_level1_table_index;
+
+				result = libqcow_internal_file_get_level2_table_by_index(
+				          internal_file,
+				          file_io_handle,
+				          level1_table_index,
+				          &level2_table,
+				          error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+					 function,
+					 level1_table_index );
+
+					goto on_error;
+				}
+				else if( result == 0 )
+				{
+					break;
+				}
+			}
+			if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+			     internal_file,
+			     level2_table,
+			     offset + (off64_t) run_size,
+			     &cluster_block_file_offset,
+			     &cluster_block_data_offset,
+			     &cluster_block_is_compressed,
+			     &cluster_block_is_zero,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 offset + (off64_t) run_size,
+				 offset + (off64_t) run_size );
+
+				goto on_error;
+			}
+			if( ( cluster_block_is_compressed != 0 )
+			 || ( cluster_block_file_offset == 0 )
+			 || ( ( cluster_block_file_offset + cluster_block_data_offset ) != ( run_file_offset + run_size ) ) )
+			{
+				break;
+			}
+			if( ( buffer_size - run_size ) > internal_file->subcluster_block_size )
+			{
+				run_size += (size_t) internal_file->subcluster_block_size;
+			}
+			else
+			{
+				run_size = buffer_size;
+			}
+		}
+		/* The last cluster block in the file can be smaller than the cluster block size
+		 * and is read by the cluster block cache
+		 */
+		result = 0;
+
+		if( ( run_size > first_block_size )
+		 && ( ( run_file_offset + run_size ) <= data_file_size ) )
+		{
+			result = 1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( result != 0 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: reading contiguous cluster blocks at offset: %" PRIu64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+			 function,
+			 run_file_offset,
+			 run_file_offset,
+			 run_size );
+		}
+#endif
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+		if( ( internal_file->mapped_file != NULL )
+		 && ( data_file_io_handle == internal_file->file_io_handle ) )
+		{
+			result = libqcow_mapped_file_copy_data_at_offset(
+			          internal_file->mapped_file,
+			          (off64_t) run_file_offset,
+			          buffer,
+			          run_size,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to copy mapped contiguous cluster blocks at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 run_file_offset,
+				 run_file_offset );
+
+				goto on_error;
+			}
+			else if( result != 0 )
+			{
+				read_count = (ssize_t) run_size;
+			}
+			result = 1;
+		}
+#endif
+		if( read_count == 0 )
+		{
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              data_file_io_handle,
+			              buffer,
+			              run_size,
+			              (off64_t) run_file_offset,
+			              error );
+		}
+		if( read_count != (ssize_t) run_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read contiguous cluster blocks at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+			 function,
+			 run_file_offset,
+			 run_file_offset );
+
+			goto on_error;
+		}
+		*read_size = run_size;
+	}
+	return( result );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+#endif
+	return( -1 );
+}
+
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Reads ahead a cluster block into the cluster block cache
+ * Only compressed or encrypted cluster blocks are read ahead, other cluster blocks are read
+ * directly into the buffer of a read. Looking up the cluster block also reads ahead its level 2 table.
+ * The cache mutex is only held to look up the cluster block and to store it in the cache, the cluster block
+ * is read, decompressed and decrypted without holding it. When a read stored the cluster block in the cache
+ * in the meantime the read ahead cluster block is discarded.
+ * The read/write lock is not grabbed since a read that holds it can wait for the cluster block to be read ahead,
+ * functions that modify the caches grab the cache mutex instead
+ * This function is used by the readahead worker thread
+ * Returns 1 if successful, 0 if the cluster block was not read or -1 on error
+ */
+int libqcow_internal_file_read_ahead_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *data_file_io_handle       = NULL;
+	libqcow_block_cache_entry_t *cache_entry    = NULL;
+	libqcow_block_cache_t *cluster_block_cache  = NULL;
+	libqcow_cluster_block_t *cluster_block      = NULL;
+	static char *function                       = "libqcow_internal_file_read_ahead_cluster_block";
+	size_t cluster_block_size                   = 0;
+	uint64_t cluster_block_data_offset          = 0;
+	uint64_t cluster_block_file_offset          = 0;
+	uint8_t cache_mutex_grabbed                 = 0;
+	uint8_t cluster_block_is_compressed         = 0;
+	uint8_t cluster_block_is_zero               = 0;
+	uint8_t read_ahead                          = 0;
+	int result                                  = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	/* The cluster block data of an image with an external data file is stored in the data file
+	 * and cannot be read ahead before the data file has been set
+	 */
+	data_file_io_handle = internal_file->data_file_io_handle;
+
+	if( data_file_io_handle == NULL )
+	{
+		if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+		{
+			return( 0 );
+		}
+		data_file_io_handle = internal_file->file_io_handle;
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	cache_mutex_grabbed = 1;
+
+	if( libqcow_internal_file_get_cluster_block_offset(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     offset,
+	     &cluster_block_file_offset,
+	     &cluster_block_data_offset,
+	     &cluster_block_is_compressed,
+	     &cluster_block_is_zero,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		goto on_error;
+	}
+	if( ( cluster_block_file_offset != 0 )
+	 && ( ( cluster_block_is_compressed != 0 )
+	  ||  ( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE ) ) )
+	{
+		if( libqcow_internal_file_get_cluster_block_file_range(
+		     internal_file,
+		     cluster_block_file_offset,
+		     cluster_block_is_compressed,
+		     &cluster_block_file_offset,
+		     &cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block file range.",
+			 function );
+
+			goto on_error;
+		}
+		if( cluster_block_is_compressed != 0 )
+		{
+			cluster_block_cache = internal_file->compressed_cluster_block_cache;
+		}
+		else
+		{
+			cluster_block_cache = internal_file->cluster_block_cache;
+		}
+		/* Looking up the entry does not affect the cache statistics
+		 */
+		cache_entry = libqcow_block_cache_find_entry(
+		               cluster_block_cache,
+		               cluster_block_file_offset );
+
+		if( ( cache_entry == NULL )
+		 || ( cache_entry->value == NULL ) )
+		{
+			read_ahead = 1;
+		}
+	}
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( read_ahead == 0 )
+	{
+		return( 0 );
+	}
+	if( libqcow_internal_file_read_uncached_cluster_block(
+	     internal_file,
+	     data_file_io_handle,
+	     cluster_block_file_offset,
+	     cluster_block_size,
+	     offset - (off64_t) cluster_block_data_offset,
+	     cluster_block_is_compressed,
+	     &cluster_block,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 cluster_block_file_offset,
+		 cluster_block_file_offset );
+
+		goto on_error;
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	cache_mutex_grabbed = 1;
+
+	/* A read can have stored the cluster block in the cache in the meantime
+	 */
+	cache_entry = libqcow_block_cache_find_entry(
+	               cluster_block_cache,
+	               cluster_block_file_offset );
+
+	if( ( cache_entry == NULL )
+	 || ( cache_entry->value == NULL ) )
+	{
+		if( libqcow_block_cache_set_value_by_key(
+		     cluster_block_cache,
+		     cluster_block_file_offset,
+		     (intptr_t *) cluster_block,
+		     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cluster block in cache.",
+			 function );
+
+			goto on_error;
+		}
+		/* The cache now manages the cluster block
+		 */
+		cluster_block = NULL;
+
+		if( cluster_block_is_compressed != 0 )
+		{
+			internal_file->number_of_decompressed_cluster_blocks += 1;
+		}
+		result = 1;
+	}
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( cluster_block != NULL )
+	{
+		if( libqcow_cluster_block_free(
+		     &cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( result );
+
+on_error:
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Decompresses the compressed cluster blocks of read segments in parallel using the decompression pool
+ * The compressed data is read on the calling thread and every cluster block is decompressed by a worker
+ * thread directly into the buffers of its read segments, which are marked as decompressed.
+ * Cluster blocks that are stored in the compressed cluster block cache are not decompressed, the decompressed
+ * cluster blocks are stored in the cache afterwards. The read segments must be sorted by file offset
+ * The cache mutex is only held to look up the cluster blocks in the cache and to store
+ * the decompressed cluster blocks, the compressed data is read and the decompression tasks
+ * are waited for without holding it. Do not call this function with the cache mutex acquired
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_decompress_read_segments(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_read_segment_t *read_segments,
+     size_t number_of_read_segments,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_entry_t *cache_entry         = NULL;
+	libqcow_cluster_block_t *cluster_block           = NULL;
+	libqcow_decompression_batch_t decompression_batch;
+	libqcow_decompression_task_t *decompression_task  = NULL;
+	libqcow_decompression_task_t *decompression_tasks = NULL;
+	libqcow_read_segment_t *read_segment             = NULL;
+	static char *function                            = "libqcow_internal_file_decompress_read_segments";
+	size_t cluster_block_size                        = 0;
+	size_t last_read_segment_index                   = 0;
+	size_t number_of_tasks                           = 0;
+	size_t read_segment_index                        = 0;
+	size_t task_index                                = 0;
+	uint64_t cluster_block_file_offset               = 0;
+	uint8_t cache_mutex_grabbed                      = 0;
+	int result                                       = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->decompression_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing decompression pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_segments == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read segments.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_read_segments == 0 )
+	 || ( number_of_read_segments > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_decompression_task_t ) ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of read segments value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	decompression_batch.number_of_pending_tasks = 0;
+	decompression_batch.number_of_failed_tasks  = 0;
+
+	for( read_segment_index = 0;
+	     read_segment_index < number_of_read_segments;
+	     read_segment_index++ )
+	{
+		read_segment = &( read_segments[ read_segment_index ] );
+
+		read_segment->is_decompressed = 0;
+	}
+	read_segment_index = 0;
+
+	while( read_segment_index < number_of_read_segments )
+	{
+		read_segment = &( read_segments[ read_segment_index ] );
+
+		if( ( read_segment->cluster_block_is_compressed == 0 )
+		 || ( read_segment->cluster_block_is_zero != 0 )
+		 || ( read_segment->file_offset == 0 ) )
+		{
+			read_segment_index++;
+
+			continue;
+		}
+		/* The read segments that are stored in the same cluster block are consecutive
+		 */
+		last_read_segment_index = read_segment_index;
+
+		while( ( last_read_segment_index + 1 ) < number_of_read_segments )
+		{
+			if( ( read_segments[ last_read_segment_index + 1 ].cluster_block_is_compressed == 0 )
+			 || ( read_segments[ last_read_segment_index + 1 ].cluster_block_is_zero != 0 )
+			 || ( read_segments[ last_read_segment_index + 1 ].cluster_block_offset != read_segment->cluster_block_offset ) )
+			{
+				break;
+			}
+			last_read_segment_index++;
+		}
+		if( libqcow_internal_file_get_cluster_block_file_range(
+		     internal_file,
+		     read_segment->cluster_block_offset,
+		     1,
+		     &cluster_block_file_offset,
+		     &cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block file range.",
+			 function );
+
+			goto on_error;
+		}
+		if( libcthreads_mutex_grab(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab cache mutex.",
+			 function );
+
+			goto on_error;
+		}
+		/* A cluster block that is stored in the cache is copied by the caller
+		 */
+		cache_entry = libqcow_block_cache_find_entry(
+		               internal_file->compressed_cluster_block_cache,
+		               cluster_block_file_offset );
+
+		result = 0;
+
+		if( ( cache_entry != NULL )
+		 && ( cache_entry->value != NULL ) )
+		{
+			result = 1;
+		}
+		if( libcthreads_mutex_release(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release cache mutex.",
+			 function );
+
+			goto on_error;
+		}
+		if( result == 0 )
+		{
+			if( decompression_tasks == NULL )
+			{
+				decompression_tasks = (libqcow_decompression_task_t *) memory_allocate(
+				                                                        sizeof( libqcow_decompression_task_t ) * number_of_read_segments );
+
+				if( decompression_tasks == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+					 "%s: unable to create decompression tasks.",
+					 function );
+
+					goto on_error;
+				}
+			}
+			if( libqcow_cluster_block_initialize(
+			     &cluster_block,
+			     internal_file->buffer_pool,
+			     cluster_block_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			if( libqcow_cluster_block_read(
+			     cluster_block,
+			     file_io_handle,
+			     cluster_block_file_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 cluster_block_file_offset,
+				 cluster_block_file_offset );
+
+				goto on_error;
+			}
+			decompression_task = &( decompression_tasks[ number_of_tasks ] );
+
+			decompression_task->batch                   = &decompression_batch;
+			decompression_task->cluster_block           = cluster_block;
+			decompression_task->read_segments           = read_segment;
+			decompression_task->number_of_read_segments = last_read_segment_index - read_segment_index + 1;
+			decompression_task->result                  = 0;
+
+			if( libqcow_decompression_pool_push_task(
+			     internal_file->decompression_pool,
+			     decompression_task,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to push decompression task.",
+				 function );
+
+				goto on_error;
+			}
+			/* The task now manages the cluster block
+			 */
+			cluster_block = NULL;
+
+			number_of_tasks++;
+		}
+		read_segment_index = last_read_segment_index + 1;
+	}
+	if( number_of_tasks == 0 )
+	{
+		return( 1 );
+	}
+	result = libqcow_decompression_pool_wait_for_batch(
+	          internal_file->decompression_pool,
+	          &decompression_batch,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to wait for decompression tasks.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+		 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+		 "%s: unable to decompress cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	cache_mutex_grabbed = 1;
+
+	for( task_index = 0;
+	     task_index < number_of_tasks;
+	     task_index++ )
+	{
+		decompression_task = &( decompression_tasks[ task_index ] );
+
+		for( read_segment_index = 0;
+		     read_segment_index < decompression_task->number_of_read_segments;
+		     read_segment_index++ )
+		{
+			decompression_task->read_segments[ read_segment_index ].is_decompressed = 1;
+		}
+		internal_file->number_of_decompressed_cluster_blocks += 1;
+
+		if( libqcow_internal_file_get_cluster_block_file_range(
+		     internal_file,
+		     decompression_task->read_segments[ 0 ].cluster_block_offset,
+		     1,
+		     &cluster_block_file_offset,
+		     &cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block file range.",
+			 function );
+
+			goto on_error;
+		}
+		/* Another read can have stored the cluster block in the cache in the meantime
+		 */
+		cache_entry = libqcow_block_cache_find_entry(
+		               internal_file->compressed_cluster_block_cache,
+		               cluster_block_file_offset );
+
+		if( ( cache_entry == NULL )
+		 || ( cache_entry->value == NULL ) )
+		{
+			if( libqcow_block_cache_set_value_by_key(
+			     internal_file->compressed_cluster_block_cache,
+			     cluster_block_file_offset,
+			     (intptr_t *) decompression_task->cluster_block,
+			     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set cluster block in cache.",
+				 function );
+
+				goto on_error;
+			}
+			/* The cache now manages the cluster block
+			 */
+			decompression_task->cluster_block = NULL;
+		}
+		else if( libqcow_cluster_block_free(
+		          &( decompression_task->cluster_block ),
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	cache_mutex_grabbed = 0;
+
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	memory_free(
+	 decompression_tasks );
+
+	return( 1 );
+
+on_error:
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+	if( decompression_tasks != NULL )
+	{
+		/* The worker threads reference the tasks until they have been processed
+		 */
+		if( decompression_batch.number_of_pending_tasks > 0 )
+		{
+			libqcow_decompression_pool_wait_for_batch(
+			 internal_file->decompression_pool,
+			 &decompression_batch,
+			 NULL );
+		}
+		for( task_index = 0;
+		     task_index < number_of_tasks;
+		     task_index++ )
+		{
+			decompression_task = &( decompression_tasks[ task_index ] );
+
+			if( decompression_task->cluster_block != NULL )
+			{
+				libqcow_cluster_block_free(
+				 &( decompression_task->cluster_block ),
+				 NULL );
+			}
+		}
+		memory_free(
+		 decompression_tasks );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	for( read_segment_index = 0;
+	     read_segment_index < number_of_read_segments;
+	     read_segment_index++ )
+	{
+		read_segments[ read_segment_index ].is_decompressed = 0;
+	}
+	return( -1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+/* Reads (media) data at a specific offset into a buffer directly from a raw file
+ * The raw file is either a raw external data file or a raw parent (backing) file,
+ * both store the media data at the same offset, data beyond the end of the raw file reads as zero
+ * This function does not use the caches and does not modify the current offset
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *raw_file_io_handle,
+         size64_t raw_file_size,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle";
+	size_t read_size      = 0;
+	ssize_t read_count    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( raw_file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid raw file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( buffer_size == 0 )
+	 || ( (size64_t) offset >= internal_file->media_size ) )
+	{
+		return( 0 );
+	}
+	read_size = buffer_size;
+
+	if( (size64_t) read_size > ( internal_file->media_size - offset ) )
+	{
+		read_size = (size_t) ( internal_file->media_size - offset );
+	}
+	if( (size64_t) offset < raw_file_size )
+	{
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              raw_file_io_handle,
+		              buffer,
+		              read_size,
+		              offset,
+		              error );
+
+		if( read_count < 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read raw file at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+	}
+	/* Handle data beyond the end of the raw file
+	 */
+	if( (size_t) read_count < read_size )
+	{
+		if( memory_set(
+		     &( ( (uint8_t *) buffer )[ read_count ] ),
+		     0,
+		     read_size - (size_t) read_count ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to set sparse data in buffer.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( (ssize_t) read_size );
+}
+
+/* Reads (media) data at a specific offset into a buffer using a Basic File IO (bfio) handle
+ * This function does not modify the current offset and can be called with the read lock acquired
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_at_offset_from_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	static char *function     = "libqcow_internal_file_read_buffer_at_offset_from_file_io_handle";
+	size_t backing_range_size = 0;
+	size_t buffer_offset      = 0;
+	size_t read_size          = 0;
+	size_t remaining_size     = 0;
+	ssize_t read_count        = 0;
+	int result                = 0;
+
+#if defined( HAVE_LIBQCOW_IO_URING ) || defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_read_vector_t read_vector;
+
+	uint8_t read_as_read_vector = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( ( internal_file->parent_file == NULL )
+		 && ( internal_file->parent_file_io_handle == NULL ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	{
+		if( internal_file->data_file_io_handle == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing data file IO handle.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= internal_file->media_size )
+	{
+		return( 0 );
+	}
+	if( ( internal_file->data_file_is_raw != 0 )
+	 && ( internal_file->selected_snapshot_index < 0 ) )
+	{
+		read_count = libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+		              internal_file,
+		              internal_file->data_file_io_handle,
+		              internal_file->data_file_size,
+		              buffer,
+		              buffer_size,
+		              offset,
+		              error );
+
+		if( read_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer at offset: %" PRIi64 " (0x%08" PRIx64 ") from data file.",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		return( read_count );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->readahead != NULL )
+	{
+		if( libqcow_readahead_update(
+		     internal_file->readahead,
+		     offset,
+		     buffer_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to update readahead.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING )
+	/* A read that spans multiple cluster blocks is read as a read vector
+	 * so that the reads of its cluster blocks are in flight at the same time
+	 */
+	if( ( internal_file->io_uring != NULL )
+	 && ( file_io_handle == internal_file->file_io_handle )
+	 && ( internal_file->data_file_io_handle == NULL )
+	 && ( (size64_t) buffer_size > internal_file->cluster_block_size ) )
+	{
+		read_as_read_vector = 1;
+	}
+#endif
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* A read that spans multiple cluster blocks is read as a read vector
+	 * so that its compressed cluster blocks are decompressed in parallel
+	 */
+	if( ( internal_file->decompression_pool != NULL )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE )
+	 && ( (size64_t) buffer_size > internal_file->cluster_block_size ) )
+	{
+		read_as_read_vector = 1;
+	}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING ) || defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( read_as_read_vector != 0 )
+	{
+		read_vector.offset      = offset;
+		read_vector.buffer      = buffer;
+		read_vector.buffer_size = buffer_size;
+		read_vector.read_count  = 0;
+
+		if( libqcow_internal_file_read_vectors_from_file_io_handle(
+		     internal_file,
+		     file_io_handle,
+		     &read_vector,
+		     1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer at offset: %" PRIi64 " (0x%08" PRIx64 ") as read vector.",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		return( read_vector.read_count );
+	}
+#endif
+	while( buffer_offset < buffer_size )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
+			 function,
+			 offset,
+			 offset );
+		}
+#endif
+		remaining_size = buffer_size - buffer_offset;
+
+		if( ( (size64_t) offset + remaining_size ) > internal_file->media_size )
+		{
+			remaining_size = (size_t) ( internal_file->media_size - offset );
+		}
+		result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+		          internal_file,
+		          file_io_handle,
+		          offset,
+		          &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+		          remaining_size,
+		          &read_size,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read contiguous cluster blocks data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			offset        += read_size;
+			buffer_offset += read_size;
+
+			if( (size64_t) offset >= internal_file->media_size )
+			{
+				break;
+			}
+			continue;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* Prevent the cluster block from being read a second time while it is read ahead
+		 */
+		if( internal_file->readahead != NULL )
+		{
+			if( libqcow_readahead_wait_for_block(
+			     internal_file->readahead,
+			     offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to wait for readahead of cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 offset,
+				 offset );
+
+				return( -1 );
+			}
+		}
+#endif
+		/* For extended level 2 table entries only the allocated subclusters are read from the file
+		 */
+		read_size = (size_t) ( internal_file->subcluster_block_size - ( (uint64_t) offset & internal_file->subcluster_block_bit_mask ) );
+
+		if( read_size > remaining_size )
+		{
+			read_size = remaining_size;
+		}
+		result = libqcow_internal_file_read_cluster_block_data(
+		          internal_file,
+		          file_io_handle,
+		          offset,
+		          &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+		          read_size,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read cluster block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			read_count = 0;
+
+			if( ( internal_file->parent_file != NULL )
+			 || ( internal_file->parent_file_io_handle != NULL ) )
+			{
+				/* Extend the read to the cluster blocks that follow and that are also stored
+				 * in the backing file, so that the parent file is read once per range
+				 */
+				if( read_size < remaining_size )
+				{
+					if( libqcow_internal_file_get_backing_range_size(
+					     internal_file,
+					     file_io_handle,
+					     offset + (off64_t) read_size,
+					     remaining_size - read_size,
+					     &backing_range_size,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+						 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+						 "%s: unable to retrieve backing range size at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+						 function,
+						 offset + (off64_t) read_size,
+						 offset + (off64_t) read_size );
+
+						return( -1 );
+					}
+					read_size += backing_range_size;
+				}
+				if( internal_file->parent_file != NULL )
+				{
+					read_count = libqcow_file_read_buffer_at_offset_concurrent(
+						      internal_file->parent_file,
+						      &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+						      read_size,
+						      offset,
+						      error );
+				}
+				else
+				{
+					/* A raw parent file stores the media data at the same offset
+					 */
+					read_count = libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+						      internal_file,
+						      internal_file->parent_file_io_handle,
+						      internal_file->parent_file_size,
+						      &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+						      read_size,
+						      offset,
+						      error );
+				}
+				if( read_count == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read buffer from parent file.",
+					 function );
+
+					return( -1 );
+				}
+			}
+			/* Handle sparse cluster block or data beyond the end of the parent file
+			 */
+			if( (size_t) read_count < read_size )
+			{
+				if( memory_set(
+				     &( ( (uint8_t *) buffer )[ buffer_offset + (size_t) read_count ] ),
+				     0,
+				     read_size - (size_t) read_count ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set sparse data in buffer.",
+					 function );
+
+					return( -1 );
+				}
+			}
+		}
+		offset        += read_size;
+		buffer_offset += read_size;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "\n" );
+		}
+#endif
+		if( (size64_t) offset >= internal_file->media_size )
+		{
+			break;
+		}
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data from the current offset into a buffer using a Basic File IO (bfio) handle
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_read_buffer_from_file_io_handle";
+	ssize_t read_count    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->current_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - current offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	read_count = libqcow_internal_file_read_buffer_at_offset_from_file_io_handle(
+	              internal_file,
+	              file_io_handle,
+	              buffer,
+	              buffer_size,
+	              internal_file->current_offset,
+	              error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 internal_file->current_offset,
+		 internal_file->current_offset );
+
+		return( -1 );
+	}
+	internal_file->current_offset += (off64_t) read_count;
+
+	return( read_count );
+}
+
+/* Reads (media) data from the current offset into a buffer
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer";
+	ssize_t read_count                     = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+		      internal_file,
+		      internal_file->file_io_handle,
+		      buffer,
+		      buffer_size,
+		      error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		read_count = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data at a specific offset
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer_at_offset(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer_at_offset";
+	ssize_t read_count                     = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_seek_offset(
+	     internal_file,
+	     offset,
+	     SEEK_SET,
+	     error ) == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		read_count = -1;
+	}
+	else
+	{
+		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+			      internal_file,
+			      internal_file->file_io_handle,
+			      buffer,
+			      buffer_size,
+			      error );
+
+		if( read_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer.",
+			 function );
+
+			read_count = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data at a specific offset without changing the current offset
+ * Multiple threads can read from the same file concurrently
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer_at_offset_concurrent(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer_at_offset_concurrent";
+	ssize_t read_count                     = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	read_count = libqcow_internal_file_read_buffer_at_offset_from_file_io_handle(
+		      internal_file,
+		      internal_file->file_io_handle,
+		      buffer,
+		      buffer_size,
+		      offset,
+		      error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		read_count = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data of multiple read vectors using a Basic File IO (bfio) handle
+ * The read vectors are split into read segments per cluster block, the level 2 tables
+ * are retrieved once for consecutive segments and the cluster blocks are read in ascending
+ * file offset order, where adjacent uncompressed cluster blocks are read at once
+ * The cache mutex is only held to look up the level 2 tables and the cluster blocks in the caches
+ * and to store cluster blocks in the caches, the data is read without holding it
+ * This function does not modify the current offset and can be called with the read lock acquired
+ * On error the read count of the read vectors is -1
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_read_vectors_from_file_io_handle(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_read_vector_t *read_vectors,
+     int number_of_read_vectors,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *data_file_io_handle          = NULL;
+	libqcow_cluster_block_t *cluster_block         = NULL;
+	libqcow_cluster_table_t *level2_table          = NULL;
+	libqcow_read_segment_t *last_read_segment      = NULL;
+	libqcow_read_segment_t *read_segment           = NULL;
+	libqcow_read_segment_t *read_segments          = NULL;
+	libqcow_read_vector_t *parent_read_vector      = NULL;
+	libqcow_read_vector_t *parent_read_vectors     = NULL;
+	libqcow_read_vector_t *read_vector             = NULL;
+	uint8_t *coalesced_data                        = NULL;
+	uint8_t *read_data                             = NULL;
+	static char *function                          = "libqcow_internal_file_read_vectors_from_file_io_handle";
+	size64_t available_size                        = 0;
+	size64_t data_file_size                        = 0;
+	size_t number_of_parent_read_vectors           = 0;
+	size_t number_of_read_segments                 = 0;
+	size_t number_of_sparse_read_segments          = 0;
+	size_t last_read_segment_index                 = 0;
+	size_t read_segment_index                      = 0;
+	size_t read_size                               = 0;
+	size_t segment_size                            = 0;
+	ssize_t read_count                             = 0;
+	uint64_t coalesced_read_end_offset             = 0;
+	uint64_t coalesced_read_offset                 = 0;
+	uint64_t coalesced_read_size                   = 0;
+	uint64_t first_cluster_block_index             = 0;
+	uint64_t last_cluster_block_index              = 0;
+	uint64_t level1_table_index                    = 0;
+	uint64_t previous_level1_table_index           = 0;
+	off64_t offset                                 = 0;
+	int read_vector_index                          = 0;
+	int result                                     = 0;
+	uint8_t read_segments_are_sorted               = 1;
+
+#if defined( HAVE_LIBQCOW_IO_URING )
+	uint8_t io_uring_reads_queued                  = 0;
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	uint8_t cache_mutex_grabbed                    = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( ( internal_file->parent_file == NULL )
+		 && ( internal_file->parent_file_io_handle == NULL ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	{
+		if( internal_file->data_file_io_handle == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing data file IO handle.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( read_vectors == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read vectors.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_read_vectors < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid number of read vectors value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	for( read_vector_index = 0;
+	     read_vector_index < number_of_read_vectors;
+	     read_vector_index++ )
+	{
+		read_vectors[ read_vector_index ].read_count = -1;
+	}
+	if( ( internal_file->data_file_is_raw != 0 )
+	 && ( internal_file->selected_snapshot_index < 0 ) )
+	{
+		for( read_vector_index = 0;
+		     read_vector_index < number_of_read_vectors;
+		     read_vector_index++ )
+		{
+			read_vector = &( read_vectors[ read_vector_index ] );
+
+			read_vector->read_count = libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+			                           internal_file,
+			                           internal_file->data_file_io_handle,
+			                           internal_file->data_file_size,
+			                           read_vector->buffer,
+			                           read_vector->buffer_size,
+			                           read_vector->offset,
+			                           error );
+
+			if( read_vector->read_count == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read vector: %d from data file.",
+				 function,
+				 read_vector_index );
+
+				return( -1 );
+			}
+		}
+		return( 1 );
+	}
+	/* The level 2 tables are stored in the image file while the cluster block data
+	 * of an image with an external data file is stored in the data file
+	 */
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		data_file_io_handle = internal_file->data_file_io_handle;
+		data_file_size      = internal_file->data_file_size;
+	}
+	else
+	{
+		data_file_io_handle = file_io_handle;
+		data_file_size      = internal_file->size;
+	}
+	/* Determine the number of read segments
+	 */
+	for( read_vector_index = 0;
+	     read_vector_index < number_of_read_vectors;
+	     read_vector_index++ )
+	{
+		read_vector = &( read_vectors[ read_vector_index ] );
+
+		if( read_vector->buffer == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+			 "%s: invalid read vector: %d - missing buffer.",
+			 function,
+			 read_vector_index );
+
+			return( -1 );
+		}
+		if( read_vector->buffer_size > (size_t) SSIZE_MAX )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid read vector: %d - buffer size value exceeds maximum.",
+			 function,
+			 read_vector_index );
+
+			return( -1 );
+		}
+		if( read_vector->offset < 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid read vector: %d - offset value out of bounds.",
+			 function,
+			 read_vector_index );
+
+			return( -1 );
+		}
+		if( ( read_vector->buffer_size == 0 )
+		 || ( (size64_t) read_vector->offset >= internal_file->media_size ) )
+		{
+			continue;
+		}
+		read_size = read_vector->buffer_size;
+
+		if( (size64_t) read_size > ( internal_file->media_size - read_vector->offset ) )
+		{
+			read_size = (size_t) ( internal_file->media_size - read_vector->offset );
+		}
+		/* For extended level 2 table entries the read segments do not cross a subcluster boundary
+		 */
+		first_cluster_block_index = (uint64_t) read_vector->offset / internal_file->subcluster_block_size;
+		last_cluster_block_index  = ( (uint64_t) read_vector->offset + read_size - 1 ) / internal_file->subcluster_block_size;
+
+		number_of_read_segments += (size_t) ( last_cluster_block_index - first_cluster_block_index + 1 );
+
+		if( ( number_of_read_segments > (size_t) INT_MAX )
+		 || ( number_of_read_segments > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_read_segment_t ) ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid number of read segments value exceeds maximum.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( number_of_read_segments > 0 )
+	{
+		read_segments = (libqcow_read_segment_t *) memory_allocate(
+		                                            sizeof( libqcow_read_segment_t ) * number_of_read_segments );
+
+		if( read_segments == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create read segments.",
+			 function );
+
+			goto on_error;
+		}
+		/* Split the read vectors into read segments that do not cross a cluster block boundary
+		 */
+		read_segment_index = 0;
+
+		for( read_vector_index = 0;
+		     read_vector_index < number_of_read_vectors;
+		     read_vector_index++ )
+		{
+			read_vector = &( read_vectors[ read_vector_index ] );
+
+			if( ( read_vector->buffer_size == 0 )
+			 || ( (size64_t) read_vector->offset >= internal_file->media_size ) )
+			{
+				continue;
+			}
+			read_size = read_vector->buffer_size;
+
+			if( (size64_t) read_size > ( internal_file->media_size - read_vector->offset ) )
+			{
+				read_size = (size_t) ( internal_file->media_size - read_vector->offset );
+			}
+			offset   = read_vector->offset;
+			read_data = (uint8_t *) read_vector->buffer;
+
+			while( read_size > 0 )
+			{
+				segment_size = (size_t) ( internal_file->subcluster_block_size - ( (uint64_t) offset & internal_file->subcluster_block_bit_mask ) );
+
+				if( segment_size > read_size )
+				{
+					segment_size = read_size;
+				}
+				read_segment = &( read_segments[ read_segment_index++ ] );
+
+				read_segment->media_offset                = offset;
+				read_segment->file_offset                 = 0;
+				read_segment->cluster_block_offset        = 0;
+				read_segment->cluster_block_data_offset   = 0;
+				read_segment->buffer                      = read_data;
+				read_segment->size                        = segment_size;
+				read_segment->vector_index                = read_vector_index;
+				read_segment->cluster_block_is_compressed = 0;
+				read_segment->cluster_block_is_zero       = 0;
+				read_segment->is_decompressed             = 0;
+
+				if( ( read_segment_index > 1 )
+				 && ( libqcow_read_segment_compare_by_media_offset(
+				       &( read_segments[ read_segment_index - 2 ] ),
+				       read_segment ) > 0 ) )
+				{
+					read_segments_are_sorted = 0;
+				}
+				offset    += segment_size;
+				read_data += segment_size;
+				read_size -= segment_size;
+			}
+		}
+		/* Sort the read segments by media offset so that read segments that
+		 * share a level 2 table are consecutive
+		 */
+		if( read_segments_are_sorted == 0 )
+		{
+			qsort(
+			 read_segments,
+			 number_of_read_segments,
+			 sizeof( libqcow_read_segment_t ),
+			 &libqcow_read_segment_compare_by_media_offset );
+		}
+		read_segments_are_sorted = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_grab(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab cache mutex.",
+			 function );
+
+			goto on_error;
+		}
+		cache_mutex_grabbed = 1;
+#endif
+		for( read_segment_index = 0;
+		     read_segment_index < number_of_read_segments;
+		     read_segment_index++ )
+		{
+			read_segment = &( read_segments[ read_segment_index ] );
+
+			level1_table_index = (uint64_t) read_segment->media_offset >> internal_file->level1_index_bit_shift;
+
+			if( ( read_segment_index == 0 )
+			 || ( level1_table_index != previous_level1_table_index ) )
+			{
+				result = libqcow_internal_file_get_level2_table_by_index(
+				          internal_file,
+				          file_io_handle,
+				          level1_table_index,
+				          &level2_table,
+				          error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+					 function,
+					 level1_table_index );
+
+					goto on_error;
+				}
+				previous_level1_table_index = level1_table_index;
+			}
+			if( libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+			     internal_file,
+			     level2_table,
+			     read_segment->media_offset,
+			     &( read_segment->cluster_block_offset ),
+			     &( read_segment->cluster_block_data_offset ),
+			     &( read_segment->cluster_block_is_compressed ),
+			     &( read_segment->cluster_block_is_zero ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 read_segment->media_offset,
+				 read_segment->media_offset );
+
+				goto on_error;
+			}
+			if( read_segment->cluster_block_offset == 0 )
+			{
+				read_segment->file_offset = 0;
+			}
+			else if( read_segment->cluster_block_is_compressed != 0 )
+			{
+				read_segment->file_offset = read_segment->cluster_block_offset & internal_file->compression_bit_mask;
+			}
+			else
+			{
+				read_segment->file_offset = read_segment->cluster_block_offset + read_segment->cluster_block_data_offset;
+			}
+			if( ( read_segment_index > 0 )
+			 && ( libqcow_read_segment_compare_by_file_offset(
+			       &( read_segments[ read_segment_index - 1 ] ),
+			       read_segment ) > 0 ) )
+			{
+				read_segments_are_sorted = 0;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* The level 2 tables can be evicted once the cache mutex is released,
+		 * the cluster block data is read without holding it
+		 */
+		cache_mutex_grabbed = 0;
+
+		if( libcthreads_mutex_release(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release cache mutex.",
+			 function );
+
+			goto on_error;
+		}
+#endif
+		/* Sort the read segments by file offset, sparse read segments are stored first
+		 * followed by the read segments that read as zero
+		 */
+		if( read_segments_are_sorted == 0 )
+		{
+			qsort(
+			 read_segments,
+			 number_of_read_segments,
+			 sizeof( libqcow_read_segment_t ),
+			 &libqcow_read_segment_compare_by_file_offset );
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* Decompress the compressed cluster blocks in parallel, the decompressed
+		 * data is stored directly into the buffers of the read segments
+		 */
+		if( ( internal_file->decompression_pool != NULL )
+		 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+		{
+			if( libqcow_internal_file_decompress_read_segments(
+			     internal_file,
+			     data_file_io_handle,
+			     read_segments,
+			     number_of_read_segments,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+				 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+				 "%s: unable to decompress read segments.",
+				 function );
+
+				goto on_error;
+			}
+		}
+#endif
+		read_segment_index = 0;
+
+		while( read_segment_index < number_of_read_segments )
+		{
+			read_segment = &( read_segments[ read_segment_index ] );
+
+			if( read_segment->cluster_block_is_zero != 0 )
+			{
+				if( memory_set(
+				     read_segment->buffer,
+				     0,
+				     read_segment->size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set zero data in buffer.",
+					 function );
+
+					goto on_error;
+				}
+				read_segment_index++;
+
+				continue;
+			}
+			else if( read_segment->file_offset == 0 )
+			{
+				number_of_sparse_read_segments++;
+
+				read_segment_index++;
+
+				continue;
+			}
+			else if( read_segment->is_decompressed != 0 )
+			{
+				read_segment_index++;
+
+				continue;
+			}
+			if( ( read_segment->cluster_block_is_compressed != 0 )
+			 || ( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+			{
+				/* Compressed and encrypted cluster blocks are read by the cluster block caches
+				 */
+				if( libqcow_internal_file_read_cached_cluster_block_data(
+				     internal_file,
+				     data_file_io_handle,
+				     read_segment->cluster_block_offset,
+				     read_segment->cluster_block_data_offset,
+				     read_segment->media_offset - (off64_t) read_segment->cluster_block_data_offset,
+				     read_segment->cluster_block_is_compressed,
+				     read_segment->buffer,
+				     read_segment->size,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read cluster block data.",
+					 function );
+
+					goto on_error;
+				}
+				read_segment_index++;
+
+				continue;
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_mutex_grab(
+			     internal_file->cache_mutex,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab cache mutex.",
+				 function );
+
+				goto on_error;
+			}
+			cache_mutex_grabbed = 1;
+#endif
+			/* An uncompressed cluster block can be stored in the cache by readahead
+			 */
+			result = libqcow_block_cache_get_value_by_key(
+			          internal_file->cluster_block_cache,
+			          read_segment->cluster_block_offset,
+			          (intptr_t **) &cluster_block,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block at offset: %" PRIu64 " (0x%08" PRIx64 ") from cache.",
+				 function,
+				 read_segment->cluster_block_offset,
+				 read_segment->cluster_block_offset );
+
+				goto on_error;
+			}
+			else if( result != 0 )
+			{
+				if( libqcow_cluster_block_copy_data(
+				     cluster_block,
+				     (size_t) read_segment->cluster_block_data_offset,
+				     read_segment->buffer,
+				     read_segment->size,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_COPY_FAILED,
+					 "%s: unable to copy cluster block data.",
+					 function );
+
+					goto on_error;
+				}
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			cache_mutex_grabbed = 0;
+
+			if( libcthreads_mutex_release(
+			     internal_file->cache_mutex,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release cache mutex.",
+				 function );
+
+				goto on_error;
+			}
+#endif
+			if( result != 0 )
+			{
+				read_segment_index++;
+
+				continue;
+			}
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+			/* With a mapped file the read segment is copied directly from the mapped data
+			 */
+			if( ( internal_file->mapped_file != NULL )
+			 && ( data_file_io_handle == internal_file->file_io_handle ) )
+			{
+				available_size = read_segment->size;
+
+				/* For version 2 and 3 the last cluster block in the file can be smaller
+				 * than the cluster block size
+				 */
+				if( ( ( internal_file->file_header->format_version == 2 )
+				  ||  ( internal_file->file_header->format_version == 3 ) )
+				 && ( ( read_segment->file_offset + read_segment->size ) > data_file_size ) )
+				{
+					if( read_segment->file_offset < data_file_size )
+					{
+						available_size = data_file_size - read_segment->file_offset;
+					}
+					else
+					{
+						available_size = 0;
+					}
+				}
+				result = 1;
+
+				if( available_size > 0 )
+				{
+					result = libqcow_mapped_file_copy_data_at_offset(
+					          internal_file->mapped_file,
+					          (off64_t) read_segment->file_offset,
+					          read_segment->buffer,
+					          (size_t) available_size,
+					          error );
+
+					if( result == -1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_READ_FAILED,
+						 "%s: unable to copy mapped cluster block data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+						 function,
+						 read_segment->file_offset,
+						 read_segment->file_offset );
+
+						goto on_error;
+					}
+				}
+				if( result != 0 )
+				{
+					if( available_size < read_segment->size )
+					{
+						if( memory_set(
+						     &( read_segment->buffer[ available_size ] ),
+						     0,
+						     (size_t) ( read_segment->size - available_size ) ) == NULL )
+						{
+							libcerror_error_set(
+							 error,
+							 LIBCERROR_ERROR_DOMAIN_MEMORY,
+							 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+							 "%s: unable to clear remainder of cluster block data.",
+							 function );
+
+							goto on_error;
+						}
+					}
+					read_segment_index++;
+
+					continue;
+				}
+			}
+#endif
+#if defined( HAVE_LIBQCOW_IO_URING )
+			/* With io_uring the read segment is read directly into its buffer
+			 * and the io_uring merges the reads of adjacent cluster blocks
+			 */
+			if( ( internal_file->io_uring != NULL )
+			 && ( data_file_io_handle == internal_file->file_io_handle ) )
+			{
+				available_size = read_segment->size;
+
+				/* For version 2 and 3 the last cluster block in the file can be smaller
+				 * than the cluster block size
+				 */
+				if( ( ( internal_file->file_header->format_version == 2 )
+				  ||  ( internal_file->file_header->format_version == 3 ) )
+				 && ( ( read_segment->file_offset + read_segment->size ) > data_file_size ) )
+				{
+					if( read_segment->file_offset < data_file_size )
+					{
+						available_size = data_file_size - read_segment->file_offset;
+					}
+					else
+					{
+						available_size = 0;
+					}
+				}
+				if( available_size > 0 )
+				{
+					/* The io_uring is grabbed until the queued reads are submitted
+					 */
+					if( io_uring_reads_queued == 0 )
+					{
+						if( libqcow_io_uring_grab(
+						     internal_file->io_uring,
+						     error ) != 1 )
+						{
+							libcerror_error_set(
+							 error,
+							 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+							 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+							 "%s: unable to grab io_uring.",
+							 function );
+
+							goto on_error;
+						}
+						io_uring_reads_queued = 1;
+					}
+					if( libqcow_io_uring_append_read(
+					     internal_file->io_uring,
+					     (off64_t) read_segment->file_offset,
+					     read_segment->buffer,
+					     (size_t) available_size,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_READ_FAILED,
+						 "%s: unable to queue read of cluster block data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+						 function,
+						 read_segment->file_offset,
+						 read_segment->file_offset );
+
+						goto on_error;
+					}
+				}
+				if( available_size < read_segment->size )
+				{
+					if( memory_set(
+					     &( read_segment->buffer[ available_size ] ),
+					     0,
+					     (size_t) ( read_segment->size - available_size ) ) == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+						 "%s: unable to clear remainder of cluster block data.",
+						 function );
+
+						goto on_error;
+					}
+				}
+				read_segment_index++;
+
+				continue;
+			}
+#endif
+			/* Coalesce the read segments of adjacent uncompressed cluster blocks into a single read
+			 */
+			coalesced_read_offset     = read_segment->file_offset;
+			coalesced_read_end_offset = read_segment->file_offset + read_segment->size;
+			last_read_segment_index   = read_segment_index;
+
+			while( ( last_read_segment_index + 1 ) < number_of_read_segments )
+			{
+				last_read_segment = &( read_segments[ last_read_segment_index + 1 ] );
+
+				if( ( last_read_segment->cluster_block_is_compressed != 0 )
+				 || ( last_read_segment->file_offset > coalesced_read_end_offset ) )
+				{
+					break;
+				}
+				if( ( last_read_segment->file_offset + last_read_segment->size ) > coalesced_read_end_offset )
+				{
+					if( ( last_read_segment->file_offset + last_read_segment->size - coalesced_read_offset ) > LIBQCOW_MAXIMUM_COALESCED_READ_SIZE )
+					{
+						break;
+					}
+					coalesced_read_end_offset = last_read_segment->file_offset + last_read_segment->size;
+				}
+				last_read_segment_index++;
+			}
+			coalesced_read_size = coalesced_read_end_offset - coalesced_read_offset;
+			available_size      = coalesced_read_size;
+
+			/* For version 2 and 3 the last cluster block in the file can be smaller
+			 * than the cluster block size
+			 */
+			if( ( ( internal_file->file_header->format_version == 2 )
+			  ||  ( internal_file->file_header->format_version == 3 ) )
+			 && ( coalesced_read_end_offset > data_file_size ) )
+			{
+				if( coalesced_read_offset < data_file_size )
+				{
+					available_size = data_file_size - coalesced_read_offset;
+				}
+				else
+				{
+					available_size = 0;
+				}
+			}
+			if( last_read_segment_index == read_segment_index )
+			{
+				read_data = read_segment->buffer;
+			}
+			else
+			{
+				if( coalesced_data == NULL )
+				{
+					coalesced_data = (uint8_t *) memory_allocate(
+					                              sizeof( uint8_t ) * LIBQCOW_MAXIMUM_COALESCED_READ_SIZE );
+
+					if( coalesced_data == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+						 "%s: unable to create coalesced data.",
+						 function );
+
+						goto on_error;
+					}
+				}
+				read_data = coalesced_data;
+			}
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: reading %" PRIzd " segments at offset: %" PRIu64 " (0x%08" PRIx64 ") of size: %" PRIu64 "\n",
+				 function,
+				 last_read_segment_index - read_segment_index + 1,
+				 coalesced_read_offset,
+				 coalesced_read_offset,
+				 coalesced_read_size );
+			}
+#endif
+			if( available_size > 0 )
+			{
+				read_count = libbfio_handle_read_buffer_at_offset(
+				              data_file_io_handle,
+				              read_data,
+				              (size_t) available_size,
+				              (off64_t) coalesced_read_offset,
+				              error );
+
+				if( read_count != (ssize_t) available_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read cluster block data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+					 function,
+					 coalesced_read_offset,
+					 coalesced_read_offset );
+
+					goto on_error;
+				}
+			}
+			if( available_size < coalesced_read_size )
+			{
+				if( memory_set(
+				     &( read_data[ available_size ] ),
+				     0,
+				     (size_t) ( coalesced_read_size - available_size ) ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to clear remainder of cluster block data.",
+					 function );
+
+					goto on_error;
+				}
+			}
+			if( read_data == coalesced_data )
+			{
+				while( read_segment_index <= last_read_segment_index )
+				{
+					read_segment = &( read_segments[ read_segment_index ] );
+
+					if( memory_copy(
+					     read_segment->buffer,
+					     &( coalesced_data[ read_segment->file_offset - coalesced_read_offset ] ),
+					     read_segment->size ) == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+						 "%s: unable to copy cluster block data to buffer.",
+						 function );
+
+						goto on_error;
+					}
+					read_segment_index++;
+				}
+			}
+			read_segment_index = last_read_segment_index + 1;
+		}
+#if defined( HAVE_LIBQCOW_IO_URING )
+		if( io_uring_reads_queued != 0 )
+		{
+			if( libqcow_io_uring_submit(
+			     internal_file->io_uring,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read cluster block data using io_uring.",
+				 function );
+
+				goto on_error;
+			}
+			io_uring_reads_queued = 0;
+
+			if( libqcow_io_uring_release(
+			     internal_file->io_uring,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release io_uring.",
+				 function );
+
+				goto on_error;
+			}
+		}
+#endif
+	}
+	/* The sparse read segments are read from the parent file as a single batch,
+	 * they are stored first and ordered by media offset
+	 */
+	if( ( number_of_sparse_read_segments > 0 )
+	 && ( ( internal_file->parent_file != NULL )
+	  ||  ( internal_file->parent_file_io_handle != NULL ) ) )
+	{
+		parent_read_vectors = (libqcow_read_vector_t *) memory_allocate(
+		                                                 sizeof( libqcow_read_vector_t ) * number_of_sparse_read_segments );
+
+		if( parent_read_vectors == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create parent read vectors.",
+			 function );
+
+			goto on_error;
+		}
+		for( read_segment_index = 0;
+		     read_segment_index < number_of_sparse_read_segments;
+		     read_segment_index++ )
+		{
+			read_segment = &( read_segments[ read_segment_index ] );
+
+			/* Merge read segments that continue the previous parent read vector
+			 */
+			if( ( parent_read_vector != NULL )
+			 && ( ( parent_read_vector->offset + (off64_t) parent_read_vector->buffer_size ) == read_segment->media_offset )
+			 && ( &( ( (uint8_t *) parent_read_vector->buffer )[ parent_read_vector->buffer_size ] ) == read_segment->buffer ) )
+			{
+				parent_read_vector->buffer_size += read_segment->size;
+
+				continue;
+			}
+			parent_read_vector = &( parent_read_vectors[ number_of_parent_read_vectors++ ] );
+
+			parent_read_vector->offset      = read_segment->media_offset;
+			parent_read_vector->buffer      = read_segment->buffer;
+			parent_read_vector->buffer_size = read_segment->size;
+			parent_read_vector->read_count  = 0;
+		}
+		if( internal_file->parent_file != NULL )
+		{
+			if( libqcow_file_read_vectors(
+			     internal_file->parent_file,
+			     parent_read_vectors,
+			     (int) number_of_parent_read_vectors,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read vectors from parent file.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		else
+		{
+			/* A raw parent file stores the media data at the same offset
+			 */
+			for( read_segment_index = 0;
+			     read_segment_index < number_of_parent_read_vectors;
+			     read_segment_index++ )
+			{
+				parent_read_vector = &( parent_read_vectors[ read_segment_index ] );
+
+				parent_read_vector->read_count = libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+				                                  internal_file,
+				                                  internal_file->parent_file_io_handle,
+				                                  internal_file->parent_file_size,
+				                                  parent_read_vector->buffer,
+				                                  parent_read_vector->buffer_size,
+				                                  parent_read_vector->offset,
+				                                  error );
+
+				if( parent_read_vector->read_count == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read buffer from parent file at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 parent_read_vector->offset,
+					 parent_read_vector->offset );
+
+					goto on_error;
+				}
+			}
+		}
+		/* Handle data beyond the end of the parent file
+		 */
+		for( read_segment_index = 0;
+		     read_segment_index < number_of_parent_read_vectors;
+		     read_segment_index++ )
+		{
+			parent_read_vector = &( parent_read_vectors[ read_segment_index ] );
+
+			if( (size_t) parent_read_vector->read_count < parent_read_vector->buffer_size )
+			{
+				if( memory_set(
+				     &( ( (uint8_t *) parent_read_vector->buffer )[ parent_read_vector->read_count ] ),
+				     0,
+				     parent_read_vector->buffer_size - (size_t) parent_read_vector->read_count ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set sparse data in buffer.",
+					 function );
+
+					goto on_error;
+				}
+			}
+		}
+		memory_free(
+		 parent_read_vectors );
+
+		parent_read_vectors = NULL;
+	}
+	else
+	{
+		for( read_segment_index = 0;
+		     read_segment_index < number_of_sparse_read_segments;
+		     read_segment_index++ )
+		{
+			read_segment = &( read_segments[ read_segment_index ] );
+
+			if( memory_set(
+			     read_segment->buffer,
+			     0,
+			     read_segment->size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to set sparse data in buffer.",
+				 function );
+
+				goto on_error;
+			}
+		}
+	}
+	if( coalesced_data != NULL )
+	{
+		memory_free(
+		 coalesced_data );
+	}
+	if( read_segments != NULL )
+	{
+		memory_free(
+		 read_segments );
+	}
+	for( read_vector_index = 0;
+	     read_vector_index < number_of_read_vectors;
+	     read_vector_index++ )
+	{
+		read_vector = &( read_vectors[ read_vector_index ] );
+
+		read_vector->read_count = 0;
+
+		if( (size64_t) read_vector->offset < internal_file->media_size )
+		{
+			read_size = read_vector->buffer_size;
+
+			if( (size64_t) read_size > ( internal_file->media_size - read_vector->offset ) )
+			{
+				read_size = (size_t) ( internal_file->media_size - read_vector->offset );
+			}
+			read_vector->read_count = (ssize_t) read_size;
+		}
+	}
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_IO_URING )
+	/* Reads that were queued but not submitted reference the buffers of the read vectors
+	 */
+	if( io_uring_reads_queued != 0 )
+	{
+		libqcow_io_uring_discard_reads(
+		 internal_file->io_uring,
+		 NULL );
+
+		libqcow_io_uring_release(
+		 internal_file->io_uring,
+		 NULL );
+	}
+#endif
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( cache_mutex_grabbed != 0 )
+	{
+		libcthreads_mutex_release(
+		 internal_file->cache_mutex,
+		 NULL );
+	}
+#endif
+	if( parent_read_vectors != NULL )
+	{
+		memory_free(
+		 parent_read_vectors );
+	}
+	if( coalesced_data != NULL )
+	{
+		memory_free(
+		 coalesced_data );
+	}
+	if( read_segments != NULL )
+	{
+		memory_free(
+		 read_segments );
+	}
+	return( -1 );
+}
+
+/* Reads (media) data of multiple read vectors without changing the current offset
+ * Every read vector contains an offset, a buffer and a buffer size, on return its read count
+ * contains the number of bytes read, which is 0 if the offset is beyond the end of the media data
+ * The read vectors are read at once, taking the read lock a single time, and the underlying data
+ * is read in ascending file offset order with adjacent cluster blocks being read together
+ * Multiple threads can read from the same file concurrently
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_read_vectors(
+     libqcow_file_t *file,
+     libqcow_read_vector_t *read_vectors,
+     int number_of_read_vectors,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_vectors";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_read_vectors_from_file_io_handle(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     read_vectors,
+	     number_of_read_vectors,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read vectors.",
+		 function );
+
+		result = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves a pointer to the memory-mapped (media) data at a specific offset
+ * The data is only available for an uncompressed and unencrypted cluster block of a memory-mapped file,
+ * the data size is the remainder of the cluster block or for extended level 2 table entries of the subcluster.
+ * The data is read-only and remains valid until the file is closed. This function does not modify the current offset
+ * Returns 1 if successful, 0 if the data is not available or -1 on error
+ */
+int libqcow_file_get_mapped_data_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_mapped_data_at_offset";
+	size_t mapped_data_size                = 0;
+	uint64_t cluster_block_data_offset     = 0;
+	uint64_t cluster_block_file_offset     = 0;
+	uint8_t cluster_block_is_compressed    = 0;
+	uint8_t cluster_block_is_zero          = 0;
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	/* The cluster block data of an image with an external data file is not stored in the mapped file
+	 */
+	if( ( internal_file->mapped_file == NULL )
+	 || ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	 || ( (size64_t) offset >= internal_file->media_size ) )
+	{
+		return( 0 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+#endif
+	result = libqcow_internal_file_get_cluster_block_offset(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          offset,
+	          &cluster_block_file_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_is_compressed,
+	          &cluster_block_is_zero,
+	          error );
+
+	if( result != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		result = -1;
+	}
+	else if( ( cluster_block_file_offset == 0 )
+	      || ( cluster_block_is_compressed != 0 )
+	      || ( cluster_block_is_zero != 0 ) )
+	{
+		result = 0;
+	}
+	else
+	{
+		mapped_data_size = (size_t) ( internal_file->subcluster_block_size - ( (uint64_t) offset & internal_file->subcluster_block_bit_mask ) );
+
+		if( (size64_t) mapped_data_size > ( internal_file->media_size - offset ) )
+		{
+			mapped_data_size = (size_t) ( internal_file->media_size - offset );
+		}
+		result = libqcow_mapped_file_get_data_at_offset(
+		          internal_file->mapped_file,
+		          (off64_t) ( cluster_block_file_offset + cluster_block_data_offset ),
+		          mapped_data_size,
+		          data,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve mapped cluster block data.",
+			 function );
+		}
+		else if( result != 0 )
+		{
+			*data_size = mapped_data_size;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+#endif /* defined( HAVE_LIBQCOW_MAPPED_FILE ) */
+
+	return( result );
+}
+
+/* Grows the reference count table
+ * The grown reference count table is stored in newly allocated clusters, the previous
+ * reference count table is freed once the file header refers to the new location
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_grow_reference_count_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     int minimum_number_of_references,
+     libcerror_error_t **error )
+{
+	libqcow_reference_count_block_t **reference_count_blocks = NULL;
+	static char *function                                    = "libqcow_internal_file_grow_reference_count_table";
+	uint64_t number_of_clusters                              = 0;
+	uint64_t number_of_references                            = 0;
+	uint64_t number_of_table_clusters                        = 0;
+	uint64_t references_per_cluster                          = 0;
+	uint64_t reference_count_table_offset                    = 0;
+	uint64_t unused_table_offset                             = 0;
+	uint64_t unused_table_clusters                           = 0;
+	uint64_t table_cluster_index                             = 0;
+	int previous_number_of_references                        = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing reference count table.",
+		 function );
+
+		return( -1 );
+	}
+	if( minimum_number_of_references <= 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid minimum number of references value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	previous_number_of_references = internal_file->reference_count_table->number_of_references;
+	references_per_cluster        = internal_file->cluster_block_size / 8;
+
+	number_of_references = (uint64_t) previous_number_of_references * 2;
+
+	if( number_of_references < (uint64_t) minimum_number_of_references )
+	{
+		number_of_references = (uint64_t) minimum_number_of_references;
+	}
+	/* The grown reference count table must be able to refer to the reference count blocks
+	 * of the clusters of the file, the table itself and the reference count blocks needed
+	 * to describe them
+	 */
+	do
+	{
+		number_of_table_clusters = ( number_of_references + references_per_cluster - 1 ) / references_per_cluster;
+		number_of_references     = number_of_table_clusters * references_per_cluster;
+
+		number_of_clusters  = ( internal_file->next_cluster_offset >> internal_file->file_header->number_of_cluster_block_bits )
+		                    + number_of_table_clusters;
+		number_of_clusters += ( number_of_clusters >> internal_file->number_of_reference_count_block_bits ) + 2;
+
+		if( ( number_of_references << internal_file->number_of_reference_count_block_bits ) >= number_of_clusters )
+		{
+			break;
+		}
+		number_of_references *= 2;
+	}
+	while( number_of_references <= (uint64_t) INT_MAX );
+
+	if( ( number_of_references > (uint64_t) INT_MAX )
+	 || ( number_of_table_clusters > (uint64_t) UINT32_MAX )
+	 || ( number_of_references > ( (uint64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_reference_count_block_t * ) ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of reference count table references value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	reference_count_table_offset = internal_file->next_cluster_offset;
+
+	internal_file->next_cluster_offset += number_of_table_clusters * internal_file->cluster_block_size;
+
+	if( internal_file->previous_reference_count_table_offset == 0 )
+	{
+		/* The current reference count table is freed after the file header is written
+		 */
+		internal_file->previous_reference_count_table_offset   = internal_file->file_header->reference_count_table_offset;
+		internal_file->previous_reference_count_table_clusters = internal_file->file_header->reference_count_table_clusters;
+	}
+	else
+	{
+		/* The current reference count table was never referenced by the file header
+		 * and can be freed directly
+		 */
+		unused_table_offset   = (uint64_t) internal_file->file_header->reference_count_table_offset;
+		unused_table_clusters = (uint64_t) internal_file->file_header->reference_count_table_clusters;
+	}
+	if( libqcow_cluster_table_resize(
+	     internal_file->reference_count_table,
+	     (size_t) ( number_of_table_clusters * internal_file->cluster_block_size ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+		 "%s: unable to resize reference count table.",
+		 function );
+
+		return( -1 );
+	}
+	reference_count_blocks = (libqcow_reference_count_block_t **) memory_reallocate(
+	                                                               internal_file->reference_count_blocks,
+	                                                               sizeof( libqcow_reference_count_block_t * ) * (size_t) number_of_references );
+
+	if( reference_count_blocks == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to resize reference count blocks.",
+		 function );
+
+		/* Keep the number of references consistent with the reference count blocks
+		 */
+		internal_file->reference_count_table->number_of_references = previous_number_of_references;
+
+		return( -1 );
+	}
+	internal_file->reference_count_blocks = reference_count_blocks;
+
+	if( memory_set(
+	     &( reference_count_blocks[ previous_number_of_references ] ),
+	     0,
+	     sizeof( libqcow_reference_count_block_t * ) * ( (size_t) number_of_references - previous_number_of_references ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear reference count blocks.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file->file_header->reference_count_table_offset   = (off64_t) reference_count_table_offset;
+	internal_file->file_header->reference_count_table_clusters = (uint32_t) number_of_table_clusters;
+	internal_file->file_header_is_modified                     = 1;
+
+	for( table_cluster_index = 0;
+	     table_cluster_index < number_of_table_clusters;
+	     table_cluster_index++ )
+	{
+		if( libqcow_internal_file_adjust_reference_count(
+		     internal_file,
+		     file_io_handle,
+		     reference_count_table_offset + ( table_cluster_index * internal_file->cluster_block_size ),
+		     1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to increment reference count of reference count table cluster: %" PRIu64 ".",
+			 function,
+			 table_cluster_index );
+
+			return( -1 );
+		}
+	}
+	for( table_cluster_index = 0;
+	     table_cluster_index < unused_table_clusters;
+	     table_cluster_index++ )
+	{
+		if( libqcow_internal_file_adjust_reference_count(
+		     internal_file,
+		     file_io_handle,
+		     unused_table_offset + ( table_cluster_index * internal_file->cluster_block_size ),
+		     -1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to decrement reference count of unused reference count table cluster: %" PRIu64 ".",
+			 function,
+			 table_cluster_index );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Retrieves the reference count block that contains the reference count of a specific cluster
+ * A reference count block is created when the cluster is not yet covered by the reference count table
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_reference_count_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_offset,
+     libqcow_reference_count_block_t **reference_count_block,
+     int *reference_count_index,
+     libcerror_error_t **error )
+{
+	libqcow_reference_count_block_t *safe_reference_count_block = NULL;
+	static char *function                                       = "libqcow_internal_file_get_reference_count_block";
+	uint64_t cluster_index                                      = 0;
+	uint64_t reference_count_block_offset                       = 0;
+	uint64_t table_index                                        = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing reference count table.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count index.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_index = cluster_offset >> internal_file->file_header->number_of_cluster_block_bits;
+	table_index   = cluster_index >> internal_file->number_of_reference_count_block_bits;
+
+	if( table_index >= (uint64_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( table_index >= (uint64_t) internal_file->reference_count_table->number_of_references )
+	{
+		if( libqcow_internal_file_grow_reference_count_table(
+		     internal_file,
+		     file_io_handle,
+		     (int) table_index + 1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to grow reference count table.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( internal_file->reference_count_blocks[ table_index ] == NULL )
+	{
+		reference_count_block_offset = internal_file->reference_count_table->references[ table_index ] & ~( internal_file->cluster_block_bit_mask );
+
+		if( libqcow_reference_count_block_initialize(
+		     &safe_reference_count_block,
+		     (size_t) internal_file->cluster_block_size,
+		     internal_file->file_header->reference_count_order,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create reference count block.",
+			 function );
+
+			goto on_error;
+		}
+		if( reference_count_block_offset != 0 )
+		{
+			if( libqcow_reference_count_block_read(
+			     safe_reference_count_block,
+			     file_io_handle,
+			     (off64_t) reference_count_block_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read reference count block at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 reference_count_block_offset,
+				 reference_count_block_offset );
+
+				goto on_error;
+			}
+			internal_file->reference_count_blocks[ table_index ] = safe_reference_count_block;
+		}
+		else
+		{
+			/* The new reference count block is stored in a newly allocated cluster
+			 * and also accounts for itself when it covers that cluster
+			 */
+			reference_count_block_offset = internal_file->next_cluster_offset;
+
+			internal_file->next_cluster_offset += internal_file->cluster_block_size;
+
+			if( libqcow_cluster_table_set_reference_by_index(
+			     internal_file->reference_count_table,
+			     (int) table_index,
+			     reference_count_block_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set reference count table reference: %" PRIu64 ".",
+				 function,
+				 table_index );
+
+				goto on_error;
+			}
+			internal_file->reference_count_blocks[ table_index ] = safe_reference_count_block;
+
+			safe_reference_count_block = NULL;
+
+			if( libqcow_internal_file_adjust_reference_count(
+			     internal_file,
+			     file_io_handle,
+			     reference_count_block_offset,
+			     1,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to increment reference count of reference count block.",
+				 function );
+
+				return( -1 );
+			}
+		}
+	}
+	*reference_count_block = internal_file->reference_count_blocks[ table_index ];
+	*reference_count_index = (int) ( cluster_index & ~( (uint64_t) -1 << internal_file->number_of_reference_count_block_bits ) );
+
+	return( 1 );
+
+on_error:
+	if( safe_reference_count_block != NULL )
+	{
+		libqcow_reference_count_block_free(
+		 &safe_reference_count_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Adjusts the reference count of a specific cluster
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_adjust_reference_count(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_offset,
+     int adjustment,
+     libcerror_error_t **error )
+{
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	static char *function                                  = "libqcow_internal_file_adjust_reference_count";
+	uint64_t reference_count                               = 0;
+	int reference_count_index                              = 0;
+
+	if( libqcow_internal_file_get_reference_count_block(
+	     internal_file,
+	     file_io_handle,
+	     cluster_offset,
+	     &reference_count_block,
+	     &reference_count_index,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve reference count block for cluster at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 cluster_offset,
+		 cluster_offset );
+
+		return( -1 );
+	}
+	if( libqcow_reference_count_block_get_reference_count_by_index(
+	     reference_count_block,
+	     reference_count_index,
+	     &reference_count,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve reference count: %d.",
+		 function,
+		 reference_count_index );
+
+		return( -1 );
+	}
+	if( ( adjustment < 0 )
+	 && ( reference_count < (uint64_t) -adjustment ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count of cluster at offset: %" PRIu64 " (0x%08" PRIx64 ") value out of bounds.",
+		 function,
+		 cluster_offset,
+		 cluster_offset );
+
+		return( -1 );
+	}
+	reference_count += (int64_t) adjustment;
+
+	if( libqcow_reference_count_block_set_reference_count_by_index(
+	     reference_count_block,
+	     reference_count_index,
+	     reference_count,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set reference count: %d.",
+		 function,
+		 reference_count_index );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Allocates a contiguous range of clusters at the end of the file
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_allocate_clusters(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     int number_of_clusters,
+     uint64_t *cluster_offset,
+     libcerror_error_t **error )
+{
+	static char *function        = "libqcow_internal_file_allocate_clusters";
+	uint64_t safe_cluster_offset = 0;
+	int cluster_index            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_clusters <= 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of clusters value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->next_cluster_offset > ( internal_file->offset_bit_mask - ( (uint64_t) number_of_clusters * internal_file->cluster_block_size ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid next cluster offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	/* The range is reserved before the reference counts are set, since setting
+	 * the reference counts can allocate reference count blocks
+	 */
+	safe_cluster_offset = internal_file->next_cluster_offset;
+
+	internal_file->next_cluster_offset += (uint64_t) number_of_clusters * internal_file->cluster_block_size;
+
+	for( cluster_index = 0;
+	     cluster_index < number_of_clusters;
+	     cluster_index++ )
+	{
+		if( libqcow_internal_file_adjust_reference_count(
+		     internal_file,
+		     file_io_handle,
+		     safe_cluster_offset + ( (uint64_t) cluster_index * internal_file->cluster_block_size ),
+		     1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to increment reference count of cluster: %d.",
+			 function,
+			 cluster_index );
+
+			return( -1 );
+		}
+	}
+	*cluster_offset = safe_cluster_offset;
+
+	return( 1 );
+}
+
+/* Frees the clusters referenced by a level 2 table reference
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level2_table_reference,
+     libcerror_error_t **error )
+{
+	static char *function         = "libqcow_internal_file_free_cluster_block";
+	uint64_t cluster_block_offset = 0;
+	uint64_t cluster_offset       = 0;
+	uint64_t end_offset           = 0;
+	uint64_t number_of_sectors    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_reference & internal_file->compression_flag_bit_mask ) != 0 )
+	{
+		/* A compressed cluster block is stored in 512-byte sectors that can
+		 * span multiple clusters
+		 */
+		cluster_block_offset = level2_table_reference & internal_file->offset_bit_mask;
+		number_of_sectors    = ( cluster_block_offset >> internal_file->compression_bit_shift ) + 1;
+		cluster_block_offset = ( cluster_block_offset & internal_file->compression_bit_mask ) & ~( (uint64_t) 511 );
+		end_offset           = cluster_block_offset + ( number_of_sectors * 512 );
+
+		if( end_offset > internal_file->size )
+		{
+			end_offset = internal_file->size;
+		}
+	}
+	else
+	{
+		cluster_block_offset = level2_table_reference & internal_file->offset_bit_mask & ~( internal_file->cluster_block_bit_mask );
+		end_offset           = cluster_block_offset + 1;
+	}
+	if( cluster_block_offset == 0 )
+	{
+		return( 1 );
+	}
+	for( cluster_offset = cluster_block_offset & ~( internal_file->cluster_block_bit_mask );
+	     cluster_offset < end_offset;
+	     cluster_offset += internal_file->cluster_block_size )
+	{
+		if( libqcow_internal_file_adjust_reference_count(
+		     internal_file,
+		     file_io_handle,
+		     cluster_offset,
+		     -1,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to decrement reference count of cluster at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+			 function,
+			 cluster_offset,
+			 cluster_offset );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Appends a level 2 table to the modified level 2 tables
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_append_modified_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     uint64_t level2_table_offset,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t **modified_level2_tables = NULL;
+	uint64_t *modified_level2_table_offsets          = NULL;
+	static char *function                            = "libqcow_internal_file_append_modified_level2_table";
+	int maximum_number_of_modified_level2_tables     = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->number_of_modified_level2_tables >= internal_file->maximum_number_of_modified_level2_tables )
+	{
+		if( internal_file->maximum_number_of_modified_level2_tables == 0 )
+		{
+			maximum_number_of_modified_level2_tables = 16;
+		}
+		else if( internal_file->maximum_number_of_modified_level2_tables < ( INT_MAX / 2 ) )
+		{
+			maximum_number_of_modified_level2_tables = internal_file->maximum_number_of_modified_level2_tables * 2;
+		}
+		else
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid maximum number of modified level 2 tables value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		modified_level2_tables = (libqcow_cluster_table_t **) memory_reallocate(
+		                                                       internal_file->modified_level2_tables,
+		                                                       sizeof( libqcow_cluster_table_t * ) * maximum_number_of_modified_level2_tables );
+
+		if( modified_level2_tables == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to resize modified level 2 tables.",
+			 function );
+
+			return( -1 );
+		}
+		internal_file->modified_level2_tables = modified_level2_tables;
+
+		modified_level2_table_offsets = (uint64_t *) memory_reallocate(
+		                                              internal_file->modified_level2_table_offsets,
+		                                              sizeof( uint64_t ) * maximum_number_of_modified_level2_tables );
+
+		if( modified_level2_table_offsets == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to resize modified level 2 table offsets.",
+			 function );
+
+			return( -1 );
+		}
+		internal_file->modified_level2_table_offsets            = modified_level2_table_offsets;
+		internal_file->maximum_number_of_modified_level2_tables = maximum_number_of_modified_level2_tables;
+	}
+	internal_file->modified_level2_tables[ internal_file->number_of_modified_level2_tables ]        = level2_table;
+	internal_file->modified_level2_table_offsets[ internal_file->number_of_modified_level2_tables ] = level2_table_offset;
+
+	internal_file->number_of_modified_level2_tables += 1;
+
+	return( 1 );
+}
+
+/* Retrieves the level 2 table for writing a specific level 1 table entry
+ * A level 2 table is created when the level 1 table entry is sparse
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_level2_table_for_write(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level1_table_index,
+     libqcow_cluster_table_t **level2_table,
+     uint64_t *level2_table_offset,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *safe_level2_table             = NULL;
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	static char *function                                  = "libqcow_internal_file_get_level2_table_for_write";
+	uint64_t level1_table_reference                        = 0;
+	uint64_t safe_level2_table_offset                      = 0;
+	uint64_t reference_count                               = 0;
+	int reference_count_index                              = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( level1_table_index > (uint64_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 1 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     internal_file->level1_table,
+	     (int) level1_table_index,
+	     &level1_table_reference,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table offset: %" PRIu64 " from level 1 table.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	safe_level2_table_offset = level1_table_reference & internal_file->offset_bit_mask;
+
+	if( safe_level2_table_offset != 0 )
+	{
+		/* A level 2 table without the copied flag can be shared and must not be modified in place
+		 */
+		if( ( level1_table_reference & LIBQCOW_TABLE_REFERENCE_FLAG_COPIED ) == 0 )
+		{
+			if( libqcow_internal_file_get_reference_count_block(
+			     internal_file,
+			     file_io_handle,
+			     safe_level2_table_offset,
+			     &reference_count_block,
+			     &reference_count_index,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve reference count block of level 2 table.",
+				 function );
+
+				return( -1 );
+			}
+			if( libqcow_reference_count_block_get_reference_count_by_index(
+			     reference_count_block,
+			     reference_count_index,
+			     &reference_count,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve reference count of level 2 table.",
+				 function );
+
+				return( -1 );
+			}
+			if( reference_count != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+				 "%s: unsupported level 2 table reference count: %" PRIu64 ".",
+				 function,
+				 reference_count );
+
+				return( -1 );
+			}
+			if( libqcow_cluster_table_set_reference_by_index(
+			     internal_file->level1_table,
+			     (int) level1_table_index,
+			     level1_table_reference | LIBQCOW_TABLE_REFERENCE_FLAG_COPIED,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set level 1 table reference: %" PRIu64 ".",
+				 function,
+				 level1_table_index );
+
+				return( -1 );
+			}
+		}
+		if( libqcow_internal_file_read_level2_table(
+		     internal_file,
+		     file_io_handle,
+		     safe_level2_table_offset,
+		     level2_table,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
+			 function,
+			 safe_level2_table_offset );
+
+			return( -1 );
+		}
+		*level2_table_offset = safe_level2_table_offset;
+
+		return( 1 );
+	}
+	/* The modified level 2 tables are written before the level 2 table cache
+	 * can evict one of them
+	 */
+	if( libqcow_internal_file_write_modified_metadata(
+	     internal_file,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write modified metadata.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_internal_file_allocate_clusters(
+	     internal_file,
+	     file_io_handle,
+	     1,
+	     &safe_level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to allocate level 2 table cluster.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_table_initialize(
+	     &safe_level2_table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create level 2 table.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_table_resize(
+	     safe_level2_table,
+	     internal_file->level2_table_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+		 "%s: unable to resize level 2 table.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_block_cache_set_value_by_key(
+	     internal_file->level2_table_cache,
+	     safe_level2_table_offset,
+	     (intptr_t *) safe_level2_table,
+	     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_table_free,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set level 2 table in cache.",
+		 function );
+
+		goto on_error;
+	}
+	*level2_table     = safe_level2_table;
+	safe_level2_table = NULL;
+
+	if( libqcow_internal_file_append_modified_level2_table(
+	     internal_file,
+	     *level2_table,
+	     safe_level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to append modified level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_set_reference_by_index(
+	     internal_file->level1_table,
+	     (int) level1_table_index,
+	     safe_level2_table_offset | LIBQCOW_TABLE_REFERENCE_FLAG_COPIED,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set level 1 table reference: %" PRIu64 ".",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	*level2_table_offset = safe_level2_table_offset;
+
+	return( 1 );
+
+on_error:
+	if( safe_level2_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &safe_level2_table,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Sets or clears the dirty flag in the file header
+ * The dirty flag indicates the reference counts might not be consistent with the tables
+ * that refer to the clusters. Only format version 3 supports the dirty flag
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_set_dirty_flag(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint8_t is_dirty,
+     libcerror_error_t **error )
+{
+	static char *function               = "libqcow_internal_file_set_dirty_flag";
+	uint64_t incompatible_feature_flags = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header->format_version < 3 )
+	{
+		return( 1 );
+	}
+	incompatible_feature_flags = internal_file->file_header->incompatible_feature_flags;
+
+	if( is_dirty != 0 )
+	{
+		incompatible_feature_flags |= LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_DIRTY;
+	}
+	else
+	{
+		incompatible_feature_flags &= ~( LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_DIRTY );
+	}
+	if( incompatible_feature_flags == internal_file->file_header->incompatible_feature_flags )
+	{
+		return( 1 );
+	}
+	internal_file->file_header->incompatible_feature_flags = incompatible_feature_flags;
+
+	if( libqcow_file_header_write_file_io_handle(
+	     internal_file->file_header,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write file header.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Writes the modified metadata
+ * The reference counts are written before the tables that refer to the clusters
+ * The dirty flag remains set until the file is closed
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_write_modified_metadata(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	static char *function                 = "libqcow_internal_file_write_modified_metadata";
+	uint64_t reference_count_table_offset = 0;
+	uint64_t table_cluster_index          = 0;
+	int level2_table_index                = 0;
+	int reference_count_block_index       = 0;
+	int write_iteration                   = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_table == NULL )
+	{
+		return( 1 );
+	}
+	/* The reference count blocks are written a second time when a relocated
+	 * reference count table was freed
+	 */
+	for( write_iteration = 0;
+	     write_iteration < 2;
+	     write_iteration++ )
+	{
+		for( reference_count_block_index = 0;
+		     reference_count_block_index < internal_file->reference_count_table->number_of_references;
+		     reference_count_block_index++ )
+		{
+			if( internal_file->reference_count_blocks[ reference_count_block_index ] == NULL )
+			{
+				continue;
+			}
+			if( libqcow_reference_count_block_write_modified_reference_counts(
+			     internal_file->reference_count_blocks[ reference_count_block_index ],
+			     file_io_handle,
+			     (off64_t) ( internal_file->reference_count_table->references[ reference_count_block_index ] & ~( internal_file->cluster_block_bit_mask ) ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_WRITE_FAILED,
+				 "%s: unable to write reference count block: %d.",
+				 function,
+				 reference_count_block_index );
+
+				return( -1 );
+			}
+		}
+		if( libqcow_cluster_table_write_modified_references(
+		     internal_file->reference_count_table,
+		     file_io_handle,
+		     internal_file->file_header->reference_count_table_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write reference count table.",
+			 function );
+
+			return( -1 );
+		}
+		if( internal_file->file_header_is_modified != 0 )
+		{
+			if( libqcow_file_header_write_file_io_handle(
+			     internal_file->file_header,
+			     file_io_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_WRITE_FAILED,
+				 "%s: unable to write file header.",
+				 function );
+
+				return( -1 );
+			}
+			internal_file->file_header_is_modified = 0;
+		}
+		if( internal_file->previous_reference_count_table_offset == 0 )
+		{
+			break;
+		}
+		reference_count_table_offset = (uint64_t) internal_file->previous_reference_count_table_offset;
+
+		for( table_cluster_index = 0;
+		     table_cluster_index < (uint64_t) internal_file->previous_reference_count_table_clusters;
+		     table_cluster_index++ )
+		{
+			if( libqcow_internal_file_adjust_reference_count(
+			     internal_file,
+			     file_io_handle,
+			     reference_count_table_offset + ( table_cluster_index * internal_file->cluster_block_size ),
+			     -1,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to decrement reference count of previous reference count table cluster: %" PRIu64 ".",
+				 function,
+				 table_cluster_index );
+
+				return( -1 );
+			}
+		}
+		internal_file->previous_reference_count_table_offset   = 0;
+		internal_file->previous_reference_count_table_clusters = 0;
+	}
+	for( level2_table_index = 0;
+	     level2_table_index < internal_file->number_of_modified_level2_tables;
+	     level2_table_index++ )
+	{
+		if( libqcow_cluster_table_write_modified_references(
+		     internal_file->modified_level2_tables[ level2_table_index ],
+		     file_io_handle,
+		     (off64_t) internal_file->modified_level2_table_offsets[ level2_table_index ],
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write level 2 table at offset: 0x%08" PRIx64 ".",
+			 function,
+			 internal_file->modified_level2_table_offsets[ level2_table_index ] );
+
+			return( -1 );
+		}
+	}
+	internal_file->number_of_modified_level2_tables = 0;
+
+	if( libqcow_cluster_table_write_modified_references(
+	     internal_file->level1_table,
+	     file_io_handle,
+	     internal_file->file_header->level1_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Writes cluster block data at a specific offset in the file
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_write_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     const uint8_t *data,
+     size_t data_size,
+     uint64_t file_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_write_cluster_block_data";
+	ssize_t write_count   = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               file_io_handle,
+	               data,
+	               data_size,
+	               (off64_t) file_offset,
+	               error );
+
+	if( write_count != (ssize_t) data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write cluster block data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		return( -1 );
+	}
+	if( ( file_offset + data_size ) > internal_file->size )
+	{
+		internal_file->size = file_offset + data_size;
+	}
+	return( 1 );
+}
+
+/* Writes (media) data at a specific offset from a buffer using a Basic File IO (bfio) handle
+ * Data is written in place in clusters that are only referenced once, otherwise
+ * new clusters are allocated at the end of the file. Contiguous data is written
+ * at once and the modified metadata is written when needed or when the file is closed.
+ * On error the file is marked as failed and the modified metadata is no longer written.
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes written or -1 on error
+ */
+ssize_t libqcow_internal_file_write_buffer_at_offset_to_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         const void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table = NULL;
+	uint8_t *cluster_block_data           = NULL;
+	static char *function                 = "libqcow_internal_file_write_buffer_at_offset_to_file_io_handle";
+	size_t buffer_offset                  = 0;
+	size_t pending_buffer_offset          = 0;
+	size_t pending_write_size             = 0;
+	size_t write_size                     = 0;
+	ssize_t read_count                    = 0;
+	uint64_t cluster_block_data_offset    = 0;
+	uint64_t cluster_block_file_offset    = 0;
+	uint64_t level1_table_index           = 0;
+	uint64_t level2_table_index           = 0;
+	uint64_t level2_table_offset          = 0;
+	uint64_t level2_table_reference       = 0;
+	uint64_t pending_level1_table_index   = 0;
+	uint64_t pending_file_offset          = 0;
+	int level2_table_is_modified          = 0;
+	int result                            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->reference_count_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing reference count table.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->write_failed != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - previous write failed.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= internal_file->media_size )
+	{
+		return( 0 );
+	}
+	/* The dirty flag is set before the first data or metadata is written and
+	 * cleared when the file is closed after the modified metadata was written
+	 */
+	if( libqcow_internal_file_set_dirty_flag(
+	     internal_file,
+	     file_io_handle,
+	     1,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set dirty flag.",
+		 function );
+
+		goto on_error;
+	}
+	while( buffer_offset < buffer_size )
+	{
+		cluster_block_data_offset = (uint64_t) offset & internal_file->cluster_block_bit_mask;
+
+		write_size = (size_t) ( internal_file->cluster_block_size - cluster_block_data_offset );
+
+		if( ( (size64_t) offset + write_size ) > internal_file->media_size )
+		{
+			write_size = (size_t) ( internal_file->media_size - offset );
+		}
+		if( ( buffer_offset + write_size ) > buffer_size )
+		{
+			write_size = buffer_size - buffer_offset;
+		}
+		level1_table_index = (uint64_t) offset >> internal_file->level1_index_bit_shift;
+		level2_table_index = ( (uint64_t) offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+
+		/* The data is written before metadata that refers to it can be written
+		 */
+		if( ( pending_write_size > 0 )
+		 && ( pending_level1_table_index != level1_table_index ) )
+		{
+			if( libqcow_internal_file_write_cluster_block_data(
+			     internal_file,
+			     file_io_handle,
+			     &( ( (uint8_t *) buffer )[ pending_buffer_offset ] ),
+			     pending_write_size,
+			     pending_file_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_WRITE_FAILED,
+				 "%s: unable to write data.",
+				 function );
+
+				goto on_error;
+			}
+			pending_write_size = 0;
+		}
+		if( libqcow_internal_file_get_level2_table_for_write(
+		     internal_file,
+		     file_io_handle,
+		     level1_table_index,
+		     &level2_table,
+		     &level2_table_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table: %" PRIu64 ".",
+			 function,
+			 level1_table_index );
+
+			goto on_error;
+		}
+		if( libqcow_cluster_table_get_reference_by_index(
+		     level2_table,
+		     (int) level2_table_index,
+		     &level2_table_reference,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table entry: %" PRIu64 ".",
+			 function,
+			 level2_table_index );
+
+			goto on_error;
+		}
+		cluster_block_file_offset = 0;
+
+		if( ( ( level2_table_reference & LIBQCOW_TABLE_REFERENCE_FLAG_COPIED ) != 0 )
+		 && ( ( level2_table_reference & internal_file->compression_flag_bit_mask ) == 0 )
+		 && ( ( internal_file->file_header->format_version < 3 )
+		  ||  ( ( level2_table_reference & LIBQCOW_TABLE_REFERENCE_FLAG_ZERO ) == 0 ) ) )
+		{
+			cluster_block_file_offset = level2_table_reference & internal_file->offset_bit_mask & ~( internal_file->cluster_block_bit_mask );
+		}
+		if( cluster_block_file_offset != 0 )
+		{
+			/* The cluster block is only referenced once and is overwritten in place
+			 */
+			result = libqcow_block_cache_remove_value_by_key(
+			          internal_file->cluster_block_cache,
+			          cluster_block_file_offset,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+				 "%s: unable to remove cluster block from cache.",
+				 function );
+
+				goto on_error;
+			}
+			cluster_block_file_offset += cluster_block_data_offset;
+		}
+		else
+		{
+			if( libqcow_internal_file_allocate_clusters(
+			     internal_file,
+			     file_io_handle,
+			     1,
+			     &cluster_block_file_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to allocate cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			if( write_size < internal_file->cluster_block_size )
+			{
+				/* A partially written cluster block is merged with its current data
+				 */
+				if( pending_write_size > 0 )
+				{
+					if( libqcow_internal_file_write_cluster_block_data(
+					     internal_file,
+					     file_io_handle,
+					     &( ( (uint8_t *) buffer )[ pending_buffer_offset ] ),
+					     pending_write_size,
+					     pending_file_offset,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_WRITE_FAILED,
+						 "%s: unable to write data.",
+						 function );
+
+						goto on_error;
+					}
+					pending_write_size = 0;
+				}
+				if( cluster_block_data == NULL )
+				{
+					if( libqcow_buffer_pool_get_buffer(
+					     internal_file->buffer_pool,
+					     (size_t) internal_file->cluster_block_size,
+					     &cluster_block_data,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+						 "%s: unable to create cluster block data.",
+						 function );
+
+						goto on_error;
+					}
+				}
+				read_count = 0;
+
+				/* The zero flag is not used by compressed cluster blocks
+				 */
+				if( ( internal_file->file_header->format_version < 3 )
+				 || ( ( level2_table_reference & internal_file->compression_flag_bit_mask ) != 0 )
+				 || ( ( level2_table_reference & LIBQCOW_TABLE_REFERENCE_FLAG_ZERO ) == 0 ) )
+				{
+					read_count = libqcow_internal_file_read_buffer_at_offset_from_file_io_handle(
+					              internal_file,
+					              file_io_handle,
+					              cluster_block_data,
+					              (size_t) internal_file->cluster_block_size,
+					              offset - (off64_t) cluster_block_data_offset,
+					              error );
+
+					if( read_count == -1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_READ_FAILED,
+						 "%s: unable to read cluster block data.",
+						 function );
+
+						goto on_error;
+					}
+				}
+				if( (size64_t) read_count < internal_file->cluster_block_size )
+				{
+					if( memory_set(
+					     &( cluster_block_data[ read_count ] ),
+					     0,
+					     (size_t) internal_file->cluster_block_size - (size_t) read_count ) == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+						 "%s: unable to clear cluster block data.",
+						 function );
+
+						goto on_error;
+					}
+				}
+				if( memory_copy(
+				     &( cluster_block_data[ cluster_block_data_offset ] ),
+				     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+				     write_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy buffer to cluster block data.",
+					 function );
+
+					goto on_error;
+				}
+				if( libqcow_internal_file_write_cluster_block_data(
+				     internal_file,
+				     file_io_handle,
+				     cluster_block_data,
+				     (size_t) internal_file->cluster_block_size,
+				     cluster_block_file_offset,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_WRITE_FAILED,
+					 "%s: unable to write cluster block data.",
+					 function );
+
+					goto on_error;
+				}
+			}
+			if( libqcow_internal_file_free_cluster_block(
+			     internal_file,
+			     file_io_handle,
+			     level2_table_reference,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to free cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			level2_table_is_modified = (int) ( level2_table->modified_start_index != level2_table->modified_end_index );
+
+			if( libqcow_cluster_table_set_reference_by_index(
+			     level2_table,
+			     (int) level2_table_index,
+			     cluster_block_file_offset | LIBQCOW_TABLE_REFERENCE_FLAG_COPIED,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set level 2 table entry: %" PRIu64 ".",
+				 function,
+				 level2_table_index );
+
+				goto on_error;
+			}
+			if( level2_table_is_modified == 0 )
+			{
+				if( libqcow_internal_file_append_modified_level2_table(
+				     internal_file,
+				     level2_table,
+				     level2_table_offset,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+					 "%s: unable to append modified level 2 table.",
+					 function );
+
+					goto on_error;
+				}
+			}
+			if( write_size < internal_file->cluster_block_size )
+			{
+				cluster_block_file_offset = 0;
+			}
+		}
+		/* Contiguous data is written at once
+		 */
+		if( cluster_block_file_offset != 0 )
+		{
+			if( ( pending_write_size > 0 )
+			 && ( ( ( pending_file_offset + pending_write_size ) != cluster_block_file_offset )
+			  ||  ( ( pending_buffer_offset + pending_write_size ) != buffer_offset ) ) )
+			{
+				if( libqcow_internal_file_write_cluster_block_data(
+				     internal_file,
+				     file_io_handle,
+				     &( ( (uint8_t *) buffer )[ pending_buffer_offset ] ),
+				     pending_write_size,
+				     pending_file_offset,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_WRITE_FAILED,
+					 "%s: unable to write data.",
+					 function );
+
+					goto on_error;
+				}
+				pending_write_size = 0;
+			}
+			if( pending_write_size == 0 )
+			{
+				pending_file_offset        = cluster_block_file_offset;
+				pending_buffer_offset      = buffer_offset;
+				pending_level1_table_index = level1_table_index;
+			}
+			pending_write_size += write_size;
+		}
+		offset        += write_size;
+		buffer_offset += write_size;
+
+		if( (size64_t) offset >= internal_file->media_size )
+		{
+			break;
+		}
+	}
+	if( pending_write_size > 0 )
+	{
+		if( libqcow_internal_file_write_cluster_block_data(
+		     internal_file,
+		     file_io_handle,
+		     &( ( (uint8_t *) buffer )[ pending_buffer_offset ] ),
+		     pending_write_size,
+		     pending_file_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( cluster_block_data != NULL )
+	{
+		if( libqcow_buffer_pool_release_buffer(
+		     internal_file->buffer_pool,
+		     &cluster_block_data,
+		     (size_t) internal_file->cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to release cluster block data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( (ssize_t) buffer_offset );
+
+on_error:
+	if( cluster_block_data != NULL )
+	{
+		libqcow_buffer_pool_release_buffer(
+		 internal_file->buffer_pool,
+		 &cluster_block_data,
+		 (size_t) internal_file->cluster_block_size,
+		 NULL );
+	}
+	/* The level 2 table and reference counts can refer to clusters whose data
+	 * was not written, hence the modified metadata must not be written
+	 */
+	internal_file->write_failed = 1;
+
+	return( -1 );
+}
+
+/* Writes (media) data at the current offset from a buffer
+ * Returns the number of bytes written or -1 on error
+ */
+ssize_t libqcow_file_write_buffer(
+         libqcow_file_t *file,
+         const void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_write_buffer";
+	ssize_t write_count                    = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid file - not opened for writing.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	write_count = libqcow_internal_file_write_buffer_at_offset_to_file_io_handle(
+	               internal_file,
+	               internal_file->file_io_handle,
+	               buffer,
+	               buffer_size,
+	               internal_file->current_offset,
+	               error );
+
+	if( write_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write buffer.",
+		 function );
+
+		write_count = -1;
+	}
+	else
+	{
+		internal_file->current_offset += (off64_t) write_count;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( write_count );
+}
+
+/* Writes (media) data at a specific offset
+ * Returns the number of bytes written or -1 on error
+ */
+ssize_t libqcow_file_write_buffer_at_offset(
+         libqcow_file_t *file,
+         const void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_write_buffer_at_offset";
+	ssize_t write_count                    = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid file - not opened for writing.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_seek_offset(
+	     internal_file,
+	     offset,
+	     SEEK_SET,
+	     error ) == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		write_count = -1;
+	}
+	else
+	{
+		write_count = libqcow_internal_file_write_buffer_at_offset_to_file_io_handle(
+		               internal_file,
+		               internal_file->file_io_handle,
+		               buffer,
+		               buffer_size,
+		               offset,
+		               error );
+
+		if( write_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write buffer.",
+			 function );
+
+			write_count = -1;
+		}
+		else
+		{
+			internal_file->current_offset += (off64_t) write_count;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( write_count );
+}
+
+/* Retrieves the offset of the next data or hole at or after a specific offset
+ * A hole is a range of cluster blocks that read as zero without data stored in the file or the backing file
+ * The end of the media is considered a hole
+ * This function is not multi-thread safe acquire the cache mutex before call
+ * Returns 1 if successful, 0 if no such offset was found or -1 on error
+ */
+int libqcow_internal_file_get_data_or_hole_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t find_hole,
+     off64_t *data_or_hole_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_get_data_or_hole_offset";
+	size64_t extent_size  = 0;
+	uint32_t extent_flags = 0;
+	uint8_t is_hole       = 0;
+	int result            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_or_hole_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data or hole offset.",
+		 function );
+
+		return( -1 );
+	}
+	do
+	{
+		result = libqcow_internal_file_get_extent_at_offset(
+		          internal_file,
+		          file_io_handle,
+		          offset,
+		          &extent_size,
+		          &extent_flags,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve extent at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			if( find_hole == 0 )
+			{
+				return( 0 );
+			}
+			*data_or_hole_offset = (off64_t) internal_file->media_size;
+
+			return( 1 );
+		}
+		is_hole = (uint8_t) ( ( extent_flags & ( LIBQCOW_EXTENT_FLAG_IS_SPARSE | LIBQCOW_EXTENT_FLAG_IS_ZERO ) ) != 0 );
+
+		if( is_hole == find_hole )
+		{
+			break;
+		}
+		offset += (off64_t) extent_size;
+	}
+	while( extent_size > 0 );
+
+	*data_or_hole_offset = offset;
+
+	return( 1 );
+}
+
+/* Seeks a certain offset of the (media) data
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_internal_file_seek_offset(
+         libqcow_internal_file_t *internal_file,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_seek_offset";
+	int result            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( ( internal_file->parent_file == NULL )
+		 && ( internal_file->parent_file_io_handle == NULL ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( whence != SEEK_CUR )
+	 && ( whence != SEEK_DATA )
+	 && ( whence != SEEK_END )
+	 && ( whence != SEEK_HOLE )
+	 && ( whence != SEEK_SET ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported whence.",
+		 function );
+
+		return( -1 );
+	}
+	if( whence == SEEK_CUR )
+	{
+		offset += internal_file->current_offset;
+	}
+	else if( whence == SEEK_END )
+	{
+		offset += (off64_t) internal_file->media_size;
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( whence == SEEK_DATA )
+	 || ( whence == SEEK_HOLE ) )
+	{
+		if( (size64_t) offset >= internal_file->media_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid offset value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_grab(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab cache mutex.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		result = libqcow_internal_file_get_data_or_hole_offset(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          offset,
+		          (uint8_t) ( whence == SEEK_HOLE ),
+		          &offset,
+		          error );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_release(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release cache mutex.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve data or hole offset.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid offset value out of bounds - no data at or after offset.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	internal_file->current_offset = offset;
+
+	return( offset );
+}
+
+/* Seeks a certain offset of the (media) data
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_file_seek_offset(
+         libqcow_file_t *file,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_seek_offset";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	offset = libqcow_internal_file_seek_offset(
+	          internal_file,
+	          offset,
+	          whence,
+	          error );
+
+	if( offset == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		offset = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( offset );
+}
+
+/* Retrieves the extent that starts at a specific offset of the (media) data
+ * The extent consists of the consecutive cluster blocks with the same extent flags
+ * Returns 1 if successful, 0 if the offset is beyond the media size or -1 on error
+ */
+int libqcow_file_get_extent_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     size64_t *extent_size,
+     uint32_t *extent_flags,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_extent_at_offset";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+#endif
+	result = libqcow_internal_file_get_extent_at_offset(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          offset,
+	          extent_size,
+	          extent_flags,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve extent at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the current offset of the (media) data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_offset(
+     libqcow_file_t *file,
+     off64_t *offset,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_offset";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid offset.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*offset = internal_file->current_offset;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the parent (backing) file of a differential image
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_parent_file(
+     libqcow_file_t *file,
+     libqcow_file_t *parent_file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_parent_file";
+	size64_t cache_budget                  = 0;
+	int number_of_decompression_threads    = 0;
+	int number_of_readahead_cluster_blocks = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->backing_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing backing filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->parent_file != NULL )
+	 || ( internal_file->parent_file_io_handle != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - parent file already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->parent_file = parent_file;
+
+	cache_budget                       = internal_file->cache_budget;
+	number_of_readahead_cluster_blocks = internal_file->number_of_readahead_cluster_blocks;
+	number_of_decompression_threads    = internal_file->number_of_decompression_threads;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	/* Apply the cache budget, readahead and decompression threads to the backing chain
+	 */
+	if( cache_budget != 0 )
+	{
+		if( libqcow_file_set_cache_budget(
+		     parent_file,
+		     cache_budget,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cache budget of parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( number_of_readahead_cluster_blocks != 0 )
+	{
+		if( libqcow_file_set_number_of_readahead_cluster_blocks(
+		     parent_file,
+		     number_of_readahead_cluster_blocks,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set number of readahead cluster blocks of parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( number_of_decompression_threads != 0 )
+	{
+		if( libqcow_file_set_number_of_decompression_threads(
+		     parent_file,
+		     number_of_decompression_threads,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set number of decompression threads of parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Sets the raw parent (backing) file of a differential image
+ * The parent file IO handle is opened for reading if it is not open and is not freed by the library
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_parent_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *parent_file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file      = NULL;
+	static char *function                       = "libqcow_file_set_parent_file_io_handle";
+	size64_t parent_file_size                   = 0;
+	int parent_file_io_handle_is_open           = 0;
+	int parent_file_io_handle_opened_in_library = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->backing_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing backing filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->parent_file != NULL )
+	 || ( internal_file->parent_file_io_handle != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - parent file already set.",
+		 function );
+
+		return( -1 );
+	}
+	/* Without a backing format header extension the format is probed by the caller
+	 */
+	if( internal_file->backing_format != NULL )
+	{
+		if( ( internal_file->backing_format_size < 3 )
+		 || ( memory_compare(
+		       internal_file->backing_format,
+		       "raw",
+		       3 ) != 0 )
+		 || ( ( internal_file->backing_format_size > 3 )
+		  &&  ( internal_file->backing_format[ 3 ] != 0 ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: invalid file - unsupported backing format.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( parent_file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid parent file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	parent_file_io_handle_is_open = libbfio_handle_is_open(
+	                                 parent_file_io_handle,
+	                               error );
+
+	if( parent_file_io_handle_is_open == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if parent file IO handle is open.",
+		 function );
+
+		goto on_error;
+	}
+	else if( parent_file_io_handle_is_open == 0 )
+	{
+		if( libbfio_handle_open(
+		     parent_file_io_handle,
+		     LIBBFIO_ACCESS_FLAG_READ,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open parent file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		parent_file_io_handle_opened_in_library = 1;
+	}
+	if( libbfio_handle_get_size(
+	     parent_file_io_handle,
+	     &parent_file_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to retrieve parent file size.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_file->parent_file_io_handle                   = parent_file_io_handle;
+	internal_file->parent_file_io_handle_opened_in_library = (uint8_t) parent_file_io_handle_opened_in_library;
+	internal_file->parent_file_size                        = parent_file_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( parent_file_io_handle_opened_in_library != 0 )
+	{
+		libbfio_handle_close(
+		 parent_file_io_handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Sets the external data file of an image that stores its cluster block data in a separate file
+ * The data file IO handle is opened for reading if it is not open and is not freed by the library
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_data_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *data_file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file    = NULL;
+	static char *function                     = "libqcow_file_set_data_file_io_handle";
+	size64_t data_file_size                   = 0;
+	int data_file_io_handle_is_open           = 0;
+	int data_file_io_handle_opened_in_library = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid file - file does not use an external data file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - data file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	data_file_io_handle_is_open = libbfio_handle_is_open(
+	                               data_file_io_handle,
+	                               error );
+
+	if( data_file_io_handle_is_open == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if data file IO handle is open.",
+		 function );
+
+		goto on_error;
+	}
+	else if( data_file_io_handle_is_open == 0 )
+	{
+		if( libbfio_handle_open(
+		     data_file_io_handle,
+		     LIBBFIO_ACCESS_FLAG_READ,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open data file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		data_file_io_handle_opened_in_library = 1;
+	}
+	if( libbfio_handle_get_size(
+	     data_file_io_handle,
+	     &data_file_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to retrieve data file size.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_file->data_file_io_handle                   = data_file_io_handle;
+	internal_file->data_file_io_handle_opened_in_library = (uint8_t) data_file_io_handle_opened_in_library;
+	internal_file->data_file_size                        = data_file_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( data_file_io_handle_opened_in_library != 0 )
+	{
+		libbfio_handle_close(
+		 data_file_io_handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Set the keys
+ * The key is either a 16 byte AES-CBC key or a 32 or 64 byte LUKS master key
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_keys(
+     libqcow_file_t *file,
+     const uint8_t *key,
+     size_t key_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_keys";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( key_size != 16 )
+	 && ( key_size != 32 )
+	 && ( key_size != 64 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported key size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_clear_keys(
+	     internal_file,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to clear keys.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_copy(
+	     internal_file->key_data,
+	     key,
+	     key_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy key.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->key_data_size   = key_size;
+	internal_file->key_data_is_set = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	libqcow_internal_file_clear_keys(
+	 internal_file,
+	 NULL );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Clears the keys and the password
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_clear_keys(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_clear_keys";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     internal_file->key_data,
+	     0,
+	     LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear key data.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file->key_data_size   = 0;
+	internal_file->key_data_is_set = 0;
+
+	if( internal_file->password != NULL )
+	{
+		if( memory_set(
+		     internal_file->password,
+		     0,
+		     internal_file->password_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear password.",
+			 function );
+
+			return( -1 );
+		}
+		memory_free(
+		 internal_file->password );
+
+		internal_file->password = NULL;
+	}
+	internal_file->password_size = 0;
+
+	return( 1 );
+}
+
+/* Sets an UTF-8 formatted password
+ * The password is used as the AES-CBC key, of which only the first 16 bytes are used,
+ * or to unlock one of the LUKS key slots
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful, 0 if password is invalid or -1 on error
+ */
+int libqcow_file_set_utf8_password(
+     libqcow_file_t *file,
+     const uint8_t *utf8_string,
+     size_t utf8_string_length,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_utf8_password";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( utf8_string == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid UTF-8 string.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( utf8_string_length == 0 )
+	 || ( utf8_string_length > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid UTF-8 string length value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_clear_keys(
+	     internal_file,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to clear keys.",
+		 function );
+
+		goto on_error;
+	}
+	/* The password is stored without the end-of-string character
+	 */
+	if( utf8_string[ utf8_string_length - 1 ] == 0 )
+	{
+		utf8_string_length -= 1;
+	}
+	internal_file->password = (uint8_t *) memory_allocate(
+	                                       sizeof( uint8_t ) * ( utf8_string_length + 1 ) );
+
+	if( internal_file->password == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create password.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->password_size = utf8_string_length + 1;
+
+	if( memory_copy(
+	     internal_file->password,
+	     utf8_string,
+	     utf8_string_length ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy password.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->password[ utf8_string_length ] = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	libqcow_internal_file_clear_keys(
+	 internal_file,
+	 NULL );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Sets an UTF-16 formatted password
+ * The password is used as the AES-CBC key, of which only the first 16 bytes are used,
+ * or to unlock one of the LUKS key slots
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful, 0 if password is invalid or -1 on error
+ */
+int libqcow_file_set_utf16_password(
+     libqcow_file_t *file,
+     const uint16_t *utf16_string,
+     size_t utf16_string_length,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_utf16_password";
+	size_t utf8_string_size                = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_clear_keys(
+	     internal_file,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to clear keys.",
+		 function );
+
+		goto on_error;
+	}
+	if( libuna_utf8_string_size_from_utf16(
+	     (libuna_utf16_character_t *) utf16_string,
+	     utf16_string_length,
+	     &utf8_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to determine password size.",
+		 function );
+
+		goto on_error;
+	}
+	if( ( utf8_string_size <= 1 )
+	 || ( utf8_string_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid password size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->password = (uint8_t *) memory_allocate(
+	                                       sizeof( uint8_t ) * utf8_string_size );
+
+	if( internal_file->password == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create password.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->password_size = utf8_string_size;
+
+	if( libuna_utf8_string_copy_from_utf16(
+	     (libuna_utf8_character_t *) internal_file->password,
+	     internal_file->password_size,
+	     (libuna_utf16_character_t *) utf16_string,
+	     utf16_string_length,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to copy password.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	libqcow_internal_file_clear_keys(
+	 internal_file,
+	 NULL );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Retrieves the cache budget
+ * The cache budget is the maximum size in bytes of the level2 table and cluster block caches,
+ * where 0 represents the default
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_cache_budget(
+     libqcow_file_t *file,
+     size64_t *cache_budget,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_cache_budget";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( cache_budget == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache budget.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*cache_budget = internal_file->cache_budget;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the cache budget
+ * The cache budget is the maximum size in bytes of the level2 table and cluster block caches,
+ * where 0 represents the default. The caches of an open file are resized and the cache budget
+ * is also applied to the parent (backing) file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_cache_budget(
+     libqcow_file_t *file,
+     size64_t cache_budget,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *parent_file            = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_cache_budget";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->cache_budget = cache_budget;
+
+	if( internal_file->cluster_block_cache != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* The readahead worker thread accesses the caches without the read/write lock
+		 */
+		if( libcthreads_mutex_grab(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab cache mutex.",
+			 function );
+
+			libcthreads_read_write_lock_release_for_write(
+			 internal_file->read_write_lock,
+			 NULL );
+
+			return( -1 );
+		}
+#endif
+		if( libqcow_internal_file_determine_cache_entries(
+		     internal_file,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine number of cache entries.",
+			 function );
+
+			result = -1;
+		}
+		/* The modified level 2 tables are written before the level 2 table cache
+		 * can evict one of them
+		 */
+		else if( ( internal_file->write_failed == 0 )
+		      && ( libqcow_internal_file_write_modified_metadata(
+		            internal_file,
+		            internal_file->file_io_handle,
+		            error ) != 1 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write modified metadata.",
+			 function );
+
+			result = -1;
+		}
+		else if( libqcow_block_cache_resize(
+		          internal_file->level2_table_cache,
+		          internal_file->number_of_level2_table_cache_entries,
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize level2 table cache.",
+			 function );
+
+			result = -1;
+		}
+		else if( libqcow_block_cache_resize(
+		          internal_file->cluster_block_cache,
+		          internal_file->number_of_cluster_block_cache_entries,
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize cluster block cache.",
+			 function );
+
+			result = -1;
+		}
+		else if( libqcow_block_cache_resize(
+		          internal_file->compressed_cluster_block_cache,
+		          internal_file->number_of_compressed_cluster_block_cache_entries,
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize compressed cluster block cache.",
+			 function );
+
+			result = -1;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_release(
+		     internal_file->cache_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release cache mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+	}
+	parent_file = internal_file->parent_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( ( result == 1 )
+	 && ( parent_file != NULL ) )
+	{
+		if( libqcow_file_set_cache_budget(
+		     parent_file,
+		     cache_budget,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cache budget of parent file.",
+			 function );
+
+			result = -1;
+		}
+	}
+	return( result );
+}
+
+/* Retrieves the IO queue depth
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_io_queue_depth(
+     libqcow_file_t *file,
+     int *queue_depth,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_io_queue_depth";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( queue_depth == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid queue depth.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*queue_depth = internal_file->io_queue_depth;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the IO queue depth
+ * The IO queue depth is the maximum number of reads of the file that are in flight at the same time,
+ * where 1 represents synchronous reads. A queue depth larger than 1 uses io_uring on Linux, when available,
+ * for files that are opened by filename for reading only. The queue depth takes effect when the file is opened
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_io_queue_depth(
+     libqcow_file_t *file,
+     int queue_depth,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_io_queue_depth";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( queue_depth <= 0 )
+	 || ( queue_depth > LIBQCOW_MAXIMUM_IO_QUEUE_DEPTH ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid queue depth value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->io_queue_depth = queue_depth;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the value to indicate if the file should be memory-mapped
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_use_memory_map(
+     libqcow_file_t *file,
+     uint8_t *use_memory_map,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_use_memory_map";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( use_memory_map == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid use memory map.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*use_memory_map = internal_file->use_memory_map;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the value to indicate if the file should be memory-mapped
+ * A memory-mapped file reads uncompressed cluster blocks directly from the mapping instead of
+ * through the cluster block cache. It is only used for unencrypted files that are opened by filename
+ * for reading only, when memory mapping is available, and takes precedence over the IO queue depth.
+ * The value takes effect when the file is opened
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_use_memory_map(
+     libqcow_file_t *file,
+     uint8_t use_memory_map,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_use_memory_map";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( use_memory_map > 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported use memory map.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->use_memory_map = use_memory_map;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the number of readahead cluster blocks
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file,
+     int *number_of_cluster_blocks,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_number_of_readahead_cluster_blocks";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( number_of_cluster_blocks == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of cluster blocks.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*number_of_cluster_blocks = internal_file->number_of_readahead_cluster_blocks;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the number of readahead cluster blocks
+ * After sequential reads are detected, up to this number of cluster blocks that follow the last read
+ * are read, decompressed and decrypted by a worker thread, where 0 disables readahead.
+ * Readahead requires multi-thread support and is only used when the file is opened for reading only.
+ * The number of readahead cluster blocks is also applied to the parent (backing) file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file,
+     int number_of_cluster_blocks,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *parent_file            = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_number_of_readahead_cluster_blocks";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( number_of_cluster_blocks < 0 )
+	 || ( number_of_cluster_blocks > LIBQCOW_MAXIMUM_NUMBER_OF_READAHEAD_CLUSTER_BLOCKS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of cluster blocks value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->number_of_readahead_cluster_blocks = number_of_cluster_blocks;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->readahead != NULL )
+	{
+		if( libqcow_readahead_free(
+		     &( internal_file->readahead ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free readahead.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( ( result == 1 )
+	 && ( libqcow_internal_file_start_readahead(
+	      internal_file,
+	      error ) != 1 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to start readahead.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	parent_file = internal_file->parent_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( ( result == 1 )
+	 && ( parent_file != NULL ) )
+	{
+		if( libqcow_file_set_number_of_readahead_cluster_blocks(
+		     parent_file,
+		     number_of_cluster_blocks,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set number of readahead cluster blocks of parent file.",
+			 function );
+
+			result = -1;
+		}
+	}
+	return( result );
+}
+
+/* Retrieves the number of decompression threads
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_number_of_decompression_threads(
+     libqcow_file_t *file,
+     int *number_of_threads,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_number_of_decompression_threads";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( number_of_threads == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of threads.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*number_of_threads = internal_file->number_of_decompression_threads;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the number of decompression threads
+ * A read that spans multiple cluster blocks decompresses its compressed cluster blocks in parallel
+ * using this number of worker threads, where 0 disables parallel decompression.
+ * Parallel decompression requires multi-thread support and is only used when the file is opened
+ * for reading only and is not encrypted.
+ * The number of decompression threads is also applied to the parent (backing) file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_number_of_decompression_threads(
+     libqcow_file_t *file,
+     int number_of_threads,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *parent_file            = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_number_of_decompression_threads";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( number_of_threads < 0 )
+	 || ( number_of_threads > LIBQCOW_MAXIMUM_NUMBER_OF_DECOMPRESSION_THREADS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of threads value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->number_of_decompression_threads = number_of_threads;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( internal_file->decompression_pool != NULL )
+	{
+		if( libqcow_decompression_pool_free(
+		     &( internal_file->decompression_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free decompression pool.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( ( result == 1 )
+	 && ( libqcow_internal_file_start_decompression_pool(
+	      internal_file,
+	      error ) != 1 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to start decompression pool.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	parent_file = internal_file->parent_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( ( result == 1 )
+	 && ( parent_file != NULL ) )
+	{
+		if( libqcow_file_set_number_of_decompression_threads(
+		     parent_file,
+		     number_of_threads,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set number of decompression threads of parent file.",
+			 function );
+
+			result = -1;
+		}
+	}
+	return( result );
+}
+
+/* Retrieves the hit, miss and eviction statistics of a specific cache
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_cache_statistics(
+     libqcow_file_t *file,
+     int cache_type,
+     uint64_t *number_of_hits,
+     uint64_t *number_of_misses,
+     uint64_t *number_of_evictions,
+     libcerror_error_t **error )
+{
+	libqcow_block_cache_t *block_cache     = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_cache_statistics";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( cache_type != LIBQCOW_CACHE_TYPE_LEVEL2_TABLES )
+	 && ( cache_type != LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS )
+	 && ( cache_type != LIBQCOW_CACHE_TYPE_COMPRESSED_CLUSTER_BLOCKS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported cache type.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+#endif
+	switch( cache_type )
+	{
+		case LIBQCOW_CACHE_TYPE_LEVEL2_TABLES:
+			block_cache = internal_file->level2_table_cache;
+			break;
+
+		case LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS:
+			block_cache = internal_file->cluster_block_cache;
+			break;
+
+		case LIBQCOW_CACHE_TYPE_COMPRESSED_CLUSTER_BLOCKS:
+			block_cache = internal_file->compressed_cluster_block_cache;
+			break;
+	}
+	if( block_cache == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing cache.",
+		 function );
+
+		result = -1;
+	}
+	else if( libqcow_block_cache_get_statistics(
+	          block_cache,
+	          number_of_hits,
+	          number_of_misses,
+	          number_of_evictions,
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cache statistics.",
+		 function );
+
+		result = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		libcthreads_read_write_lock_release_for_read(
+		 internal_file->read_write_lock,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the media size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_media_size(
+     libqcow_file_t *file,
+     size64_t *media_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_media_size";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( media_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid media size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*media_size = internal_file->media_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the format version
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_format_version(
+     libqcow_file_t *file,
+     uint32_t *format_version,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_format_version";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( format_version == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid format version.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*format_version = internal_file->file_header->format_version;
 
-on_error:
-	if( safe_cluster_block != NULL )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
-		libqcow_cluster_block_free(
-		 &safe_cluster_block,
-		 NULL );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
 	}
-	return( -1 );
+#endif
+	return( 1 );
 }
 
-/* Reads (media) data from the current offset into a buffer using a Basic File IO (bfio) handle
- * This function is not multi-thread safe acquire write lock before call
- * Returns the number of bytes read or -1 on error
+/* Retrieves the encryption method
+ * Returns 1 if successful or -1 on error
  */
-ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
-         libqcow_internal_file_t *internal_file,
-         libbfio_handle_t *file_io_handle,
-         void *buffer,
-         size_t buffer_size,
-         libcerror_error_t **error )
+int libqcow_file_get_encryption_method(
+     libqcow_file_t *file,
+     uint32_t *encryption_method,
+     libcerror_error_t **error )
 {
-	libqcow_cluster_block_t *cluster_block = NULL;
-	static char *function                  = "libqcow_internal_file_read_buffer_from_file_io_handle";
-	size_t buffer_offset                   = 0;
-	size_t read_size                       = 0;
-	ssize_t read_count                     = 0;
-	uint64_t cluster_block_data_offset     = 0;
-	uint64_t cluster_block_file_offset     = 0;
-	uint8_t cluster_block_is_compressed    = 0;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_encryption_method";
 
-	if( internal_file == NULL )
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -2516,249 +14999,168 @@ ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->current_offset < 0 )
+	if( encryption_method == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - current offset value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid encryption method.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_size == 0 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - cluster block size value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->backing_filename != NULL )
+#endif
+	*encryption_method = internal_file->encryption_method;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
-		if( internal_file->parent_file == NULL )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: invalid file - missing parent file.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
 
-			return( -1 );
-		}
+		return( -1 );
 	}
-	if( buffer == NULL )
+#endif
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded backing filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_file_get_utf8_backing_filename_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf8_backing_filename_size";
+	int result                             = 0;
+
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
 		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid buffer.",
+		 "%s: invalid file.",
 		 function );
 
 		return( -1 );
 	}
-	if( buffer_size > (size_t) SSIZE_MAX )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
-		 "%s: invalid buffer size value exceeds maximum.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( (size64_t) internal_file->current_offset >= internal_file->file_header->media_size )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
-		return( 0 );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
 	}
-	while( buffer_offset < buffer_size )
-	{
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: current offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
-			 function,
-			 internal_file->current_offset,
-			 internal_file->current_offset );
-		}
 #endif
-		if( libqcow_internal_file_get_cluster_block_offset(
-		     internal_file,
-		     file_io_handle,
-		     internal_file->current_offset,
-		     &cluster_block_file_offset,
-		     &cluster_block_data_offset,
-		     &cluster_block_is_compressed,
-		     error ) != 1 )
+	if( internal_file->backing_filename != NULL )
+	{
+		result = libuna_utf8_string_size_from_utf8_stream(
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          utf8_string_size,
+		          error );
+
+		if( result != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 internal_file->current_offset,
-			 internal_file->current_offset );
-
-			return( -1 );
-		}
-		read_size = internal_file->cluster_block_size - (size_t) cluster_block_data_offset;
-
-		if( ( (size64_t) internal_file->current_offset + read_size ) > internal_file->file_header->media_size )
-		{
-			read_size = (size_t) ( internal_file->file_header->media_size - internal_file->current_offset );
-		}
-		if( ( buffer_offset + read_size ) > buffer_size )
-		{
-			read_size = buffer_size - buffer_offset;
-		}
-		if( cluster_block_file_offset > 0 )
-		{
-			if( libqcow_internal_file_read_cluster_block(
-			     internal_file,
-			     file_io_handle,
-			     cluster_block_file_offset,
-			     cluster_block_data_offset,
-			     cluster_block_is_compressed,
-			     &cluster_block,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_IO,
-				 LIBCERROR_IO_ERROR_READ_FAILED,
-				 "%s: unable to read cluster block.",
-				 function );
-
-				return( -1 );
-			}
-			if( cluster_block == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-				 "%s: invalid cluster block.",
-				 function );
-
-				return( -1 );
-			}
-			if( cluster_block->data == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-				 "%s: invalid cluster block - missing data.",
-				 function );
-
-				return( -1 );
-			}
-			if( memory_copy(
-			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-			     &( cluster_block->data[ cluster_block_data_offset ] ),
-			     read_size ) == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
-				 "%s: unable to copy cluster block data to buffer.",
-				 function );
-
-				return( -1 );
-			}
-		}
-		else if( internal_file->parent_file != NULL )
-		{
-			read_count = libqcow_file_read_buffer_at_offset(
-				      internal_file->parent_file,
-				      &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-				      buffer_size - buffer_offset,
-				      internal_file->current_offset,
-				      error );
-
-			if( read_count == -1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_IO,
-				 LIBCERROR_IO_ERROR_READ_FAILED,
-				 "%s: unable to read buffer from parent file.",
-				 function );
-
-				return( -1 );
-			}
-			read_size = (size_t) read_count;
-		}
-		else
-		{
-			/* Handle sparse cluster block
-			 */
-			if( memory_set(
-			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-			     0,
-			     read_size ) == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-				 "%s: unable to set sparse data in buffer.",
-				 function );
-
-				return( -1 );
-			}
-		}
-		internal_file->current_offset += read_size;
-		buffer_offset                 += read_size;
+			 "%s: unable to retrieve UTF-8 string size of backing filename.",
+			 function );
 
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "\n" );
-		}
-#endif
-		if( (size64_t) internal_file->current_offset >= internal_file->file_header->media_size )
-		{
-			break;
+			result = -1;
 		}
 	}
-	return( (ssize_t) buffer_offset );
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
 }
 
-/* Reads (media) data from the current offset into a buffer
- * Returns the number of bytes read or -1 on error
+/* Retrieves the UTF-8 encoded backing filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-ssize_t libqcow_file_read_buffer(
-         libqcow_file_t *file,
-         void *buffer,
-         size_t buffer_size,
-         libcerror_error_t **error )
+int libqcow_file_get_utf8_backing_filename(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_read_buffer";
-	ssize_t read_count                     = 0;
+	static char *function                  = "libqcow_file_get_utf8_backing_filename";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -2785,7 +15187,7 @@ ssize_t libqcow_file_read_buffer(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2793,32 +15195,35 @@ ssize_t libqcow_file_read_buffer(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-		      internal_file,
-		      internal_file->file_io_handle,
-		      buffer,
-		      buffer_size,
-		      error );
-
-	if( read_count == -1 )
+	if( internal_file->backing_filename != NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read buffer.",
-		 function );
+		result = libuna_utf8_string_copy_from_utf8_stream(
+		          utf8_string,
+		          utf8_string_size,
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          error );
 
-		read_count = -1;
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string of backing filename.",
+			 function );
+
+			result = -1;
+		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2826,28 +15231,27 @@ ssize_t libqcow_file_read_buffer(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( read_count );
+	return( result );
 }
 
-/* Reads (media) data at a specific offset
- * Returns the number of bytes read or -1 on error
+/* Retrieves the size of the UTF-16 encoded backing filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-ssize_t libqcow_file_read_buffer_at_offset(
-         libqcow_file_t *file,
-         void *buffer,
-         size_t buffer_size,
-         off64_t offset,
-         libcerror_error_t **error )
+int libqcow_file_get_utf16_backing_filename_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_read_buffer_at_offset";
-	ssize_t read_count                     = 0;
+	static char *function                  = "libqcow_file_get_utf16_backing_filename_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -2874,7 +15278,7 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2882,50 +15286,34 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( libqcow_internal_file_seek_offset(
-	     internal_file,
-	     offset,
-	     SEEK_SET,
-	     error ) == -1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_SEEK_FAILED,
-		 "%s: unable to seek offset.",
-		 function );
-
-		read_count = -1;
-	}
-	else
+	if( internal_file->backing_filename != NULL )
 	{
-		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-			      internal_file,
-			      internal_file->file_io_handle,
-			      buffer,
-			      buffer_size,
-			      error );
+		result = libuna_utf16_string_size_from_utf8_stream(
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          utf16_string_size,
+		          error );
 
-		if( read_count == -1 )
+		if( result != 1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_READ_FAILED,
-			 "%s: unable to read buffer.",
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string size of backing filename.",
 			 function );
 
-			read_count = -1;
+			result = -1;
 		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2933,28 +15321,30 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( read_count );
+	return( result );
 }
 
-/* Seeks a certain offset of the (media) data
- * This function is not multi-thread safe acquire write lock before call
- * Returns the offset if seek is successful or -1 on error
+/* Retrieves the UTF-16 encoded backing filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-off64_t libqcow_internal_file_seek_offset(
-         libqcow_internal_file_t *internal_file,
-         off64_t offset,
-         int whence,
-         libcerror_error_t **error )
+int libqcow_file_get_utf16_backing_filename(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
 {
-	static char *function = "libqcow_internal_file_seek_offset";
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf16_backing_filename";
+	int result                             = 0;
 
-	if( internal_file == NULL )
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -2965,79 +15355,85 @@ off64_t libqcow_internal_file_seek_offset(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
+#endif
 	if( internal_file->backing_filename != NULL )
 	{
-		if( internal_file->parent_file == NULL )
+		result = libuna_utf16_string_copy_from_utf8_stream(
+		          utf16_string,
+		          utf16_string_size,
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          error );
+
+		if( result != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: invalid file - missing parent file.",
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string of backing filename.",
 			 function );
 
-			return( -1 );
+			result = -1;
 		}
 	}
-	if( ( whence != SEEK_CUR )
-	 && ( whence != SEEK_END )
-	 && ( whence != SEEK_SET ) )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: unsupported whence.",
-		 function );
-
-		return( -1 );
-	}
-	if( whence == SEEK_CUR )
-	{
-		offset += internal_file->current_offset;
-	}
-	else if( whence == SEEK_END )
-	{
-		offset += (off64_t) internal_file->file_header->media_size;
-	}
-	if( offset < 0 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid offset value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
-	internal_file->current_offset = offset;
-
-	return( offset );
+#endif
+	return( result );
 }
 
-/* Seeks a certain offset of the (media) data
- * Returns the offset if seek is successful or -1 on error
+/* Retrieves the size of the UTF-8 encoded backing format
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-off64_t libqcow_file_seek_offset(
-         libqcow_file_t *file,
-         off64_t offset,
-         int whence,
-         libcerror_error_t **error )
+int libqcow_file_get_utf8_backing_format_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_seek_offset";
+	static char *function                  = "libqcow_file_get_utf8_backing_format_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3064,7 +15460,7 @@ off64_t libqcow_file_seek_offset(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3072,31 +15468,34 @@ off64_t libqcow_file_seek_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	offset = libqcow_internal_file_seek_offset(
-	          internal_file,
-	          offset,
-	          whence,
-	          error );
+	if( internal_file->backing_format != NULL )
+	{
+		result = libuna_utf8_string_size_from_utf8_stream(
+		          internal_file->backing_format,
+		          internal_file->backing_format_size,
+		          utf8_string_size,
+		          error );
 
-	if( offset == -1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_SEEK_FAILED,
-		 "%s: unable to seek offset.",
-		 function );
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string size of backing format.",
+			 function );
 
-		offset = -1;
+			result = -1;
+		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3104,25 +15503,28 @@ off64_t libqcow_file_seek_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( offset );
+	return( result );
 }
 
-/* Retrieves the current offset of the (media) data
- * Returns 1 if successful or -1 on error
+/* Retrieves the UTF-8 encoded backing format
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_get_offset(
+int libqcow_file_get_utf8_backing_format(
      libqcow_file_t *file,
-     off64_t *offset,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_offset";
+	static char *function                  = "libqcow_file_get_utf8_backing_format";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3148,17 +15550,6 @@ int libqcow_file_get_offset(
 
 		return( -1 );
 	}
-	if( offset == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid offset.",
-		 function );
-
-		return( -1 );
-	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
@@ -3174,8 +15565,27 @@ int libqcow_file_get_offset(
 		return( -1 );
 	}
 #endif
-	*offset = internal_file->current_offset;
+	if( internal_file->backing_format != NULL )
+	{
+		result = libuna_utf8_string_copy_from_utf8_stream(
+		          utf8_string,
+		          utf8_string_size,
+		          internal_file->backing_format,
+		          internal_file->backing_format_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string of backing format.",
+			 function );
 
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -3191,19 +15601,21 @@ int libqcow_file_get_offset(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
-/* Sets the parent (backing) file of a differential image
- * Returns 1 if successful or -1 on error
+/* Retrieves the size of the UTF-16 encoded backing format
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_set_parent_file(
+int libqcow_file_get_utf16_backing_format_size(
      libqcow_file_t *file,
-     libqcow_file_t *parent_file,
+     size_t *utf16_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_parent_file";
+	static char *function                  = "libqcow_file_get_utf16_backing_format_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3218,30 +15630,19 @@ int libqcow_file_set_parent_file(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->backing_filename == NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing backing filename.",
-		 function );
-
-		return( -1 );
-	}
-	if( internal_file->parent_file != NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - parent file already set.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3249,16 +15650,34 @@ int libqcow_file_set_parent_file(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	internal_file->parent_file = parent_file;
+	if( internal_file->backing_format != NULL )
+	{
+		result = libuna_utf16_string_size_from_utf8_stream(
+		          internal_file->backing_format,
+		          internal_file->backing_format_size,
+		          utf16_string_size,
+		          error );
 
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string size of backing format.",
+			 function );
+
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3266,27 +15685,28 @@ int libqcow_file_set_parent_file(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
-/* Set the keys
- * This function needs to be used before one of the open functions
- * Returns 1 if successful or -1 on error
+/* Retrieves the UTF-16 encoded backing format
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_set_keys(
+int libqcow_file_get_utf16_backing_format(
      libqcow_file_t *file,
-     const uint8_t *key,
-     size_t key_size,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_keys";
+	static char *function                  = "libqcow_file_get_utf16_backing_format";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3301,41 +15721,19 @@ int libqcow_file_set_keys(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle != NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
-		 function );
-
-		return( -1 );
-	}
-	if( key == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid key.",
-		 function );
-
-		return( -1 );
-	}
-	if( key_size != 16 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: unsupported key size.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3343,30 +15741,35 @@ int libqcow_file_set_keys(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( memory_copy(
-	     internal_file->key_data,
-	     key,
-	     key_size ) == NULL )
+	if( internal_file->backing_format != NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
-		 "%s: unable to copy key.",
-		 function );
+		result = libuna_utf16_string_copy_from_utf8_stream(
+		          utf16_string,
+		          utf16_string_size,
+		          internal_file->backing_format,
+		          internal_file->backing_format_size,
+		          error );
 
-		goto on_error;
-	}
-	internal_file->key_data_is_set = 1;
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string of backing format.",
+			 function );
 
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3374,40 +15777,27 @@ int libqcow_file_set_keys(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( 1 );
-
-on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
-	return( -1 );
+	return( result );
 }
 
-/* Sets an UTF-8 formatted password
- * This function needs to be used before one of the open functions
- * Returns 1 if successful, 0 if password is invalid or -1 on error
+/* Retrieves the size of the UTF-8 encoded external data filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_set_utf8_password(
+int libqcow_file_get_utf8_data_filename_size(
      libqcow_file_t *file,
-     const uint8_t *utf8_string,
-     size_t utf8_string_length,
+     size_t *utf8_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_utf8_password";
+	static char *function                  = "libqcow_file_get_utf8_data_filename_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3422,19 +15812,19 @@ int libqcow_file_set_utf8_password(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle != NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3442,47 +15832,34 @@ int libqcow_file_set_utf8_password(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( memory_set(
-	     internal_file->key_data,
-	     0,
-	     16 ) == NULL )
+	if( internal_file->data_filename != NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-		 "%s: unable to clear key data.",
-		 function );
-
-		goto on_error;
-	}
-	if( libuna_byte_stream_copy_from_utf8(
-	     internal_file->key_data,
-	     16,
-	     LIBQCOW_CODEPAGE_US_ASCII,
-	     utf8_string,
-	     utf8_string_length,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to copy password.",
-		 function );
+		result = libuna_utf8_string_size_from_utf8_stream(
+		          internal_file->data_filename,
+		          internal_file->data_filename_size,
+		          utf8_string_size,
+		          error );
 
-		goto on_error;
-	}
-	internal_file->key_data_is_set = 1;
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string size of external data filename.",
+			 function );
 
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3490,40 +15867,28 @@ int libqcow_file_set_utf8_password(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( 1 );
-
-on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
-	return( -1 );
+	return( result );
 }
 
-/* Sets an UTF-16 formatted password
- * This function needs to be used before one of the open functions
- * Returns 1 if successful, 0 if password is invalid or -1 on error
+/* Retrieves the UTF-8 encoded external data filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_set_utf16_password(
+int libqcow_file_get_utf8_data_filename(
      libqcow_file_t *file,
-     const uint16_t *utf16_string,
-     size_t utf16_string_length,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_utf16_password";
+	static char *function                  = "libqcow_file_get_utf8_data_filename";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3538,19 +15903,19 @@ int libqcow_file_set_utf16_password(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle != NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3558,47 +15923,35 @@ int libqcow_file_set_utf16_password(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( memory_set(
-	     internal_file->key_data,
-	     0,
-	     16 ) == NULL )
+	if( internal_file->data_filename != NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-		 "%s: unable to clear key data.",
-		 function );
+		result = libuna_utf8_string_copy_from_utf8_stream(
+		          utf8_string,
+		          utf8_string_size,
+		          internal_file->data_filename,
+		          internal_file->data_filename_size,
+		          error );
 
-		goto on_error;
-	}
-	if( libuna_byte_stream_copy_from_utf16(
-	     internal_file->key_data,
-	     16,
-	     LIBQCOW_CODEPAGE_US_ASCII,
-	     utf16_string,
-	     utf16_string_length,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to copy password.",
-		 function );
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string of external data filename.",
+			 function );
 
-		goto on_error;
+			result = -1;
+		}
 	}
-	internal_file->key_data_is_set = 1;
-
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3606,38 +15959,27 @@ int libqcow_file_set_utf16_password(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( 1 );
-
-on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
-	return( -1 );
+	return( result );
 }
 
-/* Retrieves the media size
- * Returns 1 if successful or -1 on error
+/* Retrieves the size of the UTF-16 encoded external data filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_get_media_size(
+int libqcow_file_get_utf16_data_filename_size(
      libqcow_file_t *file,
-     size64_t *media_size,
+     size_t *utf16_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_media_size";
+	static char *function                  = "libqcow_file_get_utf16_data_filename_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3652,24 +15994,13 @@ int libqcow_file_get_media_size(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_header == NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
-		 function );
-
-		return( -1 );
-	}
-	if( media_size == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid media size.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
@@ -3689,8 +16020,26 @@ int libqcow_file_get_media_size(
 		return( -1 );
 	}
 #endif
-	*media_size = internal_file->file_header->media_size;
+	if( internal_file->data_filename != NULL )
+	{
+		result = libuna_utf16_string_size_from_utf8_stream(
+		          internal_file->data_filename,
+		          internal_file->data_filename_size,
+		          utf16_string_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string size of external data filename.",
+			 function );
 
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -3706,19 +16055,22 @@ int libqcow_file_get_media_size(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
-/* Retrieves the format version
- * Returns 1 if successful or -1 on error
+/* Retrieves the UTF-16 encoded external data filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-int libqcow_file_get_format_version(
+int libqcow_file_get_utf16_data_filename(
      libqcow_file_t *file,
-     uint32_t *format_version,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_format_version";
+	static char *function                  = "libqcow_file_get_utf16_data_filename";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3733,24 +16085,13 @@ int libqcow_file_get_format_version(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_header == NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
-		 function );
-
-		return( -1 );
-	}
-	if( format_version == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid format version.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
@@ -3770,8 +16111,27 @@ int libqcow_file_get_format_version(
 		return( -1 );
 	}
 #endif
-	*format_version = internal_file->file_header->format_version;
+	if( internal_file->data_filename != NULL )
+	{
+		result = libuna_utf16_string_copy_from_utf8_stream(
+		          utf16_string,
+		          utf16_string_size,
+		          internal_file->data_filename,
+		          internal_file->data_filename_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string of external data filename.",
+			 function );
 
+			result = -1;
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -3787,19 +16147,19 @@ int libqcow_file_get_format_version(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
-/* Retrieves the encryption method
+/* Retrieves the number of snapshots
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_encryption_method(
+int libqcow_file_get_number_of_snapshots(
      libqcow_file_t *file,
-     uint32_t *encryption_method,
+     int *number_of_snapshots,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_encryption_method";
+	static char *function                  = "libqcow_file_get_number_of_snapshots";
 
 	if( file == NULL )
 	{
@@ -3814,24 +16174,24 @@ int libqcow_file_get_encryption_method(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 "%s: invalid file - missing file header.",
 		 function );
 
 		return( -1 );
 	}
-	if( encryption_method == NULL )
+	if( number_of_snapshots == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
 		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid encryption method.",
+		 "%s: invalid number of snapshots.",
 		 function );
 
 		return( -1 );
@@ -3851,7 +16211,7 @@ int libqcow_file_get_encryption_method(
 		return( -1 );
 	}
 #endif
-	*encryption_method = internal_file->encryption_method;
+	*number_of_snapshots = internal_file->number_of_snapshots;
 
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
@@ -3871,18 +16231,18 @@ int libqcow_file_get_encryption_method(
 	return( 1 );
 }
 
-/* Retrieves the size of the UTF-8 encoded backing filename
- * The returned size includes the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+/* Retrieves a specific snapshot
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf8_backing_filename_size(
+int libqcow_file_get_snapshot_by_index(
      libqcow_file_t *file,
-     size_t *utf8_string_size,
+     int snapshot_index,
+     libqcow_snapshot_t **snapshot,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf8_backing_filename_size";
-	int result                             = 0;
+	static char *function                  = "libqcow_file_get_snapshot_by_index";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -3897,13 +16257,35 @@ int libqcow_file_get_utf8_backing_filename_size(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid snapshot value already set.",
 		 function );
 
 		return( -1 );
@@ -3923,25 +16305,32 @@ int libqcow_file_get_utf8_backing_filename_size(
 		return( -1 );
 	}
 #endif
-	if( internal_file->backing_filename != NULL )
+	if( ( snapshot_index < 0 )
+	 || ( snapshot_index >= internal_file->number_of_snapshots ) )
 	{
-		result = libuna_utf8_string_size_from_utf8_stream(
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          utf8_string_size,
-		          error );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid snapshot index value out of bounds.",
+		 function );
 
-		if( result != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-8 string size of backing filename.",
-			 function );
+		result = -1;
+	}
+	else if( libqcow_snapshot_initialize(
+	          snapshot,
+	          internal_file->snapshot_values[ snapshot_index ],
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create snapshot: %d.",
+		 function,
+		 snapshot_index );
 
-			result = -1;
-		}
+		result = -1;
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
@@ -3955,25 +16344,27 @@ int libqcow_file_get_utf8_backing_filename_size(
 		 "%s: unable to release read/write lock for reading.",
 		 function );
 
+		libqcow_snapshot_free(
+		 snapshot,
+		 NULL );
+
 		return( -1 );
 	}
 #endif
 	return( result );
 }
 
-/* Retrieves the UTF-8 encoded backing filename
- * The size should include the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+/* Retrieves the index of the selected snapshot
+ * The snapshot index is -1 if the active image is selected
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf8_backing_filename(
+int libqcow_file_get_selected_snapshot_index(
      libqcow_file_t *file,
-     uint8_t *utf8_string,
-     size_t utf8_string_size,
+     int *snapshot_index,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf8_backing_filename";
-	int result                             = 0;
+	static char *function                  = "libqcow_file_get_selected_snapshot_index";
 
 	if( file == NULL )
 	{
@@ -3988,13 +16379,13 @@ int libqcow_file_get_utf8_backing_filename(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( snapshot_index == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot index.",
 		 function );
 
 		return( -1 );
@@ -4014,27 +16405,8 @@ int libqcow_file_get_utf8_backing_filename(
 		return( -1 );
 	}
 #endif
-	if( internal_file->backing_filename != NULL )
-	{
-		result = libuna_utf8_string_copy_from_utf8_stream(
-		          utf8_string,
-		          utf8_string_size,
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          error );
-
-		if( result != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-8 string of backing filename.",
-			 function );
+	*snapshot_index = internal_file->selected_snapshot_index;
 
-			result = -1;
-		}
-	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -4050,21 +16422,25 @@ int libqcow_file_get_utf8_backing_filename(
 		return( -1 );
 	}
 #endif
-	return( result );
+	return( 1 );
 }
 
-/* Retrieves the size of the UTF-16 encoded backing filename
- * The returned size includes the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+/* Selects a specific snapshot to read from
+ * A snapshot index of -1 selects the active image
+ * Only the level 1 table of the snapshot is read, the level 2 table and cluster block caches
+ * are shared between the snapshots and the active image since these are keyed by file offset
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf16_backing_filename_size(
+int libqcow_file_select_snapshot(
      libqcow_file_t *file,
-     size_t *utf16_string_size,
+     int snapshot_index,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf16_backing_filename_size";
-	int result                             = 0;
+	libqcow_cluster_table_t *snapshot_level1_table = NULL;
+	libqcow_internal_file_t *internal_file         = NULL;
+	libqcow_snapshot_values_t *snapshot_values     = NULL;
+	static char *function                          = "libqcow_file_select_snapshot";
+	size64_t media_size                            = 0;
 
 	if( file == NULL )
 	{
@@ -4090,8 +16466,19 @@ int libqcow_file_get_utf16_backing_filename_size(
 
 		return( -1 );
 	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
+	if( libcthreads_read_write_lock_grab_for_write(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -4099,34 +16486,144 @@ int libqcow_file_get_utf16_backing_filename_size(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( internal_file->backing_filename != NULL )
+	if( ( snapshot_index < -1 )
+	 || ( snapshot_index >= internal_file->number_of_snapshots ) )
 	{
-		result = libuna_utf16_string_size_from_utf8_stream(
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          utf16_string_size,
-		          error );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid snapshot index value out of bounds.",
+		 function );
 
-		if( result != 1 )
+		goto on_error;
+	}
+	if( snapshot_index == -1 )
+	{
+		media_size = internal_file->file_header->media_size;
+	}
+	else
+	{
+		snapshot_values = internal_file->snapshot_values[ snapshot_index ];
+
+		if( snapshot_values == NULL )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-16 string size of backing filename.",
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: missing snapshot: %d values.",
+			 function,
+			 snapshot_index );
+
+			goto on_error;
+		}
+		if( libqcow_cluster_table_initialize(
+		     &snapshot_level1_table,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create snapshot level 1 table.",
 			 function );
 
-			result = -1;
+			goto on_error;
 		}
+		media_size = snapshot_values->media_size;
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
+	/* The cache mutex is held since the readahead worker thread reads the level 1 table
+	 * and the file IO handle without the read/write lock
+	 */
+	if( libcthreads_mutex_grab(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( snapshot_level1_table != NULL )
+	{
+		if( libqcow_cluster_table_read(
+		     snapshot_level1_table,
+		     internal_file->file_io_handle,
+		     snapshot_values->level1_table_offset,
+		     (size_t) snapshot_values->number_of_level1_table_references * 8,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot: %d level 1 table.",
+			 function,
+			 snapshot_index );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			libcthreads_mutex_release(
+			 internal_file->cache_mutex,
+			 NULL );
+#endif
+			goto on_error;
+		}
+	}
+	if( internal_file->snapshot_level1_table != NULL )
+	{
+		if( libqcow_cluster_table_free(
+		     &( internal_file->snapshot_level1_table ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free snapshot level 1 table.",
+			 function );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			libcthreads_mutex_release(
+			 internal_file->cache_mutex,
+			 NULL );
+#endif
+			goto on_error;
+		}
+	}
+	internal_file->snapshot_level1_table   = snapshot_level1_table;
+	internal_file->media_size              = media_size;
+	internal_file->selected_snapshot_index = snapshot_index;
+
+	snapshot_level1_table = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->cache_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release cache mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -4134,28 +16631,39 @@ int libqcow_file_get_utf16_backing_filename_size(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 "%s: unable to release read/write lock for writing.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( result );
+	return( 1 );
+
+on_error:
+	if( snapshot_level1_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &snapshot_level1_table,
+		 NULL );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
 }
 
-/* Retrieves the UTF-16 encoded backing filename
- * The size should include the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+/* Retrieves the number of bitmaps
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf16_backing_filename(
+int libqcow_file_get_number_of_bitmaps(
      libqcow_file_t *file,
-     uint16_t *utf16_string,
-     size_t utf16_string_size,
+     int *number_of_bitmaps,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf16_backing_filename";
-	int result                             = 0;
+	static char *function                  = "libqcow_file_get_number_of_bitmaps";
 
 	if( file == NULL )
 	{
@@ -4170,13 +16678,24 @@ int libqcow_file_get_utf16_backing_filename(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_bitmaps == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of bitmaps.",
 		 function );
 
 		return( -1 );
@@ -4196,27 +16715,8 @@ int libqcow_file_get_utf16_backing_filename(
 		return( -1 );
 	}
 #endif
-	if( internal_file->backing_filename != NULL )
-	{
-		result = libuna_utf16_string_copy_from_utf8_stream(
-		          utf16_string,
-		          utf16_string_size,
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          error );
-
-		if( result != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-16 string of backing filename.",
-			 function );
+	*number_of_bitmaps = internal_file->number_of_bitmaps;
 
-			result = -1;
-		}
-	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -4232,19 +16732,21 @@ int libqcow_file_get_utf16_backing_filename(
 		return( -1 );
 	}
 #endif
-	return( result );
+	return( 1 );
 }
 
-/* Retrieves the number of snapshots
+/* Retrieves a specific bitmap
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_number_of_snapshots(
+int libqcow_file_get_bitmap_by_index(
      libqcow_file_t *file,
-     int *number_of_snapshots,
+     int bitmap_index,
+     libqcow_bitmap_t **bitmap,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_number_of_snapshots";
+	static char *function                  = "libqcow_file_get_bitmap_by_index";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -4270,13 +16772,24 @@ int libqcow_file_get_number_of_snapshots(
 
 		return( -1 );
 	}
-	if( number_of_snapshots == NULL )
+	if( bitmap == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
 		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid number of snapshots.",
+		 "%s: invalid bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	if( *bitmap != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid bitmap value already set.",
 		 function );
 
 		return( -1 );
@@ -4296,9 +16809,34 @@ int libqcow_file_get_number_of_snapshots(
 		return( -1 );
 	}
 #endif
-	/* TODO retrieve number of snapshots from array */
-	*number_of_snapshots = (int) internal_file->file_header->number_of_snapshots;
+	if( ( bitmap_index < 0 )
+	 || ( bitmap_index >= internal_file->number_of_bitmaps ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bitmap index value out of bounds.",
+		 function );
 
+		result = -1;
+	}
+	else if( libqcow_bitmap_initialize(
+	          bitmap,
+	          internal_file,
+	          internal_file->bitmap_values[ bitmap_index ],
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create bitmap: %d.",
+		 function,
+		 bitmap_index );
+
+		result = -1;
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
@@ -4311,9 +16849,13 @@ int libqcow_file_get_number_of_snapshots(
 		 "%s: unable to release read/write lock for reading.",
 		 function );
 
+		libqcow_bitmap_free(
+		 bitmap,
+		 NULL );
+
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
@@ -25,16 +25,25 @@
 #include <common.h>
 #include <types.h>
 
+#include "libqcow_bitmap_values.h"
+#include "libqcow_block_cache.h"
+#include "libqcow_buffer_pool.h"
+#include "libqcow_cluster_block.h"
 #include "libqcow_cluster_table.h"
+#include "libqcow_decompression_pool.h"
+#include "libqcow_definitions.h"
 #include "libqcow_encryption.h"
 #include "libqcow_extern.h"
 #include "libqcow_file_header.h"
 #include "libqcow_io_handle.h"
+#include "libqcow_io_uring.h"
 #include "libqcow_libbfio.h"
 #include "libqcow_libcerror.h"
 #include "libqcow_libcthreads.h"
-#include "libqcow_libfcache.h"
-#include "libqcow_libfdata.h"
+#include "libqcow_mapped_file.h"
+#include "libqcow_readahead.h"
+#include "libqcow_reference_count_block.h"
+#include "libqcow_snapshot_values.h"
 
 #if defined( __cplusplus )
 extern "C" {
@@ -72,6 +81,30 @@ struct libqcow_internal_file
 	 */
 	libqcow_file_header_t *file_header;
 
+	/* The (storage) media size of the selected snapshot or the active image
+	 */
+	size64_t media_size;
+
+	/* The snapshot values
+	 */
+	libqcow_snapshot_values_t **snapshot_values;
+
+	/* The number of snapshots
+	 */
+	int number_of_snapshots;
+
+	/* The index of the selected snapshot, where -1 represents the active image
+	 */
+	int selected_snapshot_index;
+
+	/* The bitmap values
+	 */
+	libqcow_bitmap_values_t **bitmap_values;
+
+	/* The number of bitmaps
+	 */
+	int number_of_bitmaps;
+
 	/* The backing filename
 	 */
 	uint8_t *backing_filename;
@@ -80,6 +113,22 @@ struct libqcow_internal_file
 	 */
 	size_t backing_filename_size;
 
+	/* The backing format
+	 */
+	uint8_t *backing_format;
+
+	/* The backing format size
+	 */
+	size_t backing_format_size;
+
+	/* The external data filename
+	 */
+	uint8_t *data_filename;
+
+	/* The external data filename size
+	 */
+	size_t data_filename_size;
+
 	/* The encryption method
 	 */
 	uint32_t encryption_method;
@@ -89,13 +138,27 @@ struct libqcow_internal_file
 	libqcow_encryption_context_t *encryption_context;
 
 	/* The key data
+	 * Contains the AES-CBC key or the LUKS master key
 	 */
-	uint8_t key_data[ 16 ];
+	uint8_t key_data[ LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ];
+
+	/* The key data size
+	 */
+	size_t key_data_size;
 
 	/* Value to indicate the key data is set
 	 */
 	uint8_t key_data_is_set;
 
+	/* The UTF-8 formatted password
+	 */
+	uint8_t *password;
+
+	/* The password size
+	 * Includes the end-of-string character
+	 */
+	size_t password_size;
+
 	/* The level 1 index bit shift
  	 */
 	uint32_t level1_index_bit_shift;
@@ -104,17 +167,22 @@ struct libqcow_internal_file
 	 */
 	libqcow_cluster_table_t *level1_table;
 
+	/* The level 1 table of the selected snapshot
+	 * The level 1 table of the active image is used if no snapshot is selected
+	 */
+	libqcow_cluster_table_t *snapshot_level1_table;
+
 	/* The level 2 index bit mask
  	 */
 	uint64_t level2_index_bit_mask;
 
-	/* The level 2 table vector
+	/* The level 2 table size
 	 */
-	libfdata_vector_t *level2_table_vector;
+	size_t level2_table_size;
 
 	/* The level2 table cache
 	 */
-	libfcache_cache_t *level2_table_cache;
+	libqcow_block_cache_t *level2_table_cache;
 
 	/* The cluster block size
  	 */
@@ -124,6 +192,19 @@ struct libqcow_internal_file
  	 */
 	uint64_t cluster_block_bit_mask;
 
+	/* Value to indicate the level 2 table entries are extended with a subcluster bitmap
+	 */
+	uint8_t has_extended_level2_entries;
+
+	/* The subcluster block size
+	 * This is the cluster block size if the level 2 table entries are not extended
+ 	 */
+	size64_t subcluster_block_size;
+
+	/* The subcluster block bit mask
+ 	 */
+	uint64_t subcluster_block_bit_mask;
+
 	/* The offset bit mask
  	 */
 	uint64_t offset_bit_mask;
@@ -140,17 +221,70 @@ struct libqcow_internal_file
  	 */
 	uint64_t compression_bit_shift;
 
-	/* The cluster block vector
+	/* The cluster block buffer pool
+	 * Recycles the data of the cluster blocks evicted from the caches
 	 */
-	libfdata_vector_t *cluster_block_vector;
+	libqcow_buffer_pool_t *buffer_pool;
 
 	/* The cluster block cache
 	 */
-	libfcache_cache_t *cluster_block_cache;
+	libqcow_block_cache_t *cluster_block_cache;
 
 	/* The compressed cluster block cache
 	 */
-	libfcache_cache_t *compressed_cluster_block_cache;
+	libqcow_block_cache_t *compressed_cluster_block_cache;
+
+	/* The number of decompressed cluster blocks
+	 */
+	uint64_t number_of_decompressed_cluster_blocks;
+
+	/* The cache budget in bytes, where 0 represents the default
+	 */
+	size64_t cache_budget;
+
+	/* The cache size reserved from the process wide cache budget
+	 */
+	size64_t reserved_cache_size;
+
+	/* The number of level2 table cache entries
+	 */
+	int number_of_level2_table_cache_entries;
+
+	/* The number of cluster block cache entries
+	 */
+	int number_of_cluster_block_cache_entries;
+
+	/* The number of compressed cluster block cache entries
+	 */
+	int number_of_compressed_cluster_block_cache_entries;
+
+	/* The number of cluster blocks to read ahead, where 0 disables readahead
+	 */
+	int number_of_readahead_cluster_blocks;
+
+	/* The maximum number of host file reads that are in flight at the same time
+	 */
+	int io_queue_depth;
+
+	/* The number of threads that decompress the cluster blocks of a read, where 0 disables the threads
+	 */
+	int number_of_decompression_threads;
+
+#if defined( HAVE_LIBQCOW_IO_URING )
+	/* The io_uring that is used to read the host file asynchronously
+	 */
+	libqcow_io_uring_t *io_uring;
+#endif
+
+	/* Value to indicate if the file should be memory-mapped
+	 */
+	uint8_t use_memory_map;
+
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+	/* The memory-mapped file that is used to read uncompressed cluster blocks without the cluster block cache
+	 */
+	libqcow_mapped_file_t *mapped_file;
+#endif
 
 	/* Value to indicate if the file is locked
 	 */
@@ -160,10 +294,107 @@ struct libqcow_internal_file
 	 */
 	libqcow_file_t *parent_file;
 
+	/* The raw parent (backing) file IO handle
+	 */
+	libbfio_handle_t *parent_file_io_handle;
+
+	/* Value to indicate if the raw parent file IO handle was opened inside the library
+	 */
+	uint8_t parent_file_io_handle_opened_in_library;
+
+	/* The raw parent file size
+	 */
+	size64_t parent_file_size;
+
+	/* The external data file IO handle
+	 */
+	libbfio_handle_t *data_file_io_handle;
+
+	/* Value to indicate if the external data file IO handle was opened inside the library
+	 */
+	uint8_t data_file_io_handle_opened_in_library;
+
+	/* The external data file size
+	 */
+	size64_t data_file_size;
+
+	/* Value to indicate the external data file is a raw image
+	 * where the media data is stored at the same offset in the data file
+	 */
+	uint8_t data_file_is_raw;
+
+	/* The access flags
+	 */
+	int access_flags;
+
+	/* The reference count table
+	 */
+	libqcow_cluster_table_t *reference_count_table;
+
+	/* The reference count blocks, one per reference count table reference
+	 */
+	libqcow_reference_count_block_t **reference_count_blocks;
+
+	/* The number of reference count block bits
+	 */
+	uint8_t number_of_reference_count_block_bits;
+
+	/* The previous reference count table offset
+	 * A relocated reference count table is only freed once the new reference count table is written
+	 */
+	off64_t previous_reference_count_table_offset;
+
+	/* The previous number of reference count table clusters
+	 */
+	uint32_t previous_reference_count_table_clusters;
+
+	/* Value to indicate if the file header was modified
+	 */
+	uint8_t file_header_is_modified;
+
+	/* Value to indicate a write failed
+	 * The modified metadata is no longer written since it can refer to clusters whose data was not written
+	 */
+	uint8_t write_failed;
+
+	/* The offset of the next cluster to allocate
+	 */
+	uint64_t next_cluster_offset;
+
+	/* The modified level 2 tables
+	 * These tables are owned by the level2 table cache, which is why
+	 * the modified tables are written before a level 2 table is added to the cache
+	 */
+	libqcow_cluster_table_t **modified_level2_tables;
+
+	/* The modified level 2 table offsets
+	 */
+	uint64_t *modified_level2_table_offsets;
+
+	/* The number of modified level 2 tables
+	 */
+	int number_of_modified_level2_tables;
+
+	/* The maximum number of modified level 2 tables
+	 */
+	int maximum_number_of_modified_level2_tables;
+
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	/* The read/write lock
 	 */
 	libcthreads_read_write_lock_t *read_write_lock;
+
+	/* The cache mutex
+	 */
+	libcthreads_mutex_t *cache_mutex;
+
+	/* The readahead
+	 */
+	libqcow_readahead_t *readahead;
+
+	/* The decompression pool
+	 */
+	libqcow_decompression_pool_t *decompression_pool;
 #endif
 };
 
@@ -217,6 +448,16 @@ int libqcow_internal_file_open_read(
      libbfio_handle_t *file_io_handle,
      libcerror_error_t **error );
 
+int libqcow_internal_file_open_direct_access(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     int access_flags,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_determine_cache_entries(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 int libqcow_internal_file_open_read_backing_filename(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
@@ -224,11 +465,209 @@ int libqcow_internal_file_open_read_backing_filename(
      uint32_t backing_filename_size,
      libcerror_error_t **error );
 
+int libqcow_internal_file_open_read_backing_format(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t backing_format_offset,
+     uint32_t backing_format_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_read_data_filename(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t data_filename_offset,
+     uint32_t data_filename_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_read_encryption_key(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint8_t *key,
+     size_t key_size,
+     size_t *encryption_key_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_read_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_snapshots(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_read_bitmap_directory(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_bitmaps(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_start_readahead(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_start_decompression_pool(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_write(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_write_values(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_is_locked(
      libqcow_file_t *file,
      libcerror_error_t **error );
 
+int libqcow_internal_file_read_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level2_table_offset,
+     libqcow_cluster_table_t **level2_table,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_level2_table_by_index(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level1_table_index,
+     libqcow_cluster_table_t **level2_table,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_cluster_block_offset_from_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     uint8_t *cluster_block_is_compressed,
+     uint8_t *cluster_block_is_zero,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     uint8_t *cluster_block_is_compressed,
+     uint8_t *cluster_block_is_zero,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_extent_at_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     size64_t *extent_size,
+     uint32_t *extent_flags,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_backing_range_size(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     size_t maximum_size,
+     size_t *range_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_cluster_block_file_range(
+     libqcow_internal_file_t *internal_file,
+     uint64_t cluster_block_offset,
+     uint8_t cluster_block_is_compressed,
+     uint64_t *cluster_block_file_offset,
+     size_t *cluster_block_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_decompress_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_decrypt_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     off64_t cluster_block_media_offset,
+     off64_t cluster_block_file_offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_read_uncached_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_block_file_offset,
+     size_t cluster_block_size,
+     off64_t cluster_block_media_offset,
+     uint8_t cluster_block_is_compressed,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_read_cached_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_block_offset,
+     uint64_t cluster_block_data_offset,
+     off64_t cluster_block_media_offset,
+     uint8_t cluster_block_is_compressed,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_read_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_read_contiguous_cluster_blocks_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     size_t *read_size,
+     libcerror_error_t **error );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+int libqcow_internal_file_read_ahead_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_decompress_read_segments(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_read_segment_t *read_segments,
+     size_t number_of_read_segments,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+ssize_t libqcow_internal_file_read_buffer_at_offset_from_raw_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *raw_file_io_handle,
+         size64_t raw_file_size,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_buffer_at_offset_from_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
 ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
          libqcow_internal_file_t *internal_file,
          libbfio_handle_t *file_io_handle,
@@ -251,6 +690,134 @@ ssize_t libqcow_file_read_buffer_at_offset(
          off64_t offset,
          libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+ssize_t libqcow_file_read_buffer_at_offset_concurrent(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+int libqcow_internal_file_read_vectors_from_file_io_handle(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_read_vector_t *read_vectors,
+     int number_of_read_vectors,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_read_vectors(
+     libqcow_file_t *file,
+     libqcow_read_vector_t *read_vectors,
+     int number_of_read_vectors,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_mapped_data_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_grow_reference_count_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     int minimum_number_of_references,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_reference_count_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_offset,
+     libqcow_reference_count_block_t **reference_count_block,
+     int *reference_count_index,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_adjust_reference_count(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t cluster_offset,
+     int adjustment,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_allocate_clusters(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     int number_of_clusters,
+     uint64_t *cluster_offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level2_table_reference,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_append_modified_level2_table(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     uint64_t level2_table_offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_level2_table_for_write(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint64_t level1_table_index,
+     libqcow_cluster_table_t **level2_table,
+     uint64_t *level2_table_offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_set_dirty_flag(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint8_t is_dirty,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_write_modified_metadata(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_write_cluster_block_data(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     const uint8_t *data,
+     size_t data_size,
+     uint64_t file_offset,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_write_buffer_at_offset_to_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         const void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_file_write_buffer(
+         libqcow_file_t *file,
+         const void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_file_write_buffer_at_offset(
+         libqcow_file_t *file,
+         const void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+int libqcow_internal_file_get_data_or_hole_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint8_t find_hole,
+     off64_t *data_or_hole_offset,
+     libcerror_error_t **error );
+
 off64_t libqcow_internal_file_seek_offset(
          libqcow_internal_file_t *internal_file,
          off64_t offset,
@@ -270,12 +837,32 @@ int libqcow_file_get_offset(
      off64_t *offset,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_get_extent_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     size64_t *extent_size,
+     uint32_t *extent_flags,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_set_parent_file(
      libqcow_file_t *file,
      libqcow_file_t *parent_file,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_set_parent_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *parent_file_io_handle,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_data_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *data_file_io_handle,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_set_keys(
      libqcow_file_t *file,
@@ -283,6 +870,10 @@ int libqcow_file_set_keys(
      size_t key_size,
      libcerror_error_t **error );
 
+int libqcow_internal_file_clear_keys(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_set_utf8_password(
      libqcow_file_t *file,
@@ -297,6 +888,75 @@ int libqcow_file_set_utf16_password(
      size_t utf16_string_length,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_get_cache_budget(
+     libqcow_file_t *file,
+     size64_t *cache_budget,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_cache_budget(
+     libqcow_file_t *file,
+     size64_t cache_budget,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_io_queue_depth(
+     libqcow_file_t *file,
+     int *queue_depth,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_io_queue_depth(
+     libqcow_file_t *file,
+     int queue_depth,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_use_memory_map(
+     libqcow_file_t *file,
+     uint8_t *use_memory_map,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_use_memory_map(
+     libqcow_file_t *file,
+     uint8_t use_memory_map,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file,
+     int *number_of_cluster_blocks,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file,
+     int number_of_cluster_blocks,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_number_of_decompression_threads(
+     libqcow_file_t *file,
+     int *number_of_threads,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_number_of_decompression_threads(
+     libqcow_file_t *file,
+     int number_of_threads,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_cache_statistics(
+     libqcow_file_t *file,
+     int cache_type,
+     uint64_t *number_of_hits,
+     uint64_t *number_of_misses,
+     uint64_t *number_of_evictions,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_get_media_size(
      libqcow_file_t *file,
@@ -341,13 +1001,95 @@ int libqcow_file_get_utf16_backing_filename(
      size_t utf16_string_size,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_backing_format_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_backing_format(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_backing_format_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_backing_format(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_data_filename(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_data_filename(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_get_number_of_snapshots(
      libqcow_file_t *file,
      int *number_of_snapshots,
      libcerror_error_t **error );
 
-/* TODO add libqcow_file_get_snapshot_by_index */
+LIBQCOW_EXTERN \
+int libqcow_file_get_snapshot_by_index(
+     libqcow_file_t *file,
+     int snapshot_index,
+     libqcow_snapshot_t **snapshot,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_selected_snapshot_index(
+     libqcow_file_t *file,
+     int *snapshot_index,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_select_snapshot(
+     libqcow_file_t *file,
+     int snapshot_index,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_number_of_bitmaps(
+     libqcow_file_t *file,
+     int *number_of_bitmaps,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_bitmap_by_index(
+     libqcow_file_t *file,
+     int bitmap_index,
+     libqcow_bitmap_t **bitmap,
+     libcerror_error_t **error );
 
 #if defined( __cplusplus )
 }
@@ -25,6 +25,7 @@
 #include <types.h>
 
 #include "libqcow_debug.h"
+#include "libqcow_definitions.h"
 #include "libqcow_file_header.h"
 #include "libqcow_io_handle.h"
 #include "libqcow_libcerror.h"
@@ -144,19 +145,21 @@ int libqcow_file_header_read_data(
      size_t data_size,
      libcerror_error_t **error )
 {
-	static char *function               = "libqcow_file_header_read_data";
-	size_t file_header_data_size        = 0;
-	uint64_t compatible_feature_flags   = 0;
-	uint64_t incompatible_feature_flags = 0;
-	uint64_t safe_level1_table_offset   = 0;
-	uint64_t safe_snapshots_offset      = 0;
-	uint64_t supported_feature_flags    = 0;
-	uint32_t file_header_size           = 0;
+	static char *function                      = "libqcow_file_header_read_data";
+	size_t file_header_data_size               = 0;
+	uint64_t compatible_feature_flags          = 0;
+	uint64_t incompatible_feature_flags        = 0;
+	uint64_t safe_level1_table_offset          = 0;
+	uint64_t safe_reference_count_table_offset = 0;
+	uint64_t safe_snapshots_offset             = 0;
+	uint64_t supported_feature_flags           = 0;
+	uint32_t file_header_size                  = 0;
+	uint16_t compression_method                = LIBQCOW_COMPRESSION_METHOD_DEFLATE;
+	uint8_t compression_type                   = LIBQCOW_COMPRESSION_TYPE_DEFLATE;
 
 #if defined( HAVE_DEBUG_OUTPUT )
-	uint64_t value_64bit                = 0;
-	uint32_t value_32bit                = 0;
-	uint16_t value_16bit                = 0;
+	uint32_t value_32bit                       = 0;
+	uint16_t value_16bit                       = 0;
 #endif
 
 	if( file_header == NULL )
@@ -403,6 +406,18 @@ int libqcow_file_header_read_data(
 		 ( (qcow_file_header_v2_t *) data )->snapshots_offset,
 		 safe_snapshots_offset );
 
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_file_header_v2_t *) data )->reference_count_table_offset,
+		 safe_reference_count_table_offset );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_file_header_v2_t *) data )->reference_count_table_clusters,
+		 file_header->reference_count_table_clusters );
+
+		/* Version 2 uses 16-bit reference counts
+		 */
+		file_header->reference_count_order = 4;
+
 #if defined( HAVE_DEBUG_OUTPUT )
 		if( libcnotify_verbose != 0 )
 		{
@@ -431,21 +446,15 @@ int libqcow_file_header_read_data(
 			 function,
 			 safe_level1_table_offset );
 
-			byte_stream_copy_to_uint64_big_endian(
-			 ( (qcow_file_header_v2_t *) data )->reference_count_table_offset,
-			 value_64bit );
 			libcnotify_printf(
 			 "%s: reference count table offset\t\t: 0x%08" PRIx64 "\n",
 			 function,
-			 value_64bit );
+			 safe_reference_count_table_offset );
 
-			byte_stream_copy_to_uint32_big_endian(
-			 ( (qcow_file_header_v2_t *) data )->reference_count_table_clusters,
-			 value_32bit );
 			libcnotify_printf(
 			 "%s: reference count table clusters\t\t: %" PRIu32 "\n",
 			 function,
-			 value_32bit );
+			 file_header->reference_count_table_clusters );
 
 			libcnotify_printf(
 			 "%s: number of snapshots\t\t\t: %" PRIu32 "\n",
@@ -480,6 +489,14 @@ int libqcow_file_header_read_data(
 		 ( (qcow_file_header_v3_t *) data )->compatible_feature_flags,
 		 compatible_feature_flags );
 
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_file_header_v3_t *) data )->auto_clear_feature_flags,
+		 file_header->auto_clear_feature_flags );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_file_header_v3_t *) data )->reference_count_order,
+		 file_header->reference_count_order );
+
 		byte_stream_copy_to_uint32_big_endian(
 		 ( (qcow_file_header_v3_t *) data )->header_size,
 		 file_header_size );
@@ -497,21 +514,15 @@ int libqcow_file_header_read_data(
 			 function,
 			 compatible_feature_flags );
 
-			byte_stream_copy_to_uint64_big_endian(
-			 ( (qcow_file_header_v3_t *) data )->auto_clear_feature_flags,
-			 value_64bit );
 			libcnotify_printf(
 			 "%s: auto-clear feature flags\t\t\t: 0x%08" PRIx64 "\n",
 			 function,
-			 value_64bit );
+			 file_header->auto_clear_feature_flags );
 
-			byte_stream_copy_to_uint32_big_endian(
-			 ( (qcow_file_header_v3_t *) data )->reference_count_order,
-			 value_32bit );
 			libcnotify_printf(
 			 "%s: reference count order\t\t\t: %" PRIu32 "\n",
 			 function,
-			 value_32bit );
+			 file_header->reference_count_order );
 
 			libcnotify_printf(
 			 "%s: file header size\t\t\t\t: %" PRIu32 "\n",
@@ -536,7 +547,10 @@ int libqcow_file_header_read_data(
 		}
 #endif /* defined( HAVE_DEBUG_OUTPUT ) */
 
-		supported_feature_flags = 0x00000001UL;
+		supported_feature_flags = LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_DIRTY
+		                        | LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE
+		                        | LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_COMPRESSION_TYPE
+		                        | LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTENDED_L2;
 
 		if( ( incompatible_feature_flags & ~( supported_feature_flags ) ) != 0 )
 		{
@@ -577,6 +591,44 @@ int libqcow_file_header_read_data(
 
 			return( -1 );
 		}
+		if( file_header_size > 104 )
+		{
+			compression_type = ( (qcow_file_header_v3_t *) data )->compression_type;
+		}
+		if( ( ( incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_COMPRESSION_TYPE ) == 0 )
+		 && ( compression_type != LIBQCOW_COMPRESSION_TYPE_DEFLATE ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: invalid compression type: %" PRIu8 " without compression type feature flag.",
+			 function,
+			 compression_type );
+
+			return( -1 );
+		}
+		switch( compression_type )
+		{
+			case LIBQCOW_COMPRESSION_TYPE_DEFLATE:
+				compression_method = LIBQCOW_COMPRESSION_METHOD_DEFLATE;
+				break;
+
+			case LIBQCOW_COMPRESSION_TYPE_ZSTD:
+				compression_method = LIBQCOW_COMPRESSION_METHOD_ZSTD;
+				break;
+
+			default:
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+				 "%s: unsupported compression type: %" PRIu8 ".",
+				 function,
+				 compression_type );
+
+				return( -1 );
+		}
 	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
@@ -589,8 +641,31 @@ int libqcow_file_header_read_data(
 		}
 	}
 #endif
-	file_header->level1_table_offset = (off64_t) safe_level1_table_offset;
-	file_header->snapshots_offset    = (off64_t) safe_snapshots_offset;
+	if( safe_reference_count_table_offset > (uint64_t) INT64_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count table offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	file_header->level1_table_offset          = (off64_t) safe_level1_table_offset;
+	file_header->snapshots_offset             = (off64_t) safe_snapshots_offset;
+	file_header->reference_count_table_offset = (off64_t) safe_reference_count_table_offset;
+	file_header->incompatible_feature_flags   = incompatible_feature_flags;
+	file_header->compression_method           = compression_method;
+
+	if( file_header->format_version == 3 )
+	{
+		file_header->file_header_size = file_header_size;
+	}
+	else
+	{
+		file_header->file_header_size = (uint32_t) file_header_data_size;
+	}
 
 	return( 1 );
 }
@@ -660,6 +735,461 @@ int libqcow_file_header_read_file_io_handle(
 
 		return( -1 );
 	}
+	if( libqcow_file_header_read_extensions_file_io_handle(
+	     file_header,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file header extensions.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads the file header extensions
+ * The header extensions follow the file header and are stored in the first cluster block,
+ * only the backing format, full disk encryption, bitmaps and external data file header extensions are used, other header extensions are ignored
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_header_read_extensions_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	uint8_t extension_data[ 24 ];
+
+	static char *function             = "libqcow_file_header_read_extensions_file_io_handle";
+	size64_t bitmap_directory_size    = 0;
+	size64_t encryption_header_size   = 0;
+	uint64_t bitmap_directory_offset  = 0;
+	uint64_t encryption_header_offset = 0;
+	uint64_t extensions_end_offset    = 0;
+	uint64_t extension_offset         = 0;
+	ssize_t read_count                = 0;
+	uint32_t extension_data_size      = 0;
+	uint32_t extension_type           = 0;
+	uint32_t number_of_bitmaps        = 0;
+
+	if( file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file header.",
+		 function );
+
+		return( -1 );
+	}
+	/* Format version 1 does not support header extensions
+	 */
+	if( file_header->format_version == 1 )
+	{
+		return( 1 );
+	}
+	if( ( file_header->number_of_cluster_block_bits <= 8 )
+	 || ( file_header->number_of_cluster_block_bits > 63 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of cluster block bits value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	extensions_end_offset = (uint64_t) 1 << file_header->number_of_cluster_block_bits;
+
+	if( ( file_header->backing_filename_offset > 0 )
+	 && ( file_header->backing_filename_offset < extensions_end_offset ) )
+	{
+		extensions_end_offset = file_header->backing_filename_offset;
+	}
+	extension_offset = file_header->file_header_size;
+
+	while( ( extension_offset + 8 ) <= extensions_end_offset )
+	{
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              extension_data,
+		              8,
+		              (off64_t) extension_offset,
+		              error );
+
+		if( read_count != (ssize_t) 8 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read header extension at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+			 function,
+			 extension_offset,
+			 extension_offset );
+
+			return( -1 );
+		}
+		byte_stream_copy_to_uint32_big_endian(
+		 &( extension_data[ 0 ] ),
+		 extension_type );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 &( extension_data[ 4 ] ),
+		 extension_data_size );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: header extension type\t\t\t: 0x%08" PRIx32 "\n",
+			 function,
+			 extension_type );
+
+			libcnotify_printf(
+			 "%s: header extension data size\t\t: %" PRIu32 "\n",
+			 function,
+			 extension_data_size );
+		}
+#endif
+		if( extension_type == LIBQCOW_HEADER_EXTENSION_TYPE_END )
+		{
+			break;
+		}
+		extension_offset += 8;
+
+		if( (uint64_t) extension_data_size > ( extensions_end_offset - extension_offset ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid header extension data size value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		/* The backing format is stored in the header extension data and is not terminated by an end of string character
+		 */
+		if( extension_type == LIBQCOW_HEADER_EXTENSION_TYPE_BACKING_FORMAT )
+		{
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: backing format offset\t\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 extension_offset );
+
+				libcnotify_printf(
+				 "%s: backing format size\t\t\t: %" PRIu32 "\n",
+				 function,
+				 extension_data_size );
+			}
+#endif
+			file_header->backing_format_offset = (off64_t) extension_offset;
+			file_header->backing_format_size   = extension_data_size;
+		}
+		else if( extension_type == LIBQCOW_HEADER_EXTENSION_TYPE_FULL_DISK_ENCRYPTION )
+		{
+			if( extension_data_size < 16 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid full disk encryption header extension data size value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              file_io_handle,
+			              extension_data,
+			              16,
+			              (off64_t) extension_offset,
+			              error );
+
+			if( read_count != (ssize_t) 16 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read full disk encryption header extension data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 extension_offset,
+				 extension_offset );
+
+				return( -1 );
+			}
+			byte_stream_copy_to_uint64_big_endian(
+			 &( extension_data[ 0 ] ),
+			 encryption_header_offset );
+
+			byte_stream_copy_to_uint64_big_endian(
+			 &( extension_data[ 8 ] ),
+			 encryption_header_size );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: encryption header offset\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 encryption_header_offset );
+
+				libcnotify_printf(
+				 "%s: encryption header size\t\t\t: %" PRIu64 "\n",
+				 function,
+				 encryption_header_size );
+			}
+#endif
+			if( ( encryption_header_offset == 0 )
+			 || ( encryption_header_offset > (uint64_t) INT64_MAX ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid encryption header offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			file_header->encryption_header_offset = (off64_t) encryption_header_offset;
+			file_header->encryption_header_size   = encryption_header_size;
+		}
+		else if( extension_type == LIBQCOW_HEADER_EXTENSION_TYPE_BITMAPS )
+		{
+			if( extension_data_size < 24 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid bitmaps header extension data size value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              file_io_handle,
+			              extension_data,
+			              24,
+			              (off64_t) extension_offset,
+			              error );
+
+			if( read_count != (ssize_t) 24 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read bitmaps header extension data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+				 function,
+				 extension_offset,
+				 extension_offset );
+
+				return( -1 );
+			}
+			byte_stream_copy_to_uint32_big_endian(
+			 &( extension_data[ 0 ] ),
+			 number_of_bitmaps );
+
+			byte_stream_copy_to_uint64_big_endian(
+			 &( extension_data[ 8 ] ),
+			 bitmap_directory_size );
+
+			byte_stream_copy_to_uint64_big_endian(
+			 &( extension_data[ 16 ] ),
+			 bitmap_directory_offset );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: number of bitmaps\t\t\t: %" PRIu32 "\n",
+				 function,
+				 number_of_bitmaps );
+
+				libcnotify_printf(
+				 "%s: bitmap directory size\t\t\t: %" PRIu64 "\n",
+				 function,
+				 bitmap_directory_size );
+
+				libcnotify_printf(
+				 "%s: bitmap directory offset\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 bitmap_directory_offset );
+			}
+#endif
+			if( bitmap_directory_offset > (uint64_t) INT64_MAX )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid bitmap directory offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			file_header->number_of_bitmaps       = number_of_bitmaps;
+			file_header->bitmap_directory_offset = (off64_t) bitmap_directory_offset;
+			file_header->bitmap_directory_size   = bitmap_directory_size;
+		}
+		/* The external data filename is stored in the header extension data and is not terminated by an end of string character
+		 */
+		else if( extension_type == LIBQCOW_HEADER_EXTENSION_TYPE_EXTERNAL_DATA_FILE )
+		{
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: external data filename offset\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 extension_offset );
+
+				libcnotify_printf(
+				 "%s: external data filename size\t\t: %" PRIu32 "\n",
+				 function,
+				 extension_data_size );
+			}
+#endif
+			file_header->data_filename_offset = (off64_t) extension_offset;
+			file_header->data_filename_size   = extension_data_size;
+		}
+		/* The header extension data is padded to a multiple of 8 bytes
+		 */
+		extension_offset += ( (uint64_t) extension_data_size + 7 ) & ~( (uint64_t) 7 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	return( 1 );
+}
+
+/* Writes the file header
+ * Only the reference count table, incompatible and auto-clear feature flags values are written,
+ * the other values of the file header are not modified
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_header_write_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	uint8_t file_header_data[ sizeof( qcow_file_header_v3_t ) ];
+
+	static char *function        = "libqcow_file_header_write_file_io_handle";
+	size_t file_header_data_size = 0;
+	ssize_t read_count           = 0;
+	ssize_t write_count          = 0;
+
+	if( file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_header->format_version == 2 )
+	{
+		file_header_data_size = sizeof( qcow_file_header_v2_t );
+	}
+	else if( file_header->format_version == 3 )
+	{
+		file_header_data_size = sizeof( qcow_file_header_v3_t );
+	}
+	else
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported format version: %" PRIu32 ".",
+		 function,
+		 file_header->format_version );
+
+		return( -1 );
+	}
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              file_header_data,
+	              file_header_data_size,
+	              0,
+	              error );
+
+	if( read_count != (ssize_t) file_header_data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file header data at offset: 0 (0x00000000).",
+		 function );
+
+		return( -1 );
+	}
+	byte_stream_copy_from_uint64_big_endian(
+	 ( (qcow_file_header_v2_t *) file_header_data )->reference_count_table_offset,
+	 file_header->reference_count_table_offset );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 ( (qcow_file_header_v2_t *) file_header_data )->reference_count_table_clusters,
+	 file_header->reference_count_table_clusters );
+
+	if( file_header->format_version == 3 )
+	{
+		byte_stream_copy_from_uint64_big_endian(
+		 ( (qcow_file_header_v3_t *) file_header_data )->incompatible_feature_flags,
+		 file_header->incompatible_feature_flags );
+
+		byte_stream_copy_from_uint64_big_endian(
+		 ( (qcow_file_header_v3_t *) file_header_data )->auto_clear_feature_flags,
+		 file_header->auto_clear_feature_flags );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: writing file header at offset: 0 (0x00000000)\n",
+		 function );
+	}
+#endif
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               file_io_handle,
+	               file_header_data,
+	               file_header_data_size,
+	               0,
+	               error );
+
+	if( write_count != (ssize_t) file_header_data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write file header data at offset: 0 (0x00000000).",
+		 function );
+
+		return( -1 );
+	}
 	return( 1 );
 }
 
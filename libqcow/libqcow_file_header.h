@@ -79,6 +79,70 @@ struct libqcow_file_header
 	/* The snapshots offset
  	 */
 	off64_t snapshots_offset;
+
+	/* The reference count table offset
+ 	 */
+	off64_t reference_count_table_offset;
+
+	/* The number of reference count table clusters
+ 	 */
+	uint32_t reference_count_table_clusters;
+
+	/* The reference count order
+ 	 */
+	uint32_t reference_count_order;
+
+	/* The incompatible feature flags
+ 	 */
+	uint64_t incompatible_feature_flags;
+
+	/* The auto-clear feature flags
+ 	 */
+	uint64_t auto_clear_feature_flags;
+
+	/* The compression method
+ 	 */
+	uint16_t compression_method;
+
+	/* The file header size, which is the offset of the header extensions
+	 */
+	uint32_t file_header_size;
+
+	/* The full disk encryption (LUKS) header offset
+	 */
+	off64_t encryption_header_offset;
+
+	/* The full disk encryption (LUKS) header size
+	 */
+	size64_t encryption_header_size;
+
+	/* The number of bitmaps
+	 */
+	uint32_t number_of_bitmaps;
+
+	/* The bitmap directory offset
+	 */
+	off64_t bitmap_directory_offset;
+
+	/* The bitmap directory size
+	 */
+	size64_t bitmap_directory_size;
+
+	/* The backing format offset
+	 */
+	off64_t backing_format_offset;
+
+	/* The backing format size
+	 */
+	uint32_t backing_format_size;
+
+	/* The external data filename offset
+	 */
+	off64_t data_filename_offset;
+
+	/* The external data filename size
+	 */
+	uint32_t data_filename_size;
 };
 
 int libqcow_file_header_initialize(
@@ -100,6 +164,16 @@ int libqcow_file_header_read_file_io_handle(
      libbfio_handle_t *file_io_handle,
      libcerror_error_t **error );
 
+int libqcow_file_header_read_extensions_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_file_header_write_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
 #if defined( __cplusplus )
 }
 #endif
@@ -0,0 +1,912 @@
+/*
+ * Hash (SHA-1 and SHA-256) and password-based key derivation functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_hash.h"
+#include "libqcow_libcerror.h"
+
+/* The SHA-256 round constants
+ */
+static const uint32_t libqcow_hash_sha256_round_constants[ 64 ] = {
+	0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+	0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+	0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+	0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+	0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+	0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+	0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+	0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL };
+
+#define libqcow_hash_rotate_left( value, number_of_bits ) \
+	( ( ( value ) << ( number_of_bits ) ) | ( ( value ) >> ( 32 - ( number_of_bits ) ) ) )
+
+#define libqcow_hash_rotate_right( value, number_of_bits ) \
+	( ( ( value ) >> ( number_of_bits ) ) | ( ( value ) << ( 32 - ( number_of_bits ) ) ) )
+
+/* Retrieves the size of the hash of a specific hash type
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_hash_get_size(
+     int hash_type,
+     size_t *hash_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_hash_get_size";
+
+	if( hash_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid hash size.",
+		 function );
+
+		return( -1 );
+	}
+	switch( hash_type )
+	{
+		case LIBQCOW_HASH_TYPE_SHA1:
+			*hash_size = LIBQCOW_HASH_SHA1_SIZE;
+			break;
+
+		case LIBQCOW_HASH_TYPE_SHA256:
+			*hash_size = LIBQCOW_HASH_SHA256_SIZE;
+			break;
+
+		default:
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported hash type.",
+			 function );
+
+			return( -1 );
+	}
+	return( 1 );
+}
+
+/* Initializes a hash context
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_hash_initialize(
+     libqcow_hash_context_t *context,
+     int hash_type,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_hash_initialize";
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     context,
+	     0,
+	     sizeof( libqcow_hash_context_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear context.",
+		 function );
+
+		return( -1 );
+	}
+	switch( hash_type )
+	{
+		case LIBQCOW_HASH_TYPE_SHA1:
+			context->hash_values[ 0 ] = 0x67452301UL;
+			context->hash_values[ 1 ] = 0xefcdab89UL;
+			context->hash_values[ 2 ] = 0x98badcfeUL;
+			context->hash_values[ 3 ] = 0x10325476UL;
+			context->hash_values[ 4 ] = 0xc3d2e1f0UL;
+			break;
+
+		case LIBQCOW_HASH_TYPE_SHA256:
+			context->hash_values[ 0 ] = 0x6a09e667UL;
+			context->hash_values[ 1 ] = 0xbb67ae85UL;
+			context->hash_values[ 2 ] = 0x3c6ef372UL;
+			context->hash_values[ 3 ] = 0xa54ff53aUL;
+			context->hash_values[ 4 ] = 0x510e527fUL;
+			context->hash_values[ 5 ] = 0x9b05688cUL;
+			context->hash_values[ 6 ] = 0x1f83d9abUL;
+			context->hash_values[ 7 ] = 0x5be0cd19UL;
+			break;
+
+		default:
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported hash type.",
+			 function );
+
+			return( -1 );
+	}
+	context->hash_type = hash_type;
+
+	return( 1 );
+}
+
+/* Transforms the hash values with a block of 64 bytes
+ */
+void libqcow_hash_transform(
+     libqcow_hash_context_t *context,
+     const uint8_t *block )
+{
+	uint32_t values_32bit[ 80 ];
+
+	uint32_t hash_values[ 8 ];
+	uint32_t value1       = 0;
+	uint32_t value2       = 0;
+	uint8_t value_index   = 0;
+
+	for( value_index = 0;
+	     value_index < 16;
+	     value_index++ )
+	{
+		byte_stream_copy_to_uint32_big_endian(
+		 &( block[ value_index * 4 ] ),
+		 values_32bit[ value_index ] );
+	}
+	for( value_index = 0;
+	     value_index < 8;
+	     value_index++ )
+	{
+		hash_values[ value_index ] = context->hash_values[ value_index ];
+	}
+	if( context->hash_type == LIBQCOW_HASH_TYPE_SHA1 )
+	{
+		for( value_index = 16;
+		     value_index < 80;
+		     value_index++ )
+		{
+			value1 = values_32bit[ value_index - 3 ]
+			       ^ values_32bit[ value_index - 8 ]
+			       ^ values_32bit[ value_index - 14 ]
+			       ^ values_32bit[ value_index - 16 ];
+
+			values_32bit[ value_index ] = libqcow_hash_rotate_left( value1, 1 );
+		}
+		for( value_index = 0;
+		     value_index < 80;
+		     value_index++ )
+		{
+			if( value_index < 20 )
+			{
+				value1 = ( ( hash_values[ 1 ] & hash_values[ 2 ] ) | ( ~( hash_values[ 1 ] ) & hash_values[ 3 ] ) ) + 0x5a827999UL;
+			}
+			else if( value_index < 40 )
+			{
+				value1 = ( hash_values[ 1 ] ^ hash_values[ 2 ] ^ hash_values[ 3 ] ) + 0x6ed9eba1UL;
+			}
+			else if( value_index < 60 )
+			{
+				value1 = ( ( hash_values[ 1 ] & hash_values[ 2 ] ) | ( hash_values[ 1 ] & hash_values[ 3 ] ) | ( hash_values[ 2 ] & hash_values[ 3 ] ) ) + 0x8f1bbcdcUL;
+			}
+			else
+			{
+				value1 = ( hash_values[ 1 ] ^ hash_values[ 2 ] ^ hash_values[ 3 ] ) + 0xca62c1d6UL;
+			}
+			value1 += libqcow_hash_rotate_left( hash_values[ 0 ], 5 )
+			        + hash_values[ 4 ]
+			        + values_32bit[ value_index ];
+
+			hash_values[ 4 ] = hash_values[ 3 ];
+			hash_values[ 3 ] = hash_values[ 2 ];
+			hash_values[ 2 ] = libqcow_hash_rotate_left( hash_values[ 1 ], 30 );
+			hash_values[ 1 ] = hash_values[ 0 ];
+			hash_values[ 0 ] = value1;
+		}
+		for( value_index = 0;
+		     value_index < 5;
+		     value_index++ )
+		{
+			context->hash_values[ value_index ] += hash_values[ value_index ];
+		}
+	}
+	else
+	{
+		for( value_index = 16;
+		     value_index < 64;
+		     value_index++ )
+		{
+			value1 = values_32bit[ value_index - 15 ];
+			value2 = values_32bit[ value_index - 2 ];
+
+			values_32bit[ value_index ] = values_32bit[ value_index - 16 ]
+			                            + ( libqcow_hash_rotate_right( value1, 7 ) ^ libqcow_hash_rotate_right( value1, 18 ) ^ ( value1 >> 3 ) )
+			                            + values_32bit[ value_index - 7 ]
+			                            + ( libqcow_hash_rotate_right( value2, 17 ) ^ libqcow_hash_rotate_right( value2, 19 ) ^ ( value2 >> 10 ) );
+		}
+		for( value_index = 0;
+		     value_index < 64;
+		     value_index++ )
+		{
+			value1 = hash_values[ 7 ]
+			       + ( libqcow_hash_rotate_right( hash_values[ 4 ], 6 ) ^ libqcow_hash_rotate_right( hash_values[ 4 ], 11 ) ^ libqcow_hash_rotate_right( hash_values[ 4 ], 25 ) )
+			       + ( ( hash_values[ 4 ] & hash_values[ 5 ] ) ^ ( ~( hash_values[ 4 ] ) & hash_values[ 6 ] ) )
+			       + libqcow_hash_sha256_round_constants[ value_index ]
+			       + values_32bit[ value_index ];
+
+			value2 = ( libqcow_hash_rotate_right( hash_values[ 0 ], 2 ) ^ libqcow_hash_rotate_right( hash_values[ 0 ], 13 ) ^ libqcow_hash_rotate_right( hash_values[ 0 ], 22 ) )
+			       + ( ( hash_values[ 0 ] & hash_values[ 1 ] ) ^ ( hash_values[ 0 ] & hash_values[ 2 ] ) ^ ( hash_values[ 1 ] & hash_values[ 2 ] ) );
+
+			hash_values[ 7 ] = hash_values[ 6 ];
+			hash_values[ 6 ] = hash_values[ 5 ];
+			hash_values[ 5 ] = hash_values[ 4 ];
+			hash_values[ 4 ] = hash_values[ 3 ] + value1;
+			hash_values[ 3 ] = hash_values[ 2 ];
+			hash_values[ 2 ] = hash_values[ 1 ];
+			hash_values[ 1 ] = hash_values[ 0 ];
+			hash_values[ 0 ] = value1 + value2;
+		}
+		for( value_index = 0;
+		     value_index < 8;
+		     value_index++ )
+		{
+			context->hash_values[ value_index ] += hash_values[ value_index ];
+		}
+	}
+}
+
+/* Updates the hash with data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_hash_update(
+     libqcow_hash_context_t *context,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_hash_update";
+	size_t data_offset    = 0;
+	size_t copy_size      = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	context->total_data_size += data_size;
+
+	if( context->block_data_size > 0 )
+	{
+		copy_size = LIBQCOW_HASH_BLOCK_SIZE - context->block_data_size;
+
+		if( copy_size > data_size )
+		{
+			copy_size = data_size;
+		}
+		if( memory_copy(
+		     &( context->block[ context->block_data_size ] ),
+		     data,
+		     copy_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy data to block.",
+			 function );
+
+			return( -1 );
+		}
+		context->block_data_size += copy_size;
+		data_offset               = copy_size;
+
+		if( context->block_data_size < LIBQCOW_HASH_BLOCK_SIZE )
+		{
+			return( 1 );
+		}
+		libqcow_hash_transform(
+		 context,
+		 context->block );
+
+		context->block_data_size = 0;
+	}
+	while( ( data_size - data_offset ) >= LIBQCOW_HASH_BLOCK_SIZE )
+	{
+		libqcow_hash_transform(
+		 context,
+		 &( data[ data_offset ] ) );
+
+		data_offset += LIBQCOW_HASH_BLOCK_SIZE;
+	}
+	if( data_offset < data_size )
+	{
+		if( memory_copy(
+		     context->block,
+		     &( data[ data_offset ] ),
+		     data_size - data_offset ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy data to block.",
+			 function );
+
+			return( -1 );
+		}
+		context->block_data_size = data_size - data_offset;
+	}
+	return( 1 );
+}
+
+/* Finalizes the hash
+ * The hash size must be the size of the hash of the hash type
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_hash_finalize(
+     libqcow_hash_context_t *context,
+     uint8_t *hash,
+     size_t hash_size,
+     libcerror_error_t **error )
+{
+	static char *function     = "libqcow_hash_finalize";
+	size_t required_hash_size = 0;
+	uint64_t bit_size         = 0;
+	uint8_t value_index       = 0;
+
+	if( context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid context.",
+		 function );
+
+		return( -1 );
+	}
+	if( hash == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid hash.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_hash_get_size(
+	     context->hash_type,
+	     &required_hash_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve hash size.",
+		 function );
+
+		return( -1 );
+	}
+	if( hash_size != required_hash_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid hash size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	bit_size = context->total_data_size * 8;
+
+	/* The data is padded with a 1-bit, 0-bits and the 64-bit data bit size
+	 */
+	context->block[ context->block_data_size++ ] = 0x80;
+
+	if( context->block_data_size > ( LIBQCOW_HASH_BLOCK_SIZE - 8 ) )
+	{
+		while( context->block_data_size < LIBQCOW_HASH_BLOCK_SIZE )
+		{
+			context->block[ context->block_data_size++ ] = 0;
+		}
+		libqcow_hash_transform(
+		 context,
+		 context->block );
+
+		context->block_data_size = 0;
+	}
+	while( context->block_data_size < ( LIBQCOW_HASH_BLOCK_SIZE - 8 ) )
+	{
+		context->block[ context->block_data_size++ ] = 0;
+	}
+	byte_stream_copy_from_uint64_big_endian(
+	 &( context->block[ LIBQCOW_HASH_BLOCK_SIZE - 8 ] ),
+	 bit_size );
+
+	libqcow_hash_transform(
+	 context,
+	 context->block );
+
+	for( value_index = 0;
+	     value_index < (uint8_t) ( hash_size / 4 );
+	     value_index++ )
+	{
+		byte_stream_copy_from_uint32_big_endian(
+		 &( hash[ value_index * 4 ] ),
+		 context->hash_values[ value_index ] );
+	}
+	context->block_data_size = 0;
+
+	return( 1 );
+}
+
+/* Derives a key from a password using PBKDF2 (RFC 2898) with HMAC and the hash type
+ * The inner and outer HMAC padding blocks are processed once, every iteration
+ * only hashes the previous block using a copy of the processed hash contexts
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_hash_pbkdf2(
+     int hash_type,
+     const uint8_t *password,
+     size_t password_size,
+     const uint8_t *salt,
+     size_t salt_size,
+     uint32_t number_of_iterations,
+     uint8_t *output_data,
+     size_t output_data_size,
+     libcerror_error_t **error )
+{
+	libqcow_hash_context_t context;
+	libqcow_hash_context_t inner_context;
+	libqcow_hash_context_t outer_context;
+
+	uint8_t block_number_data[ 4 ];
+	uint8_t hash[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+	uint8_t inner_padding[ LIBQCOW_HASH_BLOCK_SIZE ];
+	uint8_t outer_padding[ LIBQCOW_HASH_BLOCK_SIZE ];
+	uint8_t password_hash[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+	uint8_t result_block[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+
+	static char *function      = "libqcow_hash_pbkdf2";
+	size_t copy_size           = 0;
+	size_t hash_size           = 0;
+	size_t output_data_offset  = 0;
+	size_t padding_index       = 0;
+	uint32_t block_number      = 0;
+	uint32_t iteration_index   = 0;
+	int result                 = 1;
+
+	if( password == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid password.",
+		 function );
+
+		return( -1 );
+	}
+	if( password_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid password size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( salt == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid salt.",
+		 function );
+
+		return( -1 );
+	}
+	if( salt_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid salt size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_iterations == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid number of iterations value zero or less.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid output data.",
+		 function );
+
+		return( -1 );
+	}
+	if( output_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid output data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_hash_get_size(
+	     hash_type,
+	     &hash_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve hash size.",
+		 function );
+
+		return( -1 );
+	}
+	/* A HMAC key that is larger than the block size is replaced by its hash
+	 */
+	if( password_size > LIBQCOW_HASH_BLOCK_SIZE )
+	{
+		if( libqcow_hash_initialize(
+		     &context,
+		     hash_type,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to initialize password hash context.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_hash_update(
+		     &context,
+		     password,
+		     password_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to update password hash.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_hash_finalize(
+		     &context,
+		     password_hash,
+		     hash_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to finalize password hash.",
+			 function );
+
+			goto on_error;
+		}
+		password      = password_hash;
+		password_size = hash_size;
+	}
+	for( padding_index = 0;
+	     padding_index < LIBQCOW_HASH_BLOCK_SIZE;
+	     padding_index++ )
+	{
+		inner_padding[ padding_index ] = 0x36;
+		outer_padding[ padding_index ] = 0x5c;
+
+		if( padding_index < password_size )
+		{
+			inner_padding[ padding_index ] ^= password[ padding_index ];
+			outer_padding[ padding_index ] ^= password[ padding_index ];
+		}
+	}
+	if( libqcow_hash_initialize(
+	     &inner_context,
+	     hash_type,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize inner hash context.",
+		 function );
+
+		goto on_error;
+	}
+	libqcow_hash_transform(
+	 &inner_context,
+	 inner_padding );
+
+	inner_context.total_data_size = LIBQCOW_HASH_BLOCK_SIZE;
+
+	if( libqcow_hash_initialize(
+	     &outer_context,
+	     hash_type,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize outer hash context.",
+		 function );
+
+		goto on_error;
+	}
+	libqcow_hash_transform(
+	 &outer_context,
+	 outer_padding );
+
+	outer_context.total_data_size = LIBQCOW_HASH_BLOCK_SIZE;
+
+	block_number = 1;
+
+	while( output_data_offset < output_data_size )
+	{
+		byte_stream_copy_from_uint32_big_endian(
+		 block_number_data,
+		 block_number );
+
+		context = inner_context;
+
+		if( ( libqcow_hash_update(
+		       &context,
+		       salt,
+		       salt_size,
+		       error ) != 1 )
+		 || ( libqcow_hash_update(
+		       &context,
+		       block_number_data,
+		       4,
+		       error ) != 1 )
+		 || ( libqcow_hash_finalize(
+		       &context,
+		       hash,
+		       hash_size,
+		       error ) != 1 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to calculate inner hash of block: %" PRIu32 ".",
+			 function,
+			 block_number );
+
+			goto on_error;
+		}
+		for( iteration_index = 0;
+		     iteration_index < number_of_iterations;
+		     iteration_index++ )
+		{
+			if( iteration_index > 0 )
+			{
+				context = inner_context;
+
+				if( ( libqcow_hash_update(
+				       &context,
+				       hash,
+				       hash_size,
+				       error ) != 1 )
+				 || ( libqcow_hash_finalize(
+				       &context,
+				       hash,
+				       hash_size,
+				       error ) != 1 ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GENERIC,
+					 "%s: unable to calculate inner hash of block: %" PRIu32 ".",
+					 function,
+					 block_number );
+
+					goto on_error;
+				}
+			}
+			context = outer_context;
+
+			if( ( libqcow_hash_update(
+			       &context,
+			       hash,
+			       hash_size,
+			       error ) != 1 )
+			 || ( libqcow_hash_finalize(
+			       &context,
+			       hash,
+			       hash_size,
+			       error ) != 1 ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GENERIC,
+				 "%s: unable to calculate outer hash of block: %" PRIu32 ".",
+				 function,
+				 block_number );
+
+				goto on_error;
+			}
+			if( iteration_index == 0 )
+			{
+				for( padding_index = 0;
+				     padding_index < hash_size;
+				     padding_index++ )
+				{
+					result_block[ padding_index ] = hash[ padding_index ];
+				}
+			}
+			else
+			{
+				for( padding_index = 0;
+				     padding_index < hash_size;
+				     padding_index++ )
+				{
+					result_block[ padding_index ] ^= hash[ padding_index ];
+				}
+			}
+		}
+		copy_size = output_data_size - output_data_offset;
+
+		if( copy_size > hash_size )
+		{
+			copy_size = hash_size;
+		}
+		if( memory_copy(
+		     &( output_data[ output_data_offset ] ),
+		     result_block,
+		     copy_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy output data.",
+			 function );
+
+			goto on_error;
+		}
+		output_data_offset += copy_size;
+		block_number       += 1;
+	}
+	goto on_exit;
+
+on_error:
+	result = -1;
+
+on_exit:
+	memory_set(
+	 &context,
+	 0,
+	 sizeof( libqcow_hash_context_t ) );
+
+	memory_set(
+	 &inner_context,
+	 0,
+	 sizeof( libqcow_hash_context_t ) );
+
+	memory_set(
+	 &outer_context,
+	 0,
+	 sizeof( libqcow_hash_context_t ) );
+
+	memory_set(
+	 hash,
+	 0,
+	 LIBQCOW_HASH_MAXIMUM_SIZE );
+
+	memory_set(
+	 inner_padding,
+	 0,
+	 LIBQCOW_HASH_BLOCK_SIZE );
+
+	memory_set(
+	 outer_padding,
+	 0,
+	 LIBQCOW_HASH_BLOCK_SIZE );
+
+	memory_set(
+	 password_hash,
+	 0,
+	 LIBQCOW_HASH_MAXIMUM_SIZE );
+
+	memory_set(
+	 result_block,
+	 0,
+	 LIBQCOW_HASH_MAXIMUM_SIZE );
+
+	return( result );
+}
+
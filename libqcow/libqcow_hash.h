@@ -0,0 +1,123 @@
+/*
+ * Hash (SHA-1 and SHA-256) and password-based key derivation functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_HASH_H )
+#define _LIBQCOW_HASH_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The hash types
+ */
+enum LIBQCOW_HASH_TYPES
+{
+	LIBQCOW_HASH_TYPE_SHA1		= 1,
+	LIBQCOW_HASH_TYPE_SHA256	= 2
+};
+
+#define LIBQCOW_HASH_SHA1_SIZE		20
+#define LIBQCOW_HASH_SHA256_SIZE	32
+
+/* The maximum hash size
+ */
+#define LIBQCOW_HASH_MAXIMUM_SIZE	32
+
+/* The size of the block the hash is calculated over
+ */
+#define LIBQCOW_HASH_BLOCK_SIZE		64
+
+typedef struct libqcow_hash_context libqcow_hash_context_t;
+
+/* The hash context is used as a value (on the stack) so that it can be
+ * copied, which allows the HMAC keys to be processed once for all PBKDF2 iterations
+ */
+struct libqcow_hash_context
+{
+	/* The hash type
+	 */
+	int hash_type;
+
+	/* The hash values
+	 */
+	uint32_t hash_values[ 8 ];
+
+	/* The total data size
+	 */
+	uint64_t total_data_size;
+
+	/* The block that contains data that has not been processed
+	 */
+	uint8_t block[ LIBQCOW_HASH_BLOCK_SIZE ];
+
+	/* The block data size
+	 */
+	size_t block_data_size;
+};
+
+int libqcow_hash_get_size(
+     int hash_type,
+     size_t *hash_size,
+     libcerror_error_t **error );
+
+int libqcow_hash_initialize(
+     libqcow_hash_context_t *context,
+     int hash_type,
+     libcerror_error_t **error );
+
+void libqcow_hash_transform(
+     libqcow_hash_context_t *context,
+     const uint8_t *block );
+
+int libqcow_hash_update(
+     libqcow_hash_context_t *context,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_hash_finalize(
+     libqcow_hash_context_t *context,
+     uint8_t *hash,
+     size_t hash_size,
+     libcerror_error_t **error );
+
+int libqcow_hash_pbkdf2(
+     int hash_type,
+     const uint8_t *password,
+     size_t password_size,
+     const uint8_t *salt,
+     size_t salt_size,
+     uint32_t number_of_iterations,
+     uint8_t *output_data,
+     size_t output_data_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_HASH_H ) */
+
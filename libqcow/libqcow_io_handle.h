@@ -27,7 +27,6 @@
 
 #include "libqcow_libbfio.h"
 #include "libqcow_libcerror.h"
-#include "libqcow_libfdata.h"
 
 #if defined( __cplusplus )
 extern "C" {
@@ -56,32 +55,6 @@ int libqcow_io_handle_clear(
      libqcow_io_handle_t *io_handle,
      libcerror_error_t **error );
 
-int libqcow_io_handle_read_level2_table(
-     intptr_t *data_handle,
-     libbfio_handle_t *file_io_handle,
-     libfdata_vector_t *vector,
-     libfdata_cache_t *cache,
-     int element_index,
-     int element_data_file_index,
-     off64_t element_data_offset,
-     size64_t element_data_size,
-     uint32_t element_data_flags,
-     uint8_t read_flags,
-     libcerror_error_t **error );
-
-int libqcow_io_handle_read_cluster_block(
-     intptr_t *data_handle,
-     libbfio_handle_t *file_io_handle,
-     libfdata_vector_t *vector,
-     libfdata_cache_t *cache,
-     int element_index,
-     int element_data_file_index,
-     off64_t element_data_offset,
-     size64_t element_data_size,
-     uint32_t element_data_flags,
-     uint8_t read_flags,
-     libcerror_error_t **error );
-
 #if defined( __cplusplus )
 }
 #endif
@@ -0,0 +1,792 @@
+/*
+ * Linux io_uring asynchronous read functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <narrow_string.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_io_uring.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( HAVE_LIBQCOW_IO_URING )
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* Creates an io_uring
+ * Make sure the value io_uring is referencing, is set to NULL
+ * The file is opened a second time for reading, using its own file descriptor
+ * Returns 1 if successful, 0 if io_uring is not available or -1 on error
+ */
+int libqcow_io_uring_initialize(
+     libqcow_io_uring_t **io_uring,
+     const char *filename,
+     int queue_depth,
+     libcerror_error_t **error )
+{
+	struct io_uring_params parameters;
+
+	static char *function = "libqcow_io_uring_initialize";
+	void *mapped_memory   = NULL;
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	if( *io_uring != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid io_uring value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( queue_depth <= 0 )
+	 || ( queue_depth > LIBQCOW_MAXIMUM_IO_QUEUE_DEPTH ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid queue depth value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*io_uring = memory_allocate_structure(
+	             libqcow_io_uring_t );
+
+	if( *io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create io_uring.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *io_uring,
+	     0,
+	     sizeof( libqcow_io_uring_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear io_uring.",
+		 function );
+
+		memory_free(
+		 *io_uring );
+
+		*io_uring = NULL;
+
+		return( -1 );
+	}
+	( *io_uring )->ring_descriptor = -1;
+	( *io_uring )->file_descriptor = -1;
+	( *io_uring )->queue_depth     = (uint32_t) queue_depth;
+
+	( *io_uring )->requests = (libqcow_io_uring_request_t *) memory_allocate(
+	                                                          sizeof( libqcow_io_uring_request_t ) * queue_depth );
+
+	if( ( *io_uring )->requests == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create requests.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *io_uring )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	( *io_uring )->file_descriptor = open(
+	                                  filename,
+	                                  O_RDONLY | O_CLOEXEC );
+
+	if( ( *io_uring )->file_descriptor == -1 )
+	{
+		goto on_unavailable;
+	}
+	if( memory_set(
+	     &parameters,
+	     0,
+	     sizeof( struct io_uring_params ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear parameters.",
+		 function );
+
+		goto on_error;
+	}
+	/* The kernel, or a seccomp policy, can refuse to create the ring
+	 */
+	( *io_uring )->ring_descriptor = (int) syscall(
+	                                        __NR_io_uring_setup,
+	                                        (unsigned int) queue_depth,
+	                                        &parameters );
+
+	if( ( *io_uring )->ring_descriptor == -1 )
+	{
+		goto on_unavailable;
+	}
+	( *io_uring )->submission_queue_ring_size = parameters.sq_off.array + ( parameters.sq_entries * sizeof( uint32_t ) );
+
+	mapped_memory = mmap(
+	                 NULL,
+	                 ( *io_uring )->submission_queue_ring_size,
+	                 PROT_READ | PROT_WRITE,
+	                 MAP_SHARED | MAP_POPULATE,
+	                 ( *io_uring )->ring_descriptor,
+	                 IORING_OFF_SQ_RING );
+
+	if( mapped_memory == MAP_FAILED )
+	{
+		goto on_unavailable;
+	}
+	( *io_uring )->submission_queue_ring = (uint8_t *) mapped_memory;
+
+	( *io_uring )->submission_queue_entries_size = parameters.sq_entries * sizeof( struct io_uring_sqe );
+
+	mapped_memory = mmap(
+	                 NULL,
+	                 ( *io_uring )->submission_queue_entries_size,
+	                 PROT_READ | PROT_WRITE,
+	                 MAP_SHARED | MAP_POPULATE,
+	                 ( *io_uring )->ring_descriptor,
+	                 IORING_OFF_SQES );
+
+	if( mapped_memory == MAP_FAILED )
+	{
+		goto on_unavailable;
+	}
+	( *io_uring )->submission_queue_entries = (struct io_uring_sqe *) mapped_memory;
+
+	( *io_uring )->completion_queue_ring_size = parameters.cq_off.cqes + ( parameters.cq_entries * sizeof( struct io_uring_cqe ) );
+
+	mapped_memory = mmap(
+	                 NULL,
+	                 ( *io_uring )->completion_queue_ring_size,
+	                 PROT_READ | PROT_WRITE,
+	                 MAP_SHARED | MAP_POPULATE,
+	                 ( *io_uring )->ring_descriptor,
+	                 IORING_OFF_CQ_RING );
+
+	if( mapped_memory == MAP_FAILED )
+	{
+		goto on_unavailable;
+	}
+	( *io_uring )->completion_queue_ring = (uint8_t *) mapped_memory;
+
+	( *io_uring )->submission_queue_tail      = (uint32_t *) &( ( *io_uring )->submission_queue_ring[ parameters.sq_off.tail ] );
+	( *io_uring )->submission_queue_ring_mask = *( (uint32_t *) &( ( *io_uring )->submission_queue_ring[ parameters.sq_off.ring_mask ] ) );
+	( *io_uring )->submission_queue_array     = (uint32_t *) &( ( *io_uring )->submission_queue_ring[ parameters.sq_off.array ] );
+
+	( *io_uring )->completion_queue_head      = (uint32_t *) &( ( *io_uring )->completion_queue_ring[ parameters.cq_off.head ] );
+	( *io_uring )->completion_queue_tail      = (uint32_t *) &( ( *io_uring )->completion_queue_ring[ parameters.cq_off.tail ] );
+	( *io_uring )->completion_queue_ring_mask = *( (uint32_t *) &( ( *io_uring )->completion_queue_ring[ parameters.cq_off.ring_mask ] ) );
+	( *io_uring )->completion_queue_entries   = (struct io_uring_cqe *) &( ( *io_uring )->completion_queue_ring[ parameters.cq_off.cqes ] );
+
+	return( 1 );
+
+on_unavailable:
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: io_uring not available, errno: %d.\n",
+		 function,
+		 errno );
+	}
+#endif
+	libqcow_io_uring_free(
+	 io_uring,
+	 NULL );
+
+	return( 0 );
+
+on_error:
+	if( *io_uring != NULL )
+	{
+		libqcow_io_uring_free(
+		 io_uring,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Frees an io_uring
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_free(
+     libqcow_io_uring_t **io_uring,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_io_uring_free";
+	int result            = 1;
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	if( *io_uring != NULL )
+	{
+		if( ( *io_uring )->completion_queue_ring != NULL )
+		{
+			munmap(
+			 ( *io_uring )->completion_queue_ring,
+			 ( *io_uring )->completion_queue_ring_size );
+		}
+		if( ( *io_uring )->submission_queue_entries != NULL )
+		{
+			munmap(
+			 ( *io_uring )->submission_queue_entries,
+			 ( *io_uring )->submission_queue_entries_size );
+		}
+		if( ( *io_uring )->submission_queue_ring != NULL )
+		{
+			munmap(
+			 ( *io_uring )->submission_queue_ring,
+			 ( *io_uring )->submission_queue_ring_size );
+		}
+		if( ( *io_uring )->ring_descriptor != -1 )
+		{
+			if( close(
+			     ( *io_uring )->ring_descriptor ) != 0 )
+			{
+				libcerror_system_set_error(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+				 errno,
+				 "%s: unable to close ring descriptor.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *io_uring )->file_descriptor != -1 )
+		{
+			if( close(
+			     ( *io_uring )->file_descriptor ) != 0 )
+			{
+				libcerror_system_set_error(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+				 errno,
+				 "%s: unable to close file descriptor.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *io_uring )->requests != NULL )
+		{
+			memory_free(
+			 ( *io_uring )->requests );
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *io_uring )->mutex != NULL )
+		{
+			if( libcthreads_mutex_free(
+			     &( ( *io_uring )->mutex ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free mutex.",
+				 function );
+
+				result = -1;
+			}
+		}
+#endif
+		memory_free(
+		 *io_uring );
+
+		*io_uring = NULL;
+	}
+	return( result );
+}
+
+/* Grabs the io_uring
+ * The queued requests and the rings can only be used by the thread that grabbed the io_uring
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_grab(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_io_uring_grab";
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     io_uring->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Releases the io_uring
+ * The queued requests must have been submitted or discarded
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_release(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_io_uring_release";
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	if( io_uring->number_of_requests != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid io_uring - requests are still queued.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     io_uring->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Appends a read to the queued requests
+ * A read that continues the last queued request, both in the file and in memory, is merged with it.
+ * The queued requests are submitted when the queue is full.
+ * The buffer must remain valid until libqcow_io_uring_submit returns
+ * This function is not multi-thread safe grab the io_uring before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_append_read(
+     libqcow_io_uring_t *io_uring,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t size,
+     libcerror_error_t **error )
+{
+	libqcow_io_uring_request_t *request = NULL;
+	static char *function               = "libqcow_io_uring_append_read";
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( size == 0 )
+	 || ( size > (size_t) LIBQCOW_MAXIMUM_ASYNCHRONOUS_READ_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( io_uring->number_of_requests > 0 )
+	{
+		request = &( io_uring->requests[ io_uring->number_of_requests - 1 ] );
+
+		if( ( ( request->offset + (off64_t) request->size ) == offset )
+		 && ( &( request->buffer[ request->size ] ) == buffer )
+		 && ( ( request->size + size ) <= (size_t) LIBQCOW_MAXIMUM_ASYNCHRONOUS_READ_SIZE ) )
+		{
+			request->size += size;
+
+			return( 1 );
+		}
+	}
+	if( io_uring->number_of_requests >= io_uring->queue_depth )
+	{
+		if( libqcow_io_uring_submit(
+		     io_uring,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to submit requests.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	request = &( io_uring->requests[ io_uring->number_of_requests++ ] );
+
+	request->offset = offset;
+	request->buffer = buffer;
+	request->size   = size;
+
+	return( 1 );
+}
+
+/* Discards the queued requests that were not submitted
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_discard_reads(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_io_uring_discard_reads";
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	io_uring->number_of_requests = 0;
+
+	return( 1 );
+}
+
+/* Adds a submission queue entry for a request
+ */
+static void libqcow_io_uring_add_submission_queue_entry(
+             libqcow_io_uring_t *io_uring,
+             uint32_t request_index )
+{
+	libqcow_io_uring_request_t *request = &( io_uring->requests[ request_index ] );
+	struct io_uring_sqe *entry          = NULL;
+	uint32_t entry_index                = 0;
+	uint32_t tail                       = 0;
+
+	/* Only this process writes the submission queue tail
+	 */
+	tail        = *( io_uring->submission_queue_tail );
+	entry_index = tail & io_uring->submission_queue_ring_mask;
+	entry       = &( io_uring->submission_queue_entries[ entry_index ] );
+
+	request->io_vector.iov_base = request->buffer;
+	request->io_vector.iov_len  = request->size;
+
+	memory_set(
+	 entry,
+	 0,
+	 sizeof( struct io_uring_sqe ) );
+
+	entry->opcode    = IORING_OP_READV;
+	entry->fd        = io_uring->file_descriptor;
+	entry->off       = (uint64_t) request->offset;
+	entry->addr      = (uint64_t) (uintptr_t) &( request->io_vector );
+	entry->len       = 1;
+	entry->user_data = (uint64_t) request_index;
+
+	io_uring->submission_queue_array[ entry_index ] = entry_index;
+
+	__atomic_store_n(
+	 io_uring->submission_queue_tail,
+	 tail + 1,
+	 __ATOMIC_RELEASE );
+}
+
+/* Submits the queued requests and waits for all of them to complete
+ * A short read is continued with a new request
+ * This function is not multi-thread safe grab the io_uring before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_io_uring_submit(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error )
+{
+	libqcow_io_uring_request_t *request = NULL;
+	struct io_uring_cqe *entry          = NULL;
+	static char *function               = "libqcow_io_uring_submit";
+	uint32_t head                       = 0;
+	uint32_t number_of_in_flight        = 0;
+	uint32_t number_to_submit           = 0;
+	uint32_t request_index              = 0;
+	uint32_t tail                       = 0;
+	int error_code                      = 0;
+	int result                          = 0;
+	int32_t read_count                  = 0;
+
+	if( io_uring == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid io_uring.",
+		 function );
+
+		return( -1 );
+	}
+	for( request_index = 0;
+	     request_index < io_uring->number_of_requests;
+	     request_index++ )
+	{
+		libqcow_io_uring_add_submission_queue_entry(
+		 io_uring,
+		 request_index );
+	}
+	number_to_submit             = io_uring->number_of_requests;
+	io_uring->number_of_requests = 0;
+
+	/* All submitted requests are waited for, also after an error,
+	 * since the kernel writes to their buffers
+	 */
+	while( ( number_to_submit > 0 )
+	    || ( number_of_in_flight > 0 ) )
+	{
+		result = (int) syscall(
+		                __NR_io_uring_enter,
+		                io_uring->ring_descriptor,
+		                number_to_submit,
+		                1,
+		                IORING_ENTER_GETEVENTS,
+		                NULL,
+		                0 );
+
+		if( result == -1 )
+		{
+			if( ( errno == EINTR )
+			 || ( errno == EAGAIN )
+			 || ( errno == EBUSY ) )
+			{
+				continue;
+			}
+			libcerror_system_set_error(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 errno,
+			 "%s: unable to enter io_uring.",
+			 function );
+
+			return( -1 );
+		}
+		number_to_submit    -= (uint32_t) result;
+		number_of_in_flight += (uint32_t) result;
+
+		head = *( io_uring->completion_queue_head );
+		tail = __atomic_load_n(
+		        io_uring->completion_queue_tail,
+		        __ATOMIC_ACQUIRE );
+
+		while( head != tail )
+		{
+			entry = &( io_uring->completion_queue_entries[ head & io_uring->completion_queue_ring_mask ] );
+
+			request_index = (uint32_t) entry->user_data;
+			read_count    = entry->res;
+
+			head++;
+
+			number_of_in_flight--;
+
+			if( request_index >= io_uring->queue_depth )
+			{
+				error_code = EIO;
+
+				continue;
+			}
+			request = &( io_uring->requests[ request_index ] );
+
+			if( read_count < 0 )
+			{
+				error_code = -read_count;
+			}
+			else if( read_count == 0 )
+			{
+				/* The caller only reads data that is stored in the file
+				 */
+				error_code = EIO;
+			}
+			else if( (size_t) read_count < request->size )
+			{
+				request->offset += read_count;
+				request->buffer += read_count;
+				request->size   -= (size_t) read_count;
+
+				libqcow_io_uring_add_submission_queue_entry(
+				 io_uring,
+				 request_index );
+
+				number_to_submit++;
+			}
+		}
+		__atomic_store_n(
+		 io_uring->completion_queue_head,
+		 head,
+		 __ATOMIC_RELEASE );
+	}
+	if( error_code != 0 )
+	{
+		libcerror_system_set_error(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 error_code,
+		 "%s: unable to read data.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_IO_URING ) */
+
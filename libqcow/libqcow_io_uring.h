@@ -0,0 +1,194 @@
+/*
+ * Linux io_uring asynchronous read functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_IO_URING_H )
+#define _LIBQCOW_IO_URING_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( HAVE_LINUX_IO_URING_H ) && defined( HAVE_SYS_MMAN_H ) && defined( HAVE_SYS_SYSCALL_H ) && defined( HAVE_FCNTL_H ) && defined( HAVE_UNISTD_H ) && defined( __GNUC__ )
+#define HAVE_LIBQCOW_IO_URING
+#endif
+
+#if defined( HAVE_LIBQCOW_IO_URING )
+
+#include <sys/uio.h>
+
+#include <linux/io_uring.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_io_uring_request libqcow_io_uring_request_t;
+
+struct libqcow_io_uring_request
+{
+	/* The (storage) file offset
+	 */
+	off64_t offset;
+
+	/* The buffer
+	 */
+	uint8_t *buffer;
+
+	/* The size
+	 */
+	size_t size;
+
+	/* The IO vector that is passed to the kernel
+	 */
+	struct iovec io_vector;
+};
+
+typedef struct libqcow_io_uring libqcow_io_uring_t;
+
+/* The io_uring queues reads of a file and submits them as a batch,
+ * so that up to queue depth reads are in flight at the same time
+ * A thread grabs the io_uring before it queues the first read and releases it
+ * after the reads are submitted or discarded
+ */
+struct libqcow_io_uring
+{
+	/* The file descriptor of the ring
+	 */
+	int ring_descriptor;
+
+	/* The file descriptor of the file that is read
+	 */
+	int file_descriptor;
+
+	/* The queue depth, which is the maximum number of requests
+	 */
+	uint32_t queue_depth;
+
+	/* The submission queue ring
+	 */
+	uint8_t *submission_queue_ring;
+
+	/* The submission queue ring size
+	 */
+	size_t submission_queue_ring_size;
+
+	/* The submission queue tail
+	 */
+	uint32_t *submission_queue_tail;
+
+	/* The submission queue ring mask
+	 */
+	uint32_t submission_queue_ring_mask;
+
+	/* The submission queue array
+	 */
+	uint32_t *submission_queue_array;
+
+	/* The submission queue entries
+	 */
+	struct io_uring_sqe *submission_queue_entries;
+
+	/* The submission queue entries size
+	 */
+	size_t submission_queue_entries_size;
+
+	/* The completion queue ring
+	 */
+	uint8_t *completion_queue_ring;
+
+	/* The completion queue ring size
+	 */
+	size_t completion_queue_ring_size;
+
+	/* The completion queue head
+	 */
+	uint32_t *completion_queue_head;
+
+	/* The completion queue tail
+	 */
+	uint32_t *completion_queue_tail;
+
+	/* The completion queue ring mask
+	 */
+	uint32_t completion_queue_ring_mask;
+
+	/* The completion queue entries
+	 */
+	struct io_uring_cqe *completion_queue_entries;
+
+	/* The requests
+	 */
+	libqcow_io_uring_request_t *requests;
+
+	/* The number of queued requests
+	 */
+	uint32_t number_of_requests;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex
+	 */
+	libcthreads_mutex_t *mutex;
+#endif
+};
+
+int libqcow_io_uring_initialize(
+     libqcow_io_uring_t **io_uring,
+     const char *filename,
+     int queue_depth,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_free(
+     libqcow_io_uring_t **io_uring,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_grab(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_release(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_append_read(
+     libqcow_io_uring_t *io_uring,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t size,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_discard_reads(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error );
+
+int libqcow_io_uring_submit(
+     libqcow_io_uring_t *io_uring,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* defined( HAVE_LIBQCOW_IO_URING ) */
+
+#endif /* !defined( _LIBQCOW_IO_URING_H ) */
+
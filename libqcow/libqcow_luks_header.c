@@ -0,0 +1,1164 @@
+/*
+ * LUKS header functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_encryption.h"
+#include "libqcow_hash.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_luks_header.h"
+
+#include "qcow_luks_header.h"
+
+const uint8_t libqcow_luks_header_signature[ 6 ] = {
+	'L', 'U', 'K', 'S', 0xba, 0xbe };
+
+/* Creates a LUKS header
+ * Make sure the value luks_header is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_luks_header_initialize(
+     libqcow_luks_header_t **luks_header,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_luks_header_initialize";
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( *luks_header != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid LUKS header value already set.",
+		 function );
+
+		return( -1 );
+	}
+	*luks_header = memory_allocate_structure(
+	                libqcow_luks_header_t );
+
+	if( *luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create LUKS header.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *luks_header,
+	     0,
+	     sizeof( libqcow_luks_header_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear LUKS header.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *luks_header != NULL )
+	{
+		memory_free(
+		 *luks_header );
+
+		*luks_header = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a LUKS header
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_luks_header_free(
+     libqcow_luks_header_t **luks_header,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_luks_header_free";
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( *luks_header != NULL )
+	{
+		memory_free(
+		 *luks_header );
+
+		*luks_header = NULL;
+	}
+	return( 1 );
+}
+
+/* Reads the LUKS header data
+ * Only LUKS version 1 with the AES-XTS-plain64 encryption method is supported,
+ * which is the encryption method QEMU uses for LUKS encrypted QCOW files
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_luks_header_read_data(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	qcow_luks_key_slot_t *key_slot_data    = NULL;
+	libqcow_luks_key_slot_t *key_slot      = NULL;
+	static char *function                  = "libqcow_luks_header_read_data";
+	int key_slot_index                     = 0;
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size < sizeof( qcow_luks_header_t ) )
+	 || ( data_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: LUKS header data:\n",
+		 function );
+		libcnotify_print_data(
+		 data,
+		 sizeof( qcow_luks_header_t ),
+		 LIBCNOTIFY_PRINT_DATA_FLAG_GROUP_DATA );
+	}
+#endif
+	if( memory_compare(
+	     ( (qcow_luks_header_t *) data )->signature,
+	     libqcow_luks_header_signature,
+	     6 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid signature.",
+		 function );
+
+		return( -1 );
+	}
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_luks_header_t *) data )->format_version,
+	 luks_header->format_version );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_luks_header_t *) data )->master_key_size,
+	 luks_header->master_key_size );
+
+	if( memory_copy(
+	     luks_header->master_key_validation_hash,
+	     ( (qcow_luks_header_t *) data )->master_key_validation_hash,
+	     20 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy master key validation hash.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_copy(
+	     luks_header->master_key_salt,
+	     ( (qcow_luks_header_t *) data )->master_key_salt,
+	     32 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy master key salt.",
+		 function );
+
+		return( -1 );
+	}
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_luks_header_t *) data )->master_key_number_of_iterations,
+	 luks_header->master_key_number_of_iterations );
+
+	for( key_slot_index = 0;
+	     key_slot_index < LIBQCOW_LUKS_NUMBER_OF_KEY_SLOTS;
+	     key_slot_index++ )
+	{
+		key_slot_data = &( ( (qcow_luks_header_t *) data )->key_slots[ key_slot_index ] );
+		key_slot      = &( luks_header->key_slots[ key_slot_index ] );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 key_slot_data->state,
+		 key_slot->state );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 key_slot_data->number_of_iterations,
+		 key_slot->number_of_iterations );
+
+		if( memory_copy(
+		     key_slot->salt,
+		     key_slot_data->salt,
+		     32 ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy key slot: %d salt.",
+			 function,
+			 key_slot_index );
+
+			return( -1 );
+		}
+		byte_stream_copy_to_uint32_big_endian(
+		 key_slot_data->key_material_sector_number,
+		 key_slot->key_material_sector_number );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 key_slot_data->number_of_stripes,
+		 key_slot->number_of_stripes );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: format version\t\t\t\t: %" PRIu16 "\n",
+		 function,
+		 luks_header->format_version );
+
+		libcnotify_printf(
+		 "%s: master key size\t\t\t\t: %" PRIu32 "\n",
+		 function,
+		 luks_header->master_key_size );
+
+		libcnotify_printf(
+		 "%s: master key number of iterations\t\t: %" PRIu32 "\n",
+		 function,
+		 luks_header->master_key_number_of_iterations );
+
+		for( key_slot_index = 0;
+		     key_slot_index < LIBQCOW_LUKS_NUMBER_OF_KEY_SLOTS;
+		     key_slot_index++ )
+		{
+			key_slot = &( luks_header->key_slots[ key_slot_index ] );
+
+			libcnotify_printf(
+			 "%s: key slot: %d state\t\t\t\t: 0x%08" PRIx32 "\n",
+			 function,
+			 key_slot_index,
+			 key_slot->state );
+
+			libcnotify_printf(
+			 "%s: key slot: %d number of iterations\t\t: %" PRIu32 "\n",
+			 function,
+			 key_slot_index,
+			 key_slot->number_of_iterations );
+
+			libcnotify_printf(
+			 "%s: key slot: %d key material sector number\t: %" PRIu32 "\n",
+			 function,
+			 key_slot_index,
+			 key_slot->key_material_sector_number );
+
+			libcnotify_printf(
+			 "%s: key slot: %d number of stripes\t\t: %" PRIu32 "\n",
+			 function,
+			 key_slot_index,
+			 key_slot->number_of_stripes );
+		}
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+
+	if( luks_header->format_version != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported format version: %" PRIu16 ".",
+		 function,
+		 luks_header->format_version );
+
+		return( -1 );
+	}
+	if( memory_compare(
+	     ( (qcow_luks_header_t *) data )->encryption_method,
+	     "aes",
+	     4 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported encryption method.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_compare(
+	     ( (qcow_luks_header_t *) data )->encryption_chaining_mode,
+	     "xts-plain64",
+	     12 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported encryption chaining mode.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_compare(
+	     ( (qcow_luks_header_t *) data )->hashing_method,
+	     "sha1",
+	     5 ) == 0 )
+	{
+		luks_header->hash_type = LIBQCOW_HASH_TYPE_SHA1;
+	}
+	else if( memory_compare(
+	          ( (qcow_luks_header_t *) data )->hashing_method,
+	          "sha256",
+	          7 ) == 0 )
+	{
+		luks_header->hash_type = LIBQCOW_HASH_TYPE_SHA256;
+	}
+	else
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported hashing method.",
+		 function );
+
+		return( -1 );
+	}
+	/* AES-XTS uses 2 keys of either 128 or 256 bits
+	 */
+	if( ( luks_header->master_key_size != 32 )
+	 && ( luks_header->master_key_size != 64 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported master key size: %" PRIu32 ".",
+		 function,
+		 luks_header->master_key_size );
+
+		return( -1 );
+	}
+	if( luks_header->master_key_number_of_iterations == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid master key number of iterations value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads the LUKS header
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_luks_header_read_file_io_handle(
+     libqcow_luks_header_t *luks_header,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error )
+{
+	uint8_t luks_header_data[ sizeof( qcow_luks_header_t ) ];
+
+	static char *function = "libqcow_luks_header_read_file_io_handle";
+	ssize_t read_count    = 0;
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading LUKS header at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 file_offset,
+		 file_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              luks_header_data,
+	              sizeof( qcow_luks_header_t ),
+	              file_offset,
+	              error );
+
+	if( read_count != (ssize_t) sizeof( qcow_luks_header_t ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read LUKS header data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		return( -1 );
+	}
+	if( libqcow_luks_header_read_data(
+	     luks_header,
+	     luks_header_data,
+	     sizeof( qcow_luks_header_t ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Verifies a master key against the master key validation hash
+ * Returns 1 if the master key is valid, 0 if not or -1 on error
+ */
+int libqcow_luks_header_verify_master_key(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error )
+{
+	uint8_t validation_hash[ 20 ];
+
+	static char *function = "libqcow_luks_header_verify_master_key";
+	int result            = 0;
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( master_key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid master key.",
+		 function );
+
+		return( -1 );
+	}
+	if( master_key_size != (size_t) luks_header->master_key_size )
+	{
+		return( 0 );
+	}
+	if( libqcow_hash_pbkdf2(
+	     luks_header->hash_type,
+	     master_key,
+	     master_key_size,
+	     luks_header->master_key_salt,
+	     32,
+	     luks_header->master_key_number_of_iterations,
+	     validation_hash,
+	     20,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GENERIC,
+		 "%s: unable to determine master key validation hash.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_compare(
+	     validation_hash,
+	     luks_header->master_key_validation_hash,
+	     20 ) == 0 )
+	{
+		result = 1;
+	}
+	memory_set(
+	 validation_hash,
+	 0,
+	 20 );
+
+	return( result );
+}
+
+/* Merges the anti-forensic stripes of decrypted key material into the master key
+ * Every stripe, except for the last, is combined with the previous result and diffused
+ * by hashing every hash size block of the result prefixed with its big-endian block number
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_luks_header_merge_stripes(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *key_material,
+     size_t key_material_size,
+     uint32_t number_of_stripes,
+     uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error )
+{
+	libqcow_hash_context_t hash_context;
+
+	uint8_t block_number_data[ 4 ];
+	uint8_t hash[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+
+	static char *function = "libqcow_luks_header_merge_stripes";
+	size_t block_offset   = 0;
+	size_t block_size     = 0;
+	size_t byte_index     = 0;
+	size_t hash_size      = 0;
+	size_t stripe_offset  = 0;
+	uint32_t block_number = 0;
+	uint32_t stripe_index = 0;
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( key_material == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key material.",
+		 function );
+
+		return( -1 );
+	}
+	if( master_key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid master key.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( master_key_size == 0 )
+	 || ( master_key_size > LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid master key size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_stripes == 0 )
+	 || ( key_material_size > (size_t) SSIZE_MAX )
+	 || ( ( key_material_size / master_key_size ) < (size_t) number_of_stripes ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid key material size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_hash_get_size(
+	     luks_header->hash_type,
+	     &hash_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve hash size.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     master_key,
+	     0,
+	     master_key_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear master key.",
+		 function );
+
+		return( -1 );
+	}
+	for( stripe_index = 0;
+	     stripe_index < number_of_stripes;
+	     stripe_index++ )
+	{
+		for( byte_index = 0;
+		     byte_index < master_key_size;
+		     byte_index++ )
+		{
+			master_key[ byte_index ] ^= key_material[ stripe_offset + byte_index ];
+		}
+		stripe_offset += master_key_size;
+
+		if( ( stripe_index + 1 ) == number_of_stripes )
+		{
+			break;
+		}
+		block_number = 0;
+
+		for( block_offset = 0;
+		     block_offset < master_key_size;
+		     block_offset += hash_size )
+		{
+			block_size = master_key_size - block_offset;
+
+			if( block_size > hash_size )
+			{
+				block_size = hash_size;
+			}
+			byte_stream_copy_from_uint32_big_endian(
+			 block_number_data,
+			 block_number );
+
+			if( ( libqcow_hash_initialize(
+			       &hash_context,
+			       luks_header->hash_type,
+			       error ) != 1 )
+			 || ( libqcow_hash_update(
+			       &hash_context,
+			       block_number_data,
+			       4,
+			       error ) != 1 )
+			 || ( libqcow_hash_update(
+			       &hash_context,
+			       &( master_key[ block_offset ] ),
+			       block_size,
+			       error ) != 1 )
+			 || ( libqcow_hash_finalize(
+			       &hash_context,
+			       hash,
+			       hash_size,
+			       error ) != 1 ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GENERIC,
+				 "%s: unable to diffuse stripe: %" PRIu32 ".",
+				 function,
+				 stripe_index );
+
+				goto on_error;
+			}
+			if( memory_copy(
+			     &( master_key[ block_offset ] ),
+			     hash,
+			     block_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy diffused block.",
+				 function );
+
+				goto on_error;
+			}
+			block_number++;
+		}
+	}
+	memory_set(
+	 &hash_context,
+	 0,
+	 sizeof( libqcow_hash_context_t ) );
+
+	memory_set(
+	 hash,
+	 0,
+	 LIBQCOW_HASH_MAXIMUM_SIZE );
+
+	return( 1 );
+
+on_error:
+	memory_set(
+	 &hash_context,
+	 0,
+	 sizeof( libqcow_hash_context_t ) );
+
+	memory_set(
+	 hash,
+	 0,
+	 LIBQCOW_HASH_MAXIMUM_SIZE );
+
+	memory_set(
+	 master_key,
+	 0,
+	 master_key_size );
+
+	return( -1 );
+}
+
+/* Retrieves the master key by unlocking the enabled key slots with a password
+ * For every key slot the key material is decrypted with a key derived from the password,
+ * the anti-forensic stripes are merged and the result is verified as the master key
+ * Returns 1 if successful, 0 if no key slot could be unlocked or -1 on error
+ */
+int libqcow_luks_header_get_master_key_with_password(
+     libqcow_luks_header_t *luks_header,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     const uint8_t *password,
+     size_t password_size,
+     uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error )
+{
+	uint8_t key_slot_key[ LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ];
+
+	libqcow_encryption_context_t *encryption_context = NULL;
+	libqcow_luks_key_slot_t *key_slot                = NULL;
+	uint8_t *key_material                            = NULL;
+	static char *function                            = "libqcow_luks_header_get_master_key_with_password";
+	size_t key_material_size                         = 0;
+	size_t stripes_size                              = 0;
+	ssize_t read_count                               = 0;
+	off64_t key_material_offset                      = 0;
+	int key_slot_index                               = 0;
+	int result                                       = 0;
+
+	if( luks_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid LUKS header.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( luks_header->master_key_size == 0 )
+	 || ( luks_header->master_key_size > LIBQCOW_LUKS_MAXIMUM_KEY_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid LUKS header - master key size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( password == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid password.",
+		 function );
+
+		return( -1 );
+	}
+	if( master_key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid master key.",
+		 function );
+
+		return( -1 );
+	}
+	if( master_key_size != (size_t) luks_header->master_key_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid master key size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	for( key_slot_index = 0;
+	     key_slot_index < LIBQCOW_LUKS_NUMBER_OF_KEY_SLOTS;
+	     key_slot_index++ )
+	{
+		key_slot = &( luks_header->key_slots[ key_slot_index ] );
+
+		if( key_slot->state != LIBQCOW_LUKS_KEY_SLOT_STATE_ENABLED )
+		{
+			continue;
+		}
+		if( ( key_slot->number_of_iterations == 0 )
+		 || ( key_slot->number_of_stripes == 0 )
+		 || ( (size_t) key_slot->number_of_stripes > ( ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE - 512 ) / luks_header->master_key_size ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid key slot: %d - value out of bounds.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		stripes_size = (size_t) luks_header->master_key_size * key_slot->number_of_stripes;
+
+		/* The key material is stored in sectors of 512 bytes
+		 */
+		key_material_size = stripes_size;
+
+		if( ( key_material_size % 512 ) != 0 )
+		{
+			key_material_size += 512 - ( key_material_size % 512 );
+		}
+		key_material = (uint8_t *) memory_allocate(
+		                            sizeof( uint8_t ) * key_material_size );
+
+		if( key_material == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create key material.",
+			 function );
+
+			goto on_error;
+		}
+		key_material_offset = file_offset + ( (off64_t) key_slot->key_material_sector_number * 512 );
+
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              key_material,
+		              key_material_size,
+		              key_material_offset,
+		              error );
+
+		if( read_count != (ssize_t) key_material_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read key slot: %d key material at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 key_slot_index,
+			 key_material_offset,
+			 key_material_offset );
+
+			goto on_error;
+		}
+		if( libqcow_hash_pbkdf2(
+		     luks_header->hash_type,
+		     password,
+		     password_size,
+		     key_slot->salt,
+		     32,
+		     key_slot->number_of_iterations,
+		     key_slot_key,
+		     master_key_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to determine key slot: %d key.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		/* The key material is encrypted with the same encryption method as the data
+		 * where the sector numbers start at the beginning of the key material
+		 */
+		if( libqcow_encryption_initialize(
+		     &encryption_context,
+		     LIBQCOW_ENCRYPTION_METHOD_LUKS,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create encryption context.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_encryption_set_keys(
+		     encryption_context,
+		     key_slot_key,
+		     master_key_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set key slot: %d key in encryption context.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		if( libqcow_encryption_crypt(
+		     encryption_context,
+		     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+		     key_material,
+		     key_material_size,
+		     key_material,
+		     key_material_size,
+		     0,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+			 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+			 "%s: unable to decrypt key slot: %d key material.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		if( libqcow_encryption_free(
+		     &encryption_context,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free encryption context.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_luks_header_merge_stripes(
+		     luks_header,
+		     key_material,
+		     stripes_size,
+		     key_slot->number_of_stripes,
+		     master_key,
+		     master_key_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to merge key slot: %d stripes.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		memory_set(
+		 key_material,
+		 0,
+		 key_material_size );
+
+		memory_free(
+		 key_material );
+
+		key_material = NULL;
+
+		result = libqcow_luks_header_verify_master_key(
+		          luks_header,
+		          master_key,
+		          master_key_size,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to verify key slot: %d master key.",
+			 function,
+			 key_slot_index );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			break;
+		}
+	}
+	if( result == 0 )
+	{
+		memory_set(
+		 master_key,
+		 0,
+		 master_key_size );
+	}
+	memory_set(
+	 key_slot_key,
+	 0,
+	 LIBQCOW_LUKS_MAXIMUM_KEY_SIZE );
+
+	return( result );
+
+on_error:
+	if( encryption_context != NULL )
+	{
+		libqcow_encryption_free(
+		 &encryption_context,
+		 NULL );
+	}
+	if( key_material != NULL )
+	{
+		memory_set(
+		 key_material,
+		 0,
+		 key_material_size );
+
+		memory_free(
+		 key_material );
+	}
+	memory_set(
+	 key_slot_key,
+	 0,
+	 LIBQCOW_LUKS_MAXIMUM_KEY_SIZE );
+
+	memory_set(
+	 master_key,
+	 0,
+	 master_key_size );
+
+	return( -1 );
+}
+
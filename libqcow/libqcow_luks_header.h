@@ -0,0 +1,144 @@
+/*
+ * LUKS header functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_LUKS_HEADER_H )
+#define _LIBQCOW_LUKS_HEADER_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_luks_key_slot libqcow_luks_key_slot_t;
+
+struct libqcow_luks_key_slot
+{
+	/* The state
+	 */
+	uint32_t state;
+
+	/* The number of password (PBKDF2) iterations
+	 */
+	uint32_t number_of_iterations;
+
+	/* The password salt
+	 */
+	uint8_t salt[ 32 ];
+
+	/* The key material sector number
+	 */
+	uint32_t key_material_sector_number;
+
+	/* The number of anti-forensic stripes
+	 */
+	uint32_t number_of_stripes;
+};
+
+typedef struct libqcow_luks_header libqcow_luks_header_t;
+
+struct libqcow_luks_header
+{
+	/* The format version
+	 */
+	uint16_t format_version;
+
+	/* The hash type used for PBKDF2 and the anti-forensic stripes
+	 */
+	int hash_type;
+
+	/* The master key size
+	 */
+	uint32_t master_key_size;
+
+	/* The master key validation hash
+	 */
+	uint8_t master_key_validation_hash[ 20 ];
+
+	/* The master key salt
+	 */
+	uint8_t master_key_salt[ 32 ];
+
+	/* The number of master key (PBKDF2) iterations
+	 */
+	uint32_t master_key_number_of_iterations;
+
+	/* The key slots
+	 */
+	libqcow_luks_key_slot_t key_slots[ LIBQCOW_LUKS_NUMBER_OF_KEY_SLOTS ];
+};
+
+int libqcow_luks_header_initialize(
+     libqcow_luks_header_t **luks_header,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_free(
+     libqcow_luks_header_t **luks_header,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_read_data(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_read_file_io_handle(
+     libqcow_luks_header_t *luks_header,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_verify_master_key(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_merge_stripes(
+     libqcow_luks_header_t *luks_header,
+     const uint8_t *key_material,
+     size_t key_material_size,
+     uint32_t number_of_stripes,
+     uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error );
+
+int libqcow_luks_header_get_master_key_with_password(
+     libqcow_luks_header_t *luks_header,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     const uint8_t *password,
+     size_t password_size,
+     uint8_t *master_key,
+     size_t master_key_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_LUKS_HEADER_H ) */
+
@@ -0,0 +1,534 @@
+/*
+ * Memory-mapped file functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_mapped_file.h"
+
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+
+/* Creates a mapped file
+ * Make sure the value mapped_file is referencing, is set to NULL
+ * The file is opened a second time for reading, using its own file descriptor
+ * Returns 1 if successful, 0 if the file cannot be mapped or -1 on error
+ */
+int libqcow_mapped_file_initialize(
+     libqcow_mapped_file_t **mapped_file,
+     const char *filename,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapped_file_initialize";
+	void *mapped_memory   = NULL;
+	off64_t file_size     = 0;
+	long page_size        = 0;
+
+	if( mapped_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapped file.",
+		 function );
+
+		return( -1 );
+	}
+	if( *mapped_file != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid mapped file value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	*mapped_file = memory_allocate_structure(
+	                libqcow_mapped_file_t );
+
+	if( *mapped_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create mapped file.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *mapped_file,
+	     0,
+	     sizeof( libqcow_mapped_file_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear mapped file.",
+		 function );
+
+		memory_free(
+		 *mapped_file );
+
+		*mapped_file = NULL;
+
+		return( -1 );
+	}
+	( *mapped_file )->file_descriptor = -1;
+	( *mapped_file )->advice          = MADV_NORMAL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *mapped_file )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+
+	page_size = sysconf(
+	             _SC_PAGESIZE );
+
+	if( page_size <= 0 )
+	{
+		goto on_unavailable;
+	}
+	( *mapped_file )->page_size = (size_t) page_size;
+
+	( *mapped_file )->file_descriptor = open(
+	                                     filename,
+	                                     O_RDONLY | O_CLOEXEC );
+
+	if( ( *mapped_file )->file_descriptor == -1 )
+	{
+		goto on_unavailable;
+	}
+	file_size = lseek(
+	             ( *mapped_file )->file_descriptor,
+	             0,
+	             SEEK_END );
+
+	/* An empty file cannot be mapped and the file must fit in the address space
+	 */
+	if( ( file_size <= 0 )
+	 || ( (uint64_t) file_size > (uint64_t) SSIZE_MAX ) )
+	{
+		goto on_unavailable;
+	}
+	mapped_memory = mmap(
+	                 NULL,
+	                 (size_t) file_size,
+	                 PROT_READ,
+	                 MAP_SHARED,
+	                 ( *mapped_file )->file_descriptor,
+	                 0 );
+
+	if( mapped_memory == MAP_FAILED )
+	{
+		goto on_unavailable;
+	}
+	( *mapped_file )->data      = (uint8_t *) mapped_memory;
+	( *mapped_file )->data_size = (size_t) file_size;
+
+	return( 1 );
+
+on_unavailable:
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: unable to map file, errno: %d.\n",
+		 function,
+		 errno );
+	}
+#endif
+	libqcow_mapped_file_free(
+	 mapped_file,
+	 NULL );
+
+	return( 0 );
+
+on_error:
+	if( *mapped_file != NULL )
+	{
+		libqcow_mapped_file_free(
+		 mapped_file,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Frees a mapped file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_mapped_file_free(
+     libqcow_mapped_file_t **mapped_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapped_file_free";
+	int result            = 1;
+
+	if( mapped_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapped file.",
+		 function );
+
+		return( -1 );
+	}
+	if( *mapped_file != NULL )
+	{
+		if( ( *mapped_file )->data != NULL )
+		{
+			if( munmap(
+			     ( *mapped_file )->data,
+			     ( *mapped_file )->data_size ) != 0 )
+			{
+				libcerror_system_set_error(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 errno,
+				 "%s: unable to unmap data.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *mapped_file )->file_descriptor != -1 )
+		{
+			if( close(
+			     ( *mapped_file )->file_descriptor ) != 0 )
+			{
+				libcerror_system_set_error(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+				 errno,
+				 "%s: unable to close file descriptor.",
+				 function );
+
+				result = -1;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *mapped_file )->mutex != NULL )
+		{
+			if( libcthreads_mutex_free(
+			     &( ( *mapped_file )->mutex ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free mutex.",
+				 function );
+
+				result = -1;
+			}
+		}
+#endif
+		memory_free(
+		 *mapped_file );
+
+		*mapped_file = NULL;
+	}
+	return( result );
+}
+
+/* Advises the kernel about the access pattern of the mapped data
+ * Sequential accesses enable sequential readahead and advise that the data
+ * that follows the access will be needed, random accesses disable readahead.
+ * The advice is a hint, failures are ignored and an access is not tracked
+ * while another thread is updating the access pattern
+ */
+void libqcow_mapped_file_advise_access(
+      libqcow_mapped_file_t *mapped_file,
+      off64_t offset,
+      size_t size )
+{
+#if defined( HAVE_MADVISE )
+	size_t advice_offset = 0;
+	size_t advice_size   = 0;
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_try_grab(
+	     mapped_file->mutex,
+	     NULL ) != 1 )
+	{
+		return;
+	}
+#endif
+	if( offset == mapped_file->last_end_offset )
+	{
+		mapped_file->number_of_sequential_accesses += 1;
+		mapped_file->number_of_random_accesses      = 0;
+	}
+	else
+	{
+		mapped_file->number_of_sequential_accesses = 0;
+		mapped_file->number_of_random_accesses     += 1;
+	}
+	mapped_file->last_end_offset = offset + (off64_t) size;
+
+#if defined( HAVE_MADVISE )
+	if( mapped_file->number_of_sequential_accesses >= LIBQCOW_MAPPED_FILE_MINIMUM_NUMBER_OF_SEQUENTIAL_ACCESSES )
+	{
+		if( mapped_file->advice != MADV_SEQUENTIAL )
+		{
+			madvise(
+			 mapped_file->data,
+			 mapped_file->data_size,
+			 MADV_SEQUENTIAL );
+
+			mapped_file->advice               = MADV_SEQUENTIAL;
+			mapped_file->will_need_end_offset = 0;
+		}
+		/* Advise the next part of the data when half of the previously advised part was accessed
+		 */
+		if( ( ( mapped_file->last_end_offset + ( LIBQCOW_MAPPED_FILE_READAHEAD_SIZE / 2 ) ) > mapped_file->will_need_end_offset )
+		 && ( (size_t) mapped_file->will_need_end_offset < mapped_file->data_size ) )
+		{
+			if( mapped_file->will_need_end_offset > mapped_file->last_end_offset )
+			{
+				advice_offset = (size_t) mapped_file->will_need_end_offset;
+			}
+			else
+			{
+				advice_offset = (size_t) mapped_file->last_end_offset;
+			}
+			advice_offset -= advice_offset % mapped_file->page_size;
+
+			if( advice_offset < mapped_file->data_size )
+			{
+				advice_size = mapped_file->data_size - advice_offset;
+
+				if( advice_size > LIBQCOW_MAPPED_FILE_READAHEAD_SIZE )
+				{
+					advice_size = LIBQCOW_MAPPED_FILE_READAHEAD_SIZE;
+				}
+				madvise(
+				 &( mapped_file->data[ advice_offset ] ),
+				 advice_size,
+				 MADV_WILLNEED );
+
+				mapped_file->will_need_end_offset = (off64_t) ( advice_offset + advice_size );
+			}
+		}
+	}
+	else if( mapped_file->number_of_random_accesses >= LIBQCOW_MAPPED_FILE_MINIMUM_NUMBER_OF_RANDOM_ACCESSES )
+	{
+		if( mapped_file->advice != MADV_RANDOM )
+		{
+			madvise(
+			 mapped_file->data,
+			 mapped_file->data_size,
+			 MADV_RANDOM );
+
+			mapped_file->advice = MADV_RANDOM;
+		}
+	}
+#endif /* defined( HAVE_MADVISE ) */
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_mutex_release(
+	 mapped_file->mutex,
+	 NULL );
+#endif
+}
+
+/* Retrieves a pointer to the mapped data at a specific offset
+ * The data remains valid until the mapped file is freed
+ * Returns 1 if successful, 0 if the data is not (entirely) mapped or -1 on error
+ */
+int libqcow_mapped_file_get_data_at_offset(
+     libqcow_mapped_file_t *mapped_file,
+     off64_t offset,
+     size_t size,
+     const uint8_t **data,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapped_file_get_data_at_offset";
+
+	if( mapped_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapped file.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( (uint64_t) offset >= (uint64_t) mapped_file->data_size )
+	 || ( size > ( mapped_file->data_size - (size_t) offset ) ) )
+	{
+		return( 0 );
+	}
+	libqcow_mapped_file_advise_access(
+	 mapped_file,
+	 offset,
+	 size );
+
+	*data = &( mapped_file->data[ offset ] );
+
+	return( 1 );
+}
+
+/* Copies the mapped data at a specific offset into a buffer
+ * Returns 1 if successful, 0 if the data is not (entirely) mapped or -1 on error
+ */
+int libqcow_mapped_file_copy_data_at_offset(
+     libqcow_mapped_file_t *mapped_file,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t size,
+     libcerror_error_t **error )
+{
+	const uint8_t *data   = NULL;
+	static char *function = "libqcow_mapped_file_copy_data_at_offset";
+	int result            = 0;
+
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          offset,
+	          size,
+	          &data,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	else if( result != 0 )
+	{
+		if( memory_copy(
+		     buffer,
+		     data,
+		     size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy data.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( result );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MAPPED_FILE ) */
+
@@ -0,0 +1,125 @@
+/*
+ * Memory-mapped file functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_MAPPED_FILE_H )
+#define _LIBQCOW_MAPPED_FILE_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( HAVE_SYS_MMAN_H ) && defined( HAVE_FCNTL_H ) && defined( HAVE_UNISTD_H ) && !defined( WINAPI )
+#define HAVE_LIBQCOW_MAPPED_FILE
+#endif
+
+#if defined( HAVE_LIBQCOW_MAPPED_FILE )
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_mapped_file libqcow_mapped_file_t;
+
+/* The mapped file maps the entire file read-only into memory
+ */
+struct libqcow_mapped_file
+{
+	/* The file descriptor
+	 */
+	int file_descriptor;
+
+	/* The mapped data
+	 */
+	uint8_t *data;
+
+	/* The mapped data size
+	 */
+	size_t data_size;
+
+	/* The page size
+	 */
+	size_t page_size;
+
+	/* The current access pattern advice
+	 */
+	int advice;
+
+	/* The end offset of the last access
+	 */
+	off64_t last_end_offset;
+
+	/* The number of consecutive sequential accesses
+	 */
+	int number_of_sequential_accesses;
+
+	/* The number of consecutive random accesses
+	 */
+	int number_of_random_accesses;
+
+	/* The end offset of the data that was advised to be read ahead
+	 */
+	off64_t will_need_end_offset;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex, which protects the access pattern
+	 */
+	libcthreads_mutex_t *mutex;
+#endif
+};
+
+int libqcow_mapped_file_initialize(
+     libqcow_mapped_file_t **mapped_file,
+     const char *filename,
+     libcerror_error_t **error );
+
+int libqcow_mapped_file_free(
+     libqcow_mapped_file_t **mapped_file,
+     libcerror_error_t **error );
+
+void libqcow_mapped_file_advise_access(
+      libqcow_mapped_file_t *mapped_file,
+      off64_t offset,
+      size_t size );
+
+int libqcow_mapped_file_get_data_at_offset(
+     libqcow_mapped_file_t *mapped_file,
+     off64_t offset,
+     size_t size,
+     const uint8_t **data,
+     libcerror_error_t **error );
+
+int libqcow_mapped_file_copy_data_at_offset(
+     libqcow_mapped_file_t *mapped_file,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* defined( HAVE_LIBQCOW_MAPPED_FILE ) */
+
+#endif /* !defined( _LIBQCOW_MAPPED_FILE_H ) */
+
@@ -0,0 +1,118 @@
+/*
+ * Run once functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_once.h"
+
+/* Calls a function once
+ * The function is called by the first caller, other callers wait until the function has returned
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_once_execute(
+     libqcow_once_t *once,
+     void (*function)( void ),
+     libcerror_error_t **error )
+{
+	static char *function_name = "libqcow_once_execute";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && !defined( WINAPI ) && defined( HAVE_PTHREAD_H )
+	int result                 = 0;
+#endif
+
+	if( once == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid once.",
+		 function_name );
+
+		return( -1 );
+	}
+	if( function == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid function.",
+		 function_name );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && defined( WINAPI )
+	/* The once state is 0 when not called, 1 while being called and 2 when called
+	 */
+	if( InterlockedCompareExchange(
+	     once,
+	     1,
+	     0 ) == 0 )
+	{
+		function();
+
+		InterlockedExchange(
+		 once,
+		 2 );
+	}
+	else
+	{
+		while( InterlockedCompareExchange(
+		        once,
+		        2,
+		        2 ) != 2 )
+		{
+			Sleep(
+			 0 );
+		}
+	}
+#elif defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && defined( HAVE_PTHREAD_H )
+	result = pthread_once(
+	          once,
+	          function );
+
+	if( result != 0 )
+	{
+		libcerror_system_set_error(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 result,
+		 "%s: unable to call function once.",
+		 function_name );
+
+		return( -1 );
+	}
+#else
+	if( *once == 0 )
+	{
+		function();
+
+		*once = 1;
+	}
+#endif
+	return( 1 );
+}
+
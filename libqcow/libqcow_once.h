@@ -0,0 +1,71 @@
+/*
+ * Run once functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_ONCE_H )
+#define _LIBQCOW_ONCE_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && !defined( WINAPI ) && defined( HAVE_PTHREAD_H )
+#include <pthread.h>
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && defined( WINAPI )
+
+/* InitOnceExecuteOnce requires Windows Vista, hence the once state is maintained by interlocked functions
+ */
+typedef LONG volatile libqcow_once_t;
+
+#define LIBQCOW_ONCE_INITIALIZER	0
+
+#elif defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) && defined( HAVE_PTHREAD_H )
+
+typedef pthread_once_t libqcow_once_t;
+
+#define LIBQCOW_ONCE_INITIALIZER	PTHREAD_ONCE_INIT
+
+#else
+
+typedef uint8_t libqcow_once_t;
+
+#define LIBQCOW_ONCE_INITIALIZER	0
+
+#endif
+
+int libqcow_once_execute(
+     libqcow_once_t *once,
+     void (*function)( void ),
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_ONCE_H ) */
+
@@ -0,0 +1,90 @@
+/*
+ * Read segment functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_read_segment.h"
+
+/* Compares two read segments by their media offset
+ * This function is used as a qsort comparison function
+ * Returns -1 if the first segment is stored before the second, 1 if after or 0 if equal
+ */
+int libqcow_read_segment_compare_by_media_offset(
+     const void *first_read_segment,
+     const void *second_read_segment )
+{
+	const libqcow_read_segment_t *first_segment  = (const libqcow_read_segment_t *) first_read_segment;
+	const libqcow_read_segment_t *second_segment = (const libqcow_read_segment_t *) second_read_segment;
+
+	if( first_segment->media_offset < second_segment->media_offset )
+	{
+		return( -1 );
+	}
+	else if( first_segment->media_offset > second_segment->media_offset )
+	{
+		return( 1 );
+	}
+	if( first_segment->vector_index < second_segment->vector_index )
+	{
+		return( -1 );
+	}
+	else if( first_segment->vector_index > second_segment->vector_index )
+	{
+		return( 1 );
+	}
+	return( 0 );
+}
+
+/* Compares two read segments by their (storage) file offset
+ * Segments with the same file offset are ordered by their media offset,
+ * where segments that are not allocated are stored before segments that read as zero
+ * This function is used as a qsort comparison function
+ * Returns -1 if the first segment is stored before the second, 1 if after or 0 if equal
+ */
+int libqcow_read_segment_compare_by_file_offset(
+     const void *first_read_segment,
+     const void *second_read_segment )
+{
+	const libqcow_read_segment_t *first_segment  = (const libqcow_read_segment_t *) first_read_segment;
+	const libqcow_read_segment_t *second_segment = (const libqcow_read_segment_t *) second_read_segment;
+
+	if( first_segment->file_offset < second_segment->file_offset )
+	{
+		return( -1 );
+	}
+	else if( first_segment->file_offset > second_segment->file_offset )
+	{
+		return( 1 );
+	}
+	if( first_segment->cluster_block_is_zero < second_segment->cluster_block_is_zero )
+	{
+		return( -1 );
+	}
+	else if( first_segment->cluster_block_is_zero > second_segment->cluster_block_is_zero )
+	{
+		return( 1 );
+	}
+	return( libqcow_read_segment_compare_by_media_offset(
+	         first_read_segment,
+	         second_read_segment ) );
+}
+
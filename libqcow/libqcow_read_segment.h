@@ -0,0 +1,92 @@
+/*
+ * Read segment functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_READ_SEGMENT_H )
+#define _LIBQCOW_READ_SEGMENT_H
+
+#include <common.h>
+#include <types.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_read_segment libqcow_read_segment_t;
+
+/* A read segment is the part of a read vector that is stored in a single cluster block
+ */
+struct libqcow_read_segment
+{
+	/* The (media) offset
+	 */
+	off64_t media_offset;
+
+	/* The (storage) file offset, which is 0 if the cluster block is not allocated
+	 */
+	uint64_t file_offset;
+
+	/* The cluster block offset
+	 */
+	uint64_t cluster_block_offset;
+
+	/* The cluster block data offset
+	 */
+	uint64_t cluster_block_data_offset;
+
+	/* The buffer
+	 */
+	uint8_t *buffer;
+
+	/* The size
+	 */
+	size_t size;
+
+	/* The index of the corresponding read vector
+	 */
+	int vector_index;
+
+	/* Value to indicate the cluster block is compressed
+	 */
+	uint8_t cluster_block_is_compressed;
+
+	/* Value to indicate the cluster block reads as zero
+	 */
+	uint8_t cluster_block_is_zero;
+
+	/* Value to indicate the data was decompressed into the buffer by the decompression pool
+	 */
+	uint8_t is_decompressed;
+};
+
+int libqcow_read_segment_compare_by_media_offset(
+     const void *first_read_segment,
+     const void *second_read_segment );
+
+int libqcow_read_segment_compare_by_file_offset(
+     const void *first_read_segment,
+     const void *second_read_segment );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_READ_SEGMENT_H ) */
+
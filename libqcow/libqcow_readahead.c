@@ -0,0 +1,775 @@
+/*
+ * Readahead functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_readahead.h"
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Creates a readahead
+ * Make sure the value readahead is referencing, is set to NULL
+ * The worker thread calls read_block for every block that is read ahead, without holding the readahead mutex
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_readahead_initialize(
+     libqcow_readahead_t **readahead,
+     intptr_t *data_handle,
+     int (*read_block)(
+            intptr_t *data_handle,
+            off64_t block_offset,
+            libcerror_error_t **error ),
+     size64_t block_size,
+     size64_t data_size,
+     int number_of_blocks,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_readahead_initialize";
+
+	if( readahead == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid readahead.",
+		 function );
+
+		return( -1 );
+	}
+	if( *readahead != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid readahead value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read block function.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( block_size == 0 )
+	 || ( block_size > (size64_t) INT64_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size > (size64_t) INT64_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_blocks <= 0 )
+	 || ( number_of_blocks > LIBQCOW_MAXIMUM_NUMBER_OF_READAHEAD_CLUSTER_BLOCKS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of blocks value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*readahead = memory_allocate_structure(
+	              libqcow_readahead_t );
+
+	if( *readahead == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create readahead.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *readahead,
+	     0,
+	     sizeof( libqcow_readahead_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear readahead.",
+		 function );
+
+		memory_free(
+		 *readahead );
+
+		*readahead = NULL;
+
+		return( -1 );
+	}
+	( *readahead )->data_handle          = data_handle;
+	( *readahead )->read_block           = read_block;
+	( *readahead )->block_size           = block_size;
+	( *readahead )->data_size            = data_size;
+	( *readahead )->number_of_blocks     = number_of_blocks;
+	( *readahead )->last_read_end_offset = -1;
+	( *readahead )->read_block_offset    = -1;
+
+	if( libcthreads_mutex_initialize(
+	     &( ( *readahead )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *readahead )->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *readahead )->block_read_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize block read condition.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_thread_create(
+	     &( ( *readahead )->thread ),
+	     NULL,
+	     &libqcow_readahead_thread_function,
+	     (void *) *readahead,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create worker thread.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *readahead != NULL )
+	{
+		if( ( *readahead )->block_read_condition != NULL )
+		{
+			libcthreads_condition_free(
+			 &( ( *readahead )->block_read_condition ),
+			 NULL );
+		}
+		if( ( *readahead )->condition != NULL )
+		{
+			libcthreads_condition_free(
+			 &( ( *readahead )->condition ),
+			 NULL );
+		}
+		if( ( *readahead )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *readahead )->mutex ),
+			 NULL );
+		}
+		memory_free(
+		 *readahead );
+
+		*readahead = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a readahead
+ * The worker thread is stopped after the block it is reading
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_readahead_free(
+     libqcow_readahead_t **readahead,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_readahead_free";
+	int result            = 1;
+
+	if( readahead == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid readahead.",
+		 function );
+
+		return( -1 );
+	}
+	if( *readahead != NULL )
+	{
+		if( libcthreads_mutex_grab(
+		     ( *readahead )->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			return( -1 );
+		}
+		( *readahead )->stop = 1;
+
+		if( libcthreads_condition_broadcast(
+		     ( *readahead )->condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to broadcast condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_release(
+		     ( *readahead )->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			return( -1 );
+		}
+		if( result != 1 )
+		{
+			return( -1 );
+		}
+		if( libcthreads_thread_join(
+		     &( ( *readahead )->thread ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join worker thread.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_condition_free(
+		     &( ( *readahead )->block_read_condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free block read condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_condition_free(
+		     &( ( *readahead )->condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_free(
+		     &( ( *readahead )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+		memory_free(
+		 *readahead );
+
+		*readahead = NULL;
+	}
+	return( result );
+}
+
+/* Updates the readahead with a read of data
+ * A read that starts at the end of the previous read is sequential. After a minimum number
+ * of sequential reads the worker thread reads ahead the blocks that follow the read,
+ * any other read cancels the blocks that have not been read ahead yet
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_readahead_update(
+     libqcow_readahead_t *readahead,
+     off64_t offset,
+     size_t size,
+     libcerror_error_t **error )
+{
+	static char *function    = "libqcow_readahead_update";
+	off64_t range_end_offset = 0;
+	off64_t read_end_offset  = 0;
+	int result               = 1;
+
+	if( readahead == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid readahead.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( offset < 0 )
+	 || ( (size64_t) offset > readahead->data_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) size > ( readahead->data_size - (size64_t) offset ) )
+	{
+		read_end_offset = (off64_t) readahead->data_size;
+	}
+	else
+	{
+		read_end_offset = offset + (off64_t) size;
+	}
+	if( libcthreads_mutex_grab(
+	     readahead->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset == readahead->last_read_end_offset )
+	{
+		if( readahead->number_of_sequential_reads < LIBQCOW_READAHEAD_MINIMUM_NUMBER_OF_SEQUENTIAL_READS )
+		{
+			readahead->number_of_sequential_reads += 1;
+		}
+	}
+	else
+	{
+		readahead->number_of_sequential_reads = 0;
+	}
+	readahead->last_read_end_offset = read_end_offset;
+
+	if( readahead->number_of_sequential_reads < LIBQCOW_READAHEAD_MINIMUM_NUMBER_OF_SEQUENTIAL_READS )
+	{
+		readahead->range_end_offset = readahead->next_block_offset;
+	}
+	else
+	{
+		/* The block that contains the end of the read is read ahead as well
+		 * since the next read continues in it
+		 */
+		read_end_offset -= (off64_t) ( (size64_t) read_end_offset % readahead->block_size );
+
+		if( (size64_t) readahead->number_of_blocks > ( ( readahead->data_size - (size64_t) read_end_offset ) / readahead->block_size ) )
+		{
+			range_end_offset = (off64_t) readahead->data_size;
+		}
+		else
+		{
+			range_end_offset = read_end_offset + (off64_t) ( readahead->number_of_blocks * readahead->block_size );
+		}
+		/* Blocks that were already read ahead in the range are not read again
+		 */
+		if( ( readahead->next_block_offset < read_end_offset )
+		 || ( readahead->next_block_offset > range_end_offset ) )
+		{
+			readahead->next_block_offset = read_end_offset;
+		}
+		readahead->range_end_offset = range_end_offset;
+
+		if( libcthreads_condition_signal(
+		     readahead->condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to signal condition.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( libcthreads_mutex_release(
+	     readahead->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Waits until the worker thread is no longer reading the block that contains the offset
+ * This prevents a read from reading a block that is being read ahead a second time
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_readahead_wait_for_block(
+     libqcow_readahead_t *readahead,
+     off64_t offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_readahead_wait_for_block";
+	off64_t block_offset  = 0;
+	int result            = 1;
+
+	if( readahead == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid readahead.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	block_offset = offset - (off64_t) ( (size64_t) offset % readahead->block_size );
+
+	if( libcthreads_mutex_grab(
+	     readahead->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( readahead->read_block_offset == block_offset )
+	{
+		if( libcthreads_condition_wait(
+		     readahead->block_read_condition,
+		     readahead->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to wait for block read condition.",
+			 function );
+
+			result = -1;
+
+			break;
+		}
+	}
+	if( libcthreads_mutex_release(
+	     readahead->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* The readahead worker thread function
+ * Reads the blocks in the readahead range one at a time until the readahead is stopped.
+ * Readahead is best effort, a block that cannot be read ends the current range
+ * The read block function returns 1 if the block was read, 0 if there was nothing to read or -1 on error
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_readahead_thread_function(
+     void *arguments )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_readahead_t *readahead = NULL;
+	static char *function          = "libqcow_readahead_thread_function";
+	off64_t block_offset           = 0;
+	int result                     = 0;
+
+	if( arguments == NULL )
+	{
+		return( -1 );
+	}
+	readahead = (libqcow_readahead_t *) arguments;
+
+	if( libcthreads_mutex_grab(
+	     readahead->mutex,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		goto on_error;
+	}
+	while( readahead->stop == 0 )
+	{
+		if( readahead->next_block_offset >= readahead->range_end_offset )
+		{
+			if( libcthreads_condition_wait(
+			     readahead->condition,
+			     readahead->mutex,
+			     &error ) != 1 )
+			{
+				libcerror_error_set(
+				 &error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to wait for condition.",
+				 function );
+
+				libcthreads_mutex_release(
+				 readahead->mutex,
+				 NULL );
+
+				goto on_error;
+			}
+			continue;
+		}
+		block_offset = readahead->next_block_offset;
+
+		readahead->next_block_offset += (off64_t) readahead->block_size;
+		readahead->read_block_offset  = block_offset;
+
+		if( libcthreads_mutex_release(
+		     readahead->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			goto on_error;
+		}
+		result = readahead->read_block(
+		          readahead->data_handle,
+		          block_offset,
+		          &error );
+
+		if( result == -1 )
+		{
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: unable to read ahead block at offset: %" PRIi64 " (0x%08" PRIx64 ").\n",
+				 function,
+				 block_offset,
+				 block_offset );
+
+				libcnotify_print_error_backtrace(
+				 error );
+			}
+#endif
+			libcerror_error_free(
+			 &error );
+		}
+		if( libcthreads_mutex_grab(
+		     readahead->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			goto on_error;
+		}
+		readahead->read_block_offset = -1;
+
+		if( result == -1 )
+		{
+			readahead->range_end_offset = readahead->next_block_offset;
+		}
+		else if( result != 0 )
+		{
+			readahead->number_of_blocks_read += 1;
+		}
+		if( libcthreads_condition_broadcast(
+		     readahead->block_read_condition,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to broadcast block read condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 readahead->mutex,
+			 NULL );
+
+			goto on_error;
+		}
+	}
+	if( libcthreads_mutex_release(
+	     readahead->mutex,
+	     &error ) != 1 )
+	{
+		libcerror_error_set(
+		 &error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_print_error_backtrace(
+		 error );
+	}
+#endif
+	libcerror_error_free(
+	 &error );
+
+	return( -1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
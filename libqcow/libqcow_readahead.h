@@ -0,0 +1,149 @@
+/*
+ * Readahead functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_READAHEAD_H )
+#define _LIBQCOW_READAHEAD_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+typedef struct libqcow_readahead libqcow_readahead_t;
+
+/* The readahead detects sequential reads and reads the blocks
+ * that follow the last read in a worker thread
+ */
+struct libqcow_readahead
+{
+	/* The data handle
+	 */
+	intptr_t *data_handle;
+
+	/* The read block function
+	 */
+	int (*read_block)(
+	       intptr_t *data_handle,
+	       off64_t block_offset,
+	       libcerror_error_t **error );
+
+	/* The block size
+	 */
+	size64_t block_size;
+
+	/* The data size
+	 */
+	size64_t data_size;
+
+	/* The number of blocks to read ahead
+	 */
+	int number_of_blocks;
+
+	/* The end offset of the last read
+	 */
+	off64_t last_read_end_offset;
+
+	/* The number of consecutive sequential reads
+	 */
+	int number_of_sequential_reads;
+
+	/* The offset of the next block to read ahead
+	 */
+	off64_t next_block_offset;
+
+	/* The end offset of the range to read ahead
+	 */
+	off64_t range_end_offset;
+
+	/* The offset of the block that is being read by the worker thread, where -1 represents none
+	 */
+	off64_t read_block_offset;
+
+	/* The number of blocks that were read ahead
+	 */
+	uint64_t number_of_blocks_read;
+
+	/* Value to indicate the worker thread should stop
+	 */
+	uint8_t stop;
+
+	/* The mutex
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that signals the worker thread
+	 */
+	libcthreads_condition_t *condition;
+
+	/* The condition that signals a block was read by the worker thread
+	 */
+	libcthreads_condition_t *block_read_condition;
+
+	/* The worker thread
+	 */
+	libcthreads_thread_t *thread;
+};
+
+int libqcow_readahead_initialize(
+     libqcow_readahead_t **readahead,
+     intptr_t *data_handle,
+     int (*read_block)(
+            intptr_t *data_handle,
+            off64_t block_offset,
+            libcerror_error_t **error ),
+     size64_t block_size,
+     size64_t data_size,
+     int number_of_blocks,
+     libcerror_error_t **error );
+
+int libqcow_readahead_free(
+     libqcow_readahead_t **readahead,
+     libcerror_error_t **error );
+
+int libqcow_readahead_update(
+     libqcow_readahead_t *readahead,
+     off64_t offset,
+     size_t size,
+     libcerror_error_t **error );
+
+int libqcow_readahead_wait_for_block(
+     libqcow_readahead_t *readahead,
+     off64_t offset,
+     libcerror_error_t **error );
+
+int libqcow_readahead_thread_function(
+     void *arguments );
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_READAHEAD_H ) */
+
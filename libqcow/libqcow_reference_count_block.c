@@ -0,0 +1,593 @@
+/*
+ * Reference count block functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_reference_count_block.h"
+
+/* Creates a reference count block
+ * Make sure the value reference_count_block is referencing, is set to NULL
+ * The reference counts are set to 0 and marked as modified until the block is read
+ * Only reference count orders 3 (8-bit) to 6 (64-bit) are supported
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_initialize(
+     libqcow_reference_count_block_t **reference_count_block,
+     size_t data_size,
+     uint32_t reference_count_order,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_reference_count_block_initialize";
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( *reference_count_block != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid reference count block value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_count_order < 3 )
+	 || ( reference_count_order > 6 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported reference count order: %" PRIu32 ".",
+		 function,
+		 reference_count_order );
+
+		return( -1 );
+	}
+	if( ( data_size < 8 )
+	 || ( data_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
+	 || ( ( data_size % 8 ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size >> ( reference_count_order - 3 ) ) > (size_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid number of reference counts value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	*reference_count_block = memory_allocate_structure(
+	                          libqcow_reference_count_block_t );
+
+	if( *reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create reference count block.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *reference_count_block,
+	     0,
+	     sizeof( libqcow_reference_count_block_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear reference count block.",
+		 function );
+
+		memory_free(
+		 *reference_count_block );
+
+		*reference_count_block = NULL;
+
+		return( -1 );
+	}
+	( *reference_count_block )->data = (uint8_t *) memory_allocate(
+	                                                sizeof( uint8_t ) * data_size );
+
+	if( ( *reference_count_block )->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     ( *reference_count_block )->data,
+	     0,
+	     data_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear data.",
+		 function );
+
+		goto on_error;
+	}
+	( *reference_count_block )->data_size                  = data_size;
+	( *reference_count_block )->reference_count_size       = (uint8_t) ( 1 << ( reference_count_order - 3 ) );
+	( *reference_count_block )->number_of_reference_counts = (int) ( data_size >> ( reference_count_order - 3 ) );
+	( *reference_count_block )->modified_start_index       = 0;
+	( *reference_count_block )->modified_end_index         = ( *reference_count_block )->number_of_reference_counts;
+
+	return( 1 );
+
+on_error:
+	if( *reference_count_block != NULL )
+	{
+		if( ( *reference_count_block )->data != NULL )
+		{
+			memory_free(
+			 ( *reference_count_block )->data );
+		}
+		memory_free(
+		 *reference_count_block );
+
+		*reference_count_block = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a reference count block
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_free(
+     libqcow_reference_count_block_t **reference_count_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_reference_count_block_free";
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( *reference_count_block != NULL )
+	{
+		if( ( *reference_count_block )->data != NULL )
+		{
+			memory_free(
+			 ( *reference_count_block )->data );
+		}
+		memory_free(
+		 *reference_count_block );
+
+		*reference_count_block = NULL;
+	}
+	return( 1 );
+}
+
+/* Retrieves a specific reference count
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_get_reference_count_by_index(
+     libqcow_reference_count_block_t *reference_count_block,
+     int reference_count_index,
+     uint64_t *reference_count,
+     libcerror_error_t **error )
+{
+	uint8_t *reference_count_data = NULL;
+	static char *function         = "libqcow_reference_count_block_get_reference_count_by_index";
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid reference count block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_count_index < 0 )
+	 || ( reference_count_index >= reference_count_block->number_of_reference_counts ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count.",
+		 function );
+
+		return( -1 );
+	}
+	reference_count_data = &( reference_count_block->data[ (size_t) reference_count_index * reference_count_block->reference_count_size ] );
+
+	switch( reference_count_block->reference_count_size )
+	{
+		case 1:
+			*reference_count = reference_count_data[ 0 ];
+			break;
+
+		case 2:
+			byte_stream_copy_to_uint16_big_endian(
+			 reference_count_data,
+			 *reference_count );
+			break;
+
+		case 4:
+			byte_stream_copy_to_uint32_big_endian(
+			 reference_count_data,
+			 *reference_count );
+			break;
+
+		case 8:
+			byte_stream_copy_to_uint64_big_endian(
+			 reference_count_data,
+			 *reference_count );
+			break;
+
+		default:
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported reference count size: %" PRIu8 ".",
+			 function,
+			 reference_count_block->reference_count_size );
+
+			return( -1 );
+	}
+	return( 1 );
+}
+
+/* Sets a specific reference count
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_set_reference_count_by_index(
+     libqcow_reference_count_block_t *reference_count_block,
+     int reference_count_index,
+     uint64_t reference_count,
+     libcerror_error_t **error )
+{
+	uint8_t *reference_count_data = NULL;
+	static char *function         = "libqcow_reference_count_block_set_reference_count_by_index";
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid reference count block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_count_index < 0 )
+	 || ( reference_count_index >= reference_count_block->number_of_reference_counts ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference count index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_count_block->reference_count_size < 8 )
+	 && ( ( reference_count >> ( reference_count_block->reference_count_size * 8 ) ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid reference count value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	reference_count_data = &( reference_count_block->data[ (size_t) reference_count_index * reference_count_block->reference_count_size ] );
+
+	switch( reference_count_block->reference_count_size )
+	{
+		case 1:
+			reference_count_data[ 0 ] = (uint8_t) reference_count;
+			break;
+
+		case 2:
+			byte_stream_copy_from_uint16_big_endian(
+			 reference_count_data,
+			 reference_count );
+			break;
+
+		case 4:
+			byte_stream_copy_from_uint32_big_endian(
+			 reference_count_data,
+			 reference_count );
+			break;
+
+		case 8:
+			byte_stream_copy_from_uint64_big_endian(
+			 reference_count_data,
+			 reference_count );
+			break;
+
+		default:
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported reference count size: %" PRIu8 ".",
+			 function,
+			 reference_count_block->reference_count_size );
+
+			return( -1 );
+	}
+	if( reference_count_block->modified_start_index == reference_count_block->modified_end_index )
+	{
+		reference_count_block->modified_start_index = reference_count_index;
+		reference_count_block->modified_end_index   = reference_count_index + 1;
+	}
+	else if( reference_count_index < reference_count_block->modified_start_index )
+	{
+		reference_count_block->modified_start_index = reference_count_index;
+	}
+	else if( reference_count_index >= reference_count_block->modified_end_index )
+	{
+		reference_count_block->modified_end_index = reference_count_index + 1;
+	}
+	return( 1 );
+}
+
+/* Reads a reference count block
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_read(
+     libqcow_reference_count_block_t *reference_count_block,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_reference_count_block_read";
+	ssize_t read_count    = 0;
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid reference count block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading reference count block at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 file_offset,
+		 file_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              reference_count_block->data,
+	              reference_count_block->data_size,
+	              file_offset,
+	              error );
+
+	if( read_count != (ssize_t) reference_count_block->data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read reference count block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		return( -1 );
+	}
+	reference_count_block->modified_start_index = 0;
+	reference_count_block->modified_end_index   = 0;
+
+	return( 1 );
+}
+
+/* Writes the modified reference counts of a reference count block
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_reference_count_block_write_modified_reference_counts(
+     libqcow_reference_count_block_t *reference_count_block,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_reference_count_block_write_modified_reference_counts";
+	size_t data_offset    = 0;
+	size_t write_size     = 0;
+	ssize_t write_count   = 0;
+
+	if( reference_count_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid reference count block.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid reference count block - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( reference_count_block->modified_start_index == reference_count_block->modified_end_index )
+	{
+		return( 1 );
+	}
+	data_offset = (size_t) reference_count_block->modified_start_index * reference_count_block->reference_count_size;
+	write_size  = (size_t) ( reference_count_block->modified_end_index - reference_count_block->modified_start_index ) * reference_count_block->reference_count_size;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: writing %" PRIzd " bytes of reference count block at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 write_size,
+		 file_offset + (off64_t) data_offset,
+		 file_offset + (off64_t) data_offset );
+	}
+#endif
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               file_io_handle,
+	               &( reference_count_block->data[ data_offset ] ),
+	               write_size,
+	               file_offset + (off64_t) data_offset,
+	               error );
+
+	if( write_count != (ssize_t) write_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write reference count block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset + (off64_t) data_offset,
+		 file_offset + (off64_t) data_offset );
+
+		return( -1 );
+	}
+	reference_count_block->modified_start_index = 0;
+	reference_count_block->modified_end_index   = 0;
+
+	return( 1 );
+}
+
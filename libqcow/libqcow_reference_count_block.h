@@ -0,0 +1,103 @@
+/*
+ * Reference count block functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_REFERENCE_COUNT_BLOCK_H )
+#define _LIBQCOW_REFERENCE_COUNT_BLOCK_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_reference_count_block libqcow_reference_count_block_t;
+
+struct libqcow_reference_count_block
+{
+	/* The data
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size_t data_size;
+
+	/* The reference count size in bytes
+	 */
+	uint8_t reference_count_size;
+
+	/* The number of reference counts
+	 */
+	int number_of_reference_counts;
+
+	/* The index of the first modified reference count
+	 */
+	int modified_start_index;
+
+	/* The index after the last modified reference count
+	 */
+	int modified_end_index;
+};
+
+int libqcow_reference_count_block_initialize(
+     libqcow_reference_count_block_t **reference_count_block,
+     size_t data_size,
+     uint32_t reference_count_order,
+     libcerror_error_t **error );
+
+int libqcow_reference_count_block_free(
+     libqcow_reference_count_block_t **reference_count_block,
+     libcerror_error_t **error );
+
+int libqcow_reference_count_block_get_reference_count_by_index(
+     libqcow_reference_count_block_t *reference_count_block,
+     int reference_count_index,
+     uint64_t *reference_count,
+     libcerror_error_t **error );
+
+int libqcow_reference_count_block_set_reference_count_by_index(
+     libqcow_reference_count_block_t *reference_count_block,
+     int reference_count_index,
+     uint64_t reference_count,
+     libcerror_error_t **error );
+
+int libqcow_reference_count_block_read(
+     libqcow_reference_count_block_t *reference_count_block,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
+int libqcow_reference_count_block_write_modified_reference_counts(
+     libqcow_reference_count_block_t *reference_count_block,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_REFERENCE_COUNT_BLOCK_H ) */
+
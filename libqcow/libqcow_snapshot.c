@@ -0,0 +1,623 @@
+/*
+ * Snapshot functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_snapshot.h"
+#include "libqcow_snapshot_values.h"
+
+/* Creates a snapshot
+ * Make sure the value snapshot is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_initialize(
+     libqcow_snapshot_t **snapshot,
+     libqcow_snapshot_values_t *snapshot_values,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_initialize";
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid snapshot value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = memory_allocate_structure(
+	                     libqcow_internal_snapshot_t );
+
+	if( internal_snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create snapshot.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_snapshot,
+	     0,
+	     sizeof( libqcow_internal_snapshot_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear snapshot.",
+		 function );
+
+		goto on_error;
+	}
+	internal_snapshot->snapshot_values = snapshot_values;
+
+	*snapshot = (libqcow_snapshot_t *) internal_snapshot;
+
+	return( 1 );
+
+on_error:
+	if( internal_snapshot != NULL )
+	{
+		memory_free(
+		 internal_snapshot );
+	}
+	return( -1 );
+}
+
+/* Frees a snapshot
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_free(
+     libqcow_snapshot_t **snapshot,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_free";
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot != NULL )
+	{
+		internal_snapshot = (libqcow_internal_snapshot_t *) *snapshot;
+		*snapshot         = NULL;
+
+		/* The snapshot_values reference is freed elsewhere
+		 */
+		memory_free(
+		 internal_snapshot );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded identifier
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf8_identifier_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf8_identifier_size";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf8_identifier_size(
+	          internal_snapshot->snapshot_values,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-8 encoded identifier
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf8_identifier(
+     libqcow_snapshot_t *snapshot,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf8_identifier";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf8_identifier(
+	          internal_snapshot->snapshot_values,
+	          utf8_string,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the size of the UTF-16 encoded identifier
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf16_identifier_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf16_identifier_size";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf16_identifier_size(
+	          internal_snapshot->snapshot_values,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-16 encoded identifier
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf16_identifier(
+     libqcow_snapshot_t *snapshot,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf16_identifier";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf16_identifier(
+	          internal_snapshot->snapshot_values,
+	          utf16_string,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the size of the UTF-8 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf8_name_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf8_name_size";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf8_name_size(
+	          internal_snapshot->snapshot_values,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-8 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf8_name(
+     libqcow_snapshot_t *snapshot,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf8_name";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf8_name(
+	          internal_snapshot->snapshot_values,
+	          utf8_string,
+	          utf8_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the size of the UTF-16 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf16_name_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf16_name_size";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf16_name_size(
+	          internal_snapshot->snapshot_values,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the UTF-16 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_get_utf16_name(
+     libqcow_snapshot_t *snapshot,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_utf16_name";
+	int result                                     = 0;
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	result = libqcow_snapshot_values_get_utf16_name(
+	          internal_snapshot->snapshot_values,
+	          utf16_string,
+	          utf16_string_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Retrieves the media size
+ * This is the media size of the image at the time the snapshot was created
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_get_media_size(
+     libqcow_snapshot_t *snapshot,
+     size64_t *media_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_media_size";
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	if( internal_snapshot->snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid snapshot - missing snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( media_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid media size.",
+		 function );
+
+		return( -1 );
+	}
+	*media_size = internal_snapshot->snapshot_values->media_size;
+
+	return( 1 );
+}
+
+/* Retrieves the virtual machine state size
+ * A size of 0 represents a snapshot without virtual machine state
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_get_virtual_machine_state_size(
+     libqcow_snapshot_t *snapshot,
+     size64_t *virtual_machine_state_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_snapshot_get_virtual_machine_state_size";
+
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	internal_snapshot = (libqcow_internal_snapshot_t *) snapshot;
+
+	if( internal_snapshot->snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid snapshot - missing snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( virtual_machine_state_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid virtual machine state size.",
+		 function );
+
+		return( -1 );
+	}
+	*virtual_machine_state_size = internal_snapshot->snapshot_values->virtual_machine_state_size;
+
+	return( 1 );
+}
+
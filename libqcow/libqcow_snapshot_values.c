@@ -0,0 +1,1019 @@
+/*
+ * Snapshot values functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libuna.h"
+#include "libqcow_snapshot_values.h"
+
+#include "qcow_snapshot_table.h"
+
+/* Creates snapshot values
+ * Make sure the value snapshot_values is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_values_initialize(
+     libqcow_snapshot_values_t **snapshot_values,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_initialize";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot_values != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid snapshot values value already set.",
+		 function );
+
+		return( -1 );
+	}
+	*snapshot_values = memory_allocate_structure(
+	                    libqcow_snapshot_values_t );
+
+	if( *snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create snapshot values.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *snapshot_values,
+	     0,
+	     sizeof( libqcow_snapshot_values_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear snapshot values.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *snapshot_values != NULL )
+	{
+		memory_free(
+		 *snapshot_values );
+
+		*snapshot_values = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees snapshot values
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_values_free(
+     libqcow_snapshot_values_t **snapshot_values,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_free";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot_values != NULL )
+	{
+		if( ( *snapshot_values )->name != NULL )
+		{
+			memory_free(
+			 ( *snapshot_values )->name );
+		}
+		if( ( *snapshot_values )->identifier != NULL )
+		{
+			memory_free(
+			 ( *snapshot_values )->identifier );
+		}
+		memory_free(
+		 *snapshot_values );
+
+		*snapshot_values = NULL;
+	}
+	return( 1 );
+}
+
+/* Reads the snapshot values from a snapshot table entry
+ * The data contains the entry including the extra data, identifier and name
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_values_read_data(
+     libqcow_snapshot_values_t *snapshot_values,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function             = "libqcow_snapshot_values_read_data";
+	size_t data_offset                = 0;
+	uint64_t safe_level1_table_offset = 0;
+	uint32_t extra_data_size          = 0;
+	uint32_t value_32bit              = 0;
+	uint16_t identifier_size          = 0;
+	uint16_t name_size                = 0;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	uint64_t value_64bit              = 0;
+#endif
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( snapshot_values->identifier != NULL )
+	 || ( snapshot_values->name != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid snapshot values - identifier or name value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size < sizeof( qcow_snapshot_table_entry_t ) )
+	 || ( data_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: snapshot table entry data:\n",
+		 function );
+		libcnotify_print_data(
+		 data,
+		 data_size,
+		 0 );
+	}
+#endif
+	byte_stream_copy_to_uint64_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->level1_table_offset,
+	 safe_level1_table_offset );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->number_of_level1_table_references,
+	 snapshot_values->number_of_level1_table_references );
+
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->identifier_size,
+	 identifier_size );
+
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->name_size,
+	 name_size );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->virtual_machine_state_size,
+	 value_32bit );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) data )->extra_data_size,
+	 extra_data_size );
+
+	snapshot_values->virtual_machine_state_size = (size64_t) value_32bit;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 1 table offset\t\t\t: 0x%08" PRIx64 "\n",
+		 function,
+		 safe_level1_table_offset );
+
+		libcnotify_printf(
+		 "%s: number of level 1 table references\t: %" PRIu32 "\n",
+		 function,
+		 snapshot_values->number_of_level1_table_references );
+
+		libcnotify_printf(
+		 "%s: identifier size\t\t\t\t: %" PRIu16 "\n",
+		 function,
+		 identifier_size );
+
+		libcnotify_printf(
+		 "%s: name size\t\t\t\t: %" PRIu16 "\n",
+		 function,
+		 name_size );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_snapshot_table_entry_t *) data )->creation_time_seconds,
+		 value_32bit );
+		libcnotify_printf(
+		 "%s: creation time seconds\t\t\t: %" PRIu32 "\n",
+		 function,
+		 value_32bit );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_snapshot_table_entry_t *) data )->creation_time_nanoseconds,
+		 value_32bit );
+		libcnotify_printf(
+		 "%s: creation time nanoseconds\t\t: %" PRIu32 "\n",
+		 function,
+		 value_32bit );
+
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_snapshot_table_entry_t *) data )->virtual_machine_clock,
+		 value_64bit );
+		libcnotify_printf(
+		 "%s: virtual machine clock\t\t\t: %" PRIu64 "\n",
+		 function,
+		 value_64bit );
+
+		libcnotify_printf(
+		 "%s: virtual machine state size\t\t: %" PRIu64 "\n",
+		 function,
+		 snapshot_values->virtual_machine_state_size );
+
+		libcnotify_printf(
+		 "%s: extra data size\t\t\t\t: %" PRIu32 "\n",
+		 function,
+		 extra_data_size );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+
+	if( ( safe_level1_table_offset == 0 )
+	 || ( safe_level1_table_offset > (uint64_t) INT64_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 1 table offset value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	if( extra_data_size > LIBQCOW_SNAPSHOT_MAXIMUM_EXTRA_DATA_SIZE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid extra data size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	data_offset = sizeof( qcow_snapshot_table_entry_t );
+
+	if( ( (size_t) extra_data_size + identifier_size + name_size ) > ( data_size - data_offset ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value too small.",
+		 function );
+
+		goto on_error;
+	}
+	snapshot_values->level1_table_offset = (off64_t) safe_level1_table_offset;
+
+	/* The extra data can be truncated, in which case the 32-bit
+	 * virtual machine state size applies and the media size is not set
+	 */
+	if( extra_data_size >= 8 )
+	{
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_snapshot_table_entry_extra_data_t *) &( data[ data_offset ] ) )->virtual_machine_state_size,
+		 snapshot_values->virtual_machine_state_size );
+	}
+	if( extra_data_size >= 16 )
+	{
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_snapshot_table_entry_extra_data_t *) &( data[ data_offset ] ) )->media_size,
+		 snapshot_values->media_size );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		if( extra_data_size > 0 )
+		{
+			libcnotify_printf(
+			 "%s: extra data:\n",
+			 function );
+			libcnotify_print_data(
+			 &( data[ data_offset ] ),
+			 (size_t) extra_data_size,
+			 0 );
+		}
+	}
+#endif
+	data_offset += extra_data_size;
+
+	if( identifier_size > 0 )
+	{
+		snapshot_values->identifier = (uint8_t *) memory_allocate(
+		                                           sizeof( uint8_t ) * identifier_size );
+
+		if( snapshot_values->identifier == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create identifier.",
+			 function );
+
+			goto on_error;
+		}
+		if( memory_copy(
+		     snapshot_values->identifier,
+		     &( data[ data_offset ] ),
+		     (size_t) identifier_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy identifier.",
+			 function );
+
+			goto on_error;
+		}
+		snapshot_values->identifier_size = (size_t) identifier_size;
+
+		data_offset += identifier_size;
+	}
+	if( name_size > 0 )
+	{
+		snapshot_values->name = (uint8_t *) memory_allocate(
+		                                     sizeof( uint8_t ) * name_size );
+
+		if( snapshot_values->name == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create name.",
+			 function );
+
+			goto on_error;
+		}
+		if( memory_copy(
+		     snapshot_values->name,
+		     &( data[ data_offset ] ),
+		     (size_t) name_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy name.",
+			 function );
+
+			goto on_error;
+		}
+		snapshot_values->name_size = (size_t) name_size;
+	}
+	return( 1 );
+
+on_error:
+	if( snapshot_values->name != NULL )
+	{
+		memory_free(
+		 snapshot_values->name );
+
+		snapshot_values->name = NULL;
+	}
+	snapshot_values->name_size = 0;
+
+	if( snapshot_values->identifier != NULL )
+	{
+		memory_free(
+		 snapshot_values->identifier );
+
+		snapshot_values->identifier = NULL;
+	}
+	snapshot_values->identifier_size = 0;
+
+	return( -1 );
+}
+
+/* Reads the snapshot values from a snapshot table entry
+ * The entry size is the size of the entry including the alignment padding,
+ * which is the distance to the next entry in the snapshot table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_snapshot_values_read_file_io_handle(
+     libqcow_snapshot_values_t *snapshot_values,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     size_t *entry_size,
+     libcerror_error_t **error )
+{
+	uint8_t entry_header_data[ sizeof( qcow_snapshot_table_entry_t ) ];
+
+	uint8_t *entry_data      = NULL;
+	static char *function    = "libqcow_snapshot_values_read_file_io_handle";
+	size_t entry_data_size   = 0;
+	ssize_t read_count       = 0;
+	uint32_t extra_data_size = 0;
+	uint16_t identifier_size = 0;
+	uint16_t name_size       = 0;
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( entry_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid entry size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading snapshot table entry at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 file_offset,
+		 file_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              entry_header_data,
+	              sizeof( qcow_snapshot_table_entry_t ),
+	              file_offset,
+	              error );
+
+	if( read_count != (ssize_t) sizeof( qcow_snapshot_table_entry_t ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read snapshot table entry data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		goto on_error;
+	}
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) entry_header_data )->identifier_size,
+	 identifier_size );
+
+	byte_stream_copy_to_uint16_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) entry_header_data )->name_size,
+	 name_size );
+
+	byte_stream_copy_to_uint32_big_endian(
+	 ( (qcow_snapshot_table_entry_t *) entry_header_data )->extra_data_size,
+	 extra_data_size );
+
+	if( extra_data_size > LIBQCOW_SNAPSHOT_MAXIMUM_EXTRA_DATA_SIZE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid extra data size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	entry_data_size = sizeof( qcow_snapshot_table_entry_t ) + (size_t) extra_data_size + identifier_size + name_size;
+
+	entry_data = (uint8_t *) memory_allocate(
+	                          sizeof( uint8_t ) * entry_data_size );
+
+	if( entry_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create snapshot table entry data.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_copy(
+	     entry_data,
+	     entry_header_data,
+	     sizeof( qcow_snapshot_table_entry_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy snapshot table entry data.",
+		 function );
+
+		goto on_error;
+	}
+	if( entry_data_size > sizeof( qcow_snapshot_table_entry_t ) )
+	{
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              &( entry_data[ sizeof( qcow_snapshot_table_entry_t ) ] ),
+		              entry_data_size - sizeof( qcow_snapshot_table_entry_t ),
+		              file_offset + sizeof( qcow_snapshot_table_entry_t ),
+		              error );
+
+		if( read_count != (ssize_t) ( entry_data_size - sizeof( qcow_snapshot_table_entry_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot table entry data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 file_offset,
+			 file_offset );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_snapshot_values_read_data(
+	     snapshot_values,
+	     entry_data,
+	     entry_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read snapshot table entry.",
+		 function );
+
+		goto on_error;
+	}
+	memory_free(
+	 entry_data );
+
+	/* The snapshot table entries are 8-byte aligned
+	 */
+	*entry_size = ( entry_data_size + 7 ) & ~( (size_t) 7 );
+
+	return( 1 );
+
+on_error:
+	if( entry_data != NULL )
+	{
+		memory_free(
+		 entry_data );
+	}
+	return( -1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded identifier
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf8_identifier_size(
+     libqcow_snapshot_values_t *snapshot_values,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf8_identifier_size";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->identifier == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_size_from_utf8_stream(
+	     snapshot_values->identifier,
+	     snapshot_values->identifier_size,
+	     utf8_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-8 encoded identifier
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf8_identifier(
+     libqcow_snapshot_values_t *snapshot_values,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf8_identifier";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->identifier == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_copy_from_utf8_stream(
+	     utf8_string,
+	     utf8_string_size,
+	     snapshot_values->identifier,
+	     snapshot_values->identifier_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-16 encoded identifier
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf16_identifier_size(
+     libqcow_snapshot_values_t *snapshot_values,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf16_identifier_size";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->identifier == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_size_from_utf8_stream(
+	     snapshot_values->identifier,
+	     snapshot_values->identifier_size,
+	     utf16_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-16 encoded identifier
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf16_identifier(
+     libqcow_snapshot_values_t *snapshot_values,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf16_identifier";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->identifier == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_copy_from_utf8_stream(
+	     utf16_string,
+	     utf16_string_size,
+	     snapshot_values->identifier,
+	     snapshot_values->identifier_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of identifier.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf8_name_size(
+     libqcow_snapshot_values_t *snapshot_values,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf8_name_size";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_size_from_utf8_stream(
+	     snapshot_values->name,
+	     snapshot_values->name_size,
+	     utf8_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-8 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf8_name(
+     libqcow_snapshot_values_t *snapshot_values,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf8_name";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf8_string_copy_from_utf8_stream(
+	     utf8_string,
+	     utf8_string_size,
+	     snapshot_values->name,
+	     snapshot_values->name_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-8 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-16 encoded name
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf16_name_size(
+     libqcow_snapshot_values_t *snapshot_values,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf16_name_size";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_size_from_utf8_stream(
+	     snapshot_values->name,
+	     snapshot_values->name_size,
+	     utf16_string_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string size of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the UTF-16 encoded name
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_snapshot_values_get_utf16_name(
+     libqcow_snapshot_values_t *snapshot_values,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_snapshot_values_get_utf16_name";
+
+	if( snapshot_values == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot values.",
+		 function );
+
+		return( -1 );
+	}
+	if( snapshot_values->name == NULL )
+	{
+		return( 0 );
+	}
+	if( libuna_utf16_string_copy_from_utf8_stream(
+	     utf16_string,
+	     utf16_string_size,
+	     snapshot_values->name,
+	     snapshot_values->name_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve UTF-16 string of name.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
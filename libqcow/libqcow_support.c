@@ -25,6 +25,7 @@
 #include <types.h>
 #include <wide_string.h>
 
+#include "libqcow_cache_budget.h"
 #include "libqcow_definitions.h"
 #include "libqcow_io_handle.h"
 #include "libqcow_libbfio.h"
@@ -118,6 +119,64 @@ int libqcow_set_codepage(
 	return( 1 );
 }
 
+/* Retrieves the process wide cache budget
+ * The process wide cache budget is the maximum size in bytes of the caches of all open files,
+ * where 0 represents no maximum
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_get_cache_budget(
+     size64_t *cache_budget,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_get_cache_budget";
+
+	if( libqcow_cache_budget_get_maximum_size(
+	     cache_budget,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cache budget.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Sets the process wide cache budget
+ * The process wide cache budget is the maximum size in bytes of the caches of all open files,
+ * where 0 represents no maximum. Files opened afterwards reserve their cache size from this budget,
+ * but always retain at least one entry per cache
+ * The cache budget is a soft ceiling: when the remaining budget is less than the minimum cache size
+ * of a file, the file still reserves its minimum cache size and the total can exceed the budget
+ * This function can be called at any time, but 0 can only be set when no files are open
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_set_cache_budget(
+     size64_t cache_budget,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_set_cache_budget";
+
+	if( libqcow_cache_budget_set_maximum_size(
+	     cache_budget,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set cache budget.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
 #endif /* !defined( HAVE_LOCAL_LIBQCOW ) */
 
 /* Determines if a file contains a QCOW file signature
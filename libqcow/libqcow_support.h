@@ -61,6 +61,16 @@ int libqcow_set_codepage(
      int codepage,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_get_cache_budget(
+     size64_t *cache_budget,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_set_cache_budget(
+     size64_t cache_budget,
+     libcerror_error_t **error );
+
 #endif /* !defined( HAVE_LOCAL_LIBQCOW ) */
 
 LIBQCOW_EXTERN \
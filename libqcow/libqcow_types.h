@@ -34,13 +34,40 @@
 /* The following type definitions hide internal data structures
  */
 #if defined( HAVE_DEBUG_OUTPUT ) && !defined( WINAPI )
-typedef struct libqcow_file {}	libqcow_file_t;
+typedef struct libqcow_bitmap {}		libqcow_bitmap_t;
+typedef struct libqcow_file {}		libqcow_file_t;
+typedef struct libqcow_snapshot {}	libqcow_snapshot_t;
 
 #else
+typedef intptr_t libqcow_bitmap_t;
 typedef intptr_t libqcow_file_t;
+typedef intptr_t libqcow_snapshot_t;
 
 #endif /* defined( HAVE_DEBUG_OUTPUT ) && !defined( WINAPI ) */
 
+/* The read vector used by libqcow_file_read_vectors
+ */
+typedef struct libqcow_read_vector libqcow_read_vector_t;
+
+struct libqcow_read_vector
+{
+	/* The (media) offset
+	 */
+	off64_t offset;
+
+	/* The buffer
+	 */
+	void *buffer;
+
+	/* The buffer size
+	 */
+	size_t buffer_size;
+
+	/* The number of bytes read, set by libqcow_file_read_vectors
+	 */
+	ssize_t read_count;
+};
+
 #endif /* defined( HAVE_LOCAL_LIBQCOW ) */
 
 #endif /* !defined( _LIBQCOW_INTERNAL_TYPES_H ) */
@@ -0,0 +1,3243 @@
+/*
+ * Zstandard (zstd) decompression functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_zstd.h"
+
+/* The literals length base values and number of additional bits per code
+ */
+const uint32_t libqcow_zstd_literals_length_base_values[ 36 ] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+	8192, 16384, 32768, 65536 };
+
+const uint8_t libqcow_zstd_literals_length_number_of_bits[ 36 ] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16 };
+
+/* The match length base values and number of additional bits per code
+ */
+const uint32_t libqcow_zstd_match_length_base_values[ 53 ] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+	4099, 8195, 16387, 32771, 65539 };
+
+const uint8_t libqcow_zstd_match_length_number_of_bits[ 53 ] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16 };
+
+/* The predefined normalized counts of the sequences FSE tables
+ */
+const int16_t libqcow_zstd_literals_length_predefined_normalized_counts[ 36 ] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1 };
+
+const int16_t libqcow_zstd_match_length_predefined_normalized_counts[ 53 ] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1 };
+
+const int16_t libqcow_zstd_offset_predefined_normalized_counts[ 29 ] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1 };
+
+/* Retrieves the index of the most significant bit of a non-zero value
+ */
+#define LIBQCOW_ZSTD_GET_MOST_SIGNIFICANT_BIT( value, bit_index ) \
+	bit_index = 0; \
+	while( ( value >> bit_index ) > 1 ) \
+	{ \
+		bit_index++; \
+	}
+
+/* Initializes a bit stream
+ * The last byte of the byte stream contains an end marker, which is the most significant bit set
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_bit_stream_initialize(
+     libqcow_zstd_bit_stream_t *bit_stream,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_zstd_bit_stream_initialize";
+	uint8_t bit_index     = 0;
+	uint8_t last_byte     = 0;
+
+	if( bit_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bit stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( byte_stream_size == 0 )
+	 || ( byte_stream_size > (size_t) ( INT64_MAX / 8 ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	last_byte = byte_stream[ byte_stream_size - 1 ];
+
+	if( last_byte == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: missing end marker.",
+		 function );
+
+		return( -1 );
+	}
+	LIBQCOW_ZSTD_GET_MOST_SIGNIFICANT_BIT(
+	 last_byte,
+	 bit_index );
+
+	bit_stream->byte_stream      = byte_stream;
+	bit_stream->byte_stream_size = byte_stream_size;
+	bit_stream->bit_offset       = ( (int64_t) ( byte_stream_size - 1 ) * 8 ) + bit_index;
+
+	return( 1 );
+}
+
+/* Retrieves a value from the bit stream without consuming the bits
+ * The most significant bit of the value is the bit before the current bit offset.
+ * Bits before the start of the byte stream are 0. This function does not check
+ * its arguments and supports up to 32 bits
+ * Returns the value
+ */
+uint32_t libqcow_zstd_bit_stream_peek_value(
+          libqcow_zstd_bit_stream_t *bit_stream,
+          uint8_t number_of_bits )
+{
+	uint64_t value_64bit = 0;
+	int64_t bit_offset   = 0;
+	size_t byte_index    = 0;
+	uint8_t byte_offset  = 0;
+	uint8_t shift        = 0;
+
+	if( number_of_bits == 0 )
+	{
+		return( 0 );
+	}
+	bit_offset = bit_stream->bit_offset - number_of_bits;
+
+	if( bit_offset < 0 )
+	{
+		if( bit_stream->bit_offset <= 0 )
+		{
+			return( 0 );
+		}
+		/* The bits before the start of the byte stream are the least significant bits of the value
+		 */
+		shift      = (uint8_t) -bit_offset;
+		bit_offset = 0;
+	}
+	byte_index = (size_t) ( bit_offset >> 3 );
+
+	if( ( byte_index + 8 ) <= bit_stream->byte_stream_size )
+	{
+		byte_stream_copy_to_uint64_little_endian(
+		 &( bit_stream->byte_stream[ byte_index ] ),
+		 value_64bit );
+	}
+	else
+	{
+		for( byte_offset = 0;
+		     ( byte_offset < 8 ) && ( ( byte_index + byte_offset ) < bit_stream->byte_stream_size );
+		     byte_offset++ )
+		{
+			value_64bit |= (uint64_t) bit_stream->byte_stream[ byte_index + byte_offset ] << ( byte_offset * 8 );
+		}
+	}
+	value_64bit >>= bit_offset & 0x07;
+	value_64bit <<= shift;
+
+	return( (uint32_t) ( value_64bit & ( ( (uint64_t) 1 << number_of_bits ) - 1 ) ) );
+}
+
+/* Retrieves a value from the bit stream
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_bit_stream_get_value(
+     libqcow_zstd_bit_stream_t *bit_stream,
+     uint8_t number_of_bits,
+     uint32_t *value_32bit,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_zstd_bit_stream_get_value";
+
+	if( bit_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bit stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_bits > (uint8_t) 32 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of bits value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( value_32bit == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid 32-bit value.",
+		 function );
+
+		return( -1 );
+	}
+	*value_32bit = libqcow_zstd_bit_stream_peek_value(
+	                bit_stream,
+	                number_of_bits );
+
+	bit_stream->bit_offset -= number_of_bits;
+
+	return( 1 );
+}
+
+/* Builds a FSE decoding table from normalized counts
+ * A normalized count of -1 represents a symbol with a "less than 1" probability
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_fse_table_build(
+     libqcow_zstd_fse_table_t *table,
+     const int16_t *normalized_counts,
+     int number_of_symbols,
+     uint8_t accuracy_log,
+     libcerror_error_t **error )
+{
+	uint16_t next_states[ 256 ];
+
+	static char *function  = "libqcow_zstd_fse_table_build";
+	uint32_t count_total   = 0;
+	uint32_t high_position = 0;
+	uint32_t position      = 0;
+	uint32_t step          = 0;
+	uint32_t table_index   = 0;
+	uint32_t table_mask    = 0;
+	uint32_t table_size    = 0;
+	uint16_t next_state    = 0;
+	uint8_t bit_index      = 0;
+	uint8_t symbol         = 0;
+	int16_t count          = 0;
+	int symbol_index       = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( normalized_counts == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid normalized counts.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_symbols <= 0 )
+	 || ( number_of_symbols > 256 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of symbols value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( accuracy_log < LIBQCOW_ZSTD_FSE_MINIMUM_ACCURACY_LOG )
+	 || ( accuracy_log > LIBQCOW_ZSTD_FSE_MAXIMUM_ACCURACY_LOG ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid accuracy log value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	table_size    = (uint32_t) 1 << accuracy_log;
+	table_mask    = table_size - 1;
+	high_position = table_size;
+
+	for( symbol_index = 0;
+	     symbol_index < number_of_symbols;
+	     symbol_index++ )
+	{
+		count = normalized_counts[ symbol_index ];
+
+		if( count == -1 )
+		{
+			count_total += 1;
+		}
+		else if( count > 0 )
+		{
+			count_total += (uint32_t) count;
+		}
+	}
+	if( count_total != table_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid normalized counts - sum does not match table size.",
+		 function );
+
+		return( -1 );
+	}
+
+	/* Symbols with a "less than 1" probability are stored at the end of the table
+	 */
+	for( symbol_index = 0;
+	     symbol_index < number_of_symbols;
+	     symbol_index++ )
+	{
+		count = normalized_counts[ symbol_index ];
+
+		if( count == -1 )
+		{
+			if( high_position == 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid normalized counts value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			high_position--;
+
+			table->entries[ high_position ].symbol = (uint8_t) symbol_index;
+
+			next_states[ symbol_index ] = 1;
+		}
+		else if( count >= 0 )
+		{
+			next_states[ symbol_index ] = (uint16_t) count;
+		}
+		else
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid normalized count: %" PRIi16 " value out of bounds.",
+			 function,
+			 count );
+
+			return( -1 );
+		}
+	}
+	/* Spread the other symbols over the table
+	 */
+	step = ( table_size >> 1 ) + ( table_size >> 3 ) + 3;
+
+	for( symbol_index = 0;
+	     symbol_index < number_of_symbols;
+	     symbol_index++ )
+	{
+		for( count = normalized_counts[ symbol_index ];
+		     count > 0;
+		     count-- )
+		{
+			if( position >= high_position )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid normalized counts value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			table->entries[ position ].symbol = (uint8_t) symbol_index;
+
+			do
+			{
+				position = ( position + step ) & table_mask;
+			}
+			while( position >= high_position );
+		}
+	}
+	if( position != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid normalized counts - sum does not match table size.",
+		 function );
+
+		return( -1 );
+	}
+	for( table_index = 0;
+	     table_index < table_size;
+	     table_index++ )
+	{
+		symbol     = table->entries[ table_index ].symbol;
+		next_state = next_states[ symbol ];
+
+		next_states[ symbol ] += 1;
+
+		if( next_state == 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid next state value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		LIBQCOW_ZSTD_GET_MOST_SIGNIFICANT_BIT(
+		 next_state,
+		 bit_index );
+
+		table->entries[ table_index ].number_of_bits = accuracy_log - bit_index;
+		table->entries[ table_index ].base_value     = (uint16_t) ( ( next_state << ( accuracy_log - bit_index ) ) - table_size );
+	}
+	table->accuracy_log = accuracy_log;
+
+	return( 1 );
+}
+
+/* Reads a FSE table description and builds the corresponding decoding table
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_fse_table_read(
+     libqcow_zstd_fse_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     uint8_t maximum_accuracy_log,
+     int maximum_symbol,
+     size_t *read_size,
+     libcerror_error_t **error )
+{
+	int16_t normalized_counts[ 256 ];
+
+	static char *function  = "libqcow_zstd_fse_table_read";
+	size_t bit_offset      = 0;
+	size_t byte_index      = 0;
+	uint32_t maximum_value = 0;
+	uint32_t remaining     = 0;
+	uint32_t threshold     = 0;
+	uint32_t value_32bit   = 0;
+	uint8_t accuracy_log   = 0;
+	uint8_t byte_offset    = 0;
+	uint8_t number_of_bits = 0;
+	uint8_t repeat_flag    = 0;
+	int16_t count          = 0;
+	int number_of_symbols  = 0;
+	int repeat_count       = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( byte_stream_size == 0 )
+	 || ( byte_stream_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( maximum_symbol < 0 )
+	 || ( maximum_symbol > 255 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid maximum symbol value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read size.",
+		 function );
+
+		return( -1 );
+	}
+	accuracy_log = ( byte_stream[ 0 ] & 0x0f ) + 5;
+
+	if( accuracy_log > maximum_accuracy_log )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported accuracy log: %" PRIu8 ".",
+		 function,
+		 accuracy_log );
+
+		return( -1 );
+	}
+	bit_offset     = 4;
+	remaining      = ( (uint32_t) 1 << accuracy_log ) + 1;
+	threshold      = (uint32_t) 1 << accuracy_log;
+	number_of_bits = accuracy_log + 1;
+
+	while( ( remaining > 1 )
+	    && ( number_of_symbols <= maximum_symbol ) )
+	{
+		/* Bits beyond the end of the byte stream are 0, the bit offset is checked afterwards
+		 */
+		byte_index  = bit_offset >> 3;
+		value_32bit = 0;
+
+		for( byte_offset = 0;
+		     ( byte_offset < 4 ) && ( ( byte_index + byte_offset ) < byte_stream_size );
+		     byte_offset++ )
+		{
+			value_32bit |= (uint32_t) byte_stream[ byte_index + byte_offset ] << ( byte_offset * 8 );
+		}
+		value_32bit >>= bit_offset & 0x07;
+
+		maximum_value = ( 2 * threshold ) - 1 - remaining;
+
+		if( ( value_32bit & ( threshold - 1 ) ) < maximum_value )
+		{
+			count       = (int16_t) ( value_32bit & ( threshold - 1 ) );
+			bit_offset += number_of_bits - 1;
+		}
+		else
+		{
+			count = (int16_t) ( value_32bit & ( ( 2 * threshold ) - 1 ) );
+
+			if( count >= (int16_t) threshold )
+			{
+				count -= (int16_t) maximum_value;
+			}
+			bit_offset += number_of_bits;
+		}
+		count -= 1;
+
+		if( count < 0 )
+		{
+			remaining -= 1;
+		}
+		else
+		{
+			if( (uint32_t) count > remaining )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid normalized count value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			remaining -= (uint32_t) count;
+		}
+		normalized_counts[ number_of_symbols++ ] = count;
+
+		if( count == 0 )
+		{
+			/* A count of 0 is followed by 2-bit repeat flags for the number of additional symbols with a count of 0
+			 */
+			do
+			{
+				byte_index  = bit_offset >> 3;
+				value_32bit = 0;
+
+				if( byte_index < byte_stream_size )
+				{
+					value_32bit = byte_stream[ byte_index ];
+				}
+				if( ( byte_index + 1 ) < byte_stream_size )
+				{
+					value_32bit |= (uint32_t) byte_stream[ byte_index + 1 ] << 8;
+				}
+				repeat_flag = (uint8_t) ( ( value_32bit >> ( bit_offset & 0x07 ) ) & 0x03 );
+				bit_offset += 2;
+
+				if( ( number_of_symbols + repeat_flag ) > ( maximum_symbol + 1 ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid number of symbols value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				for( repeat_count = 0;
+				     repeat_count < (int) repeat_flag;
+				     repeat_count++ )
+				{
+					normalized_counts[ number_of_symbols++ ] = 0;
+				}
+			}
+			while( repeat_flag == 0x03 );
+		}
+		while( remaining < threshold )
+		{
+			number_of_bits--;
+			threshold >>= 1;
+		}
+		if( bit_offset > ( byte_stream_size * 8 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( remaining != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid normalized counts - sum does not match table size.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_zstd_fse_table_build(
+	     table,
+	     normalized_counts,
+	     number_of_symbols,
+	     accuracy_log,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to build table.",
+		 function );
+
+		return( -1 );
+	}
+	*read_size = ( bit_offset + 7 ) / 8;
+
+	return( 1 );
+}
+
+/* Builds a Huffman decoding table from weights
+ * The weight of the last symbol is not stored and is derived from the other weights
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_huffman_table_build(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *weights,
+     int number_of_weights,
+     libcerror_error_t **error )
+{
+	uint8_t symbol_weights[ 256 ];
+
+	static char *function          = "libqcow_zstd_huffman_table_build";
+	uint32_t entry_index           = 0;
+	uint32_t number_of_entries     = 0;
+	uint32_t remaining_weight      = 0;
+	uint32_t table_index           = 0;
+	uint32_t weight_total          = 0;
+	uint16_t lookup_entry          = 0;
+	uint8_t bit_index              = 0;
+	uint8_t maximum_number_of_bits = 0;
+	uint8_t weight                 = 0;
+	int number_of_symbols          = 0;
+	int symbol                     = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( weights == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid weights.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_weights <= 0 )
+	 || ( number_of_weights > 255 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of weights value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	for( symbol = 0;
+	     symbol < number_of_weights;
+	     symbol++ )
+	{
+		weight = weights[ symbol ];
+
+		if( weight > LIBQCOW_ZSTD_HUFFMAN_MAXIMUM_NUMBER_OF_BITS )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid weight: %" PRIu8 " value out of bounds.",
+			 function,
+			 weight );
+
+			return( -1 );
+		}
+		if( weight > 0 )
+		{
+			weight_total += (uint32_t) 1 << ( weight - 1 );
+		}
+		symbol_weights[ symbol ] = weight;
+	}
+	if( weight_total == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid weight total value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	LIBQCOW_ZSTD_GET_MOST_SIGNIFICANT_BIT(
+	 weight_total,
+	 bit_index );
+
+	maximum_number_of_bits = bit_index + 1;
+
+	if( maximum_number_of_bits > LIBQCOW_ZSTD_HUFFMAN_MAXIMUM_NUMBER_OF_BITS )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid maximum number of bits value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	/* The weight of the last symbol completes the weight total to a power of 2
+	 */
+	remaining_weight = ( (uint32_t) 1 << maximum_number_of_bits ) - weight_total;
+
+	if( ( remaining_weight & ( remaining_weight - 1 ) ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid remaining weight value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	LIBQCOW_ZSTD_GET_MOST_SIGNIFICANT_BIT(
+	 remaining_weight,
+	 bit_index );
+
+	symbol_weights[ number_of_weights ] = bit_index + 1;
+
+	number_of_symbols = number_of_weights + 1;
+
+	/* The codes with the lowest weight, which are the longest codes, are stored first
+	 */
+	for( weight = 1;
+	     weight <= maximum_number_of_bits;
+	     weight++ )
+	{
+		number_of_entries = (uint32_t) 1 << ( weight - 1 );
+
+		for( symbol = 0;
+		     symbol < number_of_symbols;
+		     symbol++ )
+		{
+			if( symbol_weights[ symbol ] != weight )
+			{
+				continue;
+			}
+			lookup_entry = (uint16_t) symbol | (uint16_t) ( ( maximum_number_of_bits + 1 - weight ) << 8 );
+
+			for( entry_index = 0;
+			     entry_index < number_of_entries;
+			     entry_index++ )
+			{
+				table->lookup_table[ table_index++ ] = lookup_entry;
+			}
+		}
+	}
+	table->maximum_number_of_bits = maximum_number_of_bits;
+
+	return( 1 );
+}
+
+/* Reads a Huffman tree description and builds the corresponding decoding table
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_huffman_table_read(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     size_t *read_size,
+     libcerror_error_t **error )
+{
+	uint8_t weights[ 256 ];
+
+	libqcow_zstd_bit_stream_t bit_stream;
+	libqcow_zstd_fse_table_t weights_table;
+
+	static char *function          = "libqcow_zstd_huffman_table_read";
+	size_t compressed_weights_size = 0;
+	size_t table_size              = 0;
+	uint32_t first_state           = 0;
+	uint32_t second_state          = 0;
+	uint8_t byte_value             = 0;
+	uint8_t header_value           = 0;
+	uint8_t number_of_bits         = 0;
+	int number_of_weights          = 0;
+	int weight_index               = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( byte_stream_size == 0 )
+	 || ( byte_stream_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read size.",
+		 function );
+
+		return( -1 );
+	}
+	header_value = byte_stream[ 0 ];
+
+	if( header_value >= 128 )
+	{
+		/* The weights are stored as 4-bit values
+		 */
+		number_of_weights       = (int) header_value - 127;
+		compressed_weights_size = (size_t) ( number_of_weights + 1 ) / 2;
+
+		if( compressed_weights_size > ( byte_stream_size - 1 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		for( weight_index = 0;
+		     weight_index < number_of_weights;
+		     weight_index++ )
+		{
+			byte_value = byte_stream[ 1 + ( weight_index / 2 ) ];
+
+			if( ( weight_index % 2 ) == 0 )
+			{
+				weights[ weight_index ] = byte_value >> 4;
+			}
+			else
+			{
+				weights[ weight_index ] = byte_value & 0x0f;
+			}
+		}
+	}
+	else
+	{
+		/* The weights are FSE compressed
+		 */
+		compressed_weights_size = (size_t) header_value;
+
+		if( ( compressed_weights_size == 0 )
+		 || ( compressed_weights_size > ( byte_stream_size - 1 ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid compressed weights size value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_zstd_fse_table_read(
+		     &weights_table,
+		     &( byte_stream[ 1 ] ),
+		     compressed_weights_size,
+		     6,
+		     255,
+		     &table_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to read weights FSE table.",
+			 function );
+
+			return( -1 );
+		}
+		if( table_size >= compressed_weights_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid compressed weights size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_zstd_bit_stream_initialize(
+		     &bit_stream,
+		     &( byte_stream[ 1 + table_size ] ),
+		     compressed_weights_size - table_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to initialize bit stream.",
+			 function );
+
+			return( -1 );
+		}
+		first_state = libqcow_zstd_bit_stream_peek_value(
+		               &bit_stream,
+		               weights_table.accuracy_log );
+
+		bit_stream.bit_offset -= weights_table.accuracy_log;
+
+		second_state = libqcow_zstd_bit_stream_peek_value(
+		                &bit_stream,
+		                weights_table.accuracy_log );
+
+		bit_stream.bit_offset -= weights_table.accuracy_log;
+
+		/* The two states are decoded alternately until the bit stream overflows
+		 * after which the symbol of the other state is the last weight
+		 */
+		while( number_of_weights < 254 )
+		{
+			weights[ number_of_weights++ ] = weights_table.entries[ first_state ].symbol;
+
+			number_of_bits = weights_table.entries[ first_state ].number_of_bits;
+			first_state    = (uint32_t) weights_table.entries[ first_state ].base_value
+			               + libqcow_zstd_bit_stream_peek_value(
+			                  &bit_stream,
+			                  number_of_bits );
+
+			bit_stream.bit_offset -= number_of_bits;
+
+			if( bit_stream.bit_offset < 0 )
+			{
+				weights[ number_of_weights++ ] = weights_table.entries[ second_state ].symbol;
+
+				break;
+			}
+			weights[ number_of_weights++ ] = weights_table.entries[ second_state ].symbol;
+
+			number_of_bits = weights_table.entries[ second_state ].number_of_bits;
+			second_state   = (uint32_t) weights_table.entries[ second_state ].base_value
+			               + libqcow_zstd_bit_stream_peek_value(
+			                  &bit_stream,
+			                  number_of_bits );
+
+			bit_stream.bit_offset -= number_of_bits;
+
+			if( bit_stream.bit_offset < 0 )
+			{
+				weights[ number_of_weights++ ] = weights_table.entries[ first_state ].symbol;
+
+				break;
+			}
+		}
+		if( bit_stream.bit_offset >= 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of weights value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( libqcow_zstd_huffman_table_build(
+	     table,
+	     weights,
+	     number_of_weights,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to build table.",
+		 function );
+
+		return( -1 );
+	}
+	*read_size = 1 + compressed_weights_size;
+
+	return( 1 );
+}
+
+/* Decodes a Huffman encoded stream of literals
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_decode_huffman_stream(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     libcerror_error_t **error )
+{
+	libqcow_zstd_bit_stream_t bit_stream;
+
+	static char *function           = "libqcow_zstd_decode_huffman_stream";
+	size_t uncompressed_data_offset = 0;
+	uint32_t value_32bit            = 0;
+	uint16_t lookup_entry           = 0;
+	uint8_t maximum_number_of_bits  = 0;
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( table->maximum_number_of_bits == 0 )
+	 || ( table->maximum_number_of_bits > LIBQCOW_ZSTD_HUFFMAN_MAXIMUM_NUMBER_OF_BITS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid table - maximum number of bits value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid uncompressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_zstd_bit_stream_initialize(
+	     &bit_stream,
+	     byte_stream,
+	     byte_stream_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize bit stream.",
+		 function );
+
+		return( -1 );
+	}
+	maximum_number_of_bits = table->maximum_number_of_bits;
+
+	while( uncompressed_data_offset < uncompressed_data_size )
+	{
+		value_32bit = libqcow_zstd_bit_stream_peek_value(
+		               &bit_stream,
+		               maximum_number_of_bits );
+
+		lookup_entry = table->lookup_table[ value_32bit ];
+
+		uncompressed_data[ uncompressed_data_offset++ ] = LIBQCOW_ZSTD_HUFFMAN_LOOKUP_ENTRY_SYMBOL( lookup_entry );
+
+		bit_stream.bit_offset -= LIBQCOW_ZSTD_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( lookup_entry );
+	}
+	if( bit_stream.bit_offset != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bit stream - stream not fully consumed.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads a literals section
+ * The literals either reference the byte stream or the literals buffer of the frame context
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_read_literals_section(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     const uint8_t **literals,
+     size_t *number_of_literals,
+     size_t *read_size,
+     libcerror_error_t **error )
+{
+	static char *function       = "libqcow_zstd_read_literals_section";
+	const uint8_t *streams_data = NULL;
+	size_t compressed_size      = 0;
+	size_t header_size          = 0;
+	size_t regenerated_size     = 0;
+	size_t segment_size         = 0;
+	size_t stream_offset        = 0;
+	size_t stream_sizes[ 4 ]    = { 0, 0, 0, 0 };
+	size_t streams_data_size    = 0;
+	size_t tree_size            = 0;
+	uint64_t value_64bit        = 0;
+	uint8_t literals_block_type = 0;
+	uint8_t number_of_streams   = 0;
+	uint8_t size_format         = 0;
+	uint8_t stream_index        = 0;
+
+	if( frame_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid frame context.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( byte_stream_size == 0 )
+	 || ( byte_stream_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( literals == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid literals.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_literals == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of literals.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read size.",
+		 function );
+
+		return( -1 );
+	}
+	literals_block_type = byte_stream[ 0 ] & 0x03;
+	size_format         = ( byte_stream[ 0 ] >> 2 ) & 0x03;
+
+	if( ( literals_block_type == LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_RAW )
+	 || ( literals_block_type == LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_RLE ) )
+	{
+		switch( size_format )
+		{
+			case 1:
+				header_size = 2;
+				break;
+
+			case 3:
+				header_size = 3;
+				break;
+
+			default:
+				header_size = 1;
+				break;
+		}
+		if( header_size > byte_stream_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		if( header_size == 1 )
+		{
+			regenerated_size = (size_t) ( byte_stream[ 0 ] >> 3 );
+		}
+		else if( header_size == 2 )
+		{
+			regenerated_size = (size_t) ( byte_stream[ 0 ] >> 4 )
+			                 | ( (size_t) byte_stream[ 1 ] << 4 );
+		}
+		else
+		{
+			regenerated_size = (size_t) ( byte_stream[ 0 ] >> 4 )
+			                 | ( (size_t) byte_stream[ 1 ] << 4 )
+			                 | ( (size_t) byte_stream[ 2 ] << 12 );
+		}
+		if( regenerated_size > (size_t) LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid regenerated size value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		if( literals_block_type == LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_RAW )
+		{
+			if( regenerated_size > ( byte_stream_size - header_size ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid byte stream size value too small.",
+				 function );
+
+				return( -1 );
+			}
+			*literals  = &( byte_stream[ header_size ] );
+			*read_size = header_size + regenerated_size;
+		}
+		else
+		{
+			if( header_size >= byte_stream_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid byte stream size value too small.",
+				 function );
+
+				return( -1 );
+			}
+			if( regenerated_size > frame_context->literals_buffer_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid regenerated size value exceeds literals buffer size.",
+				 function );
+
+				return( -1 );
+			}
+			if( memory_set(
+			     frame_context->literals_buffer,
+			     byte_stream[ header_size ],
+			     regenerated_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to set literals.",
+				 function );
+
+				return( -1 );
+			}
+			*literals  = frame_context->literals_buffer;
+			*read_size = header_size + 1;
+		}
+		*number_of_literals = regenerated_size;
+
+		return( 1 );
+	}
+	switch( size_format )
+	{
+		case 0:
+			header_size       = 3;
+			number_of_streams = 1;
+			break;
+
+		case 1:
+			header_size       = 3;
+			number_of_streams = 4;
+			break;
+
+		case 2:
+			header_size       = 4;
+			number_of_streams = 4;
+			break;
+
+		default:
+			header_size       = 5;
+			number_of_streams = 4;
+			break;
+	}
+	if( header_size > byte_stream_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value too small.",
+		 function );
+
+		return( -1 );
+	}
+	for( stream_offset = 0;
+	     stream_offset < header_size;
+	     stream_offset++ )
+	{
+		value_64bit |= (uint64_t) byte_stream[ stream_offset ] << ( stream_offset * 8 );
+	}
+	if( header_size == 3 )
+	{
+		regenerated_size = (size_t) ( ( value_64bit >> 4 ) & 0x000003ffUL );
+		compressed_size  = (size_t) ( ( value_64bit >> 14 ) & 0x000003ffUL );
+	}
+	else if( header_size == 4 )
+	{
+		regenerated_size = (size_t) ( ( value_64bit >> 4 ) & 0x00003fffUL );
+		compressed_size  = (size_t) ( ( value_64bit >> 18 ) & 0x00003fffUL );
+	}
+	else
+	{
+		regenerated_size = (size_t) ( ( value_64bit >> 4 ) & 0x0003ffffUL );
+		compressed_size  = (size_t) ( ( value_64bit >> 22 ) & 0x0003ffffUL );
+	}
+	if( ( regenerated_size > (size_t) LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE )
+	 || ( regenerated_size > frame_context->literals_buffer_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid regenerated size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( compressed_size == 0 )
+	 || ( compressed_size > ( byte_stream_size - header_size ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid compressed size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	streams_data      = &( byte_stream[ header_size ] );
+	streams_data_size = compressed_size;
+
+	if( literals_block_type == LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_COMPRESSED )
+	{
+		if( libqcow_zstd_huffman_table_read(
+		     &( frame_context->literals_table ),
+		     streams_data,
+		     streams_data_size,
+		     &tree_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to read Huffman table.",
+			 function );
+
+			return( -1 );
+		}
+		streams_data      += tree_size;
+		streams_data_size -= tree_size;
+	}
+	else if( frame_context->literals_table.maximum_number_of_bits == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing Huffman table to repeat.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_streams == 1 )
+	{
+		if( libqcow_zstd_decode_huffman_stream(
+		     &( frame_context->literals_table ),
+		     streams_data,
+		     streams_data_size,
+		     frame_context->literals_buffer,
+		     regenerated_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+			 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+			 "%s: unable to decode Huffman stream.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	else
+	{
+		/* The 4 streams are preceded by a jump table with the size of the first 3 streams
+		 */
+		if( streams_data_size < 6 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid streams data size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		byte_stream_copy_to_uint16_little_endian(
+		 &( streams_data[ 0 ] ),
+		 stream_sizes[ 0 ] );
+
+		byte_stream_copy_to_uint16_little_endian(
+		 &( streams_data[ 2 ] ),
+		 stream_sizes[ 1 ] );
+
+		byte_stream_copy_to_uint16_little_endian(
+		 &( streams_data[ 4 ] ),
+		 stream_sizes[ 2 ] );
+
+		streams_data      += 6;
+		streams_data_size -= 6;
+
+		if( ( stream_sizes[ 0 ] + stream_sizes[ 1 ] + stream_sizes[ 2 ] ) >= streams_data_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid stream sizes value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		stream_sizes[ 3 ] = streams_data_size - ( stream_sizes[ 0 ] + stream_sizes[ 1 ] + stream_sizes[ 2 ] );
+
+		segment_size = ( regenerated_size + 3 ) / 4;
+
+		if( ( 3 * segment_size ) > regenerated_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid regenerated size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		stream_offset = 0;
+
+		for( stream_index = 0;
+		     stream_index < 4;
+		     stream_index++ )
+		{
+			if( libqcow_zstd_decode_huffman_stream(
+			     &( frame_context->literals_table ),
+			     &( streams_data[ stream_offset ] ),
+			     stream_sizes[ stream_index ],
+			     &( frame_context->literals_buffer[ stream_index * segment_size ] ),
+			     ( stream_index < 3 ) ? segment_size : regenerated_size - ( 3 * segment_size ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+				 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+				 "%s: unable to decode Huffman stream: %" PRIu8 ".",
+				 function,
+				 stream_index );
+
+				return( -1 );
+			}
+			stream_offset += stream_sizes[ stream_index ];
+		}
+	}
+	*literals           = frame_context->literals_buffer;
+	*number_of_literals = regenerated_size;
+	*read_size          = header_size + compressed_size;
+
+	return( 1 );
+}
+
+/* Reads the FSE table of one of the sequences symbol types
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_read_sequences_table(
+     libqcow_zstd_fse_table_t *table,
+     uint8_t compression_mode,
+     const int16_t *predefined_normalized_counts,
+     int number_of_predefined_normalized_counts,
+     uint8_t predefined_accuracy_log,
+     uint8_t maximum_accuracy_log,
+     int maximum_symbol,
+     uint8_t table_is_set,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     size_t *read_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_zstd_read_sequences_table";
+
+	if( table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid table.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read size.",
+		 function );
+
+		return( -1 );
+	}
+	*read_size = 0;
+
+	switch( compression_mode )
+	{
+		case LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_PREDEFINED:
+			if( libqcow_zstd_fse_table_build(
+			     table,
+			     predefined_normalized_counts,
+			     number_of_predefined_normalized_counts,
+			     predefined_accuracy_log,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to build predefined table.",
+				 function );
+
+				return( -1 );
+			}
+			break;
+
+		case LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_RLE:
+			if( byte_stream_size < 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid byte stream size value too small.",
+				 function );
+
+				return( -1 );
+			}
+			if( (int) byte_stream[ 0 ] > maximum_symbol )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid RLE symbol value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			table->accuracy_log = 0;
+
+			table->entries[ 0 ].base_value     = 0;
+			table->entries[ 0 ].symbol         = byte_stream[ 0 ];
+			table->entries[ 0 ].number_of_bits = 0;
+
+			*read_size = 1;
+
+			break;
+
+		case LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_FSE:
+			if( libqcow_zstd_fse_table_read(
+			     table,
+			     byte_stream,
+			     byte_stream_size,
+			     maximum_accuracy_log,
+			     maximum_symbol,
+			     read_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to read table.",
+				 function );
+
+				return( -1 );
+			}
+			break;
+
+		default:
+			if( table_is_set == 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+				 "%s: missing table to repeat.",
+				 function );
+
+				return( -1 );
+			}
+			break;
+	}
+	return( 1 );
+}
+
+/* Reads a sequences section and executes the sequences
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_decode_sequences(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     const uint8_t *literals,
+     size_t number_of_literals,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t frame_start_offset,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error )
+{
+	libqcow_zstd_bit_stream_t bit_stream;
+
+	libqcow_zstd_fse_table_entry_t *literals_length_entry = NULL;
+	libqcow_zstd_fse_table_entry_t *match_length_entry    = NULL;
+	libqcow_zstd_fse_table_entry_t *offset_entry          = NULL;
+	static char *function                                 = "libqcow_zstd_decode_sequences";
+	size_t byte_stream_offset                             = 0;
+	size_t data_offset                                    = 0;
+	size_t literals_offset                                = 0;
+	size_t read_size                                      = 0;
+	uint32_t literals_length                              = 0;
+	uint32_t literals_length_state                        = 0;
+	uint32_t match_length                                 = 0;
+	uint32_t match_length_state                           = 0;
+	uint32_t number_of_sequences                          = 0;
+	uint32_t offset                                       = 0;
+	uint32_t offset_state                                 = 0;
+	uint32_t offset_value                                 = 0;
+	uint32_t sequence_index                               = 0;
+	uint8_t literals_length_code                          = 0;
+	uint8_t match_length_code                             = 0;
+	uint8_t offset_code                                   = 0;
+	uint8_t symbol_compression_modes                      = 0;
+
+	if( frame_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid frame context.",
+		 function );
+
+		return( -1 );
+	}
+	if( byte_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid byte stream.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( byte_stream_size == 0 )
+	 || ( byte_stream_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid byte stream size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( literals == NULL )
+	 && ( number_of_literals > 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid literals.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid uncompressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data offset.",
+		 function );
+
+		return( -1 );
+	}
+	data_offset = *uncompressed_data_offset;
+
+	if( ( frame_start_offset > data_offset )
+	 || ( data_offset > uncompressed_data_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid uncompressed data offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_sequences = byte_stream[ 0 ];
+
+	if( number_of_sequences < 128 )
+	{
+		byte_stream_offset = 1;
+	}
+	else if( number_of_sequences < 255 )
+	{
+		if( byte_stream_size < 2 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		number_of_sequences = ( ( number_of_sequences - 128 ) << 8 ) + byte_stream[ 1 ];
+		byte_stream_offset  = 2;
+	}
+	else
+	{
+		if( byte_stream_size < 3 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		number_of_sequences = (uint32_t) byte_stream[ 1 ] + ( (uint32_t) byte_stream[ 2 ] << 8 ) + 0x7f00;
+		byte_stream_offset  = 3;
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: number of sequences\t\t\t: %" PRIu32 "\n",
+		 function,
+		 number_of_sequences );
+	}
+#endif
+	if( number_of_sequences > 0 )
+	{
+		if( byte_stream_offset >= byte_stream_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		symbol_compression_modes = byte_stream[ byte_stream_offset++ ];
+
+		if( ( symbol_compression_modes & 0x03 ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported symbol compression modes - reserved bits set.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_zstd_read_sequences_table(
+		     &( frame_context->literals_length_table ),
+		     ( symbol_compression_modes >> 6 ) & 0x03,
+		     libqcow_zstd_literals_length_predefined_normalized_counts,
+		     36,
+		     6,
+		     9,
+		     35,
+		     frame_context->sequences_tables_set & 0x01,
+		     &( byte_stream[ byte_stream_offset ] ),
+		     byte_stream_size - byte_stream_offset,
+		     &read_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to read literals length table.",
+			 function );
+
+			return( -1 );
+		}
+		byte_stream_offset                  += read_size;
+		frame_context->sequences_tables_set |= 0x01;
+
+		if( libqcow_zstd_read_sequences_table(
+		     &( frame_context->offset_table ),
+		     ( symbol_compression_modes >> 4 ) & 0x03,
+		     libqcow_zstd_offset_predefined_normalized_counts,
+		     29,
+		     5,
+		     8,
+		     31,
+		     frame_context->sequences_tables_set & 0x02,
+		     &( byte_stream[ byte_stream_offset ] ),
+		     byte_stream_size - byte_stream_offset,
+		     &read_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to read offset table.",
+			 function );
+
+			return( -1 );
+		}
+		byte_stream_offset                  += read_size;
+		frame_context->sequences_tables_set |= 0x02;
+
+		if( libqcow_zstd_read_sequences_table(
+		     &( frame_context->match_length_table ),
+		     ( symbol_compression_modes >> 2 ) & 0x03,
+		     libqcow_zstd_match_length_predefined_normalized_counts,
+		     53,
+		     6,
+		     9,
+		     52,
+		     frame_context->sequences_tables_set & 0x04,
+		     &( byte_stream[ byte_stream_offset ] ),
+		     byte_stream_size - byte_stream_offset,
+		     &read_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to read match length table.",
+			 function );
+
+			return( -1 );
+		}
+		byte_stream_offset                  += read_size;
+		frame_context->sequences_tables_set |= 0x04;
+
+		if( byte_stream_offset >= byte_stream_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid byte stream size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_zstd_bit_stream_initialize(
+		     &bit_stream,
+		     &( byte_stream[ byte_stream_offset ] ),
+		     byte_stream_size - byte_stream_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to initialize bit stream.",
+			 function );
+
+			return( -1 );
+		}
+		literals_length_state = libqcow_zstd_bit_stream_peek_value(
+		                         &bit_stream,
+		                         frame_context->literals_length_table.accuracy_log );
+
+		bit_stream.bit_offset -= frame_context->literals_length_table.accuracy_log;
+
+		offset_state = libqcow_zstd_bit_stream_peek_value(
+		                &bit_stream,
+		                frame_context->offset_table.accuracy_log );
+
+		bit_stream.bit_offset -= frame_context->offset_table.accuracy_log;
+
+		match_length_state = libqcow_zstd_bit_stream_peek_value(
+		                      &bit_stream,
+		                      frame_context->match_length_table.accuracy_log );
+
+		bit_stream.bit_offset -= frame_context->match_length_table.accuracy_log;
+
+		for( sequence_index = 0;
+		     sequence_index < number_of_sequences;
+		     sequence_index++ )
+		{
+			literals_length_entry = &( frame_context->literals_length_table.entries[ literals_length_state ] );
+			offset_entry          = &( frame_context->offset_table.entries[ offset_state ] );
+			match_length_entry    = &( frame_context->match_length_table.entries[ match_length_state ] );
+
+			literals_length_code = literals_length_entry->symbol;
+			offset_code          = offset_entry->symbol;
+			match_length_code    = match_length_entry->symbol;
+
+			/* The additional bits are stored in the order: offset, match length and literals length
+			 */
+			offset_value = ( (uint32_t) 1 << offset_code )
+			             + libqcow_zstd_bit_stream_peek_value(
+			                &bit_stream,
+			                offset_code );
+
+			bit_stream.bit_offset -= offset_code;
+
+			match_length = libqcow_zstd_match_length_base_values[ match_length_code ]
+			             + libqcow_zstd_bit_stream_peek_value(
+			                &bit_stream,
+			                libqcow_zstd_match_length_number_of_bits[ match_length_code ] );
+
+			bit_stream.bit_offset -= libqcow_zstd_match_length_number_of_bits[ match_length_code ];
+
+			literals_length = libqcow_zstd_literals_length_base_values[ literals_length_code ]
+			                + libqcow_zstd_bit_stream_peek_value(
+			                   &bit_stream,
+			                   libqcow_zstd_literals_length_number_of_bits[ literals_length_code ] );
+
+			bit_stream.bit_offset -= libqcow_zstd_literals_length_number_of_bits[ literals_length_code ];
+
+			if( bit_stream.bit_offset < 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid bit stream - stream too small.",
+				 function );
+
+				return( -1 );
+			}
+			if( offset_value > 3 )
+			{
+				offset = offset_value - 3;
+
+				frame_context->repeated_offsets[ 2 ] = frame_context->repeated_offsets[ 1 ];
+				frame_context->repeated_offsets[ 1 ] = frame_context->repeated_offsets[ 0 ];
+				frame_context->repeated_offsets[ 0 ] = offset;
+			}
+			else
+			{
+				/* When the literals length is 0 the repeated offsets are shifted by one
+				 */
+				if( literals_length == 0 )
+				{
+					offset_value += 1;
+				}
+				if( offset_value == 1 )
+				{
+					offset = frame_context->repeated_offsets[ 0 ];
+				}
+				else
+				{
+					if( offset_value == 4 )
+					{
+						offset = frame_context->repeated_offsets[ 0 ] - 1;
+					}
+					else
+					{
+						offset = frame_context->repeated_offsets[ offset_value - 1 ];
+					}
+					if( offset_value != 2 )
+					{
+						frame_context->repeated_offsets[ 2 ] = frame_context->repeated_offsets[ 1 ];
+					}
+					frame_context->repeated_offsets[ 1 ] = frame_context->repeated_offsets[ 0 ];
+					frame_context->repeated_offsets[ 0 ] = offset;
+				}
+			}
+			if( ( (size_t) literals_length > ( number_of_literals - literals_offset ) )
+			 || ( (size_t) literals_length > ( uncompressed_data_size - data_offset ) ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid literals length value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			if( literals_length > 0 )
+			{
+				if( memory_copy(
+				     &( uncompressed_data[ data_offset ] ),
+				     &( literals[ literals_offset ] ),
+				     (size_t) literals_length ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy literals to uncompressed data.",
+					 function );
+
+					return( -1 );
+				}
+				literals_offset += literals_length;
+				data_offset     += literals_length;
+			}
+			if( ( offset == 0 )
+			 || ( (size_t) offset > ( data_offset - frame_start_offset ) ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			if( (size_t) match_length > ( uncompressed_data_size - data_offset ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid match length value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			if( match_length <= offset )
+			{
+				if( memory_copy(
+				     &( uncompressed_data[ data_offset ] ),
+				     &( uncompressed_data[ data_offset - offset ] ),
+				     (size_t) match_length ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy match to uncompressed data.",
+					 function );
+
+					return( -1 );
+				}
+				data_offset += match_length;
+			}
+			else
+			{
+				/* The match overlaps with the data it is copied to
+				 */
+				while( match_length > 0 )
+				{
+					uncompressed_data[ data_offset ] = uncompressed_data[ data_offset - offset ];
+
+					data_offset++;
+					match_length--;
+				}
+			}
+			/* The states are updated in the order: literals length, match length and offset
+			 */
+			if( ( sequence_index + 1 ) < number_of_sequences )
+			{
+				literals_length_state = literals_length_entry->base_value
+				                      + libqcow_zstd_bit_stream_peek_value(
+				                         &bit_stream,
+				                         literals_length_entry->number_of_bits );
+
+				bit_stream.bit_offset -= literals_length_entry->number_of_bits;
+
+				match_length_state = match_length_entry->base_value
+				                   + libqcow_zstd_bit_stream_peek_value(
+				                      &bit_stream,
+				                      match_length_entry->number_of_bits );
+
+				bit_stream.bit_offset -= match_length_entry->number_of_bits;
+
+				offset_state = offset_entry->base_value
+				             + libqcow_zstd_bit_stream_peek_value(
+				                &bit_stream,
+				                offset_entry->number_of_bits );
+
+				bit_stream.bit_offset -= offset_entry->number_of_bits;
+			}
+		}
+		if( bit_stream.bit_offset != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid bit stream - stream not fully consumed.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	else if( byte_stream_offset != byte_stream_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid sequences section - trailing data.",
+		 function );
+
+		return( -1 );
+	}
+	/* The remaining literals are copied after the last sequence
+	 */
+	if( literals_offset < number_of_literals )
+	{
+		if( ( number_of_literals - literals_offset ) > ( uncompressed_data_size - data_offset ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid uncompressed data size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		if( memory_copy(
+		     &( uncompressed_data[ data_offset ] ),
+		     &( literals[ literals_offset ] ),
+		     number_of_literals - literals_offset ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy literals to uncompressed data.",
+			 function );
+
+			return( -1 );
+		}
+		data_offset += number_of_literals - literals_offset;
+	}
+	*uncompressed_data_offset = data_offset;
+
+	return( 1 );
+}
+
+/* Reads a compressed block
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_read_compressed_block(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t frame_start_offset,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error )
+{
+	const uint8_t *literals   = NULL;
+	static char *function     = "libqcow_zstd_read_compressed_block";
+	size_t number_of_literals = 0;
+	size_t read_size          = 0;
+
+	if( compressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( compressed_data_size == 0 )
+	 || ( compressed_data_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid compressed data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_zstd_read_literals_section(
+	     frame_context,
+	     compressed_data,
+	     compressed_data_size,
+	     &literals,
+	     &number_of_literals,
+	     &read_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to read literals section.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_size >= compressed_data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid compressed data size value too small.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_zstd_decode_sequences(
+	     frame_context,
+	     &( compressed_data[ read_size ] ),
+	     compressed_data_size - read_size,
+	     literals,
+	     number_of_literals,
+	     uncompressed_data,
+	     uncompressed_data_size,
+	     frame_start_offset,
+	     uncompressed_data_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+		 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+		 "%s: unable to decode sequences.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads a frame
+ * The frame context is reset at the start of the frame
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_read_frame(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     size_t *compressed_data_offset,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error )
+{
+	static char *function           = "libqcow_zstd_read_frame";
+	size_t block_size               = 0;
+	size_t data_offset              = 0;
+	size_t frame_start_offset       = 0;
+	size_t safe_compressed_offset   = 0;
+	uint64_t frame_content_size     = 0;
+	uint32_t block_header           = 0;
+	uint32_t dictionary_identifier  = 0;
+	uint32_t signature              = 0;
+	uint8_t block_type              = 0;
+	uint8_t byte_index              = 0;
+	uint8_t dictionary_id_size      = 0;
+	uint8_t frame_content_size_size = 0;
+	uint8_t frame_header_descriptor = 0;
+	uint8_t last_block_flag         = 0;
+	uint8_t single_segment_flag     = 0;
+
+	if( frame_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid frame context.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid compressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid uncompressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data offset.",
+		 function );
+
+		return( -1 );
+	}
+	safe_compressed_offset = *compressed_data_offset;
+	frame_start_offset     = *uncompressed_data_offset;
+	data_offset            = frame_start_offset;
+
+	if( ( safe_compressed_offset > compressed_data_size )
+	 || ( ( compressed_data_size - safe_compressed_offset ) < 5 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid compressed data size value too small.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_offset > uncompressed_data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid uncompressed data offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	byte_stream_copy_to_uint32_little_endian(
+	 &( compressed_data[ safe_compressed_offset ] ),
+	 signature );
+
+	if( signature != LIBQCOW_ZSTD_FRAME_SIGNATURE )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported frame signature: 0x%08" PRIx32 ".",
+		 function,
+		 signature );
+
+		return( -1 );
+	}
+	frame_header_descriptor = compressed_data[ safe_compressed_offset + 4 ];
+
+	safe_compressed_offset += 5;
+
+	if( ( frame_header_descriptor & 0x08 ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported frame header descriptor - reserved bit set.",
+		 function );
+
+		return( -1 );
+	}
+	single_segment_flag = ( frame_header_descriptor >> 5 ) & 0x01;
+
+	switch( frame_header_descriptor & 0x03 )
+	{
+		case 1:
+			dictionary_id_size = 1;
+			break;
+
+		case 2:
+			dictionary_id_size = 2;
+			break;
+
+		case 3:
+			dictionary_id_size = 4;
+			break;
+
+		default:
+			dictionary_id_size = 0;
+			break;
+	}
+	switch( frame_header_descriptor >> 6 )
+	{
+		case 1:
+			frame_content_size_size = 2;
+			break;
+
+		case 2:
+			frame_content_size_size = 4;
+			break;
+
+		case 3:
+			frame_content_size_size = 8;
+			break;
+
+		default:
+			frame_content_size_size = single_segment_flag;
+			break;
+	}
+	/* The window descriptor is only present when the frame is not a single segment
+	 */
+	if( ( compressed_data_size - safe_compressed_offset ) < (size_t) ( ( 1 - single_segment_flag ) + dictionary_id_size + frame_content_size_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid compressed data size value too small.",
+		 function );
+
+		return( -1 );
+	}
+	if( single_segment_flag == 0 )
+	{
+		safe_compressed_offset += 1;
+	}
+	for( byte_index = 0;
+	     byte_index < dictionary_id_size;
+	     byte_index++ )
+	{
+		dictionary_identifier |= (uint32_t) compressed_data[ safe_compressed_offset++ ] << ( byte_index * 8 );
+	}
+	if( dictionary_identifier != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported dictionary identifier: %" PRIu32 ".",
+		 function,
+		 dictionary_identifier );
+
+		return( -1 );
+	}
+	for( byte_index = 0;
+	     byte_index < frame_content_size_size;
+	     byte_index++ )
+	{
+		frame_content_size |= (uint64_t) compressed_data[ safe_compressed_offset++ ] << ( byte_index * 8 );
+	}
+	if( frame_content_size_size == 2 )
+	{
+		frame_content_size += 256;
+	}
+	if( ( frame_content_size_size != 0 )
+	 && ( frame_content_size > (uint64_t) ( uncompressed_data_size - data_offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid frame content size value exceeds uncompressed data size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: frame header descriptor\t\t\t: 0x%02" PRIx8 "\n",
+		 function,
+		 frame_header_descriptor );
+
+		libcnotify_printf(
+		 "%s: frame content size\t\t\t: %" PRIu64 "\n",
+		 function,
+		 frame_content_size );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	frame_context->literals_table.maximum_number_of_bits = 0;
+	frame_context->sequences_tables_set                  = 0;
+	frame_context->repeated_offsets[ 0 ]                 = 1;
+	frame_context->repeated_offsets[ 1 ]                 = 4;
+	frame_context->repeated_offsets[ 2 ]                 = 8;
+
+	do
+	{
+		if( ( compressed_data_size - safe_compressed_offset ) < 3 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid compressed data size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		block_header = (uint32_t) compressed_data[ safe_compressed_offset ]
+		             | ( (uint32_t) compressed_data[ safe_compressed_offset + 1 ] << 8 )
+		             | ( (uint32_t) compressed_data[ safe_compressed_offset + 2 ] << 16 );
+
+		safe_compressed_offset += 3;
+
+		last_block_flag = (uint8_t) ( block_header & 0x01 );
+		block_type      = (uint8_t) ( ( block_header >> 1 ) & 0x03 );
+		block_size      = (size_t) ( block_header >> 3 );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: block type\t\t\t\t: %" PRIu8 "\n",
+			 function,
+			 block_type );
+
+			libcnotify_printf(
+			 "%s: block size\t\t\t\t: %" PRIzd "\n",
+			 function,
+			 block_size );
+		}
+#endif
+		if( block_size > (size_t) LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid block size value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		switch( block_type )
+		{
+			case LIBQCOW_ZSTD_BLOCK_TYPE_RAW:
+				if( ( block_size > ( compressed_data_size - safe_compressed_offset ) )
+				 || ( block_size > ( uncompressed_data_size - data_offset ) ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid block size value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				if( memory_copy(
+				     &( uncompressed_data[ data_offset ] ),
+				     &( compressed_data[ safe_compressed_offset ] ),
+				     block_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy raw block to uncompressed data.",
+					 function );
+
+					return( -1 );
+				}
+				safe_compressed_offset += block_size;
+				data_offset            += block_size;
+
+				break;
+
+			case LIBQCOW_ZSTD_BLOCK_TYPE_RLE:
+				if( ( safe_compressed_offset >= compressed_data_size )
+				 || ( block_size > ( uncompressed_data_size - data_offset ) ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid block size value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				if( memory_set(
+				     &( uncompressed_data[ data_offset ] ),
+				     compressed_data[ safe_compressed_offset ],
+				     block_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set RLE block in uncompressed data.",
+					 function );
+
+					return( -1 );
+				}
+				safe_compressed_offset += 1;
+				data_offset            += block_size;
+
+				break;
+
+			case LIBQCOW_ZSTD_BLOCK_TYPE_COMPRESSED:
+				if( ( block_size == 0 )
+				 || ( block_size > ( compressed_data_size - safe_compressed_offset ) ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid block size value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				if( libqcow_zstd_read_compressed_block(
+				     frame_context,
+				     &( compressed_data[ safe_compressed_offset ] ),
+				     block_size,
+				     uncompressed_data,
+				     uncompressed_data_size,
+				     frame_start_offset,
+				     &data_offset,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+					 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+					 "%s: unable to read compressed block.",
+					 function );
+
+					return( -1 );
+				}
+				safe_compressed_offset += block_size;
+
+				break;
+
+			default:
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+				 "%s: unsupported block type: %" PRIu8 ".",
+				 function,
+				 block_type );
+
+				return( -1 );
+		}
+	}
+	while( last_block_flag == 0 );
+
+	/* The content checksum is not verified
+	 */
+	if( ( frame_header_descriptor & 0x04 ) != 0 )
+	{
+		if( ( compressed_data_size - safe_compressed_offset ) < 4 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid compressed data size value too small.",
+			 function );
+
+			return( -1 );
+		}
+		safe_compressed_offset += 4;
+	}
+	if( ( frame_content_size_size != 0 )
+	 && ( frame_content_size != (uint64_t) ( data_offset - frame_start_offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: mismatch in frame content size.",
+		 function );
+
+		return( -1 );
+	}
+	*compressed_data_offset   = safe_compressed_offset;
+	*uncompressed_data_offset = data_offset;
+
+	return( 1 );
+}
+
+/* Decompresses data using Zstandard compression
+ * Decompression stops when the uncompressed data is full, since data
+ * can follow the last frame
+ * Returns 1 on success or -1 on error
+ */
+int libqcow_zstd_decompress(
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     uint8_t *uncompressed_data,
+     size_t *uncompressed_data_size,
+     libcerror_error_t **error )
+{
+	libqcow_zstd_frame_context_t *frame_context = NULL;
+	static char *function                       = "libqcow_zstd_decompress";
+	size_t compressed_data_offset               = 0;
+	size_t uncompressed_data_offset             = 0;
+	size_t safe_uncompressed_data_size          = 0;
+	uint32_t frame_size                         = 0;
+	uint32_t signature                          = 0;
+	int number_of_frames                        = 0;
+
+	if( compressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid compressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data.",
+		 function );
+
+		return( -1 );
+	}
+	if( uncompressed_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid uncompressed data size.",
+		 function );
+
+		return( -1 );
+	}
+	safe_uncompressed_data_size = *uncompressed_data_size;
+
+	if( safe_uncompressed_data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid uncompressed data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	frame_context = memory_allocate_structure(
+	                 libqcow_zstd_frame_context_t );
+
+	if( frame_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create frame context.",
+		 function );
+
+		goto on_error;
+	}
+	frame_context->literals_buffer_size = safe_uncompressed_data_size;
+
+	if( frame_context->literals_buffer_size > (size_t) LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE )
+	{
+		frame_context->literals_buffer_size = (size_t) LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE;
+	}
+	else if( frame_context->literals_buffer_size == 0 )
+	{
+		frame_context->literals_buffer_size = 1;
+	}
+	frame_context->literals_buffer = (uint8_t *) memory_allocate(
+	                                              sizeof( uint8_t ) * frame_context->literals_buffer_size );
+
+	if( frame_context->literals_buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create literals buffer.",
+		 function );
+
+		goto on_error;
+	}
+	while( uncompressed_data_offset < safe_uncompressed_data_size )
+	{
+		if( ( compressed_data_size - compressed_data_offset ) < 4 )
+		{
+			if( number_of_frames > 0 )
+			{
+				break;
+			}
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid compressed data size value too small.",
+			 function );
+
+			goto on_error;
+		}
+		byte_stream_copy_to_uint32_little_endian(
+		 &( compressed_data[ compressed_data_offset ] ),
+		 signature );
+
+		if( ( signature & LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE_MASK ) == LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE )
+		{
+			if( ( compressed_data_size - compressed_data_offset ) < 8 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid compressed data size value too small.",
+				 function );
+
+				goto on_error;
+			}
+			byte_stream_copy_to_uint32_little_endian(
+			 &( compressed_data[ compressed_data_offset + 4 ] ),
+			 frame_size );
+
+			compressed_data_offset += 8;
+
+			if( (size_t) frame_size > ( compressed_data_size - compressed_data_offset ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid skippable frame size value out of bounds.",
+				 function );
+
+				goto on_error;
+			}
+			compressed_data_offset += frame_size;
+
+			continue;
+		}
+		if( signature != LIBQCOW_ZSTD_FRAME_SIGNATURE )
+		{
+			if( number_of_frames > 0 )
+			{
+				break;
+			}
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: unsupported frame signature: 0x%08" PRIx32 ".",
+			 function,
+			 signature );
+
+			goto on_error;
+		}
+		if( libqcow_zstd_read_frame(
+		     frame_context,
+		     compressed_data,
+		     compressed_data_size,
+		     &compressed_data_offset,
+		     uncompressed_data,
+		     safe_uncompressed_data_size,
+		     &uncompressed_data_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_COMPRESSION,
+			 LIBCERROR_COMPRESSION_ERROR_DECOMPRESS_FAILED,
+			 "%s: unable to read frame: %d.",
+			 function,
+			 number_of_frames );
+
+			goto on_error;
+		}
+		number_of_frames++;
+	}
+	if( number_of_frames == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing frame.",
+		 function );
+
+		goto on_error;
+	}
+	memory_free(
+	 frame_context->literals_buffer );
+
+	memory_free(
+	 frame_context );
+
+	*uncompressed_data_size = uncompressed_data_offset;
+
+	return( 1 );
+
+on_error:
+	if( frame_context != NULL )
+	{
+		if( frame_context->literals_buffer != NULL )
+		{
+			memory_free(
+			 frame_context->literals_buffer );
+		}
+		memory_free(
+		 frame_context );
+	}
+	return( -1 );
+}
+
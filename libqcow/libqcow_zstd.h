@@ -0,0 +1,315 @@
+/*
+ * Zstandard (zstd) decompression functions
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_ZSTD_H )
+#define _LIBQCOW_ZSTD_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The frame signatures
+ */
+#define LIBQCOW_ZSTD_FRAME_SIGNATURE			0xfd2fb528UL
+#define LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE		0x184d2a50UL
+#define LIBQCOW_ZSTD_SKIPPABLE_FRAME_SIGNATURE_MASK	0xfffffff0UL
+
+/* The maximum size of the data of a block
+ */
+#define LIBQCOW_ZSTD_MAXIMUM_BLOCK_SIZE			131072
+
+/* The block types
+ */
+enum LIBQCOW_ZSTD_BLOCK_TYPES
+{
+	LIBQCOW_ZSTD_BLOCK_TYPE_RAW			= 0x00,
+	LIBQCOW_ZSTD_BLOCK_TYPE_RLE			= 0x01,
+	LIBQCOW_ZSTD_BLOCK_TYPE_COMPRESSED		= 0x02,
+	LIBQCOW_ZSTD_BLOCK_TYPE_RESERVED		= 0x03
+};
+
+/* The literals block types
+ */
+enum LIBQCOW_ZSTD_LITERALS_BLOCK_TYPES
+{
+	LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_RAW		= 0x00,
+	LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_RLE		= 0x01,
+	LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_COMPRESSED	= 0x02,
+	LIBQCOW_ZSTD_LITERALS_BLOCK_TYPE_TREELESS	= 0x03
+};
+
+/* The sequences section symbol compression modes
+ */
+enum LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODES
+{
+	LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_PREDEFINED	= 0x00,
+	LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_RLE	= 0x01,
+	LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_FSE	= 0x02,
+	LIBQCOW_ZSTD_SYMBOL_COMPRESSION_MODE_REPEAT	= 0x03
+};
+
+/* The maximum number of bits of a Huffman code
+ */
+#define LIBQCOW_ZSTD_HUFFMAN_MAXIMUM_NUMBER_OF_BITS	11
+
+/* The minimum and maximum FSE table accuracy log
+ */
+#define LIBQCOW_ZSTD_FSE_MINIMUM_ACCURACY_LOG		5
+#define LIBQCOW_ZSTD_FSE_MAXIMUM_ACCURACY_LOG		9
+
+/* A Huffman lookup table entry contains:
+ * bits 0 - 7:  the symbol
+ * bits 8 - 15: the code size
+ */
+#define LIBQCOW_ZSTD_HUFFMAN_LOOKUP_ENTRY_SYMBOL( entry ) \
+	( (uint8_t) ( ( entry ) & 0x00ff ) )
+
+#define LIBQCOW_ZSTD_HUFFMAN_LOOKUP_ENTRY_NUMBER_OF_BITS( entry ) \
+	( (uint8_t) ( ( entry ) >> 8 ) )
+
+typedef struct libqcow_zstd_bit_stream libqcow_zstd_bit_stream_t;
+
+/* The bit stream is read backwards, from the last to the first byte
+ */
+struct libqcow_zstd_bit_stream
+{
+	/* The byte stream
+	 */
+	const uint8_t *byte_stream;
+
+	/* The byte stream size
+	 */
+	size_t byte_stream_size;
+
+	/* The bit offset of the bit after the next bit to read
+	 * Reading beyond the start of the byte stream results in a negative offset
+	 */
+	int64_t bit_offset;
+};
+
+typedef struct libqcow_zstd_fse_table_entry libqcow_zstd_fse_table_entry_t;
+
+struct libqcow_zstd_fse_table_entry
+{
+	/* The base value of the next state
+	 */
+	uint16_t base_value;
+
+	/* The symbol
+	 */
+	uint8_t symbol;
+
+	/* The number of bits to read for the next state
+	 */
+	uint8_t number_of_bits;
+};
+
+typedef struct libqcow_zstd_fse_table libqcow_zstd_fse_table_t;
+
+struct libqcow_zstd_fse_table
+{
+	/* The accuracy log
+	 */
+	uint8_t accuracy_log;
+
+	/* The entries
+	 */
+	libqcow_zstd_fse_table_entry_t entries[ 1 << LIBQCOW_ZSTD_FSE_MAXIMUM_ACCURACY_LOG ];
+};
+
+typedef struct libqcow_zstd_huffman_table libqcow_zstd_huffman_table_t;
+
+struct libqcow_zstd_huffman_table
+{
+	/* The maximum number of bits, which is 0 if the table is not set
+	 */
+	uint8_t maximum_number_of_bits;
+
+	/* The lookup table
+	 */
+	uint16_t lookup_table[ 1 << LIBQCOW_ZSTD_HUFFMAN_MAXIMUM_NUMBER_OF_BITS ];
+};
+
+typedef struct libqcow_zstd_frame_context libqcow_zstd_frame_context_t;
+
+/* The state that is kept between the blocks of a frame
+ */
+struct libqcow_zstd_frame_context
+{
+	/* The Huffman table of the literals
+	 */
+	libqcow_zstd_huffman_table_t literals_table;
+
+	/* The literals length FSE table
+	 */
+	libqcow_zstd_fse_table_t literals_length_table;
+
+	/* The offset FSE table
+	 */
+	libqcow_zstd_fse_table_t offset_table;
+
+	/* The match length FSE table
+	 */
+	libqcow_zstd_fse_table_t match_length_table;
+
+	/* Value to indicate the sequences FSE tables are set
+	 */
+	uint8_t sequences_tables_set;
+
+	/* The repeated offsets
+	 */
+	uint32_t repeated_offsets[ 3 ];
+
+	/* The literals buffer
+	 */
+	uint8_t *literals_buffer;
+
+	/* The literals buffer size
+	 */
+	size_t literals_buffer_size;
+};
+
+int libqcow_zstd_bit_stream_initialize(
+     libqcow_zstd_bit_stream_t *bit_stream,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     libcerror_error_t **error );
+
+uint32_t libqcow_zstd_bit_stream_peek_value(
+          libqcow_zstd_bit_stream_t *bit_stream,
+          uint8_t number_of_bits );
+
+int libqcow_zstd_bit_stream_get_value(
+     libqcow_zstd_bit_stream_t *bit_stream,
+     uint8_t number_of_bits,
+     uint32_t *value_32bit,
+     libcerror_error_t **error );
+
+int libqcow_zstd_fse_table_build(
+     libqcow_zstd_fse_table_t *table,
+     const int16_t *normalized_counts,
+     int number_of_symbols,
+     uint8_t accuracy_log,
+     libcerror_error_t **error );
+
+int libqcow_zstd_fse_table_read(
+     libqcow_zstd_fse_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     uint8_t maximum_accuracy_log,
+     int maximum_symbol,
+     size_t *read_size,
+     libcerror_error_t **error );
+
+int libqcow_zstd_huffman_table_build(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *weights,
+     int number_of_weights,
+     libcerror_error_t **error );
+
+int libqcow_zstd_huffman_table_read(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     size_t *read_size,
+     libcerror_error_t **error );
+
+int libqcow_zstd_decode_huffman_stream(
+     libqcow_zstd_huffman_table_t *table,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     libcerror_error_t **error );
+
+int libqcow_zstd_read_literals_section(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     const uint8_t **literals,
+     size_t *number_of_literals,
+     size_t *read_size,
+     libcerror_error_t **error );
+
+int libqcow_zstd_read_sequences_table(
+     libqcow_zstd_fse_table_t *table,
+     uint8_t compression_mode,
+     const int16_t *predefined_normalized_counts,
+     int number_of_predefined_normalized_counts,
+     uint8_t predefined_accuracy_log,
+     uint8_t maximum_accuracy_log,
+     int maximum_symbol,
+     uint8_t table_is_set,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     size_t *read_size,
+     libcerror_error_t **error );
+
+int libqcow_zstd_decode_sequences(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *byte_stream,
+     size_t byte_stream_size,
+     const uint8_t *literals,
+     size_t number_of_literals,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t frame_start_offset,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error );
+
+int libqcow_zstd_read_compressed_block(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t frame_start_offset,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error );
+
+int libqcow_zstd_read_frame(
+     libqcow_zstd_frame_context_t *frame_context,
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     size_t *compressed_data_offset,
+     uint8_t *uncompressed_data,
+     size_t uncompressed_data_size,
+     size_t *uncompressed_data_offset,
+     libcerror_error_t **error );
+
+int libqcow_zstd_decompress(
+     const uint8_t *compressed_data,
+     size_t compressed_data_size,
+     uint8_t *uncompressed_data,
+     size_t *uncompressed_data_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_ZSTD_H ) */
+
@@ -0,0 +1,89 @@
+/*
+ * The bitmap directory definition of a QEMU Copy-On-Write (QCOW) image file
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _QCOW_BITMAP_DIRECTORY_H )
+#define _QCOW_BITMAP_DIRECTORY_H
+
+#include <common.h>
+#include <types.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct qcow_bitmap_directory_entry qcow_bitmap_directory_entry_t;
+
+struct qcow_bitmap_directory_entry
+{
+	/* The bitmap table offset
+	 * Consists of 8 bytes
+	 */
+	uint8_t bitmap_table_offset[ 8 ];
+
+	/* The bitmap table size, which is the number of entries
+	 * Consists of 4 bytes
+	 */
+	uint8_t bitmap_table_size[ 4 ];
+
+	/* The flags
+	 * Consists of 4 bytes
+	 */
+	uint8_t flags[ 4 ];
+
+	/* The type
+	 * Consists of 1 byte
+	 */
+	uint8_t type;
+
+	/* The granularity bits
+	 * Consists of 1 byte
+	 */
+	uint8_t granularity_bits;
+
+	/* The name size
+	 * Consists of 2 bytes
+	 */
+	uint8_t name_size[ 2 ];
+
+	/* The extra data size
+	 * Consists of 4 bytes
+	 */
+	uint8_t extra_data_size[ 4 ];
+
+	/* The extra data
+	 * Consists of the number of bytes of the extra data size
+	 */
+
+	/* The name
+	 * Consists of the number of bytes of the name size
+	 */
+
+	/* The alignment padding
+	 * Consists of 0 to 7 bytes
+	 */
+};
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _QCOW_BITMAP_DIRECTORY_H ) */
+
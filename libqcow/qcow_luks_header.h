@@ -0,0 +1,134 @@
+/*
+ * The LUKS header definition of a QCOW file
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _QCOW_LUKS_HEADER_H )
+#define _QCOW_LUKS_HEADER_H
+
+#include <common.h>
+#include <types.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct qcow_luks_key_slot qcow_luks_key_slot_t;
+
+struct qcow_luks_key_slot
+{
+	/* The state
+	 * Consists of 4 bytes
+	 */
+	uint8_t state[ 4 ];
+
+	/* The number of password (PBKDF2) iterations
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_iterations[ 4 ];
+
+	/* The password salt
+	 * Consists of 32 bytes
+	 */
+	uint8_t salt[ 32 ];
+
+	/* The key material sector number
+	 * Consists of 4 bytes
+	 * The sector number is relative to the start of the LUKS header
+	 */
+	uint8_t key_material_sector_number[ 4 ];
+
+	/* The number of anti-forensic stripes
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_stripes[ 4 ];
+};
+
+typedef struct qcow_luks_header qcow_luks_header_t;
+
+struct qcow_luks_header
+{
+	/* The signature
+	 * Consists of 6 bytes
+	 * Consists of: "LUKS\xba\xbe"
+	 */
+	uint8_t signature[ 6 ];
+
+	/* The format version
+	 * Consists of 2 bytes
+	 */
+	uint8_t format_version[ 2 ];
+
+	/* The encryption method (cipher name)
+	 * Consists of 32 bytes
+	 */
+	uint8_t encryption_method[ 32 ];
+
+	/* The encryption chaining mode (cipher mode)
+	 * Consists of 32 bytes
+	 */
+	uint8_t encryption_chaining_mode[ 32 ];
+
+	/* The hashing method (hash specification)
+	 * Consists of 32 bytes
+	 */
+	uint8_t hashing_method[ 32 ];
+
+	/* The encrypted volume start sector
+	 * Consists of 4 bytes
+	 */
+	uint8_t encrypted_volume_start_sector[ 4 ];
+
+	/* The master key size
+	 * Consists of 4 bytes
+	 */
+	uint8_t master_key_size[ 4 ];
+
+	/* The master key validation hash
+	 * Consists of 20 bytes
+	 */
+	uint8_t master_key_validation_hash[ 20 ];
+
+	/* The master key salt
+	 * Consists of 32 bytes
+	 */
+	uint8_t master_key_salt[ 32 ];
+
+	/* The number of master key (PBKDF2) iterations
+	 * Consists of 4 bytes
+	 */
+	uint8_t master_key_number_of_iterations[ 4 ];
+
+	/* The volume identifier (UUID)
+	 * Consists of 40 bytes
+	 */
+	uint8_t volume_identifier[ 40 ];
+
+	/* The key slots
+	 * Consists of 8 x 48 bytes
+	 */
+	qcow_luks_key_slot_t key_slots[ 8 ];
+};
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _QCOW_LUKS_HEADER_H ) */
+
@@ -0,0 +1,118 @@
+/*
+ * The snapshot table definition of a QEMU Copy-On-Write (QCOW) image file
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _QCOW_SNAPSHOT_TABLE_H )
+#define _QCOW_SNAPSHOT_TABLE_H
+
+#include <common.h>
+#include <types.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct qcow_snapshot_table_entry qcow_snapshot_table_entry_t;
+
+struct qcow_snapshot_table_entry
+{
+	/* The level 1 table offset
+	 * Consists of 8 bytes
+	 */
+	uint8_t level1_table_offset[ 8 ];
+
+	/* The number of level 1 table references
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_level1_table_references[ 4 ];
+
+	/* The identifier size
+	 * Consists of 2 bytes
+	 */
+	uint8_t identifier_size[ 2 ];
+
+	/* The name size
+	 * Consists of 2 bytes
+	 */
+	uint8_t name_size[ 2 ];
+
+	/* The creation date and time in seconds
+	 * Consists of 4 bytes
+	 */
+	uint8_t creation_time_seconds[ 4 ];
+
+	/* The creation date and time in nanoseconds
+	 * Consists of 4 bytes
+	 */
+	uint8_t creation_time_nanoseconds[ 4 ];
+
+	/* The virtual machine clock in nanoseconds
+	 * Consists of 8 bytes
+	 */
+	uint8_t virtual_machine_clock[ 8 ];
+
+	/* The virtual machine state size
+	 * Consists of 4 bytes
+	 */
+	uint8_t virtual_machine_state_size[ 4 ];
+
+	/* The extra data size
+	 * Consists of 4 bytes
+	 */
+	uint8_t extra_data_size[ 4 ];
+
+	/* The extra data
+	 * Consists of the number of bytes of the extra data size
+	 */
+
+	/* The identifier
+	 * Consists of the number of bytes of the identifier size
+	 */
+
+	/* The name
+	 * Consists of the number of bytes of the name size
+	 */
+
+	/* The alignment padding
+	 * Consists of 0 to 7 bytes
+	 */
+};
+
+typedef struct qcow_snapshot_table_entry_extra_data qcow_snapshot_table_entry_extra_data_t;
+
+struct qcow_snapshot_table_entry_extra_data
+{
+	/* The virtual machine state size
+	 * Consists of 8 bytes
+	 */
+	uint8_t virtual_machine_state_size[ 8 ];
+
+	/* The media size
+	 * Consists of 8 bytes
+	 */
+	uint8_t media_size[ 8 ];
+};
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _QCOW_SNAPSHOT_TABLE_H ) */
+
@@ -32,6 +32,7 @@
 #include "pyqcow_error.h"
 #include "pyqcow_file.h"
 #include "pyqcow_file_object_io_handle.h"
+#include "pyqcow_integer.h"
 #include "pyqcow_libbfio.h"
 #include "pyqcow_libcerror.h"
 #include "pyqcow_libqcow.h"
@@ -57,6 +58,20 @@ PyMethodDef pyqcow_module_methods[] = {
 	  "\n"
 	  "Retrieves the version." },
 
+	{ "get_cache_budget",
+	  (PyCFunction) pyqcow_get_cache_budget,
+	  METH_NOARGS,
+	  "get_cache_budget() -> Integer\n"
+	  "\n"
+	  "Retrieves the maximum size in bytes of the caches of all open files, where 0 represents no maximum." },
+
+	{ "set_cache_budget",
+	  (PyCFunction) pyqcow_set_cache_budget,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "set_cache_budget(cache_budget) -> None\n"
+	  "\n"
+	  "Sets the maximum size in bytes of the caches of all open files, where 0 represents no maximum." },
+
 	{ "check_file_signature",
 	  (PyCFunction) pyqcow_check_file_signature,
 	  METH_VARARGS | METH_KEYWORDS,
@@ -122,6 +137,118 @@ PyObject *pyqcow_get_version(
 	         errors ) );
 }
 
+/* Retrieves the process wide cache budget
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_get_cache_budget(
+           PyObject *self PYQCOW_ATTRIBUTE_UNUSED,
+           PyObject *arguments PYQCOW_ATTRIBUTE_UNUSED )
+{
+	libcerror_error_t *error = NULL;
+	PyObject *integer_object = NULL;
+	static char *function    = "pyqcow_get_cache_budget";
+	size64_t cache_budget    = 0;
+	int result               = 0;
+
+	PYQCOW_UNREFERENCED_PARAMETER( self )
+	PYQCOW_UNREFERENCED_PARAMETER( arguments )
+
+	Py_BEGIN_ALLOW_THREADS
+
+	result = libqcow_get_cache_budget(
+	          &cache_budget,
+	          &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( result != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to retrieve cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	integer_object = pyqcow_integer_unsigned_new_from_64bit(
+	                  (uint64_t) cache_budget );
+
+	return( integer_object );
+}
+
+/* Sets the process wide cache budget
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_set_cache_budget(
+           PyObject *self PYQCOW_ATTRIBUTE_UNUSED,
+           PyObject *arguments,
+           PyObject *keywords )
+{
+	PyObject *integer_object    = NULL;
+	libcerror_error_t *error    = NULL;
+	static char *function       = "pyqcow_set_cache_budget";
+	static char *keyword_list[] = { "cache_budget", NULL };
+	uint64_t cache_budget       = 0;
+	int result                  = 0;
+
+	PYQCOW_UNREFERENCED_PARAMETER( self )
+
+	if( PyArg_ParseTupleAndKeywords(
+	     arguments,
+	     keywords,
+	     "O",
+	     keyword_list,
+	     &integer_object ) == 0 )
+	{
+		return( NULL );
+	}
+	if( pyqcow_integer_unsigned_copy_to_64bit(
+	     integer_object,
+	     &cache_budget,
+	     &error ) != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_ValueError,
+		 "%s: unable to convert integer object into cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	Py_BEGIN_ALLOW_THREADS
+
+	result = libqcow_set_cache_budget(
+	          (size64_t) cache_budget,
+	          &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( result != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to set cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	Py_IncRef(
+	 Py_None );
+
+	return( Py_None );
+}
+
 /* Checks if a file has a QEMU Copy-On-Write (QCOW) image file signature
  * Returns a Python object if successful or NULL on error
  */
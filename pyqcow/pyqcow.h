@@ -35,6 +35,15 @@ PyObject *pyqcow_get_version(
            PyObject *self,
            PyObject *arguments );
 
+PyObject *pyqcow_get_cache_budget(
+           PyObject *self,
+           PyObject *arguments );
+
+PyObject *pyqcow_set_cache_budget(
+           PyObject *self,
+           PyObject *arguments,
+           PyObject *keywords );
+
 PyObject *pyqcow_check_file_signature(
            PyObject *self,
            PyObject *arguments,
@@ -155,6 +155,28 @@ PyMethodDef pyqcow_file_object_methods[] = {
 	  "\n"
 	  "Sets the password." },
 
+	{ "get_cache_budget",
+	  (PyCFunction) pyqcow_file_get_cache_budget,
+	  METH_NOARGS,
+	  "get_cache_budget() -> Integer\n"
+	  "\n"
+	  "Retrieves the maximum size in bytes of the caches, where 0 represents the default." },
+
+	{ "set_cache_budget",
+	  (PyCFunction) pyqcow_file_set_cache_budget,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "set_cache_budget(cache_budget) -> None\n"
+	  "\n"
+	  "Sets the maximum size in bytes of the caches of the file and its parent files." },
+
+	{ "get_cache_statistics",
+	  (PyCFunction) pyqcow_file_get_cache_statistics,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "get_cache_statistics(cache_type) -> Tuple\n"
+	  "\n"
+	  "Retrieves the number of hits, misses and evictions of a specific cache.\n"
+	  "The cache type is 1 for level 2 tables, 2 for cluster blocks and 3 for compressed cluster blocks." },
+
 	{ "get_media_size",
 	  (PyCFunction) pyqcow_file_get_media_size,
 	  METH_NOARGS,
@@ -175,6 +197,12 @@ PyMethodDef pyqcow_file_object_methods[] = {
 
 PyGetSetDef pyqcow_file_object_get_set_definitions[] = {
 
+	{ "cache_budget",
+	  (getter) pyqcow_file_get_cache_budget,
+	  (setter) 0,
+	  "The cache budget.",
+	  NULL },
+
 	{ "media_size",
 	  (getter) pyqcow_file_get_media_size,
 	  (setter) 0,
@@ -1610,6 +1638,250 @@ PyObject *pyqcow_file_set_password(
 	return( Py_None );
 }
 
+/* Retrieves the cache budget
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_file_get_cache_budget(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments PYQCOW_ATTRIBUTE_UNUSED )
+{
+	libcerror_error_t *error = NULL;
+	PyObject *integer_object = NULL;
+	static char *function    = "pyqcow_file_get_cache_budget";
+	size64_t cache_budget    = 0;
+	int result               = 0;
+
+	PYQCOW_UNREFERENCED_PARAMETER( arguments )
+
+	if( pyqcow_file == NULL )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid file.",
+		 function );
+
+		return( NULL );
+	}
+	Py_BEGIN_ALLOW_THREADS
+
+	result = libqcow_file_get_cache_budget(
+	          pyqcow_file->file,
+	          &cache_budget,
+	          &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( result != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to retrieve cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	integer_object = pyqcow_integer_unsigned_new_from_64bit(
+	                  (uint64_t) cache_budget );
+
+	return( integer_object );
+}
+
+/* Sets the cache budget
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_file_set_cache_budget(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords )
+{
+	PyObject *integer_object    = NULL;
+	libcerror_error_t *error    = NULL;
+	static char *function       = "pyqcow_file_set_cache_budget";
+	static char *keyword_list[] = { "cache_budget", NULL };
+	uint64_t cache_budget       = 0;
+	int result                  = 0;
+
+	if( pyqcow_file == NULL )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid file.",
+		 function );
+
+		return( NULL );
+	}
+	if( PyArg_ParseTupleAndKeywords(
+	     arguments,
+	     keywords,
+	     "O",
+	     keyword_list,
+	     &integer_object ) == 0 )
+	{
+		return( NULL );
+	}
+	if( pyqcow_integer_unsigned_copy_to_64bit(
+	     integer_object,
+	     &cache_budget,
+	     &error ) != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_ValueError,
+		 "%s: unable to convert integer object into cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	Py_BEGIN_ALLOW_THREADS
+
+	result = libqcow_file_set_cache_budget(
+	          pyqcow_file->file,
+	          (size64_t) cache_budget,
+	          &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( result != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to set cache budget.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	Py_IncRef(
+	 Py_None );
+
+	return( Py_None );
+}
+
+/* Retrieves the hit, miss and eviction statistics of a specific cache
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_file_get_cache_statistics(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords )
+{
+	PyObject *integer_object     = NULL;
+	PyObject *tuple_object       = NULL;
+	libcerror_error_t *error     = NULL;
+	static char *function        = "pyqcow_file_get_cache_statistics";
+	static char *keyword_list[]  = { "cache_type", NULL };
+	uint64_t number_of_evictions = 0;
+	uint64_t number_of_hits      = 0;
+	uint64_t number_of_misses    = 0;
+	int cache_type               = 0;
+	int result                   = 0;
+
+	if( pyqcow_file == NULL )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid file.",
+		 function );
+
+		return( NULL );
+	}
+	if( PyArg_ParseTupleAndKeywords(
+	     arguments,
+	     keywords,
+	     "i",
+	     keyword_list,
+	     &cache_type ) == 0 )
+	{
+		return( NULL );
+	}
+	Py_BEGIN_ALLOW_THREADS
+
+	result = libqcow_file_get_cache_statistics(
+	          pyqcow_file->file,
+	          cache_type,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( result != 1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to retrieve cache statistics.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		return( NULL );
+	}
+	tuple_object = PyTuple_New(
+	                3 );
+
+	if( tuple_object == NULL )
+	{
+		PyErr_Format(
+		 PyExc_MemoryError,
+		 "%s: unable to create tuple object.",
+		 function );
+
+		return( NULL );
+	}
+	integer_object = pyqcow_integer_unsigned_new_from_64bit(
+	                  number_of_hits );
+
+	/* Note that PyTuple_SetItem steals the reference to integer_object
+	 */
+	if( PyTuple_SetItem(
+	     tuple_object,
+	     0,
+	     integer_object ) != 0 )
+	{
+		goto on_error;
+	}
+	integer_object = pyqcow_integer_unsigned_new_from_64bit(
+	                  number_of_misses );
+
+	if( PyTuple_SetItem(
+	     tuple_object,
+	     1,
+	     integer_object ) != 0 )
+	{
+		goto on_error;
+	}
+	integer_object = pyqcow_integer_unsigned_new_from_64bit(
+	                  number_of_evictions );
+
+	if( PyTuple_SetItem(
+	     tuple_object,
+	     2,
+	     integer_object ) != 0 )
+	{
+		goto on_error;
+	}
+	return( tuple_object );
+
+on_error:
+	Py_DecRef(
+	 tuple_object );
+
+	return( NULL );
+}
+
 /* Retrieves the media size
  * Returns a Python object if successful or NULL on error
  */
@@ -110,6 +110,20 @@ PyObject *pyqcow_file_set_password(
            PyObject *arguments,
            PyObject *keywords );
 
+PyObject *pyqcow_file_get_cache_budget(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments );
+
+PyObject *pyqcow_file_set_cache_budget(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords );
+
+PyObject *pyqcow_file_get_cache_statistics(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords );
+
 PyObject *pyqcow_file_get_media_size(
            pyqcow_file_t *pyqcow_file,
            PyObject *arguments );
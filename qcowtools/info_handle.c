@@ -305,6 +305,488 @@ int info_handle_close(
 	return( 0 );
 }
 
+/* Prints the snapshot information to a stream
+ * Returns 1 if successful or -1 on error
+ */
+int info_handle_snapshot_fprint(
+     info_handle_t *info_handle,
+     int snapshot_index,
+     libqcow_snapshot_t *snapshot,
+     libcerror_error_t **error )
+{
+	system_character_t byte_size_string[ 16 ];
+
+	system_character_t *value_string = NULL;
+	static char *function            = "info_handle_snapshot_fprint";
+	size64_t size                    = 0;
+	size_t value_string_size         = 0;
+	int result                       = 0;
+
+	if( info_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid info handle.",
+		 function );
+
+		return( -1 );
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "Snapshot: %d\n",
+	 snapshot_index + 1 );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_snapshot_get_utf16_identifier_size(
+		  snapshot,
+		  &value_string_size,
+		  error );
+#else
+	result = libqcow_snapshot_get_utf8_identifier_size(
+		  snapshot,
+		  &value_string_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve identifier string size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( value_string_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid identifier size value exceeds maximum.",
+			 function );
+
+			goto on_error;
+		}
+		value_string = system_string_allocate(
+				value_string_size );
+
+		if( value_string == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create identifier string.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_snapshot_get_utf16_identifier(
+			  snapshot,
+			  (uint16_t *) value_string,
+			  value_string_size,
+			  error );
+#else
+		result = libqcow_snapshot_get_utf8_identifier(
+			  snapshot,
+			  (uint8_t *) value_string,
+			  value_string_size,
+			  error );
+#endif
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve identifier.",
+			 function );
+
+			goto on_error;
+		}
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tIdentifier\t\t: %" PRIs_SYSTEM "\n",
+		 value_string );
+
+		memory_free(
+		 value_string );
+
+		value_string = NULL;
+	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_snapshot_get_utf16_name_size(
+		  snapshot,
+		  &value_string_size,
+		  error );
+#else
+	result = libqcow_snapshot_get_utf8_name_size(
+		  snapshot,
+		  &value_string_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve name string size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( value_string_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid name size value exceeds maximum.",
+			 function );
+
+			goto on_error;
+		}
+		value_string = system_string_allocate(
+				value_string_size );
+
+		if( value_string == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create name string.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_snapshot_get_utf16_name(
+			  snapshot,
+			  (uint16_t *) value_string,
+			  value_string_size,
+			  error );
+#else
+		result = libqcow_snapshot_get_utf8_name(
+			  snapshot,
+			  (uint8_t *) value_string,
+			  value_string_size,
+			  error );
+#endif
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve name.",
+			 function );
+
+			goto on_error;
+		}
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tName\t\t\t: %" PRIs_SYSTEM "\n",
+		 value_string );
+
+		memory_free(
+		 value_string );
+
+		value_string = NULL;
+	}
+	if( libqcow_snapshot_get_media_size(
+	     snapshot,
+	     &size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve media size.",
+		 function );
+
+		goto on_error;
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\tMedia size\t\t:" );
+
+	result = byte_size_string_create(
+	          byte_size_string,
+	          16,
+	          size,
+	          BYTE_SIZE_STRING_UNIT_MEBIBYTE,
+	          NULL );
+
+	if( result == 1 )
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 " %" PRIs_SYSTEM " (%" PRIu64 " bytes)",
+		 byte_size_string,
+		 size );
+	}
+	else
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 " %" PRIu64 " bytes",
+		 size );
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\n" );
+
+	if( libqcow_snapshot_get_virtual_machine_state_size(
+	     snapshot,
+	     &size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve virtual machine state size.",
+		 function );
+
+		goto on_error;
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\tVM state size\t\t:" );
+
+	result = byte_size_string_create(
+	          byte_size_string,
+	          16,
+	          size,
+	          BYTE_SIZE_STRING_UNIT_MEBIBYTE,
+	          NULL );
+
+	if( result == 1 )
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 " %" PRIs_SYSTEM " (%" PRIu64 " bytes)",
+		 byte_size_string,
+		 size );
+	}
+	else
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 " %" PRIu64 " bytes",
+		 size );
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\n" );
+
+	fprintf(
+	 info_handle->notify_stream,
+	 "\n" );
+
+	return( 1 );
+
+on_error:
+	if( value_string != NULL )
+	{
+		memory_free(
+		 value_string );
+	}
+	return( -1 );
+}
+
+/* Prints the bitmap information to a stream
+ * Returns 1 if successful or -1 on error
+ */
+int info_handle_bitmap_fprint(
+     info_handle_t *info_handle,
+     int bitmap_index,
+     libqcow_bitmap_t *bitmap,
+     libcerror_error_t **error )
+{
+	system_character_t *value_string = NULL;
+	static char *function            = "info_handle_bitmap_fprint";
+	size64_t granularity             = 0;
+	size_t value_string_size         = 0;
+	uint32_t flags                   = 0;
+	int result                       = 0;
+
+	if( info_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid info handle.",
+		 function );
+
+		return( -1 );
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "Bitmap: %d\n",
+	 bitmap_index + 1 );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_bitmap_get_utf16_name_size(
+		  bitmap,
+		  &value_string_size,
+		  error );
+#else
+	result = libqcow_bitmap_get_utf8_name_size(
+		  bitmap,
+		  &value_string_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve name string size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( value_string_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid name size value exceeds maximum.",
+			 function );
+
+			goto on_error;
+		}
+		value_string = system_string_allocate(
+				value_string_size );
+
+		if( value_string == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create name string.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_bitmap_get_utf16_name(
+			  bitmap,
+			  (uint16_t *) value_string,
+			  value_string_size,
+			  error );
+#else
+		result = libqcow_bitmap_get_utf8_name(
+			  bitmap,
+			  (uint8_t *) value_string,
+			  value_string_size,
+			  error );
+#endif
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve name.",
+			 function );
+
+			goto on_error;
+		}
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tName\t\t\t: %" PRIs_SYSTEM "\n",
+		 value_string );
+
+		memory_free(
+		 value_string );
+
+		value_string = NULL;
+	}
+	if( libqcow_bitmap_get_granularity(
+	     bitmap,
+	     &granularity,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve granularity.",
+		 function );
+
+		goto on_error;
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\tGranularity\t\t: %" PRIu64 " bytes\n",
+	 granularity );
+
+	if( libqcow_bitmap_get_flags(
+	     bitmap,
+	     &flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve flags.",
+		 function );
+
+		goto on_error;
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\tFlags\t\t\t: 0x%08" PRIx32 "\n",
+	 flags );
+
+	if( ( flags & LIBQCOW_BITMAP_FLAG_IN_USE ) != 0 )
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 "\t\t(In use)\n" );
+	}
+	if( ( flags & LIBQCOW_BITMAP_FLAG_AUTO ) != 0 )
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 "\t\t(Auto)\n" );
+	}
+	fprintf(
+	 info_handle->notify_stream,
+	 "\n" );
+
+	return( 1 );
+
+on_error:
+	if( value_string != NULL )
+	{
+		memory_free(
+		 value_string );
+	}
+	return( -1 );
+}
+
 /* Prints the file information to a stream
  * Returns 1 if successful or -1 on error
  */
@@ -314,14 +796,19 @@ int info_handle_file_fprint(
 {
 	system_character_t byte_size_string[ 16 ];
 
+	libqcow_bitmap_t *bitmap         = NULL;
+	libqcow_snapshot_t *snapshot     = NULL;
 	system_character_t *value_string = NULL;
 	static char *function            = "qcowinfo_file_info_fprint";
 	size64_t media_size              = 0;
 	size_t value_string_size         = 0;
 	uint32_t encryption_method       = 0;
 	uint32_t format_version          = 0;
+	int bitmap_index                 = 0;
+	int number_of_bitmaps            = 0;
 	int number_of_snapshots          = 0;
 	int result                       = 0;
+	int snapshot_index               = 0;
 
 	if( info_handle == NULL )
 	{
@@ -537,6 +1024,172 @@ int info_handle_file_fprint(
 
 		value_string = NULL;
 	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_get_utf16_backing_format_size(
+		  info_handle->input_file,
+		  &value_string_size,
+		  error );
+#else
+	result = libqcow_file_get_utf8_backing_format_size(
+		  info_handle->input_file,
+		  &value_string_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve backing format string size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( value_string_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid backing format size value exceeds maximum.",
+			 function );
+
+			goto on_error;
+		}
+		value_string = system_string_allocate(
+				value_string_size );
+
+		if( value_string == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create backing format string.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_get_utf16_backing_format(
+			  info_handle->input_file,
+			  (uint16_t *) value_string,
+			  value_string_size,
+			  error );
+#else
+		result = libqcow_file_get_utf8_backing_format(
+			  info_handle->input_file,
+			  (uint8_t *) value_string,
+			  value_string_size,
+			  error );
+#endif
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve backing format.",
+			 function );
+
+			goto on_error;
+		}
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tBacking format\t\t: %s\n",
+		 value_string );
+
+		memory_free(
+		 value_string );
+
+		value_string = NULL;
+	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_get_utf16_data_filename_size(
+		  info_handle->input_file,
+		  &value_string_size,
+		  error );
+#else
+	result = libqcow_file_get_utf8_data_filename_size(
+		  info_handle->input_file,
+		  &value_string_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve external data filename string size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( value_string_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid external data filename size value exceeds maximum.",
+			 function );
+
+			goto on_error;
+		}
+		value_string = system_string_allocate(
+				value_string_size );
+
+		if( value_string == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create external data filename string.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_get_utf16_data_filename(
+			  info_handle->input_file,
+			  (uint16_t *) value_string,
+			  value_string_size,
+			  error );
+#else
+		result = libqcow_file_get_utf8_data_filename(
+			  info_handle->input_file,
+			  (uint8_t *) value_string,
+			  value_string_size,
+			  error );
+#endif
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve external data filename.",
+			 function );
+
+			goto on_error;
+		}
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tExternal data filename\t: %s\n",
+		 value_string );
+
+		memory_free(
+		 value_string );
+
+		value_string = NULL;
+	}
 	if( libqcow_file_get_number_of_snapshots(
 	     info_handle->input_file,
 	     &number_of_snapshots,
@@ -562,7 +1215,134 @@ int info_handle_file_fprint(
 		 info_handle->notify_stream,
 		 "\n" );
 
-/* TODO print snapshot information */
+		for( snapshot_index = 0;
+		     snapshot_index < number_of_snapshots;
+		     snapshot_index++ )
+		{
+			if( libqcow_file_get_snapshot_by_index(
+			     info_handle->input_file,
+			     snapshot_index,
+			     &snapshot,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve snapshot: %d.",
+				 function,
+				 snapshot_index );
+
+				goto on_error;
+			}
+			if( info_handle_snapshot_fprint(
+			     info_handle,
+			     snapshot_index,
+			     snapshot,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_PRINT_FAILED,
+				 "%s: unable to print snapshot: %d information.",
+				 function,
+				 snapshot_index );
+
+				goto on_error;
+			}
+			if( libqcow_snapshot_free(
+			     &snapshot,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free snapshot: %d.",
+				 function,
+				 snapshot_index );
+
+				goto on_error;
+			}
+		}
+	}
+	if( libqcow_file_get_number_of_bitmaps(
+	     info_handle->input_file,
+	     &number_of_bitmaps,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve number of bitmaps.",
+		 function );
+
+		goto on_error;
+	}
+	if( number_of_bitmaps > 0 )
+	{
+		fprintf(
+		 info_handle->notify_stream,
+		 "\tNumber of bitmaps\t: %d\n",
+		 number_of_bitmaps );
+
+		fprintf(
+		 info_handle->notify_stream,
+		 "\n" );
+
+		for( bitmap_index = 0;
+		     bitmap_index < number_of_bitmaps;
+		     bitmap_index++ )
+		{
+			if( libqcow_file_get_bitmap_by_index(
+			     info_handle->input_file,
+			     bitmap_index,
+			     &bitmap,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve bitmap: %d.",
+				 function,
+				 bitmap_index );
+
+				goto on_error;
+			}
+			if( info_handle_bitmap_fprint(
+			     info_handle,
+			     bitmap_index,
+			     bitmap,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_PRINT_FAILED,
+				 "%s: unable to print bitmap: %d information.",
+				 function,
+				 bitmap_index );
+
+				goto on_error;
+			}
+			if( libqcow_bitmap_free(
+			     &bitmap,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free bitmap: %d.",
+				 function,
+				 bitmap_index );
+
+				goto on_error;
+			}
+		}
 	}
 	fprintf(
 	 info_handle->notify_stream,
@@ -571,6 +1351,18 @@ int info_handle_file_fprint(
 	return( 1 );
 
 on_error:
+	if( bitmap != NULL )
+	{
+		libqcow_bitmap_free(
+		 &bitmap,
+		 NULL );
+	}
+	if( snapshot != NULL )
+	{
+		libqcow_snapshot_free(
+		 &snapshot,
+		 NULL );
+	}
 	if( value_string != NULL )
 	{
 		memory_free(
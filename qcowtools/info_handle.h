@@ -68,6 +68,18 @@ int info_handle_close(
      info_handle_t *info_handle,
      libcerror_error_t **error );
 
+int info_handle_snapshot_fprint(
+     info_handle_t *info_handle,
+     int snapshot_index,
+     libqcow_snapshot_t *snapshot,
+     libcerror_error_t **error );
+
+int info_handle_bitmap_fprint(
+     info_handle_t *info_handle,
+     int bitmap_index,
+     libqcow_bitmap_t *bitmap,
+     libcerror_error_t **error );
+
 int info_handle_file_fprint(
      info_handle_t *info_handle,
      libcerror_error_t **error );
@@ -857,7 +857,7 @@ ssize_t mount_file_entry_read_buffer_at_offset(
 
 		return( -1 );
 	}
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
 	              file_entry->qcow_file,
 	              buffer,
 	              buffer_size,
@@ -26,9 +26,11 @@
 #include <types.h>
 #include <wide_string.h>
 
+#include "byte_size_string.h"
 #include "mount_file_entry.h"
 #include "mount_file_system.h"
 #include "mount_handle.h"
+#include "qcowtools_libbfio.h"
 #include "qcowtools_libcerror.h"
 #include "qcowtools_libcpath.h"
 #include "qcowtools_libqcow.h"
@@ -156,6 +158,22 @@ int mount_handle_free(
 
 			result = -1;
 		}
+		if( ( *mount_handle )->parent_file_io_handle != NULL )
+		{
+			if( libbfio_handle_free(
+			     &( ( *mount_handle )->parent_file_io_handle ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free parent file IO handle.",
+				 function );
+
+				result = -1;
+			}
+		}
 		if( memory_set(
 		     ( *mount_handle )->key_data,
 		     0,
@@ -465,6 +483,63 @@ int mount_handle_set_password(
 	return( 1 );
 }
 
+/* Sets the cache budget
+ * Returns 1 if successful or -1 on error
+ */
+int mount_handle_set_cache_budget(
+     mount_handle_t *mount_handle,
+     const system_character_t *string,
+     libcerror_error_t **error )
+{
+	static char *function = "mount_handle_set_cache_budget";
+	size_t string_length  = 0;
+	uint64_t size         = 0;
+
+	if( mount_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mount handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( string == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid string.",
+		 function );
+
+		return( -1 );
+	}
+	string_length = system_string_length(
+	                 string );
+
+	if( byte_size_string_convert(
+	     string,
+	     string_length,
+	     &size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to determine cache budget from string.",
+		 function );
+
+		return( -1 );
+	}
+	mount_handle->cache_budget = (size64_t) size;
+
+	return( 1 );
+}
+
 /* Sets the path prefix
  * Returns 1 if successful or -1 on error
  */
@@ -585,6 +660,23 @@ int mount_handle_open(
 
 		goto on_error;
 	}
+	if( mount_handle->cache_budget != 0 )
+	{
+		if( libqcow_file_set_cache_budget(
+		     qcow_file,
+		     mount_handle->cache_budget,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cache budget.",
+			 function );
+
+			goto on_error;
+		}
+	}
 	if( mount_handle->key_size > 0 )
 	{
 		if( libqcow_file_set_keys(
@@ -818,14 +910,19 @@ int mount_handle_open_parent(
      libqcow_file_t *qcow_file,
      libcerror_error_t **error )
 {
-	libqcow_file_t *parent_qcow_file      = NULL;
-	system_character_t *backing_file_path = NULL;
-	system_character_t *backing_filename  = NULL;
-	static char *function                 = "mount_handle_open_parent";
-	size_t backing_basename_length        = 0;
-	size_t backing_file_path_size         = 0;
-	size_t backing_filename_size          = 0;
-	int result                            = 0;
+	uint8_t backing_format[ 4 ];
+
+	libbfio_handle_t *parent_file_io_handle = NULL;
+	libqcow_file_t *parent_qcow_file        = NULL;
+	system_character_t *backing_file_path   = NULL;
+	system_character_t *backing_filename    = NULL;
+	static char *function                   = "mount_handle_open_parent";
+	size_t backing_basename_length          = 0;
+	size_t backing_file_path_size           = 0;
+	size_t backing_filename_size            = 0;
+	size_t backing_format_size              = 0;
+	int is_raw                              = 0;
+	int result                              = 0;
 
 	if( mount_handle == NULL )
 	{
@@ -961,6 +1058,174 @@ int mount_handle_open_parent(
 			goto on_error;
 		}
 	}
+	result = libqcow_file_get_utf8_backing_format_size(
+	          qcow_file,
+	          &backing_format_size,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve backing format size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( backing_format_size == 4 )
+		{
+			if( libqcow_file_get_utf8_backing_format(
+			     qcow_file,
+			     backing_format,
+			     4,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve backing format.",
+				 function );
+
+				goto on_error;
+			}
+			if( narrow_string_compare(
+			     (char *) backing_format,
+			     "raw",
+			     3 ) == 0 )
+			{
+				is_raw = 1;
+			}
+		}
+	}
+	else
+	{
+		/* Without a backing format header extension the backing file is a raw file
+		 * if it does not contain a QCOW signature
+		 */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_check_file_signature_wide(
+		          backing_file_path,
+		          error );
+#else
+		result = libqcow_check_file_signature(
+		          backing_file_path,
+		          error );
+#endif
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to check signature of parent file: %" PRIs_SYSTEM ".",
+			 function,
+			 backing_file_path );
+
+			goto on_error;
+		}
+		else if( result == 0 )
+		{
+			is_raw = 1;
+		}
+	}
+	if( is_raw != 0 )
+	{
+		if( mount_handle->parent_file_io_handle != NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+			 "%s: invalid mount handle - parent file IO handle value already set.",
+			 function );
+
+			goto on_error;
+		}
+		if( libbfio_file_initialize(
+		     &parent_file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to initialize parent file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		if( libbfio_file_set_name_wide(
+		     parent_file_io_handle,
+		     backing_file_path,
+		     system_string_length(
+		      backing_file_path ) + 1,
+		     error ) != 1 )
+#else
+		if( libbfio_file_set_name(
+		     parent_file_io_handle,
+		     backing_file_path,
+		     system_string_length(
+		      backing_file_path ) + 1,
+		     error ) != 1 )
+#endif
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set name of parent file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		if( libbfio_handle_open(
+		     parent_file_io_handle,
+		     LIBBFIO_OPEN_READ,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open parent file: %" PRIs_SYSTEM ".",
+			 function,
+			 backing_file_path );
+
+			goto on_error;
+		}
+		if( libqcow_file_set_parent_file_io_handle(
+		     qcow_file,
+		     parent_file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set parent file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		mount_handle->parent_file_io_handle = parent_file_io_handle;
+		parent_file_io_handle               = NULL;
+
+		if( mount_handle->basename != NULL )
+		{
+			memory_free(
+			 backing_file_path );
+		}
+		memory_free(
+		 backing_filename );
+
+		return( 1 );
+	}
 	if( libqcow_file_initialize(
 	     &parent_qcow_file,
 	     error ) != 1 )
@@ -974,6 +1239,23 @@ int mount_handle_open_parent(
 
 		goto on_error;
 	}
+	if( mount_handle->cache_budget != 0 )
+	{
+		if( libqcow_file_set_cache_budget(
+		     parent_qcow_file,
+		     mount_handle->cache_budget,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cache budget.",
+			 function );
+
+			goto on_error;
+		}
+	}
 #if defined( HAVE_WIDE_SYSTEM_CHARACTER )
 	if( libqcow_file_open_wide(
 	     parent_qcow_file,
@@ -1060,6 +1342,12 @@ int mount_handle_open_parent(
 	return( 1 );
 
 on_error:
+	if( parent_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &parent_file_io_handle,
+		 NULL );
+	}
 	if( parent_qcow_file != NULL )
 	{
 		libqcow_file_free(
@@ -28,6 +28,7 @@
 
 #include "mount_file_entry.h"
 #include "mount_file_system.h"
+#include "qcowtools_libbfio.h"
 #include "qcowtools_libcerror.h"
 #include "qcowtools_libqcow.h"
 
@@ -51,6 +52,10 @@ struct mount_handle
 	 */
 	mount_file_system_t *file_system;
 
+	/* The raw parent (backing) file IO handle
+	 */
+	libbfio_handle_t *parent_file_io_handle;
+
 	/* The key data
 	 */
 	uint8_t key_data[ 16 ];
@@ -67,6 +72,10 @@ struct mount_handle
 	 */
 	size_t password_length;
 
+	/* The cache budget
+	 */
+	size64_t cache_budget;
+
 	/* Value to indicate the mount handle is locked
 	 */
 	int is_locked;
@@ -104,6 +113,11 @@ int mount_handle_set_password(
      const system_character_t *string,
      libcerror_error_t **error );
 
+int mount_handle_set_cache_budget(
+     mount_handle_t *mount_handle,
+     const system_character_t *string,
+     libcerror_error_t **error );
+
 int mount_handle_set_path_prefix(
      mount_handle_t *mount_handle,
      const system_character_t *path_prefix,
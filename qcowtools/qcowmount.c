@@ -66,12 +66,14 @@ void usage_fprint(
 	}
 	fprintf( stream, "Use qcowmount to mount a QEMU Copy-On-Write (QCOW) image file\n\n" );
 
-	fprintf( stream, "Usage: qcowmount [ -k keys ] [ -p password ] [ -X extended_options ] [ -hvV ]\n"
-	                 "                 image mount_point\n\n" );
+	fprintf( stream, "Usage: qcowmount [ -c cache_budget ] [ -k keys ] [ -p password ]\n"
+	                 "                 [ -X extended_options ] [ -hvV ] image mount_point\n\n" );
 
 	fprintf( stream, "\timage:       a QEMU Copy-On-Write (QCOW) image file\n\n" );
 	fprintf( stream, "\tmount_point: the directory to serve as mount point\n\n" );
 
+	fprintf( stream, "\t-c:          specify the maximum cache size of the image and each of its\n"
+	                 "\t             backing files, such as 256MiB\n" );
 	fprintf( stream, "\t-h:          shows this help\n" );
 	fprintf( stream, "\t-k:          specify the key formatted in base16\n" );
 	fprintf( stream, "\t-p:          specify the password/passphrase\n" );
@@ -135,6 +137,7 @@ int main( int argc, char * const argv[] )
 {
 	libqcow_error_t *error                      = NULL;
 	system_character_t *mount_point             = NULL;
+	system_character_t *option_cache_budget     = NULL;
 	system_character_t *option_extended_options = NULL;
 	system_character_t *option_keys             = NULL;
 	system_character_t *option_password         = NULL;
@@ -191,7 +194,7 @@ int main( int argc, char * const argv[] )
 	while( ( option = qcowtools_getopt(
 	                   argc,
 	                   argv,
-	                   _SYSTEM_STRING( "hk:p:vVX:" ) ) ) != (system_integer_t) -1 )
+	                   _SYSTEM_STRING( "c:hk:p:vVX:" ) ) ) != (system_integer_t) -1 )
 	{
 		switch( option )
 		{
@@ -207,6 +210,11 @@ int main( int argc, char * const argv[] )
 
 				return( EXIT_FAILURE );
 
+			case (system_integer_t) 'c':
+				option_cache_budget = optarg;
+
+				break;
+
 			case (system_integer_t) 'h':
 				usage_fprint(
 				 stdout );
@@ -284,6 +292,20 @@ int main( int argc, char * const argv[] )
 
 		goto on_error;
 	}
+	if( option_cache_budget != NULL )
+	{
+		if( mount_handle_set_cache_budget(
+		     qcowmount_mount_handle,
+		     option_cache_budget,
+		     &error ) != 1 )
+		{
+			fprintf(
+			 stderr,
+			 "Unable to set cache budget.\n" );
+
+			goto on_error;
+		}
+	}
 	if( option_keys != NULL )
 	{
 		if( mount_handle_set_keys(
@@ -0,0 +1,1008 @@
+/*
+ * Library bitmap_values type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_functions.h"
+#include "qcow_test_libbfio.h"
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_bitmap_values.h"
+#include "../libqcow/libqcow_definitions.h"
+
+uint8_t qcow_test_bitmap_values_data1[ 32 ] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02,
+	0x01, 0x10, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x62, 0x6d, 0x70, 0x31, 0x00, 0x00, 0x00, 0x00 };
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_bitmap_values_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_bitmap_values_initialize(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_bitmap_values_t *bitmap_values = NULL;
+	int result                             = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests        = 1;
+	int number_of_memset_fail_tests        = 1;
+	int test_number                        = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_bitmap_values_initialize(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_bitmap_values_free(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_bitmap_values_initialize(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	bitmap_values = (libqcow_bitmap_values_t *) 0x12345678UL;
+
+	result = libqcow_bitmap_values_initialize(
+	          &bitmap_values,
+	          &error );
+
+	bitmap_values = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_bitmap_values_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_bitmap_values_initialize(
+		          &bitmap_values,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( bitmap_values != NULL )
+			{
+				libqcow_bitmap_values_free(
+				 &bitmap_values,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "bitmap_values",
+			 bitmap_values );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_bitmap_values_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_bitmap_values_initialize(
+		          &bitmap_values,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( bitmap_values != NULL )
+			{
+				libqcow_bitmap_values_free(
+				 &bitmap_values,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "bitmap_values",
+			 bitmap_values );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( bitmap_values != NULL )
+	{
+		libqcow_bitmap_values_free(
+		 &bitmap_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_bitmap_values_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_bitmap_values_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_bitmap_values_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_bitmap_values_read_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_bitmap_values_read_data(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_bitmap_values_t *bitmap_values = NULL;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_bitmap_values_initialize(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "bitmap_values->bitmap_table_offset",
+	 (int64_t) bitmap_values->bitmap_table_offset,
+	 (int64_t) 0x00030000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "bitmap_values->bitmap_table_size",
+	 bitmap_values->bitmap_table_size,
+	 (uint32_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "bitmap_values->flags",
+	 bitmap_values->flags,
+	 (uint32_t) LIBQCOW_BITMAP_FLAG_AUTO );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "bitmap_values->granularity_bits",
+	 bitmap_values->granularity_bits,
+	 (uint8_t) 16 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "bitmap_values->name_size",
+	 bitmap_values->name_size,
+	 (size_t) 4 );
+
+	/* Test error cases
+	 */
+	result = libqcow_bitmap_values_read_data(
+	          NULL,
+	          qcow_test_bitmap_values_data1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_free(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_bitmap_values_initialize(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          NULL,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          23,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the name exceeds the data
+	 */
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          26,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the type is not supported
+	 */
+	qcow_test_bitmap_values_data1[ 16 ] = 0x02;
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          32,
+	          &error );
+
+	qcow_test_bitmap_values_data1[ 16 ] = 0x01;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the granularity bits value is out of bounds
+	 */
+	qcow_test_bitmap_values_data1[ 17 ] = 0x08;
+
+	result = libqcow_bitmap_values_read_data(
+	          bitmap_values,
+	          qcow_test_bitmap_values_data1,
+	          32,
+	          &error );
+
+	qcow_test_bitmap_values_data1[ 17 ] = 0x10;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_bitmap_values_free(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( bitmap_values != NULL )
+	{
+		libqcow_bitmap_values_free(
+		 &bitmap_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_bitmap_values_get_changed_extent function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_bitmap_values_get_changed_extent(
+     void )
+{
+	uint8_t image_data[ 1536 ];
+
+	libbfio_handle_t *file_io_handle       = NULL;
+	libcerror_error_t *error               = NULL;
+	libqcow_bitmap_values_t *bitmap_values = NULL;
+	size64_t extent_size                   = 0;
+	size_t data_index                      = 0;
+	off64_t extent_offset                  = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 * The image consists of 512-byte clusters with the bitmap table at offset 512
+	 * and a bitmap cluster at offset 1024. The bitmap covers 512 MiB with a 64 KiB granularity.
+	 * The first bitmap table entry refers to the bitmap cluster, the second bitmap table entry
+	 * has all bits set
+	 */
+	for( data_index = 0;
+	     data_index < 1536;
+	     data_index++ )
+	{
+		image_data[ data_index ] = 0;
+	}
+	image_data[ 512 + 6 ]  = 0x04;
+	image_data[ 512 + 15 ] = 0x01;
+	image_data[ 1024 ]     = 0x06;
+	image_data[ 1025 ]     = 0x80;
+	image_data[ 1535 ]     = 0x80;
+
+	result = libqcow_bitmap_values_initialize(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	bitmap_values->bitmap_table_offset = 512;
+	bitmap_values->bitmap_table_size   = 2;
+	bitmap_values->type                = LIBQCOW_BITMAP_TYPE_DIRTY_TRACKING;
+	bitmap_values->granularity_bits    = 16;
+
+	/* Initialize file IO handle
+	 */
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          1536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "extent_offset",
+	 (int64_t) extent_offset,
+	 (int64_t) 0x00010000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 0x00020000UL );
+
+	/* Test an offset within a changed extent
+	 */
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0x00018000L,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "extent_offset",
+	 (int64_t) extent_offset,
+	 (int64_t) 0x00018000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 0x00018000UL );
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0x00030000L,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "extent_offset",
+	 (int64_t) extent_offset,
+	 (int64_t) 0x000f0000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 0x00010000UL );
+
+	/* Test a changed extent that continues in a bitmap cluster with all bits set
+	 */
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0x00100000L,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "extent_offset",
+	 (int64_t) extent_offset,
+	 (int64_t) 0x0fff0000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 0x10010000UL );
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0x20000000L,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_bitmap_values_get_changed_extent(
+	          NULL,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          -1,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0,
+	          NULL,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0,
+	          &extent_offset,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the bitmap is in use
+	 */
+	bitmap_values->flags = LIBQCOW_BITMAP_FLAG_IN_USE;
+
+	result = libqcow_bitmap_values_get_changed_extent(
+	          bitmap_values,
+	          file_io_handle,
+	          512,
+	          0x20000000UL,
+	          0,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	bitmap_values->flags = 0;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up file IO handle
+	 */
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_bitmap_values_free(
+	          &bitmap_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "bitmap_values",
+	 bitmap_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( bitmap_values != NULL )
+	{
+		libqcow_bitmap_values_free(
+		 &bitmap_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_bitmap_values_initialize",
+	 qcow_test_bitmap_values_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_bitmap_values_free",
+	 qcow_test_bitmap_values_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_bitmap_values_read_data",
+	 qcow_test_bitmap_values_read_data );
+
+	QCOW_TEST_RUN(
+	 "libqcow_bitmap_values_get_changed_extent",
+	 qcow_test_bitmap_values_get_changed_extent );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -0,0 +1,1451 @@
+/*
+ * Library block_cache type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_block_cache.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* The values stored in the block cache by the tests
+ */
+int qcow_test_block_cache_values[ 4 ] = { 0, 1, 2, 3 };
+
+/* The number of values freed by the block cache
+ */
+int qcow_test_block_cache_number_of_freed_values = 0;
+
+/* Frees a value stored in the block cache
+ * The values are not allocated, hence only the number of calls is counted
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_block_cache_value_free(
+     intptr_t **value,
+     libcerror_error_t **error QCOW_TEST_ATTRIBUTE_UNUSED )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( error )
+
+	if( value == NULL )
+	{
+		return( -1 );
+	}
+	*value = NULL;
+
+	qcow_test_block_cache_number_of_freed_values += 1;
+
+	return( 1 );
+}
+
+/* Tests the libqcow_block_cache_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_initialize(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	int result                         = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests    = 2;
+	int number_of_memset_fail_tests    = 2;
+	int test_number                    = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_initialize(
+	          NULL,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	block_cache = (libqcow_block_cache_t *) 0x12345678UL;
+
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	block_cache = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_block_cache_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_block_cache_initialize(
+		          &block_cache,
+		          8,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( block_cache != NULL )
+			{
+				libqcow_block_cache_free(
+				 &block_cache,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "block_cache",
+			 block_cache );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_block_cache_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_block_cache_initialize(
+		          &block_cache,
+		          8,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( block_cache != NULL )
+			{
+				libqcow_block_cache_free(
+				 &block_cache,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "block_cache",
+			 block_cache );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_block_cache_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_block_cache_get_value_by_key and libqcow_block_cache_set_value_by_key functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_get_and_set_value_by_key(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	intptr_t *value                    = NULL;
+	uint64_t number_of_evictions       = 0;
+	uint64_t number_of_hits            = 0;
+	uint64_t number_of_misses          = 0;
+	int number_of_entries              = 0;
+	int result                         = 0;
+
+	qcow_test_block_cache_number_of_freed_values = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          512,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "value",
+	 value );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          512,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ),
+	          &qcow_test_block_cache_value_free,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          512,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INTPTR(
+	 "value",
+	 value,
+	 (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Keys that would collide in a direct-mapped cache must not evict each other
+	 * while the block cache has room
+	 */
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          512 + ( (uint64_t) 1 << 40 ),
+	          (intptr_t *) &( qcow_test_block_cache_values[ 1 ] ),
+	          &qcow_test_block_cache_value_free,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          512,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          block_cache,
+	          &number_of_entries,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_entries",
+	 number_of_entries,
+	 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Setting a third value evicts the least recently set value
+	 */
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          1024,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 2 ] ),
+	          &qcow_test_block_cache_value_free,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "qcow_test_block_cache_number_of_freed_values",
+	 qcow_test_block_cache_number_of_freed_values,
+	 1 );
+
+	result = libqcow_block_cache_get_statistics(
+	          block_cache,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_hits",
+	 number_of_hits,
+	 (uint64_t) 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_misses",
+	 number_of_misses,
+	 (uint64_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_evictions",
+	 number_of_evictions,
+	 (uint64_t) 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          512,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_get_value_by_key(
+	          NULL,
+	          512,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          512,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_set_value_by_key(
+	          NULL,
+	          512,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          512,
+	          NULL,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "qcow_test_block_cache_number_of_freed_values",
+	 qcow_test_block_cache_number_of_freed_values,
+	 3 );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests that a sequential scan does not evict a frequently used value
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_scan_resistance(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	intptr_t *value                    = NULL;
+	uint64_t key                       = 0;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Set the hot value, push it out of the recent segment and set it again
+	 * so that it is promoted to the frequent segment
+	 */
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          0,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( key = 65536;
+	     key <= 8 * 65536;
+	     key += 65536 )
+	{
+		result = libqcow_block_cache_set_value_by_key(
+		          block_cache,
+		          key,
+		          (intptr_t *) &( qcow_test_block_cache_values[ 1 ] ),
+		          NULL,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          0,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          0,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Scan many more values than fit in the block cache
+	 */
+	for( key = 1024 * 65536;
+	     key < 2048 * 65536;
+	     key += 65536 )
+	{
+		result = libqcow_block_cache_set_value_by_key(
+		          block_cache,
+		          key,
+		          (intptr_t *) &( qcow_test_block_cache_values[ 2 ] ),
+		          NULL,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          0,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INTPTR(
+	 "value",
+	 value,
+	 (intptr_t *) &( qcow_test_block_cache_values[ 0 ] ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_block_cache_resize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_resize(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	uint64_t key                       = 0;
+	int number_of_entries              = 0;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( key = 0;
+	     key < 8 * 512;
+	     key += 512 )
+	{
+		result = libqcow_block_cache_set_value_by_key(
+		          block_cache,
+		          key,
+		          (intptr_t *) &( qcow_test_block_cache_values[ 3 ] ),
+		          NULL,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Test regular cases
+	 */
+	result = libqcow_block_cache_resize(
+	          block_cache,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          block_cache,
+	          &number_of_entries,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_entries",
+	 number_of_entries,
+	 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_resize(
+	          block_cache,
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          block_cache,
+	          &number_of_entries,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_entries",
+	 number_of_entries,
+	 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_resize(
+	          NULL,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_resize(
+	          block_cache,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          NULL,
+	          &number_of_entries,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          block_cache,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_block_cache_remove_value_by_key function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_remove_value_by_key(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	intptr_t *value                    = NULL;
+	int number_of_entries              = 0;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_set_value_by_key(
+	          block_cache,
+	          0x1000,
+	          (intptr_t *) &( qcow_test_block_cache_values[ 1 ] ),
+	          &qcow_test_block_cache_value_free,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	qcow_test_block_cache_number_of_freed_values = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_block_cache_remove_value_by_key(
+	          block_cache,
+	          0x1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "qcow_test_block_cache_number_of_freed_values",
+	 qcow_test_block_cache_number_of_freed_values,
+	 1 );
+
+	result = libqcow_block_cache_get_number_of_entries(
+	          block_cache,
+	          &number_of_entries,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_entries",
+	 number_of_entries,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_block_cache_get_value_by_key(
+	          block_cache,
+	          0x1000,
+	          &value,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test removing a key that is not in the cache
+	 */
+	result = libqcow_block_cache_remove_value_by_key(
+	          block_cache,
+	          0x1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_remove_value_by_key(
+	          NULL,
+	          0x1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_block_cache_get_statistics function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_block_cache_get_statistics(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_block_cache_t *block_cache = NULL;
+	uint64_t number_of_evictions       = 0;
+	uint64_t number_of_hits            = 0;
+	uint64_t number_of_misses          = 0;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_block_cache_initialize(
+	          &block_cache,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "block_cache",
+	 block_cache );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_block_cache_get_statistics(
+	          block_cache,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_hits",
+	 number_of_hits,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_block_cache_get_statistics(
+	          NULL,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_statistics(
+	          block_cache,
+	          NULL,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_statistics(
+	          block_cache,
+	          &number_of_hits,
+	          NULL,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_block_cache_get_statistics(
+	          block_cache,
+	          &number_of_hits,
+	          &number_of_misses,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_block_cache_free(
+	          &block_cache,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( block_cache != NULL )
+	{
+		libqcow_block_cache_free(
+		 &block_cache,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_initialize",
+	 qcow_test_block_cache_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_free",
+	 qcow_test_block_cache_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_resize",
+	 qcow_test_block_cache_resize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_get_and_set_value_by_key",
+	 qcow_test_block_cache_get_and_set_value_by_key );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_scan_resistance",
+	 qcow_test_block_cache_scan_resistance );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_remove_value_by_key",
+	 qcow_test_block_cache_remove_value_by_key );
+
+	QCOW_TEST_RUN(
+	 "libqcow_block_cache_get_statistics",
+	 qcow_test_block_cache_get_statistics );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
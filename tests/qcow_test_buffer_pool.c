@@ -0,0 +1,711 @@
+/*
+ * Library buffer_pool type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_buffer_pool.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_buffer_pool_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_buffer_pool_initialize(
+     void )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_buffer_pool_t *buffer_pool = NULL;
+	int result                          = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests     = 2;
+	int number_of_memset_fail_tests     = 1;
+	int test_number                     = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_buffer_pool_initialize(
+	          &buffer_pool,
+	          4096,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "buffer_pool",
+	 buffer_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_buffer_pool_free(
+	          &buffer_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "buffer_pool",
+	 buffer_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_buffer_pool_initialize(
+	          NULL,
+	          4096,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	buffer_pool = (libqcow_buffer_pool_t *) 0x12345678UL;
+
+	result = libqcow_buffer_pool_initialize(
+	          &buffer_pool,
+	          4096,
+	          4,
+	          &error );
+
+	buffer_pool = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_initialize(
+	          &buffer_pool,
+	          0,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_initialize(
+	          &buffer_pool,
+	          4096,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_buffer_pool_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_buffer_pool_initialize(
+		          &buffer_pool,
+		          4096,
+		          4,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( buffer_pool != NULL )
+			{
+				libqcow_buffer_pool_free(
+				 &buffer_pool,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "buffer_pool",
+			 buffer_pool );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_buffer_pool_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_buffer_pool_initialize(
+		          &buffer_pool,
+		          4096,
+		          4,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( buffer_pool != NULL )
+			{
+				libqcow_buffer_pool_free(
+				 &buffer_pool,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "buffer_pool",
+			 buffer_pool );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( buffer_pool != NULL )
+	{
+		libqcow_buffer_pool_free(
+		 &buffer_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_buffer_pool_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_buffer_pool_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_buffer_pool_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_buffer_pool_get_buffer and libqcow_buffer_pool_release_buffer functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_buffer_pool_get_and_release_buffer(
+     void )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_buffer_pool_t *buffer_pool = NULL;
+	uint8_t *buffer                     = NULL;
+	uint8_t *large_buffer               = NULL;
+	uint8_t *previous_buffer            = NULL;
+	uint64_t number_of_allocations      = 0;
+	uint64_t number_of_reuses           = 0;
+	int number_of_free_buffers          = 0;
+	int result                          = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_buffer_pool_initialize(
+	          &buffer_pool,
+	          4096,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "buffer_pool",
+	 buffer_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_buffer_pool_get_buffer(
+	          buffer_pool,
+	          4096,
+	          &buffer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "buffer",
+	 buffer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	previous_buffer = buffer;
+
+	result = libqcow_buffer_pool_release_buffer(
+	          buffer_pool,
+	          &buffer,
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "buffer",
+	 buffer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test if a released buffer is reused for a smaller data size
+	 */
+	result = libqcow_buffer_pool_get_buffer(
+	          buffer_pool,
+	          512,
+	          &buffer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "buffer == previous_buffer",
+	 (int) ( buffer == previous_buffer ),
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test if a data size larger than the buffer size is allocated individually
+	 */
+	result = libqcow_buffer_pool_get_buffer(
+	          buffer_pool,
+	          8192,
+	          &large_buffer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "large_buffer",
+	 large_buffer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_buffer_pool_release_buffer(
+	          buffer_pool,
+	          &large_buffer,
+	          8192,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "large_buffer",
+	 large_buffer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_buffer_pool_release_buffer(
+	          buffer_pool,
+	          &buffer,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "buffer",
+	 buffer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_buffer_pool_get_statistics(
+	          buffer_pool,
+	          &number_of_allocations,
+	          &number_of_reuses,
+	          &number_of_free_buffers,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_allocations",
+	 number_of_allocations,
+	 (uint64_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_reuses",
+	 number_of_reuses,
+	 (uint64_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_free_buffers",
+	 number_of_free_buffers,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_buffer_pool_get_buffer(
+	          NULL,
+	          4096,
+	          &buffer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_get_buffer(
+	          buffer_pool,
+	          0,
+	          &buffer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_get_buffer(
+	          buffer_pool,
+	          4096,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_release_buffer(
+	          NULL,
+	          &buffer,
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_release_buffer(
+	          buffer_pool,
+	          NULL,
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_buffer_pool_get_statistics(
+	          NULL,
+	          &number_of_allocations,
+	          &number_of_reuses,
+	          &number_of_free_buffers,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_buffer_pool_free(
+	          &buffer_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "buffer_pool",
+	 buffer_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( large_buffer != NULL )
+	{
+		libqcow_buffer_pool_release_buffer(
+		 buffer_pool,
+		 &large_buffer,
+		 8192,
+		 NULL );
+	}
+	if( buffer != NULL )
+	{
+		libqcow_buffer_pool_release_buffer(
+		 buffer_pool,
+		 &buffer,
+		 4096,
+		 NULL );
+	}
+	if( buffer_pool != NULL )
+	{
+		libqcow_buffer_pool_free(
+		 &buffer_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_buffer_pool_initialize",
+	 qcow_test_buffer_pool_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_buffer_pool_free",
+	 qcow_test_buffer_pool_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_buffer_pool_get_and_release_buffer",
+	 qcow_test_buffer_pool_get_and_release_buffer );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -0,0 +1,799 @@
+/*
+ * Library cache_budget functions test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libcthreads.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_cache_budget.h"
+
+#define QCOW_TEST_CACHE_BUDGET_NUMBER_OF_THREADS	8
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_cache_budget_get_maximum_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_get_maximum_size(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t maximum_size    = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_budget_get_maximum_size(
+	          &maximum_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "maximum_size",
+	 maximum_size,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_budget_get_maximum_size(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_budget_set_maximum_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_set_maximum_size(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t maximum_size    = 0;
+	size64_t reserved_size   = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_budget_set_maximum_size(
+	          1048576,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_get_maximum_size(
+	          &maximum_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "maximum_size",
+	 maximum_size,
+	 (uint64_t) 1048576 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_set_maximum_size(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_budget_set_maximum_size(
+	          1048576,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_reserve(
+	          4096,
+	          512,
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 4096 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test unsetting the maximum size while cache size is reserved
+	 */
+	result = libqcow_cache_budget_set_maximum_size(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_budget_release(
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_set_maximum_size(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_budget_get_reserved_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_get_reserved_size(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t reserved_size   = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_budget_get_reserved_size(
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_budget_get_reserved_size(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_budget_reserve and libqcow_cache_budget_release functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_reserve(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t reserved_size   = 0;
+	int result               = 0;
+
+	/* Test reserve without a maximum size
+	 */
+	result = libqcow_cache_budget_reserve(
+	          65536,
+	          4096,
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 65536 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_get_reserved_size(
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test reserve with a maximum size
+	 */
+	result = libqcow_cache_budget_set_maximum_size(
+	          100000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_reserve(
+	          60000,
+	          4096,
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 60000 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test reserve limited by the remaining size
+	 */
+	result = libqcow_cache_budget_reserve(
+	          60000,
+	          4096,
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 40000 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test reserve limited by the minimum size
+	 */
+	result = libqcow_cache_budget_reserve(
+	          60000,
+	          4096,
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 4096 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_get_reserved_size(
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 104096 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_release(
+	          60000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_release(
+	          40000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_release(
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_release(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_budget_reserve(
+	          60000,
+	          4096,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_budget_release(
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_budget_set_maximum_size(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+/* Reserves and releases cache size concurrently
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_reserve_concurrent_thread(
+     int *thread_result )
+{
+	libcerror_error_t *error = NULL;
+	size64_t reserved_size   = 0;
+	int number_of_tests      = 65536;
+	int result               = 0;
+	int test_number          = 0;
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		result = libqcow_cache_budget_reserve(
+		          4096,
+		          0,
+		          &reserved_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_LESS_THAN_UINT64(
+		 "reserved_size",
+		 (uint64_t) reserved_size,
+		 (uint64_t) 4097 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_cache_budget_release(
+		          reserved_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	*thread_result = 1;
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_budget_reserve and libqcow_cache_budget_release functions concurrently
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_budget_reserve_concurrent(
+     void )
+{
+	libcthreads_thread_t *threads[ QCOW_TEST_CACHE_BUDGET_NUMBER_OF_THREADS ];
+	int thread_results[ QCOW_TEST_CACHE_BUDGET_NUMBER_OF_THREADS ];
+
+	libcerror_error_t *error = NULL;
+	size64_t reserved_size   = 0;
+	int result               = 0;
+	int thread_index         = 0;
+
+	/* The maximum size allows for less than one reservation per thread
+	 */
+	result = libqcow_cache_budget_set_maximum_size(
+	          16384,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_CACHE_BUDGET_NUMBER_OF_THREADS;
+	     thread_index++ )
+	{
+		threads[ thread_index ]        = NULL;
+		thread_results[ thread_index ] = 0;
+
+		result = libcthreads_thread_create(
+		          &( threads[ thread_index ] ),
+		          NULL,
+		          (int (*)(void *)) &qcow_test_cache_budget_reserve_concurrent_thread,
+		          (void *) &( thread_results[ thread_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_CACHE_BUDGET_NUMBER_OF_THREADS;
+	     thread_index++ )
+	{
+		result = libcthreads_thread_join(
+		          &( threads[ thread_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "thread_results[ thread_index ]",
+		 thread_results[ thread_index ],
+		 1 );
+	}
+	/* All reservations were released
+	 */
+	result = libqcow_cache_budget_get_reserved_size(
+	          &reserved_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reserved_size",
+	 reserved_size,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_budget_set_maximum_size(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW ) */
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_budget_get_maximum_size",
+	 qcow_test_cache_budget_get_maximum_size );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_budget_set_maximum_size",
+	 qcow_test_cache_budget_set_maximum_size );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_budget_get_reserved_size",
+	 qcow_test_cache_budget_get_reserved_size );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_budget_reserve",
+	 qcow_test_cache_budget_reserve );
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_budget_reserve_concurrent",
+	 qcow_test_cache_budget_reserve_concurrent );
+
+#endif
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -57,6 +57,7 @@ int qcow_test_cluster_block_initialize(
 	 */
 	result = libqcow_cluster_block_initialize(
 	          &cluster_block,
+	          NULL,
 	          4096,
 	          &error );
 
@@ -93,6 +94,7 @@ int qcow_test_cluster_block_initialize(
 	/* Test error cases
 	 */
 	result = libqcow_cluster_block_initialize(
+	          NULL,
 	          NULL,
 	          4096,
 	          &error );
@@ -113,6 +115,7 @@ int qcow_test_cluster_block_initialize(
 
 	result = libqcow_cluster_block_initialize(
 	          &cluster_block,
+	          NULL,
 	          4096,
 	          &error );
 
@@ -132,6 +135,7 @@ int qcow_test_cluster_block_initialize(
 
 	result = libqcow_cluster_block_initialize(
 	          &cluster_block,
+	          NULL,
 	          (size_t) SSIZE_MAX + 1,
 	          &error );
 
@@ -159,6 +163,7 @@ int qcow_test_cluster_block_initialize(
 
 		result = libqcow_cluster_block_initialize(
 		          &cluster_block,
+		          NULL,
 		          4096,
 		          &error );
 
@@ -202,6 +207,7 @@ int qcow_test_cluster_block_initialize(
 
 		result = libqcow_cluster_block_initialize(
 		          &cluster_block,
+		          NULL,
 		          4096,
 		          &error );
 
@@ -306,6 +312,7 @@ int qcow_test_cluster_block_read(
 	 */
 	result = libqcow_cluster_block_initialize(
 	          &cluster_block,
+	          NULL,
 	          4096,
 	          &error );
 
@@ -418,6 +425,222 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_block_copy_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_block_copy_data(
+     void )
+{
+	uint8_t buffer[ 32 ];
+
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_block_t *cluster_block = NULL;
+	size_t buffer_index                    = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          NULL,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_index = 0;
+	     buffer_index < 16;
+	     buffer_index++ )
+	{
+		cluster_block->data[ buffer_index ] = (uint8_t) ( buffer_index + 1 );
+	}
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_block_copy_data(
+	          cluster_block,
+	          4,
+	          buffer,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "buffer[ 0 ]",
+	 buffer[ 0 ],
+	 (uint8_t) 5 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "buffer[ 7 ]",
+	 buffer[ 7 ],
+	 (uint8_t) 12 );
+
+	/* Test copy beyond the end of the cluster block data
+	 */
+	result = libqcow_cluster_block_copy_data(
+	          cluster_block,
+	          12,
+	          buffer,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "buffer[ 3 ]",
+	 buffer[ 3 ],
+	 (uint8_t) 16 );
+
+	for( buffer_index = 4;
+	     buffer_index < 32;
+	     buffer_index++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_index ]",
+		 buffer[ buffer_index ],
+		 (uint8_t) 0 );
+	}
+	result = libqcow_cluster_block_copy_data(
+	          cluster_block,
+	          16,
+	          buffer,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "buffer[ 0 ]",
+	 buffer[ 0 ],
+	 (uint8_t) 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_block_copy_data(
+	          NULL,
+	          0,
+	          buffer,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_copy_data(
+	          cluster_block,
+	          0,
+	          NULL,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_copy_data(
+	          cluster_block,
+	          0,
+	          buffer,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 /* The main program
@@ -449,6 +672,10 @@ int main(
 	 "libqcow_cluster_block_read",
 	 qcow_test_cluster_block_read );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_block_copy_data",
+	 qcow_test_cluster_block_copy_data );
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 	return( EXIT_SUCCESS );
@@ -544,6 +544,470 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_table_set_reference_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_table_set_reference_by_index(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_table_t *cluster_table = NULL;
+	uint64_t reference                     = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	cluster_table->modified_start_index = 0;
+	cluster_table->modified_end_index   = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_table_set_reference_by_index(
+	          cluster_table,
+	          5,
+	          0x8000000000030000UL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_start_index",
+	 cluster_table->modified_start_index,
+	 5 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_end_index",
+	 cluster_table->modified_end_index,
+	 6 );
+
+	result = libqcow_cluster_table_set_reference_by_index(
+	          cluster_table,
+	          2,
+	          0x8000000000020000UL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_start_index",
+	 cluster_table->modified_start_index,
+	 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_end_index",
+	 cluster_table->modified_end_index,
+	 6 );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          cluster_table,
+	          5,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0x8000000000030000UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_set_reference_by_index(
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_set_reference_by_index(
+	          cluster_table,
+	          -1,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_set_reference_by_index(
+	          cluster_table,
+	          8,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &cluster_table,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cluster_table_resize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_table_resize(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_table_t *cluster_table = NULL;
+	uint64_t reference                     = 0;
+	int number_of_references               = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_set_reference_by_index(
+	          cluster_table,
+	          3,
+	          0x0000000000010000UL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_number_of_references(
+	          cluster_table,
+	          &number_of_references,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_references",
+	 number_of_references,
+	 8 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_start_index",
+	 cluster_table->modified_start_index,
+	 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_table->modified_end_index",
+	 cluster_table->modified_end_index,
+	 8 );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          cluster_table,
+	          3,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0x0000000000010000UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          cluster_table,
+	          7,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_resize(
+	          NULL,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          63,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test shrinking the cluster table
+	 */
+	result = libqcow_cluster_table_resize(
+	          cluster_table,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &cluster_table,
+		 NULL );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_cluster_table_read function
  * Returns 1 if successful or 0 if not
  */
@@ -703,6 +1167,14 @@ int main(
 	 "libqcow_cluster_table_get_reference_by_index",
 	 qcow_test_cluster_table_get_reference_by_index );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_table_set_reference_by_index",
+	 qcow_test_cluster_table_set_reference_by_index );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_table_resize",
+	 qcow_test_cluster_table_resize );
+
 	QCOW_TEST_RUN(
 	 "libqcow_cluster_table_read",
 	 qcow_test_cluster_table_read );
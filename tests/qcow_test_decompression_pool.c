@@ -0,0 +1,788 @@
+/*
+ * Library decompression_pool type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_cluster_block.h"
+#include "../libqcow/libqcow_decompression_pool.h"
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_libcthreads.h"
+#include "../libqcow/libqcow_read_segment.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Decompress cluster block test function that fills the data with a byte value
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_decompression_pool_decompress_cluster_block(
+     intptr_t *data_handle QCOW_TEST_ATTRIBUTE_UNUSED,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error QCOW_TEST_ATTRIBUTE_UNUSED )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( data_handle )
+	QCOW_TEST_UNREFERENCED_PARAMETER( error )
+
+	if( cluster_block == NULL )
+	{
+		return( -1 );
+	}
+	if( memory_set(
+	     cluster_block->data,
+	     0x5a,
+	     cluster_block->data_size ) == NULL )
+	{
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Decompress cluster block test function that fails
+ * Returns -1 on error
+ */
+int qcow_test_decompression_pool_decompress_cluster_block_fails(
+     intptr_t *data_handle QCOW_TEST_ATTRIBUTE_UNUSED,
+     libqcow_cluster_block_t *cluster_block QCOW_TEST_ATTRIBUTE_UNUSED,
+     libcerror_error_t **error QCOW_TEST_ATTRIBUTE_UNUSED )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( data_handle )
+	QCOW_TEST_UNREFERENCED_PARAMETER( cluster_block )
+	QCOW_TEST_UNREFERENCED_PARAMETER( error )
+
+	return( -1 );
+}
+
+/* Tests the libqcow_decompression_pool_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_decompression_pool_initialize(
+     void )
+{
+	libcerror_error_t *error                         = NULL;
+	libqcow_decompression_pool_t *decompression_pool = NULL;
+	int result                                       = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_decompression_pool_free(
+	          &decompression_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_decompression_pool_initialize(
+	          NULL,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	decompression_pool = (libqcow_decompression_pool_t *) 0x12345678UL;
+
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          4,
+	          &error );
+
+	decompression_pool = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          NULL,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          LIBQCOW_MAXIMUM_NUMBER_OF_DECOMPRESSION_THREADS + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( decompression_pool != NULL )
+	{
+		libqcow_decompression_pool_free(
+		 &decompression_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_decompression_pool_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_decompression_pool_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_decompression_pool_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_decompression_pool_push_task function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_decompression_pool_push_task(
+     void )
+{
+	uint8_t buffer[ 256 ];
+
+	libcerror_error_t *error                         = NULL;
+	libqcow_cluster_block_t *cluster_block           = NULL;
+	libqcow_decompression_batch_t decompression_batch;
+	libqcow_decompression_pool_t *decompression_pool = NULL;
+	libqcow_decompression_task_t decompression_task;
+	libqcow_read_segment_t read_segments[ 2 ];
+	size_t buffer_offset                             = 0;
+	int result                                       = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          NULL,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( memory_set(
+	     buffer,
+	     0,
+	     256 ) == NULL )
+	{
+		goto on_error;
+	}
+	read_segments[ 0 ].cluster_block_data_offset = 0;
+	read_segments[ 0 ].buffer                    = buffer;
+	read_segments[ 0 ].size                      = 128;
+	read_segments[ 1 ].cluster_block_data_offset = 384;
+	read_segments[ 1 ].buffer                    = &( buffer[ 128 ] );
+	read_segments[ 1 ].size                      = 128;
+
+	decompression_batch.number_of_pending_tasks = 0;
+	decompression_batch.number_of_failed_tasks  = 0;
+
+	decompression_task.batch                   = &decompression_batch;
+	decompression_task.cluster_block           = cluster_block;
+	decompression_task.read_segments           = read_segments;
+	decompression_task.number_of_read_segments = 2;
+	decompression_task.result                  = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_decompression_pool_push_task(
+	          decompression_pool,
+	          &decompression_task,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_decompression_pool_wait_for_batch(
+	          decompression_pool,
+	          &decompression_batch,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "decompression_task.result",
+	 decompression_task.result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 256;
+	     buffer_offset++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 (uint8_t) 0x5a );
+	}
+	/* Test error cases
+	 */
+	result = libqcow_decompression_pool_push_task(
+	          NULL,
+	          &decompression_task,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_decompression_pool_push_task(
+	          decompression_pool,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	decompression_task.cluster_block = NULL;
+
+	result = libqcow_decompression_pool_push_task(
+	          decompression_pool,
+	          &decompression_task,
+	          &error );
+
+	decompression_task.cluster_block = cluster_block;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_decompression_pool_free(
+	          &decompression_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( decompression_pool != NULL )
+	{
+		libqcow_decompression_pool_free(
+		 &decompression_pool,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_decompression_pool_wait_for_batch function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_decompression_pool_wait_for_batch(
+     void )
+{
+	uint8_t buffer[ 128 ];
+
+	libcerror_error_t *error                         = NULL;
+	libqcow_cluster_block_t *cluster_block           = NULL;
+	libqcow_decompression_batch_t decompression_batch;
+	libqcow_decompression_pool_t *decompression_pool = NULL;
+	libqcow_decompression_task_t decompression_task;
+	libqcow_read_segment_t read_segment;
+	int result                                       = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_decompression_pool_initialize(
+	          &decompression_pool,
+	          NULL,
+	          &qcow_test_decompression_pool_decompress_cluster_block_fails,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          NULL,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_segment.cluster_block_data_offset = 0;
+	read_segment.buffer                    = buffer;
+	read_segment.size                      = 128;
+
+	decompression_batch.number_of_pending_tasks = 0;
+	decompression_batch.number_of_failed_tasks  = 0;
+
+	decompression_task.batch                   = &decompression_batch;
+	decompression_task.cluster_block           = cluster_block;
+	decompression_task.read_segments           = &read_segment;
+	decompression_task.number_of_read_segments = 1;
+	decompression_task.result                  = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_decompression_pool_wait_for_batch(
+	          decompression_pool,
+	          &decompression_batch,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_decompression_pool_push_task(
+	          decompression_pool,
+	          &decompression_task,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test a batch with a task that failed
+	 */
+	result = libqcow_decompression_pool_wait_for_batch(
+	          decompression_pool,
+	          &decompression_batch,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "decompression_task.result",
+	 decompression_task.result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_decompression_pool_wait_for_batch(
+	          NULL,
+	          &decompression_batch,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_decompression_pool_wait_for_batch(
+	          decompression_pool,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_decompression_pool_free(
+	          &decompression_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "decompression_pool",
+	 decompression_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( decompression_pool != NULL )
+	{
+		libqcow_decompression_pool_free(
+		 &decompression_pool,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_decompression_pool_initialize",
+	 qcow_test_decompression_pool_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_decompression_pool_free",
+	 qcow_test_decompression_pool_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_decompression_pool_push_task",
+	 qcow_test_decompression_pool_push_task );
+
+	QCOW_TEST_RUN(
+	 "libqcow_decompression_pool_wait_for_batch",
+	 qcow_test_decompression_pool_wait_for_batch );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -28,6 +28,15 @@
 #include <stdlib.h>
 #endif
 
+#if defined( TIME_WITH_SYS_TIME )
+#include <sys/time.h>
+#include <time.h>
+#elif defined( HAVE_SYS_TIME_H )
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
 #include "qcow_test_libcerror.h"
 #include "qcow_test_libcnotify.h"
 #include "qcow_test_libqcow.h"
@@ -40,6 +49,13 @@
 #define QCOW_TEST_DEFLATE
  */
 
+/* The number of times the test data is decompressed to measure the throughput
+ * The throughput is only measured if the QCOW_TEST_BENCHMARK environment variable is set
+ */
+#if !defined( QCOW_TEST_DEFLATE_THROUGHPUT_NUMBER_OF_ITERATIONS )
+#define QCOW_TEST_DEFLATE_THROUGHPUT_NUMBER_OF_ITERATIONS	1024
+#endif
+
 uint8_t qcow_test_deflate_compressed_byte_stream[ 2627 ] = {
 	0x78, 0xda, 0xbd, 0x59, 0x6d, 0x8f, 0xdb, 0xb8, 0x11, 0xfe, 0x7c, 0xfa, 0x15, 0xc4, 0x7e, 0xb9,
 	0x5d, 0xc0, 0x75, 0x5e, 0x7b, 0x45, 0x0f, 0x45, 0x81, 0xed, 0xde, 0x26, 0xdd, 0x62, 0x2f, 0x0d,
@@ -973,7 +989,7 @@ int qcow_test_deflate_huffman_table_construct(
 	int result                      = 0;
 
 #if defined( HAVE_QCOW_TEST_MEMORY )
-	int number_of_memset_fail_tests = 2;
+	int number_of_memset_fail_tests = 3;
 	int test_number                 = 0;
 #endif
 
@@ -1136,6 +1152,264 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_deflate_huffman_table_build_lookup_table function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_huffman_table_build_lookup_table(
+     void )
+{
+	uint16_t code_size_array[ 318 ];
+	uint8_t byte_stream[ 2 ] = { 0xff, 0x07 };
+
+	libqcow_deflate_bit_stream_t bit_stream;
+	libqcow_deflate_huffman_table_t table;
+
+	libcerror_error_t *error        = NULL;
+	void *memset_result             = NULL;
+	uint32_t value_32bit            = 0;
+	uint16_t symbol                 = 0;
+	int result                      = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_memset_fail_tests = 1;
+	int test_number                 = 0;
+#endif
+
+	/* Initialize test
+	 */
+	memset_result = memory_set(
+	                 &table,
+	                 0,
+	                 sizeof( libqcow_deflate_huffman_table_t ) );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "memset_result",
+	 memset_result );
+
+	for( symbol = 0;
+	     symbol < 288;
+	     symbol++ )
+	{
+		if( symbol < 144 )
+		{
+			code_size_array[ symbol ] = 8;
+		}
+		else if( symbol < 256 )
+		{
+			code_size_array[ symbol ] = 9;
+		}
+		else if( symbol < 280 )
+		{
+			code_size_array[ symbol ] = 7;
+		}
+		else
+		{
+			code_size_array[ symbol ] = 8;
+		}
+	}
+	result = libqcow_deflate_huffman_table_construct(
+	          &table,
+	          code_size_array,
+	          288,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_deflate_huffman_table_build_lookup_table(
+	          &table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Symbol 256 has the 7-bit code 0000000
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x0000 ]",
+	 table.lookup_table[ 0x0000 ],
+	 (uint16_t) ( ( 256 << 5 ) | 7 ) );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x0180 ]",
+	 table.lookup_table[ 0x0180 ],
+	 (uint16_t) ( ( 256 << 5 ) | 7 ) );
+
+	/* Symbol 0 has the 8-bit code 00110000
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x000c ]",
+	 table.lookup_table[ 0x000c ],
+	 (uint16_t) 8 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x010c ]",
+	 table.lookup_table[ 0x010c ],
+	 (uint16_t) 8 );
+
+	/* Symbol 144 has the 9-bit code 110010000
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x0013 ]",
+	 table.lookup_table[ 0x0013 ],
+	 (uint16_t) ( ( 144 << 5 ) | 9 ) );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x0213 ]",
+	 table.lookup_table[ 0x0213 ],
+	 (uint16_t) ( ( 144 << 5 ) | 9 ) );
+
+	/* Test codes that are stored in a secondary lookup table
+	 */
+	for( symbol = 0;
+	     symbol < 11;
+	     symbol++ )
+	{
+		code_size_array[ symbol ] = symbol + 1;
+	}
+	code_size_array[ 11 ] = 11;
+
+	result = libqcow_deflate_huffman_table_construct(
+	          &table,
+	          code_size_array,
+	          12,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Symbols 10 and 11 have the 11-bit codes 11111111110 and 11111111111
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0x03ff ]",
+	 table.lookup_table[ 0x03ff ],
+	 (uint16_t) ( ( 1024 << 5 ) | LIBQCOW_DEFLATE_HUFFMAN_LOOKUP_FLAG_SUB_TABLE | 1 ) );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 1024 ]",
+	 table.lookup_table[ 1024 ],
+	 (uint16_t) ( ( 10 << 5 ) | 11 ) );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 1025 ]",
+	 table.lookup_table[ 1025 ],
+	 (uint16_t) ( ( 11 << 5 ) | 11 ) );
+
+	bit_stream.byte_stream        = byte_stream;
+	bit_stream.byte_stream_size   = 2;
+	bit_stream.byte_stream_offset = 0;
+	bit_stream.bit_buffer         = 0;
+	bit_stream.bit_buffer_size    = 0;
+
+	result = libqcow_deflate_bit_stream_get_huffman_encoded_value(
+	          &bit_stream,
+	          &table,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "value_32bit",
+	 value_32bit,
+	 (uint32_t) 11 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "bit_stream.bit_buffer_size",
+	 bit_stream.bit_buffer_size,
+	 (uint8_t) 5 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_deflate_huffman_table_build_lookup_table(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_deflate_huffman_table_build_lookup_table with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_deflate_huffman_table_build_lookup_table(
+		          &table,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_deflate_bit_stream_get_huffman_encoded_value function
  * Returns 1 if successful or 0 if not
  */
@@ -2072,24 +2346,69 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_deflate_read_data_header function
+/* Tests the libqcow_deflate_get_adler32_implementation function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_deflate_read_data_header(
+int qcow_test_deflate_get_adler32_implementation(
      void )
 {
-	libcerror_error_t *error        = NULL;
-	size_t uncompressed_data_offset = 0;
-	int result                      = 0;
+	int implementation = 0;
 
 	/* Test regular cases
 	 */
-	uncompressed_data_offset = 0;
+	implementation = libqcow_deflate_get_adler32_implementation();
 
-	result = libqcow_deflate_read_data_header(
-	          qcow_test_deflate_compressed_byte_stream,
-	          2627,
-	          &uncompressed_data_offset,
+	QCOW_TEST_ASSERT_GREATER_THAN_INT(
+	 "implementation",
+	 implementation,
+	 0 );
+
+	QCOW_TEST_ASSERT_LESS_THAN_INT(
+	 "implementation",
+	 implementation,
+	 5 );
+
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+	/* NEON is part of the ARM64 architecture, hence the NEON implementation
+	 * is expected to be used, otherwise LIBQCOW_DEFLATE_HAVE_NEON was not defined
+	 */
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "implementation",
+	 implementation,
+	 LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_NEON );
+
+#elif defined( __x86_64__ ) || defined( _M_X64 ) || defined( _M_AMD64 )
+	/* SSE2 is part of the x86-64 architecture
+	 */
+	QCOW_TEST_ASSERT_GREATER_THAN_INT(
+	 "implementation",
+	 implementation,
+	 LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_SCALAR );
+#endif
+
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+/* Tests the libqcow_deflate_calculate_adler32_scalar function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_calculate_adler32_scalar(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	uint32_t checksum        = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_deflate_calculate_adler32_scalar(
+	          &checksum,
+	          qcow_test_deflate_uncompressed_byte_stream,
+	          7640,
+	          1,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -2097,10 +2416,10 @@ int qcow_test_deflate_read_data_header(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_EQUAL_SIZE(
-	 "uncompressed_data_offset",
-	 uncompressed_data_offset,
-	 (size_t) 2 );
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "checksum",
+	 checksum,
+	 (uint32_t) 0x304a56a4UL );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
@@ -2108,13 +2427,441 @@ int qcow_test_deflate_read_data_header(
 
 	/* Test error cases
 	 */
-	uncompressed_data_offset = 0;
-
-	result = libqcow_deflate_read_data_header(
+	result = libqcow_deflate_calculate_adler32_scalar(
 	          NULL,
-	          2627,
-	          &uncompressed_data_offset,
-	          &error );
+	          qcow_test_deflate_uncompressed_byte_stream,
+	          7640,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_deflate_calculate_adler32_scalar(
+	          &checksum,
+	          NULL,
+	          7640,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_deflate_calculate_adler32_scalar(
+	          &checksum,
+	          qcow_test_deflate_uncompressed_byte_stream,
+	          (size_t) SSIZE_MAX + 1,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Compares an Adler-32 implementation with the scalar implementation on random data
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_compare_adler32_implementation(
+     int (*calculate_adler32)(
+            uint32_t *checksum_value,
+            const uint8_t *buffer,
+            size_t size,
+            uint32_t initial_value,
+            libcerror_error_t **error ) )
+{
+	size_t test_sizes[ 16 ] = {
+		0, 1, 15, 16, 17, 31, 32, 33, 63, 5535, 5536, 5552, 5553, 11104, 11137, 65536 };
+
+	uint32_t initial_values[ 3 ] = {
+		0x00000001UL, 0x12345678UL, 0xfff0fff0UL };
+
+	uint8_t *buffer            = NULL;
+	libcerror_error_t *error   = NULL;
+	size_t buffer_offset       = 0;
+	size_t size                = 0;
+	uint32_t checksum          = 0;
+	uint32_t expected_checksum = 0;
+	uint32_t random_value      = 1;
+	int initial_value_index    = 0;
+	int result                 = 0;
+	int size_index             = 0;
+
+	/* Initialize test
+	 */
+	buffer = (uint8_t *) memory_allocate(
+	                      65536 + 16 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "buffer",
+	 buffer );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 65536 + 16;
+	     buffer_offset++ )
+	{
+		random_value = ( random_value * 1103515245UL ) + 12345;
+
+		buffer[ buffer_offset ] = (uint8_t) ( random_value >> 16 );
+	}
+	/* Test regular cases
+	 */
+	for( size_index = 0;
+	     size_index < 16;
+	     size_index++ )
+	{
+		for( initial_value_index = 0;
+		     initial_value_index < 3;
+		     initial_value_index++ )
+		{
+			/* Test aligned and unaligned data
+			 */
+			for( buffer_offset = 0;
+			     buffer_offset < 4;
+			     buffer_offset += 3 )
+			{
+				result = libqcow_deflate_calculate_adler32_scalar(
+				          &expected_checksum,
+				          &( buffer[ buffer_offset ] ),
+				          test_sizes[ size_index ],
+				          initial_values[ initial_value_index ],
+				          &error );
+
+				QCOW_TEST_ASSERT_EQUAL_INT(
+				 "result",
+				 result,
+				 1 );
+
+				QCOW_TEST_ASSERT_IS_NULL(
+				 "error",
+				 error );
+
+				result = calculate_adler32(
+				          &checksum,
+				          &( buffer[ buffer_offset ] ),
+				          test_sizes[ size_index ],
+				          initial_values[ initial_value_index ],
+				          &error );
+
+				QCOW_TEST_ASSERT_EQUAL_INT(
+				 "result",
+				 result,
+				 1 );
+
+				QCOW_TEST_ASSERT_EQUAL_UINT32(
+				 "checksum",
+				 checksum,
+				 expected_checksum );
+
+				QCOW_TEST_ASSERT_IS_NULL(
+				 "error",
+				 error );
+			}
+		}
+	}
+	/* Test every size up to 4 blocks of 64 bytes at every offset within a 16-byte vector
+	 */
+	for( buffer_offset = 0;
+	     buffer_offset < 16;
+	     buffer_offset++ )
+	{
+		for( size = 0;
+		     size <= 256;
+		     size++ )
+		{
+			result = libqcow_deflate_calculate_adler32_scalar(
+			          &expected_checksum,
+			          &( buffer[ buffer_offset ] ),
+			          size,
+			          0x12345678UL,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			result = calculate_adler32(
+			          &checksum,
+			          &( buffer[ buffer_offset ] ),
+			          size,
+			          0x12345678UL,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+
+			QCOW_TEST_ASSERT_EQUAL_UINT32(
+			 "checksum",
+			 checksum,
+			 expected_checksum );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+		}
+	}
+	/* Test a buffer that only contains 0xff bytes, which has the largest intermediate values
+	 */
+	if( memory_set(
+	     buffer,
+	     0xff,
+	     65536 ) == NULL )
+	{
+		goto on_error;
+	}
+	result = libqcow_deflate_calculate_adler32_scalar(
+	          &expected_checksum,
+	          buffer,
+	          65536,
+	          0xfff0fff0UL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = calculate_adler32(
+	          &checksum,
+	          buffer,
+	          65536,
+	          0xfff0fff0UL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "checksum",
+	 checksum,
+	 expected_checksum );
+
+	/* Test error cases
+	 */
+	result = calculate_adler32(
+	          NULL,
+	          buffer,
+	          65536,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = calculate_adler32(
+	          &checksum,
+	          NULL,
+	          65536,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = calculate_adler32(
+	          &checksum,
+	          buffer,
+	          (size_t) SSIZE_MAX + 1,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	memory_free(
+	 buffer );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( buffer != NULL )
+	{
+		memory_free(
+		 buffer );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_deflate_calculate_adler32 function with the Adler-32 implementation supported by the CPU
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_calculate_adler32_implementation(
+     void )
+{
+	return( qcow_test_deflate_compare_adler32_implementation(
+	         libqcow_deflate_calculate_adler32 ) );
+}
+
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+
+/* Tests the libqcow_deflate_calculate_adler32_sse2 function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_calculate_adler32_sse2(
+     void )
+{
+	return( qcow_test_deflate_compare_adler32_implementation(
+	         libqcow_deflate_calculate_adler32_sse2 ) );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_SSE2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+
+/* Tests the libqcow_deflate_calculate_adler32_avx2 function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_calculate_adler32_avx2(
+     void )
+{
+	/* Only test AVX2 if the CPU supports it
+	 */
+	if( libqcow_deflate_get_adler32_implementation() != LIBQCOW_DEFLATE_ADLER32_IMPLEMENTATION_AVX2 )
+	{
+		return( 1 );
+	}
+	return( qcow_test_deflate_compare_adler32_implementation(
+	         libqcow_deflate_calculate_adler32_avx2 ) );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_AVX2 ) */
+
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+
+/* Tests the libqcow_deflate_calculate_adler32_neon function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_calculate_adler32_neon(
+     void )
+{
+	return( qcow_test_deflate_compare_adler32_implementation(
+	         libqcow_deflate_calculate_adler32_neon ) );
+}
+
+#endif /* defined( LIBQCOW_DEFLATE_HAVE_NEON ) */
+
+/* Tests the libqcow_deflate_read_data_header function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_read_data_header(
+     void )
+{
+	libcerror_error_t *error        = NULL;
+	size_t uncompressed_data_offset = 0;
+	int result                      = 0;
+
+	/* Test regular cases
+	 */
+	uncompressed_data_offset = 0;
+
+	result = libqcow_deflate_read_data_header(
+	          qcow_test_deflate_compressed_byte_stream,
+	          2627,
+	          &uncompressed_data_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "uncompressed_data_offset",
+	 uncompressed_data_offset,
+	 (size_t) 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	uncompressed_data_offset = 0;
+
+	result = libqcow_deflate_read_data_header(
+	          NULL,
+	          2627,
+	          &uncompressed_data_offset,
+	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
@@ -2627,6 +3374,83 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the throughput of the libqcow_deflate_decompress_zlib function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_deflate_decompress_zlib_throughput(
+     void )
+{
+	uint8_t uncompressed_data[ 8192 ];
+
+	libcerror_error_t *error      = NULL;
+	clock_t end_time              = 0;
+	clock_t start_time            = 0;
+	double elapsed_time           = 0.0;
+	size_t uncompressed_data_size = 0;
+	int iteration                 = 0;
+	int result                    = 0;
+
+	start_time = clock();
+
+	for( iteration = 0;
+	     iteration < QCOW_TEST_DEFLATE_THROUGHPUT_NUMBER_OF_ITERATIONS;
+	     iteration++ )
+	{
+		uncompressed_data_size = 8192;
+
+		result = libqcow_deflate_decompress_zlib(
+		          qcow_test_deflate_compressed_byte_stream,
+		          2627,
+		          uncompressed_data,
+		          &uncompressed_data_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_SIZE(
+		 "uncompressed_data_size",
+		 uncompressed_data_size,
+		 (size_t) 7640 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	end_time = clock();
+
+	result = memory_compare(
+	          uncompressed_data,
+	          qcow_test_deflate_uncompressed_byte_stream,
+	          7640 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	elapsed_time = (double) ( end_time - start_time ) / CLOCKS_PER_SEC;
+
+	if( elapsed_time > 0.0 )
+	{
+		fprintf(
+		 stdout,
+		 "libqcow_deflate_decompress_zlib throughput: %.1f MiB/s\n",
+		 ( (double) QCOW_TEST_DEFLATE_THROUGHPUT_NUMBER_OF_ITERATIONS * 7640.0 ) / ( elapsed_time * 1024.0 * 1024.0 ) );
+	}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 /* The main program
@@ -2662,6 +3486,10 @@ int main(
 	 "libqcow_deflate_huffman_table_construct",
 	 qcow_test_deflate_huffman_table_construct );
 
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_huffman_table_build_lookup_table",
+	 qcow_test_deflate_huffman_table_build_lookup_table );
+
 	QCOW_TEST_RUN(
 	 "libqcow_deflate_bit_stream_get_huffman_encoded_value",
 	 qcow_test_deflate_bit_stream_get_huffman_encoded_value );
@@ -2678,10 +3506,44 @@ int main(
 	 "libqcow_deflate_decode_huffman",
 	 qcow_test_deflate_decode_huffman );
 
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_get_adler32_implementation",
+	 qcow_test_deflate_get_adler32_implementation );
+
 	QCOW_TEST_RUN(
 	 "libqcow_deflate_calculate_adler32",
 	 qcow_test_deflate_calculate_adler32 );
 
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_calculate_adler32_scalar",
+	 qcow_test_deflate_calculate_adler32_scalar );
+
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_calculate_adler32_implementation",
+	 qcow_test_deflate_calculate_adler32_implementation );
+
+#if defined( LIBQCOW_DEFLATE_HAVE_SSE2 )
+
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_calculate_adler32_sse2",
+	 qcow_test_deflate_calculate_adler32_sse2 );
+
+#endif
+#if defined( LIBQCOW_DEFLATE_HAVE_AVX2 )
+
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_calculate_adler32_avx2",
+	 qcow_test_deflate_calculate_adler32_avx2 );
+
+#endif
+#if defined( LIBQCOW_DEFLATE_HAVE_NEON )
+
+	QCOW_TEST_RUN(
+	 "libqcow_deflate_calculate_adler32_neon",
+	 qcow_test_deflate_calculate_adler32_neon );
+
+#endif
+
 	QCOW_TEST_RUN(
 	 "libqcow_deflate_read_data_header",
 	 qcow_test_deflate_read_data_header );
@@ -2698,6 +3560,17 @@ int main(
 	 "libqcow_deflate_decompress_zlib",
 	 qcow_test_deflate_decompress_zlib );
 
+	/* The throughput is only measured on request, since it prints timing information
+	 * and its outcome depends on the system the tests run on
+	 */
+	if( getenv(
+	     "QCOW_TEST_BENCHMARK" ) != NULL )
+	{
+		QCOW_TEST_RUN(
+		 "libqcow_deflate_decompress_zlib_throughput",
+		 qcow_test_deflate_decompress_zlib_throughput );
+	}
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 	return( EXIT_SUCCESS );
@@ -0,0 +1,1327 @@
+/*
+ * Library encryption functions test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_encryption.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+uint8_t qcow_test_encryption_key[ 16 ] = {
+	0x73, 0x65, 0x63, 0x72, 0x65, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+/* Tests the libqcow_encryption_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_initialize(
+     void )
+{
+	libcerror_error_t *error              = NULL;
+	libqcow_encryption_context_t *context = NULL;
+	int result                            = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_encryption_free(
+	          &context,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_encryption_initialize(
+	          NULL,
+	          LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	context = (libqcow_encryption_context_t *) 0x12345678UL;
+
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC,
+	          &error );
+
+	context = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( context != NULL )
+	{
+		libqcow_encryption_free(
+		 &context,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_encryption_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_set_keys function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_set_keys(
+     void )
+{
+	libcerror_error_t *error              = NULL;
+	libqcow_encryption_context_t *context = NULL;
+	int result                            = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_encryption_set_keys(
+	          context,
+	          qcow_test_encryption_key,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_encryption_set_keys(
+	          NULL,
+	          qcow_test_encryption_key,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_encryption_set_keys(
+	          context,
+	          NULL,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_encryption_set_keys(
+	          context,
+	          qcow_test_encryption_key,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_encryption_free(
+	          &context,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( context != NULL )
+	{
+		libqcow_encryption_free(
+		 &context,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_get_aes_implementation function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_get_aes_implementation(
+     void )
+{
+	int implementation = 0;
+
+	/* Test regular cases
+	 */
+	implementation = libqcow_encryption_get_aes_implementation();
+
+	QCOW_TEST_ASSERT_GREATER_THAN_INT(
+	 "implementation",
+	 implementation,
+	 0 );
+
+	QCOW_TEST_ASSERT_LESS_THAN_INT(
+	 "implementation",
+	 implementation,
+	 4 );
+
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_crypt function using a specific AES implementation to decrypt
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_crypt_with_implementation(
+     int aes_implementation )
+{
+	uint8_t data[ 1024 ];
+	uint8_t encrypted_data[ 1024 ];
+	uint8_t original_data[ 1024 ];
+
+	libcerror_error_t *error              = NULL;
+	libqcow_encryption_context_t *context = NULL;
+	size_t data_index                     = 0;
+	int result                            = 0;
+
+	/* Initialize test
+	 */
+	for( data_index = 0;
+	     data_index < 1024;
+	     data_index++ )
+	{
+		original_data[ data_index ] = (uint8_t) ( ( data_index * 7 ) % 251 );
+	}
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_AES_128_CBC,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	context->aes_implementation = aes_implementation;
+
+	result = libqcow_encryption_set_keys(
+	          context,
+	          qcow_test_encryption_key,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT,
+	          original_data,
+	          1024,
+	          encrypted_data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          encrypted_data,
+	          1024 );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test regular cases
+	 */
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          1024,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          data,
+	          1024 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test decrypting in-place
+	 */
+	if( memory_copy(
+	     data,
+	     encrypted_data,
+	     1024 ) == NULL )
+	{
+		goto on_error;
+	}
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          data,
+	          1024,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          data,
+	          1024 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test encrypting in-place
+	 */
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT,
+	          data,
+	          1024,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          encrypted_data,
+	          data,
+	          1024 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_encryption_crypt(
+	          NULL,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          1024,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          -1,
+	          encrypted_data,
+	          1024,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          1000,
+	          data,
+	          1024,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          1024,
+	          data,
+	          512,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_encryption_free(
+	          &context,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( context != NULL )
+	{
+		libqcow_encryption_free(
+		 &context,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_crypt function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_crypt(
+     void )
+{
+	return( qcow_test_encryption_crypt_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC ) );
+}
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+/* Tests the libqcow_encryption_decrypt_aesni function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_decrypt_aesni(
+     void )
+{
+	/* Only test AES-NI if the CPU supports it
+	 */
+	if( libqcow_encryption_get_aes_implementation() == LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC )
+	{
+		return( 1 );
+	}
+	return( qcow_test_encryption_crypt_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI ) );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+/* Tests the libqcow_encryption_decrypt_vaes function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_decrypt_vaes(
+     void )
+{
+	/* Only test VAES if the CPU supports it
+	 */
+	if( libqcow_encryption_get_aes_implementation() != LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES )
+	{
+		return( 1 );
+	}
+	return( qcow_test_encryption_crypt_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES ) );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
+/* Tests the libqcow_encryption_set_keys function with the LUKS method
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_set_keys_luks(
+     void )
+{
+	uint8_t key[ 64 ];
+
+	libcerror_error_t *error              = NULL;
+	libqcow_encryption_context_t *context = NULL;
+	int result                            = 0;
+
+	/* Initialize test
+	 */
+	memory_set(
+	 key,
+	 0x5a,
+	 64 );
+
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_LUKS,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_encryption_set_keys(
+	          context,
+	          key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_encryption_set_keys(
+	          context,
+	          key,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_encryption_set_keys(
+	          context,
+	          key,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_encryption_free(
+	          &context,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( context != NULL )
+	{
+		libqcow_encryption_free(
+		 &context,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_crypt function with the LUKS method using a specific AES implementation to decrypt
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_crypt_xts_with_implementation(
+     int aes_implementation,
+     size_t key_size )
+{
+	uint8_t data[ 8192 ];
+	uint8_t encrypted_data[ 8192 ];
+	uint8_t key[ 64 ];
+	uint8_t original_data[ 8192 ];
+
+	/* The IEEE P1619 XTS-AES-128 test vector 2
+	 */
+	uint8_t expected_encrypted_data[ 32 ] = {
+		0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40, 0x38, 0xac, 0xef, 0x83, 0x8b,
+		0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4, 0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0 };
+
+	libcerror_error_t *error              = NULL;
+	libqcow_encryption_context_t *context = NULL;
+	size_t data_index                     = 0;
+	int result                            = 0;
+
+	/* Initialize test
+	 */
+	for( data_index = 0;
+	     data_index < 64;
+	     data_index++ )
+	{
+		key[ data_index ] = (uint8_t) ( ( data_index * 13 ) + 1 );
+	}
+	for( data_index = 0;
+	     data_index < 8192;
+	     data_index++ )
+	{
+		original_data[ data_index ] = (uint8_t) ( ( data_index * 7 ) % 251 );
+	}
+	result = libqcow_encryption_initialize(
+	          &context,
+	          LIBQCOW_ENCRYPTION_METHOD_LUKS,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	context->aes_implementation = aes_implementation;
+
+	/* Test the known encrypted data of the first 2 blocks of a sector
+	 */
+	memory_set(
+	 data,
+	 0x44,
+	 512 );
+
+	memory_set(
+	 encrypted_data,
+	 0x11,
+	 16 );
+
+	memory_set(
+	 &( encrypted_data[ 16 ] ),
+	 0x22,
+	 16 );
+
+	result = libqcow_encryption_set_keys(
+	          context,
+	          encrypted_data,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT,
+	          data,
+	          512,
+	          encrypted_data,
+	          512,
+	          0x3333333333ULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          expected_encrypted_data,
+	          encrypted_data,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          512,
+	          encrypted_data,
+	          512,
+	          0x3333333333ULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          data,
+	          encrypted_data,
+	          512 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test multiple sectors where the sector number crosses a 32-bit boundary
+	 */
+	result = libqcow_encryption_set_keys(
+	          context,
+	          key,
+	          key_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_ENCRYPT,
+	          original_data,
+	          8192,
+	          encrypted_data,
+	          8192,
+	          0xfffffffaUL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          encrypted_data,
+	          8192 );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test regular cases
+	 */
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          encrypted_data,
+	          8192,
+	          data,
+	          8192,
+	          0xfffffffaUL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          data,
+	          8192 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test decrypting in-place
+	 */
+	if( memory_copy(
+	     data,
+	     encrypted_data,
+	     8192 ) == NULL )
+	{
+		goto on_error;
+	}
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          data,
+	          8192,
+	          data,
+	          8192,
+	          0xfffffffaUL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          original_data,
+	          data,
+	          8192 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test decrypting a single sector
+	 */
+	result = libqcow_encryption_crypt(
+	          context,
+	          LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+	          &( encrypted_data[ 1024 ] ),
+	          512,
+	          data,
+	          512,
+	          0xfffffffcUL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          &( original_data[ 1024 ] ),
+	          data,
+	          512 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Clean up
+	 */
+	result = libqcow_encryption_free(
+	          &context,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "context",
+	 context );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( context != NULL )
+	{
+		libqcow_encryption_free(
+		 &context,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_encryption_crypt function with the LUKS method
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_crypt_xts(
+     void )
+{
+	if( qcow_test_encryption_crypt_xts_with_implementation(
+	     LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC,
+	     32 ) != 1 )
+	{
+		return( 0 );
+	}
+	return( qcow_test_encryption_crypt_xts_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC,
+	         64 ) );
+}
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+/* Tests the libqcow_encryption_decrypt_xts_aesni function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_decrypt_xts_aesni(
+     void )
+{
+	/* Only test AES-NI if the CPU supports it
+	 */
+	if( libqcow_encryption_get_aes_implementation() == LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_GENERIC )
+	{
+		return( 1 );
+	}
+	if( qcow_test_encryption_crypt_xts_with_implementation(
+	     LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI,
+	     32 ) != 1 )
+	{
+		return( 0 );
+	}
+	return( qcow_test_encryption_crypt_xts_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_AESNI,
+	         64 ) );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+/* Tests the libqcow_encryption_decrypt_xts_vaes function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_encryption_decrypt_xts_vaes(
+     void )
+{
+	/* Only test VAES if the CPU supports it
+	 */
+	if( libqcow_encryption_get_aes_implementation() != LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES )
+	{
+		return( 1 );
+	}
+	if( qcow_test_encryption_crypt_xts_with_implementation(
+	     LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES,
+	     32 ) != 1 )
+	{
+		return( 0 );
+	}
+	return( qcow_test_encryption_crypt_xts_with_implementation(
+	         LIBQCOW_ENCRYPTION_AES_IMPLEMENTATION_VAES,
+	         64 ) );
+}
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_initialize",
+	 qcow_test_encryption_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_free",
+	 qcow_test_encryption_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_set_keys",
+	 qcow_test_encryption_set_keys );
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_get_aes_implementation",
+	 qcow_test_encryption_get_aes_implementation );
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_crypt",
+	 qcow_test_encryption_crypt );
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_decrypt_aesni",
+	 qcow_test_encryption_decrypt_aesni );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_decrypt_vaes",
+	 qcow_test_encryption_decrypt_vaes );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_set_keys_luks",
+	 qcow_test_encryption_set_keys_luks );
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_crypt_xts",
+	 qcow_test_encryption_crypt_xts );
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_AESNI )
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_decrypt_xts_aesni",
+	 qcow_test_encryption_decrypt_xts_aesni );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_AESNI ) */
+
+#if defined( LIBQCOW_ENCRYPTION_HAVE_VAES )
+
+	QCOW_TEST_RUN(
+	 "libqcow_encryption_decrypt_xts_vaes",
+	 qcow_test_encryption_decrypt_xts_vaes );
+
+#endif /* defined( LIBQCOW_ENCRYPTION_HAVE_VAES ) */
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -20,6 +20,7 @@
  */
 
 #include <common.h>
+#include <byte_stream.h>
 #include <file_stream.h>
 #include <narrow_string.h>
 #include <system_string.h>
@@ -44,6 +45,7 @@
 #include "qcow_test_libbfio.h"
 #include "qcow_test_libcerror.h"
 #include "qcow_test_libcpath.h"
+#include "qcow_test_libcthreads.h"
 #include "qcow_test_libqcow.h"
 #include "qcow_test_macros.h"
 #include "qcow_test_memory.h"
@@ -61,6 +63,23 @@
 
 #define QCOW_TEST_FILE_READ_BUFFER_SIZE	4096
 
+#define QCOW_TEST_FILE_NUMBER_OF_THREADS	8
+
+/* The number of times the media is read to measure the concurrent read throughput
+ * The throughput is only measured if the QCOW_TEST_BENCHMARK environment variable is set
+ */
+#if !defined( QCOW_TEST_FILE_THROUGHPUT_NUMBER_OF_ITERATIONS )
+#define QCOW_TEST_FILE_THROUGHPUT_NUMBER_OF_ITERATIONS	16
+#endif
+
+#if !defined( SEEK_DATA )
+#define SEEK_DATA	3
+#endif
+
+#if !defined( SEEK_HOLE )
+#define SEEK_HOLE	4
+#endif
+
 #if !defined( LIBQCOW_HAVE_BFIO )
 
 LIBQCOW_EXTERN \
@@ -937,27 +956,29 @@ on_error:
 	return( 0 );
 }
 
-#if defined( HAVE_WIDE_CHARACTER_TYPE )
-
-/* Tests the libqcow_file_open_wide function
+/* Tests the libqcow_file_get_mapped_data_at_offset function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_open_wide(
+int qcow_test_file_get_mapped_data_at_offset(
      const system_character_t *source,
      const system_character_t *password )
 {
-	wchar_t wide_source[ 256 ];
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	char narrow_source[ 256 ];
 
 	libcerror_error_t *error = NULL;
 	libqcow_file_t *file     = NULL;
+	const uint8_t *data      = NULL;
+	size_t data_size         = 0;
 	size_t string_length     = 0;
+	ssize_t read_count       = 0;
 	int result               = 0;
 
 	/* Initialize test
 	 */
-	result = qcow_test_get_wide_source(
+	result = qcow_test_get_narrow_source(
 	          source,
-	          wide_source,
+	          narrow_source,
 	          256,
 	          &error );
 
@@ -1014,11 +1035,23 @@ int qcow_test_file_open_wide(
 	         "error",
 		 error );
 	}
-	/* Test open
-	 */
-	result = libqcow_file_open_wide(
+	result = libqcow_file_set_use_memory_map(
 	          file,
-	          wide_source,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open(
+	          file,
+	          narrow_source,
 	          LIBQCOW_OPEN_READ,
 	          &error );
 
@@ -1031,12 +1064,94 @@ int qcow_test_file_open_wide(
 	 "error",
 	 error );
 
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_mapped_data_at_offset(
+	          file,
+	          0,
+	          &data,
+	          &data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The data is only available if memory mapping is supported and
+	 * the first cluster block is allocated and not compressed
+	 */
+	if( result != 0 )
+	{
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "data",
+		 data );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_SSIZE(
+		 "data_size",
+		 (ssize_t) data_size,
+		 (ssize_t) 0 );
+
+		result = libqcow_file_get_utf8_backing_filename_size(
+		          file,
+		          &string_length,
+		          &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Reading a file with a backing file requires the parent file to be set
+		 */
+		if( result == 0 )
+		{
+			if( data_size > QCOW_TEST_FILE_READ_BUFFER_SIZE )
+			{
+				data_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+			}
+			read_count = libqcow_file_read_buffer_at_offset(
+			              file,
+			              buffer,
+			              data_size,
+			              0,
+			              &error );
+
+			QCOW_TEST_ASSERT_EQUAL_SSIZE(
+			 "read_count",
+			 read_count,
+			 (ssize_t) data_size );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			result = memory_compare(
+			          buffer,
+			          data,
+			          data_size );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 0 );
+		}
+	}
 	/* Test error cases
 	 */
-	result = libqcow_file_open_wide(
+	result = libqcow_file_get_mapped_data_at_offset(
 	          NULL,
-	          wide_source,
-	          LIBQCOW_OPEN_READ,
+	          0,
+	          &data,
+	          &data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1051,10 +1166,11 @@ int qcow_test_file_open_wide(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_open_wide(
+	result = libqcow_file_get_mapped_data_at_offset(
 	          file,
-	          NULL,
-	          LIBQCOW_OPEN_READ,
+	          -1,
+	          &data,
+	          &data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1069,10 +1185,11 @@ int qcow_test_file_open_wide(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_open_wide(
+	result = libqcow_file_get_mapped_data_at_offset(
 	          file,
-	          wide_source,
-	          -1,
+	          0,
+	          NULL,
+	          &data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1087,12 +1204,11 @@ int qcow_test_file_open_wide(
 	libcerror_error_free(
 	 &error );
 
-	/* Test open when already opened
-	 */
-	result = libqcow_file_open_wide(
+	result = libqcow_file_get_mapped_data_at_offset(
 	          file,
-	          wide_source,
-	          LIBQCOW_OPEN_READ,
+	          0,
+	          &data,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1109,6 +1225,19 @@ int qcow_test_file_open_wide(
 
 	/* Clean up
 	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
 	result = libqcow_file_free(
 	          &file,
 	          &error );
@@ -1143,56 +1272,30 @@ on_error:
 	return( 0 );
 }
 
-#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
 
-/* Tests the libqcow_file_open_file_io_handle function
+/* Tests the libqcow_file_open_wide function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_open_file_io_handle(
+int qcow_test_file_open_wide(
      const system_character_t *source,
      const system_character_t *password )
 {
-	libbfio_handle_t *file_io_handle = NULL;
-	libcerror_error_t *error         = NULL;
-	libqcow_file_t *file             = NULL;
-	size_t string_length             = 0;
-	int result                       = 0;
+	wchar_t wide_source[ 256 ];
+
+	libcerror_error_t *error = NULL;
+	libqcow_file_t *file     = NULL;
+	size_t string_length     = 0;
+	int result               = 0;
 
 	/* Initialize test
 	 */
-	result = libbfio_file_initialize(
-	          &file_io_handle,
-	          &error );
-
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file_io_handle",
-	 file_io_handle );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
-
-	string_length = system_string_length(
-	                 source );
-
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-	result = libbfio_file_set_name_wide(
-	          file_io_handle,
-	          source,
-	          string_length,
-	          &error );
-#else
-	result = libbfio_file_set_name(
-	          file_io_handle,
+	result = qcow_test_get_wide_source(
 	          source,
-	          string_length,
+	          wide_source,
+	          256,
 	          &error );
-#endif
+
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
@@ -1248,9 +1351,9 @@ int qcow_test_file_open_file_io_handle(
 	}
 	/* Test open
 	 */
-	result = libqcow_file_open_file_io_handle(
+	result = libqcow_file_open_wide(
 	          file,
-	          file_io_handle,
+	          wide_source,
 	          LIBQCOW_OPEN_READ,
 	          &error );
 
@@ -1265,9 +1368,9 @@ int qcow_test_file_open_file_io_handle(
 
 	/* Test error cases
 	 */
-	result = libqcow_file_open_file_io_handle(
+	result = libqcow_file_open_wide(
 	          NULL,
-	          file_io_handle,
+	          wide_source,
 	          LIBQCOW_OPEN_READ,
 	          &error );
 
@@ -1283,7 +1386,7 @@ int qcow_test_file_open_file_io_handle(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_open_file_io_handle(
+	result = libqcow_file_open_wide(
 	          file,
 	          NULL,
 	          LIBQCOW_OPEN_READ,
@@ -1301,9 +1404,9 @@ int qcow_test_file_open_file_io_handle(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_open_file_io_handle(
+	result = libqcow_file_open_wide(
 	          file,
-	          file_io_handle,
+	          wide_source,
 	          -1,
 	          &error );
 
@@ -1321,9 +1424,9 @@ int qcow_test_file_open_file_io_handle(
 
 	/* Test open when already opened
 	 */
-	result = libqcow_file_open_file_io_handle(
+	result = libqcow_file_open_wide(
 	          file,
-	          file_io_handle,
+	          wide_source,
 	          LIBQCOW_OPEN_READ,
 	          &error );
 
@@ -1358,23 +1461,6 @@ int qcow_test_file_open_file_io_handle(
 	 "error",
 	 error );
 
-	result = libbfio_handle_free(
-	          &file_io_handle,
-	          &error );
-
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "file_io_handle",
-	 file_io_handle );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
-
 	return( 1 );
 
 on_error:
@@ -1389,52 +1475,301 @@ on_error:
 		 &file,
 		 NULL );
 	}
-	if( file_io_handle != NULL )
-	{
-		libbfio_handle_free(
-		 &file_io_handle,
-		 NULL );
-	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_close function
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Tests the libqcow_file_open_file_io_handle function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_close(
-     void )
+int qcow_test_file_open_file_io_handle(
+     const system_character_t *source,
+     const system_character_t *password )
 {
-	libcerror_error_t *error = NULL;
-	int result               = 0;
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	size_t string_length             = 0;
+	int result                       = 0;
 
-	/* Test error cases
+	/* Initialize test
 	 */
-	result = libqcow_file_close(
-	          NULL,
+	result = libbfio_file_initialize(
+	          &file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	return( 1 );
-
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
+	string_length = system_string_length(
+	                 source );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libbfio_file_set_name_wide(
+	          file_io_handle,
+	          source,
+	          string_length,
+	          &error );
+#else
+	result = libbfio_file_set_name(
+	          file_io_handle,
+	          source,
+	          string_length,
+	          &error );
+#endif
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          NULL,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          NULL,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test open when already opened
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_close function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_close(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_file_close(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
 
 /* Tests the libqcow_file_open and libqcow_file_close functions
  * Returns 1 if successful or 0 if not
@@ -1714,6 +2049,208 @@ on_error:
 
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
+/* Tests the libqcow_internal_file_get_backing_range_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_get_backing_range_size(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	size64_t extent_size                   = 0;
+	size_t maximum_size                    = 0;
+	size_t range_size                      = 0;
+	off64_t offset                         = 0;
+	uint32_t extent_flags                  = 0;
+	int number_of_extents                  = 0;
+	int result                             = 0;
+
+	internal_file = (libqcow_internal_file_t *) file;
+
+	/* Test regular cases
+	 */
+	while( number_of_extents < 4096 )
+	{
+		result = libqcow_file_get_extent_at_offset(
+		          file,
+		          offset,
+		          &extent_size,
+		          &extent_flags,
+		          &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		if( result == 0 )
+		{
+			break;
+		}
+		if( extent_size > (size64_t) ( SSIZE_MAX - internal_file->cluster_block_size ) )
+		{
+			break;
+		}
+		/* The range stops at the end of an extent of cluster blocks that are not allocated
+		 */
+		maximum_size = (size_t) ( extent_size + internal_file->cluster_block_size );
+
+		result = libqcow_internal_file_get_backing_range_size(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          offset,
+		          maximum_size,
+		          &range_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		if( ( extent_flags & ( LIBQCOW_EXTENT_FLAG_IS_SPARSE | LIBQCOW_EXTENT_FLAG_IS_BACKING_FILE ) ) != 0 )
+		{
+			QCOW_TEST_ASSERT_EQUAL_SIZE(
+			 "range_size",
+			 range_size,
+			 (size_t) extent_size );
+
+			/* The range does not exceed the maximum size
+			 */
+			result = libqcow_internal_file_get_backing_range_size(
+			          internal_file,
+			          internal_file->file_io_handle,
+			          offset,
+			          1,
+			          &range_size,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			QCOW_TEST_ASSERT_EQUAL_SIZE(
+			 "range_size",
+			 range_size,
+			 (size_t) 1 );
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_SIZE(
+			 "range_size",
+			 range_size,
+			 (size_t) 0 );
+		}
+		offset += (off64_t) extent_size;
+
+		number_of_extents++;
+	}
+	/* Test error cases
+	 */
+	result = libqcow_internal_file_get_backing_range_size(
+	          NULL,
+	          internal_file->file_io_handle,
+	          0,
+	          512,
+	          &range_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_file_get_backing_range_size(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          -1,
+	          512,
+	          &range_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_file_get_backing_range_size(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          (size_t) SSIZE_MAX + 1,
+	          &range_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_file_get_backing_range_size(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          512,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_internal_file_read_buffer_from_file_io_handle function
  * Returns 1 if successful or 0 if not
  */
@@ -2045,31 +2582,29 @@ on_error:
 	return( 0 );
 }
 
-#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
-
-/* Tests the libqcow_file_read_buffer function
+/* Tests the libqcow_internal_file_read_cluster_block_data function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_read_buffer(
+int qcow_test_internal_file_read_cluster_block_data(
      libqcow_file_t *file )
 {
-	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
-
-	libcerror_error_t *error      = NULL;
-	time_t timestamp              = 0;
-	size64_t media_size           = 0;
-	size64_t remaining_media_size = 0;
-	size_t read_size              = 0;
-	ssize_t read_count            = 0;
-	off64_t offset                = 0;
-	off64_t read_offset           = 0;
-	int number_of_tests           = 1024;
-	int random_number             = 0;
-	int result                    = 0;
-	int test_number               = 0;
+	uint8_t buffer[ 512 ];
+
+	libcerror_error_t *error                 = NULL;
+	libqcow_internal_file_t *internal_file   = NULL;
+	size64_t media_size                      = 0;
+	uint64_t cluster_block_data_offset       = 0;
+	uint64_t cluster_block_file_offset       = 0;
+	uint64_t number_of_decompressed_clusters = 0;
+	off64_t cluster_offset                   = -1;
+	off64_t offset                           = 0;
+	uint8_t cluster_block_is_compressed      = 0;
+	uint8_t cluster_block_is_zero            = 0;
+	int number_of_clusters                   = 0;
+	int result                               = 0;
+
+	internal_file = (libqcow_internal_file_t *) file;
 
-	/* Determine size
-	 */
 	result = libqcow_file_get_media_size(
 	          file,
 	          &media_size,
@@ -2084,169 +2619,277 @@ int qcow_test_file_read_buffer(
 	 "error",
 	 error );
 
-	/* Reset offset to 0
-	 */
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
-	          &error );
-
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
-
-	/* Test regular cases
+	/* Find a compressed cluster block
 	 */
-	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
-
-	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
-	{
-		read_size = (size_t) media_size;
-	}
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
-
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) read_size );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
-
-	if( media_size > 8 )
+	for( offset = 0;
+	     ( offset < (off64_t) media_size ) && ( number_of_clusters < 4096 );
+	     offset += (off64_t) internal_file->cluster_block_size )
 	{
-		/* Set offset to media_size - 8
-		 */
-		offset = libqcow_file_seek_offset(
-		          file,
-		          -8,
-		          SEEK_END,
+		result = libqcow_internal_file_get_cluster_block_offset(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          offset,
+		          &cluster_block_file_offset,
+		          &cluster_block_data_offset,
+		          &cluster_block_is_compressed,
+		          &cluster_block_is_zero,
 		          &error );
 
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 (int64_t) media_size - 8 );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
 		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		/* Read buffer on media_size boundary
+		if( ( cluster_block_file_offset != 0 )
+		 && ( cluster_block_is_compressed != 0 ) )
+		{
+			cluster_offset = offset;
+
+			break;
+		}
+		number_of_clusters++;
+	}
+	if( cluster_offset >= 0 )
+	{
+		/* Test that reading a compressed cluster block in small pieces
+		 * inflates the cluster block at most once
 		 */
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+		number_of_decompressed_clusters = internal_file->number_of_decompressed_cluster_blocks;
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 8 );
+		for( offset = cluster_offset;
+		     ( offset < ( cluster_offset + (off64_t) internal_file->cluster_block_size ) )
+		     && ( ( offset + 512 ) <= (off64_t) media_size );
+		     offset += 512 )
+		{
+			result = libqcow_internal_file_read_cluster_block_data(
+			          internal_file,
+			          internal_file->file_io_handle,
+			          offset,
+			          buffer,
+			          512,
+			          &error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
 
-		/* Read buffer beyond media_size boundary
-		 */
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 0 );
+			if( offset == cluster_offset )
+			{
+				QCOW_TEST_ASSERT_LESS_THAN_UINT64(
+				 "number_of_decompressed_cluster_blocks",
+				 internal_file->number_of_decompressed_cluster_blocks,
+				 number_of_decompressed_clusters + 2 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+				number_of_decompressed_clusters = internal_file->number_of_decompressed_cluster_blocks;
+			}
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT64(
+		 "number_of_decompressed_cluster_blocks",
+		 internal_file->number_of_decompressed_cluster_blocks,
+		 number_of_decompressed_clusters );
 	}
-	/* Stress test read buffer
+	/* Test error cases
 	 */
-	timestamp = time(
-	             NULL );
-
-	srand(
-	 (unsigned int) timestamp );
-
-	offset = libqcow_file_seek_offset(
-	          file,
+	result = libqcow_internal_file_read_cluster_block_data(
+	          NULL,
+	          internal_file->file_io_handle,
 	          0,
-	          SEEK_SET,
+	          buffer,
+	          512,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	remaining_media_size = media_size;
+	libcerror_error_free(
+	 &error );
 
-	for( test_number = 0;
-	     test_number < number_of_tests;
-	     test_number++ )
+	result = libqcow_internal_file_read_cluster_block_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          NULL,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_file_read_cluster_block_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          buffer,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
 	{
-		random_number = rand();
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
 
-		QCOW_TEST_ASSERT_GREATER_THAN_INT(
-		 "random_number",
-		 random_number,
-		 -1 );
+/* Tests the libqcow_internal_file_read_contiguous_cluster_blocks_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_read_contiguous_cluster_blocks_data(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t expected_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error               = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	size64_t media_size                    = 0;
+	size_t read_size                       = 0;
+	ssize_t read_count                     = 0;
+	uint64_t cluster_block_data_offset     = 0;
+	uint64_t cluster_block_file_offset     = 0;
+	uint64_t previous_cluster_file_offset  = 0;
+	off64_t cluster_offset                 = -1;
+	off64_t offset                         = 0;
+	uint8_t cluster_block_is_compressed    = 0;
+	uint8_t cluster_block_is_zero          = 0;
+	int number_of_clusters                 = 0;
+	int result                             = 0;
+
+	internal_file = (libqcow_internal_file_t *) file;
 
-		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
 
-#if defined( QCOW_TEST_FILE_VERBOSE )
-		fprintf(
-		 stdout,
-		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
-		 read_offset,
-		 read_offset,
-		 read_size );
-#endif
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              read_size,
-		              &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-		if( read_size > remaining_media_size )
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test that reading within a single cluster block is left to the cluster block cache
+	 */
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          buffer,
+	          256,
+	          &read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Find 2 uncompressed cluster blocks that are contiguous in the file
+	 */
+	if( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		for( offset = 0;
+		     ( ( offset + (off64_t) QCOW_TEST_FILE_READ_BUFFER_SIZE ) < (off64_t) media_size ) && ( number_of_clusters < 4096 );
+		     offset += (off64_t) internal_file->cluster_block_size )
 		{
-			read_size = (size_t) remaining_media_size;
-		}
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) read_size );
+			result = libqcow_internal_file_get_cluster_block_offset(
+			          internal_file,
+			          internal_file->file_io_handle,
+			          offset,
+			          &cluster_block_file_offset,
+			          &cluster_block_data_offset,
+			          &cluster_block_is_compressed,
+			          &cluster_block_is_zero,
+			          &error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
 
-		read_offset += read_count;
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
 
-		result = libqcow_file_get_offset(
-		          file,
-		          &offset,
+			if( ( cluster_block_file_offset == 0 )
+			 || ( cluster_block_is_compressed != 0 ) )
+			{
+				previous_cluster_file_offset = 0;
+			}
+			else if( ( previous_cluster_file_offset != 0 )
+			      && ( cluster_block_file_offset == ( previous_cluster_file_offset + internal_file->cluster_block_size ) )
+			      && ( ( cluster_block_file_offset + QCOW_TEST_FILE_READ_BUFFER_SIZE ) <= internal_file->size ) )
+			{
+				cluster_offset = offset;
+
+				break;
+			}
+			else
+			{
+				previous_cluster_file_offset = cluster_block_file_offset;
+			}
+			number_of_clusters++;
+		}
+	}
+	if( cluster_offset >= 0 )
+	{
+		/* Test that a read that crosses the cluster block boundary is read in a single run
+		 */
+		offset = cluster_offset - 256;
+
+		result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          offset,
+		          buffer,
+		          QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		          &read_size,
 		          &error );
 
 		QCOW_TEST_ASSERT_EQUAL_INT(
@@ -2254,68 +2897,82 @@ int qcow_test_file_read_buffer(
 		 result,
 		 1 );
 
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 read_offset );
-
 		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		remaining_media_size -= read_count;
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "read_size",
+		 (int) read_size,
+		 256 );
 
-		if( remaining_media_size == 0 )
-		{
-			offset = libqcow_file_seek_offset(
-			          file,
-			          0,
-			          SEEK_SET,
-			          &error );
+		QCOW_TEST_ASSERT_LESS_THAN_INT(
+		 "read_size",
+		 (int) read_size,
+		 QCOW_TEST_FILE_READ_BUFFER_SIZE + 1 );
 
-			QCOW_TEST_ASSERT_EQUAL_INT64(
-			 "offset",
-			 offset,
-			 (int64_t) 0 );
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              expected_buffer,
+		              read_size,
+		              offset,
+		              &error );
 
-			QCOW_TEST_ASSERT_IS_NULL(
-			 "error",
-			 error );
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
 
-			read_offset = 0;
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
 
-			remaining_media_size = media_size;
-		}
+		result = memory_compare(
+		          buffer,
+		          expected_buffer,
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
 	}
-	/* Reset offset to 0
+	/* Test error cases
 	 */
-	offset = libqcow_file_seek_offset(
-	          file,
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          NULL,
+	          internal_file->file_io_handle,
 	          0,
-	          SEEK_SET,
+	          buffer,
+	          QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	          &read_size,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	read_count = libqcow_file_read_buffer(
-	              NULL,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	libcerror_error_free(
+	 &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          -1,
+	          buffer,
+	          QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	          &read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2324,16 +2981,19 @@ int qcow_test_file_read_buffer(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              NULL,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          NULL,
+	          QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	          &read_size,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2342,16 +3002,19 @@ int qcow_test_file_read_buffer(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              (size_t) SSIZE_MAX + 1,
-	              &error );
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          buffer,
+	          (size_t) SSIZE_MAX + 1,
+	          &read_size,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2360,65 +3023,26 @@ int qcow_test_file_read_buffer(
 	libcerror_error_free(
 	 &error );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK )
+	result = libqcow_internal_file_read_contiguous_cluster_blocks_data(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          0,
+	          buffer,
+	          QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	          NULL,
+	          &error );
 
-	/* Test libqcow_file_read_buffer with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
-	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
-
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
-
-	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
-
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
-
-		libcerror_error_free(
-		 &error );
-	}
-	/* Test libqcow_file_read_buffer with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
-
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
-
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -2431,10 +3055,12 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_file_read_buffer_at_offset function
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* Tests the libqcow_file_read_buffer function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_read_buffer_at_offset(
+int qcow_test_file_read_buffer(
      libqcow_file_t *file )
 {
 	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
@@ -2468,6 +3094,23 @@ int qcow_test_file_read_buffer_at_offset(
 	 "error",
 	 error );
 
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
 	/* Test regular cases
 	 */
 	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
@@ -2476,11 +3119,10 @@ int qcow_test_file_read_buffer_at_offset(
 	{
 		read_size = (size_t) media_size;
 	}
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer(
 	              file,
 	              buffer,
 	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2494,13 +3136,29 @@ int qcow_test_file_read_buffer_at_offset(
 
 	if( media_size > 8 )
 	{
+		/* Set offset to media_size - 8
+		 */
+		offset = libqcow_file_seek_offset(
+		          file,
+		          -8,
+		          SEEK_END,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 (int64_t) media_size - 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
 		/* Read buffer on media_size boundary
 		 */
-		read_count = libqcow_file_read_buffer_at_offset(
+		read_count = libqcow_file_read_buffer(
 		              file,
 		              buffer,
 		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              media_size - 8,
 		              &error );
 
 		QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2514,11 +3172,10 @@ int qcow_test_file_read_buffer_at_offset(
 
 		/* Read buffer beyond media_size boundary
 		 */
-		read_count = libqcow_file_read_buffer_at_offset(
+		read_count = libqcow_file_read_buffer(
 		              file,
 		              buffer,
 		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              media_size + 8,
 		              &error );
 
 		QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2538,6 +3195,23 @@ int qcow_test_file_read_buffer_at_offset(
 	srand(
 	 (unsigned int) timestamp );
 
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	remaining_media_size = media_size;
+
 	for( test_number = 0;
 	     test_number < number_of_tests;
 	     test_number++ )
@@ -2549,29 +3223,22 @@ int qcow_test_file_read_buffer_at_offset(
 		 random_number,
 		 -1 );
 
-		if( media_size > 0 )
-		{
-			read_offset = (off64_t) random_number % media_size;
-		}
 		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
 
 #if defined( QCOW_TEST_FILE_VERBOSE )
 		fprintf(
 		 stdout,
-		 "libqcow_file_read_buffer_at_offset: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
 		 read_offset,
 		 read_offset,
 		 read_size );
 #endif
-		read_count = libqcow_file_read_buffer_at_offset(
+		read_count = libqcow_file_read_buffer(
 		              file,
 		              buffer,
 		              read_size,
-		              read_offset,
 		              &error );
 
-		remaining_media_size = media_size - read_offset;
-
 		if( read_size > remaining_media_size )
 		{
 			read_size = (size_t) remaining_media_size;
@@ -2605,14 +3272,54 @@ int qcow_test_file_read_buffer_at_offset(
 		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
+
+		remaining_media_size -= read_count;
+
+		if( remaining_media_size == 0 )
+		{
+			offset = libqcow_file_seek_offset(
+			          file,
+			          0,
+			          SEEK_SET,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT64(
+			 "offset",
+			 offset,
+			 (int64_t) 0 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			read_offset = 0;
+
+			remaining_media_size = media_size;
+		}
 	}
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
 	/* Test error cases
 	 */
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer(
 	              NULL,
 	              buffer,
 	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2627,11 +3334,10 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer(
 	              file,
 	              NULL,
 	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2646,11 +3352,10 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer(
 	              file,
 	              buffer,
 	              (size_t) SSIZE_MAX + 1,
-	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
@@ -2665,41 +3370,49 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_read_buffer with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer(
 	              file,
 	              buffer,
 	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              -1,
 	              &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
-
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
-
-	libcerror_error_free(
-	 &error );
+	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK )
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
 
-	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_file_read_buffer with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
 	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
 
-	read_count = libqcow_file_read_buffer_at_offset(
+	read_count = libqcow_file_read_buffer(
 	              file,
 	              buffer,
 	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
 	              &error );
 
-	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
 	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
 	}
 	else
 	{
@@ -2712,39 +3425,6033 @@ int qcow_test_file_read_buffer_at_offset(
 		 "error",
 		 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_read_buffer_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error      = NULL;
+	time_t timestamp              = 0;
+	size64_t media_size           = 0;
+	size64_t remaining_media_size = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t offset                = 0;
+	off64_t read_offset           = 0;
+	int number_of_tests           = 1024;
+	int random_number             = 0;
+	int result                    = 0;
+	int test_number               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size > 8 )
+	{
+		/* Read buffer on media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size - 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer beyond media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size + 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Stress test read buffer
+	 */
+	timestamp = time(
+	             NULL );
+
+	srand(
+	 (unsigned int) timestamp );
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		random_number = rand();
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "random_number",
+		 random_number,
+		 -1 );
+
+		if( media_size > 0 )
+		{
+			read_offset = (off64_t) random_number % media_size;
+		}
+		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+#if defined( QCOW_TEST_FILE_VERBOSE )
+		fprintf(
+		 stdout,
+		 "libqcow_file_read_buffer_at_offset: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+		 read_offset,
+		 read_offset,
+		 read_size );
+#endif
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              read_size,
+		              read_offset,
+		              &error );
+
+		remaining_media_size = media_size - read_offset;
+
+		if( read_size > remaining_media_size )
+		{
+			read_size = (size_t) remaining_media_size;
+		}
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		read_offset += read_count;
+
+		result = libqcow_file_get_offset(
+		          file,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 read_offset );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              -1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+/* The concurrent read thread arguments
+ */
+typedef struct qcow_test_file_read_thread_arguments qcow_test_file_read_thread_arguments_t;
+
+struct qcow_test_file_read_thread_arguments
+{
+	/* The file
+	 */
+	libqcow_file_t *file;
+
+	/* The media size
+	 */
+	size64_t media_size;
+
+	/* The pseudo random seed
+	 */
+	uint32_t seed;
+
+	/* The thread index
+	 */
+	int thread_index;
+
+	/* The number of bytes read
+	 */
+	size64_t number_of_bytes_read;
+};
+
+/* Reads random ranges concurrently and compares them against a serialized read
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent_thread(
+     qcow_test_file_read_thread_arguments_t *thread_arguments )
+{
+	uint8_t concurrent_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t serialized_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error  = NULL;
+	size_t read_size          = 0;
+	ssize_t read_count        = 0;
+	ssize_t serialized_count  = 0;
+	off64_t read_offset       = 0;
+	uint32_t random_number    = 0;
+	int number_of_tests       = 256;
+	int result                = 0;
+	int test_number           = 0;
+
+	random_number = thread_arguments->seed;
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		/* Use a linear congruential generator since rand() is not thread-safe
+		 */
+		random_number = ( random_number * 1103515245UL ) + 12345UL;
+
+		read_offset = 0;
+
+		if( thread_arguments->media_size > 0 )
+		{
+			read_offset = (off64_t) ( ( (size64_t) random_number << 9 ) % thread_arguments->media_size );
+		}
+		read_size = (size_t) ( random_number >> 16 ) % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+		read_count = libqcow_file_read_buffer_at_offset_concurrent(
+		              thread_arguments->file,
+		              concurrent_buffer,
+		              read_size,
+		              read_offset,
+		              &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		serialized_count = libqcow_file_read_buffer_at_offset(
+		                    thread_arguments->file,
+		                    serialized_buffer,
+		                    read_size,
+		                    read_offset,
+		                    &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "serialized_count",
+		 serialized_count,
+		 read_count );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          concurrent_buffer,
+		          serialized_buffer,
+		          (size_t) read_count );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		thread_arguments->number_of_bytes_read += (size64_t) read_count;
+	}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW ) */
+
+/* Tests the libqcow_file_read_buffer_at_offset_concurrent function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+	qcow_test_file_read_thread_arguments_t thread_arguments[ QCOW_TEST_FILE_NUMBER_OF_THREADS ];
+	libcthreads_thread_t *threads[ QCOW_TEST_FILE_NUMBER_OF_THREADS ];
+
+	size64_t number_of_bytes_read = 0;
+	int thread_index              = 0;
+#endif
+
+	libcerror_error_t *error      = NULL;
+	size64_t media_size           = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t current_offset        = 0;
+	off64_t offset                = 0;
+	int result                    = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &current_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size > 8 )
+	{
+		/* Read buffer on media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset_concurrent(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size - 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer beyond media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset_concurrent(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size + 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* The current offset should not have changed
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 current_offset );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+	/* Test concurrent reads from multiple threads
+	 */
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+	     thread_index++ )
+	{
+		thread_arguments[ thread_index ].file                 = file;
+		thread_arguments[ thread_index ].media_size           = media_size;
+		thread_arguments[ thread_index ].seed                 = (uint32_t) ( thread_index + 1 ) * 2654435761UL;
+		thread_arguments[ thread_index ].thread_index         = thread_index;
+		thread_arguments[ thread_index ].number_of_bytes_read = 0;
+
+		threads[ thread_index ] = NULL;
+	}
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+	     thread_index++ )
+	{
+		result = libcthreads_thread_create(
+		          &( threads[ thread_index ] ),
+		          NULL,
+		          (int (*)(void *)) &qcow_test_file_read_buffer_at_offset_concurrent_thread,
+		          (void *) &( thread_arguments[ thread_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+	     thread_index++ )
+	{
+		result = libcthreads_thread_join(
+		          &( threads[ thread_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		number_of_bytes_read += thread_arguments[ thread_index ].number_of_bytes_read;
+	}
+#if defined( QCOW_TEST_FILE_VERBOSE )
+	fprintf(
+	 stdout,
+	 "libqcow_file_read_buffer_at_offset_concurrent: %d threads read: %" PRIu64 " bytes\n",
+	 QCOW_TEST_FILE_NUMBER_OF_THREADS,
+	 number_of_bytes_read );
+#endif
+#endif /* defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW ) */
+
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              -1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_read_buffer_at_offset_concurrent with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
+	 */
+	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_file_read_buffer_at_offset_concurrent with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+/* Reads the part of the media assigned to the thread
+ * The media is divided in blocks that are assigned to the threads in turn
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent_throughput_thread(
+     qcow_test_file_read_thread_arguments_t *thread_arguments )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error = NULL;
+	ssize_t read_count       = 0;
+	off64_t read_offset      = 0;
+	int iteration            = 0;
+
+	for( iteration = 0;
+	     iteration < QCOW_TEST_FILE_THROUGHPUT_NUMBER_OF_ITERATIONS;
+	     iteration++ )
+	{
+		for( read_offset = (off64_t) thread_arguments->thread_index * QCOW_TEST_FILE_READ_BUFFER_SIZE;
+		     (size64_t) read_offset < thread_arguments->media_size;
+		     read_offset += (off64_t) QCOW_TEST_FILE_NUMBER_OF_THREADS * QCOW_TEST_FILE_READ_BUFFER_SIZE )
+		{
+			read_count = libqcow_file_read_buffer_at_offset_concurrent(
+			              thread_arguments->file,
+			              buffer,
+			              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+			              read_offset,
+			              &error );
+
+			QCOW_TEST_ASSERT_NOT_EQUAL_SSIZE(
+			 "read_count",
+			 read_count,
+			 (ssize_t) -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			thread_arguments->number_of_bytes_read += (size64_t) read_count;
+		}
+	}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the throughput of the libqcow_file_read_buffer_at_offset_concurrent function
+ * The media is read by a single thread and by multiple threads and the throughput of both is printed
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent_throughput(
+     libqcow_file_t *file )
+{
+	qcow_test_file_read_thread_arguments_t thread_arguments[ QCOW_TEST_FILE_NUMBER_OF_THREADS ];
+	libcthreads_thread_t *threads[ QCOW_TEST_FILE_NUMBER_OF_THREADS ];
+	double elapsed_times[ 2 ];
+
+	struct timeval end_time;
+	struct timeval start_time;
+
+	libcerror_error_t *error      = NULL;
+	size64_t media_size           = 0;
+	size64_t number_of_bytes_read = 0;
+	int number_of_threads         = 0;
+	int result                    = 0;
+	int run_index                 = 0;
+	int thread_index              = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Both runs read the same blocks, first from a single thread and then from multiple threads
+	 * The elapsed time is measured as wall clock time since clock() adds up the time of all threads
+	 */
+	for( run_index = 0;
+	     run_index < 2;
+	     run_index++ )
+	{
+		number_of_threads = ( run_index == 0 ) ? 1 : QCOW_TEST_FILE_NUMBER_OF_THREADS;
+
+		for( thread_index = 0;
+		     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+		     thread_index++ )
+		{
+			thread_arguments[ thread_index ].file                 = file;
+			thread_arguments[ thread_index ].media_size           = media_size;
+			thread_arguments[ thread_index ].seed                 = 0;
+			thread_arguments[ thread_index ].thread_index         = thread_index;
+			thread_arguments[ thread_index ].number_of_bytes_read = 0;
+
+			threads[ thread_index ] = NULL;
+		}
+		gettimeofday(
+		 &start_time,
+		 NULL );
+
+		if( number_of_threads == 1 )
+		{
+			/* A single thread reads the blocks of all threads in turn
+			 */
+			for( thread_index = 0;
+			     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+			     thread_index++ )
+			{
+				result = qcow_test_file_read_buffer_at_offset_concurrent_throughput_thread(
+				          &( thread_arguments[ thread_index ] ) );
+
+				QCOW_TEST_ASSERT_EQUAL_INT(
+				 "result",
+				 result,
+				 1 );
+			}
+		}
+		else
+		{
+			for( thread_index = 0;
+			     thread_index < number_of_threads;
+			     thread_index++ )
+			{
+				result = libcthreads_thread_create(
+				          &( threads[ thread_index ] ),
+				          NULL,
+				          (int (*)(void *)) &qcow_test_file_read_buffer_at_offset_concurrent_throughput_thread,
+				          (void *) &( thread_arguments[ thread_index ] ),
+				          &error );
+
+				QCOW_TEST_ASSERT_EQUAL_INT(
+				 "result",
+				 result,
+				 1 );
+
+				QCOW_TEST_ASSERT_IS_NULL(
+				 "error",
+				 error );
+			}
+			for( thread_index = 0;
+			     thread_index < number_of_threads;
+			     thread_index++ )
+			{
+				result = libcthreads_thread_join(
+				          &( threads[ thread_index ] ),
+				          &error );
+
+				QCOW_TEST_ASSERT_EQUAL_INT(
+				 "result",
+				 result,
+				 1 );
+
+				QCOW_TEST_ASSERT_IS_NULL(
+				 "error",
+				 error );
+			}
+		}
+		gettimeofday(
+		 &end_time,
+		 NULL );
+
+		elapsed_times[ run_index ] = (double) ( end_time.tv_sec - start_time.tv_sec )
+		                           + ( (double) ( end_time.tv_usec - start_time.tv_usec ) / 1000000.0 );
+
+		number_of_bytes_read = 0;
+
+		for( thread_index = 0;
+		     thread_index < QCOW_TEST_FILE_NUMBER_OF_THREADS;
+		     thread_index++ )
+		{
+			number_of_bytes_read += thread_arguments[ thread_index ].number_of_bytes_read;
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT64(
+		 "number_of_bytes_read",
+		 (uint64_t) number_of_bytes_read,
+		 (uint64_t) media_size * QCOW_TEST_FILE_THROUGHPUT_NUMBER_OF_ITERATIONS );
+
+		if( elapsed_times[ run_index ] > 0.0 )
+		{
+			fprintf(
+			 stdout,
+			 "libqcow_file_read_buffer_at_offset_concurrent throughput with %d thread(s): %.1f MiB/s\n",
+			 number_of_threads,
+			 (double) number_of_bytes_read / ( elapsed_times[ run_index ] * 1024.0 * 1024.0 ) );
+		}
+	}
+	if( elapsed_times[ 1 ] > 0.0 )
+	{
+		fprintf(
+		 stdout,
+		 "libqcow_file_read_buffer_at_offset_concurrent speed-up with %d threads: %.2f\n",
+		 QCOW_TEST_FILE_NUMBER_OF_THREADS,
+		 elapsed_times[ 0 ] / elapsed_times[ 1 ] );
+	}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	for( thread_index = 0;
+	     thread_index < number_of_threads;
+	     thread_index++ )
+	{
+		if( threads[ thread_index ] != NULL )
+		{
+			libcthreads_thread_join(
+			 &( threads[ thread_index ] ),
+			 NULL );
+		}
+	}
+	return( 0 );
+}
+
+#endif /* defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW ) */
+
+/* Tests the libqcow_file_read_vectors function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_vectors(
+     libqcow_file_t *file )
+{
+	uint8_t expected_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t vector_buffers[ 4 ][ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libqcow_read_vector_t read_vectors[ 4 ];
+
+	libcerror_error_t *error = NULL;
+	size64_t media_size      = 0;
+	ssize_t read_count       = 0;
+	int number_of_tests      = 256;
+	int random_number        = 0;
+	int result               = 0;
+	int test_number          = 0;
+	int vector_index         = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Read vectors in descending order, on the media_size boundary and beyond it
+	 */
+	for( vector_index = 0;
+	     vector_index < 4;
+	     vector_index++ )
+	{
+		read_vectors[ vector_index ].offset      = (off64_t) ( 3 - vector_index ) * QCOW_TEST_FILE_READ_BUFFER_SIZE;
+		read_vectors[ vector_index ].buffer      = vector_buffers[ vector_index ];
+		read_vectors[ vector_index ].buffer_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+		read_vectors[ vector_index ].read_count  = 0;
+	}
+	if( media_size > 8 )
+	{
+		read_vectors[ 2 ].offset = (off64_t) media_size - 8;
+		read_vectors[ 3 ].offset = (off64_t) media_size + 8;
+	}
+	/* Stress test read vectors
+	 */
+	srand(
+	 (unsigned int) time(
+	                 NULL ) );
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		if( test_number > 0 )
+		{
+			for( vector_index = 0;
+			     vector_index < 4;
+			     vector_index++ )
+			{
+				random_number = rand();
+
+				QCOW_TEST_ASSERT_GREATER_THAN_INT(
+				 "random_number",
+				 random_number,
+				 -1 );
+
+				if( media_size > 0 )
+				{
+					read_vectors[ vector_index ].offset = (off64_t) random_number % media_size;
+				}
+				read_vectors[ vector_index ].buffer_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+			}
+		}
+		result = libqcow_file_read_vectors(
+		          file,
+		          read_vectors,
+		          4,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		for( vector_index = 0;
+		     vector_index < 4;
+		     vector_index++ )
+		{
+			read_count = libqcow_file_read_buffer_at_offset(
+			              file,
+			              expected_buffer,
+			              read_vectors[ vector_index ].buffer_size,
+			              read_vectors[ vector_index ].offset,
+			              &error );
+
+			QCOW_TEST_ASSERT_EQUAL_SSIZE(
+			 "read_count",
+			 read_vectors[ vector_index ].read_count,
+			 read_count );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			result = memory_compare(
+			          vector_buffers[ vector_index ],
+			          expected_buffer,
+			          (size_t) read_count );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 0 );
+		}
+	}
+	/* Test error cases
+	 */
+	read_vectors[ 0 ].offset      = 0;
+	read_vectors[ 0 ].buffer_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	result = libqcow_file_read_vectors(
+	          NULL,
+	          read_vectors,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          NULL,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_vectors[ 1 ].offset      = 0;
+	read_vectors[ 1 ].buffer      = NULL;
+	read_vectors[ 1 ].buffer_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_vectors[ 0 ].read_count",
+	 read_vectors[ 0 ].read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_vectors[ 1 ].buffer      = vector_buffers[ 1 ];
+	read_vectors[ 1 ].buffer_size = (size_t) SSIZE_MAX + 1;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_vectors[ 1 ].offset      = -1;
+	read_vectors[ 1 ].buffer_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	/* Test libqcow_file_read_vectors with malloc failing
+	 */
+	qcow_test_malloc_attempts_before_fail = 0;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          1,
+	          &error );
+
+	if( qcow_test_malloc_attempts_before_fail != -1 )
+	{
+		qcow_test_malloc_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_read_vectors with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
+	 */
+	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          1,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Creates the data of a version 3 image
+ * The image has a level 1 table with 1 entry in the second cluster block, a reference count table
+ * in the third cluster block and uses 16-bit reference counts. The level 1 table entry refers to
+ * the level 2 table and the reference count table entry to the reference count block, when their
+ * offset is not 0. The reference count block contains a reference count of 1 for every cluster block
+ * of the data.
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_initialize_image_data(
+     uint8_t *data,
+     size_t data_size,
+     uint32_t number_of_cluster_block_bits,
+     size64_t media_size,
+     uint64_t incompatible_feature_flags,
+     uint64_t level2_table_offset,
+     uint64_t reference_count_block_offset )
+{
+	size_t cluster_block_size = 0;
+	size_t data_offset        = 0;
+	int result                = 0;
+
+	cluster_block_size = (size_t) 1 << number_of_cluster_block_bits;
+
+	result = memory_set(
+	          data,
+	          0,
+	          data_size ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 0 ] ),
+	 0x514649fbUL );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 4 ] ),
+	 3 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 20 ] ),
+	 number_of_cluster_block_bits );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 24 ] ),
+	 (uint64_t) media_size );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 36 ] ),
+	 1 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 40 ] ),
+	 (uint64_t) cluster_block_size );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 48 ] ),
+	 (uint64_t) ( 2 * cluster_block_size ) );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 56 ] ),
+	 1 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 72 ] ),
+	 incompatible_feature_flags );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 96 ] ),
+	 4 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 100 ] ),
+	 104 );
+
+	if( level2_table_offset != 0 )
+	{
+		byte_stream_copy_from_uint64_big_endian(
+		 &( data[ cluster_block_size ] ),
+		 level2_table_offset | 0x8000000000000000ULL );
+	}
+	if( reference_count_block_offset != 0 )
+	{
+		byte_stream_copy_from_uint64_big_endian(
+		 &( data[ 2 * cluster_block_size ] ),
+		 reference_count_block_offset );
+
+		for( data_offset = 0;
+		     data_offset < data_size;
+		     data_offset += cluster_block_size )
+		{
+			byte_stream_copy_from_uint16_big_endian(
+			 &( data[ reference_count_block_offset + ( ( data_offset / cluster_block_size ) * 2 ) ] ),
+			 1 );
+		}
+	}
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+/* Tests reading cluster blocks that read as zero
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_zero_cluster_blocks(
+     void )
+{
+	uint8_t data[ 3072 ];
+	uint8_t buffer[ 2048 ];
+
+	libqcow_read_vector_t read_vectors[ 2 ];
+
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	size64_t extent_size             = 0;
+	off64_t offset                   = 0;
+	uint64_t number_of_evictions     = 0;
+	uint64_t number_of_hits          = 0;
+	uint64_t number_of_misses        = 0;
+	ssize_t read_count               = 0;
+	size_t buffer_offset             = 0;
+	uint32_t extent_flags            = 0;
+	uint8_t expected_byte            = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 * The image uses 512 byte cluster blocks and contains:
+	 * a level 1 table at offset 512, a reference count table at offset 1024,
+	 * a level 2 table at offset 1536 and cluster blocks at offsets 2048 and 2560.
+	 * The level 2 table contains an allocated cluster block, a zero cluster block
+	 * without an offset, a zero cluster block with a preallocated offset
+	 * and a sparse cluster block.
+	 */
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          3072,
+	          9,
+	          2048,
+	          0,
+	          1536,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 0x8000000000000800ULL );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1544 ] ),
+	 0x0000000000000001ULL );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1552 ] ),
+	 0x8000000000000a01ULL );
+
+	result = memory_set(
+	          &( data[ 2048 ] ),
+	          0x5a,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = memory_set(
+	          &( data[ 2560 ] ),
+	          0xff,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          3072,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              2048,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 2048 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 2048;
+	     buffer_offset++ )
+	{
+		expected_byte = ( buffer_offset < 512 ) ? 0x5a : 0x00;
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Test that the cluster blocks that read as zero are not read into the cluster block cache
+	 */
+	result = libqcow_file_get_cache_statistics(
+	          file,
+	          LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "number_of_misses",
+	 number_of_misses,
+	 (uint64_t) 1 );
+
+	/* Test reading cluster blocks that read as zero with read vectors
+	 */
+	result = memory_set(
+	          buffer,
+	          0xaa,
+	          2048 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	read_vectors[ 0 ].offset      = 1280;
+	read_vectors[ 0 ].buffer      = buffer;
+	read_vectors[ 0 ].buffer_size = 768;
+	read_vectors[ 0 ].read_count  = 0;
+
+	read_vectors[ 1 ].offset      = 256;
+	read_vectors[ 1 ].buffer      = &( buffer[ 768 ] );
+	read_vectors[ 1 ].buffer_size = 768;
+	read_vectors[ 1 ].read_count  = 0;
+
+	result = libqcow_file_read_vectors(
+	          file,
+	          read_vectors,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_vectors[ 0 ].read_count",
+	 read_vectors[ 0 ].read_count,
+	 (ssize_t) 768 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_vectors[ 1 ].read_count",
+	 read_vectors[ 1 ].read_count,
+	 (ssize_t) 768 );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1536;
+	     buffer_offset++ )
+	{
+		expected_byte = ( ( buffer_offset >= 768 ) && ( buffer_offset < 1024 ) ) ? 0x5a : 0x00;
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Test the extents of the cluster blocks
+	 */
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          256,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 256 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "extent_flags",
+	 extent_flags,
+	 (uint32_t) 0 );
+
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          512,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 1024 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "extent_flags",
+	 extent_flags,
+	 (uint32_t) LIBQCOW_EXTENT_FLAG_IS_ZERO );
+
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          1536,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 512 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "extent_flags",
+	 extent_flags,
+	 (uint32_t) LIBQCOW_EXTENT_FLAG_IS_SPARSE );
+
+	/* Test seeking data and holes
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_HOLE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 512 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          256,
+	          SEEK_DATA,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 256 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          512,
+	          SEEK_DATA,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests reading subclusters of extended level 2 table entries
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_extended_level2_entries(
+     void )
+{
+	uint8_t buffer[ 3072 ];
+
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	uint8_t *data                    = NULL;
+	ssize_t read_count               = 0;
+	size_t buffer_offset             = 0;
+	size_t subcluster_index          = 0;
+	uint8_t expected_byte            = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 * The image uses 16384 byte cluster blocks with 512 byte subclusters and contains:
+	 * a level 1 table at offset 16384, a reference count table at offset 32768,
+	 * a level 2 table at offset 49152 and a cluster block at offset 65536.
+	 * The first level 2 table entry contains allocated subclusters 0, 1 and 4,
+	 * zero subcluster 2 and unallocated subclusters. Every subcluster
+	 * in the cluster block is filled with a distinct non-zero value.
+	 */
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * 81920 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          81920,
+	          14,
+	          32768,
+	          0x0000000000000010ULL,
+	          49152,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 49152 ] ),
+	 0x8000000000010000ULL );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 49160 ] ),
+	 0x0000000400000013ULL );
+
+	for( subcluster_index = 0;
+	     subcluster_index < 32;
+	     subcluster_index++ )
+	{
+		result = memory_set(
+		          &( data[ 65536 + ( subcluster_index * 512 ) ] ),
+		          (int) ( 0x10 + subcluster_index ),
+		          512 ) != NULL;
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+	}
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          81920,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              3072,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 3072 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 3072;
+	     buffer_offset++ )
+	{
+		subcluster_index = buffer_offset / 512;
+
+		if( ( subcluster_index == 0 )
+		 || ( subcluster_index == 1 )
+		 || ( subcluster_index == 4 ) )
+		{
+			expected_byte = (uint8_t) ( 0x10 + subcluster_index );
+		}
+		else
+		{
+			expected_byte = 0x00;
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Test reading a range that starts within an allocated subcluster
+	 * and ends within an unallocated subcluster
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              768,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		expected_byte = ( buffer_offset < 256 ) ? 0x11 : 0x00;
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Test reading a sparse cluster block
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              16384,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 0x00 );
+	}
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 data );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
+	return( 0 );
+}
+
+/* Tests reading cluster blocks from an external data file
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_external_data_file(
+     void )
+{
+	uint8_t buffer[ 1024 ];
+	uint8_t data[ 2048 ];
+	uint8_t data_file_data[ 1536 ];
+
+	libbfio_handle_t *data_file_io_handle = NULL;
+	libbfio_handle_t *file_io_handle      = NULL;
+	libcerror_error_t *error              = NULL;
+	libqcow_file_t *file                  = NULL;
+	ssize_t read_count                    = 0;
+	size_t buffer_offset                  = 0;
+	uint8_t expected_byte                 = 0;
+	int result                            = 0;
+
+	/* Initialize test
+	 * The image uses 512 byte cluster blocks and an external data file and contains:
+	 * a level 1 table at offset 512, a reference count table at offset 1024
+	 * and a level 2 table at offset 1536. The first level 2 table entry
+	 * refers to offset 1024 in the data file, the other entries are sparse.
+	 * The data file contains 1024 bytes of 0x11 followed by 512 bytes of 0x22.
+	 */
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          2048,
+	          9,
+	          2048,
+	          0x0000000000000004ULL,
+	          1536,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 0x8000000000000400ULL );
+
+	result = memory_set(
+	          data_file_data,
+	          0x11,
+	          1024 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = memory_set(
+	          &( data_file_data[ 1024 ] ),
+	          0x22,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          2048,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_open_file_io_handle(
+	          &data_file_io_handle,
+	          data_file_data,
+	          1536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data_file_io_handle",
+	 data_file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 * Reading without a data file IO handle fails
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              512,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test regular cases
+	 * The cluster block data is read from the data file offset in the level 2 table entry
+	 */
+	result = libqcow_file_set_data_file_io_handle(
+	          file,
+	          data_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		expected_byte = ( buffer_offset < 512 ) ? 0x22 : 0x00;
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test reading from a raw data file
+	 * The level 2 table is not used and the media offset is the data file offset,
+	 * data beyond the end of the data file reads as zero
+	 */
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 88 ] ),
+	 (uint64_t) 0x0000000000000002ULL );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_set_data_file_io_handle(
+	          file,
+	          data_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 0x11 );
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              1024,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		expected_byte = ( buffer_offset < 512 ) ? 0x22 : 0x00;
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &data_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( data_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &data_file_io_handle,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests reading unallocated cluster blocks from a raw parent file
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_raw_parent_file(
+     void )
+{
+	uint8_t buffer[ 2048 ];
+	uint8_t data[ 2560 ];
+	uint8_t parent_data[ 1280 ];
+
+	libbfio_handle_t *file_io_handle        = NULL;
+	libbfio_handle_t *parent_file_io_handle = NULL;
+	libcerror_error_t *error                = NULL;
+	libqcow_file_t *file                    = NULL;
+	ssize_t read_count                      = 0;
+	size_t buffer_offset                    = 0;
+	uint8_t expected_byte                   = 0;
+	int result                              = 0;
+
+	/* Initialize test
+	 * The image uses 512 byte cluster blocks, has a backing file named "parent.raw"
+	 * with a "raw" backing format header extension and contains:
+	 * a level 1 table at offset 512, a reference count table at offset 1024,
+	 * a level 2 table at offset 1536 and a cluster block at offset 2048.
+	 * Only the first level 2 table entry is allocated. The raw parent file
+	 * contains 1280 bytes, hence the last 768 bytes of the media are beyond its end.
+	 */
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          2560,
+	          9,
+	          2048,
+	          0,
+	          1536,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 8 ] ),
+	 (uint64_t) 256 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 16 ] ),
+	 10 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 104 ] ),
+	 0xe2792acaUL );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 108 ] ),
+	 3 );
+
+	result = memory_copy(
+	          &( data[ 112 ] ),
+	          "raw",
+	          3 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = memory_copy(
+	          &( data[ 256 ] ),
+	          "parent.raw",
+	          10 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 0x8000000000000800ULL );
+
+	result = memory_set(
+	          &( data[ 2048 ] ),
+	          0x5a,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = memory_set(
+	          parent_data,
+	          0x33,
+	          1280 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          2560,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_open_file_io_handle(
+	          &parent_file_io_handle,
+	          parent_data,
+	          1280,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "parent_file_io_handle",
+	 parent_file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 * Reading an unallocated cluster block without a parent file fails
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              512,
+	              512,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_parent_file_io_handle(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_set_parent_file_io_handle(
+	          file,
+	          parent_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              2048,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 2048 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 2048;
+	     buffer_offset++ )
+	{
+		if( buffer_offset < 512 )
+		{
+			expected_byte = 0x5a;
+		}
+		else if( buffer_offset < 1280 )
+		{
+			expected_byte = 0x33;
+		}
+		else
+		{
+			expected_byte = 0x00;
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Test reading only beyond the end of the parent file
+	 */
+	result = memory_set(
+	          buffer,
+	          0xff,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              512,
+	              1536,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 512 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 512;
+	     buffer_offset++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 0x00 );
+	}
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &parent_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( parent_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &parent_file_io_handle,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests reading a selected snapshot
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_selected_snapshot(
+     void )
+{
+	uint8_t buffer[ 1024 ];
+	uint8_t data[ 4608 ];
+
+	/* Select the active image, the snapshot and the active image again
+	 */
+	int snapshot_indexes[ 3 ] = { -1, 0, -1 };
+
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	size64_t expected_media_size     = 0;
+	size64_t media_size              = 0;
+	ssize_t read_count               = 0;
+	size_t buffer_offset             = 0;
+	uint8_t expected_byte            = 0;
+	int number_of_snapshots          = 0;
+	int result                       = 0;
+	int selected_snapshot_index      = 0;
+	int test_number                  = 0;
+
+	/* Initialize test
+	 * The image uses 512 byte cluster blocks and contains one snapshot:
+	 * the active level 1 table at offset 512, a reference count table at offset 1024,
+	 * the active level 2 table at offset 1536, the snapshot level 1 table at offset 2048,
+	 * the active cluster block at offset 2560, the snapshot level 2 table at offset 3072,
+	 * the snapshot cluster block at offset 3584 and the snapshot table at offset 4096.
+	 * The active cluster block is filled with 0x11 and the snapshot cluster block with 0x22.
+	 * The snapshot has a media size of 1024 and the active image of 2048.
+	 */
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          4608,
+	          9,
+	          2048,
+	          0,
+	          1536,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 60 ] ),
+	 1 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 64 ] ),
+	 (uint64_t) 4096 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 0x8000000000000a00ULL );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 2048 ] ),
+	 0x0000000000000c00ULL );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 3072 ] ),
+	 0x0000000000000e00ULL );
+
+	result = memory_set(
+	          &( data[ 2560 ] ),
+	          0x11,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = memory_set(
+	          &( data[ 3584 ] ),
+	          0x22,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* The snapshot table entry contains 16 bytes of extra data
+	 * with the media size, followed by identifier "1" and name "test"
+	 */
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 4096 ] ),
+	 (uint64_t) 2048 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 4104 ] ),
+	 1 );
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 4108 ] ),
+	 1 );
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 4110 ] ),
+	 4 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 4132 ] ),
+	 16 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 4144 ] ),
+	 (uint64_t) 1024 );
+
+	data[ 4152 ] = (uint8_t) '1';
+	data[ 4153 ] = (uint8_t) 't';
+	data[ 4154 ] = (uint8_t) 'e';
+	data[ 4155 ] = (uint8_t) 's';
+	data[ 4156 ] = (uint8_t) 't';
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          4608,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_number_of_snapshots(
+	          file,
+	          &number_of_snapshots,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_snapshots",
+	 number_of_snapshots,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	for( test_number = 0;
+	     test_number < 3;
+	     test_number++ )
+	{
+		result = libqcow_file_select_snapshot(
+		          file,
+		          snapshot_indexes[ test_number ],
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_file_get_selected_snapshot_index(
+		          file,
+		          &selected_snapshot_index,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "selected_snapshot_index",
+		 selected_snapshot_index,
+		 snapshot_indexes[ test_number ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_file_get_media_size(
+		          file,
+		          &media_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		if( snapshot_indexes[ test_number ] == 0 )
+		{
+			expected_media_size = 1024;
+		}
+		else
+		{
+			expected_media_size = 2048;
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT64(
+		 "media_size",
+		 (uint64_t) media_size,
+		 (uint64_t) expected_media_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              1024,
+		              0,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 1024 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		for( buffer_offset = 0;
+		     buffer_offset < 1024;
+		     buffer_offset++ )
+		{
+			if( buffer_offset >= 512 )
+			{
+				expected_byte = 0x00;
+			}
+			else if( snapshot_indexes[ test_number ] == 0 )
+			{
+				expected_byte = 0x22;
+			}
+			else
+			{
+				expected_byte = 0x11;
+			}
+			QCOW_TEST_ASSERT_EQUAL_UINT8(
+			 "buffer[ buffer_offset ]",
+			 buffer[ buffer_offset ],
+			 expected_byte );
+		}
+	}
+	/* Test error cases
+	 */
+	result = libqcow_file_select_snapshot(
+	          file,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_select_snapshot(
+	          file,
+	          -2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* A failed selection retains the selected image
+	 */
+	result = libqcow_file_get_selected_snapshot_index(
+	          file,
+	          &selected_snapshot_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "selected_snapshot_index",
+	 selected_snapshot_index,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Creates the data of an image with a persistent dirty bitmap
+ * The image uses 512 byte cluster blocks, has a media size of 32768 and contains:
+ * a level 1 table at offset 512, a reference count table at offset 1024,
+ * a bitmap directory at offset 1536, a bitmap table at offset 2048
+ * and a bitmap cluster at offset 2560. The bitmap "test" has a granularity of 512 bytes
+ * and bits 1, 2, 8 to 15 and 63 are set.
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_initialize_bitmap_image_data(
+     uint8_t *data,
+     uint64_t auto_clear_feature_flags )
+{
+	int result = 0;
+
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          3072,
+	          9,
+	          32768,
+	          0,
+	          0,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 88 ] ),
+	 auto_clear_feature_flags );
+
+	/* The bitmaps header extension
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 104 ] ),
+	 0x23852875UL );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 108 ] ),
+	 24 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 112 ] ),
+	 1 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 120 ] ),
+	 (uint64_t) 32 );
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 128 ] ),
+	 (uint64_t) 1536 );
+
+	/* The bitmap directory entry with the auto flag set
+	 */
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 (uint64_t) 2048 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 1544 ] ),
+	 1 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 1548 ] ),
+	 0x00000002UL );
+
+	data[ 1552 ] = 1;
+	data[ 1553 ] = 9;
+
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 1554 ] ),
+	 4 );
+
+	data[ 1560 ] = (uint8_t) 't';
+	data[ 1561 ] = (uint8_t) 'e';
+	data[ 1562 ] = (uint8_t) 's';
+	data[ 1563 ] = (uint8_t) 't';
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 2048 ] ),
+	 0x0000000000000a00ULL );
+
+	data[ 2560 ] = 0x06;
+	data[ 2561 ] = 0xff;
+	data[ 2567 ] = 0x80;
+
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+/* Tests retrieving the changed extents of a persistent dirty bitmap
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_bitmap_changed_extents(
+     void )
+{
+	uint8_t data[ 3072 ];
+
+	/* The changed extents of bits 1 and 2, 8 to 15 and 63
+	 */
+	off64_t expected_extent_offsets[ 3 ] = { 512, 4096, 32256 };
+	size64_t expected_extent_sizes[ 3 ]  = { 1024, 4096, 512 };
+
+	libbfio_handle_t *file_io_handle     = NULL;
+	libcerror_error_t *error             = NULL;
+	libqcow_bitmap_t *bitmap             = NULL;
+	libqcow_file_t *file                 = NULL;
+	size64_t extent_size                 = 0;
+	off64_t extent_offset                = 0;
+	off64_t offset                       = 0;
+	int extent_index                     = 0;
+	int number_of_bitmaps                = 0;
+	int result                           = 0;
+
+	/* Initialize test
+	 */
+	result = qcow_test_file_initialize_bitmap_image_data(
+	          data,
+	          0x0000000000000001ULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          3072,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_number_of_bitmaps(
+	          file,
+	          &number_of_bitmaps,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_bitmaps",
+	 number_of_bitmaps,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_bitmap_by_index(
+	          file,
+	          0,
+	          &bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "bitmap",
+	 bitmap );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( extent_index = 0;
+	     extent_index < 3;
+	     extent_index++ )
+	{
+		result = libqcow_bitmap_get_next_changed_extent(
+		          bitmap,
+		          offset,
+		          &extent_offset,
+		          &extent_size,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "extent_offset",
+		 (int64_t) extent_offset,
+		 (int64_t) expected_extent_offsets[ extent_index ] );
+
+		QCOW_TEST_ASSERT_EQUAL_UINT64(
+		 "extent_size",
+		 (uint64_t) extent_size,
+		 (uint64_t) expected_extent_sizes[ extent_index ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		offset = extent_offset + (off64_t) extent_size;
+	}
+	result = libqcow_bitmap_get_next_changed_extent(
+	          bitmap,
+	          offset,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test retrieving a changed extent from within a changed range
+	 */
+	result = libqcow_bitmap_get_next_changed_extent(
+	          bitmap,
+	          6144,
+	          &extent_offset,
+	          &extent_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "extent_offset",
+	 (int64_t) extent_offset,
+	 (int64_t) 6144 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "extent_size",
+	 (uint64_t) extent_size,
+	 (uint64_t) 2048 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_bitmap_free(
+	          &bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "bitmap",
+	 bitmap );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( bitmap != NULL )
+	{
+		libqcow_bitmap_free(
+		 &bitmap,
+		 NULL );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests that a persistent dirty bitmap is ignored if the auto-clear bitmaps flag is not set
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_bitmap_auto_clear_flag_not_set(
+     void )
+{
+	uint8_t data[ 3072 ];
+
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_bitmap_t *bitmap         = NULL;
+	libqcow_file_t *file             = NULL;
+	int number_of_bitmaps            = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 * The bitmap is inconsistent since the image was modified
+	 * by an application that does not support bitmaps
+	 */
+	result = qcow_test_file_initialize_bitmap_image_data(
+	          data,
+	          0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          3072,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_number_of_bitmaps(
+	          file,
+	          &number_of_bitmaps,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_bitmaps",
+	 number_of_bitmaps,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_bitmap_by_index(
+	          file,
+	          0,
+	          &bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "bitmap",
+	 bitmap );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( bitmap != NULL )
+	{
+		libqcow_bitmap_free(
+		 &bitmap,
+		 NULL );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_write_buffer function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_write_buffer(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 16 ];
+
+	libcerror_error_t *error = NULL;
+	ssize_t write_count      = 0;
+
+	/* Test error cases
+	 */
+	write_count = libqcow_file_write_buffer(
+	               NULL,
+	               buffer,
+	               16,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test write on a file opened without write access
+	 */
+	write_count = libqcow_file_write_buffer(
+	               file,
+	               buffer,
+	               16,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_write_buffer_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_write_buffer_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 16 ];
+
+	libcerror_error_t *error = NULL;
+	ssize_t write_count      = 0;
+
+	/* Test error cases
+	 */
+	write_count = libqcow_file_write_buffer_at_offset(
+	               NULL,
+	               buffer,
+	               16,
+	               0,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test write on a file opened without write access
+	 */
+	write_count = libqcow_file_write_buffer_at_offset(
+	               file,
+	               buffer,
+	               16,
+	               0,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests writing data across a cluster block boundary and reading it back
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_write_buffer_at_offset_round_trip(
+     void )
+{
+	uint8_t buffer[ 1024 ];
+	uint8_t data[ 3072 ];
+
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	const char *filename             = "qcow_test_file_write.qcow2";
+	size64_t file_size               = 0;
+	ssize_t read_count               = 0;
+	ssize_t write_count              = 0;
+	size_t buffer_offset             = 0;
+	uint64_t value_64bit             = 0;
+	uint16_t value_16bit             = 0;
+	uint8_t expected_byte            = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 * The image uses 512 byte cluster blocks and contains:
+	 * a level 1 table at offset 512, a reference count table at offset 1024,
+	 * a level 2 table at offset 1536, a reference count block at offset 2048
+	 * and an allocated cluster block at offset 2560.
+	 * The image is written to a file since new cluster blocks are allocated
+	 * at the end of the file.
+	 */
+	result = qcow_test_file_initialize_image_data(
+	          data,
+	          3072,
+	          9,
+	          2048,
+	          0,
+	          1536,
+	          2048 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( data[ 1536 ] ),
+	 0x8000000000000a00ULL );
+
+	result = memory_set(
+	          &( data[ 2560 ] ),
+	          0xaa,
+	          512 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libbfio_file_initialize(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_file_set_name(
+	          file_io_handle,
+	          filename,
+	          narrow_string_length(
+	           filename ),
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_handle_open(
+	          file_io_handle,
+	          LIBBFIO_OPEN_READ_WRITE_TRUNCATE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               file_io_handle,
+	               data,
+	               3072,
+	               0,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) 3072 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ_WRITE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 * The write overwrites the end of the allocated cluster block in place
+	 * and allocates a new cluster block for the start of the sparse cluster block
+	 */
+	result = memory_set(
+	          buffer,
+	          0x55,
+	          256 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	write_count = libqcow_file_write_buffer_at_offset(
+	               file,
+	               buffer,
+	               256,
+	               384,
+	               &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "write_count",
+	 write_count,
+	 (ssize_t) 256 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test that the dirty flag is set in the file header while the file is modified
+	 */
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              buffer,
+	              8,
+	              72,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 8 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 buffer,
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "value_64bit",
+	 value_64bit,
+	 (uint64_t) 1 );
+
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test that the dirty flag was cleared when the file was closed
+	 */
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              buffer,
+	              8,
+	              72,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 8 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 buffer,
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "value_64bit",
+	 value_64bit,
+	 (uint64_t) 0 );
+
+	/* Test that the new cluster block was appended to the file
+	 */
+	result = libbfio_handle_get_size(
+	          file_io_handle,
+	          &file_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "file_size",
+	 (uint64_t) file_size,
+	 (uint64_t) 3584 );
+
+	/* Test that the level 2 table refers to the cluster blocks
+	 */
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              buffer,
+	              16,
+	              1536,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 16 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 &( buffer[ 0 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "value_64bit",
+	 value_64bit,
+	 (uint64_t) 0x8000000000000a00ULL );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 &( buffer[ 8 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "value_64bit",
+	 value_64bit,
+	 (uint64_t) 0x8000000000000c00ULL );
+
+	/* Test that the reference count of the new cluster block was set
+	 */
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              buffer,
+	              16,
+	              2048,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 16 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 8;
+	     buffer_offset++ )
+	{
+		byte_stream_copy_to_uint16_big_endian(
+		 &( buffer[ buffer_offset * 2 ] ),
+		 value_16bit );
+
+		QCOW_TEST_ASSERT_EQUAL_UINT16(
+		 "value_16bit",
+		 value_16bit,
+		 ( buffer_offset < 7 ) ? 1 : 0 );
+	}
+	/* Test reading the data back
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              1024,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( buffer_offset = 0;
+	     buffer_offset < 1024;
+	     buffer_offset++ )
+	{
+		if( buffer_offset < 384 )
+		{
+			expected_byte = 0xaa;
+		}
+		else if( buffer_offset < 640 )
+		{
+			expected_byte = 0x55;
+		}
+		else
+		{
+			expected_byte = 0x00;
+		}
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "buffer[ buffer_offset ]",
+		 buffer[ buffer_offset ],
+		 expected_byte );
+	}
+	/* Clean up
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	remove(
+	 filename );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	remove(
+	 filename );
+
+	return( 0 );
+}
+
+/* Tests the libqcow_file_seek_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_seek_offset(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size64_t size            = 0;
+	off64_t offset           = 0;
+
+	/* Test regular cases
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_END,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	size = (size64_t) offset;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          1024,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -512,
+	          SEEK_CUR,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 512 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) ( size + 512 ),
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) ( size + 512 ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test seeking the next hole, the end of the media is considered a hole
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_HOLE,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_LESS_THAN_UINT64(
+	 "offset",
+	 (uint64_t) offset,
+	 (uint64_t) size + 1 );
+
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	offset = libqcow_file_seek_offset(
+	          NULL,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -1,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -1,
+	          SEEK_CUR,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) ( -1 * ( size + 1 ) ),
+	          SEEK_END,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) size,
+	          SEEK_DATA,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) size,
+	          SEEK_HOLE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          99,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_seek_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 (int64_t) offset,
+		 (int64_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_file_seek_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 (int64_t) offset,
+		 (int64_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_offset(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	off64_t offset           = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_offset(
+	          NULL,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK )
+
+	/* Test libqcow_file_get_offset with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
+	 */
+	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_file_get_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_extent_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_extent_at_offset(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size64_t extent_size     = 0;
+	size64_t media_size      = 0;
+	off64_t offset           = 0;
+	uint32_t extent_flags    = 0;
+	uint32_t previous_flags  = 0;
+	int number_of_extents    = 0;
+	int result               = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	while( number_of_extents < 4096 )
+	{
+		result = libqcow_file_get_extent_at_offset(
+		          file,
+		          offset,
+		          &extent_size,
+		          &extent_flags,
+		          &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		if( result == 0 )
+		{
+			break;
+		}
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
+		 "extent_size",
+		 (int64_t) extent_size,
+		 (int64_t) 0 );
+
+		/* Consecutive extents have different extent flags
+		 */
+		if( number_of_extents > 0 )
+		{
+			QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+			 "extent_flags",
+			 (int) extent_flags,
+			 (int) previous_flags );
+		}
+		offset        += (off64_t) extent_size;
+		previous_flags = extent_flags;
+
+		number_of_extents++;
+	}
+	if( result == 0 )
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 (int64_t) offset,
+		 (int64_t) media_size );
+	}
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          (off64_t) media_size,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_extent_at_offset(
+	          NULL,
+	          0,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          -1,
+	          &extent_size,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          0,
+	          NULL,
+	          &extent_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_extent_at_offset(
+	          file,
+	          0,
+	          &extent_size,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_cache_budget function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_cache_budget(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size64_t cache_budget    = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_cache_budget(
+	          file,
+	          &cache_budget,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_cache_budget(
+	          NULL,
+	          &cache_budget,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_cache_budget(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_set_cache_budget function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_set_cache_budget(
+     libqcow_file_t *file )
+{
+	uint8_t default_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t budget_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error = NULL;
+	size64_t cache_budget    = 0;
+	size64_t media_size      = 0;
+	size_t read_size         = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	ssize_t read_count       = 0;
+	int result               = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size < (size64_t) read_size )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              default_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_set_cache_budget(
+	          file,
+	          64 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_cache_budget(
+	          file,
+	          &cache_budget,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cache_budget",
+	 (uint64_t) cache_budget,
+	 (uint64_t) 64 * 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              budget_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          default_buffer,
+	          budget_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_file_set_cache_budget(
+	          file,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_set_cache_budget(
+	          NULL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_number_of_readahead_cluster_blocks function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error     = NULL;
+	int number_of_cluster_blocks = 0;
+	int result                   = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_number_of_readahead_cluster_blocks(
+	          file,
+	          &number_of_cluster_blocks,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_number_of_readahead_cluster_blocks(
+	          NULL,
+	          &number_of_cluster_blocks,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_number_of_readahead_cluster_blocks(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_set_number_of_readahead_cluster_blocks function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_set_number_of_readahead_cluster_blocks(
+     libqcow_file_t *file )
+{
+	uint8_t default_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t readahead_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error     = NULL;
+	size64_t media_size          = 0;
+	size_t buffer_offset         = 0;
+	size_t read_size             = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	ssize_t read_count           = 0;
+	int number_of_cluster_blocks = 0;
+	int result                   = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size < (size64_t) read_size )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              default_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_set_number_of_readahead_cluster_blocks(
+	          file,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_number_of_readahead_cluster_blocks(
+	          file,
+	          &number_of_cluster_blocks,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_cluster_blocks",
+	 number_of_cluster_blocks,
+	 4 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Read the data sequentially in small parts to trigger the readahead
+	 */
+	while( buffer_offset < read_size )
+	{
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              &( readahead_buffer[ buffer_offset ] ),
+		              512,
+		              (off64_t) buffer_offset,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 512 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		buffer_offset += 512;
+
+		if( ( read_size - buffer_offset ) < 512 )
+		{
+			break;
+		}
+	}
+	result = memory_compare(
+	          default_buffer,
+	          readahead_buffer,
+	          buffer_offset );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_file_set_number_of_readahead_cluster_blocks(
+	          file,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_set_number_of_readahead_cluster_blocks(
+	          NULL,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_number_of_readahead_cluster_blocks(
+	          file,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_number_of_readahead_cluster_blocks(
+	          file,
+	          1025,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_number_of_decompression_threads function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_number_of_decompression_threads(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	int number_of_threads    = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_number_of_decompression_threads(
+	          file,
+	          &number_of_threads,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_number_of_decompression_threads(
+	          NULL,
+	          &number_of_threads,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_number_of_decompression_threads(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_set_number_of_decompression_threads function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_set_number_of_decompression_threads(
+     libqcow_file_t *file )
+{
+	uint8_t default_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t decompression_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error = NULL;
+	size64_t media_size      = 0;
+	size_t read_size         = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	ssize_t read_count       = 0;
+	int number_of_threads    = 0;
+	int result               = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size < (size64_t) read_size )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              default_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_set_number_of_decompression_threads(
+	          file,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_number_of_decompression_threads(
+	          file,
+	          &number_of_threads,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_threads",
+	 number_of_threads,
+	 4 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Read the data at once so that its cluster blocks are decompressed in parallel
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              decompression_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          default_buffer,
+	          decompression_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_file_set_number_of_decompression_threads(
+	          file,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_set_number_of_decompression_threads(
+	          NULL,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_number_of_decompression_threads(
+	          file,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_number_of_decompression_threads(
+	          file,
+	          65,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_io_queue_depth function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_io_queue_depth(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	int io_queue_depth       = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_io_queue_depth(
+	          file,
+	          &io_queue_depth,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
 	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+	result = libqcow_file_get_io_queue_depth(
+	          NULL,
+	          &io_queue_depth,
+	          &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
-	              &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	libcerror_error_free(
+	 &error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+	result = libqcow_file_get_io_queue_depth(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -2757,92 +9464,150 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_file_seek_offset function
+/* Tests the libqcow_file_set_io_queue_depth function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_seek_offset(
+int qcow_test_file_set_io_queue_depth(
      libqcow_file_t *file )
 {
 	libcerror_error_t *error = NULL;
-	size64_t size            = 0;
-	off64_t offset           = 0;
+	int io_queue_depth       = 0;
+	int result               = 0;
 
 	/* Test regular cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_set_io_queue_depth(
 	          file,
-	          0,
-	          SEEK_END,
+	          8,
 	          &error );
 
-	QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	size = (size64_t) offset;
-
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_io_queue_depth(
 	          file,
-	          1024,
-	          SEEK_SET,
+	          &io_queue_depth,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 1024 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "io_queue_depth",
+	 io_queue_depth,
+	 8 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_set_io_queue_depth(
 	          file,
-	          -512,
-	          SEEK_CUR,
+	          1,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 512 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	offset = libqcow_file_seek_offset(
+	/* Test error cases
+	 */
+	result = libqcow_file_set_io_queue_depth(
+	          NULL,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_io_queue_depth(
 	          file,
-	          (off64_t) ( size + 512 ),
-	          SEEK_SET,
+	          0,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) ( size + 512 ) );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	/* Reset offset to 0
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_set_io_queue_depth(
+	          file,
+	          257,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_use_memory_map function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_use_memory_map(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	uint8_t use_memory_map   = 0;
+	int result               = 0;
+
+	/* Test regular cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_use_memory_map(
 	          file,
-	          0,
-	          SEEK_SET,
+	          &use_memory_map,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
@@ -2850,16 +9615,15 @@ int qcow_test_file_seek_offset(
 
 	/* Test error cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_use_memory_map(
 	          NULL,
-	          0,
-	          SEEK_SET,
+	          &use_memory_map,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2868,16 +9632,15 @@ int qcow_test_file_seek_offset(
 	libcerror_error_free(
 	 &error );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_use_memory_map(
 	          file,
-	          -1,
-	          SEEK_SET,
+	          NULL,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2886,98 +9649,111 @@ int qcow_test_file_seek_offset(
 	libcerror_error_free(
 	 &error );
 
-	offset = libqcow_file_seek_offset(
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_set_use_memory_map function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_set_use_memory_map(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	uint8_t use_memory_map   = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_set_use_memory_map(
 	          file,
-	          -1,
-	          SEEK_CUR,
+	          1,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_use_memory_map(
 	          file,
-	          (off64_t) ( -1 * ( size + 1 ) ),
-	          SEEK_END,
+	          &use_memory_map,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "use_memory_map",
+	 use_memory_map,
+	 (uint8_t) 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_set_use_memory_map(
+	          file,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-#if defined( HAVE_QCOW_TEST_RWLOCK )
-
-	/* Test libqcow_file_seek_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	/* Test error cases
 	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
-
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
+	result = libqcow_file_set_use_memory_map(
+	          NULL,
+	          1,
 	          &error );
 
-	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 (int64_t) offset,
-		 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-	/* Test libqcow_file_seek_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+	libcerror_error_free(
+	 &error );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_set_use_memory_map(
 	          file,
-	          0,
-	          SEEK_SET,
+	          2,
 	          &error );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 (int64_t) offset,
-		 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -2990,21 +9766,60 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_file_get_offset function
+/* Tests the libqcow_file_get_cache_statistics function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_get_offset(
+int qcow_test_file_get_cache_statistics(
      libqcow_file_t *file )
 {
-	libcerror_error_t *error = NULL;
-	off64_t offset           = 0;
-	int result               = 0;
+	libcerror_error_t *error     = NULL;
+	uint64_t number_of_evictions = 0;
+	uint64_t number_of_hits      = 0;
+	uint64_t number_of_misses    = 0;
+	int result                   = 0;
 
 	/* Test regular cases
 	 */
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_cache_statistics(
 	          file,
-	          &offset,
+	          LIBQCOW_CACHE_TYPE_LEVEL2_TABLES,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_cache_statistics(
+	          file,
+	          LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_cache_statistics(
+	          file,
+	          LIBQCOW_CACHE_TYPE_COMPRESSED_CLUSTER_BLOCKS,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3018,9 +9833,12 @@ int qcow_test_file_get_offset(
 
 	/* Test error cases
 	 */
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_cache_statistics(
 	          NULL,
-	          &offset,
+	          LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3035,9 +9853,12 @@ int qcow_test_file_get_offset(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_cache_statistics(
 	          file,
-	          NULL,
+	          0,
+	          &number_of_hits,
+	          &number_of_misses,
+	          &number_of_evictions,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3052,63 +9873,25 @@ int qcow_test_file_get_offset(
 	libcerror_error_free(
 	 &error );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK )
-
-	/* Test libqcow_file_get_offset with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
-	 */
-	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
-
-	result = libqcow_file_get_offset(
-	          file,
-	          &offset,
-	          &error );
-
-	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 -1 );
-
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
-
-		libcerror_error_free(
-		 &error );
-	}
-	/* Test libqcow_file_get_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
-
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_cache_statistics(
 	          file,
-	          &offset,
+	          LIBQCOW_CACHE_TYPE_CLUSTER_BLOCKS,
+	          NULL,
+	          &number_of_misses,
+	          &number_of_evictions,
 	          &error );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK ) */
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -3462,6 +10245,38 @@ int main(
 	 "libqcow_file_free",
 	 qcow_test_file_free );
 
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_zero_cluster_blocks",
+	 qcow_test_file_read_buffer_zero_cluster_blocks );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_extended_level2_entries",
+	 qcow_test_file_read_buffer_extended_level2_entries );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_external_data_file",
+	 qcow_test_file_read_buffer_external_data_file );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_raw_parent_file",
+	 qcow_test_file_read_buffer_raw_parent_file );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_selected_snapshot",
+	 qcow_test_file_read_buffer_selected_snapshot );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_get_bitmap_changed_extents",
+	 qcow_test_file_get_bitmap_changed_extents );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_get_bitmap_auto_clear_flag_not_set",
+	 qcow_test_file_get_bitmap_auto_clear_flag_not_set );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_write_buffer_at_offset_round_trip",
+	 qcow_test_file_write_buffer_at_offset_round_trip );
+
 #if !defined( __BORLANDC__ ) || ( __BORLANDC__ >= 0x0560 )
 	if( source != NULL )
 	{
@@ -3554,6 +10369,12 @@ int main(
 		 source,
 		 option_password );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_mapped_data_at_offset",
+		 qcow_test_file_get_mapped_data_at_offset,
+		 source,
+		 option_password );
+
 		/* Initialize file for tests
 		 */
 		result = qcow_test_file_open_source(
@@ -3608,11 +10429,26 @@ int main(
 
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_get_backing_range_size",
+		 qcow_test_internal_file_get_backing_range_size,
+		 file );
+
 		QCOW_TEST_RUN_WITH_ARGS(
 		 "libqcow_internal_file_read_buffer_from_file_io_handle",
 		 qcow_test_internal_file_read_buffer_from_file_io_handle,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_read_cluster_block_data",
+		 qcow_test_internal_file_read_cluster_block_data,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_read_contiguous_cluster_blocks_data",
+		 qcow_test_internal_file_read_contiguous_cluster_blocks_data,
+		 file );
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 		QCOW_TEST_RUN_WITH_ARGS(
@@ -3625,15 +10461,46 @@ int main(
 		 qcow_test_file_read_buffer_at_offset,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_buffer_at_offset_concurrent",
+		 qcow_test_file_read_buffer_at_offset_concurrent,
+		 file );
+
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && !defined( HAVE_LOCAL_LIBQCOW )
+
+		/* The throughput is only measured on request, since it prints timing information
+		 * and its outcome depends on the system the tests run on
+		 */
+		if( getenv(
+		     "QCOW_TEST_BENCHMARK" ) != NULL )
+		{
+			QCOW_TEST_RUN_WITH_ARGS(
+			 "libqcow_file_read_buffer_at_offset_concurrent_throughput",
+			 qcow_test_file_read_buffer_at_offset_concurrent_throughput,
+			 file );
+		}
+#endif
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_vectors",
+		 qcow_test_file_read_vectors,
+		 file );
+
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
 		/* TODO: add tests for libqcow_internal_file_write_buffer_to_file_io_handle */
 
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
-		/* TODO: add tests for libqcow_file_write_buffer */
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_write_buffer",
+		 qcow_test_file_write_buffer,
+		 file );
 
-		/* TODO: add tests for libqcow_file_write_buffer_at_offset */
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_write_buffer_at_offset",
+		 qcow_test_file_write_buffer_at_offset,
+		 file );
 
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
@@ -3651,12 +10518,72 @@ int main(
 		 qcow_test_file_get_offset,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_extent_at_offset",
+		 qcow_test_file_get_extent_at_offset,
+		 file );
+
 		/* TODO: add tests for libqcow_file_set_keys */
 
 		/* TODO: add tests for libqcow_file_set_utf8_password */
 
 		/* TODO: add tests for libqcow_file_set_utf16_password */
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_cache_budget",
+		 qcow_test_file_get_cache_budget,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_set_cache_budget",
+		 qcow_test_file_set_cache_budget,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_number_of_readahead_cluster_blocks",
+		 qcow_test_file_get_number_of_readahead_cluster_blocks,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_set_number_of_readahead_cluster_blocks",
+		 qcow_test_file_set_number_of_readahead_cluster_blocks,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_number_of_decompression_threads",
+		 qcow_test_file_get_number_of_decompression_threads,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_set_number_of_decompression_threads",
+		 qcow_test_file_set_number_of_decompression_threads,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_io_queue_depth",
+		 qcow_test_file_get_io_queue_depth,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_set_io_queue_depth",
+		 qcow_test_file_set_io_queue_depth,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_use_memory_map",
+		 qcow_test_file_get_use_memory_map,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_set_use_memory_map",
+		 qcow_test_file_set_use_memory_map,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_cache_statistics",
+		 qcow_test_file_get_cache_statistics,
+		 file );
+
 		QCOW_TEST_RUN_WITH_ARGS(
 		 "libqcow_file_get_media_size",
 		 qcow_test_file_get_media_size,
@@ -22,6 +22,7 @@
 #include <common.h>
 #include <byte_stream.h>
 #include <file_stream.h>
+#include <memory.h>
 #include <types.h>
 
 #if defined( HAVE_STDLIB_H ) || defined( WINAPI )
@@ -36,6 +37,7 @@
 #include "qcow_test_memory.h"
 #include "qcow_test_unused.h"
 
+#include "../libqcow/libqcow_definitions.h"
 #include "../libqcow/libqcow_file_header.h"
 
 uint8_t qcow_test_file_header_data1[ 512 ] = {
@@ -464,6 +466,157 @@ int qcow_test_file_header_read_data(
 	}
 #endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
 
+	/* Test regular case where the compression type is set
+	 */
+	qcow_test_file_header_data1[ 79 ]  = 0x08;
+	qcow_test_file_header_data1[ 103 ] = 0x70;
+	qcow_test_file_header_data1[ 104 ] = 0x01;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "file_header->compression_method",
+	 file_header->compression_method,
+	 (uint16_t) LIBQCOW_COMPRESSION_METHOD_ZSTD );
+
+	/* Test error case where the compression type is set without the compression type feature flag
+	 */
+	qcow_test_file_header_data1[ 79 ] = 0x00;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the compression type is not supported
+	 */
+	qcow_test_file_header_data1[ 79 ]  = 0x08;
+	qcow_test_file_header_data1[ 104 ] = 0xff;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	qcow_test_file_header_data1[ 79 ]  = 0x00;
+	qcow_test_file_header_data1[ 103 ] = 0x68;
+	qcow_test_file_header_data1[ 104 ] = 0x68;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test regular case where the extended level 2 table entries feature flag is set
+	 */
+	qcow_test_file_header_data1[ 79 ] = 0x10;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	qcow_test_file_header_data1[ 79 ] = 0x00;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "file_header->incompatible_feature_flags",
+	 file_header->incompatible_feature_flags,
+	 (uint64_t) LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTENDED_L2 );
+
+	/* Test regular case where the external data file feature flag is set
+	 */
+	qcow_test_file_header_data1[ 79 ] = 0x04;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	qcow_test_file_header_data1[ 79 ] = 0x00;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "file_header->incompatible_feature_flags",
+	 file_header->incompatible_feature_flags,
+	 (uint64_t) LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE );
+
+	/* Test error case where an unsupported incompatible feature flag is set
+	 */
+	qcow_test_file_header_data1[ 79 ] = 0x20;
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          qcow_test_file_header_data1,
+	          512,
+	          &error );
+
+	qcow_test_file_header_data1[ 79 ] = 0x00;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
 	/* Test error case where the signature is invalid
 	 */
 	byte_stream_copy_from_uint32_big_endian(
@@ -798,6 +951,314 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_file_header_read_extensions_file_io_handle function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_header_read_extensions_file_io_handle(
+     void )
+{
+	uint8_t file_header_data[ 512 ];
+
+	libbfio_handle_t *file_io_handle  = NULL;
+	libcerror_error_t *error          = NULL;
+	libqcow_file_header_t *file_header = NULL;
+	int result                        = 0;
+
+	/* Initialize test
+	 * Add a full disk encryption, a bitmaps and a backing format header extension after the feature name table header extension
+	 */
+	if( memory_copy(
+	     file_header_data,
+	     qcow_test_file_header_data1,
+	     512 ) == NULL )
+	{
+		goto on_error;
+	}
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 256 ] ),
+	 LIBQCOW_HEADER_EXTENSION_TYPE_FULL_DISK_ENCRYPTION );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 260 ] ),
+	 16 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( file_header_data[ 264 ] ),
+	 0x00030000UL );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( file_header_data[ 272 ] ),
+	 0x00081000UL );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 280 ] ),
+	 LIBQCOW_HEADER_EXTENSION_TYPE_BITMAPS );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 284 ] ),
+	 24 );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 288 ] ),
+	 2 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( file_header_data[ 296 ] ),
+	 0x00000040UL );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( file_header_data[ 304 ] ),
+	 0x00040000UL );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 312 ] ),
+	 LIBQCOW_HEADER_EXTENSION_TYPE_BACKING_FORMAT );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 316 ] ),
+	 3 );
+
+	file_header_data[ 320 ] = (uint8_t) 'r';
+	file_header_data[ 321 ] = (uint8_t) 'a';
+	file_header_data[ 322 ] = (uint8_t) 'w';
+
+	result = libqcow_file_header_initialize(
+	          &file_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_header",
+	 file_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_header_read_data(
+	          file_header,
+	          file_header_data,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Initialize file IO handle
+	 */
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          file_header_data,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_header_read_extensions_file_io_handle(
+	          file_header,
+	          file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "file_header->encryption_header_offset",
+	 (int64_t) file_header->encryption_header_offset,
+	 (int64_t) 0x00030000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "file_header->encryption_header_size",
+	 (uint64_t) file_header->encryption_header_size,
+	 (uint64_t) 0x00081000UL );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "file_header->number_of_bitmaps",
+	 file_header->number_of_bitmaps,
+	 (uint32_t) 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "file_header->bitmap_directory_offset",
+	 (int64_t) file_header->bitmap_directory_offset,
+	 (int64_t) 0x00040000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "file_header->bitmap_directory_size",
+	 (uint64_t) file_header->bitmap_directory_size,
+	 (uint64_t) 0x00000040UL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "file_header->backing_format_offset",
+	 (int64_t) file_header->backing_format_offset,
+	 (int64_t) 320 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "file_header->backing_format_size",
+	 file_header->backing_format_size,
+	 (uint32_t) 3 );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_header_read_extensions_file_io_handle(
+	          NULL,
+	          file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up file IO handle
+	 */
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error case where the full disk encryption header extension is too small
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( file_header_data[ 260 ] ),
+	 8 );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          file_header_data,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_header_read_extensions_file_io_handle(
+	          file_header,
+	          file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up file IO handle
+	 */
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_header_free(
+	          &file_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file_header",
+	 file_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( file_header != NULL )
+	{
+		libqcow_file_header_free(
+		 &file_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 /* The main program
@@ -833,6 +1294,10 @@ int main(
 	 "libqcow_file_header_read_file_io_handle",
 	 qcow_test_file_header_read_file_io_handle );
 
+	QCOW_TEST_RUN(
+	 "libqcow_file_header_read_extensions_file_io_handle",
+	 qcow_test_file_header_read_extensions_file_io_handle );
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 	return( EXIT_SUCCESS );
@@ -0,0 +1,729 @@
+/*
+ * Library hash functions test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_hash.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_hash_get_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_hash_get_size(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size_t hash_size         = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_hash_get_size(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          &hash_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "hash_size",
+	 hash_size,
+	 (size_t) LIBQCOW_HASH_SHA1_SIZE );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_hash_get_size(
+	          LIBQCOW_HASH_TYPE_SHA256,
+	          &hash_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "hash_size",
+	 hash_size,
+	 (size_t) LIBQCOW_HASH_SHA256_SIZE );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_hash_get_size(
+	          -1,
+	          &hash_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_get_size(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Calculates a hash and compares it with the expected hash
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_hash_calculate(
+     int hash_type,
+     const uint8_t *data,
+     size_t data_size,
+     size_t split_offset,
+     const uint8_t *expected_hash,
+     size_t hash_size )
+{
+	uint8_t hash[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+
+	libqcow_hash_context_t context;
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	result = libqcow_hash_initialize(
+	          &context,
+	          hash_type,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Update the hash in 2 parts to test data that is not block aligned
+	 */
+	result = libqcow_hash_update(
+	          &context,
+	          data,
+	          split_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_hash_update(
+	          &context,
+	          &( data[ split_offset ] ),
+	          data_size - split_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_hash_finalize(
+	          &context,
+	          hash,
+	          hash_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          hash,
+	          expected_hash,
+	          hash_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_hash_update and libqcow_hash_finalize functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_hash_finalize(
+     void )
+{
+	uint8_t hash[ LIBQCOW_HASH_MAXIMUM_SIZE ];
+
+	/* The FIPS 180-2 test vectors
+	 */
+	uint8_t data1[ 3 ] = {
+		'a', 'b', 'c' };
+
+	uint8_t data2[ 56 ] = {
+		'a', 'b', 'c', 'd', 'b', 'c', 'd', 'e', 'c', 'd', 'e', 'f', 'd', 'e', 'f', 'g',
+		'e', 'f', 'g', 'h', 'f', 'g', 'h', 'i', 'g', 'h', 'i', 'j', 'h', 'i', 'j', 'k',
+		'i', 'j', 'k', 'l', 'j', 'k', 'l', 'm', 'k', 'l', 'm', 'n', 'l', 'm', 'n', 'o',
+		'm', 'n', 'o', 'p', 'n', 'o', 'p', 'q' };
+
+	uint8_t expected_sha1_hash1[ 20 ] = {
+		0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e, 0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c,
+		0x9c, 0xd0, 0xd8, 0x9d };
+
+	uint8_t expected_sha1_hash2[ 20 ] = {
+		0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5,
+		0xe5, 0x46, 0x70, 0xf1 };
+
+	uint8_t expected_sha256_hash1[ 32 ] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad };
+
+	uint8_t expected_sha256_hash2[ 32 ] = {
+		0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+		0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 };
+
+	libqcow_hash_context_t context;
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = qcow_test_hash_calculate(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          data1,
+	          3,
+	          1,
+	          expected_sha1_hash1,
+	          20 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_hash_calculate(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          data2,
+	          56,
+	          17,
+	          expected_sha1_hash2,
+	          20 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_hash_calculate(
+	          LIBQCOW_HASH_TYPE_SHA256,
+	          data1,
+	          3,
+	          0,
+	          expected_sha256_hash1,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_hash_calculate(
+	          LIBQCOW_HASH_TYPE_SHA256,
+	          data2,
+	          56,
+	          55,
+	          expected_sha256_hash2,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* Test error cases
+	 */
+	result = libqcow_hash_initialize(
+	          NULL,
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_initialize(
+	          &context,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_initialize(
+	          &context,
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_hash_update(
+	          &context,
+	          NULL,
+	          3,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_finalize(
+	          &context,
+	          hash,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_hash_pbkdf2 function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_hash_pbkdf2(
+     void )
+{
+	uint8_t output_data[ 32 ];
+
+	/* The RFC 6070 test vectors
+	 */
+	uint8_t password1[ 8 ] = {
+		'p', 'a', 's', 's', 'w', 'o', 'r', 'd' };
+
+	uint8_t salt1[ 4 ] = {
+		's', 'a', 'l', 't' };
+
+	uint8_t password2[ 24 ] = {
+		'p', 'a', 's', 's', 'w', 'o', 'r', 'd', 'P', 'A', 'S', 'S', 'W', 'O', 'R', 'D',
+		'p', 'a', 's', 's', 'w', 'o', 'r', 'd' };
+
+	uint8_t salt2[ 36 ] = {
+		's', 'a', 'l', 't', 'S', 'A', 'L', 'T', 's', 'a', 'l', 't', 'S', 'A', 'L', 'T',
+		's', 'a', 'l', 't', 'S', 'A', 'L', 'T', 's', 'a', 'l', 't', 'S', 'A', 'L', 'T',
+		's', 'a', 'l', 't' };
+
+	uint8_t expected_output_data1[ 20 ] = {
+		0xea, 0x6c, 0x01, 0x4d, 0xc7, 0x2d, 0x6f, 0x8c, 0xcd, 0x1e, 0xd9, 0x2a, 0xce, 0x1d, 0x41, 0xf0,
+		0xd8, 0xde, 0x89, 0x57 };
+
+	uint8_t expected_output_data2[ 25 ] = {
+		0x3d, 0x2e, 0xec, 0x4f, 0xe4, 0x1c, 0x84, 0x9b, 0x80, 0xc8, 0xd8, 0x36, 0x62, 0xc0, 0xe4, 0x4a,
+		0x8b, 0x29, 0x1a, 0x96, 0x4c, 0xf2, 0xf0, 0x70, 0x38 };
+
+	uint8_t expected_output_data3[ 32 ] = {
+		0x12, 0x0f, 0xb6, 0xcf, 0xfc, 0xf8, 0xb3, 0x2c, 0x43, 0xe7, 0x22, 0x52, 0x56, 0xc4, 0xf8, 0x37,
+		0xa8, 0x65, 0x48, 0xc9, 0x2c, 0xcc, 0x35, 0x48, 0x08, 0x05, 0x98, 0x7c, 0xb7, 0x0b, 0xe1, 0x7b };
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          password1,
+	          8,
+	          salt1,
+	          4,
+	          2,
+	          output_data,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          output_data,
+	          expected_output_data1,
+	          20 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test output data that is larger than the hash size
+	 */
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          password2,
+	          24,
+	          salt2,
+	          36,
+	          4096,
+	          output_data,
+	          25,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          output_data,
+	          expected_output_data2,
+	          25 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA256,
+	          password1,
+	          8,
+	          salt1,
+	          4,
+	          1,
+	          output_data,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          output_data,
+	          expected_output_data3,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_hash_pbkdf2(
+	          -1,
+	          password1,
+	          8,
+	          salt1,
+	          4,
+	          1,
+	          output_data,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          NULL,
+	          8,
+	          salt1,
+	          4,
+	          1,
+	          output_data,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          password1,
+	          8,
+	          NULL,
+	          4,
+	          1,
+	          output_data,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          password1,
+	          8,
+	          salt1,
+	          4,
+	          0,
+	          output_data,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_hash_pbkdf2(
+	          LIBQCOW_HASH_TYPE_SHA1,
+	          password1,
+	          8,
+	          salt1,
+	          4,
+	          1,
+	          NULL,
+	          20,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_hash_get_size",
+	 qcow_test_hash_get_size );
+
+	QCOW_TEST_RUN(
+	 "libqcow_hash_finalize",
+	 qcow_test_hash_finalize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_hash_pbkdf2",
+	 qcow_test_hash_pbkdf2 );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -431,10 +431,6 @@ int main(
 
 	/* TODO: add tests for libqcow_io_handle_read_file_header */
 
-	/* TODO: add tests for libqcow_io_handle_read_level2_table */
-
-	/* TODO: add tests for libqcow_io_handle_read_cluster_block */
-
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 	return( EXIT_SUCCESS );
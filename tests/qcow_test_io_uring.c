@@ -0,0 +1,643 @@
+/*
+ * Library io_uring type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_io_uring.h"
+
+#define QCOW_TEST_IO_URING_READ_BUFFER_SIZE	4096
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_IO_URING ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+
+/* Tests the libqcow_io_uring_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_io_uring_initialize(
+     const char *source )
+{
+	libcerror_error_t *error     = NULL;
+	libqcow_io_uring_t *io_uring = NULL;
+	int result                   = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          source,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The io_uring is not available when the kernel does not support it
+	 */
+	if( result == 0 )
+	{
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "io_uring",
+		 io_uring );
+
+		return( 1 );
+	}
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "io_uring",
+	 io_uring );
+
+	/* Test error cases
+	 */
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          source,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_free(
+	          &io_uring,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "io_uring",
+	 io_uring );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_io_uring_initialize(
+	          NULL,
+	          source,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          NULL,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          source,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          source,
+	          257,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( io_uring != NULL )
+	{
+		libqcow_io_uring_free(
+		 &io_uring,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_io_uring_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_io_uring_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_io_uring_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_io_uring_grab, libqcow_io_uring_append_read, libqcow_io_uring_submit
+ * and libqcow_io_uring_release functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_io_uring_append_read(
+     const char *source )
+{
+	uint8_t expected_buffer[ QCOW_TEST_IO_URING_READ_BUFFER_SIZE ];
+	uint8_t read_buffer[ QCOW_TEST_IO_URING_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error     = NULL;
+	libqcow_io_uring_t *io_uring = NULL;
+	FILE *file_stream            = NULL;
+	void *memset_result          = NULL;
+	size_t read_size             = 0;
+	int io_uring_grabbed         = 0;
+	int result                   = 0;
+
+	/* Initialize test
+	 */
+	file_stream = file_stream_open(
+	               source,
+	               "rb" );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_stream",
+	 file_stream );
+
+	read_size = file_stream_read(
+	             file_stream,
+	             expected_buffer,
+	             QCOW_TEST_IO_URING_READ_BUFFER_SIZE );
+
+	file_stream_close(
+	 file_stream );
+
+	/* Use a multiple of 3 so the reads below are not empty
+	 */
+	read_size -= read_size % 3;
+
+	if( read_size == 0 )
+	{
+		return( 1 );
+	}
+	result = libqcow_io_uring_initialize(
+	          &io_uring,
+	          source,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( result == 0 )
+	{
+		return( 1 );
+	}
+	/* Test regular cases
+	 */
+	memset_result = memory_set(
+	                 read_buffer,
+	                 0,
+	                 QCOW_TEST_IO_URING_READ_BUFFER_SIZE );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "memset_result",
+	 memset_result );
+
+	result = libqcow_io_uring_grab(
+	          io_uring,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	io_uring_grabbed = 1;
+
+	/* The last part is read first so that it is not merged with the other parts
+	 */
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          (off64_t) ( ( read_size / 3 ) * 2 ),
+	          &( read_buffer[ ( read_size / 3 ) * 2 ] ),
+	          read_size / 3,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          0,
+	          read_buffer,
+	          read_size / 3,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* This read exceeds the queue depth and is adjacent to the previous read
+	 */
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          (off64_t) ( read_size / 3 ),
+	          &( read_buffer[ read_size / 3 ] ),
+	          read_size / 3,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_io_uring_submit(
+	          io_uring,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          read_buffer,
+	          expected_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_io_uring_release(
+	          io_uring,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	io_uring_grabbed = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_io_uring_append_read(
+	          NULL,
+	          0,
+	          read_buffer,
+	          read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          -1,
+	          read_buffer,
+	          read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          0,
+	          NULL,
+	          read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_append_read(
+	          io_uring,
+	          0,
+	          read_buffer,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_submit(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_grab(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_io_uring_release(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_io_uring_free(
+	          &io_uring,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( io_uring != NULL )
+	{
+		libqcow_io_uring_discard_reads(
+		 io_uring,
+		 NULL );
+
+		if( io_uring_grabbed != 0 )
+		{
+			libqcow_io_uring_release(
+			 io_uring,
+			 NULL );
+		}
+		libqcow_io_uring_free(
+		 &io_uring,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_IO_URING ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc,
+     char * const argv[] )
+#endif
+{
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_IO_URING ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	char *source = NULL;
+
+	if( argc > 1 )
+	{
+		source = argv[ 1 ];
+	}
+	QCOW_TEST_RUN(
+	 "libqcow_io_uring_free",
+	 qcow_test_io_uring_free );
+
+	if( source != NULL )
+	{
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_io_uring_initialize",
+		 qcow_test_io_uring_initialize,
+		 source );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_io_uring_append_read",
+		 qcow_test_io_uring_append_read,
+		 source );
+	}
+#else
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_IO_URING ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER ) */
+
+	return( EXIT_SUCCESS );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_IO_URING ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+on_error:
+	return( EXIT_FAILURE );
+#endif
+}
+
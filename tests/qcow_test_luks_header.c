@@ -0,0 +1,1312 @@
+/*
+ * Library luks_header type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_functions.h"
+#include "qcow_test_libbfio.h"
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_hash.h"
+#include "../libqcow/libqcow_luks_header.h"
+
+uint8_t qcow_test_luks_header_data1[ 592 ] = {
+	0x4c, 0x55, 0x4b, 0x53, 0xba, 0xbe, 0x00, 0x01, 0x61, 0x65, 0x73, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x78, 0x74, 0x73, 0x2d, 0x70, 0x6c, 0x61, 0x69,
+	0x6e, 0x36, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x73, 0x68, 0x61, 0x32, 0x35, 0x36, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x20,
+	0x59, 0x36, 0x66, 0x62, 0x8f, 0x57, 0x2a, 0x6f, 0xc6, 0x17, 0x43, 0x3d, 0x12, 0x8e, 0xd2, 0xa7,
+	0xee, 0xf3, 0xfc, 0x2c, 0x00, 0x03, 0x06, 0x09, 0x0c, 0x0f, 0x12, 0x15, 0x18, 0x1b, 0x1e, 0x21,
+	0x24, 0x27, 0x2a, 0x2d, 0x30, 0x33, 0x36, 0x39, 0x3c, 0x3f, 0x42, 0x45, 0x48, 0x4b, 0x4e, 0x51,
+	0x54, 0x57, 0x5a, 0x5d, 0x00, 0x00, 0x00, 0x0a, 0x36, 0x65, 0x38, 0x65, 0x66, 0x35, 0x61, 0x31,
+	0x2d, 0x35, 0x61, 0x37, 0x37, 0x2d, 0x34, 0x64, 0x39, 0x62, 0x2d, 0x38, 0x62, 0x62, 0x38, 0x2d,
+	0x33, 0x61, 0x64, 0x30, 0x62, 0x34, 0x63, 0x34, 0x66, 0x31, 0x65, 0x66, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0xac, 0x71, 0xf3, 0x00, 0x00, 0x00, 0x0a, 0x40, 0x47, 0x4e, 0x55, 0x5c, 0x63, 0x6a, 0x71,
+	0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc, 0xd3, 0xda, 0xe1,
+	0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xde, 0xad, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+uint8_t qcow_test_luks_header_key_material1[ 512 ] = {
+	0xbf, 0x63, 0xb7, 0x78, 0x5e, 0x2b, 0xaa, 0xa3, 0x93, 0x73, 0x26, 0x60, 0x14, 0x16, 0x7a, 0x62,
+	0xc4, 0x74, 0xe4, 0xf9, 0x8f, 0x8f, 0x46, 0x3d, 0x68, 0x7e, 0xe0, 0x38, 0x5c, 0x4c, 0x2e, 0xc8,
+	0x36, 0xae, 0xdb, 0xc2, 0x88, 0xb4, 0x3c, 0x3d, 0x3c, 0x44, 0x57, 0x69, 0xa1, 0xd1, 0xe9, 0xde,
+	0x16, 0xd4, 0xcc, 0x87, 0x93, 0xdc, 0xd3, 0x7f, 0x19, 0x34, 0xb2, 0xae, 0xe5, 0x25, 0xfe, 0x51,
+	0xc1, 0xfe, 0x69, 0x93, 0x0a, 0xd7, 0x08, 0xdb, 0x9f, 0x6d, 0x94, 0xf6, 0x56, 0xdb, 0x2d, 0xba,
+	0x3e, 0x98, 0xb8, 0xd9, 0x39, 0x33, 0x45, 0xd2, 0xbf, 0xec, 0x1d, 0xda, 0x14, 0xdc, 0xe2, 0x69,
+	0xb1, 0xee, 0x82, 0x7e, 0x78, 0x66, 0x9c, 0xa7, 0xa9, 0xee, 0x78, 0x69, 0x68, 0x27, 0x13, 0xe6,
+	0x2e, 0x7a, 0x72, 0x6c, 0x10, 0xd1, 0x54, 0x74, 0x04, 0x73, 0x14, 0xe3, 0xd9, 0x32, 0x60, 0xea,
+	0xcd, 0xae, 0x6b, 0x3d, 0x8f, 0x21, 0x11, 0xdb, 0xf9, 0x21, 0xf5, 0x2f, 0xaf, 0xa0, 0x97, 0xfc,
+	0x3c, 0xcf, 0xd3, 0x5d, 0xd4, 0xba, 0xe7, 0x20, 0x2a, 0x06, 0xa3, 0xe1, 0xaf, 0xca, 0x0f, 0xe1,
+	0xa8, 0xec, 0xea, 0x0e, 0x65, 0xc9, 0x7b, 0xe9, 0x78, 0xe7, 0x9c, 0x8a, 0xc8, 0x99, 0x7b, 0x88,
+	0x42, 0x58, 0xd6, 0xd5, 0x13, 0xd8, 0xef, 0x9a, 0xff, 0x49, 0x63, 0x3f, 0x1b, 0x56, 0xc9, 0xa8,
+	0x71, 0xbc, 0x8f, 0x91, 0x63, 0x99, 0x87, 0xad, 0x33, 0x58, 0x27, 0x5b, 0x27, 0xe4, 0x07, 0x28,
+	0x19, 0x50, 0x27, 0x77, 0x18, 0x3d, 0x74, 0xad, 0x99, 0xf4, 0xcf, 0x5b, 0xcf, 0xe8, 0x0e, 0x02,
+	0x26, 0xd8, 0x58, 0x16, 0x83, 0x93, 0x10, 0x13, 0x24, 0xd3, 0x62, 0xb8, 0xd4, 0x1c, 0xc4, 0x8b,
+	0xe7, 0x87, 0x60, 0xa4, 0xda, 0x35, 0xe5, 0x14, 0xcc, 0xe7, 0xab, 0xf7, 0x78, 0x96, 0xc6, 0x50,
+	0x7b, 0xd4, 0x9c, 0x72, 0x5a, 0xb4, 0xd1, 0xe8, 0x55, 0x29, 0xc6, 0xc4, 0x76, 0x40, 0x5d, 0x9c,
+	0x85, 0x9b, 0x52, 0x75, 0x1e, 0xea, 0xb8, 0xd3, 0xa3, 0x6a, 0xa0, 0xf5, 0xa9, 0xa9, 0x20, 0x04,
+	0x57, 0x2d, 0x81, 0x3d, 0xca, 0x0e, 0x63, 0x44, 0x9c, 0x3f, 0x8f, 0x56, 0x67, 0x0c, 0x40, 0xb0,
+	0xa5, 0xcd, 0x0c, 0x6c, 0x65, 0x02, 0x39, 0x55, 0x4d, 0x53, 0xad, 0x04, 0xd3, 0x2b, 0x38, 0x3f,
+	0x19, 0xe0, 0xeb, 0x15, 0xb6, 0xb5, 0x29, 0x06, 0x2d, 0x4e, 0x6b, 0xa6, 0xeb, 0x68, 0xd9, 0x53,
+	0x87, 0x6c, 0x37, 0xaa, 0xb9, 0x2a, 0xbf, 0x8d, 0x09, 0x35, 0x9d, 0x4b, 0xa2, 0xa3, 0x1d, 0xb6,
+	0xe8, 0x21, 0xa4, 0x26, 0x10, 0x66, 0x2f, 0x4c, 0x86, 0xc7, 0x03, 0x64, 0x71, 0x71, 0x76, 0xa3,
+	0xe6, 0xad, 0xd2, 0xf1, 0x0d, 0x3b, 0x1b, 0x12, 0x8c, 0x38, 0x23, 0x2a, 0xdd, 0x34, 0x69, 0xca,
+	0x67, 0xb9, 0xc2, 0x8d, 0x82, 0xc1, 0xcb, 0x13, 0x2e, 0x9e, 0x80, 0xc2, 0xca, 0x21, 0x80, 0x72,
+	0x67, 0x4d, 0xa5, 0x0b, 0x72, 0x52, 0x46, 0x38, 0xa7, 0x23, 0x21, 0x10, 0x51, 0x03, 0xeb, 0xb7,
+	0xa3, 0xc7, 0xbe, 0x64, 0xdf, 0xa8, 0x5f, 0x45, 0x05, 0x01, 0x4b, 0xfb, 0x23, 0xda, 0x0f, 0x95,
+	0xfc, 0xc0, 0xd0, 0xaf, 0x65, 0xcd, 0xb3, 0xcd, 0xad, 0xb3, 0x5b, 0xb8, 0xb7, 0xad, 0xdc, 0x7a,
+	0x76, 0xbd, 0xd4, 0x20, 0x92, 0x47, 0xd2, 0x49, 0xf0, 0x87, 0x43, 0x7c, 0x81, 0xf5, 0x37, 0x10,
+	0xf3, 0x6b, 0x72, 0x56, 0xe7, 0xfb, 0x0c, 0x45, 0x97, 0xe1, 0x3a, 0xb6, 0x93, 0xc4, 0x82, 0x86,
+	0x2c, 0x71, 0x60, 0x85, 0x2f, 0xeb, 0x96, 0x30, 0x33, 0xea, 0x8b, 0xf5, 0x8a, 0x50, 0x79, 0xec,
+	0x58, 0x65, 0x9a, 0xa8, 0x58, 0xd9, 0x91, 0xad, 0x41, 0xf4, 0x1f, 0xb3, 0x36, 0x0c, 0x4e, 0x63 };
+
+uint8_t qcow_test_luks_header_stripes1[ 64 ] = {
+	0x80, 0x85, 0x8a, 0x8f, 0x94, 0x99, 0x9e, 0xa3, 0xa8, 0xad, 0xb2, 0xb7, 0xbc, 0xc1, 0xc6, 0xcb,
+	0xd0, 0xd5, 0xda, 0xdf, 0xe4, 0xe9, 0xee, 0xf3, 0xf8, 0xfd, 0x02, 0x07, 0x0c, 0x11, 0x16, 0x1b,
+	0x92, 0x10, 0x93, 0x90, 0xa5, 0x46, 0x70, 0xb7, 0x48, 0x3f, 0xba, 0xcf, 0xf3, 0xd7, 0x09, 0x99,
+	0x79, 0x2a, 0xaf, 0x69, 0x5b, 0x62, 0x11, 0xd4, 0xcb, 0xbd, 0x68, 0xd5, 0x97, 0xbe, 0xe2, 0xb8 };
+
+uint8_t qcow_test_luks_header_master_key1[ 32 ] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f };
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_luks_header_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_initialize(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_luks_header_t *luks_header = NULL;
+	int result                         = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests    = 1;
+	int number_of_memset_fail_tests    = 1;
+	int test_number                    = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_luks_header_free(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_initialize(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	luks_header = (libqcow_luks_header_t *) 0x12345678UL;
+
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	luks_header = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_luks_header_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_luks_header_initialize(
+		          &luks_header,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( luks_header != NULL )
+			{
+				libqcow_luks_header_free(
+				 &luks_header,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "luks_header",
+			 luks_header );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_luks_header_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_luks_header_initialize(
+		          &luks_header,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( luks_header != NULL )
+			{
+				libqcow_luks_header_free(
+				 &luks_header,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "luks_header",
+			 luks_header );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_luks_header_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_luks_header_read_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_read_data(
+     void )
+{
+	uint8_t data[ 592 ];
+
+	libcerror_error_t *error           = NULL;
+	libqcow_luks_header_t *luks_header = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          qcow_test_luks_header_data1,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "luks_header->format_version",
+	 luks_header->format_version,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "luks_header->hash_type",
+	 luks_header->hash_type,
+	 LIBQCOW_HASH_TYPE_SHA256 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "luks_header->master_key_size",
+	 luks_header->master_key_size,
+	 32 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "luks_header->master_key_number_of_iterations",
+	 luks_header->master_key_number_of_iterations,
+	 10 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "luks_header->key_slots[ 0 ].state",
+	 luks_header->key_slots[ 0 ].state,
+	 (uint32_t) LIBQCOW_LUKS_KEY_SLOT_STATE_ENABLED );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "luks_header->key_slots[ 0 ].key_material_sector_number",
+	 luks_header->key_slots[ 0 ].key_material_sector_number,
+	 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "luks_header->key_slots[ 0 ].number_of_stripes",
+	 luks_header->key_slots[ 0 ].number_of_stripes,
+	 2 );
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_read_data(
+	          NULL,
+	          qcow_test_luks_header_data1,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          NULL,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          qcow_test_luks_header_data1,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          qcow_test_luks_header_data1,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where signature is invalid
+	 */
+	if( memory_copy(
+	     data,
+	     qcow_test_luks_header_data1,
+	     592 ) == NULL )
+	{
+		goto on_error;
+	}
+	data[ 0 ] = 0xff;
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          data,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the encryption chaining mode is not supported
+	 */
+	if( memory_copy(
+	     data,
+	     qcow_test_luks_header_data1,
+	     592 ) == NULL )
+	{
+		goto on_error;
+	}
+	data[ 40 ] = 'c';
+	data[ 41 ] = 'b';
+	data[ 42 ] = 'c';
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          data,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_luks_header_free(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_luks_header_verify_master_key function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_verify_master_key(
+     void )
+{
+	uint8_t master_key[ 32 ];
+
+	libcerror_error_t *error           = NULL;
+	libqcow_luks_header_t *luks_header = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          qcow_test_luks_header_data1,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_luks_header_verify_master_key(
+	          luks_header,
+	          qcow_test_luks_header_master_key1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( memory_copy(
+	     master_key,
+	     qcow_test_luks_header_master_key1,
+	     32 ) == NULL )
+	{
+		goto on_error;
+	}
+	master_key[ 31 ] ^= 0x01;
+
+	result = libqcow_luks_header_verify_master_key(
+	          luks_header,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test a master key size that does not match the master key size in the header
+	 */
+	result = libqcow_luks_header_verify_master_key(
+	          luks_header,
+	          qcow_test_luks_header_master_key1,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_verify_master_key(
+	          NULL,
+	          qcow_test_luks_header_master_key1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_verify_master_key(
+	          luks_header,
+	          NULL,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_luks_header_free(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_luks_header_merge_stripes function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_merge_stripes(
+     void )
+{
+	uint8_t master_key[ 32 ];
+
+	libcerror_error_t *error           = NULL;
+	libqcow_luks_header_t *luks_header = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_luks_header_read_data(
+	          luks_header,
+	          qcow_test_luks_header_data1,
+	          592,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_luks_header_merge_stripes(
+	          luks_header,
+	          qcow_test_luks_header_stripes1,
+	          64,
+	          2,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          master_key,
+	          qcow_test_luks_header_master_key1,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_merge_stripes(
+	          NULL,
+	          qcow_test_luks_header_stripes1,
+	          64,
+	          2,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_merge_stripes(
+	          luks_header,
+	          NULL,
+	          64,
+	          2,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_merge_stripes(
+	          luks_header,
+	          qcow_test_luks_header_stripes1,
+	          32,
+	          2,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_merge_stripes(
+	          luks_header,
+	          qcow_test_luks_header_stripes1,
+	          64,
+	          2,
+	          NULL,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_luks_header_free(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_luks_header_get_master_key_with_password function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_luks_header_get_master_key_with_password(
+     void )
+{
+	uint8_t data[ 1536 ];
+	uint8_t master_key[ 32 ];
+
+	uint8_t password1[ 8 ] = {
+		'p', 'a', 's', 's', 'w', 'o', 'r', 'd' };
+
+	uint8_t password2[ 8 ] = {
+		'P', 'A', 'S', 'S', 'W', 'O', 'R', 'D' };
+
+	libbfio_handle_t *file_io_handle   = NULL;
+	libcerror_error_t *error           = NULL;
+	libqcow_luks_header_t *luks_header = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 * The key material of the first key slot is stored in sector 2
+	 */
+	if( memory_set(
+	     data,
+	     0,
+	     1536 ) == NULL )
+	{
+		goto on_error;
+	}
+	if( memory_copy(
+	     data,
+	     qcow_test_luks_header_data1,
+	     592 ) == NULL )
+	{
+		goto on_error;
+	}
+	if( memory_copy(
+	     &( data[ 1024 ] ),
+	     qcow_test_luks_header_key_material1,
+	     512 ) == NULL )
+	{
+		goto on_error;
+	}
+	result = libqcow_luks_header_initialize(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Initialize file IO handle
+	 */
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          1536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_luks_header_read_file_io_handle(
+	          luks_header,
+	          file_io_handle,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_luks_header_get_master_key_with_password(
+	          luks_header,
+	          file_io_handle,
+	          0,
+	          password1,
+	          8,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          master_key,
+	          qcow_test_luks_header_master_key1,
+	          32 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_luks_header_get_master_key_with_password(
+	          luks_header,
+	          file_io_handle,
+	          0,
+	          password2,
+	          8,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_luks_header_get_master_key_with_password(
+	          NULL,
+	          file_io_handle,
+	          0,
+	          password1,
+	          8,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_get_master_key_with_password(
+	          luks_header,
+	          file_io_handle,
+	          0,
+	          NULL,
+	          8,
+	          master_key,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_luks_header_get_master_key_with_password(
+	          luks_header,
+	          file_io_handle,
+	          0,
+	          password1,
+	          8,
+	          master_key,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up file IO handle
+	 */
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_luks_header_free(
+	          &luks_header,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "luks_header",
+	 luks_header );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( luks_header != NULL )
+	{
+		libqcow_luks_header_free(
+		 &luks_header,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_initialize",
+	 qcow_test_luks_header_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_free",
+	 qcow_test_luks_header_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_read_data",
+	 qcow_test_luks_header_read_data );
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_verify_master_key",
+	 qcow_test_luks_header_verify_master_key );
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_merge_stripes",
+	 qcow_test_luks_header_merge_stripes );
+
+	QCOW_TEST_RUN(
+	 "libqcow_luks_header_get_master_key_with_password",
+	 qcow_test_luks_header_get_master_key_with_password );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
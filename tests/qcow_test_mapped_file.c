@@ -0,0 +1,529 @@
+/*
+ * Library mapped_file type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_mapped_file.h"
+
+#define QCOW_TEST_MAPPED_FILE_READ_BUFFER_SIZE	4096
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MAPPED_FILE ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+
+/* Tests the libqcow_mapped_file_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapped_file_initialize(
+     const char *source )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_mapped_file_t *mapped_file = NULL;
+	int result                         = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_mapped_file_initialize(
+	          &mapped_file,
+	          source,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The file cannot be mapped if it is empty
+	 */
+	if( result == 0 )
+	{
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "mapped_file",
+		 mapped_file );
+
+		return( 1 );
+	}
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "mapped_file",
+	 mapped_file );
+
+	/* Test error cases
+	 */
+	result = libqcow_mapped_file_initialize(
+	          &mapped_file,
+	          source,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_free(
+	          &mapped_file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "mapped_file",
+	 mapped_file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_mapped_file_initialize(
+	          NULL,
+	          source,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_initialize(
+	          &mapped_file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( mapped_file != NULL )
+	{
+		libqcow_mapped_file_free(
+		 &mapped_file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_mapped_file_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapped_file_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_mapped_file_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_mapped_file_get_data_at_offset and libqcow_mapped_file_copy_data_at_offset functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapped_file_get_data_at_offset(
+     const char *source )
+{
+	uint8_t expected_buffer[ QCOW_TEST_MAPPED_FILE_READ_BUFFER_SIZE ];
+	uint8_t read_buffer[ QCOW_TEST_MAPPED_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error           = NULL;
+	libqcow_mapped_file_t *mapped_file = NULL;
+	const uint8_t *data                = NULL;
+	FILE *file_stream                  = NULL;
+	size_t read_size                   = 0;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	file_stream = file_stream_open(
+	               source,
+	               "rb" );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_stream",
+	 file_stream );
+
+	read_size = file_stream_read(
+	             file_stream,
+	             expected_buffer,
+	             QCOW_TEST_MAPPED_FILE_READ_BUFFER_SIZE );
+
+	file_stream_close(
+	 file_stream );
+
+	if( read_size < 2 )
+	{
+		return( 1 );
+	}
+	result = libqcow_mapped_file_initialize(
+	          &mapped_file,
+	          source,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          0,
+	          read_size,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          data,
+	          expected_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_mapped_file_copy_data_at_offset(
+	          mapped_file,
+	          1,
+	          read_buffer,
+	          read_size - 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          read_buffer,
+	          &( expected_buffer[ 1 ] ),
+	          read_size - 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Data beyond the end of the mapped data is not available
+	 */
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          (off64_t) mapped_file->data_size,
+	          1,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          1,
+	          mapped_file->data_size,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_mapped_file_get_data_at_offset(
+	          NULL,
+	          0,
+	          read_size,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          -1,
+	          read_size,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          0,
+	          (size_t) SSIZE_MAX + 1,
+	          &data,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_get_data_at_offset(
+	          mapped_file,
+	          0,
+	          read_size,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapped_file_copy_data_at_offset(
+	          mapped_file,
+	          0,
+	          NULL,
+	          read_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_mapped_file_free(
+	          &mapped_file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( mapped_file != NULL )
+	{
+		libqcow_mapped_file_free(
+		 &mapped_file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MAPPED_FILE ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc,
+     char * const argv[] )
+#endif
+{
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MAPPED_FILE ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	char *source = NULL;
+
+	if( argc > 1 )
+	{
+		source = argv[ 1 ];
+	}
+	QCOW_TEST_RUN(
+	 "libqcow_mapped_file_free",
+	 qcow_test_mapped_file_free );
+
+	if( source != NULL )
+	{
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_mapped_file_initialize",
+		 qcow_test_mapped_file_initialize,
+		 source );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_mapped_file_get_data_at_offset",
+		 qcow_test_mapped_file_get_data_at_offset,
+		 source );
+	}
+#else
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MAPPED_FILE ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER ) */
+
+	return( EXIT_SUCCESS );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MAPPED_FILE ) && !defined( HAVE_WIDE_SYSTEM_CHARACTER )
+on_error:
+	return( EXIT_FAILURE );
+#endif
+}
+
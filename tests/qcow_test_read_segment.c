@@ -0,0 +1,254 @@
+/*
+ * Library read_segment type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_read_segment.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_read_segment_compare_by_media_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_segment_compare_by_media_offset(
+     void )
+{
+	libqcow_read_segment_t first_read_segment;
+	libqcow_read_segment_t second_read_segment;
+
+	int result = 0;
+
+	/* Initialize test
+	 */
+	first_read_segment.media_offset  = 4096;
+	first_read_segment.file_offset   = 65536;
+	first_read_segment.vector_index  = 0;
+
+	second_read_segment.media_offset = 8192;
+	second_read_segment.file_offset  = 0;
+	second_read_segment.vector_index = 1;
+
+	/* Test regular cases
+	 */
+	result = libqcow_read_segment_compare_by_media_offset(
+	          &first_read_segment,
+	          &second_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	result = libqcow_read_segment_compare_by_media_offset(
+	          &second_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libqcow_read_segment_compare_by_media_offset(
+	          &first_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test read segments with the same media offset of different read vectors
+	 */
+	second_read_segment.media_offset = 4096;
+
+	result = libqcow_read_segment_compare_by_media_offset(
+	          &first_read_segment,
+	          &second_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	result = libqcow_read_segment_compare_by_media_offset(
+	          &second_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+/* Tests the libqcow_read_segment_compare_by_file_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_segment_compare_by_file_offset(
+     void )
+{
+	libqcow_read_segment_t first_read_segment;
+	libqcow_read_segment_t second_read_segment;
+
+	int result = 0;
+
+	/* Initialize test
+	 */
+	first_read_segment.media_offset           = 4096;
+	first_read_segment.file_offset            = 65536;
+	first_read_segment.vector_index           = 0;
+	first_read_segment.cluster_block_is_zero  = 0;
+
+	second_read_segment.media_offset          = 8192;
+	second_read_segment.file_offset           = 0;
+	second_read_segment.vector_index          = 1;
+	second_read_segment.cluster_block_is_zero = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &first_read_segment,
+	          &second_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &second_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &first_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test read segments with the same file offset are ordered by media offset
+	 */
+	second_read_segment.file_offset = 65536;
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &first_read_segment,
+	          &second_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &second_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* Test read segments that are not allocated are ordered before read segments that read as zero
+	 */
+	first_read_segment.file_offset            = 0;
+	second_read_segment.file_offset           = 0;
+	first_read_segment.cluster_block_is_zero  = 1;
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &first_read_segment,
+	          &second_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libqcow_read_segment_compare_by_file_offset(
+	          &second_read_segment,
+	          &first_read_segment );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	return( 1 );
+
+on_error:
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_segment_compare_by_media_offset",
+	 qcow_test_read_segment_compare_by_media_offset );
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_segment_compare_by_file_offset",
+	 qcow_test_read_segment_compare_by_file_offset );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
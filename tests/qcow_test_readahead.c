@@ -0,0 +1,707 @@
+/*
+ * Library readahead type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_libcthreads.h"
+#include "../libqcow/libqcow_readahead.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* The offsets of the blocks read by the read block test function
+ */
+off64_t qcow_test_readahead_block_offsets[ 16 ];
+
+int qcow_test_readahead_number_of_block_offsets = 0;
+
+/* Read block test function that records the offset of the block
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_readahead_read_block(
+     intptr_t *data_handle QCOW_TEST_ATTRIBUTE_UNUSED,
+     off64_t block_offset,
+     libcerror_error_t **error QCOW_TEST_ATTRIBUTE_UNUSED )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( data_handle )
+	QCOW_TEST_UNREFERENCED_PARAMETER( error )
+
+	if( qcow_test_readahead_number_of_block_offsets < 16 )
+	{
+		qcow_test_readahead_block_offsets[ qcow_test_readahead_number_of_block_offsets++ ] = block_offset;
+	}
+	return( 1 );
+}
+
+/* Tests the libqcow_readahead_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_readahead_initialize(
+     void )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_readahead_t *readahead = NULL;
+	int result                     = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_readahead_free(
+	          &readahead,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_readahead_initialize(
+	          NULL,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	readahead = (libqcow_readahead_t *) 0x12345678UL;
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	readahead = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          NULL,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          0,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          LIBQCOW_MAXIMUM_NUMBER_OF_READAHEAD_CLUSTER_BLOCKS + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( readahead != NULL )
+	{
+		libqcow_readahead_free(
+		 &readahead,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_readahead_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_readahead_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_readahead_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_readahead_update function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_readahead_update(
+     void )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_readahead_t *readahead = NULL;
+	int result                     = 0;
+
+	/* Initialize test
+	 */
+	qcow_test_readahead_number_of_block_offsets = 0;
+
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_readahead_update(
+	          readahead,
+	          0,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The first read is not considered sequential
+	 */
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "readahead->range_end_offset",
+	 (int64_t) readahead->range_end_offset,
+	 (int64_t) readahead->next_block_offset );
+
+	result = libqcow_readahead_update(
+	          readahead,
+	          512,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Wait for the worker thread to read the 4 blocks that follow the read
+	 */
+	result = libcthreads_mutex_grab(
+	          readahead->mutex,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	while( readahead->number_of_blocks_read < 4 )
+	{
+		result = libcthreads_condition_wait(
+		          readahead->block_read_condition,
+		          readahead->mutex,
+		          &error );
+
+		if( result != 1 )
+		{
+			break;
+		}
+	}
+	libcthreads_mutex_release(
+	 readahead->mutex,
+	 NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "qcow_test_readahead_number_of_block_offsets",
+	 qcow_test_readahead_number_of_block_offsets,
+	 4 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "qcow_test_readahead_block_offsets[ 0 ]",
+	 (int64_t) qcow_test_readahead_block_offsets[ 0 ],
+	 (int64_t) 1024 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "qcow_test_readahead_block_offsets[ 3 ]",
+	 (int64_t) qcow_test_readahead_block_offsets[ 3 ],
+	 (int64_t) 2560 );
+
+	/* A non sequential read cancels the remainder of the read ahead range
+	 */
+	result = libqcow_readahead_update(
+	          readahead,
+	          4096,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "readahead->range_end_offset",
+	 (int64_t) readahead->range_end_offset,
+	 (int64_t) readahead->next_block_offset );
+
+	/* Test error cases
+	 */
+	result = libqcow_readahead_update(
+	          NULL,
+	          0,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_update(
+	          readahead,
+	          -1,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_update(
+	          readahead,
+	          0,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_readahead_free(
+	          &readahead,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( readahead != NULL )
+	{
+		libqcow_readahead_free(
+		 &readahead,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_readahead_wait_for_block function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_readahead_wait_for_block(
+     void )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_readahead_t *readahead = NULL;
+	int result                     = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_readahead_initialize(
+	          &readahead,
+	          NULL,
+	          &qcow_test_readahead_read_block,
+	          512,
+	          8192,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_readahead_wait_for_block(
+	          readahead,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_readahead_wait_for_block(
+	          NULL,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_readahead_wait_for_block(
+	          readahead,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_readahead_free(
+	          &readahead,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "readahead",
+	 readahead );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( readahead != NULL )
+	{
+		libqcow_readahead_free(
+		 &readahead,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_readahead_initialize",
+	 qcow_test_readahead_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_readahead_free",
+	 qcow_test_readahead_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_readahead_update",
+	 qcow_test_readahead_update );
+
+	QCOW_TEST_RUN(
+	 "libqcow_readahead_wait_for_block",
+	 qcow_test_readahead_wait_for_block );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
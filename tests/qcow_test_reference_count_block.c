@@ -0,0 +1,1173 @@
+/*
+ * Library reference_count_block type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_functions.h"
+#include "qcow_test_libbfio.h"
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_reference_count_block.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_reference_count_block_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_reference_count_block_initialize(
+     void )
+{
+	libcerror_error_t *error                               = NULL;
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	int result                                             = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests                        = 2;
+	int number_of_memset_fail_tests                        = 2;
+	int test_number                                        = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          4096,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_free(
+	          &reference_count_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_reference_count_block_initialize(
+	          NULL,
+	          4096,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	reference_count_block = (libqcow_reference_count_block_t *) 0x12345678UL;
+
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          4096,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	reference_count_block = NULL;
+
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          (size_t) SSIZE_MAX + 1,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          4096,
+	          7,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_reference_count_block_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_reference_count_block_initialize(
+		          &reference_count_block,
+		          4096,
+		          4,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( reference_count_block != NULL )
+			{
+				libqcow_reference_count_block_free(
+				 &reference_count_block,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "reference_count_block",
+			 reference_count_block );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_reference_count_block_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_reference_count_block_initialize(
+		          &reference_count_block,
+		          4096,
+		          4,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( reference_count_block != NULL )
+			{
+				libqcow_reference_count_block_free(
+				 &reference_count_block,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "reference_count_block",
+			 reference_count_block );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( reference_count_block != NULL )
+	{
+		libqcow_reference_count_block_free(
+		 &reference_count_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_reference_count_block_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_reference_count_block_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_reference_count_block_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_reference_count_block_get_reference_count_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_reference_count_block_get_reference_count_by_index(
+     void )
+{
+	libcerror_error_t *error                               = NULL;
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	uint64_t reference_count                               = 0;
+	int result                                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          512,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	reference_count_block->data[ 6 ] = 0x01;
+	reference_count_block->data[ 7 ] = 0x02;
+
+	/* Test regular cases
+	 */
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          3,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0x0102 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          NULL,
+	          0,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          -1,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          256,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          0,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_reference_count_block_free(
+	          &reference_count_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( reference_count_block != NULL )
+	{
+		libqcow_reference_count_block_free(
+		 &reference_count_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_reference_count_block_set_reference_count_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_reference_count_block_set_reference_count_by_index(
+     void )
+{
+	libcerror_error_t *error                               = NULL;
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	uint64_t reference_count                               = 0;
+	int result                                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          512,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A newly initialized block is marked as modified in its entirety
+	 */
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "reference_count_block->modified_end_index",
+	 reference_count_block->modified_end_index,
+	 256 );
+
+	reference_count_block->modified_start_index = 0;
+	reference_count_block->modified_end_index   = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_reference_count_block_set_reference_count_by_index(
+	          reference_count_block,
+	          10,
+	          0xfffe,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_set_reference_count_by_index(
+	          reference_count_block,
+	          2,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "reference_count_block->modified_start_index",
+	 reference_count_block->modified_start_index,
+	 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "reference_count_block->modified_end_index",
+	 reference_count_block->modified_end_index,
+	 11 );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          10,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0xfffe );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_reference_count_block_set_reference_count_by_index(
+	          NULL,
+	          0,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_set_reference_count_by_index(
+	          reference_count_block,
+	          256,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test setting a reference count that exceeds the reference count size
+	 */
+	result = libqcow_reference_count_block_set_reference_count_by_index(
+	          reference_count_block,
+	          0,
+	          0x10000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_reference_count_block_free(
+	          &reference_count_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( reference_count_block != NULL )
+	{
+		libqcow_reference_count_block_free(
+		 &reference_count_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_reference_count_block_read function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_reference_count_block_read(
+     void )
+{
+	uint8_t data[ 4096 ];
+
+	libbfio_handle_t *file_io_handle                       = NULL;
+	libcerror_error_t *error                               = NULL;
+	libqcow_reference_count_block_t *reference_count_block = NULL;
+	uint64_t reference_count                               = 0;
+	int result                                             = 0;
+
+	/* Initialize test
+	 */
+	result = memory_set(
+	          data,
+	          0,
+	          4096 ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* 16-bit reference counts at offset 0
+	 */
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 0 ] ),
+	 1 );
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 10 ] ),
+	 0x1234 );
+	byte_stream_copy_from_uint16_big_endian(
+	 &( data[ 510 ] ),
+	 0xffff );
+
+	/* 32-bit reference counts at offset 2048
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 2048 ] ),
+	 2 );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 2060 ] ),
+	 0x12345678UL );
+	byte_stream_copy_from_uint32_big_endian(
+	 &( data[ 2556 ] ),
+	 0xffffffffUL );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          data,
+	          4096,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          512,
+	          4,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_reference_count_block_read(
+	          reference_count_block,
+	          file_io_handle,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "reference_count_block->number_of_reference_counts",
+	 reference_count_block->number_of_reference_counts,
+	 256 );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          0,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          1,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          5,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0x1234 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          255,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0xffff );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_reference_count_block_read(
+	          NULL,
+	          NULL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_read(
+	          reference_count_block,
+	          NULL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_read(
+	          reference_count_block,
+	          NULL,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test reading beyond the end of the data
+	 */
+	result = libqcow_reference_count_block_read(
+	          reference_count_block,
+	          file_io_handle,
+	          3840,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_reference_count_block_free(
+	          &reference_count_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases with a reference count order of 5
+	 */
+	result = libqcow_reference_count_block_initialize(
+	          &reference_count_block,
+	          512,
+	          5,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_read(
+	          reference_count_block,
+	          file_io_handle,
+	          2048,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "reference_count_block->number_of_reference_counts",
+	 reference_count_block->number_of_reference_counts,
+	 128 );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          0,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          3,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0x12345678UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_reference_count_block_get_reference_count_by_index(
+	          reference_count_block,
+	          127,
+	          &reference_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference_count",
+	 reference_count,
+	 (uint64_t) 0xffffffffUL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_reference_count_block_free(
+	          &reference_count_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "reference_count_block",
+	 reference_count_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( reference_count_block != NULL )
+	{
+		libqcow_reference_count_block_free(
+		 &reference_count_block,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_reference_count_block_initialize",
+	 qcow_test_reference_count_block_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_reference_count_block_free",
+	 qcow_test_reference_count_block_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_reference_count_block_get_reference_count_by_index",
+	 qcow_test_reference_count_block_get_reference_count_by_index );
+
+	QCOW_TEST_RUN(
+	 "libqcow_reference_count_block_set_reference_count_by_index",
+	 qcow_test_reference_count_block_set_reference_count_by_index );
+
+	QCOW_TEST_RUN(
+	 "libqcow_reference_count_block_read",
+	 qcow_test_reference_count_block_read );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
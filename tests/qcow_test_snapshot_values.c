@@ -0,0 +1,1036 @@
+/*
+ * Library snapshot_values type test program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_functions.h"
+#include "qcow_test_libbfio.h"
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_snapshot_values.h"
+
+uint8_t qcow_test_snapshot_values_data1[ 64 ] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x05,
+	0x63, 0x5a, 0x1e, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x31, 0x73, 0x6e, 0x61, 0x70, 0x31, 0x00, 0x00 };
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_snapshot_values_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_snapshot_values_initialize(
+     void )
+{
+	libcerror_error_t *error                   = NULL;
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	int result                                 = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests            = 1;
+	int number_of_memset_fail_tests            = 1;
+	int test_number                            = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_snapshot_values_initialize(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	snapshot_values = (libqcow_snapshot_values_t *) 0x12345678UL;
+
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	snapshot_values = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_snapshot_values_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_snapshot_values_initialize(
+		          &snapshot_values,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( snapshot_values != NULL )
+			{
+				libqcow_snapshot_values_free(
+				 &snapshot_values,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "snapshot_values",
+			 snapshot_values );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_snapshot_values_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_snapshot_values_initialize(
+		          &snapshot_values,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( snapshot_values != NULL )
+			{
+				libqcow_snapshot_values_free(
+				 &snapshot_values,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "snapshot_values",
+			 snapshot_values );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_snapshot_values_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_snapshot_values_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_snapshot_values_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_snapshot_values_read_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_snapshot_values_read_data(
+     void )
+{
+	libcerror_error_t *error                   = NULL;
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	int result                                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "snapshot_values->level1_table_offset",
+	 (int64_t) snapshot_values->level1_table_offset,
+	 (int64_t) 0x00030000L );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "snapshot_values->number_of_level1_table_references",
+	 snapshot_values->number_of_level1_table_references,
+	 (uint32_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "snapshot_values->identifier_size",
+	 snapshot_values->identifier_size,
+	 (size_t) 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "snapshot_values->name_size",
+	 snapshot_values->name_size,
+	 (size_t) 5 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "snapshot_values->media_size",
+	 (uint64_t) snapshot_values->media_size,
+	 (uint64_t) 4194304 );
+
+	/* Test error cases
+	 */
+	result = libqcow_snapshot_values_read_data(
+	          NULL,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          NULL,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          39,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          (size_t) SSIZE_MAX + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          60,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the level 1 table offset is 0
+	 */
+	qcow_test_snapshot_values_data1[ 5 ] = 0x00;
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	qcow_test_snapshot_values_data1[ 5 ] = 0x03;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_snapshot_values_read_file_io_handle function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_snapshot_values_read_file_io_handle(
+     void )
+{
+	libbfio_handle_t *file_io_handle           = NULL;
+	libcerror_error_t *error                   = NULL;
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	size_t entry_size                          = 0;
+	int result                                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Initialize file IO handle
+	 */
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          snapshot_values,
+	          file_io_handle,
+	          0,
+	          &entry_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "entry_size",
+	 entry_size,
+	 (size_t) 64 );
+
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          NULL,
+	          file_io_handle,
+	          0,
+	          &entry_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          snapshot_values,
+	          NULL,
+	          0,
+	          &entry_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          snapshot_values,
+	          file_io_handle,
+	          -1,
+	          &entry_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          snapshot_values,
+	          file_io_handle,
+	          0,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the entry data is truncated
+	 */
+	result = libqcow_snapshot_values_read_file_io_handle(
+	          snapshot_values,
+	          file_io_handle,
+	          32,
+	          &entry_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up file IO handle
+	 */
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_snapshot_values_get_utf8_name function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_snapshot_values_get_utf8_name(
+     void )
+{
+	uint8_t utf8_string[ 16 ];
+
+	libcerror_error_t *error                   = NULL;
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	size_t utf8_string_size                    = 0;
+	int result                                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_snapshot_values_initialize(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_snapshot_values_read_data(
+	          snapshot_values,
+	          qcow_test_snapshot_values_data1,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_snapshot_values_get_utf8_name_size(
+	          snapshot_values,
+	          &utf8_string_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "utf8_string_size",
+	 utf8_string_size,
+	 (size_t) 6 );
+
+	result = libqcow_snapshot_values_get_utf8_name(
+	          snapshot_values,
+	          utf8_string,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          utf8_string,
+	          "snap1",
+	          6 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_snapshot_values_get_utf8_name_size(
+	          NULL,
+	          &utf8_string_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_get_utf8_name(
+	          snapshot_values,
+	          NULL,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_snapshot_values_get_utf8_name(
+	          snapshot_values,
+	          utf8_string,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_snapshot_values_free(
+	          &snapshot_values,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "snapshot_values",
+	 snapshot_values );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_snapshot_values_initialize",
+	 qcow_test_snapshot_values_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_snapshot_values_free",
+	 qcow_test_snapshot_values_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_snapshot_values_read_data",
+	 qcow_test_snapshot_values_read_data );
+
+	QCOW_TEST_RUN(
+	 "libqcow_snapshot_values_read_file_io_handle",
+	 qcow_test_snapshot_values_read_file_io_handle );
+
+	QCOW_TEST_RUN(
+	 "libqcow_snapshot_values_get_utf8_name",
+	 qcow_test_snapshot_values_get_utf8_name );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -199,6 +199,123 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_get_cache_budget function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_get_cache_budget(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t cache_budget    = 0;
+	int result               = 0;
+
+	result = libqcow_get_cache_budget(
+	          &cache_budget,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_get_cache_budget(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_set_cache_budget function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_set_cache_budget(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	size64_t cache_budget    = 0;
+	int result               = 0;
+
+	result = libqcow_set_cache_budget(
+	          4 * 1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_get_cache_budget(
+	          &cache_budget,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cache_budget",
+	 (uint64_t) cache_budget,
+	 (uint64_t) 4 * 1024 * 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_set_cache_budget(
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_check_file_signature function
  * Returns 1 if successful or 0 if not
  */
@@ -768,6 +885,14 @@ int main(
 	 "libqcow_set_codepage",
 	 qcow_test_set_codepage );
 
+	QCOW_TEST_RUN(
+	 "libqcow_get_cache_budget",
+	 qcow_test_get_cache_budget );
+
+	QCOW_TEST_RUN(
+	 "libqcow_set_cache_budget",
+	 qcow_test_set_cache_budget );
+
 #if !defined( __BORLANDC__ ) || ( __BORLANDC__ >= 0x0560 )
 
 	QCOW_TEST_RUN_WITH_ARGS(
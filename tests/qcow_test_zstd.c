@@ -0,0 +1,1200 @@
+/*
+ * Library Zstandard (zstd) decompression testing program
+ *
+ * Copyright (C) 2010-2022, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libcnotify.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_zstd.h"
+
+/* Define to make qcow_test_zstd generate verbose output
+#define QCOW_TEST_ZSTD
+ */
+
+/* The test data is the same text as used by qcow_test_deflate, compressed with: zstd -19
+ */
+uint8_t qcow_test_zstd_compressed_byte_stream[ 2566 ] = {
+	0x28, 0xb5, 0x2f, 0xfd, 0x64, 0xd8, 0x1c, 0xc5, 0x4f, 0x00, 0x8a, 0x59, 0x88, 0x0e, 0x28, 0xe0,
+	0x74, 0xdb, 0x1c, 0x28, 0x88, 0x84, 0x28, 0x6b, 0xb4, 0x7d, 0x04, 0xb1, 0x6f, 0xb9, 0x44, 0xb2,
+	0x5c, 0x8e, 0x9f, 0x93, 0x71, 0xa8, 0x6a, 0x1a, 0x3e, 0xf0, 0xe0, 0x3f, 0x15, 0x18, 0x05, 0xd2,
+	0x31, 0x8c, 0x31, 0x00, 0x0c, 0x7e, 0x01, 0xea, 0x00, 0xdb, 0x00, 0xd6, 0x00, 0xc6, 0x89, 0xa2,
+	0x2e, 0x6f, 0x36, 0x34, 0x2e, 0x32, 0x34, 0x14, 0xd4, 0x9c, 0x57, 0xcf, 0x5c, 0xdd, 0x68, 0x58,
+	0x61, 0x79, 0x7d, 0x63, 0xf5, 0x7d, 0xde, 0x09, 0x3f, 0x58, 0x32, 0x8f, 0x30, 0xe1, 0x07, 0x81,
+	0xc7, 0x77, 0x17, 0x2a, 0x9c, 0x2c, 0xec, 0xce, 0xd7, 0xf3, 0xbc, 0xb5, 0x82, 0x0e, 0x6c, 0x2a,
+	0xd6, 0xd2, 0x3a, 0x7a, 0x87, 0xf6, 0x0e, 0xb5, 0x3d, 0xda, 0x12, 0xcb, 0x0b, 0x2f, 0x2f, 0x83,
+	0x17, 0xea, 0xd9, 0x27, 0x58, 0xbf, 0xfb, 0x47, 0x36, 0xd8, 0x08, 0xa1, 0x87, 0xba, 0xa4, 0xad,
+	0x85, 0x76, 0x8d, 0xb9, 0x34, 0x84, 0x25, 0x84, 0x61, 0x93, 0x6c, 0xc5, 0xb1, 0x3b, 0x2f, 0x35,
+	0xe5, 0x2f, 0x7b, 0xca, 0xe5, 0xcd, 0xc6, 0x99, 0x69, 0x46, 0xfb, 0x74, 0xd2, 0xe1, 0xa2, 0x8f,
+	0xf8, 0xee, 0x2d, 0xa9, 0x6e, 0x53, 0x59, 0x31, 0x74, 0x72, 0x73, 0x56, 0x77, 0x2e, 0x1d, 0xfd,
+	0xe3, 0x4d, 0x9f, 0xb5, 0x89, 0x3e, 0x52, 0x61, 0xf4, 0x60, 0x00, 0x44, 0xdb, 0x83, 0x59, 0x66,
+	0xc0, 0x80, 0x06, 0x8f, 0x73, 0x8d, 0x03, 0x3f, 0x12, 0xb3, 0xb0, 0xe2, 0x50, 0xb1, 0xd7, 0x24,
+	0xf8, 0x8a, 0x12, 0xc7, 0x34, 0x0c, 0xff, 0x2a, 0xc1, 0x0e, 0x0a, 0x09, 0xbb, 0x06, 0x92, 0x3a,
+	0x79, 0x1a, 0x85, 0x11, 0x5a, 0x40, 0x80, 0x80, 0x01, 0x9f, 0xbd, 0x0a, 0x66, 0x60, 0xc0, 0xca,
+	0x01, 0xb3, 0x96, 0xab, 0xef, 0x60, 0x54, 0x81, 0x71, 0xa1, 0xc2, 0x14, 0x16, 0x17, 0x10, 0x38,
+	0x64, 0xf0, 0xc5, 0x84, 0x86, 0x8a, 0x0b, 0x15, 0x13, 0xac, 0xa1, 0x02, 0x03, 0xa3, 0xe2, 0xc2,
+	0x1c, 0x2e, 0x4c, 0xb0, 0x0d, 0x00, 0x40, 0x8f, 0x21, 0xea, 0x95, 0x58, 0x94, 0x5f, 0x12, 0x7b,
+	0x4c, 0x42, 0x06, 0xa1, 0x95, 0xd5, 0xc9, 0x33, 0x31, 0x63, 0xb1, 0xc9, 0xa4, 0x6a, 0x16, 0x28,
+	0xfc, 0x30, 0xb0, 0xec, 0xb5, 0xe5, 0x8b, 0xdd, 0x6b, 0x08, 0x76, 0xad, 0x57, 0xec, 0x79, 0xf2,
+	0xc8, 0x04, 0x1d, 0xbf, 0xf6, 0xc1, 0xa5, 0x63, 0x3c, 0x4f, 0x22, 0x2a, 0xfc, 0x28, 0xf0, 0x74,
+	0xee, 0x76, 0x82, 0xe1, 0x34, 0x65, 0xae, 0xea, 0xea, 0x67, 0x5e, 0x07, 0x15, 0x32, 0x71, 0xb9,
+	0xd2, 0x3d, 0x84, 0x0e, 0x15, 0x4b, 0x6d, 0x03, 0x5c, 0x3a, 0x88, 0xa5, 0x29, 0xa3, 0x2b, 0xae,
+	0xb6, 0x69, 0x96, 0x2a, 0x57, 0xd1, 0xf6, 0xa4, 0x7d, 0x2b, 0x89, 0xb8, 0x15, 0xb4, 0x0c, 0xef,
+	0x30, 0x6e, 0x3c, 0xe9, 0x6b, 0x18, 0x8a, 0xb5, 0x67, 0xaf, 0xba, 0xd0, 0x49, 0x96, 0x16, 0x1a,
+	0x8d, 0x8b, 0xaf, 0x85, 0xc9, 0x6d, 0xd7, 0x15, 0x3a, 0x5e, 0x94, 0x20, 0xc5, 0xf5, 0x52, 0x3a,
+	0xc5, 0xc7, 0x6e, 0x5c, 0x4a, 0x50, 0x06, 0xcb, 0x95, 0xd2, 0x53, 0x0d, 0xef, 0x43, 0x57, 0xcd,
+	0x31, 0x5a, 0xdd, 0x79, 0xda, 0xbb, 0xb8, 0xd2, 0xf2, 0xd6, 0x88, 0x1e, 0xac, 0xe1, 0xe2, 0x6f,
+	0x4a, 0x9a, 0x94, 0x8d, 0x04, 0xa9, 0xab, 0x8c, 0x34, 0x7d, 0xfc, 0x84, 0x8c, 0xde, 0xb1, 0x7c,
+	0x06, 0x3a, 0x76, 0x93, 0x74, 0xa3, 0x61, 0x36, 0xa1, 0xbc, 0xe8, 0x21, 0x17, 0xa7, 0x51, 0x18,
+	0xad, 0x0e, 0x9f, 0x67, 0xc2, 0xce, 0xfa, 0xc6, 0x35, 0xa4, 0x30, 0x88, 0x33, 0xb4, 0x49, 0xac,
+	0xde, 0x52, 0x6e, 0x11, 0xec, 0x50, 0xea, 0xd2, 0x35, 0x95, 0x9f, 0xd8, 0xd7, 0xba, 0xc4, 0xfb,
+	0x6d, 0xce, 0x5f, 0xba, 0x88, 0xa7, 0xbc, 0xc9, 0xfb, 0x48, 0xb0, 0x23, 0xf9, 0x4d, 0x25, 0xe4,
+	0x2d, 0x57, 0xfa, 0x1f, 0xfd, 0xca, 0x12, 0x1d, 0x72, 0xe9, 0xda, 0x94, 0x27, 0xeb, 0x11, 0xe5,
+	0x90, 0x67, 0xa0, 0x43, 0xfb, 0x40, 0x30, 0x61, 0xf8, 0x38, 0x2d, 0xa5, 0x89, 0x87, 0xed, 0x72,
+	0x5f, 0x93, 0xf0, 0x4f, 0xe9, 0xd8, 0x59, 0x3a, 0x8f, 0xe4, 0x84, 0xc6, 0xb5, 0xc5, 0x4d, 0x29,
+	0x8e, 0xc6, 0x41, 0xd8, 0x97, 0xad, 0x97, 0x9c, 0x61, 0x77, 0x12, 0xeb, 0x71, 0xee, 0xce, 0x72,
+	0x6d, 0xd3, 0x84, 0x8e, 0xd7, 0x42, 0xa7, 0xed, 0x3e, 0x25, 0x74, 0xb8, 0xd0, 0xf5, 0xb9, 0xf4,
+	0xd4, 0xad, 0xb2, 0x7a, 0x77, 0x07, 0x17, 0xa6, 0xd4, 0x3b, 0x8f, 0xa5, 0x93, 0x0b, 0xa9, 0x94,
+	0xad, 0x49, 0xa8, 0x49, 0x6f, 0x37, 0x99, 0xc6, 0x88, 0x1c, 0xef, 0x57, 0x4a, 0xc0, 0x53, 0x58,
+	0x98, 0x6a, 0x41, 0x81, 0xc1, 0x8f, 0x03, 0xcd, 0xf9, 0x6b, 0x41, 0x33, 0xed, 0xac, 0x31, 0x65,
+	0xd1, 0x66, 0x65, 0x3d, 0x66, 0x59, 0xa2, 0x73, 0xf5, 0xb7, 0x3d, 0xfa, 0x1e, 0xaf, 0x4b, 0x95,
+	0xac, 0xf3, 0xa7, 0x79, 0xad, 0x74, 0xab, 0xd8, 0x93, 0x37, 0x15, 0xf9, 0xf5, 0x35, 0x67, 0xa7,
+	0x8d, 0x61, 0x8e, 0x8c, 0x55, 0x6b, 0x10, 0xa3, 0x9f, 0xe1, 0x40, 0x37, 0x88, 0x20, 0x47, 0x71,
+	0xa8, 0x67, 0xb4, 0x08, 0xcb, 0x37, 0xbb, 0x18, 0xa8, 0xb9, 0x11, 0xa9, 0xad, 0x71, 0x0f, 0x11,
+	0x3d, 0x31, 0x74, 0xcf, 0x53, 0x72, 0xe8, 0xf6, 0x51, 0x26, 0x6b, 0x45, 0x7c, 0x7d, 0xee, 0x31,
+	0x8d, 0x04, 0x5d, 0x65, 0xc2, 0xe4, 0x89, 0x08, 0x7f, 0x5b, 0x6b, 0x90, 0x51, 0x1e, 0x99, 0x69,
+	0x8f, 0x60, 0xe3, 0xf6, 0xa8, 0xa1, 0xda, 0x1a, 0x89, 0x4e, 0x9f, 0xfc, 0x45, 0xfd, 0xd2, 0x6c,
+	0x3e, 0x34, 0x7b, 0x24, 0x21, 0x15, 0x4c, 0x9f, 0xbc, 0xce, 0xd7, 0xb2, 0x7b, 0x55, 0x0a, 0x57,
+	0xa2, 0xbb, 0x3a, 0xc3, 0xa4, 0x42, 0x2e, 0x35, 0x9f, 0x55, 0x5c, 0xe9, 0x24, 0x6a, 0xd2, 0xc3,
+	0xf0, 0x03, 0x45, 0x2c, 0x39, 0x53, 0x37, 0xbb, 0x19, 0xb9, 0x06, 0x3f, 0x14, 0x28, 0x96, 0x8c,
+	0xbe, 0x91, 0x6c, 0xaa, 0x2b, 0xec, 0xdd, 0xc1, 0x45, 0x08, 0xad, 0x5c, 0xa3, 0x2b, 0x3e, 0x9f,
+	0x12, 0x38, 0x0a, 0x30, 0x16, 0x7e, 0x5c, 0xa1, 0xdd, 0x3e, 0xc7, 0x04, 0x14, 0x02, 0x0b, 0x09,
+	0x5f, 0xaf, 0x4f, 0xc5, 0x33, 0xc7, 0xee, 0x44, 0xdc, 0x99, 0x2f, 0xc4, 0xd5, 0x57, 0xeb, 0x35,
+	0xc9, 0x64, 0xb1, 0xb6, 0xd0, 0x6d, 0x06, 0x3b, 0xee, 0x74, 0x02, 0x26, 0x4b, 0x62, 0xc7, 0x22,
+	0xa1, 0x77, 0xcf, 0x1b, 0x80, 0x7d, 0xaf, 0xf0, 0xba, 0xd0, 0x4e, 0x3a, 0xb3, 0xa7, 0x76, 0xe8,
+	0x40, 0x89, 0xcd, 0x09, 0xc6, 0xce, 0xe6, 0x9d, 0x85, 0xcd, 0x72, 0xb0, 0xa3, 0xc0, 0x23, 0x29,
+	0x48, 0x7f, 0xd6, 0x7a, 0xc6, 0xd0, 0x41, 0xa7, 0xab, 0xe2, 0xf2, 0x2d, 0x3a, 0x08, 0x9c, 0xb5,
+	0x82, 0xd4, 0xa8, 0x12, 0x94, 0x58, 0x41, 0x85, 0x68, 0x46, 0x92, 0x92, 0x14, 0x24, 0x8d, 0x01,
+	0x42, 0x10, 0x08, 0x84, 0x61, 0x71, 0x89, 0x28, 0x49, 0xee, 0x03, 0x72, 0xb0, 0x64, 0x98, 0x85,
+	0x9c, 0x51, 0x12, 0x11, 0x25, 0x90, 0x12, 0x91, 0x11, 0x09, 0x44, 0x14, 0x14, 0xa4, 0x24, 0x49,
+	0x86, 0x35, 0xb2, 0x79, 0x47, 0x6f, 0xcd, 0x4e, 0xac, 0x01, 0x95, 0xcd, 0x5d, 0x48, 0x28, 0xfb,
+	0x7e, 0x27, 0x1b, 0x89, 0xd5, 0x89, 0xe5, 0x31, 0x92, 0x94, 0x79, 0x85, 0x7d, 0xe4, 0xc2, 0x4b,
+	0x06, 0x13, 0x4f, 0x25, 0xe0, 0xfc, 0x9f, 0xc6, 0x05, 0x51, 0x57, 0x97, 0x14, 0x50, 0xe7, 0xfb,
+	0xf1, 0xa1, 0xde, 0x89, 0x81, 0xa4, 0x72, 0x0f, 0x81, 0x0a, 0x1d, 0x1f, 0x56, 0xcb, 0x22, 0x09,
+	0x96, 0x2f, 0x20, 0x08, 0xcf, 0x6c, 0xbd, 0xab, 0xde, 0x9b, 0x33, 0xdc, 0x3d, 0x0f, 0x02, 0x8d,
+	0x3d, 0xb8, 0x22, 0xcd, 0x2f, 0xca, 0x69, 0x19, 0x84, 0x67, 0xe0, 0xd1, 0xea, 0x16, 0x32, 0x90,
+	0xc8, 0xb4, 0xf5, 0x06, 0x1d, 0x80, 0x2d, 0xf4, 0x74, 0x80, 0x6d, 0xc3, 0x42, 0x3e, 0x5e, 0x23,
+	0x77, 0x90, 0x46, 0xa0, 0x83, 0x5e, 0xfb, 0x36, 0x58, 0xfd, 0x58, 0x7e, 0xb5, 0x50, 0xa9, 0x35,
+	0x93, 0x6e, 0x38, 0xa8, 0x80, 0xed, 0x78, 0x4e, 0x05, 0x33, 0xeb, 0x48, 0x41, 0xe5, 0xa7, 0x8f,
+	0xd1, 0xd5, 0x70, 0xb9, 0x2c, 0xb4, 0xe9, 0x01, 0x30, 0x30, 0xd2, 0x43, 0x8b, 0xd2, 0xc8, 0x3d,
+	0x20, 0xe6, 0x50, 0xfc, 0xdd, 0x2c, 0xf4, 0xb6, 0x04, 0x8c, 0xe9, 0xd2, 0x78, 0xc1, 0x9a, 0x2f,
+	0x24, 0xb6, 0xeb, 0xed, 0xd5, 0xbd, 0xc3, 0x7e, 0xb0, 0x95, 0xf7, 0x61, 0x32, 0x43, 0x33, 0xa1,
+	0xc8, 0xd7, 0x1d, 0x95, 0x43, 0x6d, 0x23, 0xb9, 0x07, 0x8b, 0x7b, 0x2e, 0x9c, 0x2e, 0xaa, 0xd1,
+	0x6c, 0x16, 0x18, 0x87, 0x3b, 0x12, 0x65, 0xdf, 0xfe, 0xa1, 0xe1, 0x49, 0xdc, 0x5c, 0x67, 0x7d,
+	0xeb, 0xfa, 0x87, 0x46, 0x3a, 0x6a, 0xd5, 0xfd, 0x04, 0x84, 0x82, 0x00, 0x29, 0x8b, 0xd6, 0x8f,
+	0x04, 0x05, 0xea, 0xb0, 0x55, 0x05, 0x13, 0x68, 0x8f, 0x19, 0x15, 0xc4, 0x43, 0xf9, 0x50, 0x69,
+	0x64, 0xb1, 0x2c, 0x03, 0xdc, 0x7f, 0x68, 0x9c, 0x00, 0xae, 0x9e, 0x14, 0x85, 0xf8, 0x41, 0xba,
+	0xba, 0x82, 0x23, 0x91, 0xfa, 0x6c, 0x1c, 0xf2, 0xdd, 0x25, 0xfb, 0xe5, 0x73, 0xde, 0x29, 0x58,
+	0x42, 0xb8, 0x01, 0x9b, 0x99, 0x68, 0xc1, 0x44, 0xaf, 0x50, 0xc5, 0x35, 0xa1, 0x0d, 0x03, 0xdd,
+	0xff, 0x54, 0x11, 0xb4, 0x60, 0x41, 0xc8, 0xc5, 0x35, 0x21, 0x61, 0x6a, 0xbd, 0x04, 0x9a, 0x9f,
+	0xad, 0x17, 0x28, 0x2e, 0x73, 0xb5, 0x7d, 0x76, 0xe0, 0x6a, 0x3e, 0x65, 0x08, 0xdd, 0x09, 0x8b,
+	0x33, 0x73, 0xe1, 0x0d, 0x38, 0xc1, 0x4d, 0x97, 0x1d, 0xd0, 0x09, 0x19, 0xaf, 0x07, 0xd7, 0xf1,
+	0xcb, 0x25, 0xd4, 0xeb, 0x71, 0x18, 0xe5, 0x24, 0x4a, 0x60, 0xb7, 0xd4, 0xb3, 0x38, 0xd8, 0xcb,
+	0xed, 0xf9, 0x82, 0xa6, 0x75, 0x31, 0x0d, 0x26, 0x9b, 0xb4, 0x4d, 0x16, 0xc0, 0x3d, 0x37, 0x61,
+	0x21, 0xd1, 0xbc, 0x07, 0x4a, 0xb2, 0xf6, 0xee, 0xe8, 0x0c, 0x09, 0x8e, 0xad, 0x75, 0x42, 0x68,
+	0x1f, 0x85, 0xd3, 0x68, 0xbd, 0x25, 0x40, 0x59, 0x90, 0x2c, 0xa1, 0x85, 0x66, 0x51, 0xf3, 0x75,
+	0x89, 0x9b, 0xb9, 0xa6, 0x61, 0x45, 0x80, 0x09, 0x20, 0xd0, 0x4a, 0x83, 0x61, 0x1b, 0xd9, 0x10,
+	0xc3, 0xab, 0xd5, 0xa4, 0x57, 0x20, 0x93, 0xe4, 0xdf, 0x8b, 0x61, 0x41, 0xe6, 0x41, 0x4a, 0x89,
+	0xaf, 0xf2, 0x31, 0x58, 0xce, 0x6b, 0x7d, 0xef, 0xbd, 0x5f, 0x6b, 0x94, 0xfe, 0x20, 0xd0, 0x26,
+	0x10, 0xfa, 0xd8, 0xe5, 0xfb, 0x17, 0xac, 0x18, 0xc8, 0x8d, 0xb3, 0x30, 0xbb, 0x44, 0x72, 0x99,
+	0xb4, 0xc2, 0x09, 0x5a, 0xdb, 0x14, 0xdf, 0xf7, 0xf9, 0x03, 0x2c, 0xf6, 0x48, 0x4e, 0x60, 0x74,
+	0x85, 0x41, 0x8b, 0xbf, 0x79, 0x62, 0xf8, 0xc4, 0xb6, 0xa3, 0x2e, 0x43, 0xca, 0x52, 0x9b, 0x06,
+	0xe2, 0xc4, 0x25, 0x7d, 0x41, 0x07, 0xb4, 0x0c, 0xcb, 0x3d, 0x47, 0xbb, 0xdc, 0x08, 0x65, 0x4e,
+	0xf0, 0x33, 0x14, 0xc8, 0x65, 0xa1, 0xe9, 0x0d, 0x81, 0x6b, 0xdf, 0x06, 0xdb, 0xf8, 0xd3, 0xf1,
+	0xab, 0xae, 0x2c, 0xc3, 0xea, 0xee, 0xbf, 0xdd, 0x00, 0xb2, 0xa0, 0x44, 0xd8, 0x9e, 0xe1, 0x89,
+	0x77, 0x67, 0x3c, 0x83, 0xc2, 0x38, 0xe7, 0x1b, 0x2a, 0xcc, 0xd0, 0x7f, 0x90, 0xdf, 0x97, 0xcf,
+	0x15, 0x66, 0x51, 0xf1, 0x7b, 0x51, 0xc5, 0x72, 0xbd, 0xe7, 0x2b, 0xda, 0x63, 0xd2, 0x86, 0x2f,
+	0xec, 0x0f, 0x1f, 0x9e, 0xe9, 0x4d, 0x48, 0x7b, 0xc3, 0xaa, 0x4c, 0x81, 0xda, 0xd2, 0xe1, 0x2a,
+	0xc4, 0x8b, 0x21, 0x3f, 0xe7, 0x82, 0x55, 0xc7, 0x06, 0xdb, 0x5d, 0x8b, 0xc2, 0x55, 0x14, 0x61,
+	0xba, 0x40, 0xa9, 0x95, 0x82, 0x3a, 0x22, 0x3a, 0x64, 0x96, 0x0a, 0x3e, 0x52, 0x4b, 0xe2, 0xc3,
+	0xf7, 0xad, 0xa3, 0x26, 0x3f, 0xbc, 0x6b, 0x87, 0xe8, 0x49, 0xee, 0x8c, 0x13, 0xf9, 0xfd, 0x44,
+	0x3a, 0x28, 0x9a, 0xe4, 0xa1, 0x2e, 0xd5, 0x47, 0xf4, 0xc3, 0xaf, 0x6a, 0x30, 0x0e, 0x4e, 0xd0,
+	0x6d, 0x09, 0x3b, 0x9e, 0x70, 0x66, 0x6d, 0x74, 0xc7, 0x89, 0xf8, 0x58, 0xfc, 0xb3, 0x50, 0x88,
+	0xc2, 0x55, 0x42, 0x21, 0xb7, 0x96, 0x2e, 0x8b, 0x8f, 0x06, 0x35, 0x27, 0x60, 0x1d, 0xd3, 0xf4,
+	0xbf, 0xfa, 0x81, 0x74, 0xf7, 0x04, 0x96, 0x69, 0xa8, 0x0a, 0x7a, 0x6f, 0x12, 0x87, 0xfa, 0xfd,
+	0x01, 0x48, 0xb7, 0x7d, 0xb6, 0xb5, 0x0b, 0x9f, 0xf7, 0x00, 0x29, 0x3b, 0xf9, 0x90, 0xef, 0x16,
+	0x7e, 0x17, 0x52, 0x7e, 0x2c, 0x29, 0xc5, 0xda, 0x08, 0x60, 0x04, 0x17, 0x2e, 0x36, 0x58, 0x94,
+	0xc2, 0xe1, 0x2a, 0x65, 0x8a, 0x33, 0xa7, 0xc6, 0x00, 0x88, 0x25, 0x20, 0xdd, 0xaa, 0xd8, 0x05,
+	0x6c, 0x1b, 0xe9, 0x06, 0x67, 0x2a, 0xc6, 0xd3, 0x8c, 0x68, 0x09, 0x71, 0x2b, 0x31, 0x50, 0x7a,
+	0x74, 0x8f, 0x88, 0xbd, 0xff, 0x42, 0x5a, 0x02, 0x4b, 0x7b, 0xcd, 0xbf, 0x04, 0x24, 0x37, 0x9c,
+	0x78, 0x56, 0x68, 0xdb, 0x4e, 0xa5, 0x83, 0x43, 0x35, 0xda, 0x3d, 0x28, 0x95, 0xfb, 0x24, 0x24,
+	0xde, 0x70, 0xdf, 0x90, 0x5f, 0xc2, 0xc9, 0x45, 0xc7, 0xeb, 0xae, 0x60, 0x2e, 0x0c, 0x63, 0x6c,
+	0xec, 0x10, 0xb4, 0x23, 0x18, 0x98, 0x04, 0x59, 0x72, 0xc8, 0xea, 0x11, 0x8f, 0xf2, 0xb4, 0xc6,
+	0x90, 0xd3, 0x0e, 0xe6, 0x8e, 0x1a, 0x4d, 0x48, 0xbf, 0x3f, 0xca, 0x3b, 0x19, 0x29, 0x42, 0x59,
+	0xed, 0x27, 0x8e, 0x6b, 0xad, 0xc4, 0x68, 0x1a, 0xd6, 0x54, 0xa4, 0xf7, 0x21, 0x25, 0xdf, 0x69,
+	0x1d, 0x90, 0x83, 0x76, 0xd5, 0x07, 0xd3, 0xb5, 0x30, 0xc1, 0xfa, 0x4f, 0xe0, 0xd1, 0xfc, 0x28,
+	0x16, 0x77, 0xd9, 0x6c, 0xd1, 0xb5, 0x10, 0x87, 0x74, 0x1d, 0xbf, 0x2e, 0x72, 0xcd, 0xa0, 0x70,
+	0xba, 0xd4, 0xa5, 0xfb, 0x31, 0x53, 0x22, 0xdf, 0xb2, 0x66, 0xc5, 0x3e, 0x6c, 0x9b, 0x84, 0x50,
+	0x41, 0x13, 0x6c, 0xb7, 0xb8, 0x3d, 0x61, 0x98, 0x63, 0x95, 0x9a, 0x46, 0x54, 0x0d, 0x94, 0xb1,
+	0xd4, 0x08, 0x1b, 0x17, 0xe9, 0x27, 0x34, 0x45, 0x48, 0xf5, 0x5c, 0xa9, 0x3d, 0xc7, 0x4e, 0x9c,
+	0xd7, 0x45, 0x22, 0x80, 0x7e, 0x38, 0x6f, 0x9b, 0xf1, 0x5d, 0x35, 0x24, 0xaa, 0x24, 0x33, 0x50,
+	0x25, 0x30, 0x68, 0x8f, 0x58, 0x68, 0x62, 0xd3, 0x13, 0x3c, 0xa9, 0xfd, 0xa5, 0x53, 0x76, 0xf9,
+	0xb8, 0x50, 0x23, 0x3f, 0xa0, 0x2d, 0xf7, 0x21, 0x6b, 0xc9, 0x8c, 0x12, 0x18, 0xa5, 0x59, 0x29,
+	0x50, 0x01, 0x40, 0x1c, 0x75, 0x00, 0xcb, 0xb1, 0x42, 0xf5, 0xbd, 0xe6, 0xa6, 0x9c, 0x95, 0xe8,
+	0xe5, 0x75, 0xa0, 0x4c, 0x78, 0x62, 0x09, 0x0b, 0xa1, 0x44, 0x07, 0x91, 0x58, 0x24, 0x7c, 0xba,
+	0x57, 0x7b, 0xa6, 0x1d, 0x2c, 0x3a, 0x07, 0x81, 0x46, 0x12, 0xd2, 0xfc, 0xb1, 0xd4, 0xe3, 0x62,
+	0x02, 0xb2, 0xce, 0xae, 0xf4, 0x6c, 0x5b, 0x1d, 0x02, 0xa9, 0x33, 0xf9, 0xd0, 0x7d, 0x2b, 0x80,
+	0x27, 0x6c, 0xfd, 0x53, 0x5f, 0xd5, 0x0d, 0x86, 0x80, 0x39, 0x32, 0xe3, 0x9a, 0xd6, 0x59, 0x79,
+	0x94, 0x55, 0xbb, 0x47, 0x78, 0x4e, 0xeb, 0x43, 0x52, 0xdd, 0x23, 0x71, 0x49, 0xb6, 0xd7, 0xd0,
+	0x5c, 0x30, 0x87, 0x11, 0xfa, 0x4d, 0x9c, 0x79, 0xe4, 0x90, 0x06, 0x33, 0x0e, 0xdb, 0xb3, 0x9d,
+	0xe3, 0xf8, 0x92, 0x75, 0xfc, 0x5f, 0xf3, 0x19, 0xc6, 0x7b, 0xfd, 0x53, 0x17, 0xd7, 0x77, 0x33,
+	0x1c, 0x2e, 0x46, 0x50, 0x12, 0x39, 0xda, 0x09, 0x73, 0xbe, 0x91, 0xe6, 0x8e, 0x39, 0xfc, 0x92,
+	0x93, 0xa2, 0x9e, 0xbd, 0x92, 0x0b, 0x8a, 0x02, 0xf9, 0x6d, 0x65, 0x39, 0x95, 0x62, 0x4f, 0x24,
+	0x75, 0x11, 0x58, 0x1c, 0x72, 0x6a, 0x23, 0x35, 0xe5, 0xdc, 0x4d, 0xc8, 0xec, 0x5b, 0x6c, 0x1d,
+	0xac, 0xbe, 0x67, 0x05, 0x82, 0x16, 0xe1, 0x19, 0x2e, 0x66, 0x39, 0x8c, 0x8d, 0xb9, 0xbd, 0x0c,
+	0xaf, 0x4f, 0x56, 0x0b, 0x62, 0xd0, 0x72, 0x28, 0xac, 0xb0, 0x17, 0xd0, 0x7b, 0x85, 0xc5, 0x00,
+	0x08, 0x1c, 0xf5, 0x84, 0xff, 0xab, 0x52, 0xa8, 0xf0, 0x06, 0xc3, 0x75, 0x91, 0xe4, 0x20, 0xa9,
+	0x86, 0xec, 0x58, 0x15, 0xde, 0x5a, 0xc4, 0x92, 0x91, 0x11, 0x03, 0x6a, 0x66, 0x6f, 0xaa, 0x28,
+	0x91, 0xc2, 0x2a, 0x32, 0x2c, 0x9b, 0x9b, 0xda, 0x1e, 0x49, 0xc5, 0xd2, 0xc0, 0x97, 0xc7, 0x2b,
+	0x14, 0x72, 0x1e, 0x10, 0x8b, 0x66, 0x32, 0x5d, 0xcd, 0xd4, 0xd9, 0x37, 0x14, 0x79, 0xf8, 0x8a,
+	0x20, 0x4f, 0x62, 0x73, 0x3e, 0x67, 0x18, 0xbe, 0xf2, 0x72, 0x17, 0x8d, 0xe2, 0x74, 0x71, 0x0b,
+	0x8e, 0xd1, 0xb0, 0x44, 0x1d, 0x0a, 0x9e, 0xad, 0x11, 0xbb, 0x30, 0x35, 0x40, 0xd6, 0x01, 0x01,
+	0x81, 0x9a, 0x3e, 0xf6, 0xf4, 0x70, 0x38, 0x48, 0x62, 0xed, 0x01, 0x09, 0x70, 0x46, 0x70, 0x7f,
+	0x92, 0x29, 0xc2, 0x43, 0x1c, 0x8e, 0x16, 0x7f, 0xe3, 0xf0, 0xd6, 0x64, 0xad, 0xda, 0x92, 0x6f,
+	0x50, 0xf0, 0xc6, 0x6d, 0x3a, 0x84, 0x38, 0x4e, 0x76, 0x6e, 0x23, 0x70, 0x66, 0x96, 0x38, 0xf5,
+	0x05, 0xea, 0xf1, 0x4b, 0xfd, 0x38, 0xd0, 0x48, 0x0d, 0xec, 0xa4, 0x9d, 0x7a, 0x5c, 0x7e, 0x69,
+	0x10, 0x04, 0xd7, 0x87, 0x37, 0x12, 0xd0, 0x18, 0x30, 0x32, 0x0a, 0x86, 0x00, 0x2f, 0x02, 0x4b,
+	0x15, 0xac, 0x8a, 0x92, 0xc5, 0x2a, 0x6c, 0x77, 0x5f, 0xd9, 0xea, 0x20, 0xba, 0x27, 0x17, 0x5f,
+	0x79, 0xe5, 0x30, 0x96, 0x30, 0x55, 0x69, 0x67, 0x6b, 0x25, 0x93, 0x12, 0x0d, 0x3d, 0x52, 0x68,
+	0x0e, 0xbd, 0x9b, 0x25, 0x1d, 0x87, 0xfd, 0x48, 0x65, 0xe5, 0x24, 0xf8, 0xb2, 0xba, 0x29, 0xf5,
+	0x3e, 0xe7, 0xa4, 0x39, 0x97, 0x2c, 0x05, 0x63, 0x78, 0x64, 0xf8, 0x6e, 0x4b, 0xb1, 0x9b, 0x02,
+	0xad, 0x1f, 0xeb, 0xf4, 0xa7, 0x52, 0x10, 0x80, 0x7a, 0x3e, 0x24, 0x5b, 0x32, 0x5d, 0x48, 0x5b,
+	0x46, 0x8a, 0xd9, 0xe8, 0x93, 0x1b, 0x58, 0xec, 0xac, 0xf4, 0xfd, 0xd1, 0x3a, 0x84, 0xde, 0x14,
+	0xcd, 0xa0, 0xd7, 0x62, 0x1b, 0xdb, 0x0a, 0x2c, 0x24, 0x8c, 0x5b, 0xa7, 0x65, 0x19, 0x9c, 0x33,
+	0x24, 0x6a, 0xe1, 0xec, 0x52, 0x73, 0x1e, 0xac, 0x23, 0x39, 0x27, 0x6e, 0x11, 0x28, 0x20, 0x59,
+	0xac, 0x52, 0xdf, 0x9e, 0x4e, 0x4c, 0x42, 0xd6, 0x7c, 0x63, 0xd7, 0x0e, 0x67, 0x13, 0x9e, 0xfe,
+	0x96, 0xa3, 0xb0, 0x15, 0xce, 0x91, 0x37, 0x2e, 0xac, 0x78, 0x70, 0x88, 0xe0, 0x2a, 0x4f, 0xf8,
+	0x00, 0x50, 0xd2, 0x28, 0xfc, 0xb7, 0x04, 0x1b, 0xc3, 0xc7, 0x62, 0xa3, 0xc9, 0x43, 0xc2, 0x00,
+	0xf9, 0x43, 0x23, 0x4d, 0x24, 0x79 };
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_zstd_bit_stream_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_zstd_bit_stream_initialize(
+     void )
+{
+	uint8_t byte_stream[ 2 ] = { 0x34, 0x12 };
+
+	libqcow_zstd_bit_stream_t bit_stream;
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          byte_stream,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The bits after the most significant bit set in the last byte are padding
+	 */
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "bit_stream.bit_offset",
+	 bit_stream.bit_offset,
+	 (int64_t) 12 );
+
+	/* Test error cases
+	 */
+	result = libqcow_zstd_bit_stream_initialize(
+	          NULL,
+	          byte_stream,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          NULL,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          byte_stream,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the last byte does not contain the padding bit
+	 */
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          byte_stream,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	byte_stream[ 1 ] = 0x00;
+
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          byte_stream,
+	          2,
+	          &error );
+
+	byte_stream[ 1 ] = 0x12;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_zstd_bit_stream_get_value function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_zstd_bit_stream_get_value(
+     void )
+{
+	uint8_t byte_stream[ 2 ] = { 0x34, 0x12 };
+
+	libqcow_zstd_bit_stream_t bit_stream;
+
+	libcerror_error_t *error = NULL;
+	uint32_t value_32bit     = 0;
+	int result               = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_zstd_bit_stream_initialize(
+	          &bit_stream,
+	          byte_stream,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          0,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "value_32bit",
+	 value_32bit,
+	 (uint32_t) 0x00000000UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          4,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "value_32bit",
+	 value_32bit,
+	 (uint32_t) 0x00000002UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          6,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "value_32bit",
+	 value_32bit,
+	 (uint32_t) 0x0000000dUL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Reading beyond the start of the byte stream returns 0 bits
+	 */
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          4,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "value_32bit",
+	 value_32bit,
+	 (uint32_t) 0x00000000UL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "bit_stream.bit_offset",
+	 bit_stream.bit_offset,
+	 (int64_t) -2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_zstd_bit_stream_get_value(
+	          NULL,
+	          4,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          33,
+	          &value_32bit,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_bit_stream_get_value(
+	          &bit_stream,
+	          4,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_zstd_fse_table_build function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_zstd_fse_table_build(
+     void )
+{
+	int16_t normalized_counts[ 4 ] = { 16, 8, -1, 7 };
+
+	libqcow_zstd_fse_table_t table;
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_zstd_fse_table_build(
+	          &table,
+	          normalized_counts,
+	          4,
+	          5,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "table.accuracy_log",
+	 table.accuracy_log,
+	 (uint8_t) 5 );
+
+	/* The "less than 1" probability symbol is stored at the end of the table
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "table.entries[ 31 ].symbol",
+	 table.entries[ 31 ].symbol,
+	 (uint8_t) 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "table.entries[ 31 ].number_of_bits",
+	 table.entries[ 31 ].number_of_bits,
+	 (uint8_t) 5 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.entries[ 31 ].base_value",
+	 table.entries[ 31 ].base_value,
+	 (uint16_t) 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_zstd_fse_table_build(
+	          NULL,
+	          normalized_counts,
+	          4,
+	          5,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_fse_table_build(
+	          &table,
+	          NULL,
+	          4,
+	          3,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_fse_table_build(
+	          &table,
+	          normalized_counts,
+	          4,
+	          LIBQCOW_ZSTD_FSE_MAXIMUM_ACCURACY_LOG + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the normalized counts do not add up to the table size
+	 */
+	normalized_counts[ 0 ] = 17;
+
+	result = libqcow_zstd_fse_table_build(
+	          &table,
+	          normalized_counts,
+	          4,
+	          5,
+	          &error );
+
+	normalized_counts[ 0 ] = 16;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_zstd_huffman_table_build function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_zstd_huffman_table_build(
+     void )
+{
+	uint8_t weights[ 2 ] = { 2, 1 };
+
+	libqcow_zstd_huffman_table_t table;
+
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_zstd_huffman_table_build(
+	          &table,
+	          weights,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "table.maximum_number_of_bits",
+	 table.maximum_number_of_bits,
+	 (uint8_t) 2 );
+
+	/* The last symbol has an implied weight of 1
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 0 ]",
+	 table.lookup_table[ 0 ],
+	 (uint16_t) 0x0201 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 1 ]",
+	 table.lookup_table[ 1 ],
+	 (uint16_t) 0x0202 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 2 ]",
+	 table.lookup_table[ 2 ],
+	 (uint16_t) 0x0100 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "table.lookup_table[ 3 ]",
+	 table.lookup_table[ 3 ],
+	 (uint16_t) 0x0100 );
+
+	/* Test error cases
+	 */
+	result = libqcow_zstd_huffman_table_build(
+	          NULL,
+	          weights,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_huffman_table_build(
+	          &table,
+	          NULL,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_huffman_table_build(
+	          &table,
+	          weights,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the implied weight is not a power of 2
+	 */
+	weights[ 0 ] = 3;
+
+	result = libqcow_zstd_huffman_table_build(
+	          &table,
+	          weights,
+	          2,
+	          &error );
+
+	weights[ 0 ] = 2;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_zstd_decompress function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_zstd_decompress(
+     void )
+{
+	uint8_t compressed_data[ 2566 + 16 ];
+	uint8_t uncompressed_data[ 8192 ];
+
+	libcerror_error_t *error      = NULL;
+	size_t uncompressed_data_size = 7640;
+	int result                    = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "uncompressed_data_size",
+	 uncompressed_data_size,
+	 (size_t) 7640 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          uncompressed_data,
+	          "\t\t   GNU LESSER GENERAL PUBLIC LICENSE\n",
+	          38 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test data following the frame, such as the remainder of the last sector of a compressed cluster
+	 */
+	result = memory_copy(
+	          compressed_data,
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566 ) == NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = memory_set(
+	          &( compressed_data[ 2566 ] ),
+	          0xa5,
+	          16 ) == NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	uncompressed_data_size = 7640;
+
+	result = libqcow_zstd_decompress(
+	          compressed_data,
+	          2566 + 16,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "uncompressed_data_size",
+	 uncompressed_data_size,
+	 (size_t) 7640 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	uncompressed_data_size = 7640;
+
+	result = libqcow_zstd_decompress(
+	          NULL,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          (size_t) SSIZE_MAX + 1,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          NULL,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          uncompressed_data,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the uncompressed data is too small
+	 */
+	uncompressed_data_size = 4096;
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the compressed data is truncated
+	 */
+	uncompressed_data_size = 7640;
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          1024,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error case where the frame signature is invalid
+	 */
+	compressed_data[ 0 ] = 0xff;
+
+	result = libqcow_zstd_decompress(
+	          compressed_data,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	/* Test libqcow_zstd_decompress with malloc failing
+	 */
+	qcow_test_malloc_attempts_before_fail = 0;
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	if( qcow_test_malloc_attempts_before_fail != -1 )
+	{
+		qcow_test_malloc_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+	/* Test libqcow_zstd_decompress with malloc failing on the literals buffer
+	 */
+	qcow_test_malloc_attempts_before_fail = 1;
+
+	result = libqcow_zstd_decompress(
+	          qcow_test_zstd_compressed_byte_stream,
+	          2566,
+	          uncompressed_data,
+	          &uncompressed_data_size,
+	          &error );
+
+	if( qcow_test_malloc_attempts_before_fail != -1 )
+	{
+		qcow_test_malloc_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( HAVE_DEBUG_OUTPUT ) && defined( QCOW_TEST_ZSTD )
+	libcnotify_verbose_set(
+	 1 );
+	libcnotify_stream_set(
+	 stderr,
+	 NULL );
+#endif
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_zstd_bit_stream_initialize",
+	 qcow_test_zstd_bit_stream_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_zstd_bit_stream_get_value",
+	 qcow_test_zstd_bit_stream_get_value );
+
+	QCOW_TEST_RUN(
+	 "libqcow_zstd_fse_table_build",
+	 qcow_test_zstd_fse_table_build );
+
+	QCOW_TEST_RUN(
+	 "libqcow_zstd_huffman_table_build",
+	 qcow_test_zstd_huffman_table_build );
+
+	QCOW_TEST_RUN(
+	 "libqcow_zstd_decompress",
+	 qcow_test_zstd_decompress );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
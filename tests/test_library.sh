@@ -7,8 +7,8 @@ EXIT_SUCCESS=0;
 EXIT_FAILURE=1;
 EXIT_IGNORE=77;
 
-LIBRARY_TESTS="cluster_block cluster_table deflate error file_header io_handle notify";
-LIBRARY_TESTS_WITH_INPUT="file support";
+LIBRARY_TESTS="bitmap_values block_cache buffer_pool cache_budget cluster_block cluster_table decompression_pool deflate encryption error file_header hash io_handle luks_header notify read_segment readahead reference_count_block snapshot_values zstd";
+LIBRARY_TESTS_WITH_INPUT="file io_uring mapped_file support";
 OPTION_SETS="";
 
 INPUT_GLOB="*";